@@ -0,0 +1,114 @@
+#include "command/dispatcher.hpp"
+#include "storage/aof.hpp"
+#include "storage/store.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* AOF benchmark: SET throughput with appendfsync always / everysec / no, compared to no AOF.
+* Usage: aof_bench [clients] [seconds] [dir]
+*
+* clients개(기본 8)의 스레드가 각자 dispatcher로 SET counter:<n> <값 32 bytes>를 seconds초(기본 2) 동안
+* 실행합니다. 서버의 세션처럼 appendfsync always에서는 각 SET의 응답을 그 명령이 fsync될 때까지 기다린 뒤
+* 다음 SET을 보내므로, 동시에 기다리는 클라이언트들의 쓰기가 fsync 한 번으로 묶이는지(group commit)가
+* 처리량에 드러납니다. 마지막으로 만들어진 AOF를 다시 실행하는 속도도 출력합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+  using namespace mini_redis;
+
+  struct result
+  {
+    std::uint64_t ops = 0;
+    double seconds = 0;
+  };
+
+  result run(std::shared_ptr<append_only_file> aof, std::size_t clients, double seconds)
+  {
+    auto st = std::make_shared<store>();
+    auto pubsub = std::make_shared<pubsub_manager>();
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> ops{0};
+    const std::string value(32, 'v');
+
+    std::vector<std::thread> threads;
+    const auto start = clock_type::now();
+    for (std::size_t t = 0; t < clients; ++t)
+    {
+      threads.emplace_back([&, t] {
+        CommandDispatcher dispatcher(st, pubsub, aof);
+        std::mutex m;
+        std::condition_variable cv;
+        std::uint64_t n = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+          dispatcher.execute_command({"SET", "counter:" + std::to_string(t) + ":" + std::to_string(n++ % 10000), value});
+          if (const auto seq = dispatcher.take_unsynced_write())
+          {
+            bool done = false;
+            aof->when_durable(seq, [&] {
+              std::lock_guard<std::mutex> lock(m);
+              done = true;
+              cv.notify_one();
+            });
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&] { return done; });
+          }
+        }
+        ops += n;
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto &t : threads)
+    {
+      t.join();
+    }
+    return {ops.load(), std::chrono::duration<double>(clock_type::now() - start).count()};
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t clients = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+  const double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+  const std::string dir = argc > 3 ? argv[3] : ".";
+  const std::string path = dir + "/aof_bench.aof";
+  std::cout << std::fixed << std::setprecision(0) << clients << " clients, " << seconds << " s per run\n";
+
+  const auto base = run(nullptr, clients, seconds);
+  std::cout << "  no AOF             " << std::setw(10) << base.ops / base.seconds << " SET/s\n";
+
+  for (const auto policy : {fsync_policy::no, fsync_policy::everysec, fsync_policy::always})
+  {
+    std::filesystem::remove(path);
+    auto aof = std::make_shared<append_only_file>(path, policy);
+    const auto r = run(aof, clients, seconds);
+    aof.reset();
+    std::cout << "  appendfsync " << std::left << std::setw(8) << fsync_policy_name(policy) << std::right
+              << std::setw(10) << r.ops / r.seconds << " SET/s (" << std::setprecision(1)
+              << 100.0 * (r.ops / r.seconds) / (base.ops / base.seconds) << "% of no AOF, "
+              << std::filesystem::file_size(path) / double(1 << 20) << " MB)\n"
+              << std::setprecision(0);
+  }
+
+  auto st = std::make_shared<store>();
+  CommandDispatcher replayer(st, std::make_shared<pubsub_manager>());
+  const auto loaded = append_only_file::replay(path, [&](const command_t &cmd) { replayer.execute_command(cmd); });
+  std::cout << "replay: " << loaded.commands << " commands in " << std::setprecision(2) << loaded.seconds << " s, "
+            << std::setprecision(0) << loaded.commands / loaded.seconds << " commands/s, " << std::setprecision(1)
+            << loaded.bytes / loaded.seconds / (1 << 20) << " MB/s\n";
+  std::filesystem::remove(path);
+  return 0;
+}
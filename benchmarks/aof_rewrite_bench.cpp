@@ -0,0 +1,151 @@
+#include "command/dispatcher.hpp"
+#include "storage/aof.hpp"
+#include "storage/store.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* AOF rewrite benchmark: file size and replay time before and after BGREWRITEAOF, and the
+* pauses it causes while clients keep writing.
+* Usage: aof_rewrite_bench [keys] [updates per key] [dir]
+*
+* keys개(기본 200k)의 키에 updates번(기본 10)씩 INCR / HSET / RPUSH를 실행하여 같은 키를 여러 번
+* 고친 긴 AOF를 만듭니다 (appendfsync everysec). 이어서 한 스레드가 SET을 계속 보내는 동안
+* BGREWRITEAOF를 실행하고, fork로 멈춘 시간, 자식이 파일을 쓰는 데 걸린 시간, 그동안 쌓인 쓰기를 옮긴 뒤
+* 파일을 바꾸느라 쓰기가 막힌 시간, 그리고 그 사이 SET의 최대 지연을 출력합니다.
+* 마지막으로 rewrite 전후 파일의 크기와 다시 실행하는 시간을 비교합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+  using namespace mini_redis;
+
+  double seconds_since(clock_type::time_point start)
+  {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+  }
+
+  double replay_seconds(const std::string &path, std::size_t &commands)
+  {
+    auto st = std::make_shared<store>();
+    CommandDispatcher replayer(st, std::make_shared<pubsub_manager>());
+    const auto stats = append_only_file::replay(path, [&](const command_t &cmd) { replayer.execute_command(cmd); });
+    commands = stats.commands;
+    return stats.seconds;
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  const std::size_t updates = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+  const std::string dir = argc > 3 ? argv[3] : ".";
+  const std::string path = dir + "/aof_rewrite_bench.aof";
+  std::filesystem::remove(path);
+  std::cout << std::fixed << std::setprecision(2);
+
+  store_config config;
+  config.dir = dir;
+  auto st = std::make_shared<store>(config);
+  auto pubsub = std::make_shared<pubsub_manager>();
+  auto aof = std::make_shared<append_only_file>(path, fsync_policy::everysec);
+  {
+    CommandDispatcher dispatcher(st, pubsub, aof);
+    for (std::size_t round = 0; round < updates; ++round)
+    {
+      for (std::size_t i = 0; i < keys; ++i)
+      {
+        const std::string id = std::to_string(i);
+        switch (i % 3)
+        {
+        case 0:
+          dispatcher.execute_command({"INCR", "counter:" + id});
+          break;
+        case 1:
+          dispatcher.execute_command({"HSET", "user:" + id, "visits", std::to_string(round), "f" + std::to_string(round), id});
+          break;
+        default:
+          dispatcher.execute_command({"RPUSH", "log:" + id, "event-" + std::to_string(round)});
+        }
+      }
+    }
+  }
+  // writer가 모두 쓸 때까지 기다림
+  for (auto size = aof->size();; )
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (aof->size() == size)
+    {
+      break;
+    }
+    size = aof->size();
+  }
+  const auto before = aof->size();
+  std::filesystem::copy_file(path, path + ".before", std::filesystem::copy_options::overwrite_existing);
+
+  // rewrite 동안 한 클라이언트가 계속 SET을 보냄
+  std::atomic<bool> stop{false};
+  std::atomic<std::uint64_t> sets{0};
+  std::atomic<long long> worst_us{0};
+  std::thread client([&] {
+    CommandDispatcher dispatcher(st, pubsub, aof);
+    std::uint64_t n = 0;
+    while (!stop.load(std::memory_order_relaxed))
+    {
+      const auto start = clock_type::now();
+      dispatcher.execute_command({"SET", "during:" + std::to_string(n++ % 100000), "value"});
+      const long long us = std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - start).count();
+      if (us > worst_us.load(std::memory_order_relaxed))
+      {
+        worst_us = us;
+      }
+    }
+    sets = n;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  worst_us = 0;
+
+  auto start = clock_type::now();
+  st->bgrewriteaof(*aof);
+  const double fork_pause = seconds_since(start);
+  double child_done = 0;
+  while (aof->rewrite_in_progress())
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    st->poll_background_save();
+    if (child_done == 0 && !st->persistence().aof_rewrite_child)
+    {
+      child_done = seconds_since(start);
+    }
+  }
+  const double total = seconds_since(start);
+  stop = true;
+  client.join();
+  std::cout << "keys: " << st->dbsize() << ", " << sets.load() << " SETs from one client during the run\n";
+  std::cout << "BGREWRITEAOF: fork pause " << fork_pause * 1e3 << " ms, child done in " << child_done
+            << " s, swapped in after " << total << " s (" << (aof->last_rewrite_ok() ? "ok" : "failed") << ")\n";
+  std::cout << "  swap pause " << aof->last_rewrite_pause().count() << " us, worst SET latency "
+            << worst_us.load() / 1000.0 << " ms\n";
+
+  const auto after = aof->base_size();
+  aof.reset();
+  std::size_t before_commands = 0;
+  std::size_t after_commands = 0;
+  const double before_replay = replay_seconds(path + ".before", before_commands);
+  const double after_replay = replay_seconds(path, after_commands);
+  std::cout << "size:   " << before / double(1 << 20) << " MB -> " << after / double(1 << 20) << " MB ("
+            << 100.0 * after / before << "%)\n";
+  std::cout << "replay: " << before_commands << " commands in " << before_replay << " s -> " << after_commands
+            << " commands in " << after_replay << " s\n";
+  std::filesystem::remove(path);
+  std::filesystem::remove(path + ".before");
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include "storage/store.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+* Churn benchmark: random SET/DEL for a long time, RSS and throughput over time.
+* Usage: churn_bench [slab|malloc] [seconds] [keys]
+*
+* 키 keys개 범위에서 무작위로 SET(50%)과 DEL(50%)을 반복합니다. 값 크기는 16 ~ 1000 bytes 사이이며,
+* 시간이 지나면서 값 크기 분포가 바뀌도록(작은 값 위주 <-> 큰 값 위주) 하여 해제된 자리를 다른 크기가
+* 재사용하지 못하는 단편화를 유도합니다. 서버 cron처럼 100ms마다 rehash_step과 defrag_step을 호출합니다.
+*
+* slab: 키와 값을 shard별 slab arena에서 할당 (기본값)
+* malloc: slab_allocator = false, 전역 new/delete 사용
+* 두 모드를 각각 다른 프로세스로 실행하여 RSS(/proc/self/statm, Linux 전용)를 비교합니다.
+* 기본 실행 시간은 30분입니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  std::size_t rss_bytes()
+  {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * 4096;
+#else
+    return 0;
+#endif
+  }
+
+  constexpr std::size_t mib = 1024 * 1024;
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const bool slab = argc <= 1 || std::strcmp(argv[1], "malloc") != 0;
+  const double seconds = argc > 2 ? std::atof(argv[2]) : 1800;
+  const std::size_t keys = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1000000;
+
+  mini_redis::store_config config;
+  config.slab_allocator = slab;
+  mini_redis::store s(config);
+
+  std::vector<std::string> names;
+  names.reserve(keys);
+  for (std::size_t i = 0; i < keys; ++i)
+  {
+    names.push_back("session:" + std::to_string(i * 2654435761u % 1000000007u) + ":token");
+  }
+  const std::string payload(1000, 'x');
+  std::mt19937_64 rng(11);
+
+  // 절반을 미리 채움
+  for (std::size_t i = 0; i < keys; i += 2)
+  {
+    s.set(names[i], payload.substr(0, 16 + rng() % 200));
+  }
+  const std::size_t rss_start = rss_bytes();
+
+  std::cout << "mode=" << (slab ? "slab" : "malloc") << " keys=" << keys << " seconds=" << seconds << "\n"
+            << std::setw(8) << "time(s)" << std::setw(12) << "ops/s" << std::setw(10) << "keys" << std::setw(12)
+            << "dataset" << std::setw(10) << "rss" << std::setw(12) << "rss/data\n";
+
+  const auto start = clock_type::now();
+  auto last_report = start;
+  auto last_cron = start;
+  std::size_t ops = 0;
+  std::size_t report_ops = 0;
+  const double report_every = seconds / 10;
+  for (;;)
+  {
+    // 1024번마다 시각 확인
+    for (int i = 0; i < 1024; ++i, ++ops)
+    {
+      const auto &key = names[rng() % keys];
+      if (rng() & 1)
+      {
+        s.del(key);
+        continue;
+      }
+      // 분포의 중심이 60초 주기로 작은 값(16~200)과 큰 값(200~1000) 사이를 오감
+      const double phase = std::chrono::duration<double>(clock_type::now() - start).count() / 60.0;
+      const bool large = static_cast<long long>(phase * 2) % 2 == 1;
+      const std::size_t size = large ? 200 + rng() % 800 : 16 + rng() % 184;
+      s.set(key, payload.substr(0, size));
+    }
+
+    const auto now = clock_type::now();
+    if (now - last_cron >= std::chrono::milliseconds(100))
+    {
+      s.rehash_step(std::chrono::milliseconds(1));
+      s.defrag_step(std::chrono::milliseconds(1));
+      last_cron = now;
+    }
+    const double elapsed = std::chrono::duration<double>(now - start).count();
+    const double since_report = std::chrono::duration<double>(now - last_report).count();
+    if (since_report >= report_every || elapsed >= seconds)
+    {
+      const std::size_t rss = rss_bytes();
+      const std::size_t dataset = s.dataset_memory();
+      std::cout << std::setw(8) << std::fixed << std::setprecision(0) << elapsed << std::setw(12)
+                << (ops - report_ops) / since_report << std::setw(10) << s.dbsize() << std::setw(9)
+                << dataset / mib << "M" << std::setw(9) << rss / mib << "M" << std::setw(11) << std::setprecision(2)
+                << static_cast<double>(rss) / dataset << "\n";
+      report_ops = ops;
+      last_report = now;
+    }
+    if (elapsed >= seconds)
+    {
+      break;
+    }
+  }
+
+  const auto slabs = s.allocator_stats();
+  std::cout << "total ops/s: " << std::setprecision(0) << ops / seconds << "  rss start=" << rss_start / mib
+            << "M end=" << rss_bytes() / mib << "M";
+  if (slab)
+  {
+    std::cout << "  slabs=" << slabs.slabs << " slab bytes=" << slabs.slab_bytes() / mib
+              << "M live=" << slabs.live_bytes / mib << "M";
+  }
+  std::cout << "\n";
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "storage/store.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+* Counter benchmark: INCRBY on many rate-limit style counters.
+* Usage: counter_bench [counters] [increments]
+*
+* 전역 operator new를 교체하여 INCRBY 한 번당 힙 할당 횟수도 함께 측정합니다.
+* 큰 값(10^15 이상)에서 시작하는 카운터도 측정하여 std::string의 인라인 크기(SSO)를 넘는 경우를 확인합니다.
+*/
+
+namespace
+{
+  std::size_t g_allocs = 0;
+} // namespace
+
+void *operator new(std::size_t n)
+{
+  ++g_allocs;
+  if (void *p = std::malloc(n))
+  {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  void run(const char *name, mini_redis::store &s, const std::vector<std::string> &keys, std::size_t increments)
+  {
+    std::mt19937_64 rng(1);
+    std::vector<std::uint32_t> order(increments);
+    for (auto &i : order)
+    {
+      i = static_cast<std::uint32_t>(rng() % keys.size());
+    }
+
+    const std::size_t allocs_before = g_allocs;
+    const auto begin = clock_type::now();
+    long long sum = 0;
+    for (auto i : order)
+    {
+      sum += s.incrby(keys[i], 3);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(clock_type::now() - begin).count();
+    std::cout << std::setw(18) << name << std::setw(12) << std::fixed << std::setprecision(1) << ns / increments
+              << std::setw(16) << std::setprecision(3)
+              << static_cast<double>(g_allocs - allocs_before) / increments
+              << "   (checksum " << sum % 1000 << ")\n";
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t counters = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  const std::size_t increments = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000000;
+
+  std::vector<std::string> keys;
+  keys.reserve(counters);
+  for (std::size_t i = 0; i < counters; ++i)
+  {
+    keys.push_back("ratelimit:" + std::to_string(i));
+  }
+
+  std::cout << "counters=" << counters << " increments=" << increments << "\n"
+            << std::setw(18) << "start value" << std::setw(12) << "ns/op" << std::setw(16) << "allocs/op" << "\n";
+
+  mini_redis::store small;
+  for (const auto &key : keys)
+  {
+    small.set(key, "0");
+  }
+  run("0", small, keys, increments);
+
+  mini_redis::store large;
+  for (const auto &key : keys)
+  {
+    large.set(key, "1000000000000000");
+  }
+  run("10^15", large, keys, increments);
+  return 0;
+}
@@ -0,0 +1,131 @@
+#include "storage/store.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+* Eviction benchmark: cache-aside workload under maxmemory.
+* Usage: eviction_bench [keyspace] [requests] [cache_percent] [value_bytes]
+*
+* 키 인기도가 Zipf 분포(s=0.99)를 따르는 요청마다 GET을 하고, 없으면 SET으로 채웁니다.
+* maxmemory는 전체 키 공간을 담는 데 필요한 메모리의 cache_percent%로 잡고, 정책마다
+* 적중률, 요청 한 번의 평균 시간, SET 지연 p99, 축출된 키 수와 최종 메모리를 출력합니다.
+* 비교 대상으로 한도가 없는 경우(적중률은 처음 한 번씩의 miss를 제외하면 100%)도 측정합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  std::vector<std::uint32_t> zipf_requests(std::size_t keyspace, std::size_t requests)
+  {
+    std::vector<double> cdf(keyspace);
+    double sum = 0;
+    for (std::size_t i = 0; i < keyspace; ++i)
+    {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), 0.99);
+      cdf[i] = sum;
+    }
+    // 인기 순위와 키 번호가 겹치지 않도록 섞음 (같은 shard에 인기 키가 몰리지 않게)
+    std::vector<std::uint32_t> rank_to_key(keyspace);
+    for (std::size_t i = 0; i < keyspace; ++i)
+    {
+      rank_to_key[i] = static_cast<std::uint32_t>(i);
+    }
+    std::mt19937_64 rng(42);
+    std::shuffle(rank_to_key.begin(), rank_to_key.end(), rng);
+
+    std::uniform_real_distribution<double> u(0, sum);
+    std::vector<std::uint32_t> out(requests);
+    for (auto &r : out)
+    {
+      const auto rank = std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin();
+      r = rank_to_key[std::min<std::size_t>(rank, keyspace - 1)];
+    }
+    return out;
+  }
+
+  void run(const char *name, const mini_redis::store_config &config, const std::vector<std::string> &keys,
+           const std::vector<std::uint32_t> &requests, const std::string &value)
+  {
+    mini_redis::store s(config);
+    std::size_t hits = 0;
+    std::vector<double> set_ns;
+    set_ns.reserve(requests.size());
+
+    const auto begin = clock_type::now();
+    for (auto idx : requests)
+    {
+      if (s.get(keys[idx]))
+      {
+        ++hits;
+        continue;
+      }
+      const auto set_begin = clock_type::now();
+      s.set(keys[idx], value);
+      set_ns.push_back(std::chrono::duration<double, std::nano>(clock_type::now() - set_begin).count());
+    }
+    const double total_ns = std::chrono::duration<double, std::nano>(clock_type::now() - begin).count();
+
+    std::sort(set_ns.begin(), set_ns.end());
+    const double p99 = set_ns.empty() ? 0 : set_ns[set_ns.size() * 99 / 100];
+    std::cout << std::setw(14) << name << std::fixed << std::setprecision(1) << std::setw(10)
+              << 100.0 * hits / requests.size() << "%" << std::setw(10) << total_ns / requests.size()
+              << std::setw(12) << std::setprecision(0) << p99 << std::setw(12) << s.evicted_keys()
+              << std::setw(10) << s.dbsize() << std::setw(10) << s.dataset_memory() / (1024 * 1024) << "MiB"
+              << std::setw(8) << s.memory_usage() / (1024 * 1024) << "MiB\n";
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t keyspace = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  const std::size_t requests = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000000;
+  const unsigned cache_percent = argc > 3 ? std::atoi(argv[3]) : 20;
+  const std::size_t value_bytes = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 100;
+
+  std::vector<std::string> keys;
+  keys.reserve(keyspace);
+  for (std::size_t i = 0; i < keyspace; ++i)
+  {
+    keys.push_back("object:" + std::to_string(i));
+  }
+  const auto order = zipf_requests(keyspace, requests);
+  const std::string value(value_bytes, 'x');
+
+  // 전체 키 공간을 담았을 때의 메모리로 한도를 정함
+  std::size_t full_memory;
+  {
+    mini_redis::store s;
+    for (const auto &key : keys)
+    {
+      s.set(key, value);
+    }
+    full_memory = s.dataset_memory();
+  }
+
+  mini_redis::store_config config;
+  config.maxmemory = full_memory * cache_percent / 100;
+  std::cout << "keyspace=" << keyspace << " requests=" << requests << " value=" << value_bytes << "B"
+            << " maxmemory=" << config.maxmemory / (1024 * 1024) << "MiB (" << cache_percent << "% of "
+            << full_memory / (1024 * 1024) << "MiB)\n"
+            << std::setw(14) << "policy" << std::setw(11) << "hit rate" << std::setw(10) << "ns/req"
+            << std::setw(12) << "set p99 ns" << std::setw(12) << "evicted" << std::setw(10) << "keys"
+            << std::setw(13) << "dataset" << std::setw(11) << "used\n";
+
+  for (auto policy : {mini_redis::eviction_policy::allkeys_lru, mini_redis::eviction_policy::allkeys_lfu})
+  {
+    config.maxmemory_policy = policy;
+    run(mini_redis::eviction_policy_name(policy), config, keys, order, value);
+  }
+
+  mini_redis::store_config unlimited;
+  run("no limit", unlimited, keys, order, value);
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "storage/store.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+/*
+* Active expiry benchmark: a burst of short-TTL writes that are never read again.
+* Usage: expire_burst_bench [volatile_keys] [persistent_keys]
+*
+* 서버 cron과 같은 방식(tick마다 active_expire_cycle + rehash_step)으로 만료 키를 회수하며,
+* 키 공간 메모리가 burst 이전 수준으로 돌아오기까지 필요한 tick 수와 CPU 시간을 출력합니다.
+* tick 사이의 100ms 대기는 생략하고 연속으로 실행합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  double ms_since(clock_type::time_point begin)
+  {
+    return std::chrono::duration<double, std::milli>(clock_type::now() - begin).count();
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t volatile_keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  const std::size_t persistent_keys = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+
+  mini_redis::store s;
+  for (std::size_t i = 0; i < persistent_keys; ++i)
+  {
+    s.set("persistent:" + std::to_string(i), std::string(32, 'v'));
+  }
+  for (int i = 0; i < 50; ++i)
+  {
+    s.rehash_step(std::chrono::milliseconds(10));
+  }
+  const auto baseline = s.memory_usage();
+
+  for (std::size_t i = 0; i < volatile_keys; ++i)
+  {
+    s.setex("session:" + std::to_string(i), 1, std::string(32, 'v'));
+  }
+  const auto peak = s.memory_usage();
+  std::cout << "persistent=" << persistent_keys << " volatile=" << volatile_keys << " (ttl 1s)\n"
+            << "memory baseline=" << baseline / 1024 << "KiB peak=" << peak / 1024 << "KiB\n";
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+  // 서버의 run_cron과 같은 예산 규칙
+  std::size_t ticks = 0;
+  std::size_t expired = 0;
+  double expire_ms = 0;
+  double rehash_ms = 0;
+  std::cout << std::setw(6) << "tick" << std::setw(10) << "expired" << std::setw(10) << "stale%"
+            << std::setw(12) << "memory(KiB)" << "\n";
+  while (s.memory_usage() > baseline && ticks < 100000)
+  {
+    const auto budget = s.expired_stale_ratio() > 0.1 ? std::chrono::microseconds(25000)
+                                                      : std::chrono::microseconds(1000);
+    auto begin = clock_type::now();
+    expired += s.active_expire_cycle(budget).expired;
+    expire_ms += ms_since(begin);
+
+    begin = clock_type::now();
+    s.rehash_step(std::chrono::milliseconds(1));
+    rehash_ms += ms_since(begin);
+
+    ++ticks;
+    if (ticks % 10 == 0)
+    {
+      std::cout << std::setw(6) << ticks << std::setw(10) << expired << std::setw(10) << std::fixed
+                << std::setprecision(1) << s.expired_stale_ratio() * 100 << std::setw(12)
+                << s.memory_usage() / 1024 << "\n";
+    }
+  }
+
+  std::cout << "reclaimed " << expired << " keys in " << ticks << " ticks (" << ticks * 100 / 1000.0
+            << "s of server time), expiry cpu=" << std::setprecision(1) << expire_ms
+            << "ms (" << std::setprecision(0) << (expired ? expire_ms * 1e6 / expired : 0)
+            << "ns/key), shrink/rehash cpu=" << std::setprecision(1) << rehash_ms << "ms\n"
+            << "memory final=" << s.memory_usage() / 1024 << "KiB\n";
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include "storage/store.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+/*
+* Expiry index benchmark: CPU cost of reclaiming expired keys.
+* Usage: expiry_index_bench [keys] [volatile_percent] [min_ttl_ms] [max_ttl_ms]
+*
+* keys개 중 volatile_percent%에 min_ttl_ms ~ max_ttl_ms 사이의 TTL을 주고, 서버 cron처럼
+* active_expire_cycle을 주기적으로 호출하여 모든 TTL 키가 회수될 때까지 걸린 CPU 시간을 측정합니다.
+* 비교 대상으로, 이전에 만료 키를 정리하던 유일한 경로였던 키 공간 전체 순회(KEYS) 한 번의 비용도 출력합니다.
+* min_ttl_ms는 적재와 전체 순회가 끝나기 전에 키가 만료되지 않을 만큼 길게 잡습니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  double ms_since(clock_type::time_point begin)
+  {
+    return std::chrono::duration<double, std::milli>(clock_type::now() - begin).count();
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+  const unsigned volatile_percent = argc > 2 ? std::atoi(argv[2]) : 50;
+  const long long min_ttl_ms = argc > 3 ? std::atoll(argv[3]) : 20000;
+  const long long max_ttl_ms = argc > 4 ? std::atoll(argv[4]) : 25000;
+
+  mini_redis::store s;
+  std::mt19937_64 rng(7);
+  std::uniform_int_distribution<unsigned> percent(0, 99);
+  std::uniform_int_distribution<long long> ttl(min_ttl_ms, max_ttl_ms);
+  std::size_t volatile_keys = 0;
+
+  auto begin = clock_type::now();
+  for (std::size_t i = 0; i < keys; ++i)
+  {
+    std::string key = "key:" + std::to_string(i);
+    if (percent(rng) < volatile_percent)
+    {
+      s.psetex(key, ttl(rng), "value");
+      ++volatile_keys;
+    }
+    else
+    {
+      s.set(key, "value");
+    }
+  }
+  std::cout << "keys=" << keys << " volatile=" << volatile_keys << " ttl=" << min_ttl_ms << ".." << max_ttl_ms << "ms"
+            << " load=" << std::fixed << std::setprecision(0) << ms_since(begin) << "ms"
+            << " memory=" << s.memory_usage() / (1024 * 1024) << "MiB\n";
+
+  // 이전 구현에서 만료 키를 회수하던 전체 순회 (패턴은 어떤 키와도 일치하지 않음)
+  begin = clock_type::now();
+  s.keys("nomatch:*");
+  const double walk_ms = ms_since(begin);
+  std::cout << "full keyspace walk: " << std::setprecision(1) << walk_ms << "ms ("
+            << std::setprecision(0) << walk_ms * 1e6 / keys << "ns per key in the keyspace)\n";
+
+  // 10ms마다 cron 한 번 (서버는 100ms 주기지만 측정 시간을 줄이기 위해 더 자주 실행)
+  std::size_t expired = 0;
+  std::size_t checked = 0;
+  std::size_t cycles = 0;
+  double cycle_ms = 0;
+  double max_cycle_ms = 0;
+  const auto start = clock_type::now();
+  while (expired < volatile_keys && ms_since(start) < max_ttl_ms + 10000)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    begin = clock_type::now();
+    auto result = s.active_expire_cycle(std::chrono::milliseconds(25));
+    const double ms = ms_since(begin);
+    cycle_ms += ms;
+    max_cycle_ms = std::max(max_cycle_ms, ms);
+    expired += result.expired;
+    checked += result.sampled;
+    ++cycles;
+  }
+
+  std::cout << "reclaimed " << expired << "/" << volatile_keys << " keys (" << checked << " index entries checked) in "
+            << cycles << " cycles\n"
+            << "expiry cpu: total=" << std::setprecision(1) << cycle_ms << "ms per-key="
+            << std::setprecision(0) << (expired ? cycle_ms * 1e6 / expired : 0) << "ns"
+            << " max-cycle=" << std::setprecision(2) << max_cycle_ms << "ms\n"
+            << "memory after: " << s.memory_usage() / (1024 * 1024) << "MiB\n";
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include "storage/glob.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+* Glob matcher benchmark: the previous byte-at-a-time backtracking matcher vs the compiled glob_pattern.
+* Usage: glob_bench [keys] [rounds]
+*
+* 자주 쓰이는 키 모양(짧은 id 키, 긴 URL 형태의 캐시 키)과 패턴(접두사, 접미사, 가운데 리터럴, ?)에 대해
+* 키 하나당 평균 매칭 시간(ns)을 출력합니다. 이전 구현은 [...]와 \를 지원하지 않으므로
+* 해당 패턴은 컴파일된 패턴만 측정합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  // 이전 store::keys의 glob_match (* 와 ?만 지원, 실패하면 * 위치부터 한 글자씩 되돌아감)
+  bool backtracking_match(const std::string &pattern, const std::string &text)
+  {
+    size_t p_idx = 0, t_idx = 0;
+    size_t p_len = pattern.length(), t_len = text.length();
+    size_t star_idx = std::string::npos, t_match_idx = 0;
+    while (t_idx < t_len)
+    {
+      if (p_idx < p_len && (pattern[p_idx] == '?' || pattern[p_idx] == text[t_idx]))
+      {
+        p_idx++;
+        t_idx++;
+      }
+      else if (p_idx < p_len && pattern[p_idx] == '*')
+      {
+        star_idx = p_idx;
+        t_match_idx = t_idx;
+        p_idx++;
+      }
+      else if (star_idx != std::string::npos)
+      {
+        p_idx = star_idx + 1;
+        t_idx = ++t_match_idx;
+      }
+      else
+      {
+        return false;
+      }
+    }
+    while (p_idx < p_len && pattern[p_idx] == '*')
+    {
+      p_idx++;
+    }
+    return p_idx == p_len;
+  }
+
+  template <typename Fn>
+  double ns_per_key(const std::vector<std::string> &keys, int rounds, std::size_t &matched, Fn &&fn)
+  {
+    matched = 0;
+    const auto start = clock_type::now();
+    for (int r = 0; r < rounds; ++r)
+    {
+      for (const auto &key : keys)
+      {
+        matched += fn(key);
+      }
+    }
+    return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / (keys.size() * rounds);
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  const int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  std::mt19937_64 rng(5);
+  std::vector<std::string> short_keys, url_keys;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    short_keys.push_back((i % 3 ? "user:" : "session:") + std::to_string(rng() % 1000000) +
+                         (i % 2 ? ":profile" : ":settings"));
+    url_keys.push_back("cache:v2:/api/" + std::string(i % 4 ? "users/" : "products/") + std::to_string(rng() % 100000) +
+                       "/orders?page=" + std::to_string(rng() % 50) + "&sort=created_at&fields=id,total,status");
+  }
+
+  struct workload
+  {
+    const char *name;
+    const std::vector<std::string> *keys;
+    std::string pattern;
+    bool legacy_syntax; // 이전 구현도 지원하는 패턴인지
+  };
+  const std::vector<workload> workloads = {
+      {"prefix", &short_keys, "user:*", true},
+      {"suffix", &short_keys, "*:profile", true},
+      {"prefix+suffix", &short_keys, "user:*:profile", true},
+      {"question", &short_keys, "user:4?????:*", true},
+      {"url middle", &url_keys, "*orders?page=1&*", true},
+      {"url two parts", &url_keys, "cache:*/products/*status", true},
+      {"url miss", &url_keys, "*fields=name*", true},
+      {"class", &short_keys, "user:[0-4]*:profile", false},
+      {"escape", &url_keys, "*\\?page=4[0-9]&*", false},
+  };
+
+  std::cout << std::left << std::setw(16) << "workload" << std::setw(30) << "pattern" << std::right << std::setw(12)
+            << "old ns/key" << std::setw(12) << "new ns/key" << std::setw(10) << "speedup" << std::setw(10)
+            << "matched\n";
+  for (const auto &w : workloads)
+  {
+    std::size_t matched_new = 0, matched_old = 0;
+    const auto compiled = mini_redis::glob_cache::global().get(w.pattern);
+    const double new_ns = ns_per_key(*w.keys, rounds, matched_new, [&](const std::string &k) { return compiled->match(k); });
+    std::cout << std::left << std::setw(16) << w.name << std::setw(30) << w.pattern << std::right << std::fixed
+              << std::setprecision(1);
+    if (w.legacy_syntax)
+    {
+      const double old_ns =
+          ns_per_key(*w.keys, rounds, matched_old, [&](const std::string &k) { return backtracking_match(w.pattern, k); });
+      std::cout << std::setw(12) << old_ns << std::setw(12) << new_ns << std::setw(9) << old_ns / new_ns << "x";
+      if (matched_old != matched_new)
+      {
+        std::cout << "  (MISMATCH old=" << matched_old / rounds << ")";
+      }
+    }
+    else
+    {
+      std::cout << std::setw(12) << "-" << std::setw(12) << new_ns << std::setw(10) << "-";
+    }
+    std::cout << std::setw(10) << matched_new / rounds << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include "storage/compact_hash.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+* Small HASH benchmark: std::unordered_map<std::string, std::string> vs compact_hash (listpack encoding).
+* Usage: hash_bench [hashes] [lookups]
+*
+* 사용자 프로필 형태의 hash(필드 5/10/20개, 짧은 필드 이름과 값)를 hashes개 만들고,
+* hash 하나당 실제 힙 사용량(glibc mallinfo2 증가분)과 HGET 한 번의 평균 시간(ns)을 출력합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+  using naive_hash = std::unordered_map<std::string, std::string>;
+
+  const char *field_names[] = {"name",    "email",   "age",     "city",     "country", "plan",   "created",
+                               "updated", "locale",  "tz",      "avatar",   "status",  "role",   "score",
+                               "level",   "referrer", "device", "last_ip", "verified", "notes"};
+
+  std::string field_value(std::size_t hash, std::size_t field)
+  {
+    switch (field % 4)
+    {
+    case 0:
+      return "user" + std::to_string(hash);
+    case 1:
+      return std::to_string(hash * 31 + field);
+    case 2:
+      return "seoul";
+    default:
+      return "u" + std::to_string(hash) + "@example.com";
+    }
+  }
+
+  std::size_t heap_in_use()
+  {
+    return mallinfo2().uordblks;
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t hashes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  const std::size_t lookups = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5000000;
+
+  std::cout << std::left << std::setw(8) << "fields" << std::right << std::setw(12) << "payload" << std::setw(16)
+            << "map B/hash" << std::setw(18) << "listpack B/hash" << std::setw(10) << "ratio" << std::setw(14)
+            << "map HGET ns" << std::setw(18) << "listpack HGET ns\n";
+  for (std::size_t fields : {5, 10, 20})
+  {
+    std::size_t payload = 0;
+    for (std::size_t f = 0; f < fields; ++f)
+    {
+      payload += std::string(field_names[f]).size() + field_value(0, f).size();
+    }
+
+    std::size_t before = heap_in_use();
+    std::vector<std::unique_ptr<naive_hash>> naive;
+    naive.reserve(hashes);
+    for (std::size_t i = 0; i < hashes; ++i)
+    {
+      auto h = std::make_unique<naive_hash>();
+      for (std::size_t f = 0; f < fields; ++f)
+      {
+        (*h)[field_names[f]] = field_value(i, f);
+      }
+      naive.push_back(std::move(h));
+    }
+    const double naive_bytes = static_cast<double>(heap_in_use() - before - hashes * sizeof(void *)) / hashes;
+
+    before = heap_in_use();
+    std::vector<std::unique_ptr<mini_redis::compact_hash>> compact;
+    compact.reserve(hashes);
+    for (std::size_t i = 0; i < hashes; ++i)
+    {
+      auto h = std::make_unique<mini_redis::compact_hash>();
+      for (std::size_t f = 0; f < fields; ++f)
+      {
+        h->set(field_names[f], field_value(i, f));
+      }
+      compact.push_back(std::move(h));
+    }
+    const double compact_bytes = static_cast<double>(heap_in_use() - before - hashes * sizeof(void *)) / hashes;
+
+    // 무작위 hash의 무작위 필드 조회 (캐시 미스 포함)
+    std::vector<std::string> probe_fields(field_names, field_names + fields);
+    std::size_t found = 0;
+    auto start = clock_type::now();
+    for (std::size_t i = 0; i < lookups; ++i)
+    {
+      // HGET처럼 값을 복사해서 반환
+      const auto &h = *naive[(i * 2654435761u) % hashes];
+      auto it = h.find(probe_fields[i % fields]);
+      found += (it == h.end() ? std::nullopt : std::optional<std::string>(it->second)).has_value();
+    }
+    const double naive_ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / lookups;
+    start = clock_type::now();
+    for (std::size_t i = 0; i < lookups; ++i)
+    {
+      const auto &h = *compact[(i * 2654435761u) % hashes];
+      found += h.get(probe_fields[i % fields]).has_value();
+    }
+    const double compact_ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / lookups;
+
+    std::cout << std::left << std::setw(8) << fields << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << static_cast<double>(payload) << std::setw(16) << naive_bytes << std::setw(18)
+              << compact_bytes << std::setw(9) << naive_bytes / compact_bytes << "x" << std::setw(14) << naive_ns
+              << std::setw(17) << compact_ns << (found == 2 * lookups ? "" : "  (lookup mismatch)") << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,161 @@
+#include "storage/hyperloglog.hpp"
+#include "storage/store.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/*
+* HyperLogLog benchmark: unique counting with PFADD/PFCOUNT vs an exact std::unordered_set<std::string>.
+* Usage: hll_bench [elements] [exact_elements]
+*
+* 서로 다른 원소 elements개(기본 100M)를 HyperLogLog에 넣으며 초당 처리량과 10배마다의 상대 오차를,
+* exact_elements개(기본 10M, 메모리 때문에 따로 제한)를 해시 집합에 넣으며 처리량과 힙 사용량
+* (glibc mallinfo2 증가분)을 출력합니다. 이어서 store를 거친 PFADD(100개씩), 캐시가 있을 때와 없을 때의
+* PFCOUNT, dense 키 16개의 PFMERGE와 여러 키 PFCOUNT 한 번의 시간을 잽니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  std::size_t heap_in_use()
+  {
+    return mallinfo2().uordblks;
+  }
+
+  double seconds_since(clock_type::time_point start)
+  {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+  }
+
+  std::string visitor(std::size_t i)
+  {
+    return "visitor:" + std::to_string(i);
+  }
+
+  double error_percent(std::uint64_t estimate, std::size_t exact)
+  {
+    return std::fabs(static_cast<double>(estimate) - static_cast<double>(exact)) * 100.0 / static_cast<double>(exact);
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000000;
+  const std::size_t exact_elements =
+      std::min(elements, argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::size_t(10000000));
+  std::cout << std::fixed;
+
+  std::size_t checksum = 0;
+  {
+    const std::size_t heap_before = heap_in_use();
+    mini_redis::hyperloglog hll;
+    std::size_t checkpoint = 1000;
+    double worst = 0;
+    const auto start = clock_type::now();
+    for (std::size_t i = 1; i <= elements; ++i)
+    {
+      checksum += hll.add(visitor(i));
+      if (i == checkpoint)
+      {
+        worst = std::max(worst, error_percent(hll.count(), i));
+        checkpoint *= 10;
+      }
+    }
+    const double seconds = seconds_since(start);
+    const auto estimate = hll.count();
+    std::cout << "hyperloglog:   " << elements << " distinct, " << std::setprecision(2)
+              << static_cast<double>(elements) / seconds / 1e6 << " M adds/s, " << heap_in_use() - heap_before
+              << " bytes, estimate " << estimate << " (" << error_percent(estimate, elements)
+              << "% off, worst checkpoint " << worst << "%)\n";
+  }
+
+  {
+    const std::size_t heap_before = heap_in_use();
+    std::unordered_set<std::string> exact;
+    const auto start = clock_type::now();
+    for (std::size_t i = 1; i <= exact_elements; ++i)
+    {
+      exact.insert(visitor(i));
+    }
+    const double seconds = seconds_since(start);
+    const std::size_t bytes = heap_in_use() - heap_before;
+    std::cout << "unordered_set: " << exact_elements << " distinct, " << std::setprecision(2)
+              << static_cast<double>(exact_elements) / seconds / 1e6 << " M adds/s, " << bytes << " bytes ("
+              << std::setprecision(1) << static_cast<double>(bytes) / static_cast<double>(exact_elements)
+              << " B/element)\n";
+    checksum += exact.size();
+  }
+
+  {
+    // store 경로: 키 16개에 100개씩 PFADD, 그다음 PFCOUNT와 PFMERGE
+    mini_redis::store store_instance;
+    const std::size_t keys = 16, batch = 100;
+    const std::size_t per_key = std::max<std::size_t>(batch, std::min<std::size_t>(elements / keys, 1000000));
+    std::vector<std::string> args(batch);
+    auto start = clock_type::now();
+    for (std::size_t k = 0; k < keys; ++k)
+    {
+      const std::string key = "hll:" + std::to_string(k);
+      for (std::size_t i = 0; i + batch <= per_key; i += batch)
+      {
+        for (std::size_t j = 0; j < batch; ++j)
+        {
+          args[j] = visitor(k * per_key / 2 + i + j);
+        }
+        checksum += store_instance.pfadd(key, args);
+      }
+    }
+    const double pfadd = seconds_since(start);
+
+    const std::size_t rounds = 1000;
+    start = clock_type::now();
+    for (std::size_t r = 0; r < rounds; ++r)
+    {
+      checksum += store_instance.pfcount({"hll:0"});
+    }
+    const double cached = seconds_since(start) / rounds;
+    start = clock_type::now();
+    for (std::size_t r = 0; r < rounds; ++r)
+    {
+      // 원소 하나를 더해 캐시를 버린 뒤 세기 (대부분 register가 바뀌지 않으므로 바뀐 경우만 다시 계산)
+      store_instance.pfadd("hll:0", {visitor(elements + r)});
+      checksum += store_instance.pfcount({"hll:0"});
+    }
+    const double fresh = seconds_since(start) / rounds;
+
+    std::vector<std::string> sources;
+    for (std::size_t k = 0; k < keys; ++k)
+    {
+      sources.push_back("hll:" + std::to_string(k));
+    }
+    start = clock_type::now();
+    for (std::size_t r = 0; r < 100; ++r)
+    {
+      store_instance.pfmerge("merged", sources);
+    }
+    const double pfmerge = seconds_since(start) / 100;
+    start = clock_type::now();
+    for (std::size_t r = 0; r < 100; ++r)
+    {
+      checksum += store_instance.pfcount(sources);
+    }
+    const double multi = seconds_since(start) / 100;
+
+    std::cout << "store: PFADD " << std::setprecision(2)
+              << static_cast<double>(keys * per_key) / pfadd / 1e6 << " M elements/s (batches of " << batch
+              << "), PFCOUNT cached " << std::setprecision(0) << cached * 1e9 << " ns, after PFADD "
+              << fresh * 1e9 << " ns, PFMERGE of " << keys << " dense keys " << pfmerge * 1e6
+              << " us, PFCOUNT of " << keys << " keys " << multi * 1e6 << " us, union estimate "
+              << store_instance.pfcount({"merged"}) << " (exact " << (keys + 1) * per_key / 2 << ")\n";
+  }
+  std::cout << "(checksum " << checksum << ")\n";
+  return 0;
+}
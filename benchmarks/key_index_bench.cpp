@@ -0,0 +1,71 @@
+#include "storage/store.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/*
+* Key index benchmark: KEYS with a literal prefix, with and without the radix-tree key index.
+* Usage: key_index_bench [keys] [repeats]
+*
+* "session:<0~99>:<id>" 형태의 키 keys개를 넣고 1%만 일치하는 "session:42:*"로 KEYS를 실행합니다.
+* 인덱스가 없으면 모든 키에 glob_match를 실행하고, 있으면 접두사의 하위 트리만 방문합니다.
+* 두 store를 차례로 만들고 해제하므로 최대 메모리는 store 하나 분량입니다.
+* KEYS 평균 시간과 키 공간 메모리(store::memory_usage), 키당 인덱스 오버헤드를 출력합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  struct result
+  {
+    double keys_ms = 0;
+    std::size_t found = 0;
+    std::size_t memory = 0;
+  };
+
+  result run(bool key_index, std::size_t keys, int repeats)
+  {
+    mini_redis::store_config config;
+    config.key_index = key_index;
+    mini_redis::store s(config);
+    for (std::size_t i = 0; i < keys; ++i)
+    {
+      s.set("session:" + std::to_string(i % 100) + ":" + std::to_string(i), "v");
+    }
+    s.rehash_step(std::chrono::seconds(60));
+
+    result r;
+    r.memory = s.memory_usage();
+    const auto start = clock_type::now();
+    for (int i = 0; i < repeats; ++i)
+    {
+      r.found = s.keys("session:42:*").size();
+    }
+    r.keys_ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count() / repeats;
+    return r;
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+  const int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  const result plain = run(false, keys, repeats);
+  const result indexed = run(true, keys, repeats);
+
+  constexpr double mib = 1024.0 * 1024.0;
+  std::cout << "keys=" << keys << " pattern=session:42:* (1%)\n"
+            << std::fixed << std::setprecision(1)
+            << "no index   KEYS " << std::setw(9) << plain.keys_ms << " ms  found=" << plain.found
+            << "  memory=" << plain.memory / mib << " MiB\n"
+            << "key index  KEYS " << std::setw(9) << indexed.keys_ms << " ms  found=" << indexed.found
+            << "  memory=" << indexed.memory / mib << " MiB\n"
+            << "speedup " << plain.keys_ms / indexed.keys_ms << "x  index overhead "
+            << (indexed.memory - plain.memory) / mib << " MiB ("
+            << static_cast<double>(indexed.memory - plain.memory) / keys << " bytes/key)\n";
+  return 0;
+}
@@ -0,0 +1,224 @@
+#include "storage/flat_table.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+/*
+* Keyspace table microbenchmark: flat_table vs the previous std::unordered_map layout.
+* Usage: keyspace_table_bench [keys]
+*
+* 전역 operator new/delete를 교체하여 각 자료구조가 실제로 요청한 힙 메모리(bytes/key)와
+* 할당 횟수를 측정하고, 삽입/조회(hit, miss) 시간을 비교합니다.
+*/
+
+namespace
+{
+  std::size_t g_live_bytes = 0;
+  std::size_t g_live_allocs = 0;
+  constexpr std::size_t header = alignof(std::max_align_t);
+
+  // 이전 store의 value_entry 레이아웃 (컨테이너 다섯 개의 variant + optional 만료 시간)
+  struct legacy_entry
+  {
+    std::variant<std::string,
+                 std::list<std::string>,
+                 std::unordered_map<std::string, std::string>,
+                 std::unordered_set<std::string>,
+                 std::map<double, std::string>>
+        value;
+    std::optional<std::chrono::steady_clock::time_point> expiry;
+  };
+} // namespace
+
+void *operator new(std::size_t n)
+{
+  auto *p = static_cast<char *>(std::malloc(n + header));
+  if (!p)
+  {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<std::size_t *>(p) = n;
+  g_live_bytes += n;
+  ++g_live_allocs;
+  return p + header;
+}
+
+void operator delete(void *ptr) noexcept
+{
+  if (!ptr)
+  {
+    return;
+  }
+  auto *p = static_cast<char *>(ptr) - header;
+  g_live_bytes -= *reinterpret_cast<std::size_t *>(p);
+  --g_live_allocs;
+  std::free(p);
+}
+
+void *operator new[](std::size_t n) { return operator new(n); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { operator delete(ptr); }
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  double ns_per_op(clock_type::time_point begin, std::size_t ops)
+  {
+    return std::chrono::duration<double, std::nano>(clock_type::now() - begin).count() / ops;
+  }
+
+  struct result
+  {
+    double insert_ns;
+    double hit_ns;
+    double miss_ns;
+    double bytes_per_key;
+    double allocs_per_key;
+  };
+
+  result bench_unordered_map(const std::vector<std::string> &keys, const std::vector<std::string> &misses)
+  {
+    result r{};
+    std::size_t base_bytes = g_live_bytes, base_allocs = g_live_allocs;
+    {
+      std::unordered_map<std::string, legacy_entry> table;
+      auto begin = clock_type::now();
+      for (const auto &k : keys)
+      {
+        table[k] = {std::string("value"), std::nullopt};
+      }
+      r.insert_ns = ns_per_op(begin, keys.size());
+      r.bytes_per_key = static_cast<double>(g_live_bytes - base_bytes) / keys.size();
+      r.allocs_per_key = static_cast<double>(g_live_allocs - base_allocs) / keys.size();
+
+      std::size_t found = 0;
+      begin = clock_type::now();
+      for (const auto &k : keys)
+      {
+        found += table.find(k) != table.end();
+      }
+      r.hit_ns = ns_per_op(begin, keys.size());
+      begin = clock_type::now();
+      for (const auto &k : misses)
+      {
+        found += table.find(k) != table.end();
+      }
+      r.miss_ns = ns_per_op(begin, misses.size());
+      if (found != keys.size())
+      {
+        std::cerr << "unexpected lookup result\n";
+      }
+    }
+    return r;
+  }
+
+  result bench_flat_table(const std::vector<std::string> &keys, const std::vector<std::string> &misses)
+  {
+    using mini_redis::flat_table;
+    result r{};
+    std::size_t base_bytes = g_live_bytes, base_allocs = g_live_allocs;
+    {
+      flat_table table;
+      auto begin = clock_type::now();
+      for (const auto &k : keys)
+      {
+        auto *entry = table.try_emplace(k, flat_table::hash(k)).first;
+        entry->value = std::string("value");
+      }
+      r.insert_ns = ns_per_op(begin, keys.size());
+      r.bytes_per_key = static_cast<double>(g_live_bytes - base_bytes) / keys.size();
+      r.allocs_per_key = static_cast<double>(g_live_allocs - base_allocs) / keys.size();
+
+      std::size_t found = 0;
+      begin = clock_type::now();
+      for (const auto &k : keys)
+      {
+        found += table.find(k, flat_table::hash(k)) != nullptr;
+      }
+      r.hit_ns = ns_per_op(begin, keys.size());
+      begin = clock_type::now();
+      for (const auto &k : misses)
+      {
+        found += table.find(k, flat_table::hash(k)) != nullptr;
+      }
+      r.miss_ns = ns_per_op(begin, misses.size());
+      if (found != keys.size())
+      {
+        std::cerr << "unexpected lookup result\n";
+      }
+    }
+    return r;
+  }
+
+  void print(const char *name, const result &r)
+  {
+    std::cout << std::setw(16) << name << std::fixed << std::setprecision(1)
+              << std::setw(12) << r.insert_ns << std::setw(10) << r.hit_ns << std::setw(10) << r.miss_ns
+              << std::setw(13) << r.bytes_per_key << std::setw(13) << std::setprecision(2) << r.allocs_per_key
+              << std::setw(15) << std::setprecision(1) << r.bytes_per_key + 16 * r.allocs_per_key << "\n";
+  }
+
+  void run(const char *shape, const std::vector<std::string> &keys, const std::vector<std::string> &misses)
+  {
+    std::cout << "\n[" << shape << "] keys=" << keys.size() << "\n";
+    std::cout << std::setw(16) << "layout" << std::setw(12) << "insert(ns)" << std::setw(10) << "hit(ns)"
+              << std::setw(10) << "miss(ns)" << std::setw(13) << "bytes/key" << std::setw(13) << "allocs/key"
+              << std::setw(15) << "~malloc'd/key" << "\n";
+    print("unordered_map", bench_unordered_map(keys, misses));
+    print("flat_table", bench_flat_table(keys, misses));
+  }
+} // namespace
+
+void run_size(std::size_t n)
+{
+  std::mt19937_64 rng(7);
+  std::vector<std::string> short_keys, long_keys, misses;
+  short_keys.reserve(n);
+  long_keys.reserve(n);
+  misses.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    short_keys.push_back("user:" + std::to_string(i));
+    long_keys.push_back("session:" + std::to_string(rng()) + ":" + std::to_string(i));
+    misses.push_back("missing:" + std::to_string(i));
+  }
+
+  run("short keys, e.g. user:123", short_keys, misses);
+  run("long keys, e.g. session:<u64>:<n>", long_keys, misses);
+}
+
+int main(int argc, char **argv)
+{
+  std::cout << "value = 5-byte string, no expiry. bytes/key counts requested heap bytes (excluding the keys vector);\n"
+            << "~malloc'd/key adds ~16 bytes of glibc allocator overhead per allocation.\n";
+
+  // flat_table은 2의 거듭제곱 용량에 최대 load factor 7/8이므로,
+  // 확장 직전(load ~0.86)과 직후(load ~0.48)를 모두 측정하여 최선/최악을 함께 보여줌
+  std::vector<std::size_t> sizes;
+  for (int i = 1; i < argc; ++i)
+  {
+    sizes.push_back(std::strtoul(argv[i], nullptr, 10));
+  }
+  if (sizes.empty())
+  {
+    sizes = {900000, 1000000};
+  }
+  for (auto n : sizes)
+  {
+    run_size(n);
+  }
+  return 0;
+}
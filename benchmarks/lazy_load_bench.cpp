@@ -0,0 +1,172 @@
+#include "storage/store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Lazy load benchmark: time until a restarted store can serve, and GET latency while the rest of
+* the snapshot is still being loaded in the background.
+* Usage: lazy_load_bench [keys] [clients] [dir]
+*
+* keys개(기본 3M)의 키로 (snapshot_load_bench와 같은 구성) 스냅샷을 저장한 뒤,
+*   1. load_snapshot(): 모든 키를 읽은 뒤에야 요청을 받을 수 있는 시간
+*   2. load_snapshot_lazily(): 돌아올 때까지의 시간 (이후 바로 요청을 받음)과, 그 직후부터 clients개
+*      (기본 2, 0이면 보내지 않음)의 스레드가 임의의 키에 GET을 보내는 동안 백그라운드 적재가 끝나는 데 걸린 시간,
+*      그 사이 GET 지연의 p50 / p99 / p99.9 / 최대값과 처음 접근하여 파일에서 읽은 키 수
+*   3. 적재가 끝난 뒤 같은 수의 GET 지연 (비교용)
+* 을 출력합니다. 처음 보는 chunk의 checksum 확인(최대 1MB)이 지연의 상한을 정하며, 코어가 하나뿐이면
+* 백그라운드 스레드와 클라이언트가 CPU를 나누어 쓰므로 꼬리 지연이 스케줄링에 좌우됩니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  struct latencies
+  {
+    std::vector<long long> ns;
+
+    double percentile(double p)
+    {
+      if (ns.empty())
+      {
+        return 0;
+      }
+      std::sort(ns.begin(), ns.end());
+      return ns[std::min(ns.size() - 1, static_cast<std::size_t>(p / 100.0 * ns.size()))] / 1000.0;
+    }
+  };
+
+  // stop이 켜질 때까지 (또는 limit개까지) 임의의 키를 GET하고 지연을 모음
+  latencies run_gets(mini_redis::store &s, std::size_t keys, std::size_t clients, const std::atomic<bool> &stop,
+                     std::size_t limit)
+  {
+    std::vector<latencies> results(clients);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < clients; ++t)
+    {
+      threads.emplace_back([&, t] {
+        std::mt19937_64 rng(t + 1);
+        auto &out = results[t].ns;
+        while (!stop.load(std::memory_order_relaxed) && out.size() < limit)
+        {
+          const std::string key = "bench:key:" + std::to_string(rng() % keys);
+          const auto start = clock_type::now();
+          // 끝자리가 0, 1인 키는 HASH
+          if (key.back() == '0' || key.back() == '1')
+          {
+            s.hget(key, "name");
+          }
+          else
+          {
+            s.get(key);
+          }
+          out.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count());
+        }
+      });
+    }
+    for (auto &t : threads)
+    {
+      t.join();
+    }
+    latencies all;
+    for (auto &r : results)
+    {
+      all.ns.insert(all.ns.end(), r.ns.begin(), r.ns.end());
+    }
+    return all;
+  }
+
+  void print(const char *label, latencies &l)
+  {
+    std::cout << label << std::setw(9) << l.ns.size() << " GETs, p50 " << l.percentile(50) << " us, p99 "
+              << l.percentile(99) << " us, p99.9 " << l.percentile(99.9) << " us, max " << l.percentile(100)
+              << " us\n";
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 3000000;
+  const std::size_t clients = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2;
+  const std::string dir = argc > 3 ? argv[3] : ".";
+  std::cout << std::fixed << std::setprecision(2);
+
+  mini_redis::store_config config;
+  config.dir = dir;
+  config.dbfilename = "lazy_load_bench.rdb";
+  const std::string path = dir + "/" + config.dbfilename;
+
+  {
+    mini_redis::store s(config);
+    const std::string long_value(100, 'v');
+    for (std::size_t i = 0; i < keys; ++i)
+    {
+      const std::string key = "bench:key:" + std::to_string(i);
+      switch (i % 10)
+      {
+      case 0:
+      case 1:
+        s.hset(key, {{"name", "user" + std::to_string(i)}, {"age", std::to_string(i % 90)}, {"city", "Seoul"},
+                     {"score", std::to_string(i * 7)}, {"plan", "pro"}, {"active", "1"}, {"ref", key},
+                     {"note", long_value.substr(0, 24)}});
+        break;
+      case 2:
+        s.setex(key, 3600, std::to_string(i));
+        break;
+      default:
+        s.set(key, i % 2 ? std::to_string(i) : long_value.substr(0, 16 + i % 85));
+      }
+    }
+    s.save();
+  }
+  std::cout << "snapshot: " << keys << " keys, " << std::filesystem::file_size(path) / double(1 << 20) << " MB, "
+            << std::thread::hardware_concurrency() << " cores, " << clients << " clients\n";
+
+  {
+    mini_redis::store s(config);
+    const auto loaded = s.load_snapshot();
+    std::cout << "eager load: ready after " << loaded->seconds * 1000 << " ms (" << loaded->threads << " threads)\n";
+  }
+
+  mini_redis::store s(config);
+  const auto start = clock_type::now();
+  const auto loaded = s.load_snapshot_lazily();
+  std::cout << "lazy load:  ready after " << loaded->seconds * 1000 << " ms (" << loaded->keys << " keys indexed, "
+            << loaded->chunks << " chunks)\n";
+
+  // 적재가 끝날 때까지 GET을 보냄
+  std::atomic<bool> stop{false};
+  std::thread watcher([&] {
+    while (s.loading())
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stop = true;
+  });
+  auto during = run_gets(s, keys, clients, stop, static_cast<std::size_t>(-1));
+  watcher.join();
+  const double hydrated = std::chrono::duration<double>(clock_type::now() - start).count();
+  const auto status = s.persistence();
+  std::cout << "background load finished after " << hydrated << " s, " << status.loading_faulted_keys
+            << " keys read on first access" << (status.loading_error.empty() ? "" : ", error: ")
+            << status.loading_error << "\n";
+  // clients 0: 백그라운드 적재만의 시간
+  if (clients > 0)
+  {
+    print("  during load: ", during);
+    std::atomic<bool> never{false};
+    auto after = run_gets(s, keys, clients, never, std::max<std::size_t>(1, during.ns.size() / clients));
+    print("  after load:  ", after);
+  }
+  std::filesystem::remove(path);
+  return 0;
+}
@@ -0,0 +1,164 @@
+#include "storage/quicklist.hpp"
+#include "storage/store.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <malloc.h>
+#include <string>
+#include <vector>
+
+/*
+* LIST representation benchmark: the previous std::list<std::string> vs quicklist.
+* Usage: list_bench [elements] [lrange_rounds]
+*
+* 1) 원소 크기별(정수, 짧은 문자열, JSON 형태 80 bytes)로 elements개를 RPUSH했을 때 원소당 실제 힙 사용량을
+*    glibc mallinfo2의 증가분으로 측정합니다 (quicklist는 압축 없음 / 양 끝 1노드 제외 압축).
+* 2) 10000개짜리 리스트에 대한 LRANGE (앞 100개, 가운데 100개, 전체) 처리량을 초당 원소 수로 출력합니다.
+*    std::list는 이전 store가 하던 것처럼 처음부터 따라가며 복사합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  std::size_t heap_in_use()
+  {
+    return mallinfo2().uordblks;
+  }
+
+  std::string make_element(int kind, std::size_t i)
+  {
+    switch (kind)
+    {
+    case 0:
+      return std::to_string(i * 7919 % 1000000);
+    case 1:
+      return "session:" + std::to_string(i) + ":evt";
+    default:
+      return "{\"id\":" + std::to_string(i) + ",\"type\":\"click\",\"page\":\"/products/" + std::to_string(i % 500) +
+             "\",\"ok\":true}";
+    }
+  }
+
+  template <typename Fn>
+  double bytes_per_element(std::size_t elements, Fn &&fill)
+  {
+    const std::size_t before = heap_in_use();
+    auto holder = fill();
+    const std::size_t after = heap_in_use();
+    return static_cast<double>(after - before) / elements;
+  }
+
+  template <typename Fn>
+  double elements_per_sec(std::size_t rounds, Fn &&fn)
+  {
+    std::size_t total = 0;
+    const auto start = clock_type::now();
+    for (std::size_t r = 0; r < rounds; ++r)
+    {
+      total += fn();
+    }
+    return total / std::chrono::duration<double>(clock_type::now() - start).count();
+  }
+
+  std::vector<std::string> list_range(const std::list<std::string> &list, std::size_t start, std::size_t count)
+  {
+    std::vector<std::string> result;
+    result.reserve(count);
+    auto it = list.begin();
+    std::advance(it, start);
+    for (; it != list.end() && result.size() < count; ++it)
+    {
+      result.push_back(*it);
+    }
+    return result;
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  const std::size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+
+  const char *kinds[] = {"integer", "short string", "json 80B"};
+  std::cout << "bytes per element (" << elements << " elements, heap growth)\n";
+  std::cout << std::left << std::setw(16) << "element" << std::right << std::setw(12) << "payload" << std::setw(12)
+            << "std::list" << std::setw(12) << "quicklist" << std::setw(14) << "compressed\n";
+  for (int kind = 0; kind < 3; ++kind)
+  {
+    std::vector<std::string> values;
+    values.reserve(elements);
+    std::size_t payload = 0;
+    for (std::size_t i = 0; i < elements; ++i)
+    {
+      values.push_back(make_element(kind, i));
+      payload += values.back().size();
+    }
+    const double old_bytes = bytes_per_element(elements, [&] {
+      auto list = std::make_unique<std::list<std::string>>();
+      for (const auto &v : values)
+      {
+        list->push_back(v);
+      }
+      return list;
+    });
+    auto fill_quicklist = [&](std::size_t depth) {
+      return [&values, depth] {
+        auto list = std::make_unique<mini_redis::quicklist>(mini_redis::quicklist::options{8192, depth});
+        for (const auto &v : values)
+        {
+          list->push_back(v);
+        }
+        return list;
+      };
+    };
+    const double new_bytes = bytes_per_element(elements, fill_quicklist(0));
+    const double compressed_bytes = bytes_per_element(elements, fill_quicklist(1));
+    std::cout << std::left << std::setw(16) << kinds[kind] << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << static_cast<double>(payload) / elements << std::setw(12) << old_bytes << std::setw(12)
+              << new_bytes << std::setw(13) << compressed_bytes << "\n";
+  }
+
+  // LRANGE 처리량
+  const std::size_t list_len = 10000;
+  std::list<std::string> old_list;
+  mini_redis::store plain;
+  mini_redis::store_config compressed_config;
+  compressed_config.list_compress_depth = 1;
+  mini_redis::store compressed(compressed_config);
+  std::vector<std::string> batch;
+  for (std::size_t i = 0; i < list_len; ++i)
+  {
+    batch.push_back(make_element(2, i));
+    old_list.push_back(batch.back());
+  }
+  plain.rpush("events", batch);
+  compressed.rpush("events", batch);
+
+  struct range_case
+  {
+    const char *name;
+    long long start;
+    long long stop;
+  };
+  const range_case cases[] = {{"LRANGE 0 99", 0, 99}, {"LRANGE 5000 5099", 5000, 5099}, {"LRANGE 0 -1", 0, -1}};
+  std::cout << "\nLRANGE on a " << list_len << "-element list (million elements/s)\n";
+  std::cout << std::left << std::setw(20) << "range" << std::right << std::setw(12) << "std::list" << std::setw(12)
+            << "quicklist" << std::setw(14) << "compressed\n";
+  for (const auto &c : cases)
+  {
+    const std::size_t start = static_cast<std::size_t>(c.start);
+    const std::size_t count = c.stop < 0 ? list_len : static_cast<std::size_t>(c.stop - c.start + 1);
+    const std::size_t n = c.stop < 0 ? rounds / 50 + 1 : rounds;
+    const double old_rate = elements_per_sec(n, [&] { return list_range(old_list, start, count).size(); });
+    const double new_rate = elements_per_sec(n, [&] { return plain.lrange("events", c.start, c.stop).size(); });
+    const double compressed_rate =
+        elements_per_sec(n, [&] { return compressed.lrange("events", c.start, c.stop).size(); });
+    std::cout << std::left << std::setw(20) << c.name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << old_rate / 1e6 << std::setw(12) << new_rate / 1e6 << std::setw(13)
+              << compressed_rate / 1e6 << "\n";
+  }
+  return 0;
+}
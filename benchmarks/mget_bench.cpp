@@ -0,0 +1,264 @@
+#include "command/dispatcher.hpp"
+#include "network/server.hpp"
+#include "protocol/serializer.hpp"
+#include "storage/store.hpp"
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Multi-key read benchmark: one MGET of N keys vs N separate GETs (a page render fetching N keys).
+* Usage: mget_bench [keys_per_page] [pages] [port]
+*
+* 100,000개의 키(값 32 bytes) 중 무작위 N개(기본 100)를 한 페이지로 읽는 비용을 세 단계에서 잽니다.
+* - store: get() N번 / mget() 한 번 (shard 잠금을 키마다 vs shard마다 한 번)
+* - dispatcher: GET 명령 N번 / MGET 한 번 (핸들러 선택, 응답 직렬화 포함)
+* - network: 127.0.0.1:port에 서버를 띄우고 GET을 하나씩 주고받기(unpipelined),
+*   GET N개를 한 번에 보내고 응답 N개 받기(pipelined), MGET 한 번
+* 각 방식의 페이지당 시간과 키당 시간을 출력합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+  using boost::asio::ip::tcp;
+
+  constexpr std::size_t keyspace = 100000;
+
+  double seconds_since(clock_type::time_point start)
+  {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+  }
+
+  std::string key_name(std::size_t i)
+  {
+    return "page:item:" + std::to_string(i);
+  }
+
+  std::string resp_command(const std::vector<std::string> &args)
+  {
+    std::string out = "*" + std::to_string(args.size()) + "\r\n";
+    for (const auto &arg : args)
+    {
+      mini_redis::serializer::append_bulk_string(out, arg);
+    }
+    return out;
+  }
+
+  // buf[pos]에서 시작하는 응답 하나의 끝 위치. 아직 다 받지 못했으면 npos
+  std::size_t reply_end(const std::string &buf, std::size_t pos)
+  {
+    const std::size_t crlf = buf.find("\r\n", pos);
+    if (crlf == std::string::npos)
+    {
+      return std::string::npos;
+    }
+    const long long n = std::atoll(buf.c_str() + pos + 1);
+    switch (buf[pos])
+    {
+    case '$':
+      return n < 0 ? crlf + 2 : (crlf + 2 + n + 2 <= buf.size() ? crlf + 2 + n + 2 : std::string::npos);
+    case '*':
+    {
+      std::size_t p = crlf + 2;
+      for (long long i = 0; i < n && p != std::string::npos; ++i)
+      {
+        p = p < buf.size() ? reply_end(buf, p) : std::string::npos;
+      }
+      return p;
+    }
+    default:
+      return crlf + 2;
+    }
+  }
+
+  // 응답 count개를 다 받을 때까지 읽고, 받은 bytes 수를 반환
+  std::size_t read_replies(tcp::socket &socket, std::string &buf, std::size_t count)
+  {
+    buf.clear();
+    std::size_t pos = 0, done = 0;
+    char chunk[65536];
+    while (done < count)
+    {
+      const std::size_t end = pos < buf.size() ? reply_end(buf, pos) : std::string::npos;
+      if (end != std::string::npos)
+      {
+        pos = end;
+        ++done;
+        continue;
+      }
+      buf.append(chunk, socket.read_some(boost::asio::buffer(chunk)));
+    }
+    return buf.size();
+  }
+
+  void report(const char *name, double seconds, std::size_t pages, std::size_t keys_per_page)
+  {
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::setprecision(1) << std::setw(9)
+              << seconds / static_cast<double>(pages) * 1e6 << " us/page " << std::setw(8)
+              << seconds / static_cast<double>(pages * keys_per_page) * 1e9 << " ns/key\n";
+  }
+} // namespace
+
+using namespace mini_redis;
+
+int main(int argc, char **argv)
+{
+  const std::size_t per_page = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100;
+  const std::size_t pages = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+  const unsigned short port = argc > 3 ? static_cast<unsigned short>(std::atoi(argv[3])) : 16390;
+  std::cout << std::fixed;
+
+  std::mt19937_64 rng(1);
+  std::vector<std::vector<std::string>> page_keys(pages);
+  for (auto &keys : page_keys)
+  {
+    for (std::size_t i = 0; i < per_page; ++i)
+    {
+      keys.push_back(key_name(rng() % keyspace));
+    }
+  }
+  const std::string value(32, 'v');
+  std::size_t checksum = 0;
+
+  {
+    auto st = std::make_shared<store>();
+    std::vector<std::pair<std::string, std::string>> batch;
+    for (std::size_t i = 0; i < keyspace; ++i)
+    {
+      batch.emplace_back(key_name(i), value);
+      if (batch.size() == 1000)
+      {
+        st->mset(batch);
+        batch.clear();
+      }
+    }
+
+    std::cout << "store (" << per_page << " keys/page):\n";
+    auto start = clock_type::now();
+    for (const auto &keys : page_keys)
+    {
+      for (const auto &key : keys)
+      {
+        checksum += st->get(key)->size();
+      }
+    }
+    report("N x get()", seconds_since(start), pages, per_page);
+    start = clock_type::now();
+    for (const auto &keys : page_keys)
+    {
+      st->mget(keys, [&](std::optional<std::string_view> v) { checksum += v->size(); });
+    }
+    report("mget()", seconds_since(start), pages, per_page);
+
+    std::cout << "dispatcher:\n";
+    CommandDispatcher dispatcher(st, std::make_shared<pubsub_manager>());
+    start = clock_type::now();
+    for (const auto &keys : page_keys)
+    {
+      for (const auto &key : keys)
+      {
+        checksum += dispatcher.execute_command({"GET", key}).size();
+      }
+    }
+    report("N x GET", seconds_since(start), pages, per_page);
+    start = clock_type::now();
+    for (const auto &keys : page_keys)
+    {
+      command_t cmd{"MGET"};
+      cmd.insert(cmd.end(), keys.begin(), keys.end());
+      checksum += dispatcher.execute_command(cmd).size();
+    }
+    report("MGET", seconds_since(start), pages, per_page);
+  }
+
+  {
+    server srv("127.0.0.1", static_cast<short>(port));
+    std::thread server_thread([&] { srv.run(); });
+    boost::asio::io_context io;
+    tcp::socket socket(io);
+    for (int attempt = 0;; ++attempt)
+    {
+      boost::system::error_code ec;
+      socket.connect(tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), port), ec);
+      if (!ec)
+      {
+        break;
+      }
+      if (attempt == 100)
+      {
+        std::cerr << "cannot connect: " << ec.message() << "\n";
+        return 1;
+      }
+      socket = tcp::socket(io);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    socket.set_option(tcp::no_delay(true));
+
+    std::string buf;
+    for (std::size_t i = 0; i < keyspace; i += 1000)
+    {
+      std::vector<std::string> args{"MSET"};
+      for (std::size_t j = i; j < i + 1000; ++j)
+      {
+        args.push_back(key_name(j));
+        args.push_back(value);
+      }
+      boost::asio::write(socket, boost::asio::buffer(resp_command(args)));
+      read_replies(socket, buf, 1);
+    }
+
+    // 요청을 미리 만들어 두어 클라이언트 쪽 직렬화 비용은 재지 않음
+    std::vector<std::vector<std::string>> gets(pages);
+    std::vector<std::string> pipelined(pages), mgets(pages);
+    for (std::size_t p = 0; p < pages; ++p)
+    {
+      std::vector<std::string> args{"MGET"};
+      for (const auto &key : page_keys[p])
+      {
+        gets[p].push_back(resp_command({"GET", key}));
+        pipelined[p] += gets[p].back();
+        args.push_back(key);
+      }
+      mgets[p] = resp_command(args);
+    }
+
+    std::cout << "network (127.0.0.1, 1 connection):\n";
+    auto start = clock_type::now();
+    for (const auto &page : gets)
+    {
+      for (const auto &request : page)
+      {
+        boost::asio::write(socket, boost::asio::buffer(request));
+        checksum += read_replies(socket, buf, 1);
+      }
+    }
+    report("N x GET unpipelined", seconds_since(start), pages, per_page);
+    start = clock_type::now();
+    for (const auto &request : pipelined)
+    {
+      boost::asio::write(socket, boost::asio::buffer(request));
+      checksum += read_replies(socket, buf, per_page);
+    }
+    report("N x GET pipelined", seconds_since(start), pages, per_page);
+    start = clock_type::now();
+    for (const auto &request : mgets)
+    {
+      boost::asio::write(socket, boost::asio::buffer(request));
+      checksum += read_replies(socket, buf, 1);
+    }
+    report("MGET", seconds_since(start), pages, per_page);
+
+    socket.close();
+    srv.stop();
+    server_thread.join();
+  }
+  std::cout << "(checksum " << checksum << ")\n";
+  return 0;
+}
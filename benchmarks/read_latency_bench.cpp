@@ -0,0 +1,118 @@
+#include "storage/store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Read-heavy latency benchmark (95% GET / 5% SET).
+* Usage: read_latency_bench [threads] [seconds] [keyspace] [shards]
+*
+* 모든 스레드가 같은 키 공간에 대해 GET/SET을 섞어 실행하고,
+* 명령 유형별 지연 시간 분포(p50/p99/p99.9)를 출력합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  struct samples
+  {
+    std::vector<std::uint32_t> get_ns;
+    std::vector<std::uint32_t> set_ns;
+  };
+
+  void print_percentiles(const char *name, std::vector<std::uint32_t> &v)
+  {
+    if (v.empty())
+    {
+      return;
+    }
+    std::sort(v.begin(), v.end());
+    auto pct = [&v](double p) { return v[std::min(v.size() - 1, static_cast<std::size_t>(p * v.size()))]; };
+    std::cout << std::setw(5) << name << std::setw(12) << v.size()
+              << std::setw(10) << pct(0.50) << std::setw(10) << pct(0.99)
+              << std::setw(10) << pct(0.999) << std::setw(12) << v.back() << "\n";
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const unsigned threads = argc > 1 ? std::atoi(argv[1]) : std::max(2u, std::thread::hardware_concurrency());
+  const double seconds = argc > 2 ? std::atof(argv[2]) : 3.0;
+  const std::size_t keyspace = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10000;
+  mini_redis::store_config cfg;
+  if (argc > 4)
+  {
+    cfg.shards = std::strtoul(argv[4], nullptr, 10);
+  }
+
+  mini_redis::store s(cfg);
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < keyspace; ++i)
+  {
+    keys.push_back("key:" + std::to_string(i));
+    s.set(keys.back(), std::string(64, 'v'));
+  }
+
+  std::atomic<bool> start{false};
+  std::atomic<bool> stop{false};
+  std::vector<samples> per_thread(threads);
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t)
+  {
+    workers.emplace_back([&, t] {
+      std::mt19937_64 rng(t + 1);
+      std::uniform_int_distribution<std::size_t> pick(0, keyspace - 1);
+      std::uniform_int_distribution<int> mix(0, 99);
+      auto &out = per_thread[t];
+      const std::string value(64, 'w');
+      while (!start.load(std::memory_order_acquire)) {}
+      while (!stop.load(std::memory_order_relaxed))
+      {
+        const auto &key = keys[pick(rng)];
+        bool is_write = mix(rng) < 5;
+        auto begin = clock_type::now();
+        if (is_write)
+        {
+          s.set(key, value);
+        }
+        else
+        {
+          s.get(key);
+        }
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - begin).count();
+        (is_write ? out.set_ns : out.get_ns).push_back(static_cast<std::uint32_t>(std::min<long long>(ns, UINT32_MAX)));
+      }
+    });
+  }
+
+  start.store(true, std::memory_order_release);
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  stop.store(true);
+  for (auto &w : workers)
+  {
+    w.join();
+  }
+
+  samples all;
+  for (auto &p : per_thread)
+  {
+    all.get_ns.insert(all.get_ns.end(), p.get_ns.begin(), p.get_ns.end());
+    all.set_ns.insert(all.set_ns.end(), p.set_ns.begin(), p.set_ns.end());
+  }
+
+  std::cout << "threads=" << threads << " keyspace=" << keyspace << " shards=" << s.shard_count()
+            << " mix=95% GET / 5% SET, " << seconds << "s\n";
+  std::cout << std::setw(5) << "op" << std::setw(12) << "count" << std::setw(10) << "p50(ns)"
+            << std::setw(10) << "p99(ns)" << std::setw(10) << "p99.9(ns)" << std::setw(12) << "max(ns)" << "\n";
+  print_percentiles("GET", all.get_ns);
+  print_percentiles("SET", all.set_ns);
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include "storage/flat_table.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+* Table growth latency benchmark.
+* Usage: rehash_latency_bench [keys]
+*
+* 키를 계속 삽입하면서 삽입 한 번의 지연 시간을 기록합니다.
+* std::unordered_map은 재해시 순간에 모든 키를 한 번에 옮기므로 최대 지연이 키 수에 비례해 커지고,
+* flat_table은 증분 재해시로 재해시 비용이 이후의 쓰기에 나뉘어 최대 지연이 일정하게 유지되어야 합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  template <typename InsertFn>
+  void run(const char *name, const std::vector<std::string> &keys, InsertFn &&insert)
+  {
+    std::vector<std::uint32_t> latency(keys.size());
+    std::uint64_t worst = 0;
+    std::size_t worst_at = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      auto begin = clock_type::now();
+      insert(keys[i]);
+      auto ns = static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - begin).count());
+      latency[i] = static_cast<std::uint32_t>(std::min<std::uint64_t>(ns, UINT32_MAX));
+      if (ns > worst)
+      {
+        worst = ns;
+        worst_at = i;
+      }
+    }
+    std::sort(latency.begin(), latency.end());
+    auto pct = [&latency](double p) { return latency[std::min(latency.size() - 1, static_cast<std::size_t>(p * latency.size()))]; };
+    std::cout << std::setw(14) << name << std::setw(10) << pct(0.5) << std::setw(10) << pct(0.99)
+              << std::setw(12) << pct(0.9999) << std::setw(14) << std::fixed << std::setprecision(3)
+              << worst / 1e6 << "  (at key #" << worst_at << ")\n";
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000000;
+  std::vector<std::string> keys;
+  keys.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    keys.push_back("key:" + std::to_string(i));
+  }
+
+  std::cout << "inserting " << n << " keys into an empty table\n";
+  std::cout << std::setw(14) << "table" << std::setw(10) << "p50(ns)" << std::setw(10) << "p99(ns)"
+            << std::setw(12) << "p99.99(ns)" << std::setw(14) << "max(ms)" << "\n";
+  {
+    std::unordered_map<std::string, mini_redis::value_entry> table;
+    run("unordered_map", keys, [&table](const std::string &key) { table[key].value = std::string("v"); });
+  }
+  {
+    mini_redis::flat_table table;
+    run("flat_table", keys, [&table](const std::string &key) {
+      table.try_emplace(key, mini_redis::flat_table::hash(key)).first->value = std::string("v");
+    });
+  }
+  return 0;
+}
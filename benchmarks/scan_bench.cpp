@@ -0,0 +1,68 @@
+#include "storage/store.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/*
+* KEYS vs SCAN benchmark.
+* Usage: scan_bench [keys] [count]
+*
+* keys개의 키(절반은 "user:" 접두사)를 넣은 뒤 "user:*" 패턴으로 KEYS 한 번과 SCAN 전체 순회를 비교합니다.
+* 한 번의 호출은 shard 잠금을 잡고 있는 시간의 상한이므로, 다른 클라이언트가 기다릴 수 있는
+* 최대 시간은 KEYS는 shard 하나를 순회하는 시간, SCAN은 호출 한 번의 시간입니다.
+* 호출 하나의 최대 시간과 전체 소요 시간, 반환된 키 수를 출력합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  double elapsed_us(clock_type::time_point start)
+  {
+    return std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  const std::size_t count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+
+  mini_redis::store s;
+  for (std::size_t i = 0; i < keys; ++i)
+  {
+    s.set((i % 2 ? "user:" : "item:") + std::to_string(i), "value");
+  }
+  s.rehash_step(std::chrono::seconds(10));
+
+  auto start = clock_type::now();
+  const std::size_t keys_found = s.keys("user:*").size();
+  const double keys_us = elapsed_us(start);
+
+  std::size_t scan_found = 0;
+  std::size_t calls = 0;
+  double max_call_us = 0;
+  std::uint64_t cursor = 0;
+  start = clock_type::now();
+  do
+  {
+    const auto call_start = clock_type::now();
+    auto result = s.scan(cursor, "user:*", count);
+    max_call_us = std::max(max_call_us, elapsed_us(call_start));
+    scan_found += result.items.size();
+    cursor = result.cursor;
+    ++calls;
+  } while (cursor != 0);
+  const double scan_us = elapsed_us(start);
+
+  std::cout << "keys=" << keys << " shards=" << s.shard_count() << " count=" << count << "\n"
+            << std::fixed << std::setprecision(1)
+            << "KEYS user:*  found=" << keys_found << "  total=" << keys_us / 1000 << "ms"
+            << "  per shard=" << keys_us / s.shard_count() / 1000 << "ms\n"
+            << "SCAN user:*  found=" << scan_found << "  total=" << scan_us / 1000 << "ms  calls=" << calls
+            << "  max call=" << max_call_us << "us  avg call=" << scan_us / calls << "us\n";
+  return 0;
+}
@@ -0,0 +1,147 @@
+#include "storage/compact_set.hpp"
+#include "storage/intset.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/*
+* SET algebra benchmark: intset SIMD merge kernels vs std::set_intersection/std::set_union on the
+* same sorted arrays vs probing an std::unordered_set<std::string> (the table encoding).
+* Usage: set_bench [members] [rounds]
+*
+* 원소 약 members개(기본 1M)인 정수 집합 두 개를 겹치는 비율(1%, 50%, 99%)을 바꿔가며 만들고,
+* 교집합/합집합 한 번의 시간과 초당 처리한 입력 원소 수(M elements/s, 두 집합 크기의 합 기준)를 출력합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  // 입력 원소 총수 / 한 번 걸린 시간 (M elements/s)
+  double throughput(std::size_t elements, double seconds)
+  {
+    return static_cast<double>(elements) / seconds / 1e6;
+  }
+
+  template <typename Fn>
+  double best_of(std::size_t rounds, Fn &&fn)
+  {
+    double best = 1e9;
+    for (std::size_t r = 0; r < rounds; ++r)
+    {
+      const auto start = clock_type::now();
+      fn();
+      best = std::min(best, std::chrono::duration<double>(clock_type::now() - start).count());
+    }
+    return best;
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t members = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  const std::size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+
+  std::cout << "members per set: " << members << ", best of " << rounds << " rounds, M input elements/s\n";
+  std::cout << std::left << std::setw(9) << "overlap" << std::right << std::setw(13) << "SINTER simd" << std::setw(12)
+            << "std::inter" << std::setw(12) << "hash probe" << std::setw(13) << "SUNION simd" << std::setw(12)
+            << "std::union" << std::setw(12) << "result" << "\n";
+
+  for (double overlap : {0.01, 0.5, 0.99})
+  {
+    // [0, 8*members) 의 각 값을 독립적으로 a만/b만/양쪽에 넣어, 두 집합이 무작위로 엇갈리고
+    // 각각 약 members개이며 그중 overlap 비율이 공통 원소가 되도록 함
+    std::mt19937_64 rng(static_cast<std::uint64_t>(overlap * 1000));
+    std::uniform_real_distribution<double> uniform(0, 1);
+    const double p = 1.0 / 8, both = p * overlap;
+    std::vector<std::int32_t> a, b;
+    a.reserve(members * 2);
+    b.reserve(members * 2);
+    for (std::size_t v = 0; v < 8 * members; ++v)
+    {
+      const double r = uniform(rng);
+      if (r < both)
+      {
+        a.push_back(static_cast<std::int32_t>(v));
+        b.push_back(static_cast<std::int32_t>(v));
+      }
+      else if (r < p)
+      {
+        a.push_back(static_cast<std::int32_t>(v));
+      }
+      else if (r < 2 * p - both)
+      {
+        b.push_back(static_cast<std::int32_t>(v));
+      }
+    }
+
+    // 1M개도 intset으로 두도록 한도를 올림
+    const mini_redis::compact_set::options opts{static_cast<std::uint32_t>(2 * members)};
+    mini_redis::compact_set set_a(opts), set_b(opts);
+    std::unordered_set<std::string> table_a, table_b;
+    table_a.reserve(a.size());
+    table_b.reserve(b.size());
+    for (std::int32_t v : a)
+    {
+      set_a.insert(std::to_string(v));
+      table_a.insert(std::to_string(v));
+    }
+    for (std::int32_t v : b)
+    {
+      set_b.insert(std::to_string(v));
+      table_b.insert(std::to_string(v));
+    }
+    if (!set_a.is_intset() || !set_b.is_intset())
+    {
+      std::cerr << "sets were converted to tables\n";
+      return 1;
+    }
+    const mini_redis::intset &ia = set_a.ints(), &ib = set_b.ints();
+
+    std::size_t simd_size = 0, std_size = 0, probe_size = 0, union_size = 0, std_union_size = 0;
+    const double simd_inter = best_of(rounds, [&] { simd_size = mini_redis::intset::intersect(ia, ib).size(); });
+    const double std_inter = best_of(rounds, [&] {
+      std::vector<std::int32_t> out;
+      out.reserve(std::min(a.size(), b.size()));
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+      std_size = out.size();
+    });
+    // table 인코딩의 SINTER: 한쪽을 돌며 다른 쪽에서 찾고 결과 문자열을 복사
+    const double probe_inter = best_of(rounds, [&] {
+      std::vector<std::string> out;
+      for (const auto &member : table_a)
+      {
+        if (table_b.count(member))
+        {
+          out.push_back(member);
+        }
+      }
+      probe_size = out.size();
+    });
+    const double simd_union = best_of(rounds, [&] { union_size = mini_redis::intset::unite(ia, ib).size(); });
+    const double std_union = best_of(rounds, [&] {
+      std::vector<std::int32_t> out;
+      out.reserve(a.size() + b.size());
+      std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+      std_union_size = out.size();
+    });
+
+    const std::size_t inputs = a.size() + b.size();
+    std::cout << std::left << std::setw(9) << (std::to_string(static_cast<int>(overlap * 100)) + "%") << std::right
+              << std::fixed << std::setprecision(1) << std::setw(13) << throughput(inputs, simd_inter) << std::setw(12)
+              << throughput(inputs, std_inter) << std::setw(12) << throughput(inputs, probe_inter) << std::setw(13)
+              << throughput(inputs, simd_union) << std::setw(12) << throughput(inputs, std_union) << std::setw(12)
+              << simd_size
+              << (simd_size == std_size && simd_size == probe_size && union_size == std_union_size ? ""
+                                                                                                 : "  (mismatch)")
+              << "\n";
+  }
+  return 0;
+}
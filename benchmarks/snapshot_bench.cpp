@@ -0,0 +1,93 @@
+#include "storage/store.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+/*
+* Snapshot benchmark: SAVE/BGSAVE write speed, the BGSAVE fork pause, and load speed.
+* Usage: snapshot_bench [keys] [dir]
+*
+* keys개(기본 5M)의 키를 만든 뒤 (문자열 80%: 정수 값 절반, 16~100 bytes 값 절반,
+* 나머지 20%는 field 8개짜리 HASH, 10%의 키에는 TTL) dir(기본 현재 디렉터리)에 SAVE로 쓰는
+* 시간과 MB/s, BGSAVE를 부를 때 부모가 멈추는 시간(fork)과 자식이 끝나기까지의 시간을 잽니다.
+* 이어서 새 store로 같은 파일을 불러오는 속도를 keys/s와 MB/s로 출력합니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  double seconds_since(clock_type::time_point start)
+  {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000000;
+  const std::string dir = argc > 2 ? argv[2] : ".";
+  std::cout << std::fixed << std::setprecision(2);
+
+  mini_redis::store_config config;
+  config.dir = dir;
+  config.dbfilename = "snapshot_bench.rdb";
+  const std::string path = dir + "/" + config.dbfilename;
+
+  {
+    mini_redis::store s(config);
+    const std::string long_value(100, 'v');
+    for (std::size_t i = 0; i < keys; ++i)
+    {
+      const std::string key = "bench:key:" + std::to_string(i);
+      switch (i % 10)
+      {
+      case 0:
+      case 1:
+        s.hset(key, {{"name", "user" + std::to_string(i)}, {"age", std::to_string(i % 90)}, {"city", "Seoul"},
+                     {"score", std::to_string(i * 7)}, {"plan", "pro"}, {"active", "1"}, {"ref", key},
+                     {"note", long_value.substr(0, 24)}});
+        break;
+      case 2:
+        s.setex(key, 3600, std::to_string(i));
+        break;
+      default:
+        s.set(key, i % 2 ? std::to_string(i) : long_value.substr(0, 16 + i % 85));
+      }
+    }
+    std::cout << "keys: " << s.dbsize() << ", used_memory " << s.memory_usage() / (1 << 20) << " MB\n";
+
+    auto start = clock_type::now();
+    s.save();
+    const double save = seconds_since(start);
+    const double mb = static_cast<double>(std::filesystem::file_size(path)) / (1 << 20);
+    std::cout << "SAVE:   " << save << " s, " << mb << " MB, " << mb / save << " MB/s, "
+              << static_cast<double>(keys) / save / 1e6 << " M keys/s\n";
+
+    start = clock_type::now();
+    s.bgsave();
+    const double fork_pause = seconds_since(start);
+    while (s.persistence().bgsave_in_progress)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      s.poll_background_save();
+    }
+    const double bgsave = seconds_since(start);
+    std::cout << "BGSAVE: fork pause " << fork_pause * 1e3 << " ms, child done in " << bgsave << " s ("
+              << (s.persistence().last_bgsave_ok ? "ok" : "failed") << ")\n";
+  }
+
+  {
+    mini_redis::store s(config);
+    const auto loaded = s.load_snapshot();
+    const double mb = static_cast<double>(loaded->bytes) / (1 << 20);
+    std::cout << "LOAD:   " << loaded->seconds << " s, " << static_cast<double>(loaded->keys) / loaded->seconds / 1e6
+              << " M keys/s, " << mb / loaded->seconds << " MB/s (" << loaded->keys << " keys)\n";
+  }
+  std::filesystem::remove(path);
+  return 0;
+}
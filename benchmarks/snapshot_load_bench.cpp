@@ -0,0 +1,76 @@
+#include "storage/store.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Snapshot load benchmark: startup load time against the number of loader threads.
+* Usage: snapshot_load_bench [keys] [max threads] [dir]
+*
+* keys개(기본 5M)의 키로 (문자열 80%: 정수 값 절반, 16~100 bytes 값 절반, 나머지 20%는 field 8개짜리 HASH,
+* 10%의 키에는 TTL) 스냅샷을 저장한 뒤, 새 store로 같은 파일을 스레드 1, 2, 4, ... max threads개
+* (기본은 코어 수)로 불러와 시간, keys/s, 1 스레드 대비 속도를 출력합니다.
+* 저장한 store와 shard 수가 같으므로 스레드마다 shard를 맡아 잠금 경쟁 없이 넣습니다.
+* 코어 수보다 많은 스레드는 빨라지지 않으므로, 확장성은 코어가 여러 개인 머신에서 보아야 합니다.
+*/
+
+int main(int argc, char **argv)
+{
+  const std::size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000000;
+  const std::size_t max_threads =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+  const std::string dir = argc > 3 ? argv[3] : ".";
+  std::cout << std::fixed << std::setprecision(2);
+
+  mini_redis::store_config config;
+  config.dir = dir;
+  config.dbfilename = "snapshot_load_bench.rdb";
+  const std::string path = dir + "/" + config.dbfilename;
+
+  {
+    mini_redis::store s(config);
+    const std::string long_value(100, 'v');
+    for (std::size_t i = 0; i < keys; ++i)
+    {
+      const std::string key = "bench:key:" + std::to_string(i);
+      switch (i % 10)
+      {
+      case 0:
+      case 1:
+        s.hset(key, {{"name", "user" + std::to_string(i)}, {"age", std::to_string(i % 90)}, {"city", "Seoul"},
+                     {"score", std::to_string(i * 7)}, {"plan", "pro"}, {"active", "1"}, {"ref", key},
+                     {"note", long_value.substr(0, 24)}});
+        break;
+      case 2:
+        s.setex(key, 3600, std::to_string(i));
+        break;
+      default:
+        s.set(key, i % 2 ? std::to_string(i) : long_value.substr(0, 16 + i % 85));
+      }
+    }
+    s.save();
+  }
+  std::cout << "snapshot: " << keys << " keys, " << std::filesystem::file_size(path) / double(1 << 20) << " MB, "
+            << std::thread::hardware_concurrency() << " cores\n";
+
+  double single = 0;
+  for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+  {
+    mini_redis::store s(config);
+    const auto loaded = s.load_snapshot(threads);
+    if (threads == 1)
+    {
+      single = loaded->seconds;
+    }
+    std::cout << "  " << std::setw(2) << loaded->threads << " threads: " << std::setw(6) << loaded->seconds << " s, "
+              << std::setw(5) << static_cast<double>(loaded->keys) / loaded->seconds / 1e6 << " M keys/s, "
+              << std::setw(7) << static_cast<double>(loaded->bytes) / loaded->seconds / (1 << 20) << " MB/s, x"
+              << single / loaded->seconds << " (" << loaded->chunks << " chunks)\n";
+  }
+  std::filesystem::remove(path);
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include "storage/store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Multi-threaded GET/SET throughput benchmark for the sharded store.
+* Usage: store_throughput_bench [shards] [seconds_per_run] [keyspace]
+*
+* 각 스레드 수(1 ~ 전체 코어)마다 shard 1개(기존 전역 mutex와 동일)와
+* 설정된 shard 수로 같은 부하를 실행하여 처리량(ops/s)을 비교합니다.
+*/
+
+namespace
+{
+  double run(std::size_t shards, unsigned threads, double seconds, std::size_t keyspace)
+  {
+    mini_redis::store_config cfg;
+    cfg.shards = shards;
+    mini_redis::store s(cfg);
+
+    std::vector<std::string> keys;
+    keys.reserve(keyspace);
+    for (std::size_t i = 0; i < keyspace; ++i)
+    {
+      keys.push_back("key:" + std::to_string(i));
+      s.set(keys.back(), "value");
+    }
+
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::atomic<unsigned long long> total_ops{0};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+      workers.emplace_back([&, t] {
+        std::mt19937_64 rng(t + 1);
+        std::uniform_int_distribution<std::size_t> pick(0, keyspace - 1);
+        unsigned long long ops = 0;
+        while (!start.load(std::memory_order_acquire)) {}
+        while (!stop.load(std::memory_order_relaxed))
+        {
+          const auto &key = keys[pick(rng)];
+          // 90% GET, 10% SET
+          if (ops % 10 == 0)
+          {
+            s.set(key, "value");
+          }
+          else
+          {
+            s.get(key);
+          }
+          ++ops;
+        }
+        total_ops += ops;
+      });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (auto &w : workers)
+    {
+      w.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return static_cast<double>(total_ops.load()) / elapsed;
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t shards = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : mini_redis::store_config{}.shards;
+  const double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+  const std::size_t keyspace = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100000;
+  const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::vector<unsigned> thread_counts;
+  for (unsigned t = 1; t < max_threads; t *= 2)
+  {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(max_threads);
+
+  std::cout << "keyspace=" << keyspace << " mix=90% GET / 10% SET, " << seconds << "s per run\n";
+  std::cout << std::setw(8) << "threads" << std::setw(18) << "1 shard (ops/s)"
+            << std::setw(22) << (std::to_string(shards) + " shards (ops/s)") << std::setw(10) << "speedup" << "\n";
+  for (unsigned t : thread_counts)
+  {
+    double single = run(1, t, seconds, keyspace);
+    double sharded = run(shards, t, seconds, keyspace);
+    std::cout << std::setw(8) << t << std::setw(18) << std::fixed << std::setprecision(0) << single
+              << std::setw(22) << sharded << std::setw(9) << std::setprecision(2) << sharded / single << "x\n";
+  }
+  return 0;
+}
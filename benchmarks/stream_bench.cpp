@@ -0,0 +1,122 @@
+#include "storage/store.hpp"
+#include "storage/stream.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+* Stream benchmark: append and range-read throughput of the STREAM type at 100M entries.
+* Usage: stream_bench [entries] [store_entries]
+*
+* entries개(기본 100M)의 항목을 스트림 하나에 추가하며 초당 추가 수와 항목당 메모리를 출력하고,
+* 같은 스트림을 처음부터 끝까지 순서대로/거꾸로 읽는 처리량, 무작위 위치에서 시작하는 XRANGE COUNT 100의
+* 호출당 시간(radix tree로 시작 block을 찾는 비용 포함)을 잽니다. 이어서 store를 거친 XADD(자동 ID)와
+* XADD MAXLEN ~ 를 store_entries개(기본 10M)씩 추가하는 처리량을 잽니다.
+* 항목은 같은 모양의 센서 이벤트({sensor, id, temp, value})로, 초당 1000개씩 들어오는 것처럼 ID를 만듭니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  double seconds_since(clock_type::time_point start)
+  {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t entries = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000000;
+  const std::size_t store_entries = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000000;
+  std::cout << std::fixed;
+  std::size_t checksum = 0;
+
+  {
+    mini_redis::stream s;
+    const std::size_t empty = s.memory_usage();
+    std::vector<std::string> fields{"sensor", "", "temp", ""};
+    const std::uint64_t base_ms = 1700000000000;
+    auto start = clock_type::now();
+    for (std::size_t i = 0; i < entries; ++i)
+    {
+      fields[1] = std::to_string(i % 64);
+      fields[3] = std::to_string(200 + i % 150);
+      s.append(mini_redis::stream_id{base_ms + i / 1000, i % 1000}, fields);
+    }
+    const double append = seconds_since(start);
+    const std::size_t bytes = s.memory_usage() - empty;
+    std::cout << "append:        " << entries << " entries, " << std::setprecision(2)
+              << static_cast<double>(entries) / append / 1e6 << " M entries/s, " << bytes / (1 << 20) << " MB ("
+              << static_cast<double>(bytes) / static_cast<double>(entries) << " B/entry)\n";
+
+    for (const bool reverse : {false, true})
+    {
+      std::size_t seen = 0;
+      start = clock_type::now();
+      s.for_each(mini_redis::stream_id{}, mini_redis::stream_id::max(), reverse,
+                 [&](mini_redis::stream_id id, const std::vector<std::string_view> &f) {
+                   checksum += id.seq + f[3].size();
+                   ++seen;
+                   return true;
+                 });
+      const double scan = seconds_since(start);
+      std::cout << (reverse ? "reverse scan:  " : "forward scan:  ") << seen << " entries, " << std::setprecision(2)
+                << static_cast<double>(seen) / scan / 1e6 << " M entries/s\n";
+    }
+
+    // 무작위 시작 ID에서 100개씩 (XRANGE key <id> + COUNT 100): 찾기 + 복사 비용
+    std::mt19937_64 rng(1);
+    const std::size_t calls = 100000;
+    start = clock_type::now();
+    for (std::size_t c = 0; c < calls; ++c)
+    {
+      const std::size_t i = rng() % entries;
+      const auto range = s.range(mini_redis::stream_id{base_ms + i / 1000, i % 1000}, mini_redis::stream_id::max(), 100);
+      checksum += range.size();
+    }
+    const double xrange = seconds_since(start) / calls;
+    start = clock_type::now();
+    for (std::size_t c = 0; c < calls; ++c)
+    {
+      const std::size_t i = rng() % entries;
+      const auto range = s.range(mini_redis::stream_id{}, mini_redis::stream_id{base_ms + i / 1000, i % 1000}, 100, true);
+      checksum += range.size();
+    }
+    const double xrevrange = seconds_since(start) / calls;
+    std::cout << "random XRANGE COUNT 100: " << std::setprecision(1) << xrange * 1e6 << " us/call, XREVRANGE COUNT 100: "
+              << xrevrange * 1e6 << " us/call\n";
+  }
+
+  {
+    // store 경로: 자동 ID XADD, 그리고 MAXLEN ~ 1000 으로 길이를 유지하며 XADD
+    mini_redis::store store_instance;
+    const std::vector<std::string> fields{"sensor", "7", "temp", "231"};
+    auto start = clock_type::now();
+    for (std::size_t i = 0; i < store_entries; ++i)
+    {
+      checksum += store_instance.xadd("events", mini_redis::stream::id_spec{}, fields)->seq;
+    }
+    const double xadd = seconds_since(start);
+
+    mini_redis::stream_trim trim;
+    trim.by = mini_redis::stream_trim::strategy::maxlen;
+    trim.approximate = true;
+    trim.maxlen = 1000;
+    start = clock_type::now();
+    for (std::size_t i = 0; i < store_entries; ++i)
+    {
+      checksum += store_instance.xadd("capped", mini_redis::stream::id_spec{}, fields, trim)->seq;
+    }
+    const double capped = seconds_since(start);
+    std::cout << "store: XADD * " << std::setprecision(2) << static_cast<double>(store_entries) / xadd / 1e6
+              << " M/s, XADD MAXLEN ~ 1000 * " << static_cast<double>(store_entries) / capped / 1e6
+              << " M/s (length " << store_instance.xlen("capped") << ")\n";
+  }
+  std::cout << "(checksum " << checksum << ")\n";
+  return 0;
+}
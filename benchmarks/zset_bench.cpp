@@ -0,0 +1,169 @@
+#include "storage/sorted_set.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <malloc.h>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+* Large sorted set benchmark: sorted_set (skiplist with span counts + member dict) vs
+* std::set<std::pair<double, std::string>> + std::unordered_map<std::string, double>.
+* Usage: zset_bench [members] [probes]
+*
+* members개(기본 10M)의 member를 무작위 점수로 ZADD 하며 초당 처리량과 member 하나당 힙 사용량
+* (glibc mallinfo2 증가분)을 재고, 무작위 member probes개(기본 1M)에 대해 ZRANK, ZSCORE,
+* 중간 순위의 ZRANGE(10개) 한 번의 평균 시간(ns)을 출력합니다.
+* std::set에는 순위 정보가 없어 ZRANK가 std::distance로 O(n)이므로 몇 번만 재서 보여 줍니다.
+*/
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  std::size_t heap_in_use()
+  {
+    return mallinfo2().uordblks;
+  }
+
+  double seconds_since(clock_type::time_point start)
+  {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+  }
+
+  std::string member_name(std::size_t i)
+  {
+    return "member:" + std::to_string(i);
+  }
+
+  void print_row(const char *name, double zadd_seconds, std::size_t members, std::size_t bytes, double zrank_ns,
+                 double zscore_ns, double zrange_ns)
+  {
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << static_cast<double>(members) / zadd_seconds / 1e6 << std::setw(12)
+              << std::setprecision(1) << static_cast<double>(bytes) / static_cast<double>(members) << std::setw(14)
+              << zrank_ns << std::setw(13) << zscore_ns << std::setw(13) << zrange_ns << "\n";
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t members = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+  const std::size_t probes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+
+  // 점수는 정수 범위를 좁게 잡아 같은 점수(member 순서로 비교)도 자주 나오게 함
+  std::mt19937_64 rng(1);
+  std::vector<double> scores(members);
+  for (auto &score : scores)
+  {
+    score = static_cast<double>(rng() % (members / 4 + 1));
+  }
+  std::vector<std::size_t> probe_ids(probes);
+  for (auto &id : probe_ids)
+  {
+    id = rng() % members;
+  }
+
+  std::cout << "members: " << members << ", probes: " << probes << "\n";
+  std::cout << std::left << std::setw(22) << "structure" << std::right << std::setw(14) << "ZADD M ops/s"
+            << std::setw(12) << "B/member" << std::setw(14) << "ZRANK ns" << std::setw(13) << "ZSCORE ns"
+            << std::setw(13) << "ZRANGE ns" << "\n";
+
+  std::size_t checksum = 0;
+  {
+    const std::size_t heap_before = heap_in_use();
+    mini_redis::sorted_set zset;
+    auto start = clock_type::now();
+    for (std::size_t i = 0; i < members; ++i)
+    {
+      zset.insert(member_name(i), scores[i]);
+    }
+    const double zadd = seconds_since(start);
+    const std::size_t bytes = heap_in_use() - heap_before;
+
+    std::vector<std::string> names;
+    names.reserve(probes);
+    for (std::size_t id : probe_ids)
+    {
+      names.push_back(member_name(id));
+    }
+    start = clock_type::now();
+    for (const auto &name : names)
+    {
+      checksum += *zset.rank(name);
+    }
+    const double zrank = seconds_since(start);
+    start = clock_type::now();
+    for (const auto &name : names)
+    {
+      checksum += static_cast<std::size_t>(*zset.score(name));
+    }
+    const double zscore = seconds_since(start);
+    start = clock_type::now();
+    for (std::size_t id : probe_ids)
+    {
+      checksum += zset.range_by_rank(id, std::min(id + 9, members - 1)).size();
+    }
+    const double zrange = seconds_since(start);
+    print_row("skiplist + dict", zadd, members, bytes, zrank * 1e9 / probes, zscore * 1e9 / probes,
+              zrange * 1e9 / probes);
+  }
+
+  {
+    // 비교 대상: 순서용 std::set과 점수 조회용 std::unordered_map
+    const std::size_t heap_before = heap_in_use();
+    std::set<std::pair<double, std::string>> ordered;
+    std::unordered_map<std::string, double> dict;
+    auto start = clock_type::now();
+    for (std::size_t i = 0; i < members; ++i)
+    {
+      std::string name = member_name(i);
+      const auto [it, inserted] = dict.emplace(name, scores[i]);
+      if (!inserted)
+      {
+        ordered.erase({it->second, name});
+        it->second = scores[i];
+      }
+      ordered.emplace(scores[i], std::move(name));
+    }
+    const double zadd = seconds_since(start);
+    const std::size_t bytes = heap_in_use() - heap_before;
+
+    // std::distance는 O(n)이라 적은 수만 잼
+    const std::size_t slow_probes = std::min<std::size_t>(probes, 5);
+    start = clock_type::now();
+    for (std::size_t p = 0; p < slow_probes; ++p)
+    {
+      const std::string name = member_name(probe_ids[p]);
+      checksum += static_cast<std::size_t>(std::distance(ordered.begin(), ordered.find({dict.at(name), name})));
+    }
+    const double zrank = seconds_since(start);
+    start = clock_type::now();
+    for (std::size_t p = 0; p < probes; ++p)
+    {
+      checksum += static_cast<std::size_t>(dict.find(member_name(probe_ids[p]))->second);
+    }
+    const double zscore = seconds_since(start);
+    start = clock_type::now();
+    for (std::size_t p = 0; p < slow_probes; ++p)
+    {
+      auto it = std::next(ordered.begin(), static_cast<long>(probe_ids[p]));
+      for (int k = 0; k < 10 && it != ordered.end(); ++k, ++it)
+      {
+        checksum += it->second.size();
+      }
+    }
+    const double zrange = seconds_since(start);
+    print_row("std::set + hash map", zadd, members, bytes, zrank * 1e9 / slow_probes, zscore * 1e9 / probes,
+              zrange * 1e9 / slow_probes);
+  }
+  std::cout << "(checksum " << checksum << ")\n";
+  return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef MINI_REDIS_BITMAP_COMMAND_HANDLER_HPP
+#define MINI_REDIS_BITMAP_COMMAND_HANDLER_HPP
+
+#include "command/command_handler_interface.hpp"
+#include "storage/store.hpp"
+#include <memory>
+
+namespace mini_redis
+{
+    class BitmapCommandHandler : public ICommandHandler
+    {
+    public:
+        explicit BitmapCommandHandler(std::shared_ptr<store> store);
+        bool supports(const std::string& command_name) const override;
+        std::string execute(const command_t& cmd) override;
+
+    private:
+        std::shared_ptr<store> store_;
+        std::string handle_setbit(const command_t &cmd);
+        std::string handle_getbit(const command_t &cmd);
+        std::string handle_bitcount(const command_t &cmd);
+        std::string handle_bitpos(const command_t &cmd);
+        std::string handle_bitop(const command_t &cmd);
+        std::string handle_bitfield(const command_t &cmd);
+    };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_BITMAP_COMMAND_HANDLER_HPP
@@ -4,6 +4,8 @@
 #include "storage/store.hpp"
 #include "pubsub/manager.hpp"
 #include "command/command_handler_interface.hpp"
+#include "storage/aof.hpp"
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -14,12 +16,24 @@ namespace mini_redis
     class CommandDispatcher
     {
     public:
-        CommandDispatcher(std::shared_ptr<store> store, std::shared_ptr<pubsub_manager> pubsub_manager);
+        /**
+         * @param aof If set, every write command that succeeds is appended to it.
+         */
+        CommandDispatcher(std::shared_ptr<store> store, std::shared_ptr<pubsub_manager> pubsub_manager,
+                          std::shared_ptr<append_only_file> aof = nullptr);
         void set_session(std::weak_ptr<session> s);
         std::string execute_command(const command_t &cmd);
 
+        /**
+         * @brief Under appendfsync always: the AOF sequence of the last write executed since the
+         * previous call, whose reply must wait until it is fsynced. 0 if there is none.
+         */
+        std::uint64_t take_unsynced_write();
+
     private:
         std::vector<std::unique_ptr<ICommandHandler>> handlers_;
+        std::shared_ptr<append_only_file> aof_;
+        std::uint64_t unsynced_write_ = 0;
     };
 } // namespace mini_redis
 
@@ -2,6 +2,7 @@
 #define MINI_REDIS_GENERIC_COMMAND_HANDLER_HPP
 
 #include "command/command_handler_interface.hpp"
+#include "storage/aof.hpp"
 #include "storage/store.hpp"
 #include <memory>
 
@@ -10,15 +11,27 @@ namespace mini_redis
     class GenericCommandHandler : public ICommandHandler
     {
     public:
-        explicit GenericCommandHandler(std::shared_ptr<store> store);
+        // aof는 INFO의 Persistence 섹션과 BGREWRITEAOF를 위한 것 (AOF를 끈 경우 nullptr)
+        explicit GenericCommandHandler(std::shared_ptr<store> store, std::shared_ptr<append_only_file> aof = nullptr);
         bool supports(const std::string& command_name) const override;
         std::string execute(const command_t& cmd) override;
 
     private:
         std::shared_ptr<store> store_;
+        std::shared_ptr<append_only_file> aof_;
         std::string handle_ping(const command_t &cmd);
         std::string handle_del(const command_t &cmd);
         std::string handle_keys(const command_t &cmd);
+        std::string handle_scan(const command_t &cmd);
+        std::string handle_collection_scan(const command_t &cmd, const std::string &command_name);
+        std::string handle_expire(const command_t &cmd, bool milliseconds);
+        std::string handle_expireat(const command_t &cmd, bool milliseconds);
+        std::string handle_ttl(const command_t &cmd, bool milliseconds);
+        std::string handle_info(const command_t &cmd);
+        std::string handle_save(const command_t &cmd, const std::string &command_name);
+        std::string handle_bgrewriteaof(const command_t &cmd);
+        std::string handle_dump(const command_t &cmd);
+        std::string handle_restore(const command_t &cmd);
     };
 } // namespace mini_redis
 
@@ -0,0 +1,29 @@
+#ifndef MINI_REDIS_HASH_COMMAND_HANDLER_HPP
+#define MINI_REDIS_HASH_COMMAND_HANDLER_HPP
+
+#include "command/command_handler_interface.hpp"
+#include "storage/store.hpp"
+#include <memory>
+
+namespace mini_redis
+{
+    class HashCommandHandler : public ICommandHandler
+    {
+    public:
+        explicit HashCommandHandler(std::shared_ptr<store> store);
+        bool supports(const std::string& command_name) const override;
+        std::string execute(const command_t& cmd) override;
+
+    private:
+        std::shared_ptr<store> store_;
+        std::string handle_hset(const command_t &cmd);
+        std::string handle_hget(const command_t &cmd);
+        std::string handle_hmget(const command_t &cmd);
+        std::string handle_hgetall(const command_t &cmd);
+        std::string handle_hdel(const command_t &cmd);
+        std::string handle_hincrby(const command_t &cmd);
+        std::string handle_hlen(const command_t &cmd);
+    };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_HASH_COMMAND_HANDLER_HPP
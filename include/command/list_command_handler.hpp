@@ -0,0 +1,28 @@
+#ifndef MINI_REDIS_LIST_COMMAND_HANDLER_HPP
+#define MINI_REDIS_LIST_COMMAND_HANDLER_HPP
+
+#include "command/command_handler_interface.hpp"
+#include "storage/store.hpp"
+#include <memory>
+
+namespace mini_redis
+{
+    class ListCommandHandler : public ICommandHandler
+    {
+    public:
+        explicit ListCommandHandler(std::shared_ptr<store> store);
+        bool supports(const std::string& command_name) const override;
+        std::string execute(const command_t& cmd) override;
+
+    private:
+        std::shared_ptr<store> store_;
+        std::string handle_push(const command_t &cmd, bool front);
+        std::string handle_pop(const command_t &cmd, bool front);
+        std::string handle_lrange(const command_t &cmd);
+        std::string handle_llen(const command_t &cmd);
+        std::string handle_lindex(const command_t &cmd);
+        std::string handle_ltrim(const command_t &cmd);
+    };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_LIST_COMMAND_HANDLER_HPP
@@ -0,0 +1,29 @@
+#ifndef MINI_REDIS_SET_COMMAND_HANDLER_HPP
+#define MINI_REDIS_SET_COMMAND_HANDLER_HPP
+
+#include "command/command_handler_interface.hpp"
+#include "storage/store.hpp"
+#include <memory>
+
+namespace mini_redis
+{
+    class SetCommandHandler : public ICommandHandler
+    {
+    public:
+        explicit SetCommandHandler(std::shared_ptr<store> store);
+        bool supports(const std::string& command_name) const override;
+        std::string execute(const command_t& cmd) override;
+
+    private:
+        std::shared_ptr<store> store_;
+        std::string handle_sadd(const command_t &cmd);
+        std::string handle_srem(const command_t &cmd);
+        std::string handle_sismember(const command_t &cmd);
+        std::string handle_smembers(const command_t &cmd);
+        std::string handle_scard(const command_t &cmd);
+        // SINTER, SUNION, SDIFF
+        std::string handle_algebra(const command_t &cmd, const std::string &command_name);
+    };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_SET_COMMAND_HANDLER_HPP
@@ -0,0 +1,47 @@
+#ifndef MINI_REDIS_SORTED_SET_COMMAND_HANDLER_HPP
+#define MINI_REDIS_SORTED_SET_COMMAND_HANDLER_HPP
+
+#include "command/command_handler_interface.hpp"
+#include "storage/store.hpp"
+#include <memory>
+
+namespace mini_redis
+{
+    class SortedSetCommandHandler : public ICommandHandler
+    {
+    public:
+        explicit SortedSetCommandHandler(std::shared_ptr<store> store);
+        bool supports(const std::string& command_name) const override;
+        std::string execute(const command_t& cmd) override;
+
+    private:
+        // ZRANGE 계열의 공통 옵션
+        struct range_query
+        {
+            enum class kind { rank, score, lex };
+            kind by = kind::rank;
+            bool reverse = false;
+            bool with_scores = false;
+            bool has_limit = false;
+            long long offset = 0;
+            long long count = -1;
+        };
+
+        std::shared_ptr<store> store_;
+        std::string handle_zadd(const command_t &cmd);
+        std::string handle_zincrby(const command_t &cmd);
+        std::string handle_zscore(const command_t &cmd);
+        // ZRANK, ZREVRANK
+        std::string handle_zrank(const command_t &cmd, bool reverse);
+        std::string handle_zrange(const command_t &cmd);
+        // ZRANGEBYSCORE, ZRANGEBYLEX
+        std::string handle_zrange_by(const command_t &cmd, range_query::kind by);
+        std::string handle_zrem(const command_t &cmd);
+        std::string handle_zcard(const command_t &cmd);
+        // min/max 인자를 query에 맞게 해석해 결과를 직렬화
+        std::string run_range(const std::string &key, const std::string &min, const std::string &max,
+                              const range_query &query);
+    };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_SORTED_SET_COMMAND_HANDLER_HPP
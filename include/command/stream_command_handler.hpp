@@ -0,0 +1,30 @@
+#ifndef MINI_REDIS_STREAM_COMMAND_HANDLER_HPP
+#define MINI_REDIS_STREAM_COMMAND_HANDLER_HPP
+
+#include "command/command_handler_interface.hpp"
+#include "storage/store.hpp"
+#include <memory>
+
+namespace mini_redis
+{
+    class StreamCommandHandler : public ICommandHandler
+    {
+    public:
+        explicit StreamCommandHandler(std::shared_ptr<store> store);
+        bool supports(const std::string& command_name) const override;
+        std::string execute(const command_t& cmd) override;
+
+    private:
+        std::shared_ptr<store> store_;
+        std::string handle_xadd(const command_t &cmd);
+        std::string handle_xlen(const command_t &cmd);
+        std::string handle_xrange(const command_t &cmd, bool reverse);
+        std::string handle_xtrim(const command_t &cmd);
+        std::string handle_xread(const command_t &cmd, bool group);
+        std::string handle_xgroup(const command_t &cmd);
+        std::string handle_xack(const command_t &cmd);
+        std::string handle_xpending(const command_t &cmd);
+    };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_STREAM_COMMAND_HANDLER_HPP
@@ -19,10 +19,13 @@ namespace mini_redis
         std::string handle_get(const command_t &cmd);
         std::string handle_set(const command_t &cmd);
         std::string handle_setex(const command_t &cmd);
+        std::string handle_psetex(const command_t &cmd);
         std::string handle_incr(const command_t &cmd);
         std::string handle_decr(const command_t &cmd);
         std::string handle_incrby(const command_t &cmd);
         std::string handle_decrby(const command_t &cmd);
+        std::string handle_mget(const command_t &cmd);
+        std::string handle_mset(const command_t &cmd, bool nx);
     };
 } // namespace mini_redis
 
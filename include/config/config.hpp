@@ -3,6 +3,8 @@
 
 #include <string>
 #include <yaml-cpp/yaml.h>
+#include "storage/aof.hpp"
+#include "storage/store.hpp"
 
 namespace mini_redis
 {
@@ -13,6 +15,8 @@ namespace mini_redis
 
         std::string get_host() const;
         short get_port() const;
+        store_config get_store_config() const;
+        aof_config get_aof_config() const;
 
     private:
         YAML::Node config_node_;
@@ -2,9 +2,12 @@
 #define MINI_REDIS_SERVER_HPP
 
 #include <boost/asio.hpp>
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <thread>
+#include "storage/aof.hpp"
 #include "storage/store.hpp"
 #include "pubsub/manager.hpp"
 
@@ -18,8 +21,11 @@ namespace mini_redis
      * 
      * @param host The host address to listen on
      * @param port The port to listen on
+     * @param store_cfg The keyspace configuration (shard count, ...)
+     * @param aof_cfg The append-only file settings (disabled by default)
      */
-    server(const std::string& host, short port);
+    server(const std::string& host, short port, const store_config& store_cfg = store_config{},
+           const aof_config& aof_cfg = aof_config{});
 
     /**
      * @brief Runs the server's I/O service loop.
@@ -46,11 +52,34 @@ namespace mini_redis
      */
     void handle_accept(boost::asio::ip::tcp::socket &&new_connection, const boost::system::error_code &error);
 
+    /**
+     * @brief Loads the keyspace at startup: from the AOF if it is enabled and exists,
+     * otherwise from the snapshot (in the background with persistence.lazy_load).
+     */
+    void load_data(const store_config& store_cfg, const aof_config& aof_cfg);
+
+    /**
+     * @brief Schedules the periodic background task (like Redis's serverCron).
+     * Runs on the io_context, so it shares the I/O threads with client sessions.
+     */
+    void schedule_cron();
+
+    /**
+     * @brief One tick of background maintenance on the store.
+     */
+    void run_cron();
+
     boost::asio::io_context io_context_;
     boost::asio::ip::tcp::acceptor acceptor_;
+    boost::asio::steady_timer cron_timer_;
     std::vector<std::thread> thread_pool_;
     std::shared_ptr<store> store_;
     std::shared_ptr<pubsub_manager> pubsub_manager_;
+    std::shared_ptr<append_only_file> aof_; // appendonly가 꺼져 있으면 nullptr
+    aof_config aof_cfg_;                    // 자동 rewrite 기준
+    // persistence.lazy_load로 시작해 아직 끝났다고 알리지 않은 백그라운드 적재의 시작 시각
+    std::optional<std::chrono::steady_clock::time_point> loading_since_;
+    bool seed_aof_pending_ = false;         // 적재가 끝나면 스냅샷의 키를 AOF에 넣는 rewrite를 시작
   };
 } // namespace mini_redis
 
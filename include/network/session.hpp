@@ -18,7 +18,8 @@ namespace mini_redis
   {
     friend class pubsub_manager;
   public:
-    session(boost::asio::ip::tcp::socket socket, std::shared_ptr<store> s, std::shared_ptr<pubsub_manager> ps_manager);
+    session(boost::asio::ip::tcp::socket socket, std::shared_ptr<store> s, std::shared_ptr<pubsub_manager> ps_manager,
+            std::shared_ptr<append_only_file> aof = nullptr);
     ~session();
     void start();
     void deliver(const std::string &msg);
@@ -42,6 +43,7 @@ namespace mini_redis
     parser parser_;
     CommandDispatcher handler_;
     std::shared_ptr<pubsub_manager> pubsub_manager_;
+    std::shared_ptr<append_only_file> aof_;
     
     // Pub/Sub state
     std::set<std::string> subscribed_channels_;
@@ -22,6 +22,11 @@ namespace mini_redis
      */
     std::vector<command_t> parse(const std::string &buffer);
 
+    /**
+     * @brief Bytes of an incomplete command kept for the next parse() call.
+     */
+    std::size_t pending_bytes() const { return buffer_.size(); }
+
   private:
     // Internal buffer for storing partial data.
     std::string buffer_;
@@ -1,7 +1,9 @@
 #ifndef MINI_REDIS_SERIALIZER_HPP
 #define MINI_REDIS_SERIALIZER_HPP
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 
@@ -39,6 +41,22 @@ namespace mini_redis
      */
     std::string serialize_bulk_string(const std::optional<std::string> &value);
 
+    /**
+     * @brief Appends a bulk string to a reply being built in place (e.g. the elements of an
+     * MGET reply, written straight from the store without an intermediate copy).
+     *
+     * @param out The reply buffer.
+     * @param value The string value, or std::nullopt for a null bulk string.
+     */
+    void append_bulk_string(std::string &out, std::optional<std::string_view> value);
+
+    /**
+     * @brief Serializes a null array (e.g. LPOP with a count on a missing key).
+     *
+     * @return The serialized null array.
+     */
+    std::string serialize_null_array();
+
     /**
      * @brief Serializes an array of strings into a RESP string.
      * 
@@ -47,13 +65,47 @@ namespace mini_redis
      */
     std::string serialize_array(const std::vector<std::string> &values);
 
+    /**
+     * @brief Serializes an array whose elements may be null (e.g. HMGET).
+     *
+     * @param values The elements; std::nullopt becomes a null bulk string.
+     * @return The serialized array string.
+     */
+    std::string serialize_nullable_array(const std::vector<std::optional<std::string>> &values);
+
     /**
      * @brief Serializes an integer into a RESP string.
      * 
-     * @param value The integer value.
+     * @param value The integer value (full 64-bit range).
      * @return The serialized integer string.
      */
-    std::string serialize_integer(int value);
+    std::string serialize_integer(std::int64_t value);
+
+    /**
+     * @brief Serializes an array of integers whose elements may be null (e.g. BITFIELD).
+     *
+     * @param values The elements; std::nullopt becomes a null bulk string.
+     * @return The serialized array string.
+     */
+    std::string serialize_nullable_integer_array(const std::vector<std::optional<std::int64_t>> &values);
+
+    /**
+     * @brief Serializes a SCAN-family reply: a two-element array of the next cursor
+     * (as a bulk string) and the array of returned items.
+     *
+     * @param cursor The cursor to pass to the next call (0 when the iteration is complete).
+     * @param items The keys or elements returned by this call.
+     * @return The serialized nested array.
+     */
+    std::string serialize_scan_reply(std::uint64_t cursor, const std::vector<std::string> &items);
+
+    /**
+     * @brief Serializes an array of already serialized replies (nested replies such as XRANGE entries).
+     *
+     * @param replies The RESP-encoded elements, written as they are.
+     * @return The serialized array string.
+     */
+    std::string serialize_reply_array(const std::vector<std::string> &replies);
   } // namespace serializer
 } // namespace mini_redis
 
@@ -0,0 +1,276 @@
+#ifndef MINI_REDIS_AOF_HPP
+#define MINI_REDIS_AOF_HPP
+
+#include "protocol/parser.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mini_redis
+{
+  /*
+   * appendfsync 정책 (Redis와 같음)
+   *   always   - 쓰기 명령의 응답을 그 명령이 fsync된 뒤에 보냄. 동시에 쌓인 명령은 fsync 한 번으로 묶임 (group commit)
+   *   everysec - 초당 한 번 fsync. 장애 시 최대 약 1초의 쓰기를 잃을 수 있음
+   *   no       - fsync하지 않고 OS가 내려쓰는 시점에 맡김
+   */
+  enum class fsync_policy
+  {
+    always,
+    everysec,
+    no
+  };
+
+  /**
+   * @brief Parses an appendfsync name (always, everysec, no; case-insensitive).
+   * @return std::nullopt for an unknown name.
+   */
+  std::optional<fsync_policy> parse_fsync_policy(const std::string &name);
+
+  /**
+   * @brief The config name of a policy ("always", "everysec", "no").
+   */
+  const char *fsync_policy_name(fsync_policy policy);
+
+  // config.yaml의 persistence.appendonly / appendfilename / appendfsync
+  struct aof_config
+  {
+    bool enabled = false;
+    std::string filename = "appendonly.aof"; // persistence.dir 기준
+    fsync_policy fsync = fsync_policy::everysec;
+    // 마지막 rewrite (또는 시작) 때보다 이 비율(%)만큼 커지고 rewrite_min_size 이상이면 자동으로 rewrite.
+    // 0이면 자동 rewrite를 하지 않음
+    unsigned rewrite_percentage = 100;
+    std::uint64_t rewrite_min_size = 64ULL * 1024 * 1024;
+  };
+
+  // 시작 시 AOF를 다시 실행한 결과
+  struct aof_load_stats
+  {
+    std::size_t commands = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t truncated_bytes = 0; // 끝에 잘린 채 남아 있어 잘라 낸 bytes (쓰는 중에 중단된 경우)
+    double seconds = 0;
+  };
+
+  /*
+   * Append-only file. 실행된 쓰기 명령을 RESP 형식 그대로 파일 끝에 이어 씀.
+   *
+   * I/O 스레드는 feed()에서 명령을 메모리 버퍼에 붙이기만 하고, write와 fsync는 전용 writer 스레드가 함.
+   * writer는 버퍼를 통째로 가져가 write 한 번으로 쓰므로, 그 사이 여러 클라이언트가 넣은 명령이
+   * 한 번의 write(와 always일 때 fsync 한 번)로 묶임.
+   *
+   * 같은 키에 대한 쓰기가 실행된 순서대로 기록되도록, dispatcher는 명령의 키들이 속한 order stripe를
+   * 잡은 채로 실행하고 feed함. 순서는 키마다만 맞으면 되므로 다른 stripe의 쓰기는 함께 실행됨.
+   *
+   * 다시 실행했을 때 같은 결과가 나오도록 시각에 따라 달라지는 명령은 바꾸어 기록함:
+   * 상대 만료 시간(EXPIRE, PEXPIRE, SETEX, PSETEX, RESTORE)은 절대 시각으로, XADD의 자동 ID(*)는
+   * 실제로 만들어진 ID로.
+   *
+   * Rewrite (BGREWRITEAOF): fork된 자식이 그 순간의 키 공간을 최소한의 명령으로 임시 파일에 쓰는 동안,
+   * 그 뒤에 feed된 명령은 rewrite 버퍼에도 복사됨. 자식이 끝나면 writer 스레드가 버퍼를 잠금 없이
+   * 임시 파일에 옮기고, 남은 양이 작아지면 잠금 안에서 마지막 부분을 쓰고 rename으로 파일을 바꿈.
+   * 쓰기 명령이 기다리는 시간은 이 마지막 단계뿐임 (last_rewrite_pause).
+   */
+  class append_only_file
+  {
+  public:
+    /**
+     * @brief Opens (or creates) the file for appending and starts the writer thread.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    append_only_file(const std::string &path, fsync_policy policy);
+
+    /**
+     * @brief Writes what is still buffered, fsyncs and stops the writer thread.
+     */
+    ~append_only_file();
+    append_only_file(const append_only_file &) = delete;
+    append_only_file &operator=(const append_only_file &) = delete;
+
+    /**
+     * @brief Whether a command (upper-case name) can modify the keyspace and is logged.
+     */
+    static bool is_write_command(const std::string &command_name);
+
+    // 실행 순서와 기록 순서를 맞추는 order 잠금의 수. 키 해시로 나누므로 다른 stripe의 키에 대한 쓰기는
+    // 서로 기다리지 않음
+    static constexpr std::size_t order_stripes = 64;
+
+    /**
+     * @brief Order locks (a bitmap of stripes) held by the calling thread; released on destruction.
+     */
+    class order_guard
+    {
+    public:
+      order_guard() = default;
+      order_guard(order_guard &&other) noexcept
+          : owner_(std::exchange(other.owner_, nullptr)), stripes_(std::exchange(other.stripes_, 0))
+      {
+      }
+      order_guard &operator=(order_guard &&other) noexcept;
+      ~order_guard() { release(); }
+      order_guard(const order_guard &) = delete;
+      order_guard &operator=(const order_guard &) = delete;
+
+    private:
+      friend class append_only_file;
+      void release();
+
+      append_only_file *owner_ = nullptr;
+      std::uint64_t stripes_ = 0;
+    };
+
+    /**
+     * @brief Locks the order stripes of the keys a write command touches, in ascending order.
+     * Held by the dispatcher around executing the command and feeding it, so writes to the
+     * same key are logged in the order they were applied. Commands whose keys are not known
+     * lock every stripe.
+     */
+    order_guard lock_order(const command_t &cmd);
+
+    /**
+     * @brief Locks every stripe, so no write is between executing and being fed (the moment
+     * the rewrite child forks).
+     */
+    order_guard lock_all_order();
+
+    /**
+     * @brief For a write not made by a command (an eviction): takes the key's stripe unless
+     * another thread holds it. Nothing is locked if the calling thread already holds it.
+     * @return false if another thread holds the stripe (waiting could deadlock).
+     */
+    bool try_lock_order(std::string_view key, order_guard &out);
+
+    // key가 속한 order stripe
+    static std::size_t order_stripe(std::string_view key);
+
+    /**
+     * @brief Buffers an executed write command for the writer thread.
+     * Commands whose reply is an error (or a null XADD) changed nothing and are skipped.
+     * @return The command's sequence number (for when_durable), or 0 if it was not logged.
+     */
+    std::uint64_t feed(const command_t &cmd, const std::string &reply);
+
+    /**
+     * @brief Calls fn once every command up to seq is written (and fsynced under appendfsync always).
+     * Runs fn right away if that is already true, otherwise later on the writer thread.
+     */
+    void when_durable(std::uint64_t seq, std::function<void()> fn);
+
+    /**
+     * @brief The error from the last failed write or fsync, if it has not succeeded since.
+     */
+    std::optional<std::string> write_error() const;
+
+    fsync_policy policy() const { return policy_; }
+    const std::string &path() const { return path_; }
+
+    // 파일 크기 (writer가 쓴 만큼)
+    std::uint64_t size() const { return size_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Starts copying every command fed from now on into the rewrite buffer.
+     * Called with lock_all_order() held, at the moment the rewrite child forks.
+     */
+    void start_rewrite();
+
+    /**
+     * @brief Hands the child's finished file to the writer thread, which appends the buffered
+     * commands to it and renames it over the AOF.
+     */
+    void finish_rewrite(const std::string &temp_path);
+
+    // rewrite 자식이 실패한 경우: 모아 둔 명령을 버림
+    void abort_rewrite();
+
+    // start_rewrite부터 파일 교체(또는 실패)까지
+    bool rewrite_in_progress() const;
+
+    /**
+     * @brief Whether the file is at least min_size bytes and has grown by percentage% since the
+     * last rewrite, or since it was opened (Redis's auto-aof-rewrite-percentage / -min-size).
+     */
+    bool rewrite_due(unsigned percentage, std::uint64_t min_size) const;
+
+    // 마지막 rewrite에서 파일을 바꾸는 동안 feed()가 막혀 있던 시간
+    std::chrono::microseconds last_rewrite_pause() const
+    {
+      return std::chrono::microseconds(last_rewrite_pause_us_.load(std::memory_order_relaxed));
+    }
+    bool last_rewrite_ok() const { return last_rewrite_ok_.load(std::memory_order_relaxed); }
+
+    // 마지막 rewrite 직후 (또는 열 때)의 파일 크기
+    std::uint64_t base_size() const { return base_size_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Streams the file at path through the RESP parser and calls execute for every command.
+     * An incomplete command at the end (a crash during a write) is logged and cut off the file.
+     * @throws std::runtime_error if the file cannot be read.
+     */
+    static aof_load_stats replay(const std::string &path, const std::function<void(const command_t &)> &execute);
+
+  private:
+#ifdef __linux__
+    using native_file = int;
+#else
+    using native_file = std::FILE *;
+#endif
+    enum class rewrite_state
+    {
+      none,
+      buffering, // 자식이 파일을 쓰는 중. feed된 명령을 rewrite_buf_에도 복사
+      merging    // 자식이 끝남. writer 스레드가 rewrite_buf_를 rewrite_temp_에 옮기고 교체
+    };
+
+    void writer_loop();
+    // buf를 파일에 씀. 실패하면 false (errno 유지)
+    bool write_all(const std::string &buf);
+    // writer 스레드에서 rewrite 결과 파일에 버퍼를 옮기고 AOF와 바꿈. 교체 후 fsync가 필요하면 unsynced를 켬
+    void merge_rewrite(bool &unsynced);
+
+    std::string path_;
+    fsync_policy policy_;
+    std::atomic<std::uint64_t> size_{0};
+    std::atomic<std::uint64_t> base_size_{0};
+    native_file file_;
+
+    // stripes(오름차순)를 잠그고 이 스레드가 잡은 것으로 기록
+    order_guard lock_stripes(std::uint64_t stripes);
+
+    std::array<std::mutex, order_stripes> order_mutexes_;
+    // 이 스레드가 잡고 있는 order stripe (같은 스레드의 축출이 이미 잡은 stripe를 다시 잠그지 않도록)
+    static thread_local const append_only_file *order_owner_;
+    static thread_local std::uint64_t order_held_;
+
+    // writer 스레드와 공유하는 상태 (mutex_로 보호)
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::string pending_;            // 아직 쓰지 않은 명령들
+    std::uint64_t fed_seq_ = 0;      // 마지막으로 feed된 명령의 sequence
+    std::uint64_t durable_seq_ = 0;  // 여기까지 쓰기(always면 fsync까지) 완료
+    std::vector<std::pair<std::uint64_t, std::function<void()>>> waiters_;
+    std::optional<std::string> write_error_;
+    std::atomic<bool> write_failed_{false}; // 쓰기 명령마다 mutex_를 잡지 않고 확인하기 위함
+    bool stopping_ = false;
+    rewrite_state rewrite_state_ = rewrite_state::none;
+    std::string rewrite_buf_;  // rewrite 자식이 fork된 뒤에 feed된 명령들
+    std::string rewrite_temp_; // 자식이 쓴 파일
+    std::atomic<long long> last_rewrite_pause_us_{0};
+    std::atomic<bool> last_rewrite_ok_{true};
+    std::thread writer_;
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_AOF_HPP
@@ -0,0 +1,94 @@
+#ifndef MINI_REDIS_BITOPS_HPP
+#define MINI_REDIS_BITOPS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mini_redis
+{
+  /*
+   * 문자열 값을 bitmap으로 다루는 kernel들 (SETBIT, BITCOUNT, BITPOS, BITOP, BITFIELD).
+   * Redis와 같이 byte 0의 최상위 bit가 bit 0이고, 버퍼 밖의 bit는 모두 0으로 봄.
+   *
+   * BITCOUNT와 BITOP은 큰 버퍼(수백 MB)를 훑으므로 CPU에 따라 구현을 고름:
+   * AVX2(32 bytes씩, popcount는 Harley-Seal 누산), POPCNT 명령(8 bytes씩), 그리고 어디서나 되는 scalar.
+   * 어떤 것을 쓸지는 처음 호출할 때 CPU를 확인해 정하므로 빌드 옵션(-mavx2 등)과 무관함.
+   */
+  namespace bitops
+  {
+    // BITCOUNT/BITOP 구현의 종류 (뒤로 갈수록 빠름)
+    enum class kernel
+    {
+      scalar,
+      popcnt,
+      avx2,
+    };
+
+    // BITOP의 연산
+    enum class operation
+    {
+      bit_and,
+      bit_or,
+      bit_xor,
+      bit_not,
+    };
+
+    // SETBIT/BITFIELD가 다룰 수 있는 가장 큰 bit offset (문자열 최대 512MB, Redis와 같음)
+    constexpr std::uint64_t max_bit_offset = 512ull * 1024 * 1024 * 8 - 1;
+
+    // 이 CPU에서 쓸 수 있는 가장 빠른 구현
+    kernel best_kernel();
+    // 지금 쓰고 있는 구현 (처음에는 best_kernel())
+    kernel active_kernel();
+    /**
+     * @brief Forces the implementation used by popcount/combine (benchmarks and tests).
+     * A kernel the CPU does not support falls back to best_kernel().
+     * @return The kernel actually selected.
+     */
+    kernel use_kernel(kernel k);
+    const char *kernel_name(kernel k);
+
+    // p[0, n)의 1인 bit 수
+    std::uint64_t popcount(const unsigned char *p, std::size_t n);
+
+    /**
+     * @brief dst[i] = dst[i] op src[i] for i in [0, n), or dst[i] = ~src[i] for bit_not
+     * (src may equal dst, which makes NOT fully in place).
+     */
+    void combine(operation op, unsigned char *dst, const unsigned char *src, std::size_t n);
+
+    /**
+     * @brief Position of the first bit equal to bit in p[0, n), counting from the top bit of
+     * p[0] as 0.
+     * @return The bit position, or -1 if there is none.
+     */
+    std::int64_t find_bit(const unsigned char *p, std::size_t n, bool bit);
+
+    // offset 위치의 bit. 버퍼 밖이면 0
+    inline bool get_bit(const unsigned char *p, std::size_t n, std::uint64_t offset)
+    {
+      const std::uint64_t byte = offset >> 3;
+      return byte < n && ((p[byte] >> (7 - (offset & 7))) & 1);
+    }
+
+    // offset 위치의 bit를 바꾸고 이전 값을 반환. offset은 버퍼 안이어야 함
+    inline bool set_bit(unsigned char *p, std::uint64_t offset, bool value)
+    {
+      unsigned char &byte = p[offset >> 3];
+      const unsigned char mask = static_cast<unsigned char>(1u << (7 - (offset & 7)));
+      const bool old = byte & mask;
+      byte = static_cast<unsigned char>(value ? byte | mask : byte & ~mask);
+      return old;
+    }
+
+    /*
+     * BITFIELD의 정수 필드: offset부터 bits개(signed는 1~64, unsigned는 1~63)의 bit를
+     * 최상위 bit가 먼저 오는 정수로 읽고 씀. 버퍼 밖의 bit는 0으로 읽음.
+     */
+    std::uint64_t get_field(const unsigned char *p, std::size_t n, std::uint64_t offset, unsigned bits);
+    // 필드에 value의 하위 bits개 bit를 씀. 필드 전체가 버퍼 안이어야 함
+    void set_field(unsigned char *p, std::uint64_t offset, unsigned bits, std::uint64_t value);
+  } // namespace bitops
+} // namespace mini_redis
+
+#endif // MINI_REDIS_BITOPS_HPP
@@ -0,0 +1,79 @@
+#ifndef MINI_REDIS_COLLECTION_SCAN_HPP
+#define MINI_REDIS_COLLECTION_SCAN_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace mini_redis
+{
+  /*
+   * 컬렉션 값(SSCAN, HSCAN, ZSCAN)을 나누어 순회하기 위한 cursor 함수들.
+   * 한 번 호출에 대략 count개의 원소만 방문하고 다음 cursor를 반환하며, 0이면 순회가 끝난 것.
+   * 호출 사이에는 잠금을 놓으므로 그동안 컬렉션이 바뀌어도 cursor가 가리키는 위치가 의미를 잃지 않아야 함.
+   */
+
+  /**
+   * @brief Visits the elements of an unordered container (RedisSet, RedisHash) bucket by bucket,
+   * starting at bucket cursor, until at least count elements were visited.
+   * Elements that stay in the container are returned at least once as long as the bucket
+   * count does not change between calls; after a rehash the walk may skip or repeat elements.
+   * @return The next bucket to visit, 0 after the last bucket.
+   */
+  template <typename Unordered, typename Fn>
+  std::uint64_t scan_buckets(const Unordered &c, std::uint64_t cursor, std::size_t count, Fn &&fn)
+  {
+    const std::size_t buckets = c.bucket_count();
+    std::size_t bucket = static_cast<std::size_t>(cursor);
+    std::size_t visited = 0;
+    // 원소가 없는 bucket만 계속 나와도 한 번에 보는 bucket 수는 제한
+    for (std::size_t seen = 0; bucket < buckets && visited < count && seen < count * 10; ++bucket, ++seen)
+    {
+      for (auto it = c.begin(bucket); it != c.end(bucket); ++it)
+      {
+        fn(*it);
+        ++visited;
+      }
+    }
+    return bucket >= buckets ? 0 : bucket;
+  }
+
+  /*
+   * double을 크기 순서가 유지되는 uint64로 바꿈 (양수는 부호 bit를 켜고, 음수는 모든 bit를 뒤집음).
+   * -inf도 0이 아닌 값이 되므로 0을 "처음/끝" cursor로 쓸 수 있음.
+   */
+  inline std::uint64_t ordered_score_bits(double score)
+  {
+    std::uint64_t bits;
+    std::memcpy(&bits, &score, sizeof(bits));
+    return (bits & (std::uint64_t(1) << 63)) ? ~bits : bits | (std::uint64_t(1) << 63);
+  }
+
+  inline double score_from_ordered_bits(std::uint64_t bits)
+  {
+    bits = (bits & (std::uint64_t(1) << 63)) ? bits & ~(std::uint64_t(1) << 63) : ~bits;
+    double score;
+    std::memcpy(&score, &bits, sizeof(score));
+    return score;
+  }
+
+  /**
+   * @brief Visits up to count entries of a score-ordered map (std::map keyed by score), starting at
+   * the first score not below the one encoded in cursor. The cursor encodes the next score
+   * rather than a position, so inserts and deletes between calls never make the walk skip or
+   * repeat entries that were there for the whole walk, and resuming is O(log n).
+   * @return The cursor of the next score, 0 after the last entry.
+   */
+  template <typename ScoreMap, typename Fn>
+  std::uint64_t scan_ordered(const ScoreMap &m, std::uint64_t cursor, std::size_t count, Fn &&fn)
+  {
+    auto it = cursor == 0 ? m.begin() : m.lower_bound(score_from_ordered_bits(cursor));
+    for (std::size_t visited = 0; it != m.end() && visited < count; ++it, ++visited)
+    {
+      fn(*it);
+    }
+    return it == m.end() ? 0 : ordered_score_bits(it->first);
+  }
+} // namespace mini_redis
+
+#endif // MINI_REDIS_COLLECTION_SCAN_HPP
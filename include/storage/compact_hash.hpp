@@ -0,0 +1,101 @@
+#ifndef MINI_REDIS_COMPACT_HASH_HPP
+#define MINI_REDIS_COMPACT_HASH_HPP
+
+#include "storage/listpack.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace mini_redis
+{
+  /*
+   * HASH 값의 저장 구조 (Redis의 listpack / hashtable 이중 인코딩).
+   * 필드가 적고 값이 짧은 동안은 [필드][값][필드][값]...을 하나의 listpack 버퍼에 이어 붙여 두고
+   * 선형으로 찾음. 필드 수가 max_listpack_entries를 넘거나 max_listpack_value보다 긴 필드/값이
+   * 들어오면 unordered_map으로 한 번 변환하고, 이후로는 다시 listpack으로 돌아가지 않음.
+   * 필드 5~20개짜리 객체(사용자 프로필 등)는 필드마다 노드와 std::string 두 개를 할당하는
+   * unordered_map보다 훨씬 작고, 그 정도 길이의 선형 탐색은 해시 계산과 비슷한 비용임.
+   */
+  class compact_hash
+  {
+  public:
+    using table_type = std::unordered_map<std::string, std::string>;
+
+    struct options
+    {
+      // listpack으로 둘 최대 필드 수
+      std::uint32_t max_listpack_entries = 128;
+      // listpack으로 둘 필드/값의 최대 길이 (bytes)
+      std::uint32_t max_listpack_value = 64;
+    };
+
+    compact_hash() = default;
+    explicit compact_hash(const options &opts) : opts_(opts) {}
+    compact_hash(const compact_hash &other);
+    compact_hash(compact_hash &&other) noexcept = default;
+    compact_hash &operator=(const compact_hash &other);
+    compact_hash &operator=(compact_hash &&other) noexcept = default;
+
+    /**
+     * @brief Sets field to value, converting to the table encoding if a threshold is crossed.
+     * @return true if the field is new.
+     */
+    bool set(std::string_view field, std::string_view value);
+    std::optional<std::string> get(std::string_view field) const;
+    // 필드를 삭제. 있었으면 true
+    bool erase(std::string_view field);
+
+    std::size_t size() const { return table_ ? table_->size() : count_; }
+    bool empty() const { return size() == 0; }
+
+    // listpack 인코딩인지 여부 (OBJECT ENCODING에 해당)
+    bool is_listpack() const { return !table_; }
+    // table 인코딩이면 그 표 (HSCAN의 bucket 순회용), listpack이면 nullptr
+    const table_type *table() const { return table_.get(); }
+
+    // 모든 (필드, 값)에 대해 fn(std::string_view field, std::string_view value) 호출
+    template <typename Fn>
+    void for_each(Fn &&fn) const
+    {
+      if (table_)
+      {
+        for (const auto &item : *table_)
+        {
+          fn(std::string_view(item.first), std::string_view(item.second));
+        }
+        return;
+      }
+      const char *p = packed_.data();
+      const char *end = p + packed_.size();
+      while (p < end)
+      {
+        std::size_t size;
+        const std::string_view field = listpack::read(p, size);
+        p += size;
+        const std::string_view value = listpack::read(p, size);
+        p += size;
+        fn(field, value);
+      }
+    }
+
+    // 구조와 버퍼를 포함한 전체 메모리 사용량 (bytes). O(1)
+    std::size_t memory_usage() const;
+
+  private:
+    // listpack에서 필드의 위치 (없으면 npos). value_at에는 값 원소의 위치를 저장
+    std::size_t find_packed(std::string_view field, std::size_t &value_at) const;
+    void convert_to_table();
+
+    std::string packed_;                // listpack 인코딩의 [필드][값]... 버퍼
+    std::uint32_t count_ = 0;           // listpack 인코딩의 필드 수
+    options opts_;
+    std::unique_ptr<table_type> table_; // table 인코딩이면 non-null
+    std::size_t table_heap_bytes_ = 0;  // table의 필드/값 문자열이 따로 할당한 bytes
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_COMPACT_HASH_HPP
@@ -0,0 +1,94 @@
+#ifndef MINI_REDIS_COMPACT_SET_HPP
+#define MINI_REDIS_COMPACT_SET_HPP
+
+#include "storage/intset.hpp"
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace mini_redis
+{
+  /*
+   * SET 값의 저장 구조 (Redis의 intset / hashtable 이중 인코딩).
+   * 모든 원소가 정수의 표준 표기이고 max_intset_entries개 이하인 동안은 정렬된 intset에 두어
+   * 원소당 4~8 bytes만 쓰고, SINTER/SUNION/SDIFF를 SIMD 병합으로 계산함.
+   * 정수가 아닌 원소가 들어오거나 원소 수가 한도를 넘으면 unordered_set으로 한 번 변환하고,
+   * 이후로는 다시 intset으로 돌아가지 않음.
+   */
+  class compact_set
+  {
+  public:
+    using table_type = std::unordered_set<std::string>;
+
+    struct options
+    {
+      // intset으로 둘 최대 원소 수
+      std::uint32_t max_intset_entries = 512;
+    };
+
+    compact_set() = default;
+    explicit compact_set(const options &opts) : opts_(opts) {}
+    // intset 연산 결과로 만든 집합 (원소 수 한도와 무관하게 intset 인코딩을 유지)
+    compact_set(intset ints, const options &opts) : ints_(std::move(ints)), opts_(opts) {}
+    compact_set(const compact_set &other);
+    compact_set(compact_set &&other) noexcept = default;
+    compact_set &operator=(const compact_set &other);
+    compact_set &operator=(compact_set &&other) noexcept = default;
+
+    /**
+     * @brief Adds member, converting to the table encoding if it is not an integer or the
+     * intset grows past max_intset_entries.
+     * @return true if the member is new.
+     */
+    bool insert(std::string_view member);
+    // 원소를 삭제. 있었으면 true
+    bool erase(std::string_view member);
+    bool contains(std::string_view member) const;
+
+    std::size_t size() const { return table_ ? table_->size() : ints_.size(); }
+    bool empty() const { return size() == 0; }
+
+    // intset 인코딩인지 여부 (OBJECT ENCODING에 해당)
+    bool is_intset() const { return !table_; }
+    // intset 인코딩일 때의 정수 집합
+    const intset &ints() const { return ints_; }
+    // table 인코딩이면 그 표 (SSCAN의 bucket 순회용), intset이면 nullptr
+    const table_type *table() const { return table_.get(); }
+
+    // 모든 원소에 대해 fn(std::string_view member) 호출 (intset은 오름차순)
+    template <typename Fn>
+    void for_each(Fn &&fn) const
+    {
+      if (table_)
+      {
+        for (const auto &member : *table_)
+        {
+          fn(std::string_view(member));
+        }
+        return;
+      }
+      char buf[24];
+      ints_.for_each([&](std::int64_t value) {
+        auto result = std::to_chars(buf, buf + sizeof(buf), value);
+        fn(std::string_view(buf, static_cast<std::size_t>(result.ptr - buf)));
+      });
+    }
+
+    // 구조와 배열/표를 포함한 전체 메모리 사용량 (bytes). O(1)
+    std::size_t memory_usage() const;
+
+  private:
+    void convert_to_table();
+
+    intset ints_;                       // intset 인코딩의 원소
+    options opts_;
+    std::unique_ptr<table_type> table_; // table 인코딩이면 non-null
+    std::size_t table_heap_bytes_ = 0;  // table의 원소 문자열이 따로 할당한 bytes
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_COMPACT_SET_HPP
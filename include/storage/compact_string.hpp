@@ -0,0 +1,144 @@
+#ifndef MINI_REDIS_COMPACT_STRING_HPP
+#define MINI_REDIS_COMPACT_STRING_HPP
+
+#include "storage/slab_arena.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace mini_redis
+{
+  /*
+   * 24 bytes 고정 크기의 문자열 (store의 키와 문자열 값).
+   * 23 bytes 이하는 객체 안에 그대로 저장하고(힙 할당 없음), 더 긴 문자열만 따로 할당함.
+   * 마지막 byte는 태그로 사용: 0~23이면 인라인 문자열의 길이, 그 외에는 [포인터 | 길이 | 용량(7 bytes)] 형태이며
+   * 태그가 할당한 곳(전역 allocator 또는 slab_arena)을 나타냄. 용량은 전역 allocator에서 할당한 경우에만 씀.
+   * (std::string은 32 bytes에 15 bytes까지만 인라인 저장 가능)
+   *
+   * arena를 넘기면 slab_arena::max_object_size 이하의 문자열은 그 arena의 slab에서 할당함.
+   * 해제할 때는 slab header에서 arena를 찾으므로 arena를 다시 넘길 필요가 없고,
+   * 복사본은 원본과 같은 arena에서 할당함. arena 할당과 해제는 arena 소유자의 잠금 안에서만 해야 함.
+   */
+  class compact_string
+  {
+  public:
+    static constexpr std::size_t inline_capacity = 23;
+
+    compact_string() noexcept { buf_[tag_pos] = 0; }
+    explicit compact_string(std::string_view s, slab_arena *arena = nullptr) { assign(s, arena); }
+    explicit compact_string(const char *s) { assign(s, nullptr); }
+    compact_string(const std::string &s) { assign(s, nullptr); }
+    compact_string(const compact_string &other) { assign(other.view(), other.arena()); }
+    compact_string(compact_string &&other) noexcept
+    {
+      std::memcpy(buf_, other.buf_, sizeof(buf_));
+      other.buf_[tag_pos] = 0;
+    }
+    compact_string &operator=(const compact_string &other)
+    {
+      if (this != &other)
+      {
+        compact_string tmp(other);
+        *this = std::move(tmp);
+      }
+      return *this;
+    }
+    compact_string &operator=(compact_string &&other) noexcept
+    {
+      if (this != &other)
+      {
+        release();
+        std::memcpy(buf_, other.buf_, sizeof(buf_));
+        other.buf_[tag_pos] = 0;
+      }
+      return *this;
+    }
+    ~compact_string() { release(); }
+
+    bool is_inline() const { return tag() <= inline_capacity; }
+    bool in_arena() const { return tag() == slab_tag; }
+
+    // slab에서 할당했으면 그 arena, 아니면 nullptr
+    slab_arena *arena() const { return in_arena() ? slab_arena::owner(data()) : nullptr; }
+
+    std::size_t size() const
+    {
+      if (is_inline())
+      {
+        return tag();
+      }
+      std::uint64_t n;
+      std::memcpy(&n, buf_ + sizeof(char *), sizeof(n));
+      return static_cast<std::size_t>(n);
+    }
+
+    const char *data() const
+    {
+      if (is_inline())
+      {
+        return buf_;
+      }
+      const char *p;
+      std::memcpy(&p, buf_, sizeof(p));
+      return p;
+    }
+
+    /**
+     * @brief Writable access to the size() bytes of the string (SETBIT, BITOP, ...).
+     * The buffer is never shared between strings, so writing through it changes only this value.
+     */
+    char *mutable_data() { return const_cast<char *>(data()); }
+
+    /**
+     * @brief Changes the size to n bytes, zero-filling new bytes and keeping the first
+     * min(n, size()) bytes. Growing a large string reserves extra capacity (doubling up to
+     * 1MB at a time, like Redis' sds), so repeated growth such as SETBIT at increasing
+     * offsets is amortized O(1) per byte.
+     * @param arena Where to allocate if the string has to move (as in the constructor).
+     */
+    void resize(std::size_t n, slab_arena *arena = nullptr);
+
+    std::string_view view() const { return std::string_view(data(), size()); }
+    std::string str() const { return std::string(data(), size()); }
+    operator std::string_view() const { return view(); }
+
+    // 인라인에 들어가지 못해 따로 할당한 byte 수 (slab이면 크기 등급만큼)
+    std::size_t heap_bytes() const
+    {
+      if (is_inline())
+      {
+        return 0;
+      }
+      return in_arena() ? slab_arena::class_size_for(size()) : heap_capacity();
+    }
+
+    bool operator==(const compact_string &other) const { return view() == other.view(); }
+    bool operator==(std::string_view other) const { return view() == other; }
+    bool operator!=(const compact_string &other) const { return view() != other.view(); }
+    bool operator!=(std::string_view other) const { return view() != other; }
+    bool operator==(const std::string &other) const { return view() == other; }
+    bool operator!=(const std::string &other) const { return view() != other; }
+    bool operator==(const char *other) const { return view() == other; }
+    bool operator!=(const char *other) const { return view() != other; }
+
+  private:
+    static constexpr std::size_t tag_pos = 23;
+    static constexpr unsigned char heap_tag = 0xFF;
+    static constexpr unsigned char slab_tag = 0xFE;
+
+    static constexpr std::size_t capacity_pos = 16;
+
+    unsigned char tag() const { return static_cast<unsigned char>(buf_[tag_pos]); }
+    void set_pointer(char *p, std::size_t n, unsigned char tag);
+    std::size_t heap_capacity() const;
+    void set_heap_capacity(std::size_t capacity);
+    void assign(std::string_view s, slab_arena *arena);
+    void release() noexcept;
+
+    alignas(8) char buf_[24];
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_COMPACT_STRING_HPP
@@ -0,0 +1,78 @@
+#ifndef MINI_REDIS_EVICTION_HPP
+#define MINI_REDIS_EVICTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mini_redis
+{
+  // maxmemory를 넘었을 때 삭제할 키를 고르는 정책 (Redis의 maxmemory-policy)
+  enum class eviction_policy
+  {
+    noeviction,  // 삭제하지 않고 메모리를 늘리는 쓰기를 거부
+    allkeys_lru, // 가장 오래전에 접근한 키
+    allkeys_lfu, // 가장 드물게 접근한 키
+    volatile_ttl // TTL이 있는 키 중 가장 먼저 만료될 키
+  };
+
+  /**
+   * @brief Parses a Redis-style policy name ("allkeys-lru", ...). Underscores are accepted too.
+   */
+  std::optional<eviction_policy> parse_eviction_policy(std::string_view name);
+  const char *eviction_policy_name(eviction_policy policy);
+
+  /*
+   * value_entry::access에 저장하는 LRU/LFU 정보 (Redis evict.c의 근사 알고리즘).
+   * - LRU: 초 단위 24 bits clock. 약 194일마다 한 바퀴 돌며, 경과 시간은 wrap을 고려해 계산.
+   * - LFU: [분 단위 16 bits 마지막 감쇠 시각 | 8 bits 로그 카운터].
+   *   카운터는 접근마다 1/((counter - 5) * 10 + 1) 확률로 증가하고, 1분마다 1씩 감소.
+   */
+  namespace access_policy
+  {
+    constexpr std::uint32_t lru_clock_max = (1u << 24) - 1;
+    constexpr std::uint8_t lfu_init_counter = 5;
+
+    std::uint32_t lru_clock();
+    std::uint32_t lru_idle_seconds(std::uint32_t access, std::uint32_t now);
+
+    std::uint32_t lfu_initial();
+    std::uint32_t lfu_touch(std::uint32_t access);
+    std::uint8_t lfu_decayed_counter(std::uint32_t access);
+  } // namespace access_policy
+
+  /*
+   * 축출 후보 풀 (Redis의 EvictionPoolLRU).
+   * 매번 소수의 키만 샘플링하지만, 지금까지 본 후보 중 점수가 높은(= 삭제하기 좋은) 키를
+   * 최대 16개까지 기억해 두므로 근사 LRU/LFU의 정확도가 올라감.
+   */
+  class eviction_pool
+  {
+  public:
+    static constexpr std::size_t capacity = 16;
+
+    struct candidate
+    {
+      std::uint64_t score; // 클수록 먼저 삭제
+      std::size_t shard;
+      std::string key;
+    };
+
+    // 풀이 가득 찼고 score가 가장 낮은 후보보다 낮으면 무시
+    void offer(std::uint64_t score, std::size_t shard, std::string_view key);
+
+    // 점수가 가장 높은 후보를 꺼냄
+    bool pop_best(candidate &out);
+
+    bool empty() const { return items_.empty(); }
+    void clear() { items_.clear(); }
+
+  private:
+    std::vector<candidate> items_; // score 오름차순
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_EVICTION_HPP
@@ -0,0 +1,86 @@
+#ifndef MINI_REDIS_EXPIRY_INDEX_HPP
+#define MINI_REDIS_EXPIRY_INDEX_HPP
+
+#include "storage/value_entry.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mini_redis
+{
+  /*
+   * 만료 시각으로 키를 찾기 위한 계층형 타이밍 휠 (hierarchical timing wheel, 1ms 해상도).
+   *
+   * - 64칸짜리 휠 6단: 0단은 1ms 칸(64ms 범위), 1단은 64ms 칸(약 4초), ... 5단은 약 2.2년 범위.
+   *   그보다 먼 만료 시각은 5단 가장 먼 칸에 두었다가 시간이 지나면 다시 배치함.
+   * - 상위 단의 칸은 하위 단이 한 바퀴 돌 때마다 하위 단으로 내려보냄(cascade).
+   * - 각 단의 사용 중인 칸을 64 bits bitmap으로 관리하여 빈 칸은 건너뜀. 0단이 비어 있으면 상위 단의
+   *   다음 사용 중인 칸까지 한 번에 넘어가므로, 시계가 크게 뛰어도 지나가는 64ms 구간을 하나씩 돌지 않음.
+   * 따라서 만료된 키 N개를 찾는 비용은 O(N + 단 수 × 지나간 사용 중인 칸 수)이고, 키 공간 전체를 훑지 않음.
+   *
+   * 항목은 키 대신 키의 해시(flat_table::hash)와 만료 시각만 저장함(16 bytes).
+   * TTL이 바뀌거나 키가 삭제되어도 항목을 찾아 지우지 않고 그대로 두며(lazy invalidation),
+   * 만료 시점에 store가 테이블의 실제 만료 시각을 다시 확인하므로 오래된 항목은 무시됨.
+   *
+   * 스레드 안전하지 않음: 호출자(store의 shard)가 잠금을 책임짐.
+   */
+  class expiry_index
+  {
+  public:
+    struct entry
+    {
+      std::uint64_t hash;
+      std::int64_t deadline; // steady_clock 기준 ms
+    };
+
+    static constexpr unsigned wheel_bits = 6;
+    static constexpr std::size_t wheel_size = std::size_t(1) << wheel_bits; // 단마다 칸 수
+    static constexpr std::size_t levels = 6;
+
+    explicit expiry_index(std::int64_t now_ms = steady_clock_ms());
+
+    /**
+     * @brief Registers a key hash to be reported once now reaches deadline.
+     */
+    void insert(std::uint64_t hash, std::int64_t deadline);
+
+    /**
+     * @brief Moves the wheel forward to now_ms. Entries whose deadline has been
+     * reached become due and can be taken with take_due().
+     */
+    void advance(std::int64_t now_ms);
+
+    /**
+     * @brief Moves up to max_entries due entries into out (appending).
+     * @return The number of entries taken.
+     */
+    std::size_t take_due(std::size_t max_entries, std::vector<entry> &out);
+
+    bool has_due() const { return due_pos_ < due_.size(); }
+
+    // 휠과 due 목록에 남아 있는 항목 수 (이미 무효가 된 항목 포함)
+    std::size_t size() const { return size_; }
+    // 휠의 칸과 due 목록이 할당한 메모리 (bytes). 할당이 바뀔 때마다 갱신하므로 O(1)
+    std::size_t memory_usage() const { return bytes_; }
+    void clear();
+
+  private:
+    using slot = std::vector<entry>;
+
+    void place(const entry &e);
+    void push(slot &s, const entry &e);
+    void cascade(std::size_t level);
+
+    std::array<std::array<slot, wheel_size>, levels> wheels_;
+    std::array<std::uint64_t, levels> occupied_{}; // 단마다 항목이 있는 칸의 bitmap
+    std::int64_t now_;                             // 마지막으로 처리한 ms
+
+    std::vector<entry> due_; // 만료 시각이 지나 store가 꺼내 가기를 기다리는 항목
+    std::size_t due_pos_ = 0;
+    std::size_t size_ = 0;
+    std::size_t bytes_ = 0;
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_EXPIRY_INDEX_HPP
@@ -0,0 +1,373 @@
+#ifndef MINI_REDIS_FLAT_TABLE_HPP
+#define MINI_REDIS_FLAT_TABLE_HPP
+
+#include "storage/compact_string.hpp"
+#include "storage/radix_tree.hpp"
+#include "storage/slab_arena.hpp"
+#include "storage/value_entry.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace mini_redis
+{
+  // 테이블의 키. 23 bytes 이하는 슬롯 안에 인라인으로, 더 긴 키는 테이블의 slab_arena에 저장
+  using compact_key = compact_string;
+
+  /*
+   * store의 키 공간을 위한 open addressing 해시 테이블 (SwissTable 방식).
+   *
+   * - 슬롯마다 1 byte의 control byte를 따로 배열로 두고, 해시의 하위 7 bits(H2)를 저장.
+   *   16개 슬롯(group) 단위로 control byte를 SSE2로 한 번에 비교하여 후보 슬롯만 키를 비교함.
+   * - 슬롯은 [compact_key | value_entry]를 하나의 연속 배열에 저장하므로
+   *   unordered_map처럼 키마다 노드를 할당하거나 포인터를 따라갈 필요가 없음.
+   * - 탐색은 group 단위 삼각수(triangular) probing, 최대 load factor는 7/8.
+   * - 증분 재해시: 테이블이 가득 차면 두 배 크기의 새 배열을 할당만 하고, 이전 배열의 슬롯은
+   *   이후의 쓰기 연산마다 rehash_step_slots개씩, 그리고 rehash_step() 호출(서버의 cron)로 조금씩 옮김.
+   *   이동이 끝나기 전까지 조회는 두 배열을 모두 확인하므로 항상 올바른 결과를 반환하고,
+   *   수천만 개의 키를 한 번에 옮기느라 모든 클라이언트가 멈추는 일이 없음.
+   *
+   * 스레드 안전하지 않음: 호출자(store의 shard)가 잠금을 책임짐.
+   * 삽입 시 재해시가 일어날 수 있으므로 반환된 value_entry 포인터는 다음 삽입 전까지만 유효함.
+   */
+  class flat_table
+  {
+  public:
+    using hash_type = std::uint64_t;
+    static constexpr std::size_t group_width = 16;
+
+    // 쓰기 연산(삽입/삭제) 한 번마다 이전 배열에서 옮기는 슬롯 수
+    static constexpr std::size_t rehash_step_slots = group_width;
+
+    /**
+     * @brief Hashes a key. The store computes this once per command and
+     * uses it both to pick the shard and to probe the shard's table.
+     */
+    static hash_type hash(std::string_view key);
+
+    flat_table() : flat_table(true) {}
+    // slab_allocator가 false이면 긴 키도 전역 allocator에서 할당 (비교 측정용)
+    explicit flat_table(bool slab_allocator);
+    ~flat_table();
+    flat_table(const flat_table &) = delete;
+    flat_table &operator=(const flat_table &) = delete;
+    flat_table(flat_table &&other) noexcept;
+    flat_table &operator=(flat_table &&other) noexcept;
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t capacity() const { return cur_.capacity; }
+    bool is_rehashing() const { return old_.capacity != 0; }
+
+    /**
+     * @brief Migrates up to max_slots slots of the previous array into the current one.
+     * Reads never migrate (they may run under a shared lock), so an idle timer
+     * calls this to finish migrations for shards that receive few writes.
+     * @return true if a migration is still in progress afterwards.
+     */
+    bool rehash_step(std::size_t max_slots);
+
+    value_entry *find(std::string_view key, hash_type h);
+    const value_entry *find(std::string_view key, hash_type h) const;
+
+    /**
+     * @brief Finds the key or inserts a default-constructed entry for it.
+     * @return The entry and whether it was newly inserted.
+     */
+    std::pair<value_entry *, bool> try_emplace(std::string_view key, hash_type h);
+
+    bool erase(std::string_view key, hash_type h);
+
+    /**
+     * @brief Erases an entry whose key hashes to h and whose TTL passed before now_ms
+     * (now_ms > expiry). Used by the expiry index, which stores only key hashes.
+     * @return true if an entry was erased.
+     */
+    bool erase_expired(hash_type h, std::int64_t now_ms);
+
+    // n개의 키를 재해시 없이 담을 수 있도록 미리 확장
+    void reserve(std::size_t n);
+    void clear();
+
+    /**
+     * @brief Starts migrating into a smaller array when fewer than 10% of the slots
+     * are used (e.g. after a burst of short-lived keys expired). Does nothing while
+     * a rehash is already in progress. An empty table releases its arrays at once.
+     * @return true if the table was shrunk or a shrink was started.
+     */
+    bool shrink_to_fit();
+
+    /**
+     * @brief Calls fn(std::string_view key, const value_entry &) for every entry.
+     */
+    template <typename Fn>
+    void for_each(Fn &&fn) const
+    {
+      for (const arrays *t : {&cur_, &old_})
+      {
+        for (std::size_t i = 0; i < t->capacity; ++i)
+        {
+          if (is_full(t->ctrl[i]))
+          {
+            fn(t->slots[i].key.view(), static_cast<const value_entry &>(t->slots[i].value));
+          }
+        }
+      }
+    }
+
+    /**
+     * @brief Erases every entry for which pred(std::string_view key, value_entry &) returns true.
+     * @return The number of erased entries.
+     */
+    template <typename Pred>
+    std::size_t erase_if(Pred &&pred)
+    {
+      std::size_t erased = 0;
+      for (arrays *t : {&cur_, &old_})
+      {
+        for (std::size_t i = 0; i < t->capacity; ++i)
+        {
+          if (is_full(t->ctrl[i]) && pred(t->slots[i].key.view(), t->slots[i].value))
+          {
+            erase_at(*t, i);
+            ++erased;
+          }
+        }
+      }
+      return erased;
+    }
+
+    /**
+     * @brief Visits up to max_slots slots starting at cursor and erases every entry
+     * for which pred(std::string_view key, value_entry &) returns true.
+     * Positions cover the current array followed by the previous one, so repeated
+     * calls walk the whole table a little at a time. A cursor invalidated by a
+     * resize just restarts the walk.
+     * @return The cursor to continue from, 0 once the end of the table was reached.
+     */
+    template <typename Pred>
+    std::size_t erase_if_range(std::size_t cursor, std::size_t max_slots, Pred &&pred)
+    {
+      const std::size_t total = cur_.capacity + old_.capacity;
+      if (cursor >= total)
+      {
+        cursor = 0;
+      }
+      const std::size_t end = std::min(total, cursor + max_slots);
+      for (std::size_t pos = cursor; pos < end; ++pos)
+      {
+        arrays &t = pos < cur_.capacity ? cur_ : old_;
+        const std::size_t i = pos < cur_.capacity ? pos : pos - cur_.capacity;
+        if (is_full(t.ctrl[i]) && pred(t.slots[i].key.view(), t.slots[i].value))
+        {
+          erase_at(t, i);
+        }
+      }
+      return end == total ? 0 : end;
+    }
+
+    /**
+     * @brief Records that an entry's value was modified in place. before is the
+     * value_memory() of the value prior to the change. Every in-place modification
+     * must be reported so that memory_usage() stays exact.
+     */
+    void value_resized(std::size_t before, const value_entry &entry)
+    {
+      value_heap_bytes_ += value_memory(entry.value);
+      value_heap_bytes_ -= before;
+    }
+
+    /**
+     * @brief Calls fn(std::string_view key, const value_entry &) for full slots starting
+     * at a given position (e.g. random) until fn has returned true count times or
+     * max_visits slots were looked at. Used to sample eviction candidates.
+     */
+    template <typename Fn>
+    void sample(std::size_t start, std::size_t count, std::size_t max_visits, Fn &&fn) const
+    {
+      const std::size_t total = cur_.capacity + old_.capacity;
+      if (total == 0 || size_ == 0)
+      {
+        return;
+      }
+      std::size_t pos = start % total;
+      for (std::size_t visited = 0; visited < max_visits && visited < total && count > 0; ++visited)
+      {
+        const arrays &t = pos < cur_.capacity ? cur_ : old_;
+        const std::size_t i = pos < cur_.capacity ? pos : pos - cur_.capacity;
+        if (is_full(t.ctrl[i]) && fn(t.slots[i].key.view(), static_cast<const value_entry &>(t.slots[i].value)))
+        {
+          --count;
+        }
+        pos = pos + 1 == total ? 0 : pos + 1;
+      }
+    }
+
+    /**
+     * @brief Calls fn(std::string_view key, const value_entry &) for the entries whose home
+     * group is the one named by cursor, and returns the cursor of the next home group
+     * (0 once every group was visited). Starting from 0 and feeding back the returned cursor
+     * visits every key that stays in the table for the whole walk at least once, even if the
+     * table grows, shrinks or is rehashing between calls (a key may be returned twice).
+     *
+     * The cursor counts home groups in reverse-binary order, as in Redis' dictScan: the groups
+     * 2^k arrays split one group into (or merge into one) share the low bits of the cursor, so
+     * a resize only changes which higher bits are still to be visited. With open addressing a key
+     * may sit in a later group of its probe chain, so each call walks the chain from the home
+     * group up to the first group with an empty slot (where lookups stop too) and keeps only
+     * the keys whose hash maps to that home group.
+     */
+    template <typename Fn>
+    std::uint64_t scan(std::uint64_t cursor, Fn &&fn) const
+    {
+      if (cur_.capacity == 0)
+      {
+        return 0;
+      }
+      if (!is_rehashing())
+      {
+        const std::uint64_t mask = cur_.capacity / group_width - 1;
+        scan_home_group(cur_, cursor & mask, fn);
+        return next_scan_cursor(cursor, mask);
+      }
+      // 작은 배열의 group 하나는 큰 배열의 group 여러 개(하위 bits가 같은)에 대응하므로 함께 방문
+      const arrays &small = cur_.capacity <= old_.capacity ? cur_ : old_;
+      const arrays &large = &small == &cur_ ? old_ : cur_;
+      const std::uint64_t small_mask = small.capacity / group_width - 1;
+      const std::uint64_t large_mask = large.capacity / group_width - 1;
+      scan_home_group(small, cursor & small_mask, fn);
+      do
+      {
+        scan_home_group(large, cursor & large_mask, fn);
+        cursor = next_scan_cursor(cursor, large_mask);
+      } while (cursor & (small_mask ^ large_mask));
+      return cursor;
+    }
+
+    // control byte, 슬롯 배열, 힙에 저장된 긴 키와 값을 합한 메모리 사용량 (bytes)
+    std::size_t memory_usage() const;
+
+    /**
+     * @brief Bytes that are allocated but can take new keys and values without allocating
+     * more: free slots (and their control bytes) and free space in the arena's slabs.
+     * Deleting a key makes its slot and slab objects reusable, so
+     * memory_usage() - reusable_bytes() drops with every erase even though nothing is freed.
+     */
+    std::size_t reusable_bytes() const;
+
+    /**
+     * @brief Arena for keys and for string values stored in this table (nullptr when
+     * disabled). Values must be allocated from it only under the owner's write lock.
+     */
+    slab_arena *arena() const { return arena_.get(); }
+
+    /**
+     * @brief Moves keys and string values that sit in sparsely used slabs into fuller ones
+     * (see slab_arena::should_move), so the sparse slabs empty out and are freed.
+     * Visits up to max_slots slots from cursor; returns the next cursor, 0 after the last slot.
+     */
+    std::size_t defrag(std::size_t cursor, std::size_t max_slots);
+
+    /**
+     * @brief While limited, a full table whose tombstones make up at least 1/16 of its
+     * capacity is cleaned up at the same size instead of doubling. Used near maxmemory,
+     * where deleted (evicted) slots should be reused rather than growing the table.
+     */
+    void limit_growth(bool limited) { growth_limited_ = limited; }
+
+    /**
+     * @brief Starts maintaining an ordered radix-tree index of the keys (built from the current
+     * keys, then updated by every insert and erase). Its memory counts in memory_usage().
+     */
+    void enable_key_index();
+
+    // 키 인덱스 (enable_key_index()를 호출하지 않았으면 nullptr)
+    const radix_tree *key_index() const { return index_.get(); }
+
+  private:
+    struct slot
+    {
+      compact_key key;
+      value_entry value;
+    };
+
+    // control byte 배열과 슬롯 배열 한 벌
+    struct arrays
+    {
+      std::int8_t *ctrl = nullptr;
+      slot *slots = nullptr;
+      std::size_t capacity = 0; // 항상 group_width의 2의 거듭제곱 배
+    };
+
+    // control byte 값: 음수는 빈 슬롯(empty) 또는 삭제 표시(tombstone), 0~127은 사용 중(H2)
+    static constexpr std::int8_t ctrl_empty = -128;
+    static constexpr std::int8_t ctrl_deleted = -2;
+
+    static bool is_full(std::int8_t c) { return c >= 0; }
+    static std::size_t h1(hash_type h) { return static_cast<std::size_t>(h >> 7); }
+    static std::int8_t h2(hash_type h) { return static_cast<std::int8_t>(h & 0x7F); }
+
+    static arrays allocate(std::size_t capacity);
+    static void release(arrays &t);
+    static std::size_t find_index(const arrays &t, std::string_view key, hash_type h);
+    static std::size_t find_insert_index(const arrays &t, hash_type h);
+
+    // cursor의 마스크 밖 bits를 모두 켠 뒤 뒤집어서 1을 더함 (상위 bit부터 증가)
+    static std::uint64_t next_scan_cursor(std::uint64_t cursor, std::uint64_t mask);
+
+    // home이 home group인 키를 probe chain에서 찾아 fn을 호출
+    template <typename Fn>
+    static void scan_home_group(const arrays &t, std::size_t home, Fn &fn)
+    {
+      const std::size_t group_mask = t.capacity / group_width - 1;
+      std::size_t group = home;
+      for (std::size_t step = 1; step <= group_mask + 1; ++step)
+      {
+        const std::int8_t *ctrl = t.ctrl + group * group_width;
+        bool has_empty = false;
+        for (std::size_t i = 0; i < group_width; ++i)
+        {
+          has_empty |= ctrl[i] == ctrl_empty;
+          const slot &s = t.slots[group * group_width + i];
+          if (is_full(ctrl[i]) && (h1(hash(s.key.view())) & group_mask) == home)
+          {
+            fn(s.key.view(), static_cast<const value_entry &>(s.value));
+          }
+        }
+        if (has_empty)
+        {
+          return;
+        }
+        group = (group + step) & group_mask;
+      }
+    }
+
+    void erase_at(arrays &t, std::size_t index);
+    void start_rehash(std::size_t new_capacity);
+    void finish_rehash();
+    void destroy();
+
+    arrays cur_;                  // 삽입은 항상 이 배열로
+    arrays old_;                  // 증분 재해시 중인 이전 배열 (capacity가 0이면 재해시 중 아님)
+    std::size_t migrate_pos_ = 0; // old_에서 다음에 옮길 슬롯 위치
+    std::size_t size_ = 0;        // 두 배열의 키 수 합계
+
+    // cur_에 더 채울 수 있는 슬롯 수. old_에 남은 키가 옮겨질 자리와
+    // 최대 load factor(7/8)를 위한 여유분을 미리 빼 둔 값.
+    std::size_t growth_left_ = 0;
+    std::size_t key_heap_bytes_ = 0;
+    std::size_t value_heap_bytes_ = 0; // value_memory()의 합
+    bool growth_limited_ = false;
+    // 슬롯 배열을 옮겨도 slab header가 가리키는 arena 주소는 그대로여야 하므로 따로 할당
+    std::unique_ptr<slab_arena> arena_;
+    std::unique_ptr<radix_tree> index_;
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_FLAT_TABLE_HPP
@@ -0,0 +1,123 @@
+#ifndef MINI_REDIS_GLOB_HPP
+#define MINI_REDIS_GLOB_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mini_redis
+{
+  /*
+   * 한 번 컴파일해서 여러 키에 반복 적용하는 Redis glob 패턴 (KEYS, SCAN MATCH).
+   *
+   * 문법은 Redis의 stringmatchlen과 같음:
+   *   *  임의의 문자열     ?  임의의 한 문자     \x  문자 x 그대로
+   *   [abc] [a-z] [^a-z]  문자 집합 (집합 안에서도 \로 escape, 닫는 ]가 없으면 패턴 끝까지)
+   *
+   * 컴파일하면 패턴을 '*'로 나눈 조각(segment)들이 되고, 각 조각은 고정 길이의 명령
+   * (리터럴 문자열, 아무 문자 하나, 문자 집합)의 나열임. 첫 조각은 문자열 맨 앞에, 마지막 조각은
+   * 맨 뒤에 고정되고, 가운데 조각은 왼쪽부터 처음 일치하는 곳을 찾으면 되므로 되돌아가기(backtracking)가
+   * 필요 없음. 가운데 조각의 위치는 조각 안의 리터럴을 SSE2로 검색(memmem)해서 찾음.
+   */
+  class glob_pattern
+  {
+  public:
+    explicit glob_pattern(std::string_view pattern);
+
+    bool match(std::string_view text) const;
+
+    // 일치하는 문자열이 모두 이것으로 시작하는 리터럴 접두사 (키 인덱스 검색용)
+    const std::string &literal_prefix() const { return prefix_; }
+
+    // 모든 문자열과 일치하는 패턴("*", "**" 등)인지
+    bool matches_all() const { return matches_all_; }
+
+    const std::string &source() const { return source_; }
+
+  private:
+    enum class op : std::uint8_t
+    {
+      literal,  // literals_[offset, offset + length)
+      any_char, // ? 를 length개
+      char_set, // sets_[offset]
+    };
+
+    struct instr
+    {
+      op kind;
+      std::uint32_t offset;
+      std::uint32_t length;
+    };
+
+    // '*' 사이의 조각: program_[first, first + count)의 명령, 일치하는 문자열 길이는 항상 width
+    struct segment
+    {
+      std::uint32_t first = 0;
+      std::uint32_t count = 0;
+      std::size_t width = 0;
+      // 검색에 쓸 리터럴 명령 위치와 그 앞까지의 길이 (리터럴이 없으면 literal_index = count)
+      std::uint32_t literal_index = 0;
+      std::size_t literal_skip = 0;
+    };
+
+    using byte_set = std::array<std::uint64_t, 4>;
+
+    void compile(std::string_view pattern);
+    void push_literal(char c);
+    void close_segment();
+    // text가 seg와 정확히 일치하는지 (길이는 호출자가 확인)
+    bool match_segment(const segment &seg, const char *text) const;
+    // text[from..]에서 seg가 처음 일치하는 위치, 없으면 npos
+    std::size_t find_segment(const segment &seg, std::string_view text, std::size_t from) const;
+
+    std::string source_;
+    std::string prefix_;
+    std::string literals_;
+    std::vector<byte_set> sets_;
+    std::vector<instr> program_;
+    std::vector<segment> segments_;
+    bool has_star_ = false;
+    bool matches_all_ = false;
+  };
+
+  /**
+   * @brief Finds needle in haystack, comparing 16 candidate positions at a time with SSE2
+   * (first and last byte filter, then a full compare). Falls back to std::string_view::find.
+   * @return The position of the first occurrence, or std::string_view::npos.
+   */
+  std::size_t find_literal(std::string_view haystack, std::string_view needle);
+
+  /*
+   * 최근에 사용한 컴파일된 패턴의 LRU 캐시. SCAN MATCH처럼 같은 패턴이 여러 번의 호출에 걸쳐
+   * 반복될 때 매번 다시 컴파일하지 않도록 함. 여러 스레드에서 동시에 사용 가능.
+   */
+  class glob_cache
+  {
+  public:
+    explicit glob_cache(std::size_t capacity = 64) : capacity_(capacity) {}
+
+    std::shared_ptr<const glob_pattern> get(const std::string &pattern);
+
+    std::size_t size() const;
+
+    // 프로세스 전체에서 공유하는 캐시
+    static glob_cache &global();
+
+  private:
+    using entry = std::pair<std::string, std::shared_ptr<const glob_pattern>>;
+
+    mutable std::mutex mutex_;
+    std::size_t capacity_;
+    std::list<entry> lru_; // 앞쪽이 최근에 사용한 패턴
+    std::unordered_map<std::string, std::list<entry>::iterator> index_;
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_GLOB_HPP
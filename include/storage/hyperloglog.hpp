@@ -0,0 +1,100 @@
+#ifndef MINI_REDIS_HYPERLOGLOG_HPP
+#define MINI_REDIS_HYPERLOGLOG_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mini_redis
+{
+  /*
+   * HyperLogLog 값의 저장 구조 (PFADD/PFCOUNT/PFMERGE, Redis와 같은 매개변수).
+   * 원소의 64-bit 해시 하위 14 bits로 16384개 register 중 하나를 고르고, 나머지 bits의
+   * 처음 1이 나오는 위치(1~51)의 최댓값을 그 register에 기록함. 표준 오차는 약 0.81%.
+   *
+   * - sparse 인코딩: 0이 아닌 register만 (index << 8 | 값) 정수로 정렬해 둠 (register당 4 bytes)
+   * - dense 인코딩: 16384개 register를 6 bits씩 빈틈없이 채운 12KB 배열
+   * sparse 배열이 sparse_max_bytes를 넘으면 dense로 한 번 변환하고 다시 돌아가지 않음.
+   * 추정값은 계산해 캐시해 두었다가 register가 바뀔 때만 버림.
+   */
+  class hyperloglog
+  {
+  public:
+    static constexpr unsigned precision = 14;
+    static constexpr std::size_t register_count = std::size_t(1) << precision;
+    // dense 인코딩의 크기 (6 bits * 16384 = 12288 bytes)
+    static constexpr std::size_t dense_bytes = register_count * 6 / 8;
+    // register의 최댓값 (해시에서 index를 뺀 50 bits가 모두 0일 때 51)
+    static constexpr unsigned max_rank = 64 - precision + 1;
+
+    struct options
+    {
+      // sparse 인코딩으로 둘 최대 크기 (bytes)
+      std::uint32_t sparse_max_bytes = 3000;
+    };
+
+    hyperloglog() = default;
+    explicit hyperloglog(const options &opts) : opts_(opts) {}
+    hyperloglog(const hyperloglog &other);
+    hyperloglog &operator=(const hyperloglog &other);
+
+    /**
+     * @brief Hashes element into its register and raises the register if needed.
+     * @return true if a register changed (the estimate may have changed).
+     */
+    bool add(std::string_view element);
+
+    // 추정 원소 수. 캐시가 있으면 O(1), 없으면 register를 한 번 훑음 (공유 잠금 아래에서 불러도 됨)
+    std::uint64_t count() const;
+
+    /*
+     * 여러 HyperLogLog를 합치는 작업 공간: register마다 1 byte인 펼친 배열 (16KB).
+     * 같은 index끼리 최댓값을 취하는 것이 합집합이므로, 펼친 배열끼리는 byte 단위 max 한 번으로
+     * 합쳐짐 (SSE2로 16개씩).
+     */
+    using raw_registers = std::vector<std::uint8_t>;
+    static raw_registers make_raw() { return raw_registers(register_count, 0); }
+    // raw[i] = max(raw[i], register i)
+    void merge_into(raw_registers &raw) const;
+    // 모든 register를 raw와의 최댓값으로 바꿈 (결과는 dense 인코딩)
+    void merge_from(const raw_registers &raw);
+    // 펼친 배열이 나타내는 집합의 추정 원소 수 (여러 키의 PFCOUNT)
+    static std::uint64_t estimate(const raw_registers &raw);
+
+    // 스냅샷용: 현재 인코딩 그대로 out에 덧붙임 ([0][sparse 항목 u32 LE...] 또는 [1][dense register 배열])
+    void serialize(std::string &out) const;
+    /**
+     * @brief Restores the registers written by serialize() (the encoding is kept as saved).
+     * @return false if data is malformed; the value is left unchanged.
+     */
+    bool deserialize(std::string_view data);
+
+    // sparse 인코딩인지 여부 (OBJECT ENCODING에 해당)
+    bool is_sparse() const { return !dense_; }
+    // 구조와 register 배열을 포함한 전체 메모리 사용량 (bytes). O(1)
+    std::size_t memory_usage() const;
+
+    // 원소 해시 (MurmurHash64A, seed는 Redis와 같음). 플랫폼과 무관하게 같은 값이 나옴
+    static std::uint64_t hash(std::string_view element);
+
+  private:
+    // 해시를 (register index, 값)으로 나눔
+    static void split_hash(std::uint64_t h, std::uint32_t &index, std::uint8_t &rank);
+    bool set_register(std::uint32_t index, std::uint8_t rank);
+    void convert_to_dense();
+    static std::uint64_t estimate_from_histogram(const std::uint32_t *histogram);
+
+    static constexpr std::uint64_t no_cache = ~std::uint64_t(0);
+
+    std::vector<std::uint32_t> sparse_;            // sparse 인코딩: (index << 8 | 값), index 순
+    std::unique_ptr<std::uint8_t[]> dense_;        // dense 인코딩이면 dense_bytes 크기의 배열
+    options opts_;
+    mutable std::atomic<std::uint64_t> cached_{0}; // 마지막 추정값 (no_cache면 다시 계산)
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_HYPERLOGLOG_HPP
@@ -0,0 +1,84 @@
+#ifndef MINI_REDIS_INTSET_HPP
+#define MINI_REDIS_INTSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mini_redis
+{
+  /*
+   * 정수만으로 된 SET의 저장 구조 (Redis의 intset).
+   * 원소를 오름차순으로 정렬해 연속된 배열에 둠. 모든 원소가 int32 범위이면 4 bytes씩,
+   * 하나라도 벗어나면 전체를 8 bytes로 한 번 넓히고 다시 줄이지 않음.
+   * 조회는 이진 탐색, 삽입/삭제는 배열 이동(O(n))이므로 큰 집합은 compact_set이 해시 집합으로 바꿈.
+   * 정렬되어 있으므로 교집합/합집합/차집합은 두 배열을 한 번씩 훑는 병합으로 계산하며,
+   * 교집합/차집합은 SIMD(SSE2, 컴파일러가 AVX2를 켜면 AVX2)로 한 번에 여러 원소씩 비교하고,
+   * 합집합은 SSE4.1이 켜져 있으면 4개씩 merge network로, 아니면 분기 없는 scalar 병합으로 계산함.
+   */
+  class intset
+  {
+  public:
+    // 추가했으면 true (이미 있으면 false)
+    bool insert(std::int64_t value);
+    // 삭제했으면 true
+    bool erase(std::int64_t value);
+    bool contains(std::int64_t value) const;
+
+    std::size_t size() const { return wide_ ? values64_.size() : values32_.size(); }
+    bool empty() const { return size() == 0; }
+    // 원소 하나의 크기 (4 또는 8 bytes)
+    std::size_t width() const { return wide_ ? 8 : 4; }
+    // i번째로 작은 원소
+    std::int64_t at(std::size_t i) const { return wide_ ? values64_[i] : values32_[i]; }
+
+    template <typename Fn>
+    void for_each(Fn &&fn) const
+    {
+      if (wide_)
+      {
+        for (std::int64_t v : values64_)
+        {
+          fn(v);
+        }
+      }
+      else
+      {
+        for (std::int32_t v : values32_)
+        {
+          fn(static_cast<std::int64_t>(v));
+        }
+      }
+    }
+
+    // 배열을 포함한 메모리 사용량 (bytes, intset 객체 자체 제외)
+    std::size_t heap_bytes() const
+    {
+      return values32_.capacity() * sizeof(std::int32_t) + values64_.capacity() * sizeof(std::int64_t);
+    }
+
+    // 정렬된 배열 (width()가 4이면 data32, 8이면 data64만 유효)
+    const std::int32_t *data32() const { return values32_.data(); }
+    const std::int64_t *data64() const { return values64_.data(); }
+
+    /**
+     * @brief Set algebra on two intsets with SIMD merge kernels. If the widths differ the
+     * narrower operand is widened to 64 bits first.
+     */
+    static intset intersect(const intset &a, const intset &b);
+    static intset unite(const intset &a, const intset &b);
+    static intset difference(const intset &a, const intset &b);
+
+  private:
+    void widen();
+    template <typename Kernel32, typename Kernel64>
+    static intset combine(const intset &a, const intset &b, std::size_t bound, Kernel32 &&kernel32,
+                          Kernel64 &&kernel64);
+
+    bool wide_ = false;
+    std::vector<std::int32_t> values32_;
+    std::vector<std::int64_t> values64_;
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_INTSET_HPP
@@ -0,0 +1,113 @@
+#ifndef MINI_REDIS_LISTPACK_HPP
+#define MINI_REDIS_LISTPACK_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace mini_redis
+{
+  /*
+   * 여러 문자열을 하나의 연속된 버퍼에 이어 붙여 저장하는 형식 (Redis의 listpack).
+   * quicklist 노드와 작은 HASH의 저장에 사용.
+   *
+   * 원소 하나의 형식: [길이 varint][데이터][역방향 길이]
+   * 역방향 길이는 (길이 varint + 데이터)의 크기를 7 bits씩 나눈 것으로, 뒤에서부터 읽도록
+   * 가장 낮은 7 bits를 맨 끝 byte에 둠. 상위 bit가 1이면 왼쪽에 byte가 더 있음.
+   * 덕분에 버퍼의 끝에서부터도 원소를 하나씩 되짚어 갈 수 있음.
+   */
+  namespace listpack
+  {
+    inline std::size_t varint_size(std::size_t v)
+    {
+      std::size_t n = 1;
+      while (v >= 0x80)
+      {
+        v >>= 7;
+        ++n;
+      }
+      return n;
+    }
+
+    // 길이가 len인 값을 저장한 원소의 전체 크기
+    inline std::size_t entry_size(std::size_t len)
+    {
+      const std::size_t body = varint_size(len) + len;
+      return body + varint_size(body);
+    }
+
+    inline void append(std::string &out, std::string_view value)
+    {
+      std::size_t len = value.size();
+      const std::size_t body = varint_size(len) + len;
+      while (len >= 0x80)
+      {
+        out += static_cast<char>((len & 0x7f) | 0x80);
+        len >>= 7;
+      }
+      out += static_cast<char>(len);
+      out.append(value.data(), value.size());
+
+      char back[10];
+      std::size_t n = 0;
+      std::size_t rest = body;
+      do
+      {
+        back[n++] = static_cast<char>(rest & 0x7f);
+        rest >>= 7;
+      } while (rest != 0);
+      for (std::size_t i = 0; i + 1 < n; ++i)
+      {
+        back[i] = static_cast<char>(back[i] | 0x80);
+      }
+      for (std::size_t i = n; i > 0; --i)
+      {
+        out += back[i - 1];
+      }
+    }
+
+    inline std::string encode(std::string_view value)
+    {
+      std::string out;
+      out.reserve(entry_size(value.size()));
+      append(out, value);
+      return out;
+    }
+
+    // p에서 시작하는 원소의 값. size에는 원소 전체의 크기(역방향 길이 포함)를 저장
+    inline std::string_view read(const char *p, std::size_t &size)
+    {
+      std::size_t len = 0;
+      std::size_t shift = 0;
+      std::size_t header = 0;
+      unsigned char b;
+      do
+      {
+        b = static_cast<unsigned char>(p[header++]);
+        len |= static_cast<std::size_t>(b & 0x7f) << shift;
+        shift += 7;
+      } while (b & 0x80);
+      size = header + len + varint_size(header + len);
+      return std::string_view(p + header, len);
+    }
+
+    // end 바로 앞에서 끝나는 원소의 시작 위치
+    inline const char *before(const char *end)
+    {
+      std::size_t body = 0;
+      std::size_t shift = 0;
+      std::size_t back = 0;
+      unsigned char b;
+      do
+      {
+        b = static_cast<unsigned char>(*(end - 1 - back));
+        ++back;
+        body |= static_cast<std::size_t>(b & 0x7f) << shift;
+        shift += 7;
+      } while (b & 0x80);
+      return end - back - body;
+    }
+  } // namespace listpack
+} // namespace mini_redis
+
+#endif // MINI_REDIS_LISTPACK_HPP
@@ -0,0 +1,27 @@
+#ifndef MINI_REDIS_LZF_HPP
+#define MINI_REDIS_LZF_HPP
+
+#include <cstddef>
+
+namespace mini_redis
+{
+  /*
+   * LZF 형식(Redis가 quicklist 노드와 RDB 문자열 압축에 쓰는 형식)의 압축과 해제.
+   * 압축률보다 속도를 우선하는 LZ77 계열로, 8KiB 이내의 반복(키 접두사, JSON 필드 이름 등)을 찾아
+   * (길이, 거리) 참조로 바꿈.
+   */
+
+  /**
+   * @brief Compresses in[0, in_len) into out.
+   * @return The compressed size, or 0 if the result does not fit in out_len bytes.
+   */
+  std::size_t lzf_compress(const char *in, std::size_t in_len, char *out, std::size_t out_len);
+
+  /**
+   * @brief Decompresses in[0, in_len) into out.
+   * @return The decompressed size, or 0 if the input is corrupt or does not fit in out_len bytes.
+   */
+  std::size_t lzf_decompress(const char *in, std::size_t in_len, char *out, std::size_t out_len);
+} // namespace mini_redis
+
+#endif // MINI_REDIS_LZF_HPP
@@ -0,0 +1,134 @@
+#ifndef MINI_REDIS_QUICKLIST_HPP
+#define MINI_REDIS_QUICKLIST_HPP
+
+#include "storage/listpack.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mini_redis
+{
+  /*
+   * LIST 값의 저장 구조 (Redis의 quicklist).
+   * 원소마다 노드를 할당하는 std::list 대신, 여러 원소를 하나의 연속된 버퍼(packed block)에
+   * [길이][데이터][역방향 길이] 형식으로 이어 붙인 노드들의 이중 연결 리스트로 저장함.
+   * - 원소당 오버헤드가 노드 포인터 두 개 + std::string(약 48 bytes) 대신 2~3 bytes 수준
+   * - 양 끝의 push/pop은 끝 노드 버퍼만 수정 (앞쪽은 노드 크기만큼 memmove)
+   * - compress_depth > 0이면 양 끝에서 그 수만큼의 노드를 제외한 안쪽 노드를 LZF로 압축
+   *   (큐처럼 양 끝만 쓰는 긴 리스트에서 가운데 부분의 메모리를 줄임)
+   * 스레드 안전하지 않으며, store의 shard 잠금으로 보호됨.
+   */
+  class quicklist
+  {
+  public:
+    struct options
+    {
+      // 노드 하나의 packed block 크기 한도 (bytes). 이보다 큰 원소는 혼자 노드 하나를 차지
+      std::size_t node_bytes = 8192;
+      // 압축하지 않고 둘 양 끝 노드 수 (0이면 압축하지 않음)
+      std::size_t compress_depth = 0;
+    };
+
+    quicklist() = default;
+    explicit quicklist(const options &opts);
+    quicklist(const quicklist &other);
+    quicklist(quicklist &&other) noexcept;
+    quicklist &operator=(const quicklist &other);
+    quicklist &operator=(quicklist &&other) noexcept;
+    ~quicklist();
+
+    void push_front(std::string_view value);
+    void push_back(std::string_view value);
+    std::optional<std::string> pop_front();
+    std::optional<std::string> pop_back();
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Element at index (negative indexes count from the tail, -1 is the last element).
+     * @return std::nullopt if the index is out of range.
+     */
+    std::optional<std::string> at(long long index) const;
+
+    /**
+     * @brief Elements from start to stop inclusive, with LRANGE index semantics
+     * (negative indexes count from the tail, out-of-range indexes are clamped).
+     */
+    std::vector<std::string> range(long long start, long long stop) const;
+
+    /**
+     * @brief Keeps only the elements from start to stop inclusive (LTRIM semantics).
+     */
+    void trim(long long start, long long stop);
+
+    void clear();
+
+    /**
+     * @brief Calls fn(std::string_view) for every element from head to tail
+     * (compressed blocks are decompressed one at a time).
+     */
+    template <typename Fn>
+    void for_each(Fn &&fn) const
+    {
+      std::string scratch;
+      for (const node *n = head_; n; n = n->next)
+      {
+        const std::string_view block = raw(*n, scratch);
+        const char *p = block.data();
+        std::size_t entry_size;
+        for (std::uint32_t i = 0; i < n->count; ++i)
+        {
+          fn(listpack::read(p, entry_size));
+          p += entry_size;
+        }
+      }
+    }
+
+    // 노드 구조와 버퍼를 포함한 전체 메모리 사용량 (bytes)
+    std::size_t memory_usage() const;
+    std::size_t node_count() const { return node_count_; }
+    // 현재 압축되어 있는 노드 수
+    std::size_t compressed_nodes() const;
+
+  private:
+    struct node
+    {
+      node *prev = nullptr;
+      node *next = nullptr;
+      std::string data;         // packed entries, compressed이면 LZF로 압축된 bytes
+      std::uint32_t count = 0;  // 원소 수
+      std::uint32_t raw_size = 0; // 압축 해제된 packed block의 크기
+      bool compressed = false;
+      bool incompressible = false; // 마지막 수정 이후 압축을 시도했지만 줄지 않음
+    };
+
+    // 노드의 packed block (압축되어 있으면 scratch에 풀어서)
+    std::string_view raw(const node &n, std::string &scratch) const;
+    void compress(node &n);
+    void decompress(node &n);
+    // 구조가 바뀐 뒤 양 끝 compress_depth개 노드는 풀고 그 바로 안쪽 노드를 압축
+    void fix_compression();
+
+    node *new_node();
+    // 끝 노드가 가득 차서 새 노드를 만들 때 이전 끝 노드의 여유 용량을 반납
+    void seal(node *n);
+    void link_front(node *n);
+    void link_back(node *n);
+    void unlink(node *n);
+    void remove_front(std::size_t count);
+    void remove_back(std::size_t count);
+
+    node *head_ = nullptr;
+    node *tail_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t node_count_ = 0;
+    std::size_t data_bytes_ = 0; // 노드 버퍼들이 힙에 차지하는 bytes (memory_usage를 O(1)로)
+    options opts_;
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_QUICKLIST_HPP
@@ -0,0 +1,183 @@
+#ifndef MINI_REDIS_RADIX_TREE_HPP
+#define MINI_REDIS_RADIX_TREE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace mini_redis
+{
+  /*
+   * 키 집합을 사전 순서로 유지하는 압축 trie (radix tree).
+   * store의 선택적 키 인덱스로, 리터럴 접두사가 있는 패턴(KEYS session:42:*)이 전체 키 대신
+   * 해당 접두사의 하위 트리만 방문하게 하고, 사전 순 범위 순회를 제공함.
+   *
+   * - 노드 하나는 [header | 간선 label] 한 번의 할당이고, 하나뿐인 자식 경로는 label로 합쳐 둠.
+   * - 자식 목록은 [첫 byte 배열 | 포인터 배열] 한 블록에 첫 byte 순으로 정렬해 두므로
+   *   자식을 찾을 때 다른 노드를 읽지 않음.
+   * - 키 인덱스는 값을 저장하지 않음: 키의 존재만 기록하고 값은 해시 테이블에서 찾음.
+   *   with_values로 만들면 노드마다 label 뒤에 포인터 하나를 더 두어 키 -> 값 map으로 쓸 수 있음
+   *   (STREAM의 entry ID -> block 인덱스). 키 인덱스의 노드 크기는 그대로임.
+   *
+   * 스레드 안전하지 않음: 소유자(flat_table, stream)의 잠금을 따름.
+   */
+  class radix_tree
+  {
+  public:
+    explicit radix_tree(bool with_values = false);
+    ~radix_tree();
+    radix_tree(const radix_tree &) = delete;
+    radix_tree &operator=(const radix_tree &) = delete;
+
+    // 새로 추가되었으면 true (이미 있으면 값도 바꾸지 않음). value는 with_values일 때만 저장
+    bool insert(std::string_view key, void *value = nullptr);
+    // 있어서 삭제했으면 true
+    bool erase(std::string_view key);
+    bool contains(std::string_view key) const;
+    // 키의 값. 키가 없거나 with_values가 아니면 nullptr
+    void *find(std::string_view key) const;
+    void clear();
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // 노드와 자식 블록에 할당한 bytes
+    std::size_t memory_usage() const { return memory_; }
+
+    /**
+     * @brief Calls fn(std::string_view key) for every key in [first, last) in lexicographic
+     * (byte-wise) order until fn returns false. An empty last means no upper bound.
+     * Subtrees entirely outside the range are skipped without being visited.
+     */
+    template <typename Fn>
+    void for_each_range(std::string_view first, std::string_view last, Fn &&fn) const
+    {
+      std::string buf;
+      walk(root_, buf, first, last, [&](std::string_view key, const node *) { return fn(key); });
+    }
+
+    /**
+     * @brief Like for_each_range, but calls fn(std::string_view key, void *value) (trees
+     * built with_values). Stopping after the first call gives the smallest key >= first.
+     */
+    template <typename Fn>
+    void for_each_entry(std::string_view first, std::string_view last, Fn &&fn) const
+    {
+      std::string buf;
+      walk(root_, buf, first, last, [&](std::string_view key, const node *n) { return fn(key, node_value(n)); });
+    }
+
+    /**
+     * @brief Calls fn(std::string_view key) for every key starting with prefix, in
+     * lexicographic order, until fn returns false.
+     */
+    template <typename Fn>
+    void for_each_prefix(std::string_view prefix, Fn &&fn) const
+    {
+      // 접두사로 시작하는 키는 [prefix, prefix의 다음 문자열) 범위
+      std::string last(prefix);
+      while (!last.empty() && static_cast<unsigned char>(last.back()) == 0xFF)
+      {
+        last.pop_back();
+      }
+      if (!last.empty())
+      {
+        last.back() = static_cast<char>(static_cast<unsigned char>(last.back()) + 1);
+      }
+      for_each_range(prefix, last, fn);
+    }
+
+  private:
+    /*
+     * header 17 bytes 바로 뒤에 label을 이어서 할당하므로 label이 7 bytes 이하인 잎 노드는
+     * malloc의 최소 크기(32 bytes) 한 칸에 들어감. with_values이면 label 뒤에 값 포인터
+     * (정렬되지 않은 위치라 memcpy로 읽고 씀).
+     */
+    struct node
+    {
+      // 자식 블록: [자식 label의 첫 byte (오름차순) | 8 bytes 정렬 | 자식 포인터]
+      unsigned char *block;
+      std::uint32_t label_len;
+      std::uint16_t child_count;
+      std::uint16_t child_capacity;
+      bool terminal; // 루트부터 이 노드까지의 경로가 키인지
+      char label_start[1];
+
+      char *label() { return label_start; }
+      const char *label() const { return label_start; }
+      std::string_view label_view() const { return std::string_view(label_start, label_len); }
+      unsigned char *first_bytes() const { return block; }
+      node **children() const { return reinterpret_cast<node **>(block + (child_capacity + 7) / 8 * 8); }
+    };
+
+    node *new_node(std::string_view label, bool terminal, void *value = nullptr);
+    void free_node(node *n);
+    void free_subtree(node *n);
+    // 노드의 label을 바꾼 복사본을 만들어 n을 대체 (자식 목록은 그대로 넘김)
+    node *relabel(node *n, std::string_view label);
+    static int find_child(const node *n, unsigned char c);
+    void add_child(node *parent, node *child);
+    void remove_child(node *parent, int index);
+    // 키가 아니고 자식이 하나뿐인 노드를 자식과 합친 노드를 반환
+    node *merge_with_child(node *n);
+    void grow_children(node *n);
+
+    std::size_t node_bytes(std::size_t label_len) const
+    {
+      return offsetof(node, label_start) + label_len + (with_values_ ? sizeof(void *) : 0);
+    }
+    void *node_value(const node *n) const;
+    void set_node_value(node *n, void *value);
+    const node *find_node(std::string_view key) const;
+    static std::size_t children_bytes(std::size_t capacity)
+    {
+      return (capacity + 7) / 8 * 8 + capacity * sizeof(node *);
+    }
+
+    // 범위 밖의 하위 트리는 건너뜀. fn이 false를 반환하거나 last에 도달하면 false
+    template <typename Fn>
+    static bool walk(const node *n, std::string &buf, std::string_view first, std::string_view last, Fn &&fn)
+    {
+      const std::size_t before = buf.size();
+      buf.append(n->label(), n->label_len);
+      const std::string_view path(buf);
+      // 이 하위 트리의 키는 모두 path로 시작하므로 path와 범위 경계의 같은 길이만큼을 비교
+      if (path.compare(first.substr(0, path.size())) < 0)
+      {
+        buf.resize(before);
+        return true;
+      }
+      if (!last.empty())
+      {
+        const int c = path.compare(0, std::min(path.size(), last.size()), last.substr(0, path.size()));
+        if (c > 0 || (c == 0 && path.size() >= last.size()))
+        {
+          return false;
+        }
+      }
+      if (n->terminal && path >= first && !fn(path, n))
+      {
+        return false;
+      }
+      node *const *children = n->children();
+      for (std::size_t i = 0; i < n->child_count; ++i)
+      {
+        if (!walk(children[i], buf, first, last, fn))
+        {
+          return false;
+        }
+      }
+      buf.resize(before);
+      return true;
+    }
+
+    const bool with_values_;
+    node *root_;
+    std::size_t size_ = 0;
+    std::size_t memory_ = 0;
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_RADIX_TREE_HPP
@@ -0,0 +1,108 @@
+#ifndef MINI_REDIS_SLAB_ARENA_HPP
+#define MINI_REDIS_SLAB_ARENA_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mini_redis
+{
+  /*
+   * 크기 등급(size class)별 slab에서 작은 객체(키, 문자열 값)를 할당하는 arena.
+   *
+   * - 64KiB slab 하나는 한 크기 등급의 객체만 담음. slab은 자기 크기로 정렬되어 있으므로
+   *   객체 주소의 하위 16 bits를 지우면 slab header가 나오고, 해제할 때 arena를 따로 넘길 필요가 없음.
+   * - 같은 shard의 키와 값이 같은 slab들에 모이므로, 전역 allocator에서 다른 shard나
+   *   일시적인 버퍼와 섞여 해제 후에도 페이지를 돌려주지 못하는 단편화가 줄어듦.
+   * - 비어 버린 slab은 몇 개만 재사용을 위해 남기고 바로 해제함.
+   * - should_move()는 jemalloc의 defrag hint처럼, 같은 등급 평균보다(또는 절반보다) 덜 찬 slab의
+   *   객체를 옮겨야 하는지 알려 줌. 소유자(flat_table::defrag)가 새로 할당해 복사한 뒤 이전 객체를 해제하면
+   *   드문드문 남은 slab이 비워져 해제됨.
+   *
+   * 스레드 안전하지 않음: 소유자(store의 shard)가 잠금을 책임짐.
+   * 할당과 해제 모두 shard의 쓰기 잠금 안에서만 일어남.
+   */
+  class slab_arena
+  {
+  public:
+    static constexpr std::size_t slab_size = 64 * 1024;
+    // 이보다 큰 객체는 slab을 쓰지 않고 전역 allocator에서 할당
+    static constexpr std::size_t max_object_size = 1024;
+    static constexpr std::size_t class_count = 32;
+    // 재사용을 위해 남겨 두는 빈 slab 수
+    static constexpr std::size_t max_empty_slabs = 4;
+
+    struct stats
+    {
+      std::size_t slabs = 0;           // 할당한 slab 수 (빈 slab 포함)
+      std::size_t empty_slabs = 0;     // 재사용을 위해 남겨 둔 빈 slab 수
+      std::size_t live_objects = 0;
+      std::size_t live_bytes = 0;      // 살아 있는 객체의 등급 크기 합
+      std::size_t requested_bytes = 0; // 살아 있는 객체가 요청한 크기 합
+
+      std::size_t slab_bytes() const { return slabs * slab_size; }
+      // slab 안에서 사용되지 않는 bytes (외부 단편화 + 빈 slab)
+      std::size_t free_bytes() const { return slab_bytes() - live_bytes; }
+    };
+
+    slab_arena() = default;
+    ~slab_arena();
+    slab_arena(const slab_arena &) = delete;
+    slab_arena &operator=(const slab_arena &) = delete;
+
+    // n bytes를 담는 크기 등급의 크기. n은 max_object_size 이하
+    static std::size_t class_size_for(std::size_t n);
+
+    /**
+     * @brief Allocates n bytes (1 <= n <= max_object_size) from the slab of the matching size class.
+     */
+    void *allocate(std::size_t n);
+
+    /**
+     * @brief Frees an object allocated by any slab_arena with the same n.
+     * The owning arena is found from the slab header.
+     */
+    static void deallocate(void *p, std::size_t n) noexcept;
+
+    // p를 할당한 arena
+    static slab_arena *owner(const void *p);
+
+    /**
+     * @brief True when p sits in a slab emptier than the average of its size class (or less
+     * than half full), so moving it elsewhere helps that slab become empty and be freed.
+     */
+    bool should_move(const void *p) const;
+
+    // 남겨 둔 빈 slab을 모두 해제하고 해제한 slab 수를 반환
+    std::size_t release_empty_slabs();
+
+    const stats &get_stats() const { return stats_; }
+
+  private:
+    struct slab;
+
+    struct size_class
+    {
+      slab *current = nullptr; // 할당에 사용 중인 slab
+      slab *partial = nullptr; // 빈 자리가 있는 다른 slab들 (이중 연결 리스트)
+      std::size_t slabs = 0;
+      std::size_t live = 0;
+    };
+
+    static std::size_t class_index(std::size_t n);
+    static slab *slab_of(const void *p);
+
+    slab *new_slab(std::size_t cls);
+    slab *pick_partial(size_class &c);
+    void link_partial(size_class &c, slab *s);
+    void unlink_partial(size_class &c, slab *s);
+    void retire(slab *s);
+
+    std::array<size_class, class_count> classes_{};
+    std::vector<slab *> empty_;
+    stats stats_;
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_SLAB_ARENA_HPP
@@ -0,0 +1,301 @@
+#ifndef MINI_REDIS_SNAPSHOT_HPP
+#define MINI_REDIS_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mini_redis
+{
+  /*
+   * 키 공간 스냅샷 파일 (SAVE/BGSAVE가 쓰고, 서버 시작 시 읽음). 정수는 모두 little endian.
+   *
+   *   "MRDB" | version u32 | 키 수 u64 | 저장 시각 (unix ms) u64
+   *   chunk...: 레코드...  (레코드: type u8 (expiry_flag bit가 있으면 만료 시각 unix ms i64가 뒤따름) | key | 값)
+   *   index: chunk마다 offset u64 | bytes u64 | 키 수 u64 | shard u32 | CRC-64 u64
+   *   key index: 슬롯 u64 × 슬롯 수 (레코드 offset << 24 | 키 해시의 tag 24 bits, 0은 빈 슬롯)
+   *   footer: index offset u64 | chunk 수 u32 | 저장한 store의 shard 수 u32 |
+   *           key index offset u64 | key index 슬롯 수 u64 | key index의 CRC-64 u64 | eof_marker u8 |
+   *           header + index + footer 앞부분의 CRC-64 u64
+   *
+   * chunk는 레코드 경계에서 나뉘고 (약 chunk_size마다, 그리고 shard가 바뀔 때) 한 shard의 키만 담으며,
+   * 자기 CRC를 가지므로 서로 독립적으로 검증하고 읽을 수 있음. 로더는 footer와 index만 먼저 확인한 뒤
+   * chunk들을 여러 스레드에서 나누어 읽음 (shard 수가 같으면 스레드마다 shard를 통째로 맡아 잠금 경쟁 없이 넣음).
+   *
+   * key index는 키 해시(store의 flat_table::hash)로 레코드를 찾는 open addressing 테이블로
+   * (슬롯 수는 2의 거듭제곱, 해시의 하위 bits가 첫 슬롯, 선형 탐사), 파일을 모두 읽지 않고
+   * 필요한 키만 꺼내는 lazy 로더가 씀. 레코드 offset이 40 bits를 넘는 파일에는 key index가 없음 (슬롯 수 0).
+   *
+   * 문자열은 [길이 varint][bytes], 컬렉션은 [원소 수 varint][원소...]이고 값의 형식은 type마다 다름
+   * (store::write_snapshot 참고). header의 키 수는 로더가 테이블 크기를 미리 잡기 위한 상한값으로,
+   * 저장 중에 만료된 키는 빠질 수 있음. 만료 시각은 메모리에서처럼 steady_clock이 아니라
+   * 벽시계 기준으로 저장하여 재시작 뒤에도 같은 시각을 가리킴.
+   *
+   * version 2 파일 (key index와 그 footer 항목이 없음)과 version 1 파일 (chunk와 index 없이
+   * 레코드... | eof_marker | 전체 CRC-64)도 읽음. version 1은 전체를 한 chunk로 봄.
+   */
+  namespace snapshot
+  {
+    constexpr char magic[4] = {'M', 'R', 'D', 'B'};
+    constexpr std::uint32_t version = 3;
+    constexpr std::uint32_t unindexed_version = 2; // key index가 없는 chunk 형식
+    constexpr std::uint32_t legacy_version = 1;
+    // DUMP payload의 값 형식 버전 (파일 형식과 별개. 값 인코딩이 바뀔 때만 올림)
+    constexpr std::uint32_t encoding_version = 1;
+    constexpr std::size_t header_size = 4 + 4 + 8 + 8;
+    constexpr std::size_t index_entry_size = 8 + 8 + 8 + 4 + 8;
+    constexpr std::size_t footer_size = 8 + 4 + 4 + 8 + 8 + 8 + 1 + 8;
+    constexpr std::size_t unindexed_footer_size = 8 + 4 + 4 + 1 + 8;
+    // chunk가 이 크기를 넘으면 다음 레코드부터 새 chunk (로더가 나누어 가질 단위이자, lazy 적재에서
+    // 키 하나를 처음 읽을 때 checksum을 확인하는 단위이므로 그 지연의 상한)
+    constexpr std::size_t chunk_size = 1 << 20;
+    // chunk가 특정 shard에 속하지 않음 (version 1 파일)
+    constexpr std::uint32_t no_shard = 0xffffffff;
+    constexpr std::uint8_t eof_marker = 0xff;
+    constexpr std::uint8_t expiry_flag = 0x80;
+
+    // key index 슬롯: 레코드 offset (40 bits)과 키 해시의 상위 24 bits (tag)
+    constexpr unsigned key_tag_bits = 24;
+    constexpr std::uint64_t max_indexed_offset = (std::uint64_t(1) << (64 - key_tag_bits)) - 1;
+    inline std::uint64_t key_tag(std::uint64_t key_hash) { return key_hash >> (64 - key_tag_bits); }
+    inline std::uint64_t key_slot_tag(std::uint64_t slot) { return slot & ((std::uint64_t(1) << key_tag_bits) - 1); }
+    inline std::uint64_t key_slot_offset(std::uint64_t slot) { return slot >> key_tag_bits; }
+
+    // 레코드의 값 형식 (RedisValue의 대안 순서와 같음)
+    enum class value_type : std::uint8_t
+    {
+      string,
+      integer,
+      list,
+      hash,
+      set,
+      zset,
+      hll,
+      stream
+    };
+
+    /**
+     * @brief CRC-64/Jones (the checksum Redis uses for RDB files), continuing from crc.
+     * Table-driven, 8 bytes per step.
+     */
+    std::uint64_t crc64(std::uint64_t crc, const void *data, std::size_t size);
+
+    /*
+     * 스냅샷 형식의 값을 메모리 버퍼에 씀 (DUMP payload). writer가 이를 상속하여 버퍼가 차면 파일로 내보냄.
+     */
+    class encoder
+    {
+    public:
+      encoder() = default;
+      virtual ~encoder() = default;
+      encoder(const encoder &) = delete;
+      encoder &operator=(const encoder &) = delete;
+
+      void put_u8(std::uint8_t v)
+      {
+        buf_ += static_cast<char>(v);
+        maybe_flush();
+      }
+      void put_u32(std::uint32_t v);
+      void put_u64(std::uint64_t v);
+      void put_varint(std::uint64_t v);
+      void put_double(double v);
+      void put_string(std::string_view s);
+
+      // 아직 내보내지 않은 bytes (encoder만 쓰면 지금까지 쓴 전부)
+      std::string &buffer() { return buf_; }
+
+    protected:
+      void maybe_flush()
+      {
+        if (buf_.size() >= flush_threshold_)
+        {
+          flush();
+        }
+      }
+      // 버퍼를 내보냄 (메모리 encoder는 threshold에 닿지 않으므로 불리지 않음)
+      virtual void flush() {}
+      // threshold보다 큰 문자열을 버퍼를 거치지 않고 내보냄
+      virtual void write_through(std::string_view s) { buf_.append(s.data(), s.size()); }
+
+      std::string buf_;
+      std::size_t flush_threshold_ = static_cast<std::size_t>(-1);
+    };
+
+    // index의 한 항목
+    struct chunk_info
+    {
+      std::uint64_t offset = 0;
+      std::uint64_t size = 0;
+      std::uint64_t keys = 0;
+      std::uint32_t shard = no_shard;
+      std::uint64_t crc = 0;
+    };
+
+    /*
+     * 스냅샷 파일을 순서대로 쓰는 버퍼 writer. 1MB씩 모아 write하며 chunk의 CRC를 함께 계산.
+     * 레코드마다 begin_record로 그 키의 shard를 알리면 chunk 경계와 index를 writer가 관리함.
+     * commit()이 index와 footer를 쓰고 fsync까지 하므로, 그 전에 실패하거나 소멸된 파일은
+     * 불완전한 상태로 남음 (호출자가 임시 파일에 쓰고 commit 후에 rename해야 함).
+     */
+    class writer : public encoder
+    {
+    public:
+      /**
+       * @brief Creates (or truncates) the file at path.
+       * @throws std::runtime_error if the file cannot be created.
+       */
+      explicit writer(const std::string &path);
+      ~writer() override;
+
+      // 파일 맨 앞의 magic, version, 키 수 (상한값), 저장 시각, 그리고 저장하는 store의 shard 수
+      void put_header(std::uint64_t key_count, std::int64_t saved_unix_ms, std::uint32_t shard_count);
+
+      /**
+       * @brief Starts a record for a key of the given shard. Closes the current chunk first if the
+       * shard differs or the chunk has reached chunk_size. key_hash goes into the key index.
+       */
+      void begin_record(std::uint32_t shard, std::uint64_t key_hash);
+
+      /**
+       * @brief Writes the index, the key index and the footer, then flushes and fsyncs the file.
+       * @throws std::runtime_error on an I/O error (also thrown by the put_* calls that flush).
+       */
+      void commit();
+
+      // 지금까지 쓴 bytes (버퍼에 남은 것 포함)
+      std::uint64_t bytes_written() const { return flushed_ + buf_.size(); }
+
+    private:
+      static constexpr std::size_t buffer_size = 1 << 20;
+
+      void flush() override;
+      void write_through(std::string_view s) override { write_raw(s.data(), s.size()); }
+      void write_raw(const char *data, std::size_t size);
+      void close_chunk();
+      // 레코드 위치들로 key index를 만들어 out에 붙임. 만들 수 없으면 (너무 큰 파일) 슬롯 수 0
+      std::uint64_t append_key_index(std::string &out) const;
+
+      std::string path_;
+      std::string header_;           // footer의 CRC에 포함
+      std::uint32_t shard_count_ = 0;
+      std::vector<chunk_info> chunks_;
+      std::vector<std::pair<std::uint64_t, std::uint64_t>> records_; // 레코드마다 (키 해시, offset)
+      bool chunk_open_ = false;
+      std::uint64_t crc_ = 0;        // 열린 chunk의 (flush된 부분의) CRC
+      std::uint64_t flushed_ = 0;
+#ifdef __linux__
+      int fd_ = -1;
+#else
+      std::FILE *file_ = nullptr;
+#endif
+    };
+
+    /*
+     * 메모리의 스냅샷 형식 값을 앞에서부터 복사 없이 읽음 (DUMP payload와 스냅샷 chunk).
+     * 반환하는 string_view는 원본 메모리가 살아 있는 동안만 유효함.
+     * 범위를 벗어나는 읽기는 잘린 데이터로 보고 예외를 던짐.
+     */
+    class decoder
+    {
+    public:
+      decoder() = default;
+      decoder(const char *data, std::size_t size) : data_(data), end_(size) {}
+      virtual ~decoder() = default;
+      decoder(const decoder &) = delete;
+      decoder &operator=(const decoder &) = delete;
+
+      std::uint8_t get_u8()
+      {
+        need(1);
+        return static_cast<std::uint8_t>(data_[pos_++]);
+      }
+      std::uint32_t get_u32();
+      std::uint64_t get_u64();
+      std::uint64_t get_varint();
+      double get_double();
+      std::string_view get_string();
+
+      // 아직 읽지 않은 bytes
+      std::size_t remaining() const { return end_ - pos_; }
+      // 지금까지 읽은 bytes
+      std::size_t position() const { return pos_; }
+
+    protected:
+      void need(std::size_t n) const;
+
+      const char *data_ = nullptr;
+      std::size_t end_ = 0; // 읽을 수 있는 영역의 끝
+      std::size_t pos_ = 0;
+    };
+
+    /*
+     * 스냅샷 파일을 읽는 reader. 파일 전체를 mmap으로 매핑하고(리눅스) chunk를 복사 없이 넘겨줌.
+     * chunk()와 key index 조회는 여러 스레드에서 동시에 불러도 됨. 반환하는 메모리는 reader가
+     * 살아 있는 동안만 유효함.
+     */
+    class reader
+    {
+    public:
+      /**
+       * @brief Maps the file and checks the header, footer, index and key index (the whole file for
+       * version 1) before anything is read. Each chunk's own checksum is checked by chunk().
+       * @param sequential Whether the chunks will be read front to back (asks the kernel for large
+       *        read-ahead); false for lookups through the key index.
+       * @throws std::runtime_error if the file cannot be read or is not a valid snapshot.
+       */
+      explicit reader(const std::string &path, bool sequential = true);
+      ~reader();
+      reader(const reader &) = delete;
+      reader &operator=(const reader &) = delete;
+
+      // header의 키 수 (상한값)와 저장 시각
+      std::uint64_t key_count() const { return key_count_; }
+      std::int64_t saved_unix_ms() const { return saved_unix_ms_; }
+      std::size_t file_size() const { return size_; }
+      // 저장한 store의 shard 수 (version 1 파일은 0)
+      std::uint32_t shard_count() const { return shard_count_; }
+      const std::vector<chunk_info> &chunks() const { return chunks_; }
+
+      /**
+       * @brief The records of chunk i, after checking the chunk's checksum.
+       * @throws std::runtime_error on a checksum mismatch.
+       */
+      std::string_view chunk(std::size_t i) const;
+      // chunk i의 레코드 (checksum 확인 없이. chunk()로 한 번 확인한 chunk를 다시 읽을 때)
+      std::string_view unchecked_chunk(std::size_t i) const;
+      // chunk i를 곧 읽을 것이라고 커널에 알려 미리 읽게 함 (순서대로 읽지 않도록 연 reader용)
+      void will_need(std::size_t i) const;
+      // offset의 레코드가 들어 있는 chunk 번호 (chunk 밖이면 chunks().size())
+      std::size_t chunk_at(std::uint64_t offset) const;
+
+      // key index의 슬롯 수 (없으면 0)와 슬롯 i의 값
+      std::uint64_t key_index_slots() const { return key_index_slots_; }
+      std::uint64_t key_index_slot(std::uint64_t i) const;
+
+    private:
+      void release();
+      [[noreturn]] void fail(const std::string &message);
+
+      std::string path_;
+      const char *data_ = nullptr;
+      std::size_t size_ = 0;
+      std::uint64_t key_count_ = 0;
+      std::int64_t saved_unix_ms_ = 0;
+      std::uint32_t shard_count_ = 0;
+      std::vector<chunk_info> chunks_;
+      const unsigned char *key_index_ = nullptr;
+      std::uint64_t key_index_slots_ = 0;
+      bool verified_ = false; // version 1: 파일 전체의 CRC를 이미 확인함
+#ifndef __linux__
+      std::string contents_;
+#endif
+    };
+  } // namespace snapshot
+} // namespace mini_redis
+
+#endif // MINI_REDIS_SNAPSHOT_HPP
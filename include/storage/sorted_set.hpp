@@ -0,0 +1,234 @@
+#ifndef MINI_REDIS_SORTED_SET_HPP
+#define MINI_REDIS_SORTED_SET_HPP
+
+#include "storage/collection_scan.hpp"
+#include "storage/listpack.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mini_redis
+{
+  // ZRANGEBYSCORE의 점수 범위. "(1.5"처럼 괄호로 시작하면 그 끝은 제외
+  struct score_range
+  {
+    double min = -std::numeric_limits<double>::infinity();
+    double max = std::numeric_limits<double>::infinity();
+    bool min_exclusive = false;
+    bool max_exclusive = false;
+
+    bool above_min(double score) const { return min_exclusive ? score > min : score >= min; }
+    bool below_max(double score) const { return max_exclusive ? score < max : score <= max; }
+  };
+
+  // ZRANGEBYLEX의 member 범위. "-"/"+"는 무한, "[a"는 포함, "(a"는 제외
+  struct lex_range
+  {
+    std::string min;
+    std::string max;
+    bool min_exclusive = false;
+    bool max_exclusive = false;
+    bool min_unbounded = true;
+    bool max_unbounded = true;
+
+    bool above_min(std::string_view member) const
+    {
+      return min_unbounded || (min_exclusive ? member > min : member >= min);
+    }
+    bool below_max(std::string_view member) const
+    {
+      return max_unbounded || (max_exclusive ? member < max : member <= max);
+    }
+  };
+
+  /*
+   * SORTED SET 값의 저장 구조 (Redis의 listpack / skiplist + dict 이중 인코딩).
+   * 원소는 (점수, member) 순서로 정렬되며 점수가 같으면 member의 byte 순서를 따름.
+   *
+   * 작은 집합은 [member][점수 8 bytes]...를 정렬된 순서로 하나의 listpack 버퍼에 두고 선형으로 찾음.
+   * 원소 수가 max_listpack_entries를 넘거나 max_listpack_value보다 긴 member가 들어오면
+   * skiplist + dict로 한 번 변환하고, 이후로는 다시 listpack으로 돌아가지 않음.
+   *
+   * skiplist는 각 level의 forward 포인터에 건너뛰는 원소 수(span)를 함께 두어, 순위(rank)로 찾기와
+   * 원소의 순위 계산이 점수로 찾기와 같은 O(log n)임. dict(member -> 노드)는 ZSCORE와
+   * 갱신/삭제 시 현재 점수를 O(1)에 찾음. dict의 key는 노드가 가진 member 문자열을 가리킴.
+   */
+  class sorted_set
+  {
+  public:
+    struct options
+    {
+      // listpack으로 둘 최대 원소 수
+      std::uint32_t max_listpack_entries = 128;
+      // listpack으로 둘 member의 최대 길이 (bytes)
+      std::uint32_t max_listpack_value = 64;
+    };
+
+    // (member, 점수) 목록. 범위 조회의 결과
+    using entries = std::vector<std::pair<std::string, double>>;
+
+    sorted_set() = default;
+    explicit sorted_set(const options &opts) : opts_(opts) {}
+    sorted_set(const sorted_set &other);
+    sorted_set(sorted_set &&other) noexcept = default;
+    sorted_set &operator=(const sorted_set &other);
+    sorted_set &operator=(sorted_set &&other) noexcept = default;
+
+    /**
+     * @brief Sets member's score, inserting it if needed (converting to the skiplist
+     * encoding if a threshold is crossed).
+     * @return true if the member is new.
+     */
+    bool insert(std::string_view member, double score);
+    // member를 삭제. 있었으면 true
+    bool erase(std::string_view member);
+    std::optional<double> score(std::string_view member) const;
+
+    /**
+     * @brief 0-based position of member in score order (from the highest score if reverse).
+     * O(log n) in the skiplist encoding.
+     */
+    std::optional<std::size_t> rank(std::string_view member, bool reverse = false) const;
+
+    /**
+     * @brief Elements whose rank is in [start, stop] (0-based, inclusive, already clamped to
+     * the set's size by the caller), from the highest score if reverse.
+     */
+    entries range_by_rank(std::size_t start, std::size_t stop, bool reverse = false) const;
+    /**
+     * @brief Elements with a score in range, in score order (descending if reverse),
+     * skipping offset matches and returning at most count.
+     */
+    entries range_by_score(const score_range &range, bool reverse = false, std::size_t offset = 0,
+                           std::size_t count = std::numeric_limits<std::size_t>::max()) const;
+    // 점수가 모두 같다고 보고 member 순서로 범위를 고름 (ZRANGEBYLEX)
+    entries range_by_lex(const lex_range &range, bool reverse = false, std::size_t offset = 0,
+                         std::size_t count = std::numeric_limits<std::size_t>::max()) const;
+
+    std::size_t size() const { return skiplist_ ? skiplist_->length : count_; }
+    bool empty() const { return size() == 0; }
+
+    // listpack 인코딩인지 여부 (OBJECT ENCODING에 해당)
+    bool is_listpack() const { return !skiplist_; }
+
+    // 모든 원소에 대해 점수 순서로 fn(std::string_view member, double score) 호출
+    template <typename Fn>
+    void for_each(Fn &&fn) const
+    {
+      if (skiplist_)
+      {
+        for (const node *x = skiplist_->header->levels()[0].forward; x; x = x->levels()[0].forward)
+        {
+          fn(std::string_view(x->member), x->score);
+        }
+        return;
+      }
+      const char *p = packed_.data();
+      const char *end = p + packed_.size();
+      while (p < end)
+      {
+        std::size_t size;
+        const std::string_view member = listpack::read(p, size);
+        p += size;
+        const double score = packed_score(p, size);
+        p += size;
+        fn(member, score);
+      }
+    }
+
+    // skiplist 인코딩의 member -> 노드 dict를 scan_buckets로 방문 (ZSCAN용). fn(std::string_view member, double score)
+    template <typename Fn>
+    std::uint64_t scan_dict(std::uint64_t cursor, std::size_t count, Fn &&fn) const;
+
+    // 구조와 버퍼를 포함한 전체 메모리 사용량 (bytes). O(1)
+    std::size_t memory_usage() const;
+
+  private:
+    static constexpr int max_level = 32;
+
+    struct node;
+    struct level
+    {
+      node *forward;
+      std::size_t span; // forward까지 건너뛰는 원소 수
+    };
+
+    /*
+     * skiplist 노드. level 배열은 노드 바로 뒤에 height개만큼 함께 할당하므로
+     * 노드마다 level 수에 맞는 크기 하나만 할당함.
+     */
+    struct node
+    {
+      std::string member;
+      double score;
+      node *backward;
+      int height;
+
+      level *levels() { return reinterpret_cast<level *>(this + 1); }
+      const level *levels() const { return reinterpret_cast<const level *>(this + 1); }
+    };
+
+    struct skiplist
+    {
+      node *header;
+      node *tail = nullptr;
+      std::size_t length = 0;
+      int height = 1;
+      std::unordered_map<std::string_view, node *> dict;
+      std::size_t node_bytes = 0; // 노드와 member 문자열이 차지하는 bytes
+
+      skiplist();
+      ~skiplist();
+      skiplist(const skiplist &) = delete;
+      skiplist &operator=(const skiplist &) = delete;
+
+      node *insert(std::string_view member, double score);
+      void erase(node *x);
+      node *update_score(node *x, double score);
+      // 1-based 순위의 노드
+      node *at_rank(std::size_t rank) const;
+      std::size_t rank_of(const node *x) const;
+      node *first_in_range(const score_range &range) const;
+      node *last_in_range(const score_range &range) const;
+      node *first_in_range(const lex_range &range) const;
+      node *last_in_range(const lex_range &range) const;
+    };
+
+    static node *make_node(int height, std::string_view member, double score);
+    static void free_node(node *x);
+    static std::size_t node_size(int height) { return sizeof(node) + height * sizeof(level); }
+    static double packed_score(const char *p, std::size_t &size);
+    // listpack에서 member의 위치 (없으면 npos). score_at에는 점수 원소의 위치를 저장
+    std::size_t find_packed(std::string_view member, std::size_t &score_at) const;
+    void insert_packed(std::string_view member, double score);
+    void convert_to_skiplist();
+
+    template <typename Range>
+    entries packed_range(const Range &range, bool reverse, std::size_t offset, std::size_t count) const;
+    template <typename Range>
+    entries skiplist_range(const Range &range, bool reverse, std::size_t offset, std::size_t count) const;
+
+    std::string packed_;                  // listpack 인코딩의 [member][점수]... 버퍼
+    std::uint32_t count_ = 0;             // listpack 인코딩의 원소 수
+    options opts_;
+    std::unique_ptr<skiplist> skiplist_;  // skiplist 인코딩이면 non-null
+  };
+
+  template <typename Fn>
+  std::uint64_t sorted_set::scan_dict(std::uint64_t cursor, std::size_t count, Fn &&fn) const
+  {
+    return scan_buckets(skiplist_->dict, cursor, count, [&](const auto &item) { fn(item.first, item.second->score); });
+  }
+
+  // 다시 읽으면 같은 double이 되는 가장 짧은 표기 (ZSCORE, WITHSCORES, ZSCAN). 무한대는 inf / -inf
+  std::string format_score(double score);
+} // namespace mini_redis
+
+#endif // MINI_REDIS_SORTED_SET_HPP
@@ -1,48 +1,211 @@
 #ifndef MINI_REDIS_STORE_HPP
 #define MINI_REDIS_STORE_HPP
 
+#include "storage/value_entry.hpp"
+#include "storage/bitops.hpp"
+#include "storage/flat_table.hpp"
+#include "storage/expiry_index.hpp"
+#include "storage/eviction.hpp"
+#include "storage/snapshot.hpp"
+#include "storage/aof.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
-#include <list>
-#include <map>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <optional>
-#include <variant>
 #include <chrono>
+#include <random>
+#include <utility>
+#include <limits>
+#include <thread>
 
 namespace mini_redis
 {
-  // Redis 데이터 타입 정의
-  using RedisString = std::string;
-  using RedisList = std::list<std::string>;
-  using RedisHash = std::unordered_map<std::string, std::string>;
-  using RedisSet = std::unordered_set<std::string>;
-  using RedisSortedSet = std::map<double, std::string>; // score -> member
-
-  // std::variant를 사용하여 다양한 데이터 타입을 저장
-  using RedisValue = std::variant<
-      RedisString,
-      RedisList,
-      RedisHash,
-      RedisSet,
-      RedisSortedSet>;
-
-  // 값과 만료 시간을 저장하는 구조체
-  struct value_entry
+  // store 생성 시 사용되는 설정 값 (config.yaml의 storage 섹션)
+  struct store_config
   {
-    RedisValue value;
-    std::optional<std::chrono::steady_clock::time_point> expiry;
+    // Number of hash-partitioned shards, each guarded by its own lock.
+    std::size_t shards = 16;
+
+    // Memory limit for the keyspace in bytes (0 = unlimited).
+    std::size_t maxmemory = 0;
+    // Which keys to evict once maxmemory is reached.
+    eviction_policy maxmemory_policy = eviction_policy::noeviction;
+    // Keys sampled per eviction to refresh the candidate pool.
+    std::size_t maxmemory_samples = 5;
+
+    // Allocate long keys and string values from per-shard slab arenas instead of the global heap.
+    bool slab_allocator = true;
+
+    // Keep an ordered radix-tree index of the keys so that KEYS patterns with a literal
+    // prefix only visit the matching keys (costs extra memory per key).
+    bool key_index = false;
+
+    // Maximum size in bytes of one packed element block of a LIST value.
+    std::size_t list_node_bytes = 8192;
+    // Blocks at each end of a list kept uncompressed; inner blocks are compressed (0 = never).
+    std::size_t list_compress_depth = 0;
+
+    // HASH values stay in the compact listpack encoding while they have at most this many
+    // fields and every field and value is at most hash_max_listpack_value bytes.
+    std::size_t hash_max_listpack_entries = 128;
+    std::size_t hash_max_listpack_value = 64;
+
+    // SET values whose members are all integers stay in the sorted intset encoding while
+    // they have at most this many members.
+    std::size_t set_max_intset_entries = 512;
+
+    // Sorted sets stay in the compact listpack encoding while they have at most this many
+    // members and every member is at most zset_max_listpack_value bytes.
+    std::size_t zset_max_listpack_entries = 128;
+    std::size_t zset_max_listpack_value = 64;
+
+    // HyperLogLog values stay in the sparse encoding while it takes at most this many bytes,
+    // then switch to the 12KB dense register array.
+    std::size_t hll_sparse_max_bytes = 3000;
+
+    // STREAM entries are packed into blocks of at most this many entries and bytes; a new
+    // block is started when either limit is reached.
+    std::size_t stream_node_max_entries = 100;
+    std::size_t stream_node_max_bytes = 4096;
+
+    // Snapshot file written by SAVE/BGSAVE and loaded at startup (the persistence section).
+    std::string dir = ".";
+    std::string dbfilename = "dump.rdb";
+    // Start serving at once and load the snapshot in the background, decoding a key from the
+    // mapped file when it is first accessed (needs a snapshot with a key index).
+    bool lazy_load = false;
+  };
+
+  // 능동 만료(active expiry) 사이클 한 번의 결과
+  struct expire_cycle_result
+  {
+    std::size_t sampled = 0; // 확인한 TTL 키 수
+    std::size_t expired = 0; // 그중 만료되어 삭제한 키 수
+    bool timed_out = false;  // 시간 예산을 다 써서 중간에 멈췄는지 여부
+  };
+
+  // SCAN 계열 명령 한 번의 결과
+  struct scan_result
+  {
+    std::uint64_t cursor = 0;       // 다음 호출에 넘길 cursor (0이면 순회 완료)
+    std::vector<std::string> items; // 키, 또는 HSCAN/ZSCAN이면 [field, value, ...] / [member, score, ...]
+  };
+
+  // ZADD의 조건 옵션
+  struct zadd_flags
+  {
+    bool nx = false; // 새 member만 추가
+    bool xx = false; // 이미 있는 member만 갱신
+    bool gt = false; // 새 점수가 더 클 때만 갱신
+    bool lt = false; // 새 점수가 더 작을 때만 갱신
+    bool ch = false; // 반환 값에 점수가 바뀐 member 수도 포함
+  };
+
+  // BITFIELD의 하위 명령 하나 (GET/SET/INCRBY와 그때의 OVERFLOW 방식)
+  struct bitfield_op
+  {
+    enum class kind
+    {
+      get,
+      set,
+      incrby
+    };
+    enum class overflow
+    {
+      wrap, // 범위를 넘으면 2의 보수처럼 돌아감
+      sat,  // 최솟값/최댓값에 머묾
+      fail  // 쓰지 않고 nil을 반환
+    };
+
+    kind type = kind::get;
+    overflow on_overflow = overflow::wrap;
+    bool is_signed = false;
+    unsigned bits = 0;        // signed는 1~64, unsigned는 1~63
+    std::uint64_t offset = 0; // 필드의 첫 bit 위치
+    std::int64_t value = 0;   // SET의 값 또는 INCRBY의 증가량
+  };
+
+  // XREAD/XREADGROUP 결과: 키마다 읽은 항목
+  using stream_read_result = std::vector<std::pair<std::string, std::vector<stream::entry>>>;
+
+  // XPENDING 요약 형태의 결과
+  struct xpending_summary
+  {
+    std::size_t count = 0;         // 그룹의 PEL 항목 수
+    stream_id min;                 // 가장 작은/큰 pending ID (count가 0이면 의미 없음)
+    stream_id max;
+    std::vector<std::pair<std::string, std::size_t>> consumers; // pending이 있는 소비자와 그 수
+  };
+
+  // XPENDING 확장 형태의 항목 하나
+  struct xpending_entry
+  {
+    stream_id id;
+    std::string consumer;
+    std::int64_t idle_ms = 0;      // 마지막 전달 후 지난 시간
+    std::uint64_t deliveries = 0;  // 전달 횟수
+  };
+
+  // load_snapshot 결과
+  struct snapshot_load_stats
+  {
+    std::size_t keys = 0;    // 불러온 키 수
+    std::size_t expired = 0; // 파일에는 있지만 이미 만료되어 건너뛴 키 수
+    std::size_t bytes = 0;   // 파일 크기
+    std::size_t chunks = 0;  // 파일의 chunk 수
+    std::size_t threads = 0; // 실제로 쓴 스레드 수
+    double seconds = 0;      // checksum 확인을 포함한 전체 시간
+    bool deferred = false;   // load_snapshot_lazily: 키는 아직 파일에 있고 백그라운드에서 읽는 중
+  };
+
+  // load_snapshot의 진행 상황 (chunk 하나를 넣을 때마다 읽은 bytes와 전체 bytes로 호출됨. 호출은 직렬화됨)
+  using snapshot_progress = std::function<void(std::uint64_t done_bytes, std::uint64_t total_bytes)>;
+
+  // INFO persistence에 보고하는 스냅샷과 AOF rewrite 자식 프로세스의 상태
+  struct persistence_status
+  {
+    bool bgsave_in_progress = false;
+    std::int64_t last_save_time = 0; // 마지막으로 성공한 저장 시각 (unix 초, 저장한 적이 없으면 시작 시각)
+    bool last_bgsave_ok = true;
+    bool aof_rewrite_child = false;  // BGREWRITEAOF 자식이 아직 파일을 쓰는 중
+    bool last_aof_rewrite_ok = true; // 마지막 rewrite 자식이 성공했는지
+
+    // load_snapshot_lazily로 시작한 적재
+    bool loading = false;                 // 아직 파일에만 있는 키가 남아 있음
+    std::uint64_t loading_total_bytes = 0;
+    std::uint64_t loading_loaded_bytes = 0;  // 백그라운드 스레드가 끝낸 chunk의 bytes
+    std::uint64_t loading_faulted_keys = 0;  // 백그라운드 스레드보다 먼저 접근되어 그때 읽은 키 수 (끝난 뒤에도 유지)
+    std::string loading_error;            // 읽지 못한 chunk나 레코드가 있었으면 그 오류 (없으면 빈 문자열)
   };
 
   class store
   {
   public:
+    explicit store(const store_config &config = store_config{});
+    ~store();
+
     // String commands
     void set(const std::string &key, const std::string &value);
     void setex(const std::string &key, int ttl_seconds, const std::string &value);
+    void psetex(const std::string &key, long long ttl_ms, const std::string &value);
     std::optional<std::string> get(const std::string &key);
+    /**
+     * @brief MGET: calls visit once per key, in order, with the key's string value (std::nullopt
+     * if it is missing or holds another type). Each shard's read lock is taken once for the
+     * whole batch; the views are only valid during the call.
+     */
+    void mget(const std::vector<std::string> &keys,
+              const std::function<void(std::optional<std::string_view>)> &visit);
+    std::vector<std::optional<std::string>> mget(const std::vector<std::string> &keys);
+    // MSET: 모든 shard의 잠금을 한 번씩 잡고 모든 키를 설정 (TTL은 지움). 다른 명령에는 한꺼번에 보임
+    void mset(const std::vector<std::pair<std::string, std::string>> &pairs);
+    // MSETNX: 키가 하나도 없을 때만 모두 설정하고 true, 하나라도 있으면 아무것도 하지 않고 false
+    bool msetnx(const std::vector<std::pair<std::string, std::string>> &pairs);
     long long incr(const std::string &key);
     long long decr(const std::string &key);
     long long incrby(const std::string &key, long long increment);
@@ -51,16 +214,668 @@ namespace mini_redis
     // Generic commands
     int del(const std::string &key);
     int del(const std::vector<std::string> &keys);
+    // KEYS: pattern에 맞는 모든 키. lazy 적재 중이면 LOADING 오류를 던짐
     std::vector<std::string> keys(const std::string &pattern = "*");
     bool exists(const std::string &key);
-    void expire(const std::string &key, int seconds);
+    /**
+     * @brief Incremental keyspace iteration (SCAN). Each call visits roughly count keys
+     * (at most count * 10 table groups), holding one shard's read lock at a time and none
+     * between calls. Every key present for the whole walk is returned at least once even if
+     * tables are resized between calls; keys may be returned more than once.
+     *
+     * @param cursor 0 to start, then the cursor returned by the previous call.
+     * @param pattern Glob pattern the keys must match ("*" for all).
+     * @param type Value type name the keys must have (string, list, hash, set, zset), empty for any.
+     * @throws std::runtime_error (LOADING) while a lazy snapshot restore is still running.
+     */
+    scan_result scan(std::uint64_t cursor, const std::string &pattern = "*", std::size_t count = 10,
+                     const std::string &type = "");
+
+    /**
+     * @brief Incremental iteration over a set, hash or sorted set (SSCAN, HSCAN, ZSCAN).
+     * A missing key yields an empty result with cursor 0.
+     * @throws std::runtime_error if the key holds another type.
+     */
+    scan_result sscan(const std::string &key, std::uint64_t cursor, const std::string &pattern = "*",
+                      std::size_t count = 10);
+    scan_result hscan(const std::string &key, std::uint64_t cursor, const std::string &pattern = "*",
+                      std::size_t count = 10);
+    scan_result zscan(const std::string &key, std::uint64_t cursor, const std::string &pattern = "*",
+                      std::size_t count = 10);
+
+    // List commands
+    /**
+     * @brief Pushes values onto the head (LPUSH, each value becomes the new head in turn)
+     * or tail (RPUSH) of a list, creating it if needed.
+     * @return The length of the list after the push.
+     * @throws std::runtime_error if the key holds another type.
+     */
+    std::size_t lpush(const std::string &key, const std::vector<std::string> &values);
+    std::size_t rpush(const std::string &key, const std::vector<std::string> &values);
+    /**
+     * @brief Removes and returns up to count elements from the head (LPOP) or tail (RPOP).
+     * The key is deleted once the list is empty.
+     * @return std::nullopt if the key does not exist.
+     * @throws std::runtime_error if the key holds another type.
+     */
+    std::optional<std::vector<std::string>> lpop(const std::string &key, std::size_t count = 1);
+    std::optional<std::vector<std::string>> rpop(const std::string &key, std::size_t count = 1);
+    std::vector<std::string> lrange(const std::string &key, long long start, long long stop);
+    std::size_t llen(const std::string &key);
+    std::optional<std::string> lindex(const std::string &key, long long index);
+    void ltrim(const std::string &key, long long start, long long stop);
+
+    // Hash commands
+    /**
+     * @brief Sets fields of a hash (HSET), creating it if needed.
+     * @param fields Field-value pairs, applied in order.
+     * @return The number of fields that were added (not just updated).
+     * @throws std::runtime_error if the key holds another type.
+     */
+    std::size_t hset(const std::string &key, const std::vector<std::pair<std::string, std::string>> &fields);
+    std::optional<std::string> hget(const std::string &key, const std::string &field);
+    std::vector<std::optional<std::string>> hmget(const std::string &key, const std::vector<std::string> &fields);
+    // [field, value, field, value, ...]
+    std::vector<std::string> hgetall(const std::string &key);
+    // 삭제한 필드 수. 마지막 필드를 지우면 키도 삭제
+    std::size_t hdel(const std::string &key, const std::vector<std::string> &fields);
+    /**
+     * @brief Adds increment to the integer value of a field (HINCRBY), starting from 0.
+     * @throws std::runtime_error if the value is not an integer or the result would overflow.
+     */
+    long long hincrby(const std::string &key, const std::string &field, long long increment);
+    std::size_t hlen(const std::string &key);
+
+    // Set commands
+    /**
+     * @brief Adds members to a set (SADD), creating it if needed.
+     * @return The number of members that were added.
+     * @throws std::runtime_error if the key holds another type.
+     */
+    std::size_t sadd(const std::string &key, const std::vector<std::string> &members);
+    // 삭제한 원소 수. 마지막 원소를 지우면 키도 삭제
+    std::size_t srem(const std::string &key, const std::vector<std::string> &members);
+    bool sismember(const std::string &key, const std::string &member);
+    std::vector<std::string> smembers(const std::string &key);
+    std::size_t scard(const std::string &key);
+    /**
+     * @brief Intersection, union or difference (first key minus the rest) of the given sets
+     * (SINTER, SUNION, SDIFF). Missing keys count as empty sets. When every operand uses the
+     * intset encoding the result is computed with the SIMD intset merge kernels.
+     * @throws std::runtime_error if any key holds another type.
+     */
+    std::vector<std::string> sinter(const std::vector<std::string> &keys);
+    std::vector<std::string> sunion(const std::vector<std::string> &keys);
+    std::vector<std::string> sdiff(const std::vector<std::string> &keys);
+
+    // Sorted set commands
+    /**
+     * @brief Adds members or updates their scores (ZADD), creating the key if needed.
+     * @param members (score, member) pairs, applied in order.
+     * @return The number of members added (plus updated ones with flags.ch).
+     * @throws std::runtime_error if the key holds another type.
+     */
+    std::size_t zadd(const std::string &key, const std::vector<std::pair<double, std::string>> &members,
+                     const zadd_flags &flags = {});
+    /**
+     * @brief ZADD ... INCR: adds increment to member's score (starting from 0).
+     * @return The new score, or std::nullopt if the flags prevented the update.
+     * @throws std::runtime_error if the key holds another type or the result is NaN.
+     */
+    std::optional<double> zadd_incr(const std::string &key, double increment, const std::string &member,
+                                    const zadd_flags &flags = {});
+    double zincrby(const std::string &key, double increment, const std::string &member);
+    std::optional<double> zscore(const std::string &key, const std::string &member);
+    // 0부터 시작하는 순위 (reverse이면 높은 점수부터). O(log n)
+    std::optional<std::size_t> zrank(const std::string &key, const std::string &member, bool reverse = false);
+    /**
+     * @brief Members by rank (ZRANGE), with Redis index semantics (negative indexes count
+     * from the end, out-of-range indexes are clamped).
+     */
+    sorted_set::entries zrange(const std::string &key, long long start, long long stop, bool reverse = false);
+    sorted_set::entries zrangebyscore(const std::string &key, const score_range &range, bool reverse = false,
+                                      std::size_t offset = 0,
+                                      std::size_t count = std::numeric_limits<std::size_t>::max());
+    sorted_set::entries zrangebylex(const std::string &key, const lex_range &range, bool reverse = false,
+                                    std::size_t offset = 0,
+                                    std::size_t count = std::numeric_limits<std::size_t>::max());
+    // 삭제한 member 수. 마지막 member를 지우면 키도 삭제
+    std::size_t zrem(const std::string &key, const std::vector<std::string> &members);
+    std::size_t zcard(const std::string &key);
+
+    // Bitmap commands (문자열 값을 bitmap으로 다룸. byte 0의 최상위 bit가 bit 0)
+    /**
+     * @brief Sets or clears the bit at offset (SETBIT) in place, growing the string with
+     * zero bytes if needed and creating the key if missing.
+     * @return The previous value of the bit.
+     * @throws std::runtime_error if the key holds another type or offset is above
+     * bitops::max_bit_offset.
+     */
+    bool setbit(const std::string &key, std::uint64_t offset, bool value);
+    // offset 위치의 bit. 키가 없거나 문자열 밖이면 false
+    bool getbit(const std::string &key, std::uint64_t offset);
+    /**
+     * @brief Number of set bits (BITCOUNT) in [start, end], in bytes or with bit_unit in bits.
+     * Negative positions count from the end, as in GETRANGE.
+     */
+    std::uint64_t bitcount(const std::string &key, long long start = 0, long long end = -1, bool bit_unit = false);
+    /**
+     * @brief Position of the first bit equal to bit (BITPOS) in [start, end], in bytes or
+     * with bit_unit in bits. When looking for 0 without an explicit end, the string is
+     * treated as padded with zeros, so the result is never -1.
+     * @return The absolute bit position, or -1 if there is none.
+     */
+    long long bitpos(const std::string &key, bool bit, long long start = 0, std::optional<long long> end = std::nullopt,
+                     bool bit_unit = false);
+    /**
+     * @brief BITOP: stores op over the source strings (shorter ones padded with zeros) in dest,
+     * replacing its value and TTL. The result is computed directly in dest's buffer, in place
+     * when dest is also a source. An empty result deletes dest.
+     * @return The length of the result in bytes.
+     * @throws std::runtime_error if a source holds another type.
+     */
+    std::size_t bitop(bitops::operation op, const std::string &dest, const std::vector<std::string> &keys);
+    /**
+     * @brief Runs BITFIELD sub-commands in order on one string.
+     * @return One entry per op: the field value for GET, the old value for SET, the new value
+     * for INCRBY, or std::nullopt when OVERFLOW FAIL skipped the write.
+     * @throws std::runtime_error if the key holds another type.
+     */
+    std::vector<std::optional<std::int64_t>> bitfield(const std::string &key, const std::vector<bitfield_op> &ops);
+
+    // HyperLogLog commands
+    /**
+     * @brief Adds elements to the HyperLogLog at key (PFADD), creating it if missing.
+     * @return true if the key was created or a register changed.
+     * @throws std::runtime_error if the key holds another type.
+     */
+    bool pfadd(const std::string &key, const std::vector<std::string> &elements);
+    /**
+     * @brief Estimated number of distinct elements (PFCOUNT). One key uses the cached estimate;
+     * several keys are merged into a temporary register array. Missing keys count as empty.
+     */
+    std::uint64_t pfcount(const std::vector<std::string> &keys);
+    /**
+     * @brief PFMERGE: stores the union of dest and the sources in dest (dense encoding).
+     * @throws std::runtime_error if any of the keys holds another type.
+     */
+    void pfmerge(const std::string &dest, const std::vector<std::string> &sources);
+
+    // Stream commands
+    /**
+     * @brief XADD: appends an entry ([field, value, ...]) with the resolved ID, then applies trim.
+     * @return The new entry's ID, or std::nullopt if nomkstream is set and the key is missing.
+     * @throws std::runtime_error if the key holds another type or the ID is not greater than the top item.
+     */
+    std::optional<stream_id> xadd(const std::string &key, const stream::id_spec &id,
+                                  const std::vector<std::string> &fields, const stream_trim &trim = {},
+                                  bool nomkstream = false);
+    std::size_t xlen(const std::string &key);
+    // [start, end]의 항목을 최대 count개, reverse이면 큰 ID부터 (XRANGE/XREVRANGE)
+    std::vector<stream::entry> xrange(const std::string &key, stream_id start, stream_id end, std::size_t count,
+                                      bool reverse = false);
+    // 지운 항목 수 (XTRIM)
+    std::size_t xtrim(const std::string &key, const stream_trim &trim);
+    /**
+     * @brief XREAD without BLOCK: up to count entries (0 = no limit) after each key's ID.
+     * A std::nullopt ID ("$") means the stream's current last ID. Keys with nothing new
+     * are left out of the result.
+     */
+    stream_read_result xread(const std::vector<std::string> &keys, const std::vector<std::optional<stream_id>> &after,
+                             std::size_t count);
+    /**
+     * @brief XGROUP CREATE. A std::nullopt ID ("$") starts the group at the stream's last ID.
+     * @throws std::runtime_error if the key is missing (without mkstream) or the group exists (BUSYGROUP).
+     */
+    void xgroup_create(const std::string &key, const std::string &group, std::optional<stream_id> id,
+                       bool mkstream);
+    // XGROUP SETID: 그룹의 마지막 전달 ID를 바꿈 (std::nullopt이면 "$")
+    void xgroup_setid(const std::string &key, const std::string &group, std::optional<stream_id> id);
+    // XGROUP DESTROY: 그룹이 있었으면 true
+    bool xgroup_destroy(const std::string &key, const std::string &group);
+    // XGROUP CREATECONSUMER: 새로 만들었으면 true
+    bool xgroup_createconsumer(const std::string &key, const std::string &group, const std::string &consumer);
+    // XGROUP DELCONSUMER: 지운 소비자가 가지고 있던 pending 항목 수
+    std::size_t xgroup_delconsumer(const std::string &key, const std::string &group, const std::string &consumer);
+    /**
+     * @brief XREADGROUP without BLOCK. A std::nullopt ID (">") reads entries never delivered to
+     * the group; an explicit ID re-reads the consumer's pending entries after it. Keys with no
+     * new entries are left out; history reads always report the key.
+     * @throws std::runtime_error (NOGROUP) if a key or the group does not exist.
+     */
+    stream_read_result xreadgroup(const std::string &group, const std::string &consumer,
+                                  const std::vector<std::string> &keys,
+                                  const std::vector<std::optional<stream_id>> &after, std::size_t count, bool noack);
+    // XACK: PEL에서 지운 항목 수 (키나 그룹이 없으면 0)
+    std::size_t xack(const std::string &key, const std::string &group, const std::vector<stream_id> &ids);
+    // XPENDING key group
+    xpending_summary xpending(const std::string &key, const std::string &group);
+    /**
+     * @brief XPENDING key group [IDLE min_idle] start end count [consumer]: pending entries in
+     * [start, end] in ID order, optionally only one consumer's and only those idle for at least min_idle_ms.
+     */
+    std::vector<xpending_entry> xpending(const std::string &key, const std::string &group, stream_id start,
+                                         stream_id end, std::size_t count, const std::optional<std::string> &consumer,
+                                         std::int64_t min_idle_ms = 0);
+
+    bool expire(const std::string &key, int seconds);
+    bool pexpire(const std::string &key, long long ms);
     long long ttl(const std::string &key);
+    long long pttl(const std::string &key);
+
+    std::size_t shard_count() const { return shard_count_; }
+
+    /**
+     * @brief Advances in-progress incremental rehashes of shard tables.
+     * Called periodically by the server so that shards receiving few writes
+     * still finish growing. Each shard lock is held for one short batch at a time.
+     *
+     * @param budget Maximum wall time to spend.
+     */
+    void rehash_step(std::chrono::microseconds budget);
+
+    /**
+     * @brief Compacts fragmented shard arenas (like Redis's active defrag). Shards whose
+     * arenas hold more than 10% free slab space (and at least a few free slabs) are walked
+     * in short batches, moving objects out of sparse slabs; emptied slabs are freed once a
+     * walk completes. Does nothing when the arenas are not fragmented.
+     *
+     * @param budget Maximum wall time to spend.
+     */
+    void defrag_step(std::chrono::microseconds budget);
+
+    // 모든 shard arena의 통계 합계
+    slab_arena::stats allocator_stats();
+
+    /**
+     * @brief Actively reclaims expired keys that nobody reads again (like Redis's activeExpireCycle).
+     * Each shard's expiry index yields the key hashes whose deadline has passed, so the
+     * cost is proportional to the number of expiring keys rather than the keyspace size.
+     * They are checked against the table and deleted in small batches (one lock hold per
+     * batch), and the cycle resumes from the shard where it ran out of time.
+     * Not meant to be called concurrently with itself (the server runs it from one timer).
+     *
+     * @param budget Maximum wall time to spend.
+     */
+    expire_cycle_result active_expire_cycle(std::chrono::microseconds budget);
+
+    /**
+     * @brief Moving average of the fraction of checked TTL keys that were actually
+     * expired and deleted (the rest were overwritten, deleted or given a new TTL since).
+     */
+    double expired_stale_ratio() const { return expired_stale_ratio_.load(std::memory_order_relaxed); }
+
+    // 지금까지 만료되어 삭제된 키 수 (조회 시 발견된 것과 능동 만료 모두 포함)
+    std::uint64_t expired_keys() const { return expired_keys_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Memory used by the keyspace: shard tables (slots, keys, values) and
+     * expiry indexes. Maintained incrementally by every write, so reading it is O(1).
+     */
+    std::size_t memory_usage() const { return used_memory_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief The part of memory_usage() that maxmemory limits: everything except table
+     * slots that are allocated but free (deleting a key makes its slot reusable, so eviction
+     * lowers this even when the key and value were stored inline in the slot).
+     */
+    std::size_t dataset_memory() const { return dataset_memory_.load(std::memory_order_relaxed); }
+
+    std::size_t maxmemory() const { return maxmemory_; }
+    eviction_policy maxmemory_policy() const { return policy_; }
+
+    // maxmemory를 지키기 위해 축출된 키 수 (누적값. 단위 시간당 증가량이 축출 속도)
+    std::uint64_t evicted_keys() const { return evicted_keys_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Logs a DEL to aof for every key evicted from now on (like Redis's propagated
+     * deletions), so replaying the file does not bring evicted keys back. nullptr stops it.
+     */
+    void log_evictions_to(std::shared_ptr<append_only_file> aof);
+
+    /**
+     * @brief Turns maxmemory enforcement off or on. Off while the AOF is replayed: the file already
+     * holds the DELs of past evictions, and a replayed write must not be rejected with OOM.
+     */
+    void set_maxmemory_enforced(bool enforced) { maxmemory_enforced_.store(enforced, std::memory_order_relaxed); }
+
+    /**
+     * @brief Evicts keys until usage is within maxmemory, without a time budget (once after loading).
+     * @return The number of keys evicted.
+     */
+    std::size_t evict_to_maxmemory();
+
+    // 전체 키 수 (만료되었지만 아직 삭제되지 않은 키 포함)
+    std::size_t dbsize();
+
+    // Persistence
+    /**
+     * @brief SAVE: writes a point-in-time snapshot of every live key to dir/dbfilename through
+     * a temporary file that is renamed into place. Holds every shard's read lock while writing,
+     * so reads continue but writes wait.
+     * @throws std::runtime_error if a background save is running, a lazy snapshot restore is still
+     *         running (LOADING) or the file cannot be written.
+     */
+    void save();
+    /**
+     * @brief BGSAVE: forks a child that writes the snapshot from its copy-on-write view of
+     * memory, so writers only wait for the fork itself. The child is reaped by
+     * poll_background_save(). Builds without fork() save in the foreground instead.
+     * @throws std::runtime_error if a background save is already running or fork fails.
+     */
+    void bgsave();
+    // 끝난 BGSAVE 자식을 거두고, 성공했으면 임시 파일을 스냅샷 파일로 바꿈. 끝난 BGREWRITEAOF 자식은
+    // 결과 파일을 AOF writer에 넘김 (기다리지 않음. server cron이 호출)
+    void poll_background_save();
+    /**
+     * @brief Loads dir/dbfilename into the keyspace (for an empty store at startup). The file is
+     * mapped and its index checked first, every shard's table is sized for its key count, then
+     * threads workers (0: one per core) decode the chunks in parallel, each chunk's checksum checked
+     * as it is read. If the file was saved with the same shard count, each worker owns whole shards
+     * and inserts under that shard's lock alone. Keys whose TTL passed while the server was down are skipped.
+     * @return std::nullopt if there is no snapshot file.
+     * @throws std::runtime_error if the file is corrupt or of an unsupported version (keys from the
+     *         chunks read before the error stay loaded).
+     */
+    std::optional<snapshot_load_stats> load_snapshot(std::size_t threads = 0, const snapshot_progress &progress = {});
+    /**
+     * @brief Serve-while-loading startup: maps dir/dbfilename and returns as soon as its index and key
+     * index are checked, leaving the keys in the file. Any command that touches a key first decodes it
+     * from the mapping (so a write to a key not loaded yet applies to its saved value), and a background
+     * thread inserts the rest chunk by chunk, taking a shard lock for one record at a time so reads are
+     * never held up for long. KEYS, SCAN, SAVE, BGSAVE and BGREWRITEAOF, which need the whole keyspace,
+     * are refused with LOADING until it is done. progress is called from the loading threads. A file
+     * without a key index (version 1 or 2) is loaded in the foreground with load_snapshot() instead.
+     * @return std::nullopt if there is no snapshot file; otherwise keys is the number of indexed keys and
+     *         deferred is set unless the file was loaded in the foreground.
+     * @throws std::runtime_error if the file is corrupt or of an unsupported version. A chunk found to
+     *         be corrupt later is skipped and reported through persistence().loading_error.
+     */
+    std::optional<snapshot_load_stats> load_snapshot_lazily(const snapshot_progress &progress = {});
+    // load_snapshot_lazily의 적재가 아직 끝나지 않았는지
+    bool loading() const { return loading_.load(std::memory_order_acquire); }
+    // 남은 chunk를 이 스레드에서도 함께 읽어 lazy 적재가 끝날 때까지 기다림 (I/O 스레드에서는 부르지 않음)
+    void finish_loading();
+    persistence_status persistence() const;
+
+    /**
+     * @brief DUMP: serializes a key's value as [type][value in the snapshot encoding][version][CRC-64].
+     * @return std::nullopt if the key does not exist.
+     */
+    std::optional<std::string> dump(const std::string &key);
+    /**
+     * @brief RESTORE: creates a key from a DUMP payload.
+     * @param ttl_ms 0 for no expiry, otherwise milliseconds from now (or a unix time in ms if absolute_ttl).
+     * @throws std::runtime_error "BUSYKEY ..." if the key exists and replace is false,
+     *         or "ERR ..." if the payload is damaged or from another version.
+     */
+    void restore(const std::string &key, long long ttl_ms, bool absolute_ttl, std::string_view payload, bool replace);
+
+    /**
+     * @brief BGREWRITEAOF: forks, with every aof order stripe and every shard's read lock held so no write is
+     * half applied or half logged, and the child writes the shortest command list that rebuilds the
+     * keyspace (SET / RESTORE, PEXPIREAT) to a temporary file. aof buffers the writes that follow;
+     * once poll_background_save() reaps the child, aof's writer thread appends them and swaps the file in.
+     * Builds without fork() write the file in the foreground.
+     * @throws std::runtime_error if a rewrite or BGSAVE is already running, or fork fails.
+     */
+    void bgrewriteaof(append_only_file &aof);
 
   private:
+    using read_lock = std::shared_lock<std::shared_mutex>;
+    using write_lock = std::unique_lock<std::shared_mutex>;
+
+    /*
+     * 키 공간을 해시 값으로 분할한 조각(shard).
+     * 각 shard는 자신의 reader-writer lock을 가지므로 서로 다른 shard의 명령은 병렬로 실행되고,
+     * 같은 shard에 대해서도 읽기(GET, EXISTS, TTL, KEYS)끼리는 서로를 막지 않음.
+     * alignas(64): 인접한 shard의 lock이 같은 캐시 라인을 공유(false sharing)하지 않도록 함.
+     */
+    struct alignas(64) shard
+    {
+      flat_table data;
+      std::shared_mutex mutex;
+
+      // 읽기 잠금 중에 발견된 만료 키. 읽기 경로는 data를 수정할 수 없으므로
+      // 키 이름만 남겨 두고, 다음에 쓰기 잠금을 잡은 스레드가 실제로 삭제함.
+      std::mutex expired_mutex;
+      std::vector<std::string> expired_keys;
+      std::atomic<bool> has_expired{false};
+
+      // TTL이 있는 키의 해시를 만료 시각 순으로 찾기 위한 인덱스 (쓰기 잠금으로 보호)
+      expiry_index expires;
+
+      // used_memory_, dataset_memory_에 마지막으로 반영한 이 shard의 메모리 (쓰기 잠금으로 보호)
+      std::size_t accounted_memory = 0;
+      std::size_t accounted_dataset = 0;
+
+      // 진행 중인 defrag 순회의 다음 슬롯 위치 (0이면 진행 중 아님)
+      std::size_t defrag_cursor = 0;
+    };
+
+    /**
+     * @brief Finds a live key under the caller's read lock and returns its value if it holds T
+     * (recording the access for LRU/LFU).
+     * @return nullptr if the key is missing or expired.
+     * @throws std::runtime_error if the key holds another type.
+     */
+    template <typename T>
+    const T *find_collection(shard &sh, const std::string &key, flat_table::hash_type h);
+
+    std::size_t push_list(const std::string &key, const std::vector<std::string> &values, bool front);
+    std::optional<std::vector<std::string>> pop_list(const std::string &key, std::size_t count, bool front);
+
+    /**
+     * @brief Finds a live key under the caller's write lock. An expired key is deleted
+     * and reported as missing.
+     */
+    value_entry *find_for_write(shard &sh, const std::string &key, flat_table::hash_type h);
+
+    /**
+     * @brief The string form of find_collection: the bytes of a live string value under the
+     * caller's read lock (an integer-encoded value is written to scratch first).
+     * @return std::nullopt if the key is missing or expired.
+     * @throws std::runtime_error if the key holds another type.
+     */
+    std::optional<std::string_view> find_string(shard &sh, const std::string &key, flat_table::hash_type h,
+                                                std::string &scratch);
+    /**
+     * @brief An entry's value as a RedisString that can be modified in place (bitmap writes),
+     * creating an empty one for a new entry and converting an integer-encoded value.
+     * @throws std::runtime_error if the entry holds another type.
+     */
+    RedisString &writable_string(shard &sh, value_entry &entry, bool inserted);
+    /**
+     * @brief find_for_write for a stream key.
+     * @return nullptr if the key is missing or expired.
+     * @throws std::runtime_error if the key holds another type.
+     */
+    RedisStream *find_stream_for_write(shard &sh, const std::string &key, flat_table::hash_type h);
+    /**
+     * @brief The named group of the stream at key, for the XGROUP subcommands.
+     * @throws std::runtime_error if the key is missing or holds another type, or (NOGROUP) the group is missing.
+     */
+    stream::consumer_group &find_group_for_write(shard &sh, const std::string &key, flat_table::hash_type h,
+                                                 const std::string &group);
+
+    /**
+     * @brief The body of SET: stores a string value and clears the TTL.
+     * Caller must hold the shard's write lock.
+     */
+    void set_locked(shard &sh, const std::string &key, flat_table::hash_type h, const std::string &value);
+
     bool is_key_expired(const value_entry &entry);
+    std::size_t shard_index(flat_table::hash_type h) const;
+    /**
+     * @brief The shard of a key hash. While a lazy load is running, first decodes the key's record
+     * from the snapshot if nobody has yet (every key operation calls this before taking the shard's
+     * lock). Once the record is loaded this takes no lock, so it is also safe under a held lock.
+     */
+    shard &shard_for(flat_table::hash_type h);
+
+    /**
+     * @brief Sets an entry's deadline and registers it in the shard's expiry index.
+     * Caller must hold the shard's write lock.
+     */
+    void set_expiry(shard &sh, flat_table::hash_type h, value_entry &entry, std::int64_t deadline_ms);
+
+    /**
+     * @brief Records an expired key seen under a read lock for later removal.
+     */
+    void defer_expired(shard &sh, const std::string &key);
+
+    /**
+     * @brief Erases keys deferred by readers. Caller must hold the shard's write lock.
+     */
+    void reclaim_expired(shard &sh);
+
+    /**
+     * @brief Brings used_memory_ and dataset_memory_ up to date with the shard's current
+     * usage. Called at the end of every write-locked section that may change memory.
+     */
+    void sync_memory(shard &sh);
+
+    /**
+     * @brief Updates an entry's LRU clock or LFU counter according to the policy.
+     * Safe under a read lock (the access metadata is a relaxed atomic).
+     */
+    void touch(const value_entry &entry, bool inserted = false);
+
+    /**
+     * @brief Called before writes that may grow memory. Evicts keys while usage is
+     * above maxmemory, spending at most a short time budget per call.
+     * @throws std::runtime_error (OOM) if usage is above the limit and nothing can be evicted.
+     */
+    void ensure_memory();
+
+    // 샘플링으로 축출 후보를 하나 고름. 삭제할 수 있는 키가 없으면 false
+    bool next_eviction_candidate(eviction_pool::candidate &out);
+    void sample_eviction_candidates(std::size_t shard_idx);
+    bool evict(const eviction_pool::candidate &victim);
+
+    /**
+     * @brief Locks every shard touched by the given key hashes exactly once.
+     * Shards are locked in ascending index order so that concurrent
+     * multi-key operations can never deadlock on each other.
+     */
+    std::vector<write_lock> lock_shards(const std::vector<flat_table::hash_type> &hashes);
+    // lock_shards와 같은 순서로 읽기 잠금을 잡음 (여러 키를 읽기만 하는 명령용)
+    std::vector<read_lock> lock_shards_shared(const std::vector<flat_table::hash_type> &hashes);
+    // hashes가 속한 shard 번호들 (오름차순, 중복 없음)
+    std::vector<std::size_t> sorted_shards(const std::vector<flat_table::hash_type> &hashes) const;
+
+    // 모든 shard의 읽기 잠금 (번호 순서)
+    std::vector<read_lock> lock_all_shards_shared();
+
+    std::string snapshot_path() const;
+    /**
+     * @brief Writes every live key to a snapshot file at path. The caller holds every shard's
+     * lock, or is the forked BGSAVE child (a private copy of memory, where no lock may be taken).
+     */
+    void write_snapshot(const std::string &path);
+    /**
+     * @brief Reads one value of the given type from a snapshot into out, building collections
+     * with this store's encoding options. to_steady_ms converts saved wall-clock times.
+     */
+    void read_snapshot_value(snapshot::decoder &in, snapshot::value_type type, RedisValue &out, slab_arena *arena,
+                             std::int64_t to_steady_ms);
+    /**
+     * @brief Inserts the records of one snapshot chunk. If owned is set, the caller holds its write
+     * lock and every key must belong to it; otherwise each key's shard is locked in turn.
+     * @return The number of keys inserted; expired counts the ones skipped.
+     */
+    std::size_t load_snapshot_chunk(std::string_view records, shard *owned, std::int64_t now, std::int64_t to_steady,
+                                    std::size_t &expired);
+
+    // load_snapshot_lazily의 상태 (매핑한 파일, key index 슬롯마다 읽었는지 표시, 진행 상황. store.cpp)
+    struct lazy_snapshot;
+    /**
+     * @brief Loads every record of the lazy snapshot whose key index tag matches h and that nobody has
+     * loaded yet. Errors are recorded in the lazy state rather than thrown.
+     */
+    void fault_in(flat_table::hash_type h);
+    /**
+     * @brief Inserts the record at offset (in chunk) unless it was already loaded: marks its key index
+     * slot (looked up if slot is npos) and inserts the key under its shard's write lock. lock is kept
+     * if it already holds that shard, otherwise released and moved to it (left held for the caller).
+     * @return If find_next, the offset of the next record (the value of a record loaded by someone
+     *         else is read and dropped to get there), otherwise 0.
+     */
+    std::uint64_t hydrate_record(lazy_snapshot &lazy, std::size_t chunk, std::uint64_t offset, std::uint64_t slot,
+                                 bool find_next, write_lock &lock);
+    // 아직 아무도 맡지 않은 chunk를 하나씩 가져가 읽음. 마지막 chunk를 끝낸 스레드가 적재를 마침
+    void hydrate_chunks(lazy_snapshot &lazy);
+    /**
+     * @brief Writes the commands that rebuild every live key to path (the BGREWRITEAOF child's work;
+     * same locking rules as write_snapshot).
+     */
+    void write_aof_rewrite(const std::string &path);
+
+    enum class set_algebra
+    {
+      inter,
+      unite,
+      diff
+    };
+    std::vector<std::string> set_operation(const std::vector<std::string> &keys, set_algebra op);
+
+    /**
+     * @brief Applies ZADD to a sorted set under its shard's write lock.
+     * @param incr_result With INCR semantics (a single member whose score is added to),
+     * receives the new score, or std::nullopt if the flags prevented the update.
+     * @return The number of members added, plus updated ones with flags.ch.
+     */
+    std::size_t apply_zadd(const std::string &key, const std::vector<std::pair<double, std::string>> &members,
+                           const zadd_flags &flags, std::optional<double> *incr_result);
+
+    std::size_t shard_count_;
+    std::unique_ptr<shard[]> shards_;
+    const quicklist::options list_options_;
+    const compact_hash::options hash_options_;
+    const compact_set::options set_options_;
+    const sorted_set::options zset_options_;
+    const hyperloglog::options hll_options_;
+    const stream::options stream_options_;
+
+    std::size_t expire_next_shard_ = 0; // 다음 능동 만료 사이클이 시작할 shard
+    std::size_t defrag_next_shard_ = 0; // 다음 defrag_step이 시작할 shard
+    std::atomic<std::uint64_t> expired_keys_{0};
+    std::atomic<double> expired_stale_ratio_{0.0};
+
+    std::atomic<std::size_t> used_memory_{0};
+    std::atomic<std::size_t> dataset_memory_{0};
+    const std::size_t maxmemory_;
+    const eviction_policy policy_;
+    const std::size_t maxmemory_samples_;
+
+    // 축출은 한 번에 한 스레드만 진행 (후보 풀과 난수 생성기를 보호)
+    std::mutex eviction_mutex_;
+    eviction_pool eviction_pool_;
+    std::size_t eviction_next_shard_ = 0;
+    std::mt19937_64 eviction_rng_{std::random_device{}()};
+    std::atomic<std::uint64_t> evicted_keys_{0};
+    std::atomic<bool> maxmemory_enforced_{true};
+    std::shared_ptr<append_only_file> eviction_log_; // 축출을 DEL로 기록할 AOF (eviction_mutex_로 보호)
+
+    const std::string dir_;
+    const std::string dbfilename_;
+    // 아래 스냅샷 상태와 SAVE/BGSAVE의 시작을 보호
+    mutable std::mutex persistence_mutex_;
+    int bgsave_child_ = 0; // 실행 중인 BGSAVE 자식의 pid (0이면 없음)
+    int rewrite_child_ = 0; // 실행 중인 BGREWRITEAOF 자식의 pid (0이면 없음)
+    append_only_file *rewrite_aof_ = nullptr; // rewrite 결과를 넘길 AOF (자식이 끝날 때까지 살아 있어야 함)
+    std::string rewrite_temp_;                // 자식이 쓰는 파일
+    bool last_aof_rewrite_ok_ = true;
+    std::int64_t last_save_time_ = 0;
+    bool last_bgsave_ok_ = true;
+    std::string lazy_load_error_;        // 끝난 lazy 적재의 오류
+    std::uint64_t lazy_faulted_keys_ = 0; // 끝난 lazy 적재에서 먼저 접근되어 읽은 키 수
 
-    std::unordered_map<std::string, value_entry> data_;
-    std::mutex mutex_;
+    // lazy 적재 중에만 있음. 키를 찾는 스레드가 std::atomic_load로 복사해 쓰므로 적재가 끝나
+    // 비운 뒤에도 쓰던 스레드가 놓을 때까지 매핑이 유지됨
+    std::shared_ptr<lazy_snapshot> lazy_;
+    std::atomic<bool> loading_{false};
+    std::thread hydrator_;
   };
 } // namespace mini_redis
 
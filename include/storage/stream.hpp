@@ -0,0 +1,282 @@
+#ifndef MINI_REDIS_STREAM_HPP
+#define MINI_REDIS_STREAM_HPP
+
+#include "storage/radix_tree.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mini_redis
+{
+  // STREAM 항목의 ID: <밀리초>-<순번>. 스트림 안에서 항상 증가함
+  struct stream_id
+  {
+    std::uint64_t ms = 0;
+    std::uint64_t seq = 0;
+
+    static stream_id max() { return {std::numeric_limits<std::uint64_t>::max(), std::numeric_limits<std::uint64_t>::max()}; }
+
+    bool operator==(const stream_id &o) const { return ms == o.ms && seq == o.seq; }
+    bool operator!=(const stream_id &o) const { return !(*this == o); }
+    bool operator<(const stream_id &o) const { return ms < o.ms || (ms == o.ms && seq < o.seq); }
+    bool operator>(const stream_id &o) const { return o < *this; }
+    bool operator<=(const stream_id &o) const { return !(o < *this); }
+    bool operator>=(const stream_id &o) const { return !(*this < o); }
+
+    // 바로 다음/이전 ID로 바꿈 (XRANGE의 배타적 경계 '('). 이미 최대/최소이면 false
+    bool increment();
+    bool decrement();
+
+    std::string to_string() const;
+    /**
+     * @brief Parses "<ms>-<seq>" or "<ms>"; a missing sequence becomes missing_seq
+     * (0 for range starts, UINT64_MAX for range ends).
+     */
+    static std::optional<stream_id> parse(std::string_view s, std::uint64_t missing_seq = 0);
+  };
+
+  // XADD/XTRIM의 trim 조건 (MAXLEN|MINID [=|~] threshold [LIMIT count])
+  struct stream_trim
+  {
+    enum class strategy
+    {
+      none,
+      maxlen,
+      minid,
+    };
+    strategy by = strategy::none;
+    // '~': 통째로 지울 수 있는 block만 지움 (정확한 길이 대신 빠른 trim)
+    bool approximate = false;
+    std::uint64_t maxlen = 0;
+    stream_id minid;
+    // '~'일 때 한 번에 지울 최대 항목 수 (0이면 node_max_entries * 100)
+    std::size_t limit = 0;
+  };
+
+  /*
+   * STREAM 값의 저장 구조 (Redis의 rax + listpack 구조와 같은 방식).
+   *
+   * - 항목은 최대 node_max_entries개 / node_max_bytes bytes의 packed block에 차례로 쌓음.
+   *   block의 첫 항목 ID(master)를 기준으로 ID는 차이만 varint로 쓰고, 필드 이름이 첫 항목과
+   *   같으면 값만 저장함 (같은 모양의 이벤트가 이어지는 일반적인 경우 항목당 십여 bytes).
+   * - block들은 연결 리스트로 잇고, master ID(16 bytes big-endian)를 key로 하는 radix_tree로
+   *   찾음. 추가는 끝 block에만 하므로 O(1), 범위 읽기는 시작 block을 한 번 찾은 뒤 순서대로 훑음.
+   * - 항목은 앞에서부터만 지움 (XTRIM): 통째로 지울 block은 해제하고, 일부만 지우면 block 안의
+   *   시작 위치를 옮김.
+   * - 소비자 그룹은 마지막으로 전달한 ID와 전달 후 아직 ACK 받지 않은 항목 목록(PEL)을 가짐.
+   *
+   * 스레드 안전하지 않음: store의 shard 잠금을 따름.
+   */
+  class stream
+  {
+  public:
+    struct options
+    {
+      // block 하나의 최대 항목 수와 최대 크기 (bytes). 둘 중 먼저 닿는 쪽에서 새 block을 시작
+      std::uint32_t node_max_entries = 100;
+      std::uint32_t node_max_bytes = 4096;
+    };
+
+    // 항목 하나: ID와 [field, value, ...]. 소비자 그룹의 이력 읽기에서 이미 지워진 항목이면 fields가 빔
+    struct entry
+    {
+      stream_id id;
+      std::vector<std::string> fields;
+    };
+
+    // XADD의 ID 지정: "*"(둘 다 자동), "<ms>-*"(순번만 자동), "<ms>-<seq>"
+    struct id_spec
+    {
+      stream_id id;
+      bool auto_ms = true;
+      bool auto_seq = true;
+    };
+
+    // PEL 항목: 전달받은 소비자, 마지막 전달 시각(steady_clock ms), 전달 횟수
+    struct pending_entry
+    {
+      std::string consumer;
+      std::int64_t delivery_ms = 0;
+      std::uint64_t deliveries = 1;
+    };
+
+    struct consumer
+    {
+      std::int64_t seen_ms = 0;
+      std::set<stream_id> pending; // 이 소비자에게 전달되어 ACK를 기다리는 ID
+    };
+
+    struct consumer_group
+    {
+      stream_id last_delivered;
+      std::map<stream_id, pending_entry> pending;
+      std::map<std::string, consumer, std::less<>> consumers;
+    };
+
+    stream();
+    explicit stream(const options &opts);
+    ~stream();
+    stream(const stream &other);
+    stream(stream &&other) noexcept;
+    stream &operator=(const stream &other);
+    stream &operator=(stream &&other) noexcept;
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    // 지금까지 추가한 가장 큰 ID (항목이 모두 지워져도 유지됨)
+    stream_id last_id() const { return last_id_; }
+
+    /**
+     * @brief Resolves an XADD ID against the current top item and the wall clock.
+     * @throws std::runtime_error if the ID is 0-0 or not greater than last_id().
+     */
+    stream_id next_id(const id_spec &spec, std::uint64_t now_ms) const;
+    // 항목 추가. id는 last_id()보다 커야 함 (next_id로 구한 값), fields는 [field, value, ...]
+    void append(stream_id id, const std::vector<std::string> &fields);
+
+    /**
+     * @brief Calls fn(stream_id, const std::vector<std::string_view> &fields) for the entries
+     * in [start, end], in ID order or reversed, until fn returns false. The views point into
+     * the block and are only valid during the call.
+     */
+    template <typename Fn>
+    void for_each(stream_id start, stream_id end, bool reverse, Fn &&fn) const
+    {
+      if (start > end || size_ == 0)
+      {
+        return;
+      }
+      std::vector<std::string_view> master_fields, fields;
+      std::vector<const unsigned char *> positions;
+      stream_id id;
+      for (const block *b = locate(reverse ? end : start); b; b = reverse ? b->prev : b->next)
+      {
+        if (reverse ? b->last < start : b->master > end)
+        {
+          return;
+        }
+        const unsigned char *p = read_master_fields(*b, master_fields);
+        const unsigned char *stop = b->data.data() + b->data.size();
+        if (!reverse)
+        {
+          for (p = b->data.data() + b->head; p != stop;)
+          {
+            p = decode_entry(*b, p, master_fields, id, fields);
+            if (id > end)
+            {
+              return;
+            }
+            if (id >= start && !fn(id, fields))
+            {
+              return;
+            }
+          }
+          continue;
+        }
+        // 항목 길이가 제각각이라 뒤에서부터 읽으려면 block의 항목 위치를 먼저 모음
+        positions.clear();
+        for (p = b->data.data() + b->head; p != stop; p = skip_entry(p))
+        {
+          positions.push_back(p);
+        }
+        for (auto it = positions.rbegin(); it != positions.rend(); ++it)
+        {
+          decode_entry(*b, *it, master_fields, id, fields);
+          if (id < start)
+          {
+            return;
+          }
+          if (id <= end && !fn(id, fields))
+          {
+            return;
+          }
+        }
+      }
+    }
+
+    // [start, end]의 항목을 최대 count개 (XRANGE/XREVRANGE)
+    std::vector<entry> range(stream_id start, stream_id end, std::size_t count, bool reverse = false) const;
+    // 앞에서부터 조건에 맞게 항목을 지우고 지운 수를 반환 (XTRIM, XADD의 MAXLEN/MINID)
+    std::size_t trim(const stream_trim &how);
+
+    // 소비자 그룹
+    consumer_group *find_group(std::string_view name);
+    const std::map<std::string, consumer_group, std::less<>> &groups() const { return groups_; }
+    // 없던 그룹이면 만들고 true
+    bool create_group(const std::string &name, stream_id last_delivered);
+    bool destroy_group(std::string_view name);
+    // 없던 소비자이면 만들고 true
+    bool create_consumer(consumer_group &group, const std::string &name, std::int64_t now_ms);
+    // 소비자를 지우고, 그 소비자가 가지고 있던 PEL 항목 수를 반환
+    std::size_t delete_consumer(consumer_group &group, std::string_view name);
+
+    /**
+     * @brief XREADGROUP for one stream. With no after ID (">") delivers up to count entries
+     * newer than the group's last delivered ID, advancing it and (unless noack) adding them
+     * to the PEL. With an ID, re-reads the consumer's own pending entries after it.
+     * A count of 0 means no limit. The consumer is created if missing.
+     */
+    std::vector<entry> read_group(consumer_group &group, const std::string &consumer_name,
+                                  std::optional<stream_id> after, std::size_t count, bool noack, std::int64_t now_ms);
+    // PEL에서 ID들을 지우고 지운 수를 반환 (XACK)
+    std::size_t ack(consumer_group &group, const std::vector<stream_id> &ids);
+
+    // 스냅샷 로드용: 항목이 지워진 뒤에도 남는 마지막 ID (현재 last_id 이상이어야 함)
+    void restore_last_id(stream_id id);
+    // 스냅샷 로드용: PEL 항목 하나를 되살림 (소비자가 없으면 만듦)
+    void restore_pending(consumer_group &group, stream_id id, const std::string &consumer_name,
+                         std::int64_t delivery_ms, std::uint64_t deliveries);
+
+    // block, index, 소비자 그룹을 포함한 전체 메모리 사용량 추정 (bytes). O(1)
+    std::size_t memory_usage() const;
+
+  private:
+    struct block
+    {
+      stream_id master;        // 첫 항목의 ID (index의 key). 앞 항목이 지워져도 그대로 둠
+      stream_id last;          // 마지막 항목의 ID
+      std::uint32_t added = 0; // 추가한 항목 수 (지워진 앞 항목 포함)
+      std::uint32_t live = 0;  // 남은 항목 수
+      std::uint32_t head = 0;  // 첫 남은 항목의 위치 (data 안 offset)
+      // [master 필드 이름 목록][항목...]
+      std::vector<unsigned char> data;
+      block *prev = nullptr;
+      block *next = nullptr;
+    };
+
+    // id가 들어 있을 block (master가 id 이하인 마지막 block, 없으면 첫 block)
+    const block *locate(stream_id id) const;
+    static const unsigned char *read_master_fields(const block &b, std::vector<std::string_view> &names);
+    static const unsigned char *decode_entry(const block &b, const unsigned char *p,
+                                             const std::vector<std::string_view> &master_fields, stream_id &id,
+                                             std::vector<std::string_view> &fields);
+    static const unsigned char *skip_entry(const unsigned char *p);
+    block *new_block(stream_id id, const std::vector<std::string> &fields);
+    void remove_head_block();
+    // 첫 block의 앞 항목 n개를 지움 (n < live)
+    void drop_head_entries(std::size_t n);
+    void copy_from(const stream &other);
+    void release();
+
+    options opts_;
+    std::unique_ptr<radix_tree> index_; // master ID -> block
+    block *head_ = nullptr;
+    block *tail_ = nullptr;
+    std::size_t size_ = 0;
+    stream_id last_id_;
+    std::size_t block_bytes_ = 0; // block 구조체와 data 용량의 합
+    std::map<std::string, consumer_group, std::less<>> groups_;
+    std::size_t pending_count_ = 0;  // 모든 그룹의 PEL 항목 수 (메모리 추정용)
+    std::size_t consumer_count_ = 0; // 모든 그룹의 소비자 수 (메모리 추정용)
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_STREAM_HPP
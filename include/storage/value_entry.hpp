@@ -0,0 +1,252 @@
+#ifndef MINI_REDIS_VALUE_ENTRY_HPP
+#define MINI_REDIS_VALUE_ENTRY_HPP
+
+#include "storage/compact_string.hpp"
+#include "storage/compact_hash.hpp"
+#include "storage/compact_set.hpp"
+#include "storage/sorted_set.hpp"
+#include "storage/hyperloglog.hpp"
+#include "storage/stream.hpp"
+#include "storage/quicklist.hpp"
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <optional>
+#include <memory>
+#include <variant>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+
+namespace mini_redis
+{
+  // Redis 데이터 타입 정의
+  // 23 bytes까지 인라인으로 저장하고, 더 긴 값은 shard의 slab_arena에서 할당
+  using RedisString = compact_string;
+  // 정수로 표현되는 문자열 값의 인코딩 (Redis의 OBJ_ENCODING_INT). 명령에는 문자열과 똑같이 보임
+  using RedisInt = std::int64_t;
+  // 원소들을 packed block 노드에 모아 저장하는 연결 리스트 (Redis의 quicklist)
+  using RedisList = quicklist;
+  // 작은 HASH는 listpack 하나에, 커지면 unordered_map으로 저장 (Redis의 listpack/hashtable 인코딩)
+  using RedisHash = compact_hash;
+  // 정수만 있는 작은 SET은 정렬된 intset에, 그 밖에는 unordered_set으로 저장 (Redis의 intset/hashtable 인코딩)
+  using RedisSet = compact_set;
+  // 작은 SORTED SET은 listpack 하나에, 커지면 skiplist + dict로 저장 (Redis의 listpack/skiplist 인코딩)
+  using RedisSortedSet = sorted_set;
+  // PFADD/PFCOUNT/PFMERGE의 HyperLogLog. 작을 때는 sparse, 커지면 12KB dense register 배열
+  using RedisHll = hyperloglog;
+  // 추가만 하는 STREAM. 항목을 delta 인코딩한 packed block에 쌓고 radix tree로 ID를 찾음
+  using RedisStream = stream;
+
+  /*
+   * 컬렉션 타입을 힙에 따로 두는 값 래퍼.
+   * variant 안에 컨테이너를 직접 넣으면 가장 큰 타입(unordered_map) 크기만큼 모든 키가 공간을 차지하므로,
+   * 포인터 하나만 인라인으로 두어 대부분을 차지하는 문자열 키의 엔트리 크기를 줄임.
+   * 복사 시에는 내용을 깊은 복사하여 일반 값 타입처럼 동작함.
+   */
+  template <typename T>
+  class boxed
+  {
+  public:
+    boxed() : ptr_(std::make_unique<T>()) {}
+    boxed(T value) : ptr_(std::make_unique<T>(std::move(value))) {}
+    boxed(const boxed &other) : ptr_(std::make_unique<T>(*other.ptr_)) {}
+    boxed(boxed &&other) noexcept = default;
+    boxed &operator=(const boxed &other)
+    {
+      ptr_ = std::make_unique<T>(*other.ptr_);
+      return *this;
+    }
+    boxed &operator=(boxed &&other) noexcept = default;
+
+    T &operator*() { return *ptr_; }
+    const T &operator*() const { return *ptr_; }
+    T *operator->() { return ptr_.get(); }
+    const T *operator->() const { return ptr_.get(); }
+
+  private:
+    std::unique_ptr<T> ptr_;
+  };
+
+  // std::variant를 사용하여 다양한 데이터 타입을 저장
+  using RedisValue = std::variant<
+      RedisString,
+      RedisInt,
+      boxed<RedisList>,
+      boxed<RedisHash>,
+      boxed<RedisSet>,
+      boxed<RedisSortedSet>,
+      boxed<RedisHll>,
+      boxed<RedisStream>>;
+
+  /*
+   * 문자열이 int64의 표준 표기(부호는 '-'만, 앞자리 0과 공백 없음)이면 그 값을 반환.
+   * 표준 표기만 받아들이므로 정수로 저장한 값을 다시 문자열로 바꾸면 항상 원래 문자열과 같음.
+   */
+  inline std::optional<std::int64_t> parse_int64(std::string_view s)
+  {
+    if (s.empty() || s.size() > 20)
+    {
+      return std::nullopt;
+    }
+    const std::size_t digits = s[0] == '-' ? 1 : 0;
+    if (s.size() == digits || (s[digits] == '0' && (s.size() > digits + 1 || digits == 1)))
+    {
+      return std::nullopt; // "-", "007", "-0"
+    }
+    std::int64_t value;
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (ec != std::errc() || end != s.data() + s.size())
+    {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  // 문자열 값을 저장: 정수로 표현되면 RedisInt로, 아니면 RedisString으로 (arena가 있으면 그 slab에)
+  inline void assign_string(RedisValue &target, std::string_view value, slab_arena *arena = nullptr)
+  {
+    if (auto n = parse_int64(value))
+    {
+      target = *n;
+    }
+    else
+    {
+      target = RedisString(value, arena);
+    }
+  }
+
+  // 문자열 타입(RedisString 또는 RedisInt) 값의 내용. 문자열 타입이 아니면 std::nullopt
+  inline std::optional<std::string> string_value(const RedisValue &value)
+  {
+    if (auto str = std::get_if<RedisString>(&value))
+    {
+      return str->str();
+    }
+    if (auto n = std::get_if<RedisInt>(&value))
+    {
+      return std::to_string(*n);
+    }
+    return std::nullopt;
+  }
+
+  // 문자열 타입 값의 bytes를 복사 없이 반환 (정수 인코딩이면 scratch에 써서). 문자열 타입이 아니면 std::nullopt
+  inline std::optional<std::string_view> string_bytes(const RedisValue &value, std::string &scratch)
+  {
+    if (auto str = std::get_if<RedisString>(&value))
+    {
+      return str->view();
+    }
+    if (auto n = std::get_if<RedisInt>(&value))
+    {
+      scratch = std::to_string(*n);
+      return std::string_view(scratch);
+    }
+    return std::nullopt;
+  }
+
+  // TYPE 명령과 SCAN의 TYPE 옵션에서 쓰는 타입 이름
+  inline const char *value_type_name(const RedisValue &value)
+  {
+    switch (value.index())
+    {
+    case 0:
+    case 1:
+      return "string";
+    case 2:
+      return "list";
+    case 3:
+      return "hash";
+    case 4:
+      return "set";
+    case 5:
+      return "zset";
+    case 7:
+      return "stream";
+    default:
+      // Redis의 HyperLogLog는 문자열 값이므로 TYPE도 string으로 보고함
+      return "string";
+    }
+  }
+
+  // std::string이 인라인 버퍼(SSO)를 넘어 따로 할당한 bytes
+  inline std::size_t string_heap_bytes(const std::string &s)
+  {
+    const char *self = reinterpret_cast<const char *>(&s);
+    const bool is_inline = s.data() >= self && s.data() < self + sizeof(s);
+    return is_inline ? 0 : s.capacity() + 1;
+  }
+
+  /*
+   * 값이 힙에 따로 차지하는 메모리 추정치 (bytes). value_entry 자체의 크기는 제외.
+   * maxmemory 계산용으로, 컨테이너 노드의 할당 크기는 구현에 따라 다르므로 근사값임.
+   * 모든 타입이 O(1) (컬렉션은 스스로 사용량을 갱신하며 유지함).
+   */
+  struct value_memory_visitor
+  {
+    std::size_t operator()(const RedisString &s) const { return s.heap_bytes(); }
+    std::size_t operator()(const RedisInt &) const { return 0; }
+    std::size_t operator()(const boxed<RedisList> &list) const { return list->memory_usage(); }
+    std::size_t operator()(const boxed<RedisHash> &hash) const { return hash->memory_usage(); }
+    std::size_t operator()(const boxed<RedisSet> &set) const { return set->memory_usage(); }
+    std::size_t operator()(const boxed<RedisSortedSet> &zset) const { return zset->memory_usage(); }
+    std::size_t operator()(const boxed<RedisHll> &hll) const { return hll->memory_usage(); }
+    std::size_t operator()(const boxed<RedisStream> &s) const { return s->memory_usage(); }
+  };
+
+  inline std::size_t value_memory(const RedisValue &value)
+  {
+    return std::visit(value_memory_visitor{}, value);
+  }
+
+  /*
+   * 키의 접근 정보 (LRU/LFU 근사용, Redis의 robj.lru와 같은 24 bits).
+   * - LRU 정책: 마지막 접근 시각 (초 단위 LRU clock)
+   * - LFU 정책: 상위 16 bits는 마지막 감쇠 시각(분 단위), 하위 8 bits는 로그 스케일 접근 횟수
+   * GET 등 공유 잠금만 잡는 읽기 경로에서도 갱신하므로 relaxed atomic으로 저장하고,
+   * value_entry가 일반 값 타입처럼 복사/이동될 수 있도록 복사 연산을 직접 정의함.
+   */
+  class access_meta
+  {
+  public:
+    access_meta() = default;
+    access_meta(const access_meta &other) : bits_(other.load()) {}
+    access_meta &operator=(const access_meta &other)
+    {
+      store(other.load());
+      return *this;
+    }
+
+    std::uint32_t load() const { return bits_.load(std::memory_order_relaxed); }
+    void store(std::uint32_t bits) const { bits_.store(bits, std::memory_order_relaxed); }
+
+  private:
+    mutable std::atomic<std::uint32_t> bits_{0};
+  };
+
+  // steady_clock 기준 현재 시각 (밀리초)
+  inline std::int64_t steady_clock_ms()
+  {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  // 값과 만료 시간을 저장하는 구조체
+  struct value_entry
+  {
+    RedisValue value;
+
+    // 만료 시각 (steady_clock 기준 ms), 0이면 만료 없음.
+    // std::optional<time_point>(16 bytes) 대신 8 bytes 정수로 저장.
+    std::int64_t expiry = 0;
+
+    // maxmemory 축출(eviction) 후보를 고르기 위한 접근 정보
+    access_meta access;
+
+    bool has_expiry() const { return expiry != 0; }
+    void clear_expiry() { expiry = 0; }
+  };
+} // namespace mini_redis
+
+#endif // MINI_REDIS_VALUE_ENTRY_HPP
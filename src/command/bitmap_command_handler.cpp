@@ -0,0 +1,407 @@
+#include "command/bitmap_command_handler.hpp"
+#include "protocol/serializer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <optional>
+#include <stdexcept>
+
+namespace mini_redis
+{
+    namespace
+    {
+        std::optional<long long> parse_integer(const std::string &text)
+        {
+            long long value = 0;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (text.empty() || ec != std::errc() || end != text.data() + text.size())
+            {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        // 0 이상 bitops::max_bit_offset 이하의 bit offset
+        std::optional<std::uint64_t> parse_bit_offset(const std::string &text)
+        {
+            auto value = parse_integer(text);
+            if (!value || *value < 0 || static_cast<std::uint64_t>(*value) > bitops::max_bit_offset)
+            {
+                return std::nullopt;
+            }
+            return static_cast<std::uint64_t>(*value);
+        }
+
+        // "0" 또는 "1"
+        std::optional<bool> parse_bit(const std::string &text)
+        {
+            if (text == "0" || text == "1")
+            {
+                return text == "1";
+            }
+            return std::nullopt;
+        }
+
+        std::string upper(std::string text)
+        {
+            std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+            return text;
+        }
+
+        // BYTE|BIT 단위 옵션. 그 밖의 값이면 std::nullopt
+        std::optional<bool> parse_unit(const std::string &text)
+        {
+            const std::string unit = upper(text);
+            if (unit == "BIT" || unit == "BYTE")
+            {
+                return unit == "BIT";
+            }
+            return std::nullopt;
+        }
+
+        // BITFIELD의 타입 "i<bits>"(1~64) 또는 "u<bits>"(1~63)
+        bool parse_field_type(const std::string &text, bitfield_op &op)
+        {
+            if (text.size() < 2 || (text[0] != 'i' && text[0] != 'u' && text[0] != 'I' && text[0] != 'U'))
+            {
+                return false;
+            }
+            op.is_signed = text[0] == 'i' || text[0] == 'I';
+            auto bits = parse_integer(text.substr(1));
+            if (!bits || *bits < 1 || *bits > (op.is_signed ? 64 : 63))
+            {
+                return false;
+            }
+            op.bits = static_cast<unsigned>(*bits);
+            return true;
+        }
+
+        // BITFIELD의 offset. "#n"이면 n번째 필드 (n * bits)
+        bool parse_field_offset(const std::string &text, bitfield_op &op)
+        {
+            const bool by_field = !text.empty() && text[0] == '#';
+            auto value = parse_integer(by_field ? text.substr(1) : text);
+            if (!value || *value < 0)
+            {
+                return false;
+            }
+            const auto offset = static_cast<std::uint64_t>(*value);
+            if (by_field && offset > bitops::max_bit_offset / op.bits)
+            {
+                return false;
+            }
+            op.offset = by_field ? offset * op.bits : offset;
+            return op.offset + op.bits - 1 <= bitops::max_bit_offset;
+        }
+    } // namespace
+
+    BitmapCommandHandler::BitmapCommandHandler(std::shared_ptr<store> store) : store_(store) {}
+
+    bool BitmapCommandHandler::supports(const std::string& command_name) const {
+        std::string upper_cmd = command_name;
+        std::transform(upper_cmd.begin(), upper_cmd.end(), upper_cmd.begin(), ::toupper);
+        return upper_cmd == "SETBIT" || upper_cmd == "GETBIT" || upper_cmd == "BITCOUNT" || upper_cmd == "BITPOS" ||
+               upper_cmd == "BITOP" || upper_cmd == "BITFIELD";
+    }
+
+    std::string BitmapCommandHandler::execute(const command_t& cmd) {
+        std::string command_name = cmd[0];
+        std::transform(command_name.begin(), command_name.end(), command_name.begin(), ::toupper);
+
+        if (command_name == "SETBIT") {
+            return handle_setbit(cmd);
+        } else if (command_name == "GETBIT") {
+            return handle_getbit(cmd);
+        } else if (command_name == "BITCOUNT") {
+            return handle_bitcount(cmd);
+        } else if (command_name == "BITPOS") {
+            return handle_bitpos(cmd);
+        } else if (command_name == "BITOP") {
+            return handle_bitop(cmd);
+        } else if (command_name == "BITFIELD") {
+            return handle_bitfield(cmd);
+        }
+        return serializer::serialize_error("ERR unknown command `" + cmd[0] + "`");
+    }
+
+    // SETBIT key offset value
+    std::string BitmapCommandHandler::handle_setbit(const command_t &cmd)
+    {
+        if (cmd.size() != 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'setbit' command");
+        }
+        const auto offset = parse_bit_offset(cmd[2]);
+        if (!offset)
+        {
+            return serializer::serialize_error("ERR bit offset is not an integer or out of range");
+        }
+        const auto bit = parse_bit(cmd[3]);
+        if (!bit)
+        {
+            return serializer::serialize_error("ERR bit is not an integer or out of range");
+        }
+        try
+        {
+            return serializer::serialize_integer(store_->setbit(cmd[1], *offset, *bit) ? 1 : 0);
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // GETBIT key offset
+    std::string BitmapCommandHandler::handle_getbit(const command_t &cmd)
+    {
+        if (cmd.size() != 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'getbit' command");
+        }
+        const auto offset = parse_bit_offset(cmd[2]);
+        if (!offset)
+        {
+            return serializer::serialize_error("ERR bit offset is not an integer or out of range");
+        }
+        try
+        {
+            return serializer::serialize_integer(store_->getbit(cmd[1], *offset) ? 1 : 0);
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // BITCOUNT key [start end [BYTE|BIT]]
+    std::string BitmapCommandHandler::handle_bitcount(const command_t &cmd)
+    {
+        if (cmd.size() < 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'bitcount' command");
+        }
+        if (cmd.size() == 3 || cmd.size() > 5)
+        {
+            return serializer::serialize_error("ERR syntax error");
+        }
+        long long start = 0, end = -1;
+        bool bit_unit = false;
+        if (cmd.size() >= 4)
+        {
+            const auto parsed_start = parse_integer(cmd[2]);
+            const auto parsed_end = parse_integer(cmd[3]);
+            if (!parsed_start || !parsed_end)
+            {
+                return serializer::serialize_error("ERR value is not an integer or out of range");
+            }
+            start = *parsed_start;
+            end = *parsed_end;
+        }
+        if (cmd.size() == 5)
+        {
+            const auto unit = parse_unit(cmd[4]);
+            if (!unit)
+            {
+                return serializer::serialize_error("ERR syntax error");
+            }
+            bit_unit = *unit;
+        }
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->bitcount(cmd[1], start, end, bit_unit)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // BITPOS key bit [start [end [BYTE|BIT]]]
+    std::string BitmapCommandHandler::handle_bitpos(const command_t &cmd)
+    {
+        if (cmd.size() < 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'bitpos' command");
+        }
+        if (cmd.size() > 6)
+        {
+            return serializer::serialize_error("ERR syntax error");
+        }
+        const auto bit = parse_bit(cmd[2]);
+        if (!bit)
+        {
+            return serializer::serialize_error("ERR The bit argument must be 1 or 0.");
+        }
+        long long start = 0;
+        std::optional<long long> end;
+        bool bit_unit = false;
+        if (cmd.size() >= 4)
+        {
+            const auto parsed = parse_integer(cmd[3]);
+            if (!parsed)
+            {
+                return serializer::serialize_error("ERR value is not an integer or out of range");
+            }
+            start = *parsed;
+        }
+        if (cmd.size() >= 5)
+        {
+            end = parse_integer(cmd[4]);
+            if (!end)
+            {
+                return serializer::serialize_error("ERR value is not an integer or out of range");
+            }
+        }
+        if (cmd.size() == 6)
+        {
+            const auto unit = parse_unit(cmd[5]);
+            if (!unit)
+            {
+                return serializer::serialize_error("ERR syntax error");
+            }
+            bit_unit = *unit;
+        }
+        try
+        {
+            return serializer::serialize_integer(store_->bitpos(cmd[1], *bit, start, end, bit_unit));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // BITOP AND|OR|XOR|NOT destkey key [key ...]
+    std::string BitmapCommandHandler::handle_bitop(const command_t &cmd)
+    {
+        if (cmd.size() < 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'bitop' command");
+        }
+        const std::string name = upper(cmd[1]);
+        bitops::operation op;
+        if (name == "AND")
+        {
+            op = bitops::operation::bit_and;
+        }
+        else if (name == "OR")
+        {
+            op = bitops::operation::bit_or;
+        }
+        else if (name == "XOR")
+        {
+            op = bitops::operation::bit_xor;
+        }
+        else if (name == "NOT")
+        {
+            op = bitops::operation::bit_not;
+        }
+        else
+        {
+            return serializer::serialize_error("ERR syntax error");
+        }
+        const std::vector<std::string> keys(cmd.begin() + 3, cmd.end());
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->bitop(op, cmd[2], keys)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // BITFIELD key [GET type offset] [SET type offset value] [INCRBY type offset increment] [OVERFLOW WRAP|SAT|FAIL] ...
+    std::string BitmapCommandHandler::handle_bitfield(const command_t &cmd)
+    {
+        if (cmd.size() < 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'bitfield' command");
+        }
+        std::vector<bitfield_op> ops;
+        auto overflow = bitfield_op::overflow::wrap;
+        for (std::size_t i = 2; i < cmd.size();)
+        {
+            const std::string sub = upper(cmd[i]);
+            if (sub == "OVERFLOW" && i + 1 < cmd.size())
+            {
+                const std::string mode = upper(cmd[i + 1]);
+                if (mode == "WRAP")
+                {
+                    overflow = bitfield_op::overflow::wrap;
+                }
+                else if (mode == "SAT")
+                {
+                    overflow = bitfield_op::overflow::sat;
+                }
+                else if (mode == "FAIL")
+                {
+                    overflow = bitfield_op::overflow::fail;
+                }
+                else
+                {
+                    return serializer::serialize_error("ERR Invalid OVERFLOW type specified");
+                }
+                i += 2;
+                continue;
+            }
+
+            bitfield_op op;
+            std::size_t args;
+            if (sub == "GET")
+            {
+                op.type = bitfield_op::kind::get;
+                args = 3;
+            }
+            else if (sub == "SET")
+            {
+                op.type = bitfield_op::kind::set;
+                args = 4;
+            }
+            else if (sub == "INCRBY")
+            {
+                op.type = bitfield_op::kind::incrby;
+                args = 4;
+            }
+            else
+            {
+                return serializer::serialize_error("ERR syntax error");
+            }
+            if (i + args > cmd.size())
+            {
+                return serializer::serialize_error("ERR syntax error");
+            }
+            if (!parse_field_type(cmd[i + 1], op))
+            {
+                return serializer::serialize_error(
+                    "ERR Invalid bitfield type. Use something like i16 u8. Note that u64 is not supported but i64 is.");
+            }
+            if (!parse_field_offset(cmd[i + 2], op))
+            {
+                return serializer::serialize_error("ERR bit offset is not an integer or out of range");
+            }
+            if (args == 4)
+            {
+                const auto value = parse_integer(cmd[i + 3]);
+                if (!value)
+                {
+                    return serializer::serialize_error("ERR value is not an integer or out of range");
+                }
+                op.value = *value;
+            }
+            op.on_overflow = overflow;
+            ops.push_back(op);
+            i += args;
+        }
+
+        try
+        {
+            // 각 하위 명령의 결과는 정수, OVERFLOW FAIL로 건너뛰었으면 nil
+            return serializer::serialize_nullable_integer_array(store_->bitfield(cmd[1], ops));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+} // namespace mini_redis
@@ -1,6 +1,13 @@
 #include "command/dispatcher.hpp"
 #include "command/generic_command_handler.hpp"
 #include "command/string_command_handler.hpp"
+#include "command/list_command_handler.hpp"
+#include "command/hash_command_handler.hpp"
+#include "command/set_command_handler.hpp"
+#include "command/sorted_set_command_handler.hpp"
+#include "command/bitmap_command_handler.hpp"
+#include "command/hyperloglog_command_handler.hpp"
+#include "command/stream_command_handler.hpp"
 #include "command/pubsub_command_handler.hpp"
 #include "protocol/serializer.hpp"
 #include <algorithm>
@@ -8,10 +15,19 @@
 
 namespace mini_redis
 {
-    CommandDispatcher::CommandDispatcher(std::shared_ptr<store> store, std::shared_ptr<pubsub_manager> pubsub_manager) {
+    CommandDispatcher::CommandDispatcher(std::shared_ptr<store> store, std::shared_ptr<pubsub_manager> pubsub_manager,
+                                         std::shared_ptr<append_only_file> aof)
+        : aof_(std::move(aof)) {
         // unique_ptr를 사용하여 각 핸들러의 소유권을 명확히 하고, 핸들러가 더 이상 필요하지 않을 때 자동으로 메모리를 해제함.
-        handlers_.push_back(std::make_unique<GenericCommandHandler>(store));
+        handlers_.push_back(std::make_unique<GenericCommandHandler>(store, aof_));
         handlers_.push_back(std::make_unique<StringCommandHandler>(store));
+        handlers_.push_back(std::make_unique<ListCommandHandler>(store));
+        handlers_.push_back(std::make_unique<HashCommandHandler>(store));
+        handlers_.push_back(std::make_unique<SetCommandHandler>(store));
+        handlers_.push_back(std::make_unique<SortedSetCommandHandler>(store));
+        handlers_.push_back(std::make_unique<BitmapCommandHandler>(store));
+        handlers_.push_back(std::make_unique<HyperLogLogCommandHandler>(store));
+        handlers_.push_back(std::make_unique<StreamCommandHandler>(store));
         
         /*
          * PUB/SUB 핸들러는 다른 핸들러와 다르게 명령 처리를 위해 세션이 필요함.
@@ -57,10 +73,32 @@ namespace mini_redis
 
     for (const auto& handler : handlers_) {
             if (handler->supports(command_name)) {
-                return handler->execute(cmd);
+                if (!aof_ || !append_only_file::is_write_command(command_name)) {
+                    return handler->execute(cmd);
+                }
+                // Redis와 같이 AOF에 쓸 수 없는 동안에는 쓰기 명령을 거부
+                if (const auto error = aof_->write_error()) {
+                    return serializer::serialize_error("MISCONF Errors writing to the AOF file: " + *error);
+                }
+                // 실행과 기록을 명령의 키들의 order 잠금 안에서 하여, 같은 키에 대한 쓰기가 실행된 순서대로
+                // 기록되게 함. 다른 stripe의 키에 대한 쓰기는 서로 기다리지 않음
+                const auto order = aof_->lock_order(cmd);
+                std::string reply = handler->execute(cmd);
+                const auto seq = aof_->feed(cmd, reply);
+                if (seq != 0 && aof_->policy() == fsync_policy::always) {
+                    unsynced_write_ = seq;
+                }
+                return reply;
             }
         }
 
         return serializer::serialize_error("ERR unknown command `" + cmd[0] + "`");
     }
+
+    std::uint64_t CommandDispatcher::take_unsynced_write()
+    {
+        const auto seq = unsynced_write_;
+        unsynced_write_ = 0;
+        return seq;
+    }
 } // namespace mini_redis
@@ -2,15 +2,26 @@
 #include "protocol/serializer.hpp"
 #include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <stdexcept>
 
 namespace mini_redis
 {
-    GenericCommandHandler::GenericCommandHandler(std::shared_ptr<store> store) : store_(store) {}
+    GenericCommandHandler::GenericCommandHandler(std::shared_ptr<store> store, std::shared_ptr<append_only_file> aof)
+        : store_(store), aof_(std::move(aof)) {}
 
     bool GenericCommandHandler::supports(const std::string& command_name) const {
         std::string upper_cmd = command_name;
         std::transform(upper_cmd.begin(), upper_cmd.end(), upper_cmd.begin(), ::toupper);
-        return upper_cmd == "PING" || upper_cmd == "DEL" || upper_cmd == "KEYS";
+        return upper_cmd == "PING" || upper_cmd == "DEL" || upper_cmd == "KEYS" ||
+               upper_cmd == "SCAN" || upper_cmd == "SSCAN" || upper_cmd == "HSCAN" || upper_cmd == "ZSCAN" ||
+               upper_cmd == "EXPIRE" || upper_cmd == "PEXPIRE" || upper_cmd == "EXPIREAT" || upper_cmd == "PEXPIREAT" ||
+               upper_cmd == "TTL" || upper_cmd == "PTTL" || upper_cmd == "INFO" ||
+               upper_cmd == "SAVE" || upper_cmd == "BGSAVE" || upper_cmd == "LASTSAVE" ||
+               upper_cmd == "BGREWRITEAOF" || upper_cmd == "DUMP" || upper_cmd == "RESTORE";
     }
 
     std::string GenericCommandHandler::execute(const command_t& cmd) {
@@ -23,6 +34,32 @@ namespace mini_redis
             return handle_del(cmd);
         } else if (command_name == "KEYS") {
             return handle_keys(cmd);
+        } else if (command_name == "SCAN") {
+            return handle_scan(cmd);
+        } else if (command_name == "SSCAN" || command_name == "HSCAN" || command_name == "ZSCAN") {
+            return handle_collection_scan(cmd, command_name);
+        } else if (command_name == "EXPIRE") {
+            return handle_expire(cmd, false);
+        } else if (command_name == "PEXPIRE") {
+            return handle_expire(cmd, true);
+        } else if (command_name == "EXPIREAT") {
+            return handle_expireat(cmd, false);
+        } else if (command_name == "PEXPIREAT") {
+            return handle_expireat(cmd, true);
+        } else if (command_name == "TTL") {
+            return handle_ttl(cmd, false);
+        } else if (command_name == "PTTL") {
+            return handle_ttl(cmd, true);
+        } else if (command_name == "INFO") {
+            return handle_info(cmd);
+        } else if (command_name == "SAVE" || command_name == "BGSAVE" || command_name == "LASTSAVE") {
+            return handle_save(cmd, command_name);
+        } else if (command_name == "BGREWRITEAOF") {
+            return handle_bgrewriteaof(cmd);
+        } else if (command_name == "DUMP") {
+            return handle_dump(cmd);
+        } else if (command_name == "RESTORE") {
+            return handle_restore(cmd);
         }
         return serializer::serialize_error("ERR unknown command `" + cmd[0] + "`");
     }
@@ -59,8 +96,404 @@ namespace mini_redis
         }
 
         const std::string &pattern = cmd[1];
-        std::vector<std::string> matched_keys = store_->keys(pattern);
+        try
+        {
+            std::vector<std::string> matched_keys = store_->keys(pattern);
+            return serializer::serialize_array(matched_keys);
+        }
+        catch (const std::runtime_error &e)
+        {
+            // lazy 적재 중 (LOADING)
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    namespace
+    {
+        // SCAN 계열 명령의 cursor와 옵션
+        struct scan_args
+        {
+            std::uint64_t cursor = 0;
+            std::string pattern = "*";
+            std::size_t count = 10;
+            std::string type;
+        };
 
-        return serializer::serialize_array(matched_keys);
+        // cmd[first]부터 "cursor [MATCH pattern] [COUNT n] [TYPE t]"를 해석. 실패하면 오류 응답을 반환
+        std::optional<std::string> parse_scan_args(const command_t &cmd, std::size_t first, bool allow_type,
+                                                   scan_args &out)
+        {
+            const std::string &cursor = cmd[first];
+            auto [end, ec] = std::from_chars(cursor.data(), cursor.data() + cursor.size(), out.cursor);
+            if (cursor.empty() || ec != std::errc() || end != cursor.data() + cursor.size())
+            {
+                return serializer::serialize_error("ERR invalid cursor");
+            }
+            for (std::size_t i = first + 1; i < cmd.size(); i += 2)
+            {
+                if (i + 1 >= cmd.size())
+                {
+                    return serializer::serialize_error("ERR syntax error");
+                }
+                std::string option = cmd[i];
+                std::transform(option.begin(), option.end(), option.begin(), ::toupper);
+                const std::string &value = cmd[i + 1];
+                if (option == "MATCH")
+                {
+                    out.pattern = value;
+                }
+                else if (option == "COUNT")
+                {
+                    long long count = 0;
+                    auto [count_end, count_ec] = std::from_chars(value.data(), value.data() + value.size(), count);
+                    if (count_ec != std::errc() || count_end != value.data() + value.size())
+                    {
+                        return serializer::serialize_error("ERR value is not an integer or out of range");
+                    }
+                    if (count < 1)
+                    {
+                        return serializer::serialize_error("ERR syntax error");
+                    }
+                    out.count = static_cast<std::size_t>(count);
+                }
+                else if (option == "TYPE" && allow_type)
+                {
+                    out.type = value;
+                    std::transform(out.type.begin(), out.type.end(), out.type.begin(), ::tolower);
+                }
+                else
+                {
+                    return serializer::serialize_error("ERR syntax error");
+                }
+            }
+            return std::nullopt;
+        }
+    } // namespace
+
+    // SCAN cursor [MATCH pattern] [COUNT count] [TYPE type]
+    std::string GenericCommandHandler::handle_scan(const command_t &cmd)
+    {
+        if (cmd.size() < 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'scan' command");
+        }
+        scan_args args;
+        if (auto error = parse_scan_args(cmd, 1, true, args))
+        {
+            return *error;
+        }
+        try
+        {
+            scan_result result = store_->scan(args.cursor, args.pattern, args.count, args.type);
+            return serializer::serialize_scan_reply(result.cursor, result.items);
+        }
+        catch (const std::runtime_error &e)
+        {
+            // lazy 적재 중 (LOADING)
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // SSCAN / HSCAN / ZSCAN key cursor [MATCH pattern] [COUNT count]
+    std::string GenericCommandHandler::handle_collection_scan(const command_t &cmd, const std::string &command_name)
+    {
+        std::string lower_name = command_name;
+        std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
+        if (cmd.size() < 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for '" + lower_name + "' command");
+        }
+        scan_args args;
+        if (auto error = parse_scan_args(cmd, 2, false, args))
+        {
+            return *error;
+        }
+        try
+        {
+            scan_result result;
+            if (command_name == "SSCAN")
+            {
+                result = store_->sscan(cmd[1], args.cursor, args.pattern, args.count);
+            }
+            else if (command_name == "HSCAN")
+            {
+                result = store_->hscan(cmd[1], args.cursor, args.pattern, args.count);
+            }
+            else
+            {
+                result = store_->zscan(cmd[1], args.cursor, args.pattern, args.count);
+            }
+            return serializer::serialize_scan_reply(result.cursor, result.items);
+        }
+        catch (const std::runtime_error &e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // EXPIRE key seconds / PEXPIRE key milliseconds
+    std::string GenericCommandHandler::handle_expire(const command_t &cmd, bool milliseconds)
+    {
+        if (cmd.size() != 3)
+        {
+            return serializer::serialize_error(std::string("ERR wrong number of arguments for '") +
+                                               (milliseconds ? "pexpire" : "expire") + "' command");
+        }
+        const std::string &key = cmd[1];
+        long long timeout;
+        try {
+            timeout = std::stoll(cmd[2]);
+        } catch (const std::invalid_argument&) {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        } catch (const std::out_of_range&) {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        }
+
+        // Redis와 같이 0 이하의 만료 시간은 키를 바로 삭제
+        if (timeout <= 0)
+        {
+            return serializer::serialize_integer(store_->del(key));
+        }
+        // steady_clock 시각에 더해도 넘치지 않도록 제한
+        if (timeout > std::numeric_limits<long long>::max() / 1000)
+        {
+            return serializer::serialize_error(std::string("ERR invalid expire time in '") +
+                                               (milliseconds ? "pexpire" : "expire") + "' command");
+        }
+        const long long ms = milliseconds ? timeout : timeout * 1000;
+        return serializer::serialize_integer(store_->pexpire(key, ms) ? 1 : 0);
+    }
+
+    // EXPIREAT key unix-seconds / PEXPIREAT key unix-milliseconds (AOF가 상대 만료 시간을 이 형태로 기록함)
+    std::string GenericCommandHandler::handle_expireat(const command_t &cmd, bool milliseconds)
+    {
+        if (cmd.size() != 3)
+        {
+            return serializer::serialize_error(std::string("ERR wrong number of arguments for '") +
+                                               (milliseconds ? "pexpireat" : "expireat") + "' command");
+        }
+        long long when;
+        try {
+            when = std::stoll(cmd[2]);
+        } catch (const std::invalid_argument&) {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        } catch (const std::out_of_range&) {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        }
+        if (!milliseconds && (when > std::numeric_limits<long long>::max() / 1000 ||
+                              when < std::numeric_limits<long long>::min() / 1000))
+        {
+            return serializer::serialize_error("ERR invalid expire time in 'expireat' command");
+        }
+        const long long at_ms = milliseconds ? when : when * 1000;
+        const long long now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch()).count();
+        // 이미 지난 시각이면 키를 바로 삭제
+        if (at_ms <= now_ms)
+        {
+            return serializer::serialize_integer(store_->del(cmd[1]));
+        }
+        return serializer::serialize_integer(store_->pexpire(cmd[1], at_ms - now_ms) ? 1 : 0);
+    }
+
+    // TTL key / PTTL key: -2 (키 없음), -1 (만료 시간 없음), 그 외 남은 시간
+    std::string GenericCommandHandler::handle_ttl(const command_t &cmd, bool milliseconds)
+    {
+        if (cmd.size() != 2)
+        {
+            return serializer::serialize_error(std::string("ERR wrong number of arguments for '") +
+                                               (milliseconds ? "pttl" : "ttl") + "' command");
+        }
+        const std::string &key = cmd[1];
+        const long long remaining = milliseconds ? store_->pttl(key) : store_->ttl(key);
+        return serializer::serialize_integer(remaining);
+    }
+    // INFO [section]: Redis와 같은 "key:value" 줄 형식. 지원하는 섹션은 memory, stats, keyspace
+    // SAVE / BGSAVE / LASTSAVE
+    std::string GenericCommandHandler::handle_save(const command_t &cmd, const std::string &command_name)
+    {
+        if (cmd.size() != 1)
+        {
+            std::string lower = command_name;
+            std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+            return serializer::serialize_error("ERR wrong number of arguments for '" + lower + "' command");
+        }
+        if (command_name == "LASTSAVE")
+        {
+            return serializer::serialize_integer(store_->persistence().last_save_time);
+        }
+        try
+        {
+            if (command_name == "SAVE")
+            {
+                store_->save();
+                return serializer::serialize_ok();
+            }
+            store_->bgsave();
+            return "+Background saving started\r\n";
+        }
+        catch (const std::runtime_error &e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // BGREWRITEAOF: 자식 프로세스가 현재 키 공간으로 AOF를 새로 쓰고, 그동안의 쓰기는 끝난 뒤 이어 붙임
+    std::string GenericCommandHandler::handle_bgrewriteaof(const command_t &cmd)
+    {
+        if (cmd.size() != 1)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'bgrewriteaof' command");
+        }
+        if (!aof_)
+        {
+            return serializer::serialize_error("ERR Append only file is disabled (persistence.appendonly)");
+        }
+        try
+        {
+            store_->bgrewriteaof(*aof_);
+            return "+Background append only file rewriting started\r\n";
+        }
+        catch (const std::runtime_error &e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // DUMP key: 값을 스냅샷 형식으로 직렬화한 payload (키가 없으면 null)
+    std::string GenericCommandHandler::handle_dump(const command_t &cmd)
+    {
+        if (cmd.size() != 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'dump' command");
+        }
+        const auto payload = store_->dump(cmd[1]);
+        return payload ? serializer::serialize_bulk_string(*payload) : serializer::serialize_null_bulk_string();
+    }
+
+    // RESTORE key ttl payload [REPLACE] [ABSTTL]: ttl은 밀리초 (0이면 만료 없음, ABSTTL이면 unix 시각)
+    std::string GenericCommandHandler::handle_restore(const command_t &cmd)
+    {
+        if (cmd.size() < 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'restore' command");
+        }
+        bool replace = false;
+        bool absolute = false;
+        for (std::size_t i = 4; i < cmd.size(); ++i)
+        {
+            std::string option = cmd[i];
+            std::transform(option.begin(), option.end(), option.begin(), ::toupper);
+            if (option == "REPLACE")
+            {
+                replace = true;
+            }
+            else if (option == "ABSTTL")
+            {
+                absolute = true;
+            }
+            else
+            {
+                return serializer::serialize_error("ERR syntax error");
+            }
+        }
+        long long ttl;
+        try {
+            ttl = std::stoll(cmd[2]);
+        } catch (const std::invalid_argument&) {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        } catch (const std::out_of_range&) {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        }
+        try
+        {
+            store_->restore(cmd[1], ttl, absolute, cmd[3], replace);
+            return serializer::serialize_ok();
+        }
+        catch (const std::runtime_error &e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    std::string GenericCommandHandler::handle_info(const command_t &cmd)
+    {
+        if (cmd.size() > 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'info' command");
+        }
+        std::string section = cmd.size() == 2 ? cmd[1] : "all";
+        std::transform(section.begin(), section.end(), section.begin(), ::tolower);
+        const bool all = section == "all" || section == "default" || section == "everything";
+
+        std::string info;
+        if (all || section == "memory")
+        {
+            info += "# Memory\r\n";
+            info += "used_memory:" + std::to_string(store_->memory_usage()) + "\r\n";
+            info += "used_memory_dataset:" + std::to_string(store_->dataset_memory()) + "\r\n";
+            info += "maxmemory:" + std::to_string(store_->maxmemory()) + "\r\n";
+            const auto slabs = store_->allocator_stats();
+            info += "allocator_slabs:" + std::to_string(slabs.slabs) + "\r\n";
+            info += "allocator_slab_bytes:" + std::to_string(slabs.slab_bytes()) + "\r\n";
+            info += "allocator_live_bytes:" + std::to_string(slabs.live_bytes) + "\r\n";
+            info += "allocator_frag_ratio:" +
+                    std::to_string(slabs.live_bytes ? static_cast<double>(slabs.slab_bytes()) / slabs.live_bytes : 1.0) +
+                    "\r\n";
+            info += std::string("maxmemory_policy:") + eviction_policy_name(store_->maxmemory_policy()) + "\r\n";
+        }
+        if (all || section == "persistence")
+        {
+            if (!info.empty()) info += "\r\n";
+            const auto status = store_->persistence();
+            info += "# Persistence\r\n";
+            info += "loading:" + std::to_string(status.loading ? 1 : 0) + "\r\n";
+            if (status.loading)
+            {
+                // persistence.lazy_load: 백그라운드 적재의 진행 상황과, 그보다 먼저 접근되어 읽은 키 수
+                info += "loading_total_bytes:" + std::to_string(status.loading_total_bytes) + "\r\n";
+                info += "loading_loaded_bytes:" + std::to_string(status.loading_loaded_bytes) + "\r\n";
+                info += "loading_loaded_perc:" +
+                        std::to_string(status.loading_total_bytes
+                                           ? 100.0 * status.loading_loaded_bytes / status.loading_total_bytes
+                                           : 100.0) +
+                        "\r\n";
+                info += "loading_faulted_keys:" + std::to_string(status.loading_faulted_keys) + "\r\n";
+            }
+            if (!status.loading_error.empty())
+            {
+                info += "loading_error:" + status.loading_error + "\r\n";
+            }
+            info += "rdb_bgsave_in_progress:" + std::to_string(status.bgsave_in_progress ? 1 : 0) + "\r\n";
+            info += "rdb_last_save_time:" + std::to_string(status.last_save_time) + "\r\n";
+            info += std::string("rdb_last_bgsave_status:") + (status.last_bgsave_ok ? "ok" : "err") + "\r\n";
+            info += "aof_enabled:" + std::to_string(aof_ ? 1 : 0) + "\r\n";
+            if (aof_)
+            {
+                info += std::string("aof_fsync:") + fsync_policy_name(aof_->policy()) + "\r\n";
+                info += "aof_current_size:" + std::to_string(aof_->size()) + "\r\n";
+                info += std::string("aof_last_write_status:") + (aof_->write_error() ? "err" : "ok") + "\r\n";
+                info += "aof_base_size:" + std::to_string(aof_->base_size()) + "\r\n";
+                info += "aof_rewrite_in_progress:" + std::to_string(aof_->rewrite_in_progress() ? 1 : 0) + "\r\n";
+                info += std::string("aof_last_bgrewrite_status:") +
+                        (status.last_aof_rewrite_ok && aof_->last_rewrite_ok() ? "ok" : "err") + "\r\n";
+                info += "aof_last_rewrite_pause_us:" + std::to_string(aof_->last_rewrite_pause().count()) + "\r\n";
+            }
+        }
+        if (all || section == "stats")
+        {
+            if (!info.empty()) info += "\r\n";
+            info += "# Stats\r\n";
+            info += "expired_keys:" + std::to_string(store_->expired_keys()) + "\r\n";
+            info += "evicted_keys:" + std::to_string(store_->evicted_keys()) + "\r\n";
+            info += "expired_stale_perc:" + std::to_string(store_->expired_stale_ratio() * 100) + "\r\n";
+        }
+        if (all || section == "keyspace")
+        {
+            if (!info.empty()) info += "\r\n";
+            info += "# Keyspace\r\n";
+            info += "db0:keys=" + std::to_string(store_->dbsize()) + "\r\n";
+        }
+        return serializer::serialize_bulk_string(info);
     }
 } // namespace mini_redis
@@ -0,0 +1,174 @@
+#include "command/hash_command_handler.hpp"
+#include "protocol/serializer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+
+namespace mini_redis
+{
+    HashCommandHandler::HashCommandHandler(std::shared_ptr<store> store) : store_(store) {}
+
+    bool HashCommandHandler::supports(const std::string& command_name) const {
+        std::string upper_cmd = command_name;
+        std::transform(upper_cmd.begin(), upper_cmd.end(), upper_cmd.begin(), ::toupper);
+        return upper_cmd == "HSET" || upper_cmd == "HGET" || upper_cmd == "HMGET" || upper_cmd == "HGETALL" ||
+               upper_cmd == "HDEL" || upper_cmd == "HINCRBY" || upper_cmd == "HLEN";
+    }
+
+    std::string HashCommandHandler::execute(const command_t& cmd) {
+        std::string command_name = cmd[0];
+        std::transform(command_name.begin(), command_name.end(), command_name.begin(), ::toupper);
+
+        if (command_name == "HSET") {
+            return handle_hset(cmd);
+        } else if (command_name == "HGET") {
+            return handle_hget(cmd);
+        } else if (command_name == "HMGET") {
+            return handle_hmget(cmd);
+        } else if (command_name == "HGETALL") {
+            return handle_hgetall(cmd);
+        } else if (command_name == "HDEL") {
+            return handle_hdel(cmd);
+        } else if (command_name == "HINCRBY") {
+            return handle_hincrby(cmd);
+        } else if (command_name == "HLEN") {
+            return handle_hlen(cmd);
+        }
+        return serializer::serialize_error("ERR unknown command `" + cmd[0] + "`");
+    }
+
+    // HSET key field value [field value ...]
+    std::string HashCommandHandler::handle_hset(const command_t &cmd)
+    {
+        if (cmd.size() < 4 || cmd.size() % 2 != 0)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'hset' command");
+        }
+        std::vector<std::pair<std::string, std::string>> fields;
+        fields.reserve((cmd.size() - 2) / 2);
+        for (std::size_t i = 2; i < cmd.size(); i += 2)
+        {
+            fields.emplace_back(cmd[i], cmd[i + 1]);
+        }
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->hset(cmd[1], fields)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // HGET key field
+    std::string HashCommandHandler::handle_hget(const command_t &cmd)
+    {
+        if (cmd.size() != 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'hget' command");
+        }
+        try
+        {
+            return serializer::serialize_bulk_string(store_->hget(cmd[1], cmd[2]));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // HMGET key field [field ...]
+    std::string HashCommandHandler::handle_hmget(const command_t &cmd)
+    {
+        if (cmd.size() < 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'hmget' command");
+        }
+        const std::vector<std::string> fields(cmd.begin() + 2, cmd.end());
+        try
+        {
+            return serializer::serialize_nullable_array(store_->hmget(cmd[1], fields));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // HGETALL key
+    std::string HashCommandHandler::handle_hgetall(const command_t &cmd)
+    {
+        if (cmd.size() != 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'hgetall' command");
+        }
+        try
+        {
+            return serializer::serialize_array(store_->hgetall(cmd[1]));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // HDEL key field [field ...]
+    std::string HashCommandHandler::handle_hdel(const command_t &cmd)
+    {
+        if (cmd.size() < 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'hdel' command");
+        }
+        const std::vector<std::string> fields(cmd.begin() + 2, cmd.end());
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->hdel(cmd[1], fields)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // HINCRBY key field increment
+    std::string HashCommandHandler::handle_hincrby(const command_t &cmd)
+    {
+        if (cmd.size() != 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'hincrby' command");
+        }
+        const std::string &text = cmd[3];
+        long long increment = 0;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), increment);
+        if (text.empty() || ec != std::errc() || end != text.data() + text.size())
+        {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        }
+        try
+        {
+            return serializer::serialize_integer(store_->hincrby(cmd[1], cmd[2], increment));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // HLEN key
+    std::string HashCommandHandler::handle_hlen(const command_t &cmd)
+    {
+        if (cmd.size() != 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'hlen' command");
+        }
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->hlen(cmd[1])));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+} // namespace mini_redis
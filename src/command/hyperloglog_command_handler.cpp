@@ -0,0 +1,85 @@
+#include "command/hyperloglog_command_handler.hpp"
+#include "protocol/serializer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace mini_redis
+{
+    HyperLogLogCommandHandler::HyperLogLogCommandHandler(std::shared_ptr<store> store) : store_(store) {}
+
+    bool HyperLogLogCommandHandler::supports(const std::string& command_name) const {
+        std::string upper_cmd = command_name;
+        std::transform(upper_cmd.begin(), upper_cmd.end(), upper_cmd.begin(), ::toupper);
+        return upper_cmd == "PFADD" || upper_cmd == "PFCOUNT" || upper_cmd == "PFMERGE";
+    }
+
+    std::string HyperLogLogCommandHandler::execute(const command_t& cmd) {
+        std::string command_name = cmd[0];
+        std::transform(command_name.begin(), command_name.end(), command_name.begin(), ::toupper);
+
+        if (command_name == "PFADD") {
+            return handle_pfadd(cmd);
+        } else if (command_name == "PFCOUNT") {
+            return handle_pfcount(cmd);
+        } else if (command_name == "PFMERGE") {
+            return handle_pfmerge(cmd);
+        }
+        return serializer::serialize_error("ERR unknown command `" + cmd[0] + "`");
+    }
+
+    // PFADD key [element ...]
+    std::string HyperLogLogCommandHandler::handle_pfadd(const command_t &cmd)
+    {
+        if (cmd.size() < 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'pfadd' command");
+        }
+        const std::vector<std::string> elements(cmd.begin() + 2, cmd.end());
+        try
+        {
+            return serializer::serialize_integer(store_->pfadd(cmd[1], elements) ? 1 : 0);
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // PFCOUNT key [key ...]
+    std::string HyperLogLogCommandHandler::handle_pfcount(const command_t &cmd)
+    {
+        if (cmd.size() < 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'pfcount' command");
+        }
+        const std::vector<std::string> keys(cmd.begin() + 1, cmd.end());
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->pfcount(keys)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // PFMERGE destkey [sourcekey ...]
+    std::string HyperLogLogCommandHandler::handle_pfmerge(const command_t &cmd)
+    {
+        if (cmd.size() < 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'pfmerge' command");
+        }
+        const std::vector<std::string> sources(cmd.begin() + 2, cmd.end());
+        try
+        {
+            store_->pfmerge(cmd[1], sources);
+            return serializer::serialize_ok();
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+} // namespace mini_redis
@@ -0,0 +1,201 @@
+#include "command/list_command_handler.hpp"
+#include "protocol/serializer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <optional>
+#include <stdexcept>
+
+namespace mini_redis
+{
+    namespace
+    {
+        std::optional<long long> parse_integer(const std::string &text)
+        {
+            long long value = 0;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (text.empty() || ec != std::errc() || end != text.data() + text.size())
+            {
+                return std::nullopt;
+            }
+            return value;
+        }
+    } // namespace
+
+    ListCommandHandler::ListCommandHandler(std::shared_ptr<store> store) : store_(store) {}
+
+    bool ListCommandHandler::supports(const std::string& command_name) const {
+        std::string upper_cmd = command_name;
+        std::transform(upper_cmd.begin(), upper_cmd.end(), upper_cmd.begin(), ::toupper);
+        return upper_cmd == "LPUSH" || upper_cmd == "RPUSH" || upper_cmd == "LPOP" || upper_cmd == "RPOP" ||
+               upper_cmd == "LRANGE" || upper_cmd == "LLEN" || upper_cmd == "LINDEX" || upper_cmd == "LTRIM";
+    }
+
+    std::string ListCommandHandler::execute(const command_t& cmd) {
+        std::string command_name = cmd[0];
+        std::transform(command_name.begin(), command_name.end(), command_name.begin(), ::toupper);
+
+        if (command_name == "LPUSH") {
+            return handle_push(cmd, true);
+        } else if (command_name == "RPUSH") {
+            return handle_push(cmd, false);
+        } else if (command_name == "LPOP") {
+            return handle_pop(cmd, true);
+        } else if (command_name == "RPOP") {
+            return handle_pop(cmd, false);
+        } else if (command_name == "LRANGE") {
+            return handle_lrange(cmd);
+        } else if (command_name == "LLEN") {
+            return handle_llen(cmd);
+        } else if (command_name == "LINDEX") {
+            return handle_lindex(cmd);
+        } else if (command_name == "LTRIM") {
+            return handle_ltrim(cmd);
+        }
+        return serializer::serialize_error("ERR unknown command `" + cmd[0] + "`");
+    }
+
+    // LPUSH / RPUSH key element [element ...]
+    std::string ListCommandHandler::handle_push(const command_t &cmd, bool front)
+    {
+        if (cmd.size() < 3)
+        {
+            return serializer::serialize_error(std::string("ERR wrong number of arguments for '") +
+                                               (front ? "lpush" : "rpush") + "' command");
+        }
+        const std::vector<std::string> values(cmd.begin() + 2, cmd.end());
+        try
+        {
+            const std::size_t length = front ? store_->lpush(cmd[1], values) : store_->rpush(cmd[1], values);
+            return serializer::serialize_integer(static_cast<std::int64_t>(length));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // LPOP / RPOP key [count]
+    // count가 없으면 원소 하나(또는 nil), 있으면 배열(키가 없으면 null 배열)로 응답
+    std::string ListCommandHandler::handle_pop(const command_t &cmd, bool front)
+    {
+        if (cmd.size() != 2 && cmd.size() != 3)
+        {
+            return serializer::serialize_error(std::string("ERR wrong number of arguments for '") +
+                                               (front ? "lpop" : "rpop") + "' command");
+        }
+        std::size_t count = 1;
+        if (cmd.size() == 3)
+        {
+            auto parsed = parse_integer(cmd[2]);
+            if (!parsed || *parsed < 0)
+            {
+                return serializer::serialize_error("ERR value is out of range, must be positive");
+            }
+            count = static_cast<std::size_t>(*parsed);
+        }
+        try
+        {
+            auto popped = front ? store_->lpop(cmd[1], count) : store_->rpop(cmd[1], count);
+            if (cmd.size() == 3)
+            {
+                return popped ? serializer::serialize_array(*popped) : serializer::serialize_null_array();
+            }
+            if (!popped || popped->empty())
+            {
+                return serializer::serialize_null_bulk_string();
+            }
+            return serializer::serialize_bulk_string(popped->front());
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // LRANGE key start stop
+    std::string ListCommandHandler::handle_lrange(const command_t &cmd)
+    {
+        if (cmd.size() != 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'lrange' command");
+        }
+        auto start = parse_integer(cmd[2]);
+        auto stop = parse_integer(cmd[3]);
+        if (!start || !stop)
+        {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        }
+        try
+        {
+            return serializer::serialize_array(store_->lrange(cmd[1], *start, *stop));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // LLEN key
+    std::string ListCommandHandler::handle_llen(const command_t &cmd)
+    {
+        if (cmd.size() != 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'llen' command");
+        }
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->llen(cmd[1])));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // LINDEX key index
+    std::string ListCommandHandler::handle_lindex(const command_t &cmd)
+    {
+        if (cmd.size() != 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'lindex' command");
+        }
+        auto index = parse_integer(cmd[2]);
+        if (!index)
+        {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        }
+        try
+        {
+            return serializer::serialize_bulk_string(store_->lindex(cmd[1], *index));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // LTRIM key start stop
+    std::string ListCommandHandler::handle_ltrim(const command_t &cmd)
+    {
+        if (cmd.size() != 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'ltrim' command");
+        }
+        auto start = parse_integer(cmd[2]);
+        auto stop = parse_integer(cmd[3]);
+        if (!start || !stop)
+        {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        }
+        try
+        {
+            store_->ltrim(cmd[1], *start, *stop);
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+        return serializer::serialize_ok();
+    }
+} // namespace mini_redis
@@ -0,0 +1,152 @@
+#include "command/set_command_handler.hpp"
+#include "protocol/serializer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace mini_redis
+{
+    SetCommandHandler::SetCommandHandler(std::shared_ptr<store> store) : store_(store) {}
+
+    bool SetCommandHandler::supports(const std::string& command_name) const {
+        std::string upper_cmd = command_name;
+        std::transform(upper_cmd.begin(), upper_cmd.end(), upper_cmd.begin(), ::toupper);
+        return upper_cmd == "SADD" || upper_cmd == "SREM" || upper_cmd == "SISMEMBER" || upper_cmd == "SMEMBERS" ||
+               upper_cmd == "SCARD" || upper_cmd == "SINTER" || upper_cmd == "SUNION" || upper_cmd == "SDIFF";
+    }
+
+    std::string SetCommandHandler::execute(const command_t& cmd) {
+        std::string command_name = cmd[0];
+        std::transform(command_name.begin(), command_name.end(), command_name.begin(), ::toupper);
+
+        if (command_name == "SADD") {
+            return handle_sadd(cmd);
+        } else if (command_name == "SREM") {
+            return handle_srem(cmd);
+        } else if (command_name == "SISMEMBER") {
+            return handle_sismember(cmd);
+        } else if (command_name == "SMEMBERS") {
+            return handle_smembers(cmd);
+        } else if (command_name == "SCARD") {
+            return handle_scard(cmd);
+        } else if (command_name == "SINTER" || command_name == "SUNION" || command_name == "SDIFF") {
+            return handle_algebra(cmd, command_name);
+        }
+        return serializer::serialize_error("ERR unknown command `" + cmd[0] + "`");
+    }
+
+    // SADD key member [member ...]
+    std::string SetCommandHandler::handle_sadd(const command_t &cmd)
+    {
+        if (cmd.size() < 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'sadd' command");
+        }
+        const std::vector<std::string> members(cmd.begin() + 2, cmd.end());
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->sadd(cmd[1], members)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // SREM key member [member ...]
+    std::string SetCommandHandler::handle_srem(const command_t &cmd)
+    {
+        if (cmd.size() < 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'srem' command");
+        }
+        const std::vector<std::string> members(cmd.begin() + 2, cmd.end());
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->srem(cmd[1], members)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // SISMEMBER key member
+    std::string SetCommandHandler::handle_sismember(const command_t &cmd)
+    {
+        if (cmd.size() != 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'sismember' command");
+        }
+        try
+        {
+            return serializer::serialize_integer(store_->sismember(cmd[1], cmd[2]) ? 1 : 0);
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // SMEMBERS key
+    std::string SetCommandHandler::handle_smembers(const command_t &cmd)
+    {
+        if (cmd.size() != 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'smembers' command");
+        }
+        try
+        {
+            return serializer::serialize_array(store_->smembers(cmd[1]));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // SCARD key
+    std::string SetCommandHandler::handle_scard(const command_t &cmd)
+    {
+        if (cmd.size() != 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'scard' command");
+        }
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->scard(cmd[1])));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // SINTER|SUNION|SDIFF key [key ...]
+    std::string SetCommandHandler::handle_algebra(const command_t &cmd, const std::string &command_name)
+    {
+        if (cmd.size() < 2)
+        {
+            std::string lower = command_name;
+            std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+            return serializer::serialize_error("ERR wrong number of arguments for '" + lower + "' command");
+        }
+        const std::vector<std::string> keys(cmd.begin() + 1, cmd.end());
+        try
+        {
+            if (command_name == "SINTER")
+            {
+                return serializer::serialize_array(store_->sinter(keys));
+            }
+            if (command_name == "SUNION")
+            {
+                return serializer::serialize_array(store_->sunion(keys));
+            }
+            return serializer::serialize_array(store_->sdiff(keys));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+} // namespace mini_redis
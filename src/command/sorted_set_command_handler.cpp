@@ -0,0 +1,489 @@
+#include "command/sorted_set_command_handler.hpp"
+#include "protocol/serializer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+namespace mini_redis
+{
+    namespace
+    {
+        std::optional<long long> parse_integer(const std::string &text)
+        {
+            long long value = 0;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (text.empty() || ec != std::errc() || end != text.data() + text.size())
+            {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        // 점수 파싱. "inf", "-inf"를 허용하고 공백, 남는 문자, NaN은 거부
+        std::optional<double> parse_score(const char *text, std::size_t size)
+        {
+            if (size == 0 || std::isspace(static_cast<unsigned char>(text[0])))
+            {
+                return std::nullopt;
+            }
+            const std::string owned(text, size);
+            char *end = nullptr;
+            const double value = std::strtod(owned.c_str(), &end);
+            if (end != owned.c_str() + owned.size() || std::isnan(value))
+            {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        std::optional<double> parse_score(const std::string &text)
+        {
+            return parse_score(text.data(), text.size());
+        }
+
+        // "(1.5"는 1.5를 제외하는 경계
+        bool parse_score_bound(const std::string &text, double &value, bool &exclusive)
+        {
+            exclusive = !text.empty() && text[0] == '(';
+            const auto parsed = exclusive ? parse_score(text.data() + 1, text.size() - 1) : parse_score(text);
+            if (!parsed)
+            {
+                return false;
+            }
+            value = *parsed;
+            return true;
+        }
+
+        // "-"/"+"는 무한, "[a"는 a 포함, "(a"는 a 제외. 반대쪽 무한("+"인 min 등)은 empty로 알림
+        bool parse_lex_bound(const std::string &text, bool is_min, std::string &value, bool &exclusive,
+                             bool &unbounded, bool &empty)
+        {
+            if (text == "-" || text == "+")
+            {
+                unbounded = true;
+                empty = empty || (text == "+") == is_min;
+                return true;
+            }
+            if (text.empty() || (text[0] != '[' && text[0] != '('))
+            {
+                return false;
+            }
+            unbounded = false;
+            exclusive = text[0] == '(';
+            value = text.substr(1);
+            return true;
+        }
+
+        std::string upper(std::string text)
+        {
+            std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+            return text;
+        }
+
+        std::string serialize_entries(const sorted_set::entries &entries, bool with_scores)
+        {
+            std::vector<std::string> values;
+            values.reserve(entries.size() * (with_scores ? 2 : 1));
+            for (const auto &[member, score] : entries)
+            {
+                values.push_back(member);
+                if (with_scores)
+                {
+                    values.push_back(format_score(score));
+                }
+            }
+            return serializer::serialize_array(values);
+        }
+    } // namespace
+
+    SortedSetCommandHandler::SortedSetCommandHandler(std::shared_ptr<store> store) : store_(store) {}
+
+    bool SortedSetCommandHandler::supports(const std::string& command_name) const {
+        std::string upper_cmd = command_name;
+        std::transform(upper_cmd.begin(), upper_cmd.end(), upper_cmd.begin(), ::toupper);
+        return upper_cmd == "ZADD" || upper_cmd == "ZINCRBY" || upper_cmd == "ZSCORE" || upper_cmd == "ZRANK" ||
+               upper_cmd == "ZREVRANK" || upper_cmd == "ZRANGE" || upper_cmd == "ZRANGEBYSCORE" ||
+               upper_cmd == "ZRANGEBYLEX" || upper_cmd == "ZREM" || upper_cmd == "ZCARD";
+    }
+
+    std::string SortedSetCommandHandler::execute(const command_t& cmd) {
+        std::string command_name = cmd[0];
+        std::transform(command_name.begin(), command_name.end(), command_name.begin(), ::toupper);
+
+        if (command_name == "ZADD") {
+            return handle_zadd(cmd);
+        } else if (command_name == "ZINCRBY") {
+            return handle_zincrby(cmd);
+        } else if (command_name == "ZSCORE") {
+            return handle_zscore(cmd);
+        } else if (command_name == "ZRANK") {
+            return handle_zrank(cmd, false);
+        } else if (command_name == "ZREVRANK") {
+            return handle_zrank(cmd, true);
+        } else if (command_name == "ZRANGE") {
+            return handle_zrange(cmd);
+        } else if (command_name == "ZRANGEBYSCORE") {
+            return handle_zrange_by(cmd, range_query::kind::score);
+        } else if (command_name == "ZRANGEBYLEX") {
+            return handle_zrange_by(cmd, range_query::kind::lex);
+        } else if (command_name == "ZREM") {
+            return handle_zrem(cmd);
+        } else if (command_name == "ZCARD") {
+            return handle_zcard(cmd);
+        }
+        return serializer::serialize_error("ERR unknown command `" + cmd[0] + "`");
+    }
+
+    // ZADD key [NX|XX] [GT|LT] [CH] [INCR] score member [score member ...]
+    std::string SortedSetCommandHandler::handle_zadd(const command_t &cmd)
+    {
+        if (cmd.size() < 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'zadd' command");
+        }
+        zadd_flags flags;
+        bool incr = false;
+        std::size_t i = 2;
+        for (; i < cmd.size(); ++i)
+        {
+            const std::string option = upper(cmd[i]);
+            if (option == "NX")
+            {
+                flags.nx = true;
+            }
+            else if (option == "XX")
+            {
+                flags.xx = true;
+            }
+            else if (option == "GT")
+            {
+                flags.gt = true;
+            }
+            else if (option == "LT")
+            {
+                flags.lt = true;
+            }
+            else if (option == "CH")
+            {
+                flags.ch = true;
+            }
+            else if (option == "INCR")
+            {
+                incr = true;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        const std::size_t pairs = cmd.size() - i;
+        if (pairs == 0 || pairs % 2 != 0)
+        {
+            return serializer::serialize_error("ERR syntax error");
+        }
+        if (flags.nx && flags.xx)
+        {
+            return serializer::serialize_error("ERR XX and NX options at the same time are not compatible");
+        }
+        if ((flags.gt && flags.lt) || (flags.nx && (flags.gt || flags.lt)))
+        {
+            return serializer::serialize_error("ERR GT, LT, and/or NX options at the same time are not compatible");
+        }
+        if (incr && pairs != 2)
+        {
+            return serializer::serialize_error("ERR INCR option supports a single increment-element pair");
+        }
+
+        // 하나라도 잘못된 점수가 있으면 아무것도 반영하지 않음
+        std::vector<std::pair<double, std::string>> members;
+        members.reserve(pairs / 2);
+        for (; i < cmd.size(); i += 2)
+        {
+            const auto score = parse_score(cmd[i]);
+            if (!score)
+            {
+                return serializer::serialize_error("ERR value is not a valid float");
+            }
+            members.emplace_back(*score, cmd[i + 1]);
+        }
+
+        try
+        {
+            if (incr)
+            {
+                // NX/XX/GT/LT 조건으로 갱신하지 않았으면 nil
+                const auto result = store_->zadd_incr(cmd[1], members[0].first, members[0].second, flags);
+                return result ? serializer::serialize_bulk_string(format_score(*result))
+                              : serializer::serialize_null_bulk_string();
+            }
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->zadd(cmd[1], members, flags)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // ZINCRBY key increment member
+    std::string SortedSetCommandHandler::handle_zincrby(const command_t &cmd)
+    {
+        if (cmd.size() != 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'zincrby' command");
+        }
+        const auto increment = parse_score(cmd[2]);
+        if (!increment)
+        {
+            return serializer::serialize_error("ERR value is not a valid float");
+        }
+        try
+        {
+            return serializer::serialize_bulk_string(format_score(store_->zincrby(cmd[1], *increment, cmd[3])));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // ZSCORE key member
+    std::string SortedSetCommandHandler::handle_zscore(const command_t &cmd)
+    {
+        if (cmd.size() != 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'zscore' command");
+        }
+        try
+        {
+            const auto score = store_->zscore(cmd[1], cmd[2]);
+            return score ? serializer::serialize_bulk_string(format_score(*score))
+                         : serializer::serialize_null_bulk_string();
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // ZRANK|ZREVRANK key member
+    std::string SortedSetCommandHandler::handle_zrank(const command_t &cmd, bool reverse)
+    {
+        if (cmd.size() != 3)
+        {
+            return serializer::serialize_error(std::string("ERR wrong number of arguments for '") +
+                                               (reverse ? "zrevrank" : "zrank") + "' command");
+        }
+        try
+        {
+            const auto rank = store_->zrank(cmd[1], cmd[2], reverse);
+            return rank ? serializer::serialize_integer(static_cast<std::int64_t>(*rank))
+                        : serializer::serialize_null_bulk_string();
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // ZRANGE key start stop [BYSCORE|BYLEX] [REV] [LIMIT offset count] [WITHSCORES]
+    std::string SortedSetCommandHandler::handle_zrange(const command_t &cmd)
+    {
+        if (cmd.size() < 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'zrange' command");
+        }
+        range_query query;
+        for (std::size_t i = 4; i < cmd.size(); ++i)
+        {
+            const std::string option = upper(cmd[i]);
+            if (option == "BYSCORE")
+            {
+                query.by = range_query::kind::score;
+            }
+            else if (option == "BYLEX")
+            {
+                query.by = range_query::kind::lex;
+            }
+            else if (option == "REV")
+            {
+                query.reverse = true;
+            }
+            else if (option == "WITHSCORES")
+            {
+                query.with_scores = true;
+            }
+            else if (option == "LIMIT" && i + 2 < cmd.size())
+            {
+                const auto offset = parse_integer(cmd[i + 1]);
+                const auto count = parse_integer(cmd[i + 2]);
+                if (!offset || !count)
+                {
+                    return serializer::serialize_error("ERR value is not an integer or out of range");
+                }
+                query.has_limit = true;
+                query.offset = *offset;
+                query.count = *count;
+                i += 2;
+            }
+            else
+            {
+                return serializer::serialize_error("ERR syntax error");
+            }
+        }
+        if (query.has_limit && query.by == range_query::kind::rank)
+        {
+            return serializer::serialize_error(
+                "ERR syntax error, LIMIT is only supported in combination with either BYSCORE or BYLEX");
+        }
+        if (query.with_scores && query.by == range_query::kind::lex)
+        {
+            return serializer::serialize_error("ERR syntax error, WITHSCORES not supported in combination with BYLEX");
+        }
+        // REV와 함께 쓰면 BYSCORE/BYLEX의 인자는 max min 순서
+        const bool swap = query.reverse && query.by != range_query::kind::rank;
+        return run_range(cmd[1], swap ? cmd[3] : cmd[2], swap ? cmd[2] : cmd[3], query);
+    }
+
+    // ZRANGEBYSCORE key min max [WITHSCORES] [LIMIT offset count]
+    // ZRANGEBYLEX key min max [LIMIT offset count]
+    std::string SortedSetCommandHandler::handle_zrange_by(const command_t &cmd, range_query::kind by)
+    {
+        if (cmd.size() < 4)
+        {
+            return serializer::serialize_error(std::string("ERR wrong number of arguments for '") +
+                                               (by == range_query::kind::score ? "zrangebyscore" : "zrangebylex") +
+                                               "' command");
+        }
+        range_query query;
+        query.by = by;
+        for (std::size_t i = 4; i < cmd.size(); ++i)
+        {
+            const std::string option = upper(cmd[i]);
+            if (option == "WITHSCORES" && by == range_query::kind::score)
+            {
+                query.with_scores = true;
+            }
+            else if (option == "LIMIT" && i + 2 < cmd.size())
+            {
+                const auto offset = parse_integer(cmd[i + 1]);
+                const auto count = parse_integer(cmd[i + 2]);
+                if (!offset || !count)
+                {
+                    return serializer::serialize_error("ERR value is not an integer or out of range");
+                }
+                query.has_limit = true;
+                query.offset = *offset;
+                query.count = *count;
+                i += 2;
+            }
+            else
+            {
+                return serializer::serialize_error("ERR syntax error");
+            }
+        }
+        return run_range(cmd[1], cmd[2], cmd[3], query);
+    }
+
+    std::string SortedSetCommandHandler::run_range(const std::string &key, const std::string &min,
+                                                   const std::string &max, const range_query &query)
+    {
+        // 음수 count는 제한 없음, 음수 offset은 빈 결과
+        if (query.offset < 0)
+        {
+            return serializer::serialize_array({});
+        }
+        const auto offset = static_cast<std::size_t>(query.offset);
+        const auto count =
+            query.count < 0 ? std::numeric_limits<std::size_t>::max() : static_cast<std::size_t>(query.count);
+        try
+        {
+            switch (query.by)
+            {
+            case range_query::kind::rank:
+            {
+                const auto start = parse_integer(min);
+                const auto stop = parse_integer(max);
+                if (!start || !stop)
+                {
+                    return serializer::serialize_error("ERR value is not an integer or out of range");
+                }
+                return serialize_entries(store_->zrange(key, *start, *stop, query.reverse), query.with_scores);
+            }
+            case range_query::kind::score:
+            {
+                score_range range;
+                if (!parse_score_bound(min, range.min, range.min_exclusive) ||
+                    !parse_score_bound(max, range.max, range.max_exclusive))
+                {
+                    return serializer::serialize_error("ERR min or max is not a float");
+                }
+                return serialize_entries(store_->zrangebyscore(key, range, query.reverse, offset, count),
+                                         query.with_scores);
+            }
+            case range_query::kind::lex:
+            {
+                lex_range range;
+                bool empty = false;
+                if (!parse_lex_bound(min, true, range.min, range.min_exclusive, range.min_unbounded, empty) ||
+                    !parse_lex_bound(max, false, range.max, range.max_exclusive, range.max_unbounded, empty))
+                {
+                    return serializer::serialize_error("ERR min or max not valid string range item");
+                }
+                if (empty)
+                {
+                    // 키의 타입은 그래도 확인
+                    store_->zcard(key);
+                    return serializer::serialize_array({});
+                }
+                return serialize_entries(store_->zrangebylex(key, range, query.reverse, offset, count), false);
+            }
+            }
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+        return serializer::serialize_array({});
+    }
+
+    // ZREM key member [member ...]
+    std::string SortedSetCommandHandler::handle_zrem(const command_t &cmd)
+    {
+        if (cmd.size() < 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'zrem' command");
+        }
+        const std::vector<std::string> members(cmd.begin() + 2, cmd.end());
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->zrem(cmd[1], members)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // ZCARD key
+    std::string SortedSetCommandHandler::handle_zcard(const command_t &cmd)
+    {
+        if (cmd.size() != 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'zcard' command");
+        }
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->zcard(cmd[1])));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+} // namespace mini_redis
@@ -0,0 +1,573 @@
+#include "command/stream_command_handler.hpp"
+#include "protocol/serializer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+namespace mini_redis
+{
+    namespace
+    {
+        const char *const invalid_id = "ERR Invalid stream ID specified as stream command argument";
+
+        std::optional<long long> parse_integer(const std::string &text)
+        {
+            long long value = 0;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (text.empty() || ec != std::errc() || end != text.data() + text.size())
+            {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        std::string upper(std::string text)
+        {
+            std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+            return text;
+        }
+
+        // "<ms>-<seq>" 또는 "<ms>" (순번은 missing_seq)
+        stream_id parse_id(const std::string &text, std::uint64_t missing_seq = 0)
+        {
+            const auto id = stream_id::parse(text, missing_seq);
+            if (!id)
+            {
+                throw std::runtime_error(invalid_id);
+            }
+            return *id;
+        }
+
+        // XRANGE/XPENDING의 경계: "-", "+", "(" 붙은 배타적 ID. 순번이 없으면 시작은 0, 끝은 최대
+        stream_id parse_range_bound(const std::string &text, bool is_start)
+        {
+            if (text == "-")
+            {
+                return stream_id{};
+            }
+            if (text == "+")
+            {
+                return stream_id::max();
+            }
+            const std::uint64_t missing_seq = is_start ? 0 : std::numeric_limits<std::uint64_t>::max();
+            if (text.size() > 1 && text[0] == '(')
+            {
+                stream_id id = parse_id(text.substr(1), missing_seq);
+                if (!(is_start ? id.increment() : id.decrement()))
+                {
+                    throw std::runtime_error(is_start ? "ERR invalid start ID for the interval"
+                                                      : "ERR invalid end ID for the interval");
+                }
+                return id;
+            }
+            return parse_id(text, missing_seq);
+        }
+
+        // XADD의 ID: "*", "<ms>-*", "<ms>-<seq>", "<ms>"
+        stream::id_spec parse_xadd_id(const std::string &text)
+        {
+            stream::id_spec spec;
+            if (text == "*")
+            {
+                return spec;
+            }
+            spec.auto_ms = false;
+            if (text.size() > 2 && text.compare(text.size() - 2, 2, "-*") == 0)
+            {
+                spec.id = parse_id(text.substr(0, text.size() - 2));
+                return spec;
+            }
+            spec.auto_seq = false;
+            spec.id = parse_id(text);
+            return spec;
+        }
+
+        // MAXLEN|MINID [=|~] threshold [LIMIT count]. i는 MAXLEN/MINID 위치에서 시작해 마지막 인자 위치로 옮김
+        stream_trim parse_trim(const command_t &cmd, std::size_t &i)
+        {
+            stream_trim trim;
+            trim.by = upper(cmd[i]) == "MAXLEN" ? stream_trim::strategy::maxlen : stream_trim::strategy::minid;
+            if (i + 1 < cmd.size() && (cmd[i + 1] == "~" || cmd[i + 1] == "="))
+            {
+                trim.approximate = cmd[++i] == "~";
+            }
+            if (++i >= cmd.size())
+            {
+                throw std::runtime_error("ERR syntax error");
+            }
+            if (trim.by == stream_trim::strategy::maxlen)
+            {
+                const auto maxlen = parse_integer(cmd[i]);
+                if (!maxlen)
+                {
+                    throw std::runtime_error("ERR value is not an integer or out of range");
+                }
+                if (*maxlen < 0)
+                {
+                    throw std::runtime_error("ERR The MAXLEN argument must be >= 0.");
+                }
+                trim.maxlen = static_cast<std::uint64_t>(*maxlen);
+            }
+            else
+            {
+                trim.minid = parse_id(cmd[i]);
+            }
+            if (i + 2 < cmd.size() && upper(cmd[i + 1]) == "LIMIT")
+            {
+                const auto limit = parse_integer(cmd[i + 2]);
+                if (!limit || *limit < 0)
+                {
+                    throw std::runtime_error("ERR The LIMIT argument must be >= 0.");
+                }
+                if (!trim.approximate)
+                {
+                    throw std::runtime_error("ERR syntax error, LIMIT cannot be used without the special ~ option");
+                }
+                // LIMIT 0은 제한 없음
+                trim.limit = *limit ? static_cast<std::size_t>(*limit) : std::numeric_limits<std::size_t>::max();
+                i += 2;
+            }
+            return trim;
+        }
+
+        std::string entry_reply(const stream::entry &e)
+        {
+            // 소비자 그룹 이력에서 이미 지워진 항목은 [id, nil]
+            return "*2\r\n" + serializer::serialize_bulk_string(e.id.to_string()) +
+                   (e.fields.empty() ? serializer::serialize_null_array() : serializer::serialize_array(e.fields));
+        }
+
+        std::string entries_reply(const std::vector<stream::entry> &entries)
+        {
+            std::vector<std::string> replies;
+            replies.reserve(entries.size());
+            for (const auto &e : entries)
+            {
+                replies.push_back(entry_reply(e));
+            }
+            return serializer::serialize_reply_array(replies);
+        }
+    } // namespace
+
+    StreamCommandHandler::StreamCommandHandler(std::shared_ptr<store> store) : store_(store) {}
+
+    bool StreamCommandHandler::supports(const std::string& command_name) const {
+        std::string upper_cmd = command_name;
+        std::transform(upper_cmd.begin(), upper_cmd.end(), upper_cmd.begin(), ::toupper);
+        return upper_cmd == "XADD" || upper_cmd == "XLEN" || upper_cmd == "XRANGE" || upper_cmd == "XREVRANGE" ||
+               upper_cmd == "XTRIM" || upper_cmd == "XREAD" || upper_cmd == "XGROUP" || upper_cmd == "XREADGROUP" ||
+               upper_cmd == "XACK" || upper_cmd == "XPENDING";
+    }
+
+    std::string StreamCommandHandler::execute(const command_t& cmd) {
+        std::string command_name = cmd[0];
+        std::transform(command_name.begin(), command_name.end(), command_name.begin(), ::toupper);
+
+        if (command_name == "XADD") {
+            return handle_xadd(cmd);
+        } else if (command_name == "XLEN") {
+            return handle_xlen(cmd);
+        } else if (command_name == "XRANGE") {
+            return handle_xrange(cmd, false);
+        } else if (command_name == "XREVRANGE") {
+            return handle_xrange(cmd, true);
+        } else if (command_name == "XTRIM") {
+            return handle_xtrim(cmd);
+        } else if (command_name == "XREAD") {
+            return handle_xread(cmd, false);
+        } else if (command_name == "XGROUP") {
+            return handle_xgroup(cmd);
+        } else if (command_name == "XREADGROUP") {
+            return handle_xread(cmd, true);
+        } else if (command_name == "XACK") {
+            return handle_xack(cmd);
+        } else if (command_name == "XPENDING") {
+            return handle_xpending(cmd);
+        }
+        return serializer::serialize_error("ERR unknown command `" + cmd[0] + "`");
+    }
+
+    // XADD key [NOMKSTREAM] [MAXLEN|MINID [=|~] threshold [LIMIT count]] *|id field value [field value ...]
+    std::string StreamCommandHandler::handle_xadd(const command_t &cmd)
+    {
+        try
+        {
+            bool nomkstream = false;
+            stream_trim trim;
+            std::size_t i = 2;
+            for (; i < cmd.size(); ++i)
+            {
+                const std::string option = upper(cmd[i]);
+                if (option == "NOMKSTREAM")
+                {
+                    nomkstream = true;
+                }
+                else if (option == "MAXLEN" || option == "MINID")
+                {
+                    trim = parse_trim(cmd, i);
+                }
+                else
+                {
+                    break;
+                }
+            }
+            // ID 뒤에 field value 쌍이 하나 이상 있어야 함
+            if (i >= cmd.size() || cmd.size() - i < 3 || (cmd.size() - i - 1) % 2 != 0)
+            {
+                return serializer::serialize_error("ERR wrong number of arguments for 'xadd' command");
+            }
+            const auto spec = parse_xadd_id(cmd[i]);
+            const std::vector<std::string> fields(cmd.begin() + i + 1, cmd.end());
+            const auto id = store_->xadd(cmd[1], spec, fields, trim, nomkstream);
+            return serializer::serialize_bulk_string(id ? std::optional<std::string>(id->to_string()) : std::nullopt);
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // XLEN key
+    std::string StreamCommandHandler::handle_xlen(const command_t &cmd)
+    {
+        if (cmd.size() != 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'xlen' command");
+        }
+        try
+        {
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->xlen(cmd[1])));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // XRANGE key start end [COUNT count], XREVRANGE key end start [COUNT count]
+    std::string StreamCommandHandler::handle_xrange(const command_t &cmd, bool reverse)
+    {
+        if (cmd.size() != 4 && cmd.size() != 6)
+        {
+            return serializer::serialize_error(std::string("ERR wrong number of arguments for '") +
+                                               (reverse ? "xrevrange" : "xrange") + "' command");
+        }
+        try
+        {
+            std::size_t count = std::numeric_limits<std::size_t>::max();
+            if (cmd.size() == 6)
+            {
+                const auto parsed = parse_integer(cmd[5]);
+                if (upper(cmd[4]) != "COUNT")
+                {
+                    return serializer::serialize_error("ERR syntax error");
+                }
+                if (!parsed)
+                {
+                    return serializer::serialize_error("ERR value is not an integer or out of range");
+                }
+                count = *parsed < 0 ? 0 : static_cast<std::size_t>(*parsed);
+            }
+            const stream_id start = parse_range_bound(reverse ? cmd[3] : cmd[2], true);
+            const stream_id end = parse_range_bound(reverse ? cmd[2] : cmd[3], false);
+            return entries_reply(store_->xrange(cmd[1], start, end, count, reverse));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // XTRIM key MAXLEN|MINID [=|~] threshold [LIMIT count]
+    std::string StreamCommandHandler::handle_xtrim(const command_t &cmd)
+    {
+        if (cmd.size() < 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'xtrim' command");
+        }
+        try
+        {
+            std::size_t i = 2;
+            const std::string strategy = upper(cmd[i]);
+            if (strategy != "MAXLEN" && strategy != "MINID")
+            {
+                return serializer::serialize_error("ERR syntax error");
+            }
+            const stream_trim trim = parse_trim(cmd, i);
+            if (i + 1 != cmd.size())
+            {
+                return serializer::serialize_error("ERR syntax error");
+            }
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->xtrim(cmd[1], trim)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // XREAD [COUNT count] [BLOCK ms] STREAMS key [key ...] id [id ...]
+    // XREADGROUP GROUP group consumer [COUNT count] [BLOCK ms] [NOACK] STREAMS key [key ...] id [id ...]
+    std::string StreamCommandHandler::handle_xread(const command_t &cmd, bool group)
+    {
+        const std::string name = group ? "xreadgroup" : "xread";
+        try
+        {
+            std::string group_name, consumer;
+            std::size_t count = 0;
+            bool noack = false;
+            std::size_t i = 1;
+            for (; i < cmd.size(); ++i)
+            {
+                const std::string option = upper(cmd[i]);
+                if (option == "STREAMS")
+                {
+                    break;
+                }
+                if (option == "COUNT" && i + 1 < cmd.size())
+                {
+                    const auto parsed = parse_integer(cmd[++i]);
+                    if (!parsed)
+                    {
+                        return serializer::serialize_error("ERR value is not an integer or out of range");
+                    }
+                    count = *parsed < 0 ? 0 : static_cast<std::size_t>(*parsed);
+                }
+                else if (option == "BLOCK" && i + 1 < cmd.size())
+                {
+                    // 세션 스레드를 붙잡지 않도록 대기하는 읽기는 지원하지 않음
+                    return serializer::serialize_error("ERR BLOCK is not supported");
+                }
+                else if (group && option == "GROUP" && i + 2 < cmd.size())
+                {
+                    group_name = cmd[i + 1];
+                    consumer = cmd[i + 2];
+                    i += 2;
+                }
+                else if (group && option == "NOACK")
+                {
+                    noack = true;
+                }
+                else
+                {
+                    return serializer::serialize_error("ERR syntax error");
+                }
+            }
+            if (group && group_name.empty())
+            {
+                return serializer::serialize_error("ERR Missing GROUP option for XREADGROUP");
+            }
+            const std::size_t rest = i < cmd.size() ? cmd.size() - i - 1 : 0;
+            if (rest == 0 || rest % 2 != 0)
+            {
+                return serializer::serialize_error(
+                    "ERR Unbalanced '" + name +
+                    "' list of streams: for each stream key an ID or '$' must be specified.");
+            }
+            const std::size_t streams = rest / 2;
+            const std::vector<std::string> keys(cmd.begin() + i + 1, cmd.begin() + i + 1 + streams);
+            // XREAD의 "$"와 XREADGROUP의 ">"는 std::nullopt
+            std::vector<std::optional<stream_id>> after;
+            for (std::size_t k = 0; k < streams; ++k)
+            {
+                const std::string &text = cmd[i + 1 + streams + k];
+                if (group && text == "$")
+                {
+                    return serializer::serialize_error(
+                        "ERR The $ ID is meaningless in the context of XREADGROUP: you want to read the history "
+                        "of this consumer by specifying a proper ID, or use the > ID to get new messages. The $ ID "
+                        "would just return an empty result set.");
+                }
+                after.push_back(text == (group ? ">" : "$") ? std::nullopt
+                                                              : std::optional<stream_id>(parse_id(text)));
+            }
+
+            const auto result = group ? store_->xreadgroup(group_name, consumer, keys, after, count, noack)
+                                      : store_->xread(keys, after, count);
+            if (result.empty())
+            {
+                return serializer::serialize_null_array();
+            }
+            std::vector<std::string> replies;
+            for (const auto &[key, entries] : result)
+            {
+                replies.push_back("*2\r\n" + serializer::serialize_bulk_string(key) + entries_reply(entries));
+            }
+            return serializer::serialize_reply_array(replies);
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // XGROUP CREATE key group id|$ [MKSTREAM] [ENTRIESREAD n], XGROUP SETID key group id|$ [ENTRIESREAD n],
+    // XGROUP DESTROY key group, XGROUP CREATECONSUMER key group consumer, XGROUP DELCONSUMER key group consumer
+    std::string StreamCommandHandler::handle_xgroup(const command_t &cmd)
+    {
+        if (cmd.size() < 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'xgroup' command");
+        }
+        const std::string sub = upper(cmd[1]);
+        try
+        {
+            if (sub == "CREATE" || sub == "SETID")
+            {
+                if (cmd.size() < 5)
+                {
+                    return serializer::serialize_error("ERR wrong number of arguments for 'xgroup|" +
+                                                       std::string(sub == "CREATE" ? "create" : "setid") +
+                                                       "' command");
+                }
+                bool mkstream = false;
+                for (std::size_t i = 5; i < cmd.size(); ++i)
+                {
+                    const std::string option = upper(cmd[i]);
+                    if (sub == "CREATE" && option == "MKSTREAM")
+                    {
+                        mkstream = true;
+                    }
+                    else if (option == "ENTRIESREAD" && i + 1 < cmd.size())
+                    {
+                        // 그룹의 lag 계산용 값. lag을 보고하지 않으므로 형식만 확인
+                        if (!parse_integer(cmd[++i]))
+                        {
+                            return serializer::serialize_error("ERR value is not an integer or out of range");
+                        }
+                    }
+                    else
+                    {
+                        return serializer::serialize_error("ERR syntax error");
+                    }
+                }
+                const std::optional<stream_id> id =
+                    cmd[4] == "$" ? std::nullopt : std::optional<stream_id>(parse_id(cmd[4]));
+                if (sub == "CREATE")
+                {
+                    store_->xgroup_create(cmd[2], cmd[3], id, mkstream);
+                }
+                else
+                {
+                    store_->xgroup_setid(cmd[2], cmd[3], id);
+                }
+                return serializer::serialize_ok();
+            }
+            if (sub == "DESTROY" && cmd.size() == 4)
+            {
+                return serializer::serialize_integer(store_->xgroup_destroy(cmd[2], cmd[3]) ? 1 : 0);
+            }
+            if (sub == "CREATECONSUMER" && cmd.size() == 5)
+            {
+                return serializer::serialize_integer(store_->xgroup_createconsumer(cmd[2], cmd[3], cmd[4]) ? 1 : 0);
+            }
+            if (sub == "DELCONSUMER" && cmd.size() == 5)
+            {
+                return serializer::serialize_integer(
+                    static_cast<std::int64_t>(store_->xgroup_delconsumer(cmd[2], cmd[3], cmd[4])));
+            }
+            return serializer::serialize_error("ERR unknown subcommand or wrong number of arguments for '" + cmd[1] +
+                                               "'. Try XGROUP HELP.");
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // XACK key group id [id ...]
+    std::string StreamCommandHandler::handle_xack(const command_t &cmd)
+    {
+        if (cmd.size() < 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'xack' command");
+        }
+        try
+        {
+            std::vector<stream_id> ids;
+            for (std::size_t i = 3; i < cmd.size(); ++i)
+            {
+                ids.push_back(parse_id(cmd[i]));
+            }
+            return serializer::serialize_integer(static_cast<std::int64_t>(store_->xack(cmd[1], cmd[2], ids)));
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+
+    // XPENDING key group [[IDLE min-idle-time] start end count [consumer]]
+    std::string StreamCommandHandler::handle_xpending(const command_t &cmd)
+    {
+        if (cmd.size() < 3)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'xpending' command");
+        }
+        try
+        {
+            if (cmd.size() == 3)
+            {
+                const auto summary = store_->xpending(cmd[1], cmd[2]);
+                if (summary.count == 0)
+                {
+                    return "*4\r\n" + serializer::serialize_integer(0) + serializer::serialize_null_bulk_string() +
+                           serializer::serialize_null_bulk_string() + serializer::serialize_null_array();
+                }
+                std::vector<std::string> consumers;
+                for (const auto &[name, pending] : summary.consumers)
+                {
+                    consumers.push_back(serializer::serialize_array({name, std::to_string(pending)}));
+                }
+                return "*4\r\n" + serializer::serialize_integer(static_cast<std::int64_t>(summary.count)) +
+                       serializer::serialize_bulk_string(summary.min.to_string()) +
+                       serializer::serialize_bulk_string(summary.max.to_string()) +
+                       serializer::serialize_reply_array(consumers);
+            }
+
+            std::size_t i = 3;
+            long long min_idle = 0;
+            if (upper(cmd[i]) == "IDLE" && i + 1 < cmd.size())
+            {
+                const auto parsed = parse_integer(cmd[i + 1]);
+                if (!parsed)
+                {
+                    return serializer::serialize_error("ERR value is not an integer or out of range");
+                }
+                min_idle = *parsed;
+                i += 2;
+            }
+            if (cmd.size() - i != 3 && cmd.size() - i != 4)
+            {
+                return serializer::serialize_error("ERR syntax error");
+            }
+            const stream_id start = parse_range_bound(cmd[i], true);
+            const stream_id end = parse_range_bound(cmd[i + 1], false);
+            const auto count = parse_integer(cmd[i + 2]);
+            if (!count)
+            {
+                return serializer::serialize_error("ERR value is not an integer or out of range");
+            }
+            const std::optional<std::string> consumer =
+                cmd.size() - i == 4 ? std::optional<std::string>(cmd[i + 3]) : std::nullopt;
+            const auto entries = store_->xpending(cmd[1], cmd[2], start, end,
+                                                  *count < 0 ? 0 : static_cast<std::size_t>(*count), consumer, min_idle);
+            std::vector<std::string> replies;
+            replies.reserve(entries.size());
+            for (const auto &e : entries)
+            {
+                replies.push_back("*4\r\n" + serializer::serialize_bulk_string(e.id.to_string()) +
+                                  serializer::serialize_bulk_string(e.consumer) + serializer::serialize_integer(e.idle_ms) +
+                                  serializer::serialize_integer(static_cast<std::int64_t>(e.deliveries)));
+            }
+            return serializer::serialize_reply_array(replies);
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+    }
+} // namespace mini_redis
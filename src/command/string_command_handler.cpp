@@ -11,9 +11,10 @@ namespace mini_redis
     bool StringCommandHandler::supports(const std::string& command_name) const {
         std::string upper_cmd = command_name;
         std::transform(upper_cmd.begin(), upper_cmd.end(), upper_cmd.begin(), ::toupper);
-        return upper_cmd == "GET" || upper_cmd == "SET" || upper_cmd == "SETEX" || 
+        return upper_cmd == "GET" || upper_cmd == "SET" || upper_cmd == "SETEX" || upper_cmd == "PSETEX" || 
                upper_cmd == "INCR" || upper_cmd == "DECR" ||
-               upper_cmd == "INCRBY" || upper_cmd == "DECRBY";
+               upper_cmd == "INCRBY" || upper_cmd == "DECRBY" ||
+               upper_cmd == "MGET" || upper_cmd == "MSET" || upper_cmd == "MSETNX";
     }
 
     std::string StringCommandHandler::execute(const command_t& cmd) {
@@ -26,6 +27,8 @@ namespace mini_redis
             return handle_set(cmd);
         } else if (command_name == "SETEX") {
             return handle_setex(cmd);
+        } else if (command_name == "PSETEX") {
+            return handle_psetex(cmd);
         } else if (command_name == "INCR") {
             return handle_incr(cmd);
         } else if (command_name == "DECR") {
@@ -34,6 +37,12 @@ namespace mini_redis
             return handle_incrby(cmd);
         } else if (command_name == "DECRBY") {
             return handle_decrby(cmd);
+        } else if (command_name == "MGET") {
+            return handle_mget(cmd);
+        } else if (command_name == "MSET") {
+            return handle_mset(cmd, false);
+        } else if (command_name == "MSETNX") {
+            return handle_mset(cmd, true);
         }
         return serializer::serialize_error("ERR unknown command `" + cmd[0] + "`");
     }
@@ -64,7 +73,15 @@ namespace mini_redis
         }
         const std::string &key = cmd[1];
         const std::string &value = cmd[2];
-        store_->set(key, value);
+        try
+        {
+            store_->set(key, value);
+        }
+        catch (const std::runtime_error& e)
+        {
+            // maxmemory를 넘었는데 축출할 수 있는 키가 없는 경우 (OOM)
+            return serializer::serialize_error(e.what());
+        }
         return serializer::serialize_ok();
     }
 
@@ -95,6 +112,45 @@ namespace mini_redis
         {
             return serializer::serialize_error("ERR value is not an integer or out of range");
         }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
+
+        return serializer::serialize_ok();
+    }
+
+    std::string StringCommandHandler::handle_psetex(const command_t &cmd)
+    {
+        if (cmd.size() != 4)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'psetex' command");
+        }
+
+        const std::string &key = cmd[1];
+        const std::string &ttl_str = cmd[2];
+        const std::string &value = cmd[3];
+
+        try
+        {
+            long long ttl_ms = std::stoll(ttl_str);
+            if (ttl_ms <= 0) {
+                return serializer::serialize_error("ERR invalid expire time in psetex");
+            }
+            store_->psetex(key, ttl_ms, value);
+        }
+        catch (const std::invalid_argument&)
+        {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        }
+        catch (const std::out_of_range&)
+        {
+            return serializer::serialize_error("ERR value is not an integer or out of range");
+        }
+        catch (const std::runtime_error& e)
+        {
+            return serializer::serialize_error(e.what());
+        }
 
         return serializer::serialize_ok();
     }
@@ -170,4 +226,51 @@ namespace mini_redis
             return serializer::serialize_error(e.what());
         }
     }
+
+    // MGET key [key ...]
+    std::string StringCommandHandler::handle_mget(const command_t &cmd)
+    {
+        if (cmd.size() < 2)
+        {
+            return serializer::serialize_error("ERR wrong number of arguments for 'mget' command");
+        }
+        const std::vector<std::string> keys(cmd.begin() + 1, cmd.end());
+        // 값마다 문자열을 만들지 않고, 잠금을 잡은 store에서 바로 응답 버퍼 하나에 씀
+        std::string reply = "*" + std::to_string(keys.size()) + "\r\n";
+        reply.reserve(keys.size() * 32);
+        store_->mget(keys, [&](std::optional<std::string_view> value) {
+            serializer::append_bulk_string(reply, value);
+        });
+        return reply;
+    }
+
+    // MSET key value [key value ...], MSETNX key value [key value ...]
+    std::string StringCommandHandler::handle_mset(const command_t &cmd, bool nx)
+    {
+        if (cmd.size() < 3 || cmd.size() % 2 == 0)
+        {
+            return serializer::serialize_error(std::string("ERR wrong number of arguments for '") +
+                                               (nx ? "msetnx" : "mset") + "' command");
+        }
+        std::vector<std::pair<std::string, std::string>> pairs;
+        pairs.reserve(cmd.size() / 2);
+        for (std::size_t i = 1; i + 1 < cmd.size(); i += 2)
+        {
+            pairs.emplace_back(cmd[i], cmd[i + 1]);
+        }
+        try
+        {
+            if (nx)
+            {
+                return serializer::serialize_integer(store_->msetnx(pairs) ? 1 : 0);
+            }
+            store_->mset(pairs);
+            return serializer::serialize_ok();
+        }
+        catch (const std::runtime_error& e)
+        {
+            // maxmemory를 넘었는데 축출할 수 있는 키가 없는 경우 (OOM)
+            return serializer::serialize_error(e.what());
+        }
+    }
 } // namespace mini_redis
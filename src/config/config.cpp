@@ -1,4 +1,5 @@
 #include "config/config.hpp"
+#include <cctype>
 #include <stdexcept>
 
 namespace mini_redis
@@ -41,4 +42,185 @@ namespace mini_redis
         // Default host if not specified
         return "0.0.0.0";
     }
+
+    namespace
+    {
+        // Redis와 같은 메모리 크기 표기: 1k = 1000, 1kb = 1024 (m/mb, g/gb도 같음). 단위가 없으면 bytes.
+        // name은 오류 메시지에 쓸 설정 이름
+        std::size_t parse_memory_size(const std::string& name, const std::string& text)
+        {
+            std::size_t pos = 0;
+            while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+                ++pos;
+            }
+            if (pos == 0) {
+                throw std::runtime_error(name + " must be a size such as 100mb: " + text);
+            }
+            const std::size_t number = std::stoull(text.substr(0, pos));
+            std::string unit = text.substr(pos);
+            for (auto& c : unit) {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            if (unit.empty() || unit == "b") return number;
+            if (unit == "k") return number * 1000;
+            if (unit == "kb") return number * 1024;
+            if (unit == "m") return number * 1000 * 1000;
+            if (unit == "mb") return number * 1024 * 1024;
+            if (unit == "g") return number * 1000 * 1000 * 1000;
+            if (unit == "gb") return number * 1024 * 1024 * 1024;
+            throw std::runtime_error(name + " has an unknown unit: " + text);
+        }
+    } // namespace
+
+    store_config Config::get_store_config() const
+    {
+        // storage 섹션은 선택 사항이며, 없으면 기본값을 사용
+        store_config cfg;
+        // persistence 섹션: 스냅샷 파일 위치
+        if (YAML::Node persistence = config_node_["persistence"])
+        {
+            if (persistence["dir"] && persistence["dir"].IsScalar())
+            {
+                cfg.dir = persistence["dir"].as<std::string>();
+            }
+            if (persistence["dbfilename"] && persistence["dbfilename"].IsScalar())
+            {
+                cfg.dbfilename = persistence["dbfilename"].as<std::string>();
+                if (cfg.dbfilename.empty()) {
+                    throw std::runtime_error("persistence.dbfilename must not be empty");
+                }
+            }
+            if (persistence["lazy_load"] && persistence["lazy_load"].IsScalar())
+            {
+                cfg.lazy_load = persistence["lazy_load"].as<bool>();
+            }
+        }
+        YAML::Node storage = config_node_["storage"];
+        if (!storage) {
+            return cfg;
+        }
+        if (storage["shards"] && storage["shards"].IsScalar())
+        {
+            cfg.shards = storage["shards"].as<std::size_t>();
+            if (cfg.shards == 0) {
+                throw std::runtime_error("storage.shards must be greater than 0");
+            }
+        }
+        if (storage["slab_allocator"] && storage["slab_allocator"].IsScalar())
+        {
+            cfg.slab_allocator = storage["slab_allocator"].as<bool>();
+        }
+        if (storage["key_index"] && storage["key_index"].IsScalar())
+        {
+            cfg.key_index = storage["key_index"].as<bool>();
+        }
+        if (storage["list_node_size"] && storage["list_node_size"].IsScalar())
+        {
+            cfg.list_node_bytes = parse_memory_size("storage.list_node_size", storage["list_node_size"].as<std::string>());
+            if (cfg.list_node_bytes == 0) {
+                throw std::runtime_error("storage.list_node_size must be greater than 0");
+            }
+        }
+        if (storage["list_compress_depth"] && storage["list_compress_depth"].IsScalar())
+        {
+            cfg.list_compress_depth = storage["list_compress_depth"].as<std::size_t>();
+        }
+        if (storage["hash_max_listpack_entries"] && storage["hash_max_listpack_entries"].IsScalar())
+        {
+            cfg.hash_max_listpack_entries = storage["hash_max_listpack_entries"].as<std::size_t>();
+        }
+        if (storage["hash_max_listpack_value"] && storage["hash_max_listpack_value"].IsScalar())
+        {
+            cfg.hash_max_listpack_value = storage["hash_max_listpack_value"].as<std::size_t>();
+        }
+        if (storage["set_max_intset_entries"] && storage["set_max_intset_entries"].IsScalar())
+        {
+            cfg.set_max_intset_entries = storage["set_max_intset_entries"].as<std::size_t>();
+        }
+        if (storage["zset_max_listpack_entries"] && storage["zset_max_listpack_entries"].IsScalar())
+        {
+            cfg.zset_max_listpack_entries = storage["zset_max_listpack_entries"].as<std::size_t>();
+        }
+        if (storage["zset_max_listpack_value"] && storage["zset_max_listpack_value"].IsScalar())
+        {
+            cfg.zset_max_listpack_value = storage["zset_max_listpack_value"].as<std::size_t>();
+        }
+        if (storage["hll_sparse_max_bytes"] && storage["hll_sparse_max_bytes"].IsScalar())
+        {
+            cfg.hll_sparse_max_bytes = storage["hll_sparse_max_bytes"].as<std::size_t>();
+        }
+        if (storage["stream_node_max_entries"] && storage["stream_node_max_entries"].IsScalar())
+        {
+            cfg.stream_node_max_entries = storage["stream_node_max_entries"].as<std::size_t>();
+        }
+        if (storage["stream_node_max_bytes"] && storage["stream_node_max_bytes"].IsScalar())
+        {
+            cfg.stream_node_max_bytes = storage["stream_node_max_bytes"].as<std::size_t>();
+        }
+        if (storage["maxmemory"] && storage["maxmemory"].IsScalar())
+        {
+            cfg.maxmemory = parse_memory_size("storage.maxmemory", storage["maxmemory"].as<std::string>());
+        }
+        if (storage["maxmemory_policy"] && storage["maxmemory_policy"].IsScalar())
+        {
+            const auto name = storage["maxmemory_policy"].as<std::string>();
+            auto policy = parse_eviction_policy(name);
+            if (!policy) {
+                throw std::runtime_error("storage.maxmemory_policy is not supported: " + name);
+            }
+            cfg.maxmemory_policy = *policy;
+        }
+        if (storage["maxmemory_samples"] && storage["maxmemory_samples"].IsScalar())
+        {
+            cfg.maxmemory_samples = storage["maxmemory_samples"].as<std::size_t>();
+            if (cfg.maxmemory_samples == 0) {
+                throw std::runtime_error("storage.maxmemory_samples must be greater than 0");
+            }
+        }
+        return cfg;
+    }
+
+    aof_config Config::get_aof_config() const
+    {
+        // persistence 섹션의 appendonly 설정 (파일은 persistence.dir 아래에 만들어짐)
+        aof_config cfg;
+        YAML::Node persistence = config_node_["persistence"];
+        if (!persistence) {
+            return cfg;
+        }
+        if (persistence["appendonly"] && persistence["appendonly"].IsScalar())
+        {
+            cfg.enabled = persistence["appendonly"].as<bool>();
+        }
+        if (persistence["appendfilename"] && persistence["appendfilename"].IsScalar())
+        {
+            cfg.filename = persistence["appendfilename"].as<std::string>();
+            if (cfg.filename.empty()) {
+                throw std::runtime_error("persistence.appendfilename must not be empty");
+            }
+        }
+        if (persistence["appendfsync"] && persistence["appendfsync"].IsScalar())
+        {
+            const auto name = persistence["appendfsync"].as<std::string>();
+            auto policy = parse_fsync_policy(name);
+            if (!policy) {
+                throw std::runtime_error("persistence.appendfsync must be always, everysec or no: " + name);
+            }
+            cfg.fsync = *policy;
+        }
+        if (persistence["auto_aof_rewrite_percentage"] && persistence["auto_aof_rewrite_percentage"].IsScalar())
+        {
+            const int percentage = persistence["auto_aof_rewrite_percentage"].as<int>();
+            if (percentage < 0) {
+                throw std::runtime_error("persistence.auto_aof_rewrite_percentage must not be negative");
+            }
+            cfg.rewrite_percentage = static_cast<unsigned>(percentage);
+        }
+        if (persistence["auto_aof_rewrite_min_size"] && persistence["auto_aof_rewrite_min_size"].IsScalar())
+        {
+            cfg.rewrite_min_size = parse_memory_size("persistence.auto_aof_rewrite_min_size",
+                                                     persistence["auto_aof_rewrite_min_size"].as<std::string>());
+        }
+        return cfg;
+    }
 } // namespace mini_redis
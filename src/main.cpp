@@ -48,7 +48,7 @@ int main()
         mini_redis::Config config("config.yaml");
         const auto host = config.get_host();
         const short port = config.get_port();
-        mini_redis::server s(host, port);
+        mini_redis::server s(host, port, config.get_store_config(), config.get_aof_config());
         std::cout << "Mini-Redis server started on " << host << ":" << port << std::endl;
         s.run();
     }
@@ -1,5 +1,8 @@
 ﻿#include "network/server.hpp"
 #include "network/session.hpp"
+#include "command/dispatcher.hpp"
+#include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <thread>
 #include <memory>
@@ -7,13 +10,18 @@
 
 namespace mini_redis
 {
-  server::server(const std::string& host, short port)
+  server::server(const std::string& host, short port, const store_config& store_cfg, const aof_config& aof_cfg)
       : acceptor_(io_context_, boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address(host), port)),
-        store_(std::make_shared<store>()),
-        pubsub_manager_(std::make_shared<pubsub_manager>())
+        cron_timer_(io_context_),
+        store_(std::make_shared<store>(store_cfg)),
+        pubsub_manager_(std::make_shared<pubsub_manager>()),
+        aof_cfg_(aof_cfg)
   {
+    // 클라이언트를 받기 전에 디스크의 데이터를 불러옴
+    load_data(store_cfg, aof_cfg);
     // 생성자 연결
     start_accept();
+    schedule_cron();
   }
 
   void server::run()
@@ -51,10 +59,168 @@ namespace mini_redis
     std::cout << "Server stopped." << std::endl;
   }
 
+  namespace
+  {
+    // 큰 스냅샷을 읽는 동안 1초에 한 번 진행률을 출력
+    snapshot_progress snapshot_progress_printer()
+    {
+      auto last = std::make_shared<std::chrono::steady_clock::time_point>(std::chrono::steady_clock::now());
+      return [last](std::uint64_t done, std::uint64_t total) {
+        const auto now = std::chrono::steady_clock::now();
+        if (done < total && now - *last < std::chrono::seconds(1))
+        {
+          return;
+        }
+        *last = now;
+        std::cout << "Loading snapshot: " << (total ? done * 100 / total : 100) << "% (" << (done >> 20) << " of "
+                  << (total >> 20) << " MB)" << std::endl;
+      };
+    }
+  } // namespace
+
+  void server::load_data(const store_config& store_cfg, const aof_config& aof_cfg)
+  {
+    const std::string aof_path = store_cfg.dir + "/" + aof_cfg.filename;
+    bool seed_aof = false;
+    if (aof_cfg.enabled && std::filesystem::exists(aof_path))
+    {
+      // Redis와 같이 AOF가 있으면 스냅샷 대신 AOF를 씀 (마지막 쓰기까지 담고 있으므로).
+      // 축출은 DEL로 기록되어 있으므로 다시 실행하는 동안에는 maxmemory를 적용하지 않음
+      CommandDispatcher replayer(store_, pubsub_manager_);
+      store_->set_maxmemory_enforced(false);
+      const auto loaded = append_only_file::replay(aof_path, [&](const command_t& cmd) { replayer.execute_command(cmd); });
+      store_->set_maxmemory_enforced(true);
+      const double seconds = std::max(loaded.seconds, 1e-9);
+      std::cout << "DB loaded from append only file: " << loaded.commands << " commands in " << loaded.seconds
+                << " s, " << static_cast<std::uint64_t>(loaded.commands / seconds) << " commands/s, "
+                << static_cast<std::uint64_t>(loaded.bytes / seconds / (1 << 20)) << " MB/s" << std::endl;
+    }
+    else if (const auto loaded = store_cfg.lazy_load ? store_->load_snapshot_lazily(snapshot_progress_printer())
+                                                     : store_->load_snapshot(0, snapshot_progress_printer()))
+    {
+      const double seconds = std::max(loaded->seconds, 1e-9);
+      if (loaded->deferred)
+      {
+        // 키는 처음 접근될 때나 백그라운드 스레드가 읽음. 끝나는 것은 cron이 알림
+        std::cout << "DB mapped from disk: " << loaded->keys << " keys indexed in " << loaded->seconds * 1000
+                  << " ms, loading the rest in the background (" << (loaded->bytes >> 20) << " MB file, "
+                  << loaded->chunks << " chunks)" << std::endl;
+        loading_since_ = std::chrono::steady_clock::now();
+      }
+      else
+      {
+        std::cout << "DB loaded from disk: " << loaded->keys << " keys (" << loaded->expired << " expired) in "
+                  << loaded->seconds << " s, " << static_cast<std::uint64_t>(loaded->keys / seconds) << " keys/s, "
+                  << static_cast<std::uint64_t>(loaded->bytes / seconds / (1 << 20)) << " MB/s (" << loaded->chunks
+                  << " chunks, " << loaded->threads << " threads)" << std::endl;
+      }
+      // appendonly를 처음 켠 경우: 스냅샷에서 불러온 키가 AOF에도 들어가도록 바로 rewrite함
+      seed_aof = aof_cfg.enabled && loaded->keys > 0;
+    }
+    if (aof_cfg.enabled)
+    {
+      aof_ = std::make_shared<append_only_file>(aof_path, aof_cfg.fsync);
+      store_->log_evictions_to(aof_);
+      // lazy 적재 중이면 rewrite 자식이 모든 키를 볼 수 있도록 적재가 끝난 뒤 cron이 시작함
+      seed_aof_pending_ = seed_aof && store_->loading();
+    }
+    // maxmemory를 낮춘 뒤 다시 시작한 경우 등: 받아들이기 전에 한도 안으로 줄임 (AOF가 있으면 DEL도 기록)
+    if (const auto evicted = store_->evict_to_maxmemory())
+    {
+      std::cout << "Evicted " << evicted << " keys to fit maxmemory after loading" << std::endl;
+    }
+    if (aof_ && seed_aof && !seed_aof_pending_)
+    {
+      store_->bgrewriteaof(*aof_);
+      std::cout << "Background append only file rewriting started to include the snapshot's keys" << std::endl;
+    }
+  }
+
+  void server::schedule_cron()
+  {
+    // 100ms 주기 (Redis 기본 hz 10과 동일)
+    cron_timer_.expires_after(std::chrono::milliseconds(100));
+    cron_timer_.async_wait([this](const boost::system::error_code &error) {
+      if (!error)
+      {
+        run_cron();
+        schedule_cron();
+      }
+    });
+  }
+
+  void server::run_cron()
+  {
+    // 아무도 다시 읽지 않는 만료 키를 능동적으로 삭제. 평소에는 tick당 1ms만 쓰고,
+    // 확인한 TTL 키 중 실제로 만료된 비율이 10%를 넘으면 tick의 25%(Redis의 slow cycle 한도)까지 사용.
+    // 만료 인덱스에 처리할 항목이 없으면 사이클은 예산과 관계없이 바로 끝남
+    const auto expire_budget = store_->expired_stale_ratio() > 0.1
+                                   ? std::chrono::microseconds(25000)
+                                   : std::chrono::microseconds(1000);
+    store_->active_expire_cycle(expire_budget);
+
+    // 쓰기가 드문 shard의 증분 재해시를 마무리 (tick당 최대 1ms)
+    store_->rehash_step(std::chrono::milliseconds(1));
+
+    // 키와 값을 담는 slab의 빈 공간이 많아지면 조금씩 압축하여 빈 slab을 해제 (tick당 최대 1ms)
+    store_->defrag_step(std::chrono::milliseconds(1));
+
+    // lazy 적재가 끝났으면 알리고, 미뤄 둔 AOF의 첫 rewrite를 시작
+    if (loading_since_ && !store_->loading())
+    {
+      const auto status = store_->persistence();
+      const double seconds =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - *loading_since_).count();
+      if (status.loading_error.empty())
+      {
+        std::cout << "Background loading finished in " << seconds << " s" << std::endl;
+      }
+      else
+      {
+        std::cerr << "Background loading finished in " << seconds << " s with keys missing: " << status.loading_error
+                  << std::endl;
+      }
+      loading_since_.reset();
+    }
+    if (seed_aof_pending_ && !store_->loading())
+    {
+      try
+      {
+        store_->bgrewriteaof(*aof_);
+        seed_aof_pending_ = false;
+        std::cout << "Background append only file rewriting started to include the snapshot's keys" << std::endl;
+      }
+      catch (const std::runtime_error &)
+      {
+        // BGSAVE가 실행 중이면 다음 tick에 다시 시도
+      }
+    }
+
+    // 끝난 BGSAVE 자식 프로세스를 거두고 스냅샷 파일을 교체 (BGREWRITEAOF 자식은 AOF writer에 넘김)
+    store_->poll_background_save();
+
+    // AOF가 마지막 rewrite 이후 auto_aof_rewrite_percentage만큼 커졌으면 rewrite
+    if (aof_ && aof_->rewrite_due(aof_cfg_.rewrite_percentage, aof_cfg_.rewrite_min_size))
+    {
+      try
+      {
+        store_->bgrewriteaof(*aof_);
+        std::cout << "Starting automatic rewriting of AOF on " << aof_->size() << " bytes (base "
+                  << aof_->base_size() << ")" << std::endl;
+      }
+      catch (const std::runtime_error &)
+      {
+        // BGSAVE가 실행 중이면 다음 tick에 다시 시도
+      }
+    }
+  }
+
   void server::start_accept()
   {
     // 비동기적 새 클라이언트 연결 수락
+    // 연결마다 strand를 주어, 여러 I/O 스레드가 한 세션의 읽기/쓰기 완료 핸들러를 동시에 실행하지 않게 함
     acceptor_.async_accept(
+        boost::asio::make_strand(io_context_),
         [this](const boost::system::error_code &error, boost::asio::ip::tcp::socket socket) {
           handle_accept(std::move(socket), error);
         });
@@ -68,8 +234,11 @@ namespace mini_redis
       std::cout << "New connection from: " 
                 << socket.remote_endpoint().address().to_string()
                 << ":" << socket.remote_endpoint().port() << std::endl;
+      // 작은 응답이 Nagle + delayed ACK로 묶여 지연되지 않도록 바로 전송
+      boost::system::error_code ignored;
+      socket.set_option(boost::asio::ip::tcp::no_delay(true), ignored);
       // 데이터 저장소를 생성하고 세션에 전달
-      std::make_shared<session>(std::move(socket), store_, pubsub_manager_)->start();
+      std::make_shared<session>(std::move(socket), store_, pubsub_manager_, aof_)->start();
     }
     else
     {
@@ -8,8 +8,9 @@
 
 namespace mini_redis
 {
-  session::session(boost::asio::ip::tcp::socket socket, std::shared_ptr<store> s, std::shared_ptr<pubsub_manager> ps_manager)
-      : socket_(std::move(socket)), handler_(s, ps_manager), pubsub_manager_(ps_manager)
+  session::session(boost::asio::ip::tcp::socket socket, std::shared_ptr<store> s, std::shared_ptr<pubsub_manager> ps_manager,
+                   std::shared_ptr<append_only_file> aof)
+      : socket_(std::move(socket)), handler_(s, ps_manager, aof), pubsub_manager_(ps_manager), aof_(aof)
   {
   }
 
@@ -72,20 +73,42 @@ namespace mini_redis
 
           // resp 명령어 파싱 및 실행
           auto commands = parser_.parse(data);
+          // appendfsync always: 쓰기 명령이 나온 뒤의 응답은 그 명령이 fsync될 때까지 모아 둠
+          std::uint64_t unsynced = 0;
+          std::string deferred;
           for (const auto &cmd : commands)
           {
             std::string upper_cmd = cmd[0];
             std::transform(upper_cmd.begin(), upper_cmd.end(), upper_cmd.begin(), ::toupper);
 
+            std::string result;
             if (is_subscribed() && (upper_cmd != "SUBSCRIBE" && upper_cmd != "UNSUBSCRIBE" && upper_cmd != "PING")) {
-                do_write(serializer::serialize_error("ERR only 'SUBSCRIBE', 'UNSUBSCRIBE', and 'PING' are allowed in this context"));
-                continue;
+                result = serializer::serialize_error("ERR only 'SUBSCRIBE', 'UNSUBSCRIBE', and 'PING' are allowed in this context");
+            } else {
+                result = handler_.execute_command(cmd);
+                if (const auto seq = handler_.take_unsynced_write()) {
+                  unsynced = seq;
+                }
             }
-            std::string result = handler_.execute_command(cmd);
-            if (!result.empty()) {
+            if (unsynced != 0) {
+              deferred += result;
+            } else if (!result.empty()) {
               do_write(result);
             }
           }
+          if (unsynced != 0) {
+            // I/O 스레드는 fsync를 기다리지 않고 반환. writer 스레드가 group commit을 마치면
+            // 응답을 보내고 다음 읽기를 시작함 (그때까지 이 클라이언트의 명령은 더 읽지 않음)
+            aof_->when_durable(unsynced, [this, self, deferred = std::move(deferred)]() mutable {
+              boost::asio::post(socket_.get_executor(), [this, self, deferred = std::move(deferred)] {
+                if (!deferred.empty()) {
+                  do_write(deferred);
+                }
+                do_read();
+              });
+            });
+            return;
+          }
           // 읽기
           do_read();
         }
@@ -99,6 +122,12 @@ namespace mini_redis
 
   void session::do_write(const std::string& response)
   {
+    // 전송 대기 중인 응답이 있으면 이어 붙여서, pipeline된 응답들이 write 한 번으로 나가게 함
+    // (front는 async_write가 쓰는 중이므로 건드리지 않음)
+    if (write_queue_.size() > 1) {
+      write_queue_.back() += response;
+      return;
+    }
     write_queue_.push_back(response);
     if (!writing_in_progress_) {
       do_queued_write();
@@ -34,8 +34,11 @@ namespace mini_redis
         pos++;
 
         size_t crlf_pos = buffer_.find("\r\n", pos);
-        if (crlf_pos == std::string::npos) 
+        if (crlf_pos == std::string::npos)
+        {
+          pos = start_pos;
           break; // \r\n이 없으면 파싱 중단 (명령어 PING, SET 등)
+        }
         int num_elements = std::stoi(buffer_.substr(pos, crlf_pos - pos));
         pos = crlf_pos + 2;
 
@@ -48,7 +51,9 @@ namespace mini_redis
 
         for (int i = 0; i < num_elements; ++i)
         {
-          // 각 요소를 파싱
+          // 각 요소를 파싱 (요소 경계에서 읽기가 끊긴 경우 다음 데이터를 기다림)
+          if (pos >= buffer_.size())
+            break;
           if (buffer_[pos] != '$')
           {
             throw std::runtime_error("Invalid RESP: element must start with '$'");
@@ -1,4 +1,5 @@
 #include "protocol/serializer.hpp"
+#include <charconv>
 
 namespace mini_redis
 {
@@ -31,19 +32,95 @@ namespace mini_redis
       }
     }
 
+    void append_bulk_string(std::string &out, std::optional<std::string_view> value)
+    {
+      if (!value)
+      {
+        out += "$-1\r\n";
+        return;
+      }
+      char buf[24];
+      out += '$';
+      out.append(buf, std::to_chars(buf, buf + sizeof(buf), value->size()).ptr);
+      out += "\r\n";
+      out += *value;
+      out += "\r\n";
+    }
+
+    std::string serialize_null_array()
+    {
+      return "*-1\r\n"; // null array
+    }
+
     std::string serialize_array(const std::vector<std::string> &values)
+    {
+      // LRANGE 등 긴 응답에서 원소마다 임시 문자열을 만들지 않도록 크기를 미리 계산
+      std::size_t total = 16;
+      for (const auto &v : values)
+      {
+        total += v.size() + 16;
+      }
+      std::string result;
+      result.reserve(total);
+      char buf[24];
+      result += '*';
+      result.append(buf, std::to_chars(buf, buf + sizeof(buf), values.size()).ptr);
+      result += "\r\n";
+      for (const auto &v : values)
+      {
+        result += '$';
+        result.append(buf, std::to_chars(buf, buf + sizeof(buf), v.size()).ptr);
+        result += "\r\n";
+        result += v;
+        result += "\r\n";
+      }
+      return result;
+    }
+
+    std::string serialize_nullable_array(const std::vector<std::optional<std::string>> &values)
     {
       std::string result = "*" + std::to_string(values.size()) + "\r\n";
       for (const auto &v : values)
       {
-        result += "$" + std::to_string(v.length()) + "\r\n" + v + "\r\n";
+        result += serialize_bulk_string(v);
       }
       return result;
     }
 
-    std::string serialize_integer(int value)
+    std::string serialize_integer(std::int64_t value)
     {
-      return ":" + std::to_string(value) + "\r\n";
+      // ':' + 최대 20자리(부호 포함) + CRLF
+      char buf[24];
+      buf[0] = ':';
+      char *end = std::to_chars(buf + 1, buf + sizeof(buf) - 2, value).ptr;
+      *end++ = '\r';
+      *end++ = '\n';
+      return std::string(buf, end);
+    }
+
+    std::string serialize_nullable_integer_array(const std::vector<std::optional<std::int64_t>> &values)
+    {
+      std::string result = "*" + std::to_string(values.size()) + "\r\n";
+      for (const auto &v : values)
+      {
+        result += v ? serialize_integer(*v) : serialize_null_bulk_string();
+      }
+      return result;
+    }
+
+    std::string serialize_scan_reply(std::uint64_t cursor, const std::vector<std::string> &items)
+    {
+      return "*2\r\n" + serialize_bulk_string(std::to_string(cursor)) + serialize_array(items);
+    }
+
+    std::string serialize_reply_array(const std::vector<std::string> &replies)
+    {
+      std::string result = "*" + std::to_string(replies.size()) + "\r\n";
+      for (const auto &reply : replies)
+      {
+        result += reply;
+      }
+      return result;
     }
   } // namespace serializer
 } // namespace mini_redis
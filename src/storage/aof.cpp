@@ -0,0 +1,775 @@
+#include "storage/aof.hpp"
+#include "protocol/serializer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mini_redis
+{
+  namespace
+  {
+    std::string to_upper(std::string s)
+    {
+      std::transform(s.begin(), s.end(), s.begin(), ::toupper);
+      return s;
+    }
+
+    long long unix_time_ms()
+    {
+      return std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::system_clock::now().time_since_epoch())
+          .count();
+    }
+
+    void append_command(std::string &out, std::initializer_list<std::string_view> args)
+    {
+      out += '*';
+      out += std::to_string(args.size());
+      out += "\r\n";
+      for (const auto arg : args)
+      {
+        serializer::append_bulk_string(out, arg);
+      }
+    }
+
+    // XADD key [NOMKSTREAM] [MAXLEN|MINID [=|~] threshold [LIMIT count]] id ... 에서 id의 위치
+    std::size_t xadd_id_index(const command_t &cmd)
+    {
+      std::size_t i = 2;
+      while (i < cmd.size())
+      {
+        const std::string option = to_upper(cmd[i]);
+        if (option == "NOMKSTREAM")
+        {
+          ++i;
+        }
+        else if (option == "MAXLEN" || option == "MINID")
+        {
+          ++i;
+          if (i < cmd.size() && (cmd[i] == "=" || cmd[i] == "~"))
+          {
+            ++i;
+          }
+          ++i; // threshold
+          if (i < cmd.size() && to_upper(cmd[i]) == "LIMIT")
+          {
+            i += 2;
+          }
+        }
+        else
+        {
+          break;
+        }
+      }
+      return i;
+    }
+
+    // 파일 교체 직전, rewrite 버퍼에 남은 양이 이보다 작으면 잠금 안에서 마저 씀
+    constexpr std::size_t rewrite_tail_bytes = 64 * 1024;
+
+#ifdef __linux__
+    int open_for_append(const std::string &path)
+    {
+      return ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    }
+
+    bool is_open(int fd) { return fd >= 0; }
+
+    // 일부만 쓰고 실패하면 written에 쓴 만큼을 남김
+    bool write_fully(int fd, const std::string &buf, std::size_t &written)
+    {
+      written = 0;
+      while (written < buf.size())
+      {
+        const ssize_t n = ::write(fd, buf.data() + written, buf.size() - written);
+        if (n < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          return false;
+        }
+        written += static_cast<std::size_t>(n);
+      }
+      return true;
+    }
+
+    bool sync_file(int fd) { return ::fdatasync(fd) == 0; }
+
+    std::uint64_t file_size(int fd, const std::string &)
+    {
+      struct stat st;
+      return ::fstat(fd, &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+    }
+
+    void close_file(int fd) { ::close(fd); }
+#else
+    std::FILE *open_for_append(const std::string &path) { return std::fopen(path.c_str(), "ab"); }
+
+    bool is_open(std::FILE *file) { return file != nullptr; }
+
+    bool write_fully(std::FILE *file, const std::string &buf, std::size_t &written)
+    {
+      written = std::fwrite(buf.data(), 1, buf.size(), file);
+      return written == buf.size() && std::fflush(file) == 0;
+    }
+
+    // 이식 가능한 fsync가 없으므로 stdio 버퍼만 비움 (write_fully에서 이미 비웠음)
+    bool sync_file(std::FILE *) { return true; }
+
+    std::uint64_t file_size(std::FILE *, const std::string &path)
+    {
+      std::error_code ec;
+      const auto size = std::filesystem::file_size(path, ec);
+      return ec ? 0 : size;
+    }
+
+    void close_file(std::FILE *file) { std::fclose(file); }
+#endif
+  } // namespace
+
+  std::optional<fsync_policy> parse_fsync_policy(const std::string &name)
+  {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "always") return fsync_policy::always;
+    if (lower == "everysec") return fsync_policy::everysec;
+    if (lower == "no") return fsync_policy::no;
+    return std::nullopt;
+  }
+
+  const char *fsync_policy_name(fsync_policy policy)
+  {
+    switch (policy)
+    {
+    case fsync_policy::always:
+      return "always";
+    case fsync_policy::everysec:
+      return "everysec";
+    default:
+      return "no";
+    }
+  }
+
+  append_only_file::append_only_file(const std::string &path, fsync_policy policy)
+      : path_(path), policy_(policy), file_(open_for_append(path))
+  {
+    if (!is_open(file_))
+    {
+      throw std::runtime_error("ERR cannot open append only file " + path + ": " + std::strerror(errno));
+    }
+    size_ = file_size(file_, path);
+    base_size_ = size_.load();
+    writer_ = std::thread([this] { writer_loop(); });
+  }
+
+  append_only_file::~append_only_file()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_one();
+    writer_.join();
+    close_file(file_);
+    // 교체하지 못한 rewrite 결과는 버림 (자식이 아직 쓰는 중이면 store가 정리함)
+    if (rewrite_state_ == rewrite_state::merging)
+    {
+      std::remove(rewrite_temp_.c_str());
+    }
+  }
+
+  namespace
+  {
+    // 쓰기 명령의 키 위치 (Redis의 first key / last key / step). last가 0 이하면 끝에서부터 센 위치
+    struct key_spec
+    {
+      int first;
+      int last;
+      int step;
+    };
+
+    // 키 공간을 바꿀 수 있는 명령 (읽기 전용 명령과 SAVE, INFO 같은 서버 명령은 기록하지 않음)
+    const std::unordered_map<std::string, key_spec> &write_commands()
+    {
+      static const std::unordered_map<std::string, key_spec> commands = {
+          {"SET", {1, 1, 1}}, {"SETEX", {1, 1, 1}}, {"PSETEX", {1, 1, 1}},
+          {"INCR", {1, 1, 1}}, {"DECR", {1, 1, 1}}, {"INCRBY", {1, 1, 1}}, {"DECRBY", {1, 1, 1}},
+          {"MSET", {1, 0, 2}}, {"MSETNX", {1, 0, 2}}, {"DEL", {1, 0, 1}},
+          {"EXPIRE", {1, 1, 1}}, {"PEXPIRE", {1, 1, 1}}, {"EXPIREAT", {1, 1, 1}}, {"PEXPIREAT", {1, 1, 1}},
+          {"LPUSH", {1, 1, 1}}, {"RPUSH", {1, 1, 1}}, {"LPOP", {1, 1, 1}}, {"RPOP", {1, 1, 1}}, {"LTRIM", {1, 1, 1}},
+          {"HSET", {1, 1, 1}}, {"HDEL", {1, 1, 1}}, {"HINCRBY", {1, 1, 1}},
+          {"SADD", {1, 1, 1}}, {"SREM", {1, 1, 1}},
+          {"ZADD", {1, 1, 1}}, {"ZINCRBY", {1, 1, 1}}, {"ZREM", {1, 1, 1}},
+          {"SETBIT", {1, 1, 1}}, {"BITOP", {2, 0, 1}}, {"BITFIELD", {1, 1, 1}},
+          {"PFADD", {1, 1, 1}}, {"PFMERGE", {1, 0, 1}},
+          {"XADD", {1, 1, 1}}, {"XTRIM", {1, 1, 1}}, {"XGROUP", {2, 2, 1}}, {"XACK", {1, 1, 1}},
+          {"XREADGROUP", {0, 0, 0}}, // STREAMS 뒤의 앞쪽 절반
+          {"RESTORE", {1, 1, 1}}};
+      return commands;
+    }
+
+    constexpr std::uint64_t all_stripes = ~std::uint64_t(0);
+    static_assert(append_only_file::order_stripes == 64, "order stripes are kept in a 64-bit mask");
+
+    // 명령이 다루는 키들의 order stripe bitmap. 키를 알 수 없으면 모든 stripe
+    std::uint64_t command_stripes(const command_t &cmd)
+    {
+      const auto it = write_commands().find(to_upper(cmd[0]));
+      if (it == write_commands().end())
+      {
+        return all_stripes;
+      }
+      const int argc = static_cast<int>(cmd.size());
+      int first = it->second.first;
+      int last = it->second.last <= 0 ? argc - 1 + it->second.last : it->second.last;
+      int step = it->second.step;
+      if (first == 0)
+      {
+        // XREADGROUP GROUP group consumer [COUNT n] [BLOCK ms] [NOACK] STREAMS key ... id ...
+        const auto streams = std::find_if(cmd.begin() + 1, cmd.end(), [](const std::string &arg) {
+          return to_upper(arg) == "STREAMS";
+        });
+        const int keys = static_cast<int>(cmd.end() - streams - 1) / 2;
+        first = static_cast<int>(streams - cmd.begin()) + 1;
+        last = first + keys - 1;
+        step = 1;
+      }
+      if (first >= argc || last < first)
+      {
+        return all_stripes;
+      }
+      std::uint64_t stripes = 0;
+      for (int i = first; i <= last && i < argc; i += step)
+      {
+        stripes |= std::uint64_t(1) << append_only_file::order_stripe(cmd[i]);
+      }
+      return stripes;
+    }
+  } // namespace
+
+  thread_local const append_only_file *append_only_file::order_owner_ = nullptr;
+  thread_local std::uint64_t append_only_file::order_held_ = 0;
+
+  bool append_only_file::is_write_command(const std::string &command_name)
+  {
+    return write_commands().count(command_name) > 0;
+  }
+
+  std::size_t append_only_file::order_stripe(std::string_view key)
+  {
+    return std::hash<std::string_view>{}(key) % order_stripes;
+  }
+
+  append_only_file::order_guard &append_only_file::order_guard::operator=(order_guard &&other) noexcept
+  {
+    if (this != &other)
+    {
+      release();
+      owner_ = std::exchange(other.owner_, nullptr);
+      stripes_ = std::exchange(other.stripes_, 0);
+    }
+    return *this;
+  }
+
+  void append_only_file::order_guard::release()
+  {
+    if (!owner_)
+    {
+      return;
+    }
+    for (std::size_t i = 0; i < order_stripes; ++i)
+    {
+      if ((stripes_ >> i) & 1)
+      {
+        owner_->order_mutexes_[i].unlock();
+      }
+    }
+    order_held_ &= ~stripes_;
+    if (order_held_ == 0)
+    {
+      order_owner_ = nullptr;
+    }
+    owner_ = nullptr;
+    stripes_ = 0;
+  }
+
+  append_only_file::order_guard append_only_file::lock_stripes(std::uint64_t stripes)
+  {
+    // 항상 번호 순서로 잠가서 여러 키의 명령끼리 교착 상태가 되지 않게 함
+    for (std::size_t i = 0; i < order_stripes; ++i)
+    {
+      if ((stripes >> i) & 1)
+      {
+        order_mutexes_[i].lock();
+      }
+    }
+    order_owner_ = this;
+    order_held_ |= stripes;
+    order_guard guard;
+    guard.owner_ = this;
+    guard.stripes_ = stripes;
+    return guard;
+  }
+
+  append_only_file::order_guard append_only_file::lock_order(const command_t &cmd)
+  {
+    return lock_stripes(cmd.empty() ? all_stripes : command_stripes(cmd));
+  }
+
+  append_only_file::order_guard append_only_file::lock_all_order() { return lock_stripes(all_stripes); }
+
+  bool append_only_file::try_lock_order(std::string_view key, order_guard &out)
+  {
+    const std::size_t index = order_stripe(key);
+    const std::uint64_t stripe = std::uint64_t(1) << index;
+    if (order_owner_ == this && (order_held_ & stripe) != 0)
+    {
+      return true;
+    }
+    if (!order_mutexes_[index].try_lock())
+    {
+      return false;
+    }
+    order_owner_ = this;
+    order_held_ |= stripe;
+    out = order_guard();
+    out.owner_ = this;
+    out.stripes_ = stripe;
+    return true;
+  }
+
+  std::uint64_t append_only_file::feed(const command_t &cmd, const std::string &reply)
+  {
+    // 오류 응답이면 아무것도 바뀌지 않았음 (XADD NOMKSTREAM이 스트림을 만들지 않은 경우는 null)
+    if (reply.empty() || reply[0] == '-' || reply.compare(0, 3, "$-1") == 0)
+    {
+      return 0;
+    }
+    const std::string name = to_upper(cmd[0]);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool was_empty = pending_.empty();
+    const std::size_t start = pending_.size();
+    if ((name == "SETEX" || name == "PSETEX") && cmd.size() == 4)
+    {
+      const long long ttl = std::stoll(cmd[2]);
+      const long long at = unix_time_ms() + (name == "SETEX" ? ttl * 1000 : ttl);
+      append_command(pending_, {"SET", cmd[1], cmd[3]});
+      append_command(pending_, {"PEXPIREAT", cmd[1], std::to_string(at)});
+    }
+    else if ((name == "EXPIRE" || name == "PEXPIRE") && cmd.size() == 3)
+    {
+      // 0 이하면 과거 시각이 되어 다시 실행할 때도 키가 삭제됨
+      const long long ttl = std::stoll(cmd[2]);
+      const long long at = unix_time_ms() + (name == "EXPIRE" ? ttl * 1000 : ttl);
+      append_command(pending_, {"PEXPIREAT", cmd[1], std::to_string(at)});
+    }
+    else if (name == "RESTORE" && cmd.size() >= 4 && std::stoll(cmd[2]) > 0 &&
+             std::none_of(cmd.begin() + 4, cmd.end(), [](const std::string &arg) { return to_upper(arg) == "ABSTTL"; }))
+    {
+      // RESTORE key ttl payload [REPLACE] -> RESTORE key <unix ms> payload [REPLACE] ABSTTL
+      const long long at = unix_time_ms() + std::stoll(cmd[2]);
+      pending_ += '*';
+      pending_ += std::to_string(cmd.size() + 1);
+      pending_ += "\r\n";
+      for (std::size_t i = 0; i < cmd.size(); ++i)
+      {
+        serializer::append_bulk_string(pending_, i == 2 ? std::to_string(at) : cmd[i]);
+      }
+      serializer::append_bulk_string(pending_, "ABSTTL");
+    }
+    else
+    {
+      // XADD의 자동 ID는 응답($len\r\nID\r\n)의 실제 ID로 바꿈
+      const std::size_t id_index = name == "XADD" ? xadd_id_index(cmd) : 0;
+      pending_ += '*';
+      pending_ += std::to_string(cmd.size());
+      pending_ += "\r\n";
+      for (std::size_t i = 0; i < cmd.size(); ++i)
+      {
+        if (id_index && i == id_index && reply[0] == '$')
+        {
+          const std::size_t start = reply.find("\r\n") + 2;
+          serializer::append_bulk_string(pending_, std::string_view(reply).substr(start, reply.size() - start - 2));
+        }
+        else
+        {
+          serializer::append_bulk_string(pending_, cmd[i]);
+        }
+      }
+    }
+    if (rewrite_state_ != rewrite_state::none)
+    {
+      // 자식이 fork 시점의 키 공간을 쓰는 동안의 명령은 새 파일에도 이어 붙여야 함
+      rewrite_buf_.append(pending_, start, std::string::npos);
+    }
+    const std::uint64_t seq = ++fed_seq_;
+    // writer는 batch를 가져간 뒤 비어 있는 버퍼에 첫 명령이 들어올 때만 깨움. 그 뒤의 명령은
+    // writer가 깨어나 가져갈 때까지 같은 batch에 쌓이므로 명령마다 깨우는 비용이 없음
+    if (was_empty)
+    {
+      cv_.notify_one();
+    }
+    return seq;
+  }
+
+  void append_only_file::when_durable(std::uint64_t seq, std::function<void()> fn)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (seq <= durable_seq_)
+    {
+      lock.unlock();
+      fn();
+      return;
+    }
+    waiters_.emplace_back(seq, std::move(fn));
+  }
+
+  std::optional<std::string> append_only_file::write_error() const
+  {
+    if (!write_failed_.load(std::memory_order_acquire))
+    {
+      return std::nullopt;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return write_error_;
+  }
+
+  void append_only_file::start_rewrite()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rewrite_state_ = rewrite_state::buffering;
+    rewrite_buf_.clear();
+  }
+
+  void append_only_file::finish_rewrite(const std::string &temp_path)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (rewrite_state_ != rewrite_state::buffering)
+      {
+        return;
+      }
+      rewrite_state_ = rewrite_state::merging;
+      rewrite_temp_ = temp_path;
+    }
+    cv_.notify_one();
+  }
+
+  void append_only_file::abort_rewrite()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rewrite_state_ = rewrite_state::none;
+    std::string().swap(rewrite_buf_);
+    last_rewrite_ok_ = false;
+  }
+
+  bool append_only_file::rewrite_in_progress() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rewrite_state_ != rewrite_state::none;
+  }
+
+  bool append_only_file::rewrite_due(unsigned percentage, std::uint64_t min_size) const
+  {
+    const std::uint64_t size = size_.load(std::memory_order_relaxed);
+    const std::uint64_t base = base_size_.load(std::memory_order_relaxed);
+    if (percentage == 0 || size < min_size)
+    {
+      return false;
+    }
+    return (size - std::min(size, base)) * 100 >= base * percentage && !rewrite_in_progress();
+  }
+
+  bool append_only_file::write_all(const std::string &buf)
+  {
+    std::size_t written = 0;
+    if (!write_fully(file_, buf, written))
+    {
+#ifdef __linux__
+      // 일부만 쓰였으면 잘라 내어, 다시 시도할 때 명령이 반쯤 두 번 기록되지 않게 함
+      const int saved = errno;
+      if (written > 0 && ::ftruncate(file_, static_cast<off_t>(size_.load())) != 0)
+      {
+        size_ += written;
+      }
+      errno = saved;
+#endif
+      return false;
+    }
+    size_ += buf.size();
+    return true;
+  }
+
+  void append_only_file::merge_rewrite(bool &unsynced)
+  {
+    using clock = std::chrono::steady_clock;
+    std::string temp;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      temp = rewrite_temp_;
+    }
+    native_file file = open_for_append(temp);
+    const auto fail = [&](const char *what) {
+      std::cerr << "Background AOF rewrite failed: cannot " << what << " " << temp << ": " << std::strerror(errno)
+                << std::endl;
+      if (is_open(file))
+      {
+        close_file(file);
+      }
+      std::remove(temp.c_str());
+    };
+    const auto abandon = [this] {
+      rewrite_state_ = rewrite_state::none;
+      std::string().swap(rewrite_buf_);
+      last_rewrite_ok_ = false;
+    };
+    if (!is_open(file))
+    {
+      fail("open");
+      std::lock_guard<std::mutex> lock(mutex_);
+      abandon();
+      return;
+    }
+
+    // 1) 자식이 쓰는 동안 모인 명령을 잠금 없이 옮김. 옮기는 동안 들어온 명령은 다시 버퍼에 쌓이므로
+    //    남은 양이 작아질 때까지 반복 (쓰기가 디스크보다 빠르게 계속 들어오면 몇 번 만에 멈춤)
+    std::string chunk;
+    std::size_t written = 0;
+    for (int round = 0; round < 16; ++round)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (rewrite_buf_.size() < rewrite_tail_bytes)
+        {
+          break;
+        }
+        chunk.swap(rewrite_buf_);
+      }
+      if (!write_fully(file, chunk, written))
+      {
+        fail("write");
+        std::lock_guard<std::mutex> lock(mutex_);
+        abandon();
+        return;
+      }
+      chunk.clear();
+    }
+    if (!sync_file(file))
+    {
+      fail("fsync");
+      std::lock_guard<std::mutex> lock(mutex_);
+      abandon();
+      return;
+    }
+
+    // 2) 남은 명령을 쓰고 파일을 바꿈. feed()가 막히는 것은 이 구간뿐
+    std::vector<std::function<void()>> ready;
+    native_file old_file;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto start = clock::now();
+      const bool tail_ok = write_fully(file, rewrite_buf_, written) &&
+                           (policy_ != fsync_policy::always || rewrite_buf_.empty() || sync_file(file));
+      if (!tail_ok || std::rename(temp.c_str(), path_.c_str()) != 0)
+      {
+        fail(tail_ok ? "rename" : "write");
+        abandon();
+        return;
+      }
+      old_file = file_;
+      file_ = file;
+      size_ = file_size(file_, path_);
+      base_size_ = size_.load();
+      // fork 전의 명령은 자식이 쓴 키 공간에, 그 뒤의 명령은 rewrite_buf_로 모두 새 파일에 들어갔으므로
+      // 옛 파일에 아직 쓰지 않은 명령은 버림
+      pending_.clear();
+      durable_seq_ = fed_seq_;
+      for (auto &waiter : waiters_)
+      {
+        ready.push_back(std::move(waiter.second));
+      }
+      waiters_.clear();
+      std::string().swap(rewrite_buf_);
+      rewrite_state_ = rewrite_state::none;
+      last_rewrite_ok_ = true;
+      last_rewrite_pause_us_ =
+          std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+    }
+    close_file(old_file);
+    // always가 아니면 마지막 부분은 아직 fsync하지 않았음 (everysec이 이어서 처리)
+    unsynced = policy_ != fsync_policy::always;
+    for (auto &fn : ready)
+    {
+      fn();
+    }
+  }
+
+  void append_only_file::writer_loop()
+  {
+    using clock = std::chrono::steady_clock;
+    constexpr auto batch_delay = std::chrono::milliseconds(1);
+    std::string batch;
+    bool unsynced = false;
+    auto last_sync = clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+      // 명령이 들어오면 바로 깨어나고, 조용할 때도 everysec의 fsync를 위해 1초마다 깨어남
+      cv_.wait_for(lock, std::chrono::seconds(1), [this] {
+        return stopping_ || !pending_.empty() || rewrite_state_ == rewrite_state::merging;
+      });
+      if (stopping_ && pending_.empty())
+      {
+        break;
+      }
+      if (rewrite_state_ == rewrite_state::merging)
+      {
+        // 교체가 끝나면 pending_은 비워지고 (새 파일에 들어 있음) 옛 파일은 닫힘
+        lock.unlock();
+        merge_rewrite(unsynced);
+        lock.lock();
+        continue;
+      }
+      if (policy_ != fsync_policy::always && !pending_.empty() && !stopping_)
+      {
+        // 기다리는 클라이언트가 없으므로 1ms 동안 명령을 더 모아 write 한 번에 씀
+        // (명령마다 깨어나 작은 write를 반복하면 I/O 스레드와 CPU를 다툼)
+        lock.unlock();
+        std::this_thread::sleep_for(batch_delay);
+        lock.lock();
+      }
+      // 쌓인 명령을 통째로 가져가 잠금 없이 씀. 쓰는 동안 들어온 명령은 다음 batch로 묶임
+      batch.swap(pending_);
+      const std::uint64_t seq = fed_seq_;
+      lock.unlock();
+
+      bool ok = batch.empty() || write_all(batch);
+      if (ok && !batch.empty())
+      {
+        unsynced = true;
+        batch.clear();
+      }
+      const auto now = clock::now();
+      if (ok && unsynced &&
+          (policy_ == fsync_policy::always ||
+           (policy_ == fsync_policy::everysec && now - last_sync >= std::chrono::seconds(1))))
+      {
+        ok = sync_file(file_);
+        if (ok)
+        {
+          unsynced = false;
+          last_sync = now;
+        }
+      }
+      const std::string error = ok ? std::string() : std::strerror(errno);
+
+      std::vector<std::function<void()>> ready;
+      lock.lock();
+      if (ok)
+      {
+        write_error_.reset();
+        write_failed_.store(false, std::memory_order_release);
+        durable_seq_ = seq;
+        auto done = std::partition(waiters_.begin(), waiters_.end(),
+                                   [seq](const auto &waiter) { return waiter.first > seq; });
+        for (auto it = done; it != waiters_.end(); ++it)
+        {
+          ready.push_back(std::move(it->second));
+        }
+        waiters_.erase(done, waiters_.end());
+      }
+      else
+      {
+        // 쓰지 못한 명령은 새로 들어온 것 앞에 되돌려 두고 잠시 뒤 다시 시도 (fsync만 실패했으면 batch는 비어 있음).
+        // 그동안 쓰기 명령은 거부됨
+        if (!write_error_)
+        {
+          std::cerr << "Error writing to the append only file " << path_ << ": " << error << std::endl;
+        }
+        write_error_ = error;
+        write_failed_.store(true, std::memory_order_release);
+        batch += pending_;
+        pending_.swap(batch);
+        batch.clear();
+        if (stopping_)
+        {
+          break;
+        }
+        cv_.wait_for(lock, std::chrono::seconds(1), [this] { return stopping_; });
+        continue;
+      }
+      lock.unlock();
+      for (auto &fn : ready)
+      {
+        fn();
+      }
+      lock.lock();
+    }
+    lock.unlock();
+    // 종료할 때는 정책과 관계없이 마지막으로 fsync
+    if (unsynced)
+    {
+      sync_file(file_);
+    }
+  }
+
+  aof_load_stats append_only_file::replay(const std::string &path,
+                                          const std::function<void(const command_t &)> &execute)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+      throw std::runtime_error("ERR cannot open append only file " + path);
+    }
+    // 파일 전체를 메모리에 올리지 않고 1MB씩 읽어 parser에 흘려 넣음
+    constexpr std::size_t chunk_size = 1 << 20;
+    aof_load_stats stats;
+    parser p;
+    std::string chunk;
+    for (;;)
+    {
+      chunk.resize(chunk_size);
+      in.read(&chunk[0], static_cast<std::streamsize>(chunk_size));
+      const auto n = static_cast<std::size_t>(in.gcount());
+      if (n == 0)
+      {
+        break;
+      }
+      chunk.resize(n);
+      stats.bytes += n;
+      for (const auto &cmd : p.parse(chunk))
+      {
+        execute(cmd);
+        ++stats.commands;
+      }
+    }
+    in.close();
+
+    // 마지막 명령을 쓰는 도중에 멈춘 경우 (Redis의 aof-load-truncated yes와 같이 잘라 내고 계속)
+    if (const std::size_t partial = p.pending_bytes(); partial > 0)
+    {
+      stats.truncated_bytes = partial;
+      std::filesystem::resize_file(path, stats.bytes - partial);
+      std::cerr << "Append only file " << path << " ends with an incomplete command; truncated " << partial
+                << " bytes" << std::endl;
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+  }
+} // namespace mini_redis
@@ -0,0 +1,399 @@
+#include "storage/bitops.hpp"
+#include <atomic>
+#include <cstring>
+
+/*
+ * x86-64에서는 AVX2/POPCNT 구현을 함께 빌드하고 실행 중에 CPU를 확인해 고름.
+ * GCC/Clang은 함수 단위 target 속성으로, MSVC는 옵션 없이도 intrinsic을 쓸 수 있음.
+ * 그 밖의 환경에서는 scalar 구현만 씀.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define MINI_REDIS_BITOPS_X86 1
+#define MINI_REDIS_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define MINI_REDIS_BITOPS_X86 1
+#define MINI_REDIS_TARGET(isa)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace mini_redis
+{
+  namespace bitops
+  {
+    namespace
+    {
+      std::uint64_t load_word(const unsigned char *p)
+      {
+        std::uint64_t w;
+        std::memcpy(&w, p, sizeof(w));
+        return w;
+      }
+
+      void store_word(unsigned char *p, std::uint64_t w)
+      {
+        std::memcpy(p, &w, sizeof(w));
+      }
+
+      // 64 bits 안의 1인 bit 수 (SWAR)
+      std::uint64_t popcount_word(std::uint64_t w)
+      {
+        w = w - ((w >> 1) & 0x5555555555555555ull);
+        w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+        w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return (w * 0x0101010101010101ull) >> 56;
+      }
+
+      std::uint64_t popcount_scalar(const unsigned char *p, std::size_t n)
+      {
+        std::uint64_t total = 0;
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+          total += popcount_word(load_word(p + i));
+        }
+        for (; i < n; ++i)
+        {
+          total += popcount_word(p[i]);
+        }
+        return total;
+      }
+
+      template <operation Op>
+      unsigned char apply(unsigned char a, unsigned char b)
+      {
+        switch (Op)
+        {
+        case operation::bit_and:
+          return a & b;
+        case operation::bit_or:
+          return a | b;
+        case operation::bit_xor:
+          return a ^ b;
+        default:
+          return static_cast<unsigned char>(~b);
+        }
+      }
+
+      template <operation Op>
+      std::uint64_t apply(std::uint64_t a, std::uint64_t b)
+      {
+        switch (Op)
+        {
+        case operation::bit_and:
+          return a & b;
+        case operation::bit_or:
+          return a | b;
+        case operation::bit_xor:
+          return a ^ b;
+        default:
+          return ~b;
+        }
+      }
+
+      // 8 bytes씩 처리하고 남은 byte는 하나씩 (begin부터, 앞부분은 다른 구현이 이미 처리한 경우)
+      template <operation Op>
+      void combine_scalar(unsigned char *dst, const unsigned char *src, std::size_t begin, std::size_t n)
+      {
+        std::size_t i = begin;
+        for (; i + 8 <= n; i += 8)
+        {
+          store_word(dst + i, apply<Op>(load_word(dst + i), load_word(src + i)));
+        }
+        for (; i < n; ++i)
+        {
+          dst[i] = apply<Op>(dst[i], src[i]);
+        }
+      }
+
+#ifdef MINI_REDIS_BITOPS_X86
+      MINI_REDIS_TARGET("popcnt")
+      std::uint64_t popcount_popcnt(const unsigned char *p, std::size_t n)
+      {
+        // 독립된 누산기 4개로 popcnt의 지연 시간을 겹침
+        std::uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+          c0 += static_cast<std::uint64_t>(_mm_popcnt_u64(load_word(p + i)));
+          c1 += static_cast<std::uint64_t>(_mm_popcnt_u64(load_word(p + i + 8)));
+          c2 += static_cast<std::uint64_t>(_mm_popcnt_u64(load_word(p + i + 16)));
+          c3 += static_cast<std::uint64_t>(_mm_popcnt_u64(load_word(p + i + 24)));
+        }
+        for (; i + 8 <= n; i += 8)
+        {
+          c0 += static_cast<std::uint64_t>(_mm_popcnt_u64(load_word(p + i)));
+        }
+        for (; i < n; ++i)
+        {
+          c0 += static_cast<std::uint64_t>(_mm_popcnt_u32(p[i]));
+        }
+        return c0 + c1 + c2 + c3;
+      }
+
+      // 32 bytes 안의 각 8 bytes의 1인 bit 수 (4비트씩 표를 찾아 더하는 Muła의 방법)
+      MINI_REDIS_TARGET("avx2")
+      __m256i popcount256(__m256i v)
+      {
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                                1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low_mask = _mm256_set1_epi8(0x0F);
+        const __m256i lo = _mm256_and_si256(v, low_mask);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        const __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+      }
+
+      // carry-save adder: a + b + c의 각 bit 자리를 (high, low) 두 bit로
+      MINI_REDIS_TARGET("avx2")
+      void csa(__m256i &high, __m256i &low, __m256i a, __m256i b, __m256i c)
+      {
+        const __m256i u = _mm256_xor_si256(a, b);
+        high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+        low = _mm256_xor_si256(u, c);
+      }
+
+      /*
+       * Harley-Seal 방식: 16개 벡터(512 bytes)를 carry-save adder로 더해 가며 bit 자리별 1의 개수를
+       * ones/twos/fours/eights/sixteens 벡터에 이진수로 모으고, 넘쳐 나온 sixteens에만 popcount를 함.
+       * 벡터 하나당 popcount 대신 논리 연산 몇 개로 끝나므로 표 찾기 방식만 쓸 때보다 빠름.
+       */
+      MINI_REDIS_TARGET("avx2")
+      std::uint64_t popcount_avx2(const unsigned char *p, std::size_t n)
+      {
+        const __m256i *v = reinterpret_cast<const __m256i *>(p);
+        const std::size_t vectors = n / 32;
+        __m256i total = _mm256_setzero_si256();
+        __m256i ones = _mm256_setzero_si256(), twos = _mm256_setzero_si256(), fours = _mm256_setzero_si256(),
+                eights = _mm256_setzero_si256(), sixteens;
+        __m256i twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+        std::size_t i = 0;
+        for (; i + 16 <= vectors; i += 16)
+        {
+          csa(twos_a, ones, ones, _mm256_loadu_si256(v + i), _mm256_loadu_si256(v + i + 1));
+          csa(twos_b, ones, ones, _mm256_loadu_si256(v + i + 2), _mm256_loadu_si256(v + i + 3));
+          csa(fours_a, twos, twos, twos_a, twos_b);
+          csa(twos_a, ones, ones, _mm256_loadu_si256(v + i + 4), _mm256_loadu_si256(v + i + 5));
+          csa(twos_b, ones, ones, _mm256_loadu_si256(v + i + 6), _mm256_loadu_si256(v + i + 7));
+          csa(fours_b, twos, twos, twos_a, twos_b);
+          csa(eights_a, fours, fours, fours_a, fours_b);
+          csa(twos_a, ones, ones, _mm256_loadu_si256(v + i + 8), _mm256_loadu_si256(v + i + 9));
+          csa(twos_b, ones, ones, _mm256_loadu_si256(v + i + 10), _mm256_loadu_si256(v + i + 11));
+          csa(fours_a, twos, twos, twos_a, twos_b);
+          csa(twos_a, ones, ones, _mm256_loadu_si256(v + i + 12), _mm256_loadu_si256(v + i + 13));
+          csa(twos_b, ones, ones, _mm256_loadu_si256(v + i + 14), _mm256_loadu_si256(v + i + 15));
+          csa(fours_b, twos, twos, twos_a, twos_b);
+          csa(eights_b, fours, fours, fours_a, fours_b);
+          csa(sixteens, eights, eights, eights_a, eights_b);
+          total = _mm256_add_epi64(total, popcount256(sixteens));
+        }
+        total = _mm256_slli_epi64(total, 4);
+        total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(eights), 3));
+        total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(fours), 2));
+        total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(twos), 1));
+        total = _mm256_add_epi64(total, popcount256(ones));
+        for (; i < vectors; ++i)
+        {
+          total = _mm256_add_epi64(total, popcount256(_mm256_loadu_si256(v + i)));
+        }
+        alignas(32) std::uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), total);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + popcount_popcnt(p + vectors * 32, n - vectors * 32);
+      }
+
+      template <operation Op>
+      MINI_REDIS_TARGET("avx2")
+      __m256i apply256(__m256i a, __m256i b)
+      {
+        switch (Op)
+        {
+        case operation::bit_and:
+          return _mm256_and_si256(a, b);
+        case operation::bit_or:
+          return _mm256_or_si256(a, b);
+        case operation::bit_xor:
+          return _mm256_xor_si256(a, b);
+        default:
+          return _mm256_xor_si256(b, _mm256_set1_epi32(-1));
+        }
+      }
+
+      template <operation Op>
+      MINI_REDIS_TARGET("avx2")
+      void combine_avx2(unsigned char *dst, const unsigned char *src, std::size_t n)
+      {
+        std::size_t i = 0;
+        for (; i + 64 <= n; i += 64)
+        {
+          __m256i *d = reinterpret_cast<__m256i *>(dst + i);
+          const __m256i *s = reinterpret_cast<const __m256i *>(src + i);
+          const __m256i r0 = apply256<Op>(_mm256_loadu_si256(d), _mm256_loadu_si256(s));
+          const __m256i r1 = apply256<Op>(_mm256_loadu_si256(d + 1), _mm256_loadu_si256(s + 1));
+          _mm256_storeu_si256(d, r0);
+          _mm256_storeu_si256(d + 1, r1);
+        }
+        combine_scalar<Op>(dst, src, i, n);
+      }
+
+      kernel detect_kernel()
+      {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        const bool popcnt = info[2] & (1 << 23);
+        // AVX2는 CPU 지원과 함께 OS가 YMM 레지스터를 저장해 주는지(OSXSAVE, XCR0)도 확인해야 함
+        bool avx2 = false;
+        if ((info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6)
+        {
+          __cpuidex(info, 7, 0);
+          avx2 = info[1] & (1 << 5);
+        }
+#else
+        __builtin_cpu_init();
+        const bool popcnt = __builtin_cpu_supports("popcnt");
+        const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        return avx2 ? kernel::avx2 : popcnt ? kernel::popcnt : kernel::scalar;
+      }
+#else
+      kernel detect_kernel()
+      {
+        return kernel::scalar;
+      }
+#endif
+
+      std::atomic<kernel> &selected()
+      {
+        static std::atomic<kernel> k{best_kernel()};
+        return k;
+      }
+
+      template <operation Op>
+      void combine_with(unsigned char *dst, const unsigned char *src, std::size_t n)
+      {
+#ifdef MINI_REDIS_BITOPS_X86
+        if (active_kernel() == kernel::avx2)
+        {
+          combine_avx2<Op>(dst, src, n);
+          return;
+        }
+#endif
+        combine_scalar<Op>(dst, src, 0, n);
+      }
+    } // namespace
+
+    kernel best_kernel()
+    {
+      static const kernel detected = detect_kernel();
+      return detected;
+    }
+
+    kernel active_kernel()
+    {
+      return selected().load(std::memory_order_relaxed);
+    }
+
+    kernel use_kernel(kernel k)
+    {
+      if (static_cast<int>(k) > static_cast<int>(best_kernel()))
+      {
+        k = best_kernel();
+      }
+      selected().store(k, std::memory_order_relaxed);
+      return k;
+    }
+
+    const char *kernel_name(kernel k)
+    {
+      switch (k)
+      {
+      case kernel::avx2:
+        return "avx2";
+      case kernel::popcnt:
+        return "popcnt";
+      default:
+        return "scalar";
+      }
+    }
+
+    std::uint64_t popcount(const unsigned char *p, std::size_t n)
+    {
+#ifdef MINI_REDIS_BITOPS_X86
+      switch (active_kernel())
+      {
+      case kernel::avx2:
+        return popcount_avx2(p, n);
+      case kernel::popcnt:
+        return popcount_popcnt(p, n);
+      default:
+        break;
+      }
+#endif
+      return popcount_scalar(p, n);
+    }
+
+    void combine(operation op, unsigned char *dst, const unsigned char *src, std::size_t n)
+    {
+      switch (op)
+      {
+      case operation::bit_and:
+        combine_with<operation::bit_and>(dst, src, n);
+        break;
+      case operation::bit_or:
+        combine_with<operation::bit_or>(dst, src, n);
+        break;
+      case operation::bit_xor:
+        combine_with<operation::bit_xor>(dst, src, n);
+        break;
+      case operation::bit_not:
+        combine_with<operation::bit_not>(dst, src, n);
+        break;
+      }
+    }
+
+    std::int64_t find_bit(const unsigned char *p, std::size_t n, bool bit)
+    {
+      // 찾는 bit가 없는 byte(1을 찾으면 0x00, 0을 찾으면 0xFF)는 8 bytes씩 건너뜀
+      const std::uint64_t skip_word = bit ? 0 : ~std::uint64_t(0);
+      const unsigned char skip_byte = bit ? 0x00 : 0xFF;
+      std::size_t i = 0;
+      while (i + 8 <= n && load_word(p + i) == skip_word)
+      {
+        i += 8;
+      }
+      for (; i < n; ++i)
+      {
+        if (p[i] != skip_byte)
+        {
+          for (int b = 0; b < 8; ++b)
+          {
+            if (((p[i] >> (7 - b)) & 1) == static_cast<int>(bit))
+            {
+              return static_cast<std::int64_t>(i * 8 + b);
+            }
+          }
+        }
+      }
+      return -1;
+    }
+
+    std::uint64_t get_field(const unsigned char *p, std::size_t n, std::uint64_t offset, unsigned bits)
+    {
+      std::uint64_t value = 0;
+      for (unsigned i = 0; i < bits; ++i)
+      {
+        value = (value << 1) | static_cast<std::uint64_t>(get_bit(p, n, offset + i));
+      }
+      return value;
+    }
+
+    void set_field(unsigned char *p, std::uint64_t offset, unsigned bits, std::uint64_t value)
+    {
+      for (unsigned i = 0; i < bits; ++i)
+      {
+        set_bit(p, offset + i, (value >> (bits - 1 - i)) & 1);
+      }
+    }
+  } // namespace bitops
+} // namespace mini_redis
@@ -0,0 +1,165 @@
+#include "storage/compact_hash.hpp"
+
+namespace mini_redis
+{
+  namespace
+  {
+    std::size_t heap_bytes(const std::string &s)
+    {
+      const char *self = reinterpret_cast<const char *>(&s);
+      const bool is_inline = s.data() >= self && s.data() < self + sizeof(s);
+      return is_inline ? 0 : s.capacity() + 1;
+    }
+  } // namespace
+
+  compact_hash::compact_hash(const compact_hash &other)
+      : packed_(other.packed_),
+        count_(other.count_),
+        opts_(other.opts_),
+        table_(other.table_ ? std::make_unique<table_type>(*other.table_) : nullptr),
+        table_heap_bytes_(other.table_heap_bytes_)
+  {
+  }
+
+  compact_hash &compact_hash::operator=(const compact_hash &other)
+  {
+    if (this != &other)
+    {
+      compact_hash copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  std::size_t compact_hash::find_packed(std::string_view field, std::size_t &value_at) const
+  {
+    std::size_t pos = 0;
+    while (pos < packed_.size())
+    {
+      std::size_t field_size;
+      const std::string_view candidate = listpack::read(packed_.data() + pos, field_size);
+      std::size_t value_size;
+      listpack::read(packed_.data() + pos + field_size, value_size);
+      if (candidate == field)
+      {
+        value_at = pos + field_size;
+        return pos;
+      }
+      pos += field_size + value_size;
+    }
+    return std::string::npos;
+  }
+
+  bool compact_hash::set(std::string_view field, std::string_view value)
+  {
+    if (table_)
+    {
+      auto [it, inserted] = table_->try_emplace(std::string(field));
+      if (inserted)
+      {
+        table_heap_bytes_ += heap_bytes(it->first);
+      }
+      table_heap_bytes_ -= heap_bytes(it->second);
+      it->second.assign(value.data(), value.size());
+      table_heap_bytes_ += heap_bytes(it->second);
+      return inserted;
+    }
+    if (field.size() > opts_.max_listpack_value || value.size() > opts_.max_listpack_value)
+    {
+      convert_to_table();
+      return set(field, value);
+    }
+
+    std::size_t value_at;
+    if (find_packed(field, value_at) != std::string::npos)
+    {
+      std::size_t old_size;
+      listpack::read(packed_.data() + value_at, old_size);
+      packed_.replace(value_at, old_size, listpack::encode(value));
+      return false;
+    }
+    if (count_ + 1 > opts_.max_listpack_entries)
+    {
+      convert_to_table();
+      return set(field, value);
+    }
+    listpack::append(packed_, field);
+    listpack::append(packed_, value);
+    ++count_;
+    return true;
+  }
+
+  std::optional<std::string> compact_hash::get(std::string_view field) const
+  {
+    if (table_)
+    {
+      // 이종 조회(heterogeneous lookup)는 C++20부터라 임시 문자열을 만듦
+      auto it = table_->find(std::string(field));
+      return it == table_->end() ? std::nullopt : std::optional<std::string>(it->second);
+    }
+    std::size_t value_at;
+    if (find_packed(field, value_at) == std::string::npos)
+    {
+      return std::nullopt;
+    }
+    std::size_t size;
+    return std::string(listpack::read(packed_.data() + value_at, size));
+  }
+
+  bool compact_hash::erase(std::string_view field)
+  {
+    if (table_)
+    {
+      auto it = table_->find(std::string(field));
+      if (it == table_->end())
+      {
+        return false;
+      }
+      table_heap_bytes_ -= heap_bytes(it->first) + heap_bytes(it->second);
+      table_->erase(it);
+      return true;
+    }
+    std::size_t value_at;
+    const std::size_t pos = find_packed(field, value_at);
+    if (pos == std::string::npos)
+    {
+      return false;
+    }
+    std::size_t value_size;
+    listpack::read(packed_.data() + value_at, value_size);
+    packed_.erase(pos, value_at + value_size - pos);
+    --count_;
+    if (count_ == 0)
+    {
+      packed_.shrink_to_fit();
+    }
+    return true;
+  }
+
+  void compact_hash::convert_to_table()
+  {
+    auto table = std::make_unique<table_type>();
+    table->reserve(count_ + 1);
+    std::size_t heap = 0;
+    for_each([&](std::string_view field, std::string_view value) {
+      auto it = table->emplace(std::string(field), std::string(value)).first;
+      heap += heap_bytes(it->first) + heap_bytes(it->second);
+    });
+    table_ = std::move(table);
+    table_heap_bytes_ = heap;
+    std::string().swap(packed_);
+    count_ = 0;
+  }
+
+  std::size_t compact_hash::memory_usage() const
+  {
+    std::size_t total = sizeof(compact_hash) + heap_bytes(packed_);
+    if (table_)
+    {
+      // 노드마다 next 포인터와 캐시된 해시 값, 필드와 값 std::string
+      total += sizeof(table_type) + table_->bucket_count() * sizeof(void *) +
+               table_->size() * (2 * sizeof(void *) + 2 * sizeof(std::string)) + table_heap_bytes_;
+    }
+    return total;
+  }
+} // namespace mini_redis
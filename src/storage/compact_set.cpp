@@ -0,0 +1,94 @@
+#include "storage/compact_set.hpp"
+#include "storage/value_entry.hpp"
+
+namespace mini_redis
+{
+  compact_set::compact_set(const compact_set &other)
+      : ints_(other.ints_),
+        opts_(other.opts_),
+        table_(other.table_ ? std::make_unique<table_type>(*other.table_) : nullptr),
+        table_heap_bytes_(other.table_heap_bytes_)
+  {
+  }
+
+  compact_set &compact_set::operator=(const compact_set &other)
+  {
+    if (this != &other)
+    {
+      compact_set copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  bool compact_set::insert(std::string_view member)
+  {
+    if (!table_)
+    {
+      const auto value = parse_int64(member);
+      if (value && (ints_.size() < opts_.max_intset_entries || ints_.contains(*value)))
+      {
+        return ints_.insert(*value);
+      }
+      convert_to_table();
+    }
+    auto [it, inserted] = table_->emplace(member);
+    if (inserted)
+    {
+      table_heap_bytes_ += string_heap_bytes(*it);
+    }
+    return inserted;
+  }
+
+  bool compact_set::erase(std::string_view member)
+  {
+    if (!table_)
+    {
+      // 표준 표기가 아닌 문자열("007" 등)은 intset에 들어갈 수 없으므로 없는 원소
+      const auto value = parse_int64(member);
+      return value && ints_.erase(*value);
+    }
+    // 이종 조회(heterogeneous lookup)는 C++20부터라 임시 문자열을 만듦
+    auto it = table_->find(std::string(member));
+    if (it == table_->end())
+    {
+      return false;
+    }
+    table_heap_bytes_ -= string_heap_bytes(*it);
+    table_->erase(it);
+    return true;
+  }
+
+  bool compact_set::contains(std::string_view member) const
+  {
+    if (!table_)
+    {
+      const auto value = parse_int64(member);
+      return value && ints_.contains(*value);
+    }
+    return table_->count(std::string(member)) != 0;
+  }
+
+  void compact_set::convert_to_table()
+  {
+    auto table = std::make_unique<table_type>();
+    table->reserve(ints_.size() + 1);
+    std::size_t heap = 0;
+    for_each([&](std::string_view member) { heap += string_heap_bytes(*table->emplace(member).first); });
+    table_ = std::move(table);
+    table_heap_bytes_ = heap;
+    ints_ = intset();
+  }
+
+  std::size_t compact_set::memory_usage() const
+  {
+    std::size_t total = sizeof(compact_set) + ints_.heap_bytes();
+    if (table_)
+    {
+      // 노드마다 next 포인터와 캐시된 해시 값, 원소 std::string
+      total += sizeof(table_type) + table_->bucket_count() * sizeof(void *) +
+               table_->size() * (2 * sizeof(void *) + sizeof(std::string)) + table_heap_bytes_;
+    }
+    return total;
+  }
+} // namespace mini_redis
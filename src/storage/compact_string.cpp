@@ -0,0 +1,127 @@
+#include "storage/compact_string.hpp"
+#include <algorithm>
+
+namespace mini_redis
+{
+  void compact_string::set_pointer(char *p, std::size_t n, unsigned char tag)
+  {
+    std::uint64_t size = n;
+    std::memcpy(buf_, &p, sizeof(p));
+    std::memcpy(buf_ + sizeof(char *), &size, sizeof(size));
+    buf_[tag_pos] = static_cast<char>(tag);
+  }
+
+  std::size_t compact_string::heap_capacity() const
+  {
+    // 포인터와 길이 뒤의 7 bytes에 little-endian으로 저장
+    std::size_t capacity = 0;
+    for (std::size_t i = tag_pos; i-- > capacity_pos;)
+    {
+      capacity = (capacity << 8) | static_cast<unsigned char>(buf_[i]);
+    }
+    return capacity;
+  }
+
+  void compact_string::set_heap_capacity(std::size_t capacity)
+  {
+    for (std::size_t i = capacity_pos; i < tag_pos; ++i)
+    {
+      buf_[i] = static_cast<char>(capacity & 0xFF);
+      capacity >>= 8;
+    }
+  }
+
+  void compact_string::assign(std::string_view s, slab_arena *arena)
+  {
+    if (s.size() <= inline_capacity)
+    {
+      std::memcpy(buf_, s.data(), s.size());
+      buf_[tag_pos] = static_cast<char>(s.size());
+      return;
+    }
+    const bool use_arena = arena && s.size() <= slab_arena::max_object_size;
+    char *p = use_arena ? static_cast<char *>(arena->allocate(s.size())) : new char[s.size()];
+    std::memcpy(p, s.data(), s.size());
+    set_pointer(p, s.size(), use_arena ? slab_tag : heap_tag);
+    if (!use_arena)
+    {
+      set_heap_capacity(s.size());
+    }
+  }
+
+  void compact_string::resize(std::size_t n, slab_arena *arena)
+  {
+    const std::size_t old_size = size();
+    if (n == old_size)
+    {
+      return;
+    }
+    // 지금 버퍼 안에서 크기만 바꿀 수 있는 경우 (slab은 크기 등급이 그대로일 때만)
+    const bool fits = is_inline()  ? n <= inline_capacity
+                      : in_arena() ? n > inline_capacity && n <= slab_arena::max_object_size &&
+                                         slab_arena::class_size_for(n) == slab_arena::class_size_for(old_size)
+                                   : n > inline_capacity && n <= heap_capacity();
+    if (fits)
+    {
+      char *p = mutable_data();
+      if (n > old_size)
+      {
+        std::memset(p + old_size, 0, n - old_size);
+      }
+      if (is_inline())
+      {
+        buf_[tag_pos] = static_cast<char>(n);
+      }
+      else
+      {
+        std::uint64_t size = n;
+        std::memcpy(buf_ + sizeof(char *), &size, sizeof(size));
+      }
+      return;
+    }
+
+    compact_string grown;
+    if (n <= inline_capacity)
+    {
+      std::memcpy(grown.buf_, data(), n);
+      grown.buf_[tag_pos] = static_cast<char>(n);
+    }
+    else if (arena && n <= slab_arena::max_object_size)
+    {
+      char *p = static_cast<char *>(arena->allocate(n));
+      std::memcpy(p, data(), std::min(n, old_size));
+      std::memset(p + std::min(n, old_size), 0, n - std::min(n, old_size));
+      grown.set_pointer(p, n, slab_tag);
+    }
+    else
+    {
+      // 커질 때는 여유를 두어 (1MB까지는 두 배, 그 뒤로는 1MB씩) 반복되는 확장의 복사를 줄임
+      constexpr std::size_t max_prealloc = 1024 * 1024;
+      const std::size_t capacity = n > old_size ? std::max(n, std::min(2 * n, n + max_prealloc)) : n;
+      char *p = new char[capacity];
+      std::memcpy(p, data(), std::min(n, old_size));
+      std::memset(p + std::min(n, old_size), 0, n - std::min(n, old_size));
+      grown.set_pointer(p, n, heap_tag);
+      grown.set_heap_capacity(capacity);
+    }
+    *this = std::move(grown);
+  }
+
+  void compact_string::release() noexcept
+  {
+    if (is_inline())
+    {
+      return;
+    }
+    char *p = const_cast<char *>(data());
+    if (in_arena())
+    {
+      slab_arena::deallocate(p, size());
+    }
+    else
+    {
+      delete[] p;
+    }
+    buf_[tag_pos] = 0;
+  }
+} // namespace mini_redis
@@ -0,0 +1,138 @@
+#include "storage/eviction.hpp"
+#include "storage/value_entry.hpp"
+#include <algorithm>
+#include <cctype>
+#include <random>
+
+namespace mini_redis
+{
+  std::optional<eviction_policy> parse_eviction_policy(std::string_view name)
+  {
+    std::string normalized(name);
+    for (auto &c : normalized)
+    {
+      c = c == '_' ? '-' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (normalized == "noeviction")
+    {
+      return eviction_policy::noeviction;
+    }
+    if (normalized == "allkeys-lru")
+    {
+      return eviction_policy::allkeys_lru;
+    }
+    if (normalized == "allkeys-lfu")
+    {
+      return eviction_policy::allkeys_lfu;
+    }
+    if (normalized == "volatile-ttl")
+    {
+      return eviction_policy::volatile_ttl;
+    }
+    return std::nullopt;
+  }
+
+  const char *eviction_policy_name(eviction_policy policy)
+  {
+    switch (policy)
+    {
+    case eviction_policy::allkeys_lru:
+      return "allkeys-lru";
+    case eviction_policy::allkeys_lfu:
+      return "allkeys-lfu";
+    case eviction_policy::volatile_ttl:
+      return "volatile-ttl";
+    case eviction_policy::noeviction:
+    default:
+      return "noeviction";
+    }
+  }
+
+  namespace access_policy
+  {
+    namespace
+    {
+      constexpr double lfu_log_factor = 10.0;
+
+      std::uint32_t minutes_now()
+      {
+        return static_cast<std::uint32_t>(steady_clock_ms() / 60000) & 0xFFFF;
+      }
+    } // namespace
+
+    std::uint32_t lru_clock()
+    {
+      return static_cast<std::uint32_t>(steady_clock_ms() / 1000) & lru_clock_max;
+    }
+
+    std::uint32_t lru_idle_seconds(std::uint32_t access, std::uint32_t now)
+    {
+      const std::uint32_t last = access & lru_clock_max;
+      return now >= last ? now - last : now + (lru_clock_max - last) + 1;
+    }
+
+    std::uint32_t lfu_initial()
+    {
+      return (minutes_now() << 8) | lfu_init_counter;
+    }
+
+    std::uint8_t lfu_decayed_counter(std::uint32_t access)
+    {
+      const std::uint32_t last = (access >> 8) & 0xFFFF;
+      const std::uint32_t now = minutes_now();
+      const std::uint32_t elapsed = now >= last ? now - last : now + (0xFFFF - last) + 1;
+      const std::uint32_t counter = access & 0xFF;
+      return static_cast<std::uint8_t>(elapsed >= counter ? 0 : counter - elapsed);
+    }
+
+    std::uint32_t lfu_touch(std::uint32_t access)
+    {
+      std::uint32_t counter = lfu_decayed_counter(access);
+      if (counter < 255)
+      {
+        // 읽기는 여러 스레드에서 동시에 실행되므로 스레드마다 난수 생성기를 둠
+        thread_local std::minstd_rand rng(std::random_device{}());
+        const double r = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        const double base = counter > lfu_init_counter ? counter - lfu_init_counter : 0;
+        if (r < 1.0 / (base * lfu_log_factor + 1))
+        {
+          ++counter;
+        }
+      }
+      return (minutes_now() << 8) | counter;
+    }
+  } // namespace access_policy
+
+  void eviction_pool::offer(std::uint64_t score, std::size_t shard, std::string_view key)
+  {
+    if (items_.size() == capacity && score <= items_.front().score)
+    {
+      return;
+    }
+    for (const auto &c : items_)
+    {
+      if (c.shard == shard && c.key == key)
+      {
+        return; // 같은 키를 여러 번 샘플링한 경우
+      }
+    }
+    if (items_.size() == capacity)
+    {
+      items_.erase(items_.begin());
+    }
+    auto pos = std::upper_bound(items_.begin(), items_.end(), score,
+                                [](std::uint64_t s, const candidate &c) { return s < c.score; });
+    items_.insert(pos, candidate{score, shard, std::string(key)});
+  }
+
+  bool eviction_pool::pop_best(candidate &out)
+  {
+    if (items_.empty())
+    {
+      return false;
+    }
+    out = std::move(items_.back());
+    items_.pop_back();
+    return true;
+  }
+} // namespace mini_redis
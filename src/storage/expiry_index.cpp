@@ -0,0 +1,210 @@
+#include "storage/expiry_index.hpp"
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace mini_redis
+{
+  namespace
+  {
+    constexpr std::uint64_t slot_mask = expiry_index::wheel_size - 1;
+
+    inline unsigned count_trailing_zeros(std::uint64_t mask)
+    {
+#if defined(_MSC_VER)
+      unsigned long index;
+      _BitScanForward64(&index, mask);
+      return static_cast<unsigned>(index);
+#else
+      return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+    }
+
+    // level단 한 칸이 나타내는 ms 단위의 bit 수
+    inline unsigned level_shift(std::size_t level)
+    {
+      return static_cast<unsigned>(level * expiry_index::wheel_bits);
+    }
+
+    // bit i가 칸 i를 나타내는 bitmap을 from번 칸이 bit 0에 오도록 돌림
+    inline std::uint64_t rotate_to(std::uint64_t mask, unsigned from)
+    {
+      return from == 0 ? mask : (mask >> from) | (mask << (expiry_index::wheel_size - from));
+    }
+  } // namespace
+
+  expiry_index::expiry_index(std::int64_t now_ms) : now_(now_ms) {}
+
+  void expiry_index::insert(std::uint64_t hash, std::int64_t deadline)
+  {
+    place(entry{hash, deadline});
+    ++size_;
+  }
+
+  void expiry_index::place(const entry &e)
+  {
+    const std::int64_t delta = e.deadline - now_;
+    if (delta <= 0)
+    {
+      push(due_, e);
+      return;
+    }
+
+    // delta가 들어가는 가장 낮은 단을 고름: level단은 64^(level+1) ms 미만의 범위를 담당
+    std::size_t level = 0;
+    while (level < levels && static_cast<std::uint64_t>(delta) >> level_shift(level + 1) != 0)
+    {
+      ++level;
+    }
+    std::int64_t target = e.deadline;
+    if (level == levels)
+    {
+      // 휠 전체 범위(약 2.2년)보다 먼 시각은 가장 먼 칸에 두고 cascade 때 다시 배치
+      level = levels - 1;
+      target = now_ + static_cast<std::int64_t>((std::uint64_t(1) << level_shift(levels)) - 1);
+    }
+    const std::size_t index = (static_cast<std::uint64_t>(target) >> level_shift(level)) & slot_mask;
+    push(wheels_[level][index], e);
+    occupied_[level] |= std::uint64_t(1) << index;
+  }
+
+  void expiry_index::push(slot &s, const entry &e)
+  {
+    const std::size_t capacity = s.capacity();
+    s.push_back(e);
+    bytes_ += (s.capacity() - capacity) * sizeof(entry);
+  }
+
+  void expiry_index::cascade(std::size_t level)
+  {
+    const std::size_t index = (static_cast<std::uint64_t>(now_) >> level_shift(level)) & slot_mask;
+    if ((occupied_[level] & (std::uint64_t(1) << index)) == 0)
+    {
+      return;
+    }
+    slot items;
+    items.swap(wheels_[level][index]);
+    occupied_[level] &= ~(std::uint64_t(1) << index);
+    // 이 칸의 항목은 모두 64^level ms 안에 만료되므로 더 낮은 단(또는 due)으로 내려감
+    for (const auto &e : items)
+    {
+      place(e);
+    }
+    bytes_ -= items.capacity() * sizeof(entry);
+  }
+
+  void expiry_index::advance(std::int64_t now_ms)
+  {
+    while (now_ < now_ms)
+    {
+      if (occupied_[0] == 0)
+      {
+        // 0단이 비어 있으면 그사이의 64ms 구간은 할 일이 없으므로, 상위 단에서 다음으로 항목이 있는 칸이
+        // 시작되는 경계(없으면 now_ms)의 직전까지 한 번에 건너뜀. 시계가 크게 뛰어도 사용 중인 칸 수만큼만 돎
+        std::int64_t event = now_ms;
+        for (std::size_t level = 1; level < levels; ++level)
+        {
+          if (occupied_[level] == 0)
+          {
+            continue;
+          }
+          const std::uint64_t current = static_cast<std::uint64_t>(now_) >> level_shift(level);
+          const std::uint64_t ahead = rotate_to(occupied_[level], static_cast<unsigned>((current + 1) & slot_mask));
+          const std::uint64_t start = (current + 1 + count_trailing_zeros(ahead)) << level_shift(level);
+          event = std::min(event, static_cast<std::int64_t>(start));
+        }
+        now_ = std::max(now_, event - 1);
+      }
+      const std::int64_t next = now_ + 1;
+      if ((static_cast<std::uint64_t>(next) & slot_mask) == 0)
+      {
+        // 0단이 한 바퀴 돌았음: 경계에 걸린 상위 단의 칸을 높은 단부터 내려보냄
+        now_ = next;
+        std::size_t top = 1;
+        while (top + 1 < levels && (static_cast<std::uint64_t>(next) & ((std::uint64_t(1) << level_shift(top + 1)) - 1)) == 0)
+        {
+          ++top;
+        }
+        for (std::size_t level = top; level >= 1; --level)
+        {
+          cascade(level);
+        }
+      }
+      else
+      {
+        // 이번 64ms 구간에서 다음으로 항목이 있는 0단 칸까지 건너뜀
+        const unsigned pos = static_cast<unsigned>(static_cast<std::uint64_t>(next) & slot_mask);
+        const std::uint64_t ahead = occupied_[0] >> pos;
+        if (ahead == 0)
+        {
+          now_ = std::min(now_ms, next | static_cast<std::int64_t>(slot_mask));
+          continue;
+        }
+        const std::int64_t target = next + count_trailing_zeros(ahead);
+        if (target > now_ms)
+        {
+          now_ = now_ms;
+          break;
+        }
+        now_ = target;
+      }
+
+      const std::size_t index = static_cast<std::uint64_t>(now_) & slot_mask;
+      if (occupied_[0] & (std::uint64_t(1) << index))
+      {
+        auto &items = wheels_[0][index];
+        if (!has_due())
+        {
+          // 칸의 버퍼를 그대로 due 목록으로 사용
+          bytes_ -= due_.capacity() * sizeof(entry);
+          due_.clear();
+          due_pos_ = 0;
+          due_.swap(items);
+        }
+        else
+        {
+          const std::size_t capacity = due_.capacity();
+          due_.insert(due_.end(), items.begin(), items.end());
+          bytes_ += (due_.capacity() - capacity) * sizeof(entry);
+          bytes_ -= items.capacity() * sizeof(entry);
+        }
+        slot().swap(items);
+        occupied_[0] &= ~(std::uint64_t(1) << index);
+      }
+    }
+  }
+
+  std::size_t expiry_index::take_due(std::size_t max_entries, std::vector<entry> &out)
+  {
+    const std::size_t n = std::min(max_entries, due_.size() - due_pos_);
+    out.insert(out.end(), due_.begin() + due_pos_, due_.begin() + due_pos_ + n);
+    due_pos_ += n;
+    size_ -= n;
+    if (due_pos_ == due_.size())
+    {
+      // 대량 만료 후 큰 버퍼를 계속 잡고 있지 않도록 해제
+      bytes_ -= due_.capacity() * sizeof(entry);
+      std::vector<entry>().swap(due_);
+      due_pos_ = 0;
+    }
+    return n;
+  }
+
+  void expiry_index::clear()
+  {
+    for (auto &wheel : wheels_)
+    {
+      for (auto &s : wheel)
+      {
+        slot().swap(s);
+      }
+    }
+    occupied_.fill(0);
+    std::vector<entry>().swap(due_);
+    due_pos_ = 0;
+    size_ = 0;
+    bytes_ = 0;
+  }
+} // namespace mini_redis
@@ -0,0 +1,530 @@
+#include "storage/flat_table.hpp"
+#include <algorithm>
+#include <functional>
+#include <new>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MINI_REDIS_FLAT_TABLE_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace mini_redis
+{
+  namespace
+  {
+    constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    inline unsigned count_trailing_zeros(std::uint32_t mask)
+    {
+#if defined(_MSC_VER)
+      unsigned long index;
+      _BitScanForward(&index, mask);
+      return static_cast<unsigned>(index);
+#else
+      return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    // group(16 bytes)의 control byte 중 value와 같은 위치를 bit mask로 반환
+    inline std::uint32_t match_byte(const std::int8_t *group, std::int8_t value)
+    {
+#ifdef MINI_REDIS_FLAT_TABLE_SSE2
+      __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+      return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value))));
+#else
+      std::uint32_t mask = 0;
+      for (std::size_t i = 0; i < flat_table::group_width; ++i)
+      {
+        mask |= static_cast<std::uint32_t>(group[i] == value) << i;
+      }
+      return mask;
+#endif
+    }
+
+    // 빈 슬롯 또는 tombstone(= 부호 bit가 켜진 control byte) 위치를 bit mask로 반환
+    inline std::uint32_t match_empty_or_deleted(const std::int8_t *group)
+    {
+#ifdef MINI_REDIS_FLAT_TABLE_SSE2
+      __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+      return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+      std::uint32_t mask = 0;
+      for (std::size_t i = 0; i < flat_table::group_width; ++i)
+      {
+        mask |= static_cast<std::uint32_t>(group[i] < 0) << i;
+      }
+      return mask;
+#endif
+    }
+  } // namespace
+
+  // ---------------------------------------------------------------------------
+  // flat_table
+  // ---------------------------------------------------------------------------
+
+  flat_table::hash_type flat_table::hash(std::string_view key)
+  {
+    std::uint64_t h = std::hash<std::string_view>{}(key);
+    // MurmurHash3 fmix64: 구현마다 품질이 다른 std::hash 결과의 bit를 고르게 섞어
+    // 하위 7 bits(H2)와 상위 bits(group 선택, shard 선택)가 서로 독립적이 되도록 함
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  flat_table::flat_table(bool slab_allocator)
+      : arena_(slab_allocator ? std::make_unique<slab_arena>() : nullptr)
+  {
+  }
+
+  flat_table::~flat_table()
+  {
+    destroy();
+  }
+
+  flat_table::flat_table(flat_table &&other) noexcept
+      : cur_(other.cur_), old_(other.old_), migrate_pos_(other.migrate_pos_), size_(other.size_),
+        growth_left_(other.growth_left_), key_heap_bytes_(other.key_heap_bytes_),
+        value_heap_bytes_(other.value_heap_bytes_), growth_limited_(other.growth_limited_),
+        arena_(std::move(other.arena_)), index_(std::move(other.index_))
+  {
+    other.cur_ = arrays{};
+    other.old_ = arrays{};
+    other.migrate_pos_ = other.size_ = other.growth_left_ = other.key_heap_bytes_ = other.value_heap_bytes_ = 0;
+  }
+
+  flat_table &flat_table::operator=(flat_table &&other) noexcept
+  {
+    if (this != &other)
+    {
+      destroy();
+      std::swap(cur_, other.cur_);
+      std::swap(old_, other.old_);
+      std::swap(migrate_pos_, other.migrate_pos_);
+      std::swap(size_, other.size_);
+      std::swap(growth_left_, other.growth_left_);
+      std::swap(key_heap_bytes_, other.key_heap_bytes_);
+      std::swap(value_heap_bytes_, other.value_heap_bytes_);
+      std::swap(growth_limited_, other.growth_limited_);
+      std::swap(arena_, other.arena_);
+      std::swap(index_, other.index_);
+    }
+    return *this;
+  }
+
+  flat_table::arrays flat_table::allocate(std::size_t capacity)
+  {
+    arrays t;
+    t.ctrl = new std::int8_t[capacity];
+    std::memset(t.ctrl, static_cast<unsigned char>(ctrl_empty), capacity);
+    t.slots = static_cast<slot *>(::operator new(sizeof(slot) * capacity));
+    t.capacity = capacity;
+    return t;
+  }
+
+  void flat_table::release(arrays &t)
+  {
+    for (std::size_t i = 0; i < t.capacity; ++i)
+    {
+      if (is_full(t.ctrl[i]))
+      {
+        t.slots[i].~slot();
+      }
+    }
+    delete[] t.ctrl;
+    ::operator delete(t.slots);
+    t = arrays{};
+  }
+
+  std::size_t flat_table::find_index(const arrays &t, std::string_view key, hash_type h)
+  {
+    if (t.capacity == 0)
+    {
+      return npos;
+    }
+    const std::size_t group_mask = t.capacity / group_width - 1;
+    const std::int8_t tag = h2(h);
+    std::size_t group = h1(h) & group_mask;
+
+    // 삼각수 probing: 그룹 수가 2의 거듭제곱이면 모든 그룹을 정확히 한 번씩 방문함
+    for (std::size_t step = 1; step <= group_mask + 1; ++step)
+    {
+      const std::int8_t *ctrl = t.ctrl + group * group_width;
+      for (std::uint32_t m = match_byte(ctrl, tag); m != 0; m &= m - 1)
+      {
+        std::size_t index = group * group_width + count_trailing_zeros(m);
+        if (t.slots[index].key.view() == key)
+        {
+          return index;
+        }
+      }
+      // 빈 슬롯이 있는 그룹에서 탐색 종료 (삽입도 이 그룹을 넘어가지 않았음)
+      if (match_byte(ctrl, ctrl_empty) != 0)
+      {
+        return npos;
+      }
+      group = (group + step) & group_mask;
+    }
+    return npos;
+  }
+
+  std::size_t flat_table::find_insert_index(const arrays &t, hash_type h)
+  {
+    const std::size_t group_mask = t.capacity / group_width - 1;
+    std::size_t group = h1(h) & group_mask;
+    for (std::size_t step = 1;; ++step)
+    {
+      std::uint32_t m = match_empty_or_deleted(t.ctrl + group * group_width);
+      if (m != 0)
+      {
+        return group * group_width + count_trailing_zeros(m);
+      }
+      group = (group + step) & group_mask;
+    }
+  }
+
+  value_entry *flat_table::find(std::string_view key, hash_type h)
+  {
+    std::size_t index = find_index(cur_, key, h);
+    if (index != npos)
+    {
+      return &cur_.slots[index].value;
+    }
+    index = find_index(old_, key, h);
+    return index == npos ? nullptr : &old_.slots[index].value;
+  }
+
+  const value_entry *flat_table::find(std::string_view key, hash_type h) const
+  {
+    return const_cast<flat_table *>(this)->find(key, h);
+  }
+
+  std::pair<value_entry *, bool> flat_table::try_emplace(std::string_view key, hash_type h)
+  {
+    if (is_rehashing())
+    {
+      rehash_step(rehash_step_slots);
+    }
+    if (value_entry *existing = find(key, h))
+    {
+      return {existing, false};
+    }
+
+    if (cur_.capacity == 0)
+    {
+      cur_ = allocate(group_width);
+      growth_left_ = group_width - group_width / 8;
+    }
+    std::size_t index = find_insert_index(cur_, h);
+    if (cur_.ctrl[index] == ctrl_empty && growth_left_ == 0)
+    {
+      // 이전 재해시가 아직 끝나지 않았다면(쓰기가 드문 shard) 먼저 마무리
+      finish_rehash();
+      // tombstone이 대부분이면 같은 크기로 정리만 하고, 아니면 두 배로 확장.
+      // 메모리 한도에 가까울 때는 tombstone이 조금만 있어도 그 자리를 재사용
+      const std::size_t reusable = cur_.capacity - cur_.capacity / 8 - size_;
+      const bool same_size = size_ * 16 <= cur_.capacity * 7 ||
+                             (growth_limited_ && reusable >= cur_.capacity / 16);
+      start_rehash(same_size ? cur_.capacity : cur_.capacity * 2);
+      rehash_step(rehash_step_slots);
+      index = find_insert_index(cur_, h);
+    }
+
+    if (cur_.ctrl[index] == ctrl_empty)
+    {
+      --growth_left_;
+    }
+    new (&cur_.slots[index]) slot{compact_key(key, arena_.get()), value_entry{}};
+    cur_.ctrl[index] = h2(h);
+    ++size_;
+    key_heap_bytes_ += cur_.slots[index].key.heap_bytes();
+    if (index_)
+    {
+      index_->insert(key);
+    }
+    return {&cur_.slots[index].value, true};
+  }
+
+  bool flat_table::erase(std::string_view key, hash_type h)
+  {
+    if (is_rehashing())
+    {
+      rehash_step(rehash_step_slots);
+    }
+    std::size_t index = find_index(cur_, key, h);
+    if (index != npos)
+    {
+      erase_at(cur_, index);
+      return true;
+    }
+    index = find_index(old_, key, h);
+    if (index != npos)
+    {
+      erase_at(old_, index);
+      return true;
+    }
+    return false;
+  }
+
+  bool flat_table::erase_expired(hash_type h, std::int64_t now_ms)
+  {
+    const std::int8_t tag = h2(h);
+    for (arrays *t : {&cur_, &old_})
+    {
+      if (t->capacity == 0)
+      {
+        continue;
+      }
+      const std::size_t group_mask = t->capacity / group_width - 1;
+      std::size_t group = h1(h) & group_mask;
+      for (std::size_t step = 1; step <= group_mask + 1; ++step)
+      {
+        const std::int8_t *ctrl = t->ctrl + group * group_width;
+        for (std::uint32_t m = match_byte(ctrl, tag); m != 0; m &= m - 1)
+        {
+          std::size_t index = group * group_width + count_trailing_zeros(m);
+          const slot &s = t->slots[index];
+          // H2가 같은 다른 키일 수 있으므로 전체 해시를 다시 계산해서 확인
+          if (s.value.has_expiry() && s.value.expiry < now_ms && hash(s.key.view()) == h)
+          {
+            erase_at(*t, index);
+            return true;
+          }
+        }
+        if (match_byte(ctrl, ctrl_empty) != 0)
+        {
+          break;
+        }
+        group = (group + step) & group_mask;
+      }
+    }
+    return false;
+  }
+
+  void flat_table::erase_at(arrays &t, std::size_t index)
+  {
+    key_heap_bytes_ -= t.slots[index].key.heap_bytes();
+    value_heap_bytes_ -= value_memory(t.slots[index].value.value);
+    if (index_)
+    {
+      index_->erase(t.slots[index].key.view());
+    }
+    t.slots[index].~slot();
+    --size_;
+
+    if (&t == &old_)
+    {
+      // old_는 조회만 하므로 항상 tombstone으로 남겨 다른 키의 탐색 경로를 유지하고,
+      // 이 키가 옮겨질 자리로 예약해 둔 cur_의 여유분을 돌려받음
+      t.ctrl[index] = ctrl_deleted;
+      ++growth_left_;
+      return;
+    }
+
+    // 같은 그룹에 빈 슬롯이 이미 있으면 탐색이 이 그룹에서 멈추므로 tombstone 없이 비워도 안전
+    const std::int8_t *group = t.ctrl + (index / group_width) * group_width;
+    if (match_byte(group, ctrl_empty) != 0)
+    {
+      t.ctrl[index] = ctrl_empty;
+      ++growth_left_;
+    }
+    else
+    {
+      t.ctrl[index] = ctrl_deleted;
+    }
+  }
+
+  void flat_table::start_rehash(std::size_t new_capacity)
+  {
+    old_ = cur_;
+    cur_ = allocate(new_capacity);
+    migrate_pos_ = 0;
+    // old_의 모든 키가 결국 cur_로 옮겨질 것이므로 그만큼을 미리 예약
+    growth_left_ = new_capacity - new_capacity / 8 - size_;
+  }
+
+  bool flat_table::rehash_step(std::size_t max_slots)
+  {
+    if (!is_rehashing())
+    {
+      return false;
+    }
+
+    const std::size_t end = std::min(old_.capacity, migrate_pos_ + max_slots);
+    for (; migrate_pos_ < end; ++migrate_pos_)
+    {
+      std::int8_t &c = old_.ctrl[migrate_pos_];
+      if (!is_full(c))
+      {
+        continue;
+      }
+      slot &from = old_.slots[migrate_pos_];
+      hash_type h = hash(from.key.view());
+      std::size_t index = find_insert_index(cur_, h);
+      if (cur_.ctrl[index] == ctrl_deleted)
+      {
+        // 예약해 둔 빈 슬롯 대신 tombstone을 재사용했으므로 여유분이 하나 늘어남
+        ++growth_left_;
+      }
+      new (&cur_.slots[index]) slot(std::move(from));
+      cur_.ctrl[index] = h2(h);
+      from.~slot();
+      // 아직 옮기지 않은 키의 탐색 경로가 끊기지 않도록 빈 슬롯이 아닌 tombstone으로 표시
+      c = ctrl_deleted;
+    }
+
+    if (migrate_pos_ == old_.capacity)
+    {
+      release(old_);
+      migrate_pos_ = 0;
+      return false;
+    }
+    return true;
+  }
+
+  void flat_table::finish_rehash()
+  {
+    while (rehash_step(old_.capacity))
+    {
+    }
+  }
+
+  void flat_table::reserve(std::size_t n)
+  {
+    std::size_t capacity = group_width;
+    while (capacity - capacity / 8 < n)
+    {
+      capacity *= 2;
+    }
+    if (capacity > cur_.capacity)
+    {
+      // 미리 크기를 잡는 용도(대량 적재 전 등)이므로 증분 없이 즉시 옮김
+      finish_rehash();
+      start_rehash(capacity);
+      finish_rehash();
+    }
+  }
+
+  bool flat_table::shrink_to_fit()
+  {
+    if (is_rehashing() || cur_.capacity <= group_width || size_ * 10 >= cur_.capacity)
+    {
+      return false;
+    }
+    if (size_ == 0)
+    {
+      destroy();
+      return true;
+    }
+    // reserve와 같은 크기 기준. 축소 조건(10% 미만)과의 차이가 커서 확장/축소가 반복되지는 않음
+    std::size_t capacity = group_width;
+    while (capacity - capacity / 8 < size_)
+    {
+      capacity *= 2;
+    }
+    if (capacity >= cur_.capacity)
+    {
+      return false;
+    }
+    start_rehash(capacity);
+    rehash_step(rehash_step_slots);
+    return true;
+  }
+
+  void flat_table::clear()
+  {
+    destroy();
+  }
+
+  void flat_table::destroy()
+  {
+    release(cur_);
+    release(old_);
+    migrate_pos_ = size_ = growth_left_ = key_heap_bytes_ = value_heap_bytes_ = 0;
+    if (index_)
+    {
+      index_->clear();
+    }
+  }
+
+  void flat_table::enable_key_index()
+  {
+    if (index_)
+    {
+      return;
+    }
+    index_ = std::make_unique<radix_tree>();
+    for_each([this](std::string_view key, const value_entry &) { index_->insert(key); });
+  }
+
+  std::size_t flat_table::memory_usage() const
+  {
+    // 키와 값의 slab 할당은 크기 등급만큼 key/value_heap_bytes_에 들어 있고, slab의 나머지는 free_bytes
+    const std::size_t slab_free = arena_ ? arena_->get_stats().free_bytes() : 0;
+    return (cur_.capacity + old_.capacity) * (sizeof(std::int8_t) + sizeof(slot)) + key_heap_bytes_ +
+           value_heap_bytes_ + slab_free + (index_ ? index_->memory_usage() : 0);
+  }
+
+  std::size_t flat_table::reusable_bytes() const
+  {
+    // 재해시 중에도 모든 키는 결국 cur_로 옮겨지므로 cur_ 기준으로 계산
+    const std::size_t usable = cur_.capacity - cur_.capacity / 8;
+    const std::size_t free_slots = usable > size_ ? (usable - size_) * (sizeof(std::int8_t) + sizeof(slot)) : 0;
+    return free_slots + (arena_ ? arena_->get_stats().free_bytes() : 0);
+  }
+
+  std::uint64_t flat_table::next_scan_cursor(std::uint64_t cursor, std::uint64_t mask)
+  {
+    auto reverse = [](std::uint64_t v)
+    {
+      v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+      v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+      v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+      v = ((v >> 8) & 0x00FF00FF00FF00FFULL) | ((v & 0x00FF00FF00FF00FFULL) << 8);
+      v = ((v >> 16) & 0x0000FFFF0000FFFFULL) | ((v & 0x0000FFFF0000FFFFULL) << 16);
+      return (v >> 32) | (v << 32);
+    };
+    cursor |= ~mask;
+    cursor = reverse(cursor);
+    ++cursor;
+    return reverse(cursor);
+  }
+
+  std::size_t flat_table::defrag(std::size_t cursor, std::size_t max_slots)
+  {
+    // 재해시 중에는 키가 두 배열에 나뉘어 있으므로 끝날 때까지 미룸 (같은 cursor를 반환)
+    if (!arena_ || is_rehashing())
+    {
+      return arena_ ? cursor : 0;
+    }
+    std::size_t i = cursor;
+    for (std::size_t visited = 0; i < cur_.capacity && visited < max_slots; ++i, ++visited)
+    {
+      if (!is_full(cur_.ctrl[i]))
+      {
+        continue;
+      }
+      slot &s = cur_.slots[i];
+      if (s.key.in_arena() && arena_->should_move(s.key.data()))
+      {
+        // 새로 할당한 뒤 이전 객체를 해제하므로 크기 등급과 heap bytes는 그대로
+        s.key = compact_key(s.key.view(), arena_.get());
+      }
+      if (auto *str = std::get_if<RedisString>(&s.value.value))
+      {
+        if (str->in_arena() && arena_->should_move(str->data()))
+        {
+          *str = RedisString(str->view(), arena_.get());
+        }
+      }
+    }
+    return i >= cur_.capacity ? 0 : i;
+  }
+} // namespace mini_redis
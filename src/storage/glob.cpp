@@ -0,0 +1,405 @@
+#include "storage/glob.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MINI_REDIS_GLOB_SSE2 1
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace mini_redis
+{
+  namespace
+  {
+    inline unsigned count_trailing_zeros(std::uint32_t mask)
+    {
+#if defined(_MSC_VER)
+      unsigned long index;
+      _BitScanForward(&index, mask);
+      return static_cast<unsigned>(index);
+#else
+      return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    // 이보다 긴 패턴은 캐시하지 않음 (클라이언트가 보낸 긴 패턴으로 캐시가 커지지 않도록)
+    constexpr std::size_t max_cached_pattern = 1024;
+  } // namespace
+
+  // ---------------------------------------------------------------------------
+  // find_literal
+  // ---------------------------------------------------------------------------
+
+  std::size_t find_literal(std::string_view haystack, std::string_view needle)
+  {
+    const std::size_t n = needle.size();
+    if (n == 0)
+    {
+      return 0;
+    }
+    if (n > haystack.size())
+    {
+      return std::string_view::npos;
+    }
+    if (n == 1)
+    {
+      const void *p = std::memchr(haystack.data(), needle[0], haystack.size());
+      return p ? static_cast<const char *>(p) - haystack.data() : std::string_view::npos;
+    }
+
+    // 후보 위치마다 needle의 첫 byte와 마지막 byte를 한 번에 비교하고, 둘 다 맞는 위치만 전체 비교
+    const char *h = haystack.data();
+    std::size_t i = 0;
+#ifdef __AVX2__
+    {
+      const __m256i first = _mm256_set1_epi8(needle[0]);
+      const __m256i last = _mm256_set1_epi8(needle[n - 1]);
+      for (; i + n - 1 + 32 <= haystack.size(); i += 32)
+      {
+        const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + i));
+        const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + i + n - 1));
+        auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+        for (; mask != 0; mask &= mask - 1)
+        {
+          const std::size_t pos = i + count_trailing_zeros(mask);
+          if (std::memcmp(h + pos + 1, needle.data() + 1, n - 2) == 0)
+          {
+            return pos;
+          }
+        }
+      }
+    }
+#endif
+#ifdef MINI_REDIS_GLOB_SSE2
+    {
+      const __m128i first = _mm_set1_epi8(needle[0]);
+      const __m128i last = _mm_set1_epi8(needle[n - 1]);
+      for (; i + n - 1 + 16 <= haystack.size(); i += 16)
+      {
+        const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i));
+        const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i + n - 1));
+        auto mask = static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+        for (; mask != 0; mask &= mask - 1)
+        {
+          const std::size_t pos = i + count_trailing_zeros(mask);
+          if (std::memcmp(h + pos + 1, needle.data() + 1, n - 2) == 0)
+          {
+            return pos;
+          }
+        }
+      }
+    }
+#endif
+    const std::size_t rest = haystack.substr(i).find(needle);
+    return rest == std::string_view::npos ? rest : i + rest;
+  }
+
+  // ---------------------------------------------------------------------------
+  // glob_pattern
+  // ---------------------------------------------------------------------------
+
+  glob_pattern::glob_pattern(std::string_view pattern) : source_(pattern)
+  {
+    compile(pattern);
+  }
+
+  void glob_pattern::push_literal(char c)
+  {
+    segment &seg = segments_.back();
+    if (seg.count > 0 && program_.back().kind == op::literal)
+    {
+      // 리터럴은 literals_ 끝에 차례로 붙이므로 직전 리터럴 명령을 늘리기만 하면 됨
+      ++program_.back().length;
+    }
+    else
+    {
+      program_.push_back({op::literal, static_cast<std::uint32_t>(literals_.size()), 1});
+      ++seg.count;
+    }
+    literals_ += c;
+    ++seg.width;
+  }
+
+  void glob_pattern::close_segment()
+  {
+    // 가장 긴 리터럴을 검색에 사용 (길수록 후보 위치가 적음)
+    segment &seg = segments_.back();
+    seg.literal_index = seg.count;
+    std::size_t best = 0;
+    std::size_t skip = 0;
+    for (std::uint32_t i = 0; i < seg.count; ++i)
+    {
+      const instr &in = program_[seg.first + i];
+      if (in.kind == op::literal && in.length > best)
+      {
+        best = in.length;
+        seg.literal_index = i;
+        seg.literal_skip = skip;
+      }
+      skip += in.kind == op::literal || in.kind == op::any_char ? in.length : 1;
+    }
+  }
+
+  void glob_pattern::compile(std::string_view p)
+  {
+    segments_.push_back({});
+    std::size_t i = 0;
+    while (i < p.size())
+    {
+      const char c = p[i];
+      if (c == '*')
+      {
+        has_star_ = true;
+        close_segment();
+        while (i < p.size() && p[i] == '*')
+        {
+          ++i;
+        }
+        segments_.push_back({});
+        segments_.back().first = static_cast<std::uint32_t>(program_.size());
+        continue;
+      }
+      if (c == '?')
+      {
+        segment &seg = segments_.back();
+        if (seg.count > 0 && program_.back().kind == op::any_char)
+        {
+          ++program_.back().length;
+        }
+        else
+        {
+          program_.push_back({op::any_char, 0, 1});
+          ++seg.count;
+        }
+        ++seg.width;
+        ++i;
+        continue;
+      }
+      if (c == '\\' && i + 1 < p.size())
+      {
+        push_literal(p[i + 1]);
+        i += 2;
+        continue;
+      }
+      if (c != '[')
+      {
+        push_literal(c);
+        ++i;
+        continue;
+      }
+
+      // 문자 집합: [^...]는 부정, a-z는 범위(거꾸로 쓴 범위도 허용), ]가 없으면 패턴 끝까지
+      byte_set set{};
+      auto add = [&set](unsigned char b) { set[b >> 6] |= std::uint64_t(1) << (b & 63); };
+      ++i;
+      const bool negate = i < p.size() && p[i] == '^';
+      if (negate)
+      {
+        ++i;
+      }
+      while (i < p.size() && p[i] != ']')
+      {
+        if (p[i] == '\\' && i + 1 < p.size())
+        {
+          add(static_cast<unsigned char>(p[i + 1]));
+          i += 2;
+        }
+        else if (i + 2 < p.size() && p[i + 1] == '-')
+        {
+          auto lo = static_cast<unsigned char>(p[i]);
+          auto hi = static_cast<unsigned char>(p[i + 2]);
+          if (lo > hi)
+          {
+            std::swap(lo, hi);
+          }
+          for (unsigned b = lo; b <= hi; ++b)
+          {
+            add(static_cast<unsigned char>(b));
+          }
+          i += 3;
+        }
+        else
+        {
+          add(static_cast<unsigned char>(p[i]));
+          ++i;
+        }
+      }
+      ++i; // ']'
+      if (negate)
+      {
+        for (auto &word : set)
+        {
+          word = ~word;
+        }
+      }
+      program_.push_back({op::char_set, static_cast<std::uint32_t>(sets_.size()), 1});
+      sets_.push_back(set);
+      ++segments_.back().count;
+      ++segments_.back().width;
+    }
+    close_segment();
+
+    const segment &head = segments_.front();
+    if (head.count > 0 && program_[0].kind == op::literal)
+    {
+      prefix_ = literals_.substr(program_[0].offset, program_[0].length);
+    }
+    matches_all_ = has_star_ && std::all_of(segments_.begin(), segments_.end(),
+                                            [](const segment &seg) { return seg.count == 0; });
+  }
+
+  bool glob_pattern::match_segment(const segment &seg, const char *text) const
+  {
+    for (std::uint32_t i = 0; i < seg.count; ++i)
+    {
+      const instr &in = program_[seg.first + i];
+      switch (in.kind)
+      {
+      case op::literal:
+        if (std::memcmp(text, literals_.data() + in.offset, in.length) != 0)
+        {
+          return false;
+        }
+        text += in.length;
+        break;
+      case op::any_char:
+        text += in.length;
+        break;
+      case op::char_set:
+      {
+        const auto b = static_cast<unsigned char>(*text++);
+        if (!(sets_[in.offset][b >> 6] >> (b & 63) & 1))
+        {
+          return false;
+        }
+        break;
+      }
+      }
+    }
+    return true;
+  }
+
+  std::size_t glob_pattern::find_segment(const segment &seg, std::string_view text, std::size_t from) const
+  {
+    if (seg.literal_index == seg.count)
+    {
+      // 리터럴이 없는 조각(?, [..]만)은 위치마다 확인
+      for (std::size_t pos = from; pos + seg.width <= text.size(); ++pos)
+      {
+        if (match_segment(seg, text.data() + pos))
+        {
+          return pos;
+        }
+      }
+      return std::string_view::npos;
+    }
+    const instr &lit = program_[seg.first + seg.literal_index];
+    const std::string_view needle(literals_.data() + lit.offset, lit.length);
+    std::size_t search = from + seg.literal_skip;
+    while (search + (seg.width - seg.literal_skip) <= text.size())
+    {
+      const std::size_t found = find_literal(text.substr(search), needle);
+      if (found == std::string_view::npos)
+      {
+        return found;
+      }
+      const std::size_t start = search + found - seg.literal_skip;
+      if (start + seg.width > text.size())
+      {
+        return std::string_view::npos;
+      }
+      if (match_segment(seg, text.data() + start))
+      {
+        return start;
+      }
+      search += found + 1;
+    }
+    return std::string_view::npos;
+  }
+
+  bool glob_pattern::match(std::string_view text) const
+  {
+    if (matches_all_)
+    {
+      return true;
+    }
+    const segment &head = segments_.front();
+    if (!has_star_)
+    {
+      return text.size() == head.width && match_segment(head, text.data());
+    }
+    const segment &tail = segments_.back();
+    if (text.size() < head.width + tail.width || !match_segment(head, text.data()) ||
+        !match_segment(tail, text.data() + text.size() - tail.width))
+    {
+      return false;
+    }
+    // 가운데 조각은 왼쪽부터 처음 일치하는 곳을 고르면 됨: 더 뒤에서 일치시켜도 남는 문자열만 줄어듦
+    const std::string_view body = text.substr(0, text.size() - tail.width);
+    std::size_t pos = head.width;
+    for (std::size_t s = 1; s + 1 < segments_.size(); ++s)
+    {
+      const std::size_t found = find_segment(segments_[s], body, pos);
+      if (found == std::string_view::npos)
+      {
+        return false;
+      }
+      pos = found + segments_[s].width;
+    }
+    return true;
+  }
+
+  // ---------------------------------------------------------------------------
+  // glob_cache
+  // ---------------------------------------------------------------------------
+
+  std::shared_ptr<const glob_pattern> glob_cache::get(const std::string &pattern)
+  {
+    if (pattern.size() > max_cached_pattern)
+    {
+      return std::make_shared<const glob_pattern>(pattern);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(pattern);
+      if (it != index_.end())
+      {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+      }
+    }
+    // 컴파일은 잠금 밖에서. 다른 스레드가 같은 패턴을 먼저 넣었으면 그것을 사용
+    auto compiled = std::make_shared<const glob_pattern>(pattern);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(pattern);
+    if (it != index_.end())
+    {
+      return it->second->second;
+    }
+    lru_.emplace_front(pattern, compiled);
+    index_.emplace(pattern, lru_.begin());
+    if (lru_.size() > capacity_)
+    {
+      index_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+    return compiled;
+  }
+
+  std::size_t glob_cache::size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+  }
+
+  glob_cache &glob_cache::global()
+  {
+    static glob_cache cache;
+    return cache;
+  }
+} // namespace mini_redis
@@ -0,0 +1,431 @@
+#include "storage/hyperloglog.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MINI_REDIS_HLL_SSE2 1
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace mini_redis
+{
+  namespace
+  {
+    constexpr double alpha_inf = 0.721347520444481703680; // 1 / (2 ln 2)
+    constexpr unsigned histogram_size = 64;
+
+    /*
+     * dense 인코딩의 register 배치 (Redis와 같음): register i는 bit 6i부터 6 bits,
+     * 각 byte 안에서는 하위 bit부터 채움. 그래서 3 bytes마다 register 4개가 딱 맞게 들어감.
+     */
+    std::uint8_t get_dense(const std::uint8_t *p, std::uint32_t index)
+    {
+      const std::size_t bit = std::size_t(index) * 6;
+      const unsigned shift = bit & 7;
+      const unsigned word = p[bit >> 3] | (unsigned(p[(bit >> 3) + 1]) << 8);
+      return static_cast<std::uint8_t>((word >> shift) & 63);
+    }
+
+    void set_dense(std::uint8_t *p, std::uint32_t index, std::uint8_t value)
+    {
+      const std::size_t bit = std::size_t(index) * 6;
+      const unsigned shift = bit & 7;
+      std::uint8_t *byte = p + (bit >> 3);
+      unsigned word = byte[0] | (unsigned(byte[1]) << 8);
+      word = (word & ~(63u << shift)) | (unsigned(value) << shift);
+      byte[0] = static_cast<std::uint8_t>(word);
+      byte[1] = static_cast<std::uint8_t>(word >> 8);
+    }
+
+    // dense 배열을 register당 1 byte로 펼침 (3 bytes -> register 4개)
+    void unpack(const std::uint8_t *p, std::uint8_t *out)
+    {
+      for (std::size_t g = 0; g < hyperloglog::register_count / 4; ++g, p += 3, out += 4)
+      {
+        const unsigned b0 = p[0], b1 = p[1], b2 = p[2];
+        out[0] = static_cast<std::uint8_t>(b0 & 63);
+        out[1] = static_cast<std::uint8_t>(((b0 >> 6) | (b1 << 2)) & 63);
+        out[2] = static_cast<std::uint8_t>(((b1 >> 4) | (b2 << 4)) & 63);
+        out[3] = static_cast<std::uint8_t>(b2 >> 2);
+      }
+    }
+
+    void pack(const std::uint8_t *in, std::uint8_t *p)
+    {
+      for (std::size_t g = 0; g < hyperloglog::register_count / 4; ++g, p += 3, in += 4)
+      {
+        p[0] = static_cast<std::uint8_t>(in[0] | (in[1] << 6));
+        p[1] = static_cast<std::uint8_t>((in[1] >> 2) | (in[2] << 4));
+        p[2] = static_cast<std::uint8_t>((in[2] >> 4) | (in[3] << 2));
+      }
+    }
+
+    // dst[i] = max(dst[i], src[i])
+    void max_bytes(std::uint8_t *dst, const std::uint8_t *src, std::size_t n)
+    {
+      std::size_t i = 0;
+#ifdef __AVX2__
+      for (; i + 32 <= n; i += 32)
+      {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_max_epu8(a, b));
+      }
+#endif
+#ifdef MINI_REDIS_HLL_SSE2
+      for (; i + 16 <= n; i += 16)
+      {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_max_epu8(a, b));
+      }
+#endif
+      for (; i < n; ++i)
+      {
+        dst[i] = std::max(dst[i], src[i]);
+      }
+    }
+
+    /*
+     * Ertl의 개선된 추정식 ("New cardinality estimation algorithms for HyperLogLog sketches",
+     * Redis 5부터 쓰는 방식). 작은 집합의 linear counting 보정과 큰 집합의 편향 보정이 따로 필요 없음.
+     */
+    double sigma(double x)
+    {
+      if (x == 1.0)
+      {
+        return std::numeric_limits<double>::infinity();
+      }
+      double y = 1.0, z = x, previous;
+      do
+      {
+        x *= x;
+        previous = z;
+        z += x * y;
+        y += y;
+      } while (previous != z);
+      return z;
+    }
+
+    double tau(double x)
+    {
+      if (x == 0.0 || x == 1.0)
+      {
+        return 0.0;
+      }
+      double y = 1.0, z = 1 - x, previous;
+      do
+      {
+        x = std::sqrt(x);
+        previous = z;
+        y *= 0.5;
+        z -= (1 - x) * (1 - x) * y;
+      } while (previous != z);
+      return z / 3;
+    }
+  } // namespace
+
+  hyperloglog::hyperloglog(const hyperloglog &other)
+      : sparse_(other.sparse_), opts_(other.opts_), cached_(other.cached_.load(std::memory_order_relaxed))
+  {
+    if (other.dense_)
+    {
+      dense_.reset(new std::uint8_t[dense_bytes + 1]);
+      std::memcpy(dense_.get(), other.dense_.get(), dense_bytes + 1);
+    }
+  }
+
+  hyperloglog &hyperloglog::operator=(const hyperloglog &other)
+  {
+    if (this != &other)
+    {
+      hyperloglog copy(other);
+      sparse_ = std::move(copy.sparse_);
+      dense_ = std::move(copy.dense_);
+      opts_ = copy.opts_;
+      cached_.store(copy.cached_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    return *this;
+  }
+
+  std::uint64_t hyperloglog::hash(std::string_view element)
+  {
+    // MurmurHash64A (8 bytes 블록은 little-endian으로 읽음)
+    constexpr std::uint64_t m = 0xc6a4a7935bd1e995ULL;
+    constexpr int r = 47;
+    const std::size_t len = element.size();
+    const auto *data = reinterpret_cast<const unsigned char *>(element.data());
+    std::uint64_t h = 0xadc83b19ULL ^ (len * m);
+
+    const unsigned char *end = data + (len & ~std::size_t(7));
+    for (; data != end; data += 8)
+    {
+      std::uint64_t k = 0;
+      for (int i = 7; i >= 0; --i)
+      {
+        k = (k << 8) | data[i];
+      }
+      k *= m;
+      k ^= k >> r;
+      k *= m;
+      h ^= k;
+      h *= m;
+    }
+    switch (len & 7)
+    {
+    case 7:
+      h ^= std::uint64_t(data[6]) << 48;
+      [[fallthrough]];
+    case 6:
+      h ^= std::uint64_t(data[5]) << 40;
+      [[fallthrough]];
+    case 5:
+      h ^= std::uint64_t(data[4]) << 32;
+      [[fallthrough]];
+    case 4:
+      h ^= std::uint64_t(data[3]) << 24;
+      [[fallthrough]];
+    case 3:
+      h ^= std::uint64_t(data[2]) << 16;
+      [[fallthrough]];
+    case 2:
+      h ^= std::uint64_t(data[1]) << 8;
+      [[fallthrough]];
+    case 1:
+      h ^= std::uint64_t(data[0]);
+      h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+  }
+
+  void hyperloglog::split_hash(std::uint64_t h, std::uint32_t &index, std::uint8_t &rank)
+  {
+    index = static_cast<std::uint32_t>(h & (register_count - 1));
+    // index를 뺀 나머지 bits에서 처음 1이 나오는 위치 (모두 0이어도 max_rank에서 멈추도록 경계 bit를 둠)
+    h = (h >> precision) | (std::uint64_t(1) << (64 - precision));
+    rank = 1;
+    while ((h & 1) == 0)
+    {
+      ++rank;
+      h >>= 1;
+    }
+  }
+
+  bool hyperloglog::add(std::string_view element)
+  {
+    std::uint32_t index;
+    std::uint8_t rank;
+    split_hash(hash(element), index, rank);
+    return set_register(index, rank);
+  }
+
+  bool hyperloglog::set_register(std::uint32_t index, std::uint8_t rank)
+  {
+    if (dense_)
+    {
+      if (get_dense(dense_.get(), index) >= rank)
+      {
+        return false;
+      }
+      set_dense(dense_.get(), index, rank);
+      cached_.store(no_cache, std::memory_order_relaxed);
+      return true;
+    }
+
+    const std::uint32_t key = index << 8;
+    auto it = std::lower_bound(sparse_.begin(), sparse_.end(), key);
+    if (it != sparse_.end() && (*it >> 8) == index)
+    {
+      if ((*it & 0xff) >= rank)
+      {
+        return false;
+      }
+      *it = key | rank;
+    }
+    else
+    {
+      sparse_.insert(it, key | rank);
+      if (sparse_.size() * sizeof(std::uint32_t) > opts_.sparse_max_bytes)
+      {
+        convert_to_dense();
+      }
+    }
+    cached_.store(no_cache, std::memory_order_relaxed);
+    return true;
+  }
+
+  void hyperloglog::convert_to_dense()
+  {
+    // 마지막 register를 읽고 쓸 때 다음 byte까지 한 번에 다루므로 1 byte 여유를 둠
+    dense_.reset(new std::uint8_t[dense_bytes + 1]());
+    for (std::uint32_t entry : sparse_)
+    {
+      set_dense(dense_.get(), entry >> 8, static_cast<std::uint8_t>(entry & 0xff));
+    }
+    sparse_.clear();
+    sparse_.shrink_to_fit();
+  }
+
+  std::uint64_t hyperloglog::count() const
+  {
+    // 공유 잠금 아래에서 여러 reader가 동시에 계산해도 같은 값을 저장하므로 relaxed로 충분함
+    std::uint64_t cached = cached_.load(std::memory_order_relaxed);
+    if (cached != no_cache)
+    {
+      return cached;
+    }
+    std::uint32_t histogram[histogram_size] = {};
+    if (dense_)
+    {
+      const std::uint8_t *p = dense_.get();
+      for (std::size_t g = 0; g < register_count / 4; ++g, p += 3)
+      {
+        const unsigned b0 = p[0], b1 = p[1], b2 = p[2];
+        ++histogram[b0 & 63];
+        ++histogram[((b0 >> 6) | (b1 << 2)) & 63];
+        ++histogram[((b1 >> 4) | (b2 << 4)) & 63];
+        ++histogram[b2 >> 2];
+      }
+    }
+    else
+    {
+      histogram[0] = static_cast<std::uint32_t>(register_count - sparse_.size());
+      for (std::uint32_t entry : sparse_)
+      {
+        ++histogram[entry & 0xff];
+      }
+    }
+    cached = estimate_from_histogram(histogram);
+    cached_.store(cached, std::memory_order_relaxed);
+    return cached;
+  }
+
+  std::uint64_t hyperloglog::estimate_from_histogram(const std::uint32_t *histogram)
+  {
+    const double m = static_cast<double>(register_count);
+    constexpr unsigned q = 64 - precision;
+    double z = m * tau((m - histogram[q + 1]) / m);
+    for (unsigned j = q; j >= 1; --j)
+    {
+      z += histogram[j];
+      z *= 0.5;
+    }
+    z += m * sigma(histogram[0] / m);
+    return static_cast<std::uint64_t>(std::llround(alpha_inf * m * m / z));
+  }
+
+  std::uint64_t hyperloglog::estimate(const raw_registers &raw)
+  {
+    std::uint32_t histogram[histogram_size] = {};
+    for (std::uint8_t value : raw)
+    {
+      ++histogram[value];
+    }
+    return estimate_from_histogram(histogram);
+  }
+
+  void hyperloglog::merge_into(raw_registers &raw) const
+  {
+    if (dense_)
+    {
+      std::uint8_t registers[register_count];
+      unpack(dense_.get(), registers);
+      max_bytes(raw.data(), registers, register_count);
+      return;
+    }
+    for (std::uint32_t entry : sparse_)
+    {
+      auto &value = raw[entry >> 8];
+      value = std::max(value, static_cast<std::uint8_t>(entry & 0xff));
+    }
+  }
+
+  void hyperloglog::merge_from(const raw_registers &raw)
+  {
+    raw_registers merged(raw);
+    merge_into(merged);
+    if (!dense_)
+    {
+      dense_.reset(new std::uint8_t[dense_bytes + 1]());
+      sparse_.clear();
+      sparse_.shrink_to_fit();
+    }
+    pack(merged.data(), dense_.get());
+    cached_.store(no_cache, std::memory_order_relaxed);
+  }
+
+  void hyperloglog::serialize(std::string &out) const
+  {
+    if (dense_)
+    {
+      out += '\1';
+      out.append(reinterpret_cast<const char *>(dense_.get()), dense_bytes);
+      return;
+    }
+    out += '\0';
+    for (std::uint32_t entry : sparse_)
+    {
+      for (int i = 0; i < 4; ++i)
+      {
+        out += static_cast<char>((entry >> (8 * i)) & 0xff);
+      }
+    }
+  }
+
+  bool hyperloglog::deserialize(std::string_view data)
+  {
+    if (data.empty())
+    {
+      return false;
+    }
+    const auto *p = reinterpret_cast<const std::uint8_t *>(data.data()) + 1;
+    const std::size_t size = data.size() - 1;
+    if (data[0] == 1)
+    {
+      if (size != dense_bytes)
+      {
+        return false;
+      }
+      // 마지막 register를 읽을 때 한 byte를 더 보므로 배열은 dense_bytes + 1 크기
+      dense_.reset(new std::uint8_t[dense_bytes + 1]());
+      std::memcpy(dense_.get(), p, dense_bytes);
+      sparse_.clear();
+      sparse_.shrink_to_fit();
+    }
+    else
+    {
+      if (data[0] != 0 || size % 4 != 0)
+      {
+        return false;
+      }
+      std::vector<std::uint32_t> entries(size / 4);
+      for (std::size_t i = 0; i < entries.size(); ++i, p += 4)
+      {
+        entries[i] = p[0] | (std::uint32_t(p[1]) << 8) | (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+        // index 순서로 중복 없이, 값은 1..max_rank
+        const std::uint32_t index = entries[i] >> 8, rank = entries[i] & 0xff;
+        if (index >= register_count || rank == 0 || rank > max_rank || (i > 0 && index <= (entries[i - 1] >> 8)))
+        {
+          return false;
+        }
+      }
+      sparse_ = std::move(entries);
+      dense_.reset();
+    }
+    cached_.store(no_cache, std::memory_order_relaxed);
+    return true;
+  }
+
+  std::size_t hyperloglog::memory_usage() const
+  {
+    return sizeof(hyperloglog) + sparse_.capacity() * sizeof(std::uint32_t) + (dense_ ? dense_bytes + 1 : 0);
+  }
+} // namespace mini_redis
@@ -0,0 +1,465 @@
+#include "storage/intset.hpp"
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MINI_REDIS_INTSET_SSE2 1
+#endif
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace mini_redis
+{
+  namespace
+  {
+    /*
+     * 결과를 미리 충분히 잡아 둔 배열에 차례로 쓰는 출력 위치.
+     * 조건부 추가를 분기 없이 (항상 쓰고 조건이 참일 때만 위치를 옮기는 방식으로) 처리함.
+     */
+    template <typename T>
+    struct sink
+    {
+      T *first;
+      T *last;
+
+      void push_if(T value, bool keep)
+      {
+        *last = value;
+        last += keep;
+      }
+      // 직전에 쓴 값과 같으면 건너뜀 (합집합의 중복 제거)
+      void push_unique(T value) { push_if(value, last == first || last[-1] != value); }
+    };
+
+    /*
+     * 정렬된 두 배열 a, b를 블록 단위로 비교하는 교집합/차집합 kernel.
+     * a의 블록 하나를 b의 블록과 모든 회전(rotation) 위치에서 한꺼번에 비교해 a의 어느 원소가
+     * b에 있는지를 found bit로 모으고, 최댓값이 더 작은 쪽 블록을 앞으로 옮김.
+     * a 블록이 넘어갈 때 found를 보고 원소를 내보냄 (교집합은 찾은 것, 차집합은 못 찾은 것).
+     * found는 항상 a[i]를 bit 0으로 하는 상대 위치이므로, 블록 폭이 다른 단계(AVX2 -> SSE2 -> scalar)로
+     * 넘어가도 그대로 이어서 쓸 수 있음.
+     */
+    template <typename T>
+    inline void emit_block(const T *block, std::size_t width, std::uint32_t found, bool keep_matched, sink<T> &out)
+    {
+      for (std::size_t lane = 0; lane < width; ++lane)
+      {
+        out.push_if(block[lane], ((found >> lane) & 1) == static_cast<std::uint32_t>(keep_matched));
+      }
+    }
+
+    template <typename T>
+    void match_tail(const T *a, std::size_t na, const T *b, std::size_t nb, std::size_t i, std::size_t j,
+                    std::uint32_t found, bool keep_matched, sink<T> &out)
+    {
+      for (std::size_t k = i; k < na; ++k)
+      {
+        while (j < nb && b[j] < a[k])
+        {
+          ++j;
+        }
+        const bool matched = (j < nb && b[j] == a[k]) || (k - i < 32 && ((found >> (k - i)) & 1));
+        out.push_if(a[k], matched == keep_matched);
+      }
+    }
+
+    void match32(const std::int32_t *a, std::size_t na, const std::int32_t *b, std::size_t nb, bool keep_matched,
+                 sink<std::int32_t> &out)
+    {
+      std::size_t i = 0, j = 0;
+      std::uint32_t found = 0;
+#ifdef __AVX2__
+      {
+        const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+        while (i + 8 <= na && j + 8 <= nb)
+        {
+          const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+          __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j));
+          __m256i eq = _mm256_cmpeq_epi32(va, vb);
+          for (int r = 1; r < 8; ++r)
+          {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+          }
+          found |= static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+          const std::int32_t amax = a[i + 7], bmax = b[j + 7];
+          if (amax <= bmax)
+          {
+            emit_block(a + i, 8, found, keep_matched, out);
+            i += 8;
+            found = 0;
+          }
+          if (bmax <= amax)
+          {
+            j += 8;
+          }
+        }
+      }
+#endif
+#ifdef MINI_REDIS_INTSET_SSE2
+      while (i + 4 <= na && j + 4 <= nb)
+      {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+        const __m128i eq = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        found |= static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+        const std::int32_t amax = a[i + 3], bmax = b[j + 3];
+        if (amax <= bmax)
+        {
+          emit_block(a + i, 4, found, keep_matched, out);
+          i += 4;
+          found >>= 4;
+        }
+        if (bmax <= amax)
+        {
+          j += 4;
+        }
+      }
+#endif
+      match_tail(a, na, b, nb, i, j, found, keep_matched, out);
+    }
+
+#ifdef MINI_REDIS_INTSET_SSE2
+    // SSE2에는 64 bits 비교가 없으므로 32 bits 비교 결과의 두 반쪽을 AND
+    inline __m128i cmpeq64(__m128i x, __m128i y)
+    {
+      const __m128i eq = _mm_cmpeq_epi32(x, y);
+      return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+#endif
+
+    void match64(const std::int64_t *a, std::size_t na, const std::int64_t *b, std::size_t nb, bool keep_matched,
+                 sink<std::int64_t> &out)
+    {
+      std::size_t i = 0, j = 0;
+      std::uint32_t found = 0;
+#ifdef __AVX2__
+      while (i + 4 <= na && j + 4 <= nb)
+      {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j));
+        const __m256i eq = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi64(va, vb),
+                            _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm256_or_si256(_mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                            _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        found |= static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+        const std::int64_t amax = a[i + 3], bmax = b[j + 3];
+        if (amax <= bmax)
+        {
+          emit_block(a + i, 4, found, keep_matched, out);
+          i += 4;
+          found = 0;
+        }
+        if (bmax <= amax)
+        {
+          j += 4;
+        }
+      }
+#endif
+#ifdef MINI_REDIS_INTSET_SSE2
+      while (i + 2 <= na && j + 2 <= nb)
+      {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+        const __m128i eq =
+            _mm_or_si128(cmpeq64(va, vb), cmpeq64(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        found |= static_cast<std::uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(eq)));
+        const std::int64_t amax = a[i + 1], bmax = b[j + 1];
+        if (amax <= bmax)
+        {
+          emit_block(a + i, 2, found, keep_matched, out);
+          i += 2;
+          found >>= 2;
+        }
+        if (bmax <= amax)
+        {
+          j += 2;
+        }
+      }
+#endif
+      match_tail(a, na, b, nb, i, j, found, keep_matched, out);
+    }
+
+    // 정렬된 두 배열의 합집합 (중복 제거). out에 이미 쓴 값보다 작은 값은 오지 않아야 함
+    template <typename T>
+    void merge_unique(const T *a, std::size_t na, const T *b, std::size_t nb, sink<T> &out)
+    {
+      // 직전 값은 방금 쓴 메모리에서 다시 읽지 않고 register에 둠 (store -> load 의존 사슬 방지)
+      T previous = out.last == out.first ? T() : out.last[-1];
+      auto push = [&](T value) {
+        out.push_if(value, value != previous || out.last == out.first);
+        previous = value;
+      };
+      std::size_t i = 0, j = 0;
+      while (i < na && j < nb)
+      {
+        // 작은 쪽을 쓰고, 같으면 양쪽 모두 전진 (분기 없이)
+        const T x = a[i], y = b[j];
+        push(x < y ? x : y);
+        i += x <= y;
+        j += y <= x;
+      }
+      for (; i < na; ++i)
+      {
+        push(a[i]);
+      }
+      for (; j < nb; ++j)
+      {
+        push(b[j]);
+      }
+    }
+
+#ifdef __SSE4_1__
+    /*
+     * 합집합의 merge network는 32 bits min/max(SSE4.1)가 있어야 scalar 병합보다 빠름.
+     * SSE2로 흉내 내면 (비교 + and/andnot/or) carry에 걸린 의존 사슬이 길어져 분기 없는
+     * scalar 병합보다 느리므로, SSE4.1이 없는 빌드는 merge_unique를 그대로 씀.
+     */
+    inline void min_max(__m128i &lo, __m128i &hi)
+    {
+      const __m128i mn = _mm_min_epi32(lo, hi);
+      hi = _mm_max_epi32(lo, hi);
+      lo = mn;
+    }
+
+    // 정렬된 4개짜리 두 벡터를 bitonic merge network로 합침: a에는 작은 4개, b에는 큰 4개 (각각 정렬)
+    inline void merge4(__m128i &a, __m128i &b)
+    {
+      b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 1, 2, 3)); // 뒤집어서 a와 함께 bitonic 수열로
+      min_max(a, b);
+      // 거리 2, 거리 1 비교로 각 bitonic 4개를 정렬
+      for (__m128i *v : {&a, &b})
+      {
+        __m128i lo = *v;
+        __m128i hi = _mm_shuffle_epi32(*v, _MM_SHUFFLE(1, 0, 3, 2));
+        min_max(lo, hi);
+        __m128i x = _mm_unpacklo_epi64(lo, hi); // [min0, min1, max0, max1]
+        lo = x;
+        hi = _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+        min_max(lo, hi);
+        *v = _mm_unpacklo_epi64(_mm_unpacklo_epi32(lo, hi), _mm_unpackhi_epi32(lo, hi));
+      }
+    }
+
+    /*
+     * 정렬된 4개를 내보내되 직전 값과 같은 값(양쪽 집합에 모두 있던 원소)은 건너뜀.
+     * 직전 값은 방금 쓴 메모리에서 다시 읽지 않고 (vector store -> scalar load 전달 지연)
+     * 이전에 내보낸 vector의 마지막 lane을 register에서 가져옴.
+     */
+    inline void emit_unique(__m128i v, __m128i previous, bool first, sink<std::int32_t> &out)
+    {
+      const __m128i prev = _mm_or_si128(_mm_slli_si128(v, 4), _mm_srli_si128(previous, 12));
+      unsigned dup = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, prev))));
+      dup &= first ? ~1u : ~0u;
+      // 중복이 없으면 (대부분의 경우) 4개를 한 번에 씀
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out.last), v);
+      if (dup == 0)
+      {
+        out.last += 4;
+        return;
+      }
+      alignas(16) std::int32_t lanes[4];
+      _mm_store_si128(reinterpret_cast<__m128i *>(lanes), v);
+      for (int lane = 0; lane < 4; ++lane)
+      {
+        out.push_if(lanes[lane], !((dup >> lane) & 1));
+      }
+    }
+#endif
+
+    void unite32(const std::int32_t *a, std::size_t na, const std::int32_t *b, std::size_t nb,
+                 sink<std::int32_t> &out)
+    {
+#ifdef __SSE4_1__
+      if (na >= 4 && nb >= 4)
+      {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+        __m128i carry = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+        std::size_t i = 4, j = 4;
+        merge4(low, carry);
+        emit_unique(low, low, true, out);
+        // 다음 원소가 더 작은 쪽에서 4개를 가져와 carry와 합치고, 작은 4개를 내보냄
+        while (i + 4 <= na && j + 4 <= nb)
+        {
+          const bool take_a = a[i] <= b[j];
+          __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(take_a ? a + i : b + j));
+          i += take_a ? 4 : 0;
+          j += take_a ? 0 : 4;
+          merge4(next, carry);
+          emit_unique(next, low, false, out);
+          low = next;
+        }
+        // carry 4개와 짧은 쪽 나머지(4개 미만)를 먼저 합친 뒤 긴 쪽 나머지와 병합
+        alignas(16) std::int32_t rest[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(rest), carry);
+        const bool a_short = na - i < 4;
+        std::int32_t small[8];
+        sink<std::int32_t> small_out{small, small};
+        merge_unique(rest, 4, a_short ? a + i : b + j, a_short ? na - i : nb - j, small_out);
+        // small의 첫 값은 이미 내보낸 값과 같을 수 있으므로 out에 쓸 때 다시 중복을 거름
+        merge_unique(small, static_cast<std::size_t>(small_out.last - small), a_short ? b + j : a + i,
+                     a_short ? nb - j : na - i, out);
+        return;
+      }
+#endif
+      merge_unique(a, na, b, nb, out);
+    }
+
+    // 결과가 잡아 둔 크기보다 많이 작을 때만 줄임 (큰 배열을 다시 복사하는 비용을 피함)
+    template <typename T>
+    void shrink_if_sparse(std::vector<T> &values)
+    {
+      if (values.size() < values.capacity() / 4 * 3)
+      {
+        values.shrink_to_fit();
+      }
+    }
+
+    std::vector<std::int64_t> widened(const intset &s)
+    {
+      std::vector<std::int64_t> values;
+      values.reserve(s.size());
+      s.for_each([&](std::int64_t v) { values.push_back(v); });
+      return values;
+    }
+  } // namespace
+
+  bool intset::insert(std::int64_t value)
+  {
+    if (!wide_ && (value < std::numeric_limits<std::int32_t>::min() || value > std::numeric_limits<std::int32_t>::max()))
+    {
+      widen();
+    }
+    if (wide_)
+    {
+      auto it = std::lower_bound(values64_.begin(), values64_.end(), value);
+      if (it != values64_.end() && *it == value)
+      {
+        return false;
+      }
+      values64_.insert(it, value);
+      return true;
+    }
+    const auto narrow = static_cast<std::int32_t>(value);
+    auto it = std::lower_bound(values32_.begin(), values32_.end(), narrow);
+    if (it != values32_.end() && *it == narrow)
+    {
+      return false;
+    }
+    values32_.insert(it, narrow);
+    return true;
+  }
+
+  bool intset::erase(std::int64_t value)
+  {
+    if (wide_)
+    {
+      auto it = std::lower_bound(values64_.begin(), values64_.end(), value);
+      if (it == values64_.end() || *it != value)
+      {
+        return false;
+      }
+      values64_.erase(it);
+      return true;
+    }
+    if (value < std::numeric_limits<std::int32_t>::min() || value > std::numeric_limits<std::int32_t>::max())
+    {
+      return false;
+    }
+    const auto narrow = static_cast<std::int32_t>(value);
+    auto it = std::lower_bound(values32_.begin(), values32_.end(), narrow);
+    if (it == values32_.end() || *it != narrow)
+    {
+      return false;
+    }
+    values32_.erase(it);
+    return true;
+  }
+
+  bool intset::contains(std::int64_t value) const
+  {
+    if (wide_)
+    {
+      return std::binary_search(values64_.begin(), values64_.end(), value);
+    }
+    if (value < std::numeric_limits<std::int32_t>::min() || value > std::numeric_limits<std::int32_t>::max())
+    {
+      return false;
+    }
+    return std::binary_search(values32_.begin(), values32_.end(), static_cast<std::int32_t>(value));
+  }
+
+  void intset::widen()
+  {
+    values64_.assign(values32_.begin(), values32_.end());
+    std::vector<std::int32_t>().swap(values32_);
+    wide_ = true;
+  }
+
+  /*
+   * 두 피연산자가 모두 4 bytes 폭이면 그대로 32 bits kernel을, 아니면 좁은 쪽을 64 bits로 넓힌
+   * 임시 배열을 만들어 64 bits kernel을 실행. 결과 배열은 가능한 최대 크기로 잡았다가 줄임
+   * (sink는 버리는 값도 끝 위치에 쓰고 합집합은 4개씩 통째로 쓰므로 4칸 여유를 둠).
+   */
+  template <typename Kernel32, typename Kernel64>
+  intset intset::combine(const intset &a, const intset &b, std::size_t bound, Kernel32 &&kernel32,
+                         Kernel64 &&kernel64)
+  {
+    intset result;
+    if (a.width() == 4 && b.width() == 4)
+    {
+      result.values32_.resize(bound + 4);
+      sink<std::int32_t> out{result.values32_.data(), result.values32_.data()};
+      kernel32(a.data32(), b.data32(), out);
+      result.values32_.resize(static_cast<std::size_t>(out.last - out.first));
+      shrink_if_sparse(result.values32_);
+      return result;
+    }
+    const auto x = a.width() == 8 ? std::vector<std::int64_t>() : widened(a);
+    const auto y = b.width() == 8 ? std::vector<std::int64_t>() : widened(b);
+    result.wide_ = true;
+    result.values64_.resize(bound + 4);
+    sink<std::int64_t> out{result.values64_.data(), result.values64_.data()};
+    kernel64(a.width() == 8 ? a.data64() : x.data(), b.width() == 8 ? b.data64() : y.data(), out);
+    result.values64_.resize(static_cast<std::size_t>(out.last - out.first));
+    shrink_if_sparse(result.values64_);
+    return result;
+  }
+
+  intset intset::intersect(const intset &a, const intset &b)
+  {
+    const std::size_t na = a.size(), nb = b.size();
+    return combine(
+        a, b, std::min(na, nb),
+        [&](const std::int32_t *x, const std::int32_t *y, sink<std::int32_t> &out) { match32(x, na, y, nb, true, out); },
+        [&](const std::int64_t *x, const std::int64_t *y, sink<std::int64_t> &out) { match64(x, na, y, nb, true, out); });
+  }
+
+  intset intset::difference(const intset &a, const intset &b)
+  {
+    const std::size_t na = a.size(), nb = b.size();
+    return combine(
+        a, b, na,
+        [&](const std::int32_t *x, const std::int32_t *y, sink<std::int32_t> &out) { match32(x, na, y, nb, false, out); },
+        [&](const std::int64_t *x, const std::int64_t *y, sink<std::int64_t> &out) { match64(x, na, y, nb, false, out); });
+  }
+
+  intset intset::unite(const intset &a, const intset &b)
+  {
+    const std::size_t na = a.size(), nb = b.size();
+    // 64 bits 합집합은 scalar 병합
+    return combine(
+        a, b, na + nb,
+        [&](const std::int32_t *x, const std::int32_t *y, sink<std::int32_t> &out) { unite32(x, na, y, nb, out); },
+        [&](const std::int64_t *x, const std::int64_t *y, sink<std::int64_t> &out) { merge_unique(x, na, y, nb, out); });
+  }
+} // namespace mini_redis
@@ -0,0 +1,178 @@
+#include "storage/lzf.hpp"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace mini_redis
+{
+  namespace
+  {
+    constexpr unsigned hash_log = 13;
+    constexpr std::size_t max_literal = 32;       // 리터럴 한 묶음의 최대 길이 (control byte 0~31)
+    constexpr std::size_t max_offset = 1 << 13;   // 참조할 수 있는 최대 거리
+    constexpr std::size_t max_reference = (1 << 8) + (1 << 3); // 참조 한 번의 최대 길이 - 2
+
+    inline unsigned hash3(const unsigned char *p)
+    {
+      const std::uint32_t v = (std::uint32_t(p[0]) << 16) | (std::uint32_t(p[1]) << 8) | p[2];
+      return (v * 2654435761u) >> (32 - hash_log);
+    }
+  } // namespace
+
+  /*
+   * 출력 형식 (liblzf와 같음):
+   *   000LLLLL                      : 뒤따르는 L + 1 bytes의 리터럴
+   *   LLLooooo oooooooo             : 거리 o + 1 만큼 앞에서 L + 2 bytes 복사 (L < 7)
+   *   111ooooo LLLLLLLL oooooooo    : 거리 o + 1 만큼 앞에서 L + 9 bytes 복사
+   */
+  std::size_t lzf_compress(const char *in_chars, std::size_t in_len, char *out_chars, std::size_t out_len)
+  {
+    const auto *in = reinterpret_cast<const unsigned char *>(in_chars);
+    auto *out = reinterpret_cast<unsigned char *>(out_chars);
+    if (in_len == 0 || out_len < 2)
+    {
+      return 0;
+    }
+    // 3 bytes 해시 -> 마지막으로 나온 위치 + 1 (0은 비어 있음)
+    thread_local std::vector<std::uint32_t> table;
+    table.assign(std::size_t(1) << hash_log, 0);
+
+    std::size_t ip = 0;
+    std::size_t op = 1; // out[0]은 첫 리터럴 묶음의 control byte 자리
+    std::size_t lit = 0;
+    while (ip + 2 < in_len)
+    {
+      const unsigned h = hash3(in + ip);
+      const std::size_t ref = table[h];
+      table[h] = static_cast<std::uint32_t>(ip + 1);
+      if (ref != 0 && ip - (ref - 1) <= max_offset && std::memcmp(in + ref - 1, in + ip, 3) == 0)
+      {
+        const std::size_t from = ref - 1;
+        const std::size_t off = ip - from - 1;
+        std::size_t maxlen = in_len - ip - 2;
+        if (maxlen > max_reference)
+        {
+          maxlen = max_reference;
+        }
+        // 참조 한 번은 최대 3 bytes, 이후 새 리터럴 control byte 1 byte
+        if (op + 4 >= out_len)
+        {
+          return 0;
+        }
+        // 진행 중인 리터럴 묶음을 닫음
+        if (lit)
+        {
+          out[op - lit - 1] = static_cast<unsigned char>(lit - 1);
+        }
+        else
+        {
+          --op;
+        }
+        std::size_t len = 2;
+        do
+        {
+          ++len;
+        } while (len < maxlen && in[from + len] == in[ip + len]);
+        len -= 2;
+        ++ip;
+        if (len < 7)
+        {
+          out[op++] = static_cast<unsigned char>((off >> 8) + (len << 5));
+        }
+        else
+        {
+          out[op++] = static_cast<unsigned char>((off >> 8) + (7 << 5));
+          out[op++] = static_cast<unsigned char>(len - 7);
+        }
+        out[op++] = static_cast<unsigned char>(off);
+        lit = 0;
+        ++op;
+        ip += len + 1;
+        continue;
+      }
+      if (op + 1 >= out_len)
+      {
+        return 0;
+      }
+      out[op++] = in[ip++];
+      if (++lit == max_literal)
+      {
+        out[op - lit - 1] = static_cast<unsigned char>(lit - 1);
+        lit = 0;
+        ++op;
+      }
+    }
+    while (ip < in_len)
+    {
+      if (op + 1 >= out_len)
+      {
+        return 0;
+      }
+      out[op++] = in[ip++];
+      if (++lit == max_literal)
+      {
+        out[op - lit - 1] = static_cast<unsigned char>(lit - 1);
+        lit = 0;
+        ++op;
+      }
+    }
+    if (lit)
+    {
+      out[op - lit - 1] = static_cast<unsigned char>(lit - 1);
+    }
+    else
+    {
+      --op;
+    }
+    return op;
+  }
+
+  std::size_t lzf_decompress(const char *in_chars, std::size_t in_len, char *out_chars, std::size_t out_len)
+  {
+    const auto *in = reinterpret_cast<const unsigned char *>(in_chars);
+    auto *out = reinterpret_cast<unsigned char *>(out_chars);
+    std::size_t ip = 0;
+    std::size_t op = 0;
+    while (ip < in_len)
+    {
+      std::size_t ctrl = in[ip++];
+      if (ctrl < 32)
+      {
+        const std::size_t len = ctrl + 1;
+        if (op + len > out_len || ip + len > in_len)
+        {
+          return 0;
+        }
+        std::memcpy(out + op, in + ip, len);
+        op += len;
+        ip += len;
+        continue;
+      }
+      std::size_t len = ctrl >> 5;
+      if (len == 7)
+      {
+        if (ip >= in_len)
+        {
+          return 0;
+        }
+        len += in[ip++];
+      }
+      if (ip >= in_len)
+      {
+        return 0;
+      }
+      const std::size_t off = ((ctrl & 0x1f) << 8) + in[ip++] + 1;
+      len += 2;
+      if (off > op || op + len > out_len)
+      {
+        return 0;
+      }
+      // 참조 구간이 출력과 겹칠 수 있으므로(반복 패턴) 한 byte씩 복사
+      for (std::size_t i = 0; i < len; ++i, ++op)
+      {
+        out[op] = out[op - off];
+      }
+    }
+    return op;
+  }
+} // namespace mini_redis
@@ -0,0 +1,566 @@
+#include "storage/quicklist.hpp"
+#include "storage/listpack.hpp"
+#include "storage/lzf.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace mini_redis
+{
+  namespace
+  {
+    // 이보다 작은 노드는 압축해도 얻는 것이 거의 없음
+    constexpr std::size_t min_compress_bytes = 48;
+
+    std::size_t heap_bytes(const std::string &s)
+    {
+      const char *self = reinterpret_cast<const char *>(&s);
+      const bool is_inline = s.data() >= self && s.data() < self + sizeof(s);
+      return is_inline ? 0 : s.capacity() + 1;
+    }
+
+    // LRANGE/LTRIM의 인덱스 정규화. 범위가 비면 false
+    bool normalize_range(long long &start, long long &stop, std::size_t size)
+    {
+      const auto len = static_cast<long long>(size);
+      if (start < 0)
+      {
+        start += len;
+      }
+      if (stop < 0)
+      {
+        stop += len;
+      }
+      if (start < 0)
+      {
+        start = 0;
+      }
+      if (start > stop || start >= len)
+      {
+        return false;
+      }
+      if (stop >= len)
+      {
+        stop = len - 1;
+      }
+      return true;
+    }
+  } // namespace
+
+  quicklist::quicklist(const options &opts) : opts_(opts)
+  {
+    if (opts_.node_bytes == 0)
+    {
+      opts_.node_bytes = 1;
+    }
+  }
+
+  quicklist::quicklist(const quicklist &other) : opts_(other.opts_)
+  {
+    for (const node *n = other.head_; n; n = n->next)
+    {
+      node *copy = new_node();
+      copy->data = n->data;
+      copy->count = n->count;
+      copy->raw_size = n->raw_size;
+      copy->compressed = n->compressed;
+      copy->incompressible = n->incompressible;
+      data_bytes_ += heap_bytes(copy->data);
+      link_back(copy);
+    }
+    size_ = other.size_;
+  }
+
+  quicklist::quicklist(quicklist &&other) noexcept
+      : head_(std::exchange(other.head_, nullptr)),
+        tail_(std::exchange(other.tail_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        node_count_(std::exchange(other.node_count_, 0)),
+        data_bytes_(std::exchange(other.data_bytes_, 0)),
+        opts_(other.opts_)
+  {
+  }
+
+  quicklist &quicklist::operator=(const quicklist &other)
+  {
+    if (this != &other)
+    {
+      quicklist copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  quicklist &quicklist::operator=(quicklist &&other) noexcept
+  {
+    if (this != &other)
+    {
+      clear();
+      head_ = std::exchange(other.head_, nullptr);
+      tail_ = std::exchange(other.tail_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+      node_count_ = std::exchange(other.node_count_, 0);
+      data_bytes_ = std::exchange(other.data_bytes_, 0);
+      opts_ = other.opts_;
+    }
+    return *this;
+  }
+
+  quicklist::~quicklist()
+  {
+    clear();
+  }
+
+  void quicklist::clear()
+  {
+    node *n = head_;
+    while (n)
+    {
+      node *next = n->next;
+      delete n;
+      n = next;
+    }
+    head_ = tail_ = nullptr;
+    size_ = 0;
+    node_count_ = 0;
+    data_bytes_ = 0;
+  }
+
+  // ---------------------------------------------------------------------------
+  // 노드 관리
+  // ---------------------------------------------------------------------------
+
+  quicklist::node *quicklist::new_node()
+  {
+    ++node_count_;
+    return new node();
+  }
+
+  void quicklist::seal(node *n)
+  {
+    // 버퍼는 2배씩 커지므로 가득 찬 노드는 용량이 한도의 두 배 가까이 될 수 있음.
+    // 더 이상 원소가 붙지 않게 된 노드는 내용 크기에 맞춰 줄임
+    if (n && !n->compressed && n->data.capacity() > n->data.size())
+    {
+      data_bytes_ -= heap_bytes(n->data);
+      n->data.shrink_to_fit();
+      data_bytes_ += heap_bytes(n->data);
+    }
+  }
+
+  void quicklist::link_front(node *n)
+  {
+    n->next = head_;
+    if (head_)
+    {
+      head_->prev = n;
+    }
+    else
+    {
+      tail_ = n;
+    }
+    head_ = n;
+  }
+
+  void quicklist::link_back(node *n)
+  {
+    n->prev = tail_;
+    if (tail_)
+    {
+      tail_->next = n;
+    }
+    else
+    {
+      head_ = n;
+    }
+    tail_ = n;
+  }
+
+  void quicklist::unlink(node *n)
+  {
+    (n->prev ? n->prev->next : head_) = n->next;
+    (n->next ? n->next->prev : tail_) = n->prev;
+    data_bytes_ -= heap_bytes(n->data);
+    --node_count_;
+    delete n;
+  }
+
+  std::string_view quicklist::raw(const node &n, std::string &scratch) const
+  {
+    if (!n.compressed)
+    {
+      return n.data;
+    }
+    scratch.resize(n.raw_size);
+    if (lzf_decompress(n.data.data(), n.data.size(), scratch.data(), scratch.size()) != n.raw_size)
+    {
+      throw std::runtime_error("ERR corrupted list node");
+    }
+    return scratch;
+  }
+
+  void quicklist::compress(node &n)
+  {
+    if (n.compressed || n.incompressible || n.raw_size < min_compress_bytes)
+    {
+      return;
+    }
+    // 8 bytes 이상 줄어들지 않으면 압축하지 않음 (Redis와 같은 기준)
+    std::string out(n.raw_size - 8, '\0');
+    const std::size_t size = lzf_compress(n.data.data(), n.data.size(), out.data(), out.size());
+    if (size == 0)
+    {
+      n.incompressible = true;
+      return;
+    }
+    out.resize(size);
+    out.shrink_to_fit();
+    data_bytes_ -= heap_bytes(n.data);
+    n.data = std::move(out);
+    data_bytes_ += heap_bytes(n.data);
+    n.compressed = true;
+  }
+
+  void quicklist::decompress(node &n)
+  {
+    if (!n.compressed)
+    {
+      return;
+    }
+    std::string out;
+    raw(n, out);
+    data_bytes_ -= heap_bytes(n.data);
+    n.data = std::move(out);
+    data_bytes_ += heap_bytes(n.data);
+    n.compressed = false;
+  }
+
+  void quicklist::fix_compression()
+  {
+    const std::size_t depth = opts_.compress_depth;
+    if (depth == 0)
+    {
+      return;
+    }
+    // push/pop은 노드를 끝에서 하나씩 더하거나 빼므로, 경계 바로 안쪽 노드만 압축하면
+    // 그보다 안쪽 노드는 이미 예전에 경계를 지나면서 압축되어 있음
+    node *front = head_;
+    node *back = tail_;
+    for (std::size_t i = 0; i < depth && front; ++i)
+    {
+      decompress(*front);
+      decompress(*back);
+      front = front->next;
+      back = back->prev;
+    }
+    if (node_count_ > 2 * depth)
+    {
+      compress(*front);
+      compress(*back);
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // push / pop
+  // ---------------------------------------------------------------------------
+
+  void quicklist::push_front(std::string_view value)
+  {
+    const std::string entry = listpack::encode(value);
+    if (head_ && head_->raw_size + entry.size() <= opts_.node_bytes)
+    {
+      decompress(*head_);
+      const std::size_t before = heap_bytes(head_->data);
+      head_->data.insert(0, entry);
+      data_bytes_ += heap_bytes(head_->data) - before;
+      ++head_->count;
+      head_->raw_size += static_cast<std::uint32_t>(entry.size());
+      head_->incompressible = false;
+    }
+    else
+    {
+      seal(head_);
+      node *n = new_node();
+      n->data = entry;
+      n->count = 1;
+      n->raw_size = static_cast<std::uint32_t>(entry.size());
+      data_bytes_ += heap_bytes(n->data);
+      link_front(n);
+    }
+    ++size_;
+    fix_compression();
+  }
+
+  void quicklist::push_back(std::string_view value)
+  {
+    if (tail_ && !tail_->compressed)
+    {
+      // 끝 노드에 바로 이어 붙여 임시 문자열을 만들지 않음
+      const std::size_t entry_size = listpack::entry_size(value.size());
+      if (tail_->raw_size + entry_size <= opts_.node_bytes)
+      {
+        const std::size_t before = heap_bytes(tail_->data);
+        listpack::append(tail_->data, value);
+        data_bytes_ += heap_bytes(tail_->data) - before;
+        ++tail_->count;
+        tail_->raw_size += static_cast<std::uint32_t>(entry_size);
+        tail_->incompressible = false;
+        ++size_;
+        fix_compression();
+        return;
+      }
+    }
+    seal(tail_);
+    node *n = new_node();
+    listpack::append(n->data, value);
+    n->count = 1;
+    n->raw_size = static_cast<std::uint32_t>(n->data.size());
+    data_bytes_ += heap_bytes(n->data);
+    link_back(n);
+    ++size_;
+    fix_compression();
+  }
+
+  std::optional<std::string> quicklist::pop_front()
+  {
+    if (!head_)
+    {
+      return std::nullopt;
+    }
+    node *n = head_;
+    decompress(*n);
+    std::size_t entry_size;
+    std::string value(listpack::read(n->data.data(), entry_size));
+    if (n->count == 1)
+    {
+      unlink(n);
+    }
+    else
+    {
+      const std::size_t before = heap_bytes(n->data);
+      n->data.erase(0, entry_size);
+      data_bytes_ += heap_bytes(n->data) - before;
+      --n->count;
+      n->raw_size -= static_cast<std::uint32_t>(entry_size);
+      n->incompressible = false;
+    }
+    --size_;
+    fix_compression();
+    return value;
+  }
+
+  std::optional<std::string> quicklist::pop_back()
+  {
+    if (!tail_)
+    {
+      return std::nullopt;
+    }
+    node *n = tail_;
+    decompress(*n);
+    const char *end = n->data.data() + n->data.size();
+    const char *start = listpack::before(end);
+    std::size_t entry_size;
+    std::string value(listpack::read(start, entry_size));
+    if (n->count == 1)
+    {
+      unlink(n);
+    }
+    else
+    {
+      n->data.resize(n->data.size() - entry_size);
+      --n->count;
+      n->raw_size -= static_cast<std::uint32_t>(entry_size);
+      n->incompressible = false;
+    }
+    --size_;
+    fix_compression();
+    return value;
+  }
+
+  // ---------------------------------------------------------------------------
+  // 조회
+  // ---------------------------------------------------------------------------
+
+  std::optional<std::string> quicklist::at(long long index) const
+  {
+    const auto len = static_cast<long long>(size_);
+    if (index < 0)
+    {
+      index += len;
+    }
+    if (index < 0 || index >= len)
+    {
+      return std::nullopt;
+    }
+    std::string scratch;
+    if (index < len / 2)
+    {
+      // 앞에서부터: 노드 단위로 건너뛴 뒤 노드 안에서 원소를 차례로 넘김
+      auto skip = static_cast<std::size_t>(index);
+      const node *n = head_;
+      while (skip >= n->count)
+      {
+        skip -= n->count;
+        n = n->next;
+      }
+      const std::string_view block = raw(*n, scratch);
+      const char *p = block.data();
+      std::size_t entry_size;
+      for (; skip > 0; --skip)
+      {
+        listpack::read(p, entry_size);
+        p += entry_size;
+      }
+      return std::string(listpack::read(p, entry_size));
+    }
+    // 뒤에서부터: 역방향 길이로 원소를 되짚어 감
+    auto skip = static_cast<std::size_t>(len - 1 - index);
+    const node *n = tail_;
+    while (skip >= n->count)
+    {
+      skip -= n->count;
+      n = n->prev;
+    }
+    const std::string_view block = raw(*n, scratch);
+    const char *p = listpack::before(block.data() + block.size());
+    for (; skip > 0; --skip)
+    {
+      p = listpack::before(p);
+    }
+    std::size_t entry_size;
+    return std::string(listpack::read(p, entry_size));
+  }
+
+  std::vector<std::string> quicklist::range(long long start, long long stop) const
+  {
+    std::vector<std::string> result;
+    if (!normalize_range(start, stop, size_))
+    {
+      return result;
+    }
+    result.reserve(static_cast<std::size_t>(stop - start + 1));
+    auto skip = static_cast<std::size_t>(start);
+    auto remaining = static_cast<std::size_t>(stop - start + 1);
+    const node *n = head_;
+    while (skip >= n->count)
+    {
+      skip -= n->count;
+      n = n->next;
+    }
+    std::string scratch;
+    for (; n && remaining > 0; n = n->next, skip = 0)
+    {
+      const std::string_view block = raw(*n, scratch);
+      const char *p = block.data();
+      std::size_t entry_size;
+      for (std::uint32_t i = 0; i < n->count && remaining > 0; ++i)
+      {
+        const std::string_view value = listpack::read(p, entry_size);
+        p += entry_size;
+        if (i >= skip)
+        {
+          result.emplace_back(value);
+          --remaining;
+        }
+      }
+    }
+    return result;
+  }
+
+  std::size_t quicklist::memory_usage() const
+  {
+    return sizeof(quicklist) + node_count_ * sizeof(node) + data_bytes_;
+  }
+
+  std::size_t quicklist::compressed_nodes() const
+  {
+    std::size_t count = 0;
+    for (const node *n = head_; n; n = n->next)
+    {
+      count += n->compressed;
+    }
+    return count;
+  }
+
+  // ---------------------------------------------------------------------------
+  // trim
+  // ---------------------------------------------------------------------------
+
+  void quicklist::trim(long long start, long long stop)
+  {
+    if (!normalize_range(start, stop, size_))
+    {
+      clear();
+      return;
+    }
+    const auto back = size_ - 1 - static_cast<std::size_t>(stop);
+    remove_front(static_cast<std::size_t>(start));
+    remove_back(back);
+    fix_compression();
+  }
+
+  void quicklist::remove_front(std::size_t count)
+  {
+    // 통째로 지울 수 있는 노드는 압축을 풀지 않고 해제
+    while (count > 0 && head_ && head_->count <= count)
+    {
+      count -= head_->count;
+      size_ -= head_->count;
+      unlink(head_);
+    }
+    if (count == 0 || !head_)
+    {
+      return;
+    }
+    node *n = head_;
+    decompress(*n);
+    const char *p = n->data.data();
+    std::size_t entry_size;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      listpack::read(p, entry_size);
+      p += entry_size;
+    }
+    const auto removed = static_cast<std::size_t>(p - n->data.data());
+    const std::size_t before = heap_bytes(n->data);
+    n->data.erase(0, removed);
+    n->data.shrink_to_fit();
+    data_bytes_ += heap_bytes(n->data);
+    data_bytes_ -= before;
+    n->count -= static_cast<std::uint32_t>(count);
+    n->raw_size -= static_cast<std::uint32_t>(removed);
+    n->incompressible = false;
+    size_ -= count;
+  }
+
+  void quicklist::remove_back(std::size_t count)
+  {
+    while (count > 0 && tail_ && tail_->count <= count)
+    {
+      count -= tail_->count;
+      size_ -= tail_->count;
+      unlink(tail_);
+    }
+    if (count == 0 || !tail_)
+    {
+      return;
+    }
+    node *n = tail_;
+    decompress(*n);
+    const char *end = n->data.data() + n->data.size();
+    const char *p = end;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      p = listpack::before(p);
+    }
+    const auto removed = static_cast<std::size_t>(end - p);
+    const std::size_t before = heap_bytes(n->data);
+    n->data.resize(n->data.size() - removed);
+    n->data.shrink_to_fit();
+    data_bytes_ += heap_bytes(n->data);
+    data_bytes_ -= before;
+    n->count -= static_cast<std::uint32_t>(count);
+    n->raw_size -= static_cast<std::uint32_t>(removed);
+    n->incompressible = false;
+    size_ -= count;
+  }
+} // namespace mini_redis
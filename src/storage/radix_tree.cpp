@@ -0,0 +1,317 @@
+#include "storage/radix_tree.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace mini_redis
+{
+  radix_tree::radix_tree(bool with_values) : with_values_(with_values), root_(new_node({}, false)) {}
+
+  radix_tree::~radix_tree()
+  {
+    free_subtree(root_);
+  }
+
+  void *radix_tree::node_value(const node *n) const
+  {
+    void *value = nullptr;
+    if (with_values_)
+    {
+      std::memcpy(&value, n->label() + n->label_len, sizeof(value));
+    }
+    return value;
+  }
+
+  void radix_tree::set_node_value(node *n, void *value)
+  {
+    if (with_values_)
+    {
+      std::memcpy(n->label() + n->label_len, &value, sizeof(value));
+    }
+  }
+
+  radix_tree::node *radix_tree::new_node(std::string_view label, bool terminal, void *value)
+  {
+    void *p = std::malloc(node_bytes(label.size()));
+    if (!p)
+    {
+      throw std::bad_alloc();
+    }
+    node *n = static_cast<node *>(p);
+    n->block = nullptr;
+    n->label_len = static_cast<std::uint32_t>(label.size());
+    n->child_count = 0;
+    n->child_capacity = 0;
+    n->terminal = terminal;
+    if (!label.empty())
+    {
+      std::memcpy(n->label(), label.data(), label.size());
+    }
+    set_node_value(n, value);
+    memory_ += node_bytes(label.size());
+    return n;
+  }
+
+  void radix_tree::free_node(node *n)
+  {
+    if (n->child_capacity)
+    {
+      std::free(n->block);
+      memory_ -= children_bytes(n->child_capacity);
+    }
+    memory_ -= node_bytes(n->label_len);
+    std::free(n);
+  }
+
+  void radix_tree::free_subtree(node *n)
+  {
+    // 깊은 트리에서 재귀가 스택을 넘지 않도록 명시적인 스택 사용
+    std::vector<node *> stack{n};
+    while (!stack.empty())
+    {
+      node *cur = stack.back();
+      stack.pop_back();
+      stack.insert(stack.end(), cur->children(), cur->children() + cur->child_count);
+      free_node(cur);
+    }
+  }
+
+  void radix_tree::clear()
+  {
+    free_subtree(root_);
+    size_ = 0;
+    root_ = new_node({}, false);
+  }
+
+  radix_tree::node *radix_tree::relabel(node *n, std::string_view label)
+  {
+    node *copy = new_node(label, n->terminal, node_value(n));
+    copy->block = n->block;
+    copy->child_count = n->child_count;
+    copy->child_capacity = n->child_capacity;
+    n->child_capacity = 0; // 자식 블록은 copy로 넘어감
+    n->child_count = 0;
+    free_node(n);
+    return copy;
+  }
+
+  int radix_tree::find_child(const node *n, unsigned char c)
+  {
+    const unsigned char *begin = n->first_bytes();
+    const unsigned char *end = begin + n->child_count;
+    const unsigned char *it = std::lower_bound(begin, end, c);
+    return it != end && *it == c ? static_cast<int>(it - begin) : -1;
+  }
+
+  void radix_tree::grow_children(node *n)
+  {
+    const std::size_t capacity = n->child_capacity ? std::min<std::size_t>(n->child_capacity * 2, 256) : 1;
+    void *p = std::malloc(children_bytes(capacity));
+    if (!p)
+    {
+      throw std::bad_alloc();
+    }
+    auto *block = static_cast<unsigned char *>(p);
+    auto **children = reinterpret_cast<node **>(block + (capacity + 7) / 8 * 8);
+    if (n->child_count)
+    {
+      std::memcpy(block, n->first_bytes(), n->child_count);
+      std::memcpy(children, n->children(), n->child_count * sizeof(node *));
+    }
+    if (n->child_capacity)
+    {
+      std::free(n->block);
+      memory_ -= children_bytes(n->child_capacity);
+    }
+    n->block = block;
+    n->child_capacity = static_cast<std::uint16_t>(capacity);
+    memory_ += children_bytes(capacity);
+  }
+
+  void radix_tree::add_child(node *parent, node *child)
+  {
+    if (parent->child_count == parent->child_capacity)
+    {
+      grow_children(parent);
+    }
+    const auto c = static_cast<unsigned char>(child->label()[0]);
+    unsigned char *first_bytes = parent->first_bytes();
+    node **children = parent->children();
+    const std::size_t pos = std::lower_bound(first_bytes, first_bytes + parent->child_count, c) - first_bytes;
+    const std::size_t tail = parent->child_count - pos;
+    std::memmove(first_bytes + pos + 1, first_bytes + pos, tail);
+    std::memmove(children + pos + 1, children + pos, tail * sizeof(node *));
+    first_bytes[pos] = c;
+    children[pos] = child;
+    ++parent->child_count;
+  }
+
+  void radix_tree::remove_child(node *parent, int index)
+  {
+    const std::size_t tail = parent->child_count - index - 1;
+    unsigned char *first_bytes = parent->first_bytes();
+    node **children = parent->children();
+    std::memmove(first_bytes + index, first_bytes + index + 1, tail);
+    std::memmove(children + index, children + index + 1, tail * sizeof(node *));
+    --parent->child_count;
+    if (parent->child_count == 0)
+    {
+      std::free(parent->block);
+      memory_ -= children_bytes(parent->child_capacity);
+      parent->block = nullptr;
+      parent->child_capacity = 0;
+    }
+  }
+
+  radix_tree::node *radix_tree::merge_with_child(node *n)
+  {
+    node *child = n->children()[0];
+    std::string label(n->label_view());
+    label.append(child->label(), child->label_len);
+    node *merged = relabel(child, label);
+    // n의 자식 블록(child 하나만 가리킴)은 n과 함께 해제
+    free_node(n);
+    return merged;
+  }
+
+  bool radix_tree::insert(std::string_view key, void *value)
+  {
+    node *n = root_;
+    std::size_t pos = 0;
+    for (;;)
+    {
+      if (pos == key.size())
+      {
+        if (n->terminal)
+        {
+          return false;
+        }
+        n->terminal = true;
+        set_node_value(n, value);
+        ++size_;
+        return true;
+      }
+      const int index = find_child(n, static_cast<unsigned char>(key[pos]));
+      if (index < 0)
+      {
+        add_child(n, new_node(key.substr(pos), true, value));
+        ++size_;
+        return true;
+      }
+      node *child = n->children()[index];
+      const std::string_view rest = key.substr(pos);
+      const std::size_t common =
+          std::mismatch(child->label(), child->label() + std::min<std::size_t>(child->label_len, rest.size()),
+                        rest.begin())
+              .first -
+          child->label();
+      if (common < child->label_len)
+      {
+        // label 중간에서 갈라지면 공통 부분을 label로 하는 노드를 사이에 둠
+        node *mid = new_node(rest.substr(0, common), false);
+        node *tail = relabel(child, child->label_view().substr(common));
+        add_child(mid, tail);
+        n->children()[index] = mid;
+        child = mid;
+      }
+      n = child;
+      pos += common;
+    }
+  }
+
+  bool radix_tree::erase(std::string_view key)
+  {
+    // 루트부터의 경로: (부모, 부모 안에서의 자식 위치)
+    struct step
+    {
+      node *parent;
+      int index;
+    };
+    std::vector<step> path;
+    node *n = root_;
+    std::size_t pos = 0;
+    while (pos < key.size())
+    {
+      const int index = find_child(n, static_cast<unsigned char>(key[pos]));
+      if (index < 0)
+      {
+        return false;
+      }
+      node *child = n->children()[index];
+      if (key.substr(pos, child->label_len) != child->label_view())
+      {
+        return false;
+      }
+      path.push_back({n, index});
+      n = child;
+      pos += child->label_len;
+    }
+    if (!n->terminal)
+    {
+      return false;
+    }
+    n->terminal = false;
+    --size_;
+    if (n == root_)
+    {
+      return true;
+    }
+
+    // 키도 아니고 자식도 없는 노드는 제거하고, 그 때문에 자식이 하나만 남은 부모는 합침
+    auto [parent, index] = path.back();
+    if (n->child_count == 0)
+    {
+      free_node(n);
+      remove_child(parent, index);
+      if (parent == root_ || parent->terminal || parent->child_count != 1)
+      {
+        return true;
+      }
+      path.pop_back();
+      n = parent;
+      parent = path.back().parent;
+      index = path.back().index;
+    }
+    else if (n->child_count != 1)
+    {
+      return true;
+    }
+    parent->children()[index] = merge_with_child(n);
+    return true;
+  }
+
+  bool radix_tree::contains(std::string_view key) const
+  {
+    return find_node(key) != nullptr;
+  }
+
+  void *radix_tree::find(std::string_view key) const
+  {
+    const node *n = find_node(key);
+    return n ? node_value(n) : nullptr;
+  }
+
+  const radix_tree::node *radix_tree::find_node(std::string_view key) const
+  {
+    const node *n = root_;
+    std::size_t pos = 0;
+    while (pos < key.size())
+    {
+      const int index = find_child(n, static_cast<unsigned char>(key[pos]));
+      if (index < 0)
+      {
+        return nullptr;
+      }
+      n = n->children()[index];
+      if (key.substr(pos, n->label_len) != n->label_view())
+      {
+        return nullptr;
+      }
+      pos += n->label_len;
+    }
+    return n->terminal ? n : nullptr;
+  }
+} // namespace mini_redis
@@ -0,0 +1,337 @@
+#include "storage/slab_arena.hpp"
+#include <algorithm>
+#include <cassert>
+#include <new>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace mini_redis
+{
+  namespace
+  {
+    // 128 bytes까지는 16 bytes 간격, 그 위로는 2의 거듭제곱 구간마다 8개 등급 (내부 단편화 최대 12.5%)
+    constexpr std::array<std::uint16_t, slab_arena::class_count> class_sizes = {
+        16, 32, 48, 64, 80, 96, 112, 128,
+        144, 160, 176, 192, 208, 224, 240, 256,
+        288, 320, 352, 384, 416, 448, 480, 512,
+        576, 640, 704, 768, 832, 896, 960, 1024};
+
+    struct free_object
+    {
+      free_object *next;
+    };
+
+    /*
+     * slab 메모리는 전역 allocator를 거치지 않고 OS에서 직접 받아 해제 즉시 돌려줌.
+     * (glibc의 heap은 중간에 비어 있는 64KiB 블록을 OS에 돌려주지 못하므로 churn 후 RSS가 줄지 않음)
+     * mmap은 페이지 단위로만 정렬되므로, 먼저 slab 크기만큼 요청해 보고 정렬되어 있지 않을 때만
+     * 두 배를 받아 앞뒤를 잘라냄 (jemalloc과 같은 방식). 커널은 새 매핑을 직전 매핑 바로 아래에 두므로
+     * 한 번 정렬이 맞으면 이후 요청도 대부분 바로 정렬되고, 인접한 매핑은 하나로 합쳐짐.
+     */
+    void *map_slab()
+    {
+#ifdef __linux__
+      constexpr std::size_t size = slab_arena::slab_size;
+      auto aligned = [](void *p) { return (reinterpret_cast<std::uintptr_t>(p) & (size - 1)) == 0; };
+      void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED)
+      {
+        throw std::bad_alloc();
+      }
+      if (aligned(p))
+      {
+        return p;
+      }
+      munmap(p, size);
+      p = mmap(nullptr, 2 * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED)
+      {
+        throw std::bad_alloc();
+      }
+      char *base = static_cast<char *>(p);
+      char *start = reinterpret_cast<char *>((reinterpret_cast<std::uintptr_t>(base) + size - 1) & ~(size - 1));
+      if (start != base)
+      {
+        munmap(base, start - base);
+      }
+      if (start + size != base + 2 * size)
+      {
+        munmap(start + size, base + 2 * size - (start + size));
+      }
+      return start;
+#else
+      return ::operator new(slab_arena::slab_size, std::align_val_t(slab_arena::slab_size));
+#endif
+    }
+
+    void unmap_slab(void *s)
+    {
+#ifdef __linux__
+      munmap(s, slab_arena::slab_size);
+#else
+      ::operator delete(s, std::align_val_t(slab_arena::slab_size));
+#endif
+    }
+  } // namespace
+
+  /*
+   * slab 앞부분에 두는 header. 객체는 header 뒤 첫 16 bytes 경계부터 배치.
+   * 아직 한 번도 할당하지 않은 영역은 bump 포인터로, 해제된 객체는 free list로 관리하므로
+   * 새 slab을 만들 때 모든 객체를 free list에 엮는 초기화 비용이 없음.
+   */
+  struct slab_arena::slab
+  {
+    slab_arena *owner;
+    slab *prev;
+    slab *next;
+    free_object *free_list;
+    char *bump;
+    std::uint32_t live;
+    std::uint32_t capacity;
+    std::uint16_t cls;
+    bool in_partial;
+
+    static constexpr std::size_t header_size = (sizeof(slab_arena *) * 5 + 16 + 15) / 16 * 16;
+
+    char *objects() { return reinterpret_cast<char *>(this) + header_size; }
+    bool full() const { return free_list == nullptr && bump == nullptr; }
+  };
+
+  slab_arena::~slab_arena()
+  {
+    // 남은 객체가 있더라도(소유자가 먼저 해제하지 않은 경우) slab 전체를 해제
+    std::vector<slab *> all(empty_.begin(), empty_.end());
+    for (auto &c : classes_)
+    {
+      if (c.current)
+      {
+        all.push_back(c.current);
+      }
+      for (slab *s = c.partial; s; s = s->next)
+      {
+        all.push_back(s);
+      }
+    }
+    // 가득 찬 slab은 어느 목록에도 없으므로 current/partial로 찾을 수 없음. 소유자는 모든 객체를
+    // 먼저 해제해야 하며, 그러면 가득 찬 slab은 남지 않음
+    for (slab *s : all)
+    {
+      unmap_slab(s);
+    }
+  }
+
+  std::size_t slab_arena::class_index(std::size_t n)
+  {
+    if (n <= 128)
+    {
+      return n == 0 ? 0 : (n - 1) / 16;
+    }
+    return static_cast<std::size_t>(std::lower_bound(class_sizes.begin() + 8, class_sizes.end(), n) -
+                                    class_sizes.begin());
+  }
+
+  std::size_t slab_arena::class_size_for(std::size_t n)
+  {
+    return class_sizes[class_index(n)];
+  }
+
+  slab_arena::slab *slab_arena::slab_of(const void *p)
+  {
+    return reinterpret_cast<slab *>(reinterpret_cast<std::uintptr_t>(p) & ~(std::uintptr_t(slab_size) - 1));
+  }
+
+  slab_arena *slab_arena::owner(const void *p)
+  {
+    return slab_of(p)->owner;
+  }
+
+  slab_arena::slab *slab_arena::new_slab(std::size_t cls)
+  {
+    static_assert(sizeof(slab) <= slab::header_size, "slab header does not fit");
+    slab *s;
+    if (!empty_.empty())
+    {
+      s = empty_.back();
+      empty_.pop_back();
+      --stats_.empty_slabs;
+    }
+    else
+    {
+      s = static_cast<slab *>(map_slab());
+      ++stats_.slabs;
+    }
+    s->owner = this;
+    s->prev = s->next = nullptr;
+    s->free_list = nullptr;
+    s->bump = s->objects();
+    s->live = 0;
+    s->capacity = static_cast<std::uint32_t>((slab_size - slab::header_size) / class_sizes[cls]);
+    s->cls = static_cast<std::uint16_t>(cls);
+    s->in_partial = false;
+    ++classes_[cls].slabs;
+    return s;
+  }
+
+  void slab_arena::link_partial(size_class &c, slab *s)
+  {
+    s->prev = nullptr;
+    s->next = c.partial;
+    if (c.partial)
+    {
+      c.partial->prev = s;
+    }
+    c.partial = s;
+    s->in_partial = true;
+  }
+
+  void slab_arena::unlink_partial(size_class &c, slab *s)
+  {
+    if (s->prev)
+    {
+      s->prev->next = s->next;
+    }
+    else
+    {
+      c.partial = s->next;
+    }
+    if (s->next)
+    {
+      s->next->prev = s->prev;
+    }
+    s->prev = s->next = nullptr;
+    s->in_partial = false;
+  }
+
+  slab_arena::slab *slab_arena::pick_partial(size_class &c)
+  {
+    // 앞쪽 몇 개 중 가장 많이 찬 slab을 골라, 덜 찬 slab이 비워질 기회를 줌
+    constexpr int candidates = 8;
+    slab *best = nullptr;
+    int seen = 0;
+    for (slab *s = c.partial; s && seen < candidates; s = s->next, ++seen)
+    {
+      if (!best || s->live > best->live)
+      {
+        best = s;
+      }
+    }
+    if (best)
+    {
+      unlink_partial(c, best);
+    }
+    return best;
+  }
+
+  void *slab_arena::allocate(std::size_t n)
+  {
+    assert(n > 0 && n <= max_object_size);
+    const std::size_t cls = class_index(n);
+    size_class &c = classes_[cls];
+    if (!c.current || c.current->full())
+    {
+      // 가득 찬 current는 어느 목록에도 두지 않음. 객체가 해제되면 partial로 돌아옴
+      c.current = pick_partial(c);
+      if (!c.current)
+      {
+        c.current = new_slab(cls);
+      }
+    }
+
+    slab *s = c.current;
+    void *p;
+    if (s->free_list)
+    {
+      p = s->free_list;
+      s->free_list = s->free_list->next;
+    }
+    else
+    {
+      p = s->bump;
+      s->bump += class_sizes[cls];
+      if (s->bump + class_sizes[cls] > reinterpret_cast<char *>(s) + slab_size)
+      {
+        s->bump = nullptr;
+      }
+    }
+    ++s->live;
+    ++c.live;
+    ++stats_.live_objects;
+    stats_.live_bytes += class_sizes[cls];
+    stats_.requested_bytes += n;
+    return p;
+  }
+
+  void slab_arena::deallocate(void *p, std::size_t n) noexcept
+  {
+    slab *s = slab_of(p);
+    slab_arena &arena = *s->owner;
+    size_class &c = arena.classes_[s->cls];
+    const bool was_full = s->full();
+
+    auto *obj = static_cast<free_object *>(p);
+    obj->next = s->free_list;
+    s->free_list = obj;
+    --s->live;
+    --c.live;
+    --arena.stats_.live_objects;
+    arena.stats_.live_bytes -= class_sizes[s->cls];
+    arena.stats_.requested_bytes -= n;
+
+    if (s == c.current)
+    {
+      return;
+    }
+    if (s->live == 0)
+    {
+      if (s->in_partial)
+      {
+        arena.unlink_partial(c, s);
+      }
+      arena.retire(s);
+    }
+    else if (was_full)
+    {
+      arena.link_partial(c, s);
+    }
+  }
+
+  void slab_arena::retire(slab *s)
+  {
+    --classes_[s->cls].slabs;
+    if (empty_.size() < max_empty_slabs)
+    {
+      empty_.push_back(s);
+      ++stats_.empty_slabs;
+      return;
+    }
+    unmap_slab(s);
+    --stats_.slabs;
+  }
+
+  bool slab_arena::should_move(const void *p) const
+  {
+    const slab *s = slab_of(p);
+    const size_class &c = classes_[s->cls];
+    if (s == c.current || c.slabs <= 1)
+    {
+      return false;
+    }
+    // 사용률이 등급 평균보다 낮거나 절반이 안 되는 slab의 객체를 옮김.
+    // 평균만 기준으로 하면(jemalloc) 고르게 드문드문 찬 slab들은 절반만 옮겨지고 여러 번 순회해야 함
+    return s->live < s->capacity / 2 || static_cast<std::size_t>(s->live) * c.slabs < c.live;
+  }
+
+  std::size_t slab_arena::release_empty_slabs()
+  {
+    const std::size_t released = empty_.size();
+    for (slab *s : empty_)
+    {
+      unmap_slab(s);
+    }
+    empty_.clear();
+    stats_.slabs -= released;
+    stats_.empty_slabs = 0;
+    return released;
+  }
+} // namespace mini_redis
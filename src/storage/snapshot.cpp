@@ -0,0 +1,613 @@
+#include "storage/snapshot.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mini_redis
+{
+  namespace snapshot
+  {
+    namespace
+    {
+      // CRC-64/Jones (reflected, Redis의 crc64와 같은 다항식)
+      constexpr std::uint64_t crc64_poly = 0x95ac9329ac4bc9b5ULL;
+
+      /*
+       * slicing-by-8 표: tables[0]은 byte 하나의 CRC, tables[k][b]는 byte b 뒤에 0 byte가 k개
+       * 더 있을 때의 CRC. 8 bytes를 한 번에 표 8개로 처리하여 byte마다 표를 한 번 보는 것보다
+       * 분기와 의존 체인이 짧음.
+       */
+      using crc_tables = std::array<std::array<std::uint64_t, 256>, 8>;
+
+      crc_tables make_crc_tables()
+      {
+        crc_tables t{};
+        for (std::uint32_t b = 0; b < 256; ++b)
+        {
+          std::uint64_t crc = b;
+          for (int i = 0; i < 8; ++i)
+          {
+            crc = (crc & 1) ? (crc >> 1) ^ crc64_poly : crc >> 1;
+          }
+          t[0][b] = crc;
+        }
+        for (std::uint32_t b = 0; b < 256; ++b)
+        {
+          for (std::size_t k = 1; k < 8; ++k)
+          {
+            t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xff];
+          }
+        }
+        return t;
+      }
+
+      std::uint64_t load_le(const unsigned char *p, int bytes)
+      {
+        std::uint64_t v = 0;
+        for (int i = bytes - 1; i >= 0; --i)
+        {
+          v = (v << 8) | p[i];
+        }
+        return v;
+      }
+
+      std::uint64_t load_le64(const unsigned char *p) { return load_le(p, 8); }
+
+      void append_le(std::string &out, std::uint64_t v, int bytes)
+      {
+        for (int i = 0; i < bytes; ++i)
+        {
+          out += static_cast<char>((v >> (8 * i)) & 0xff);
+        }
+      }
+
+      [[noreturn]] void io_error(const std::string &what, const std::string &path)
+      {
+        throw std::runtime_error("ERR " + what + " " + path + ": " + std::strerror(errno));
+      }
+    } // namespace
+
+    std::uint64_t crc64(std::uint64_t crc, const void *data, std::size_t size)
+    {
+      static const crc_tables t = make_crc_tables();
+      const auto *p = static_cast<const unsigned char *>(data);
+      for (; size >= 8; size -= 8, p += 8)
+      {
+        crc ^= load_le64(p);
+        crc = t[7][crc & 0xff] ^ t[6][(crc >> 8) & 0xff] ^ t[5][(crc >> 16) & 0xff] ^ t[4][(crc >> 24) & 0xff] ^
+              t[3][(crc >> 32) & 0xff] ^ t[2][(crc >> 40) & 0xff] ^ t[1][(crc >> 48) & 0xff] ^ t[0][crc >> 56];
+      }
+      for (; size > 0; --size, ++p)
+      {
+        crc = t[0][(crc ^ *p) & 0xff] ^ (crc >> 8);
+      }
+      return crc;
+    }
+
+    writer::writer(const std::string &path) : path_(path)
+    {
+      flush_threshold_ = buffer_size;
+      buf_.reserve(buffer_size + 64);
+#ifdef __linux__
+      fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (fd_ < 0)
+      {
+        io_error("cannot create", path);
+      }
+#else
+      file_ = std::fopen(path.c_str(), "wb");
+      if (!file_)
+      {
+        io_error("cannot create", path);
+      }
+#endif
+    }
+
+    writer::~writer()
+    {
+#ifdef __linux__
+      if (fd_ >= 0)
+      {
+        ::close(fd_);
+      }
+#else
+      if (file_)
+      {
+        std::fclose(file_);
+      }
+#endif
+    }
+
+    void writer::put_header(std::uint64_t key_count, std::int64_t saved_unix_ms, std::uint32_t shard_count)
+    {
+      header_.append(magic, sizeof(magic));
+      append_le(header_, version, 4);
+      append_le(header_, key_count, 8);
+      append_le(header_, static_cast<std::uint64_t>(saved_unix_ms), 8);
+      shard_count_ = shard_count;
+      buf_ += header_;
+      // header는 어느 chunk에도 속하지 않으므로 먼저 내보냄 (CRC는 footer에서 따로 계산)
+      flush();
+      crc_ = 0;
+    }
+
+    void writer::begin_record(std::uint32_t shard, std::uint64_t key_hash)
+    {
+      if (chunk_open_ && (shard != chunks_.back().shard || bytes_written() - chunks_.back().offset >= chunk_size))
+      {
+        close_chunk();
+      }
+      if (!chunk_open_)
+      {
+        chunk_info chunk;
+        chunk.offset = bytes_written();
+        chunk.shard = shard;
+        chunks_.push_back(chunk);
+        chunk_open_ = true;
+      }
+      ++chunks_.back().keys;
+      records_.emplace_back(key_hash, bytes_written());
+    }
+
+    void writer::close_chunk()
+    {
+      // chunk의 마지막 bytes까지 CRC에 들어가도록 내보냄
+      flush();
+      auto &chunk = chunks_.back();
+      chunk.size = flushed_ - chunk.offset;
+      chunk.crc = crc_;
+      crc_ = 0;
+      chunk_open_ = false;
+    }
+
+    std::uint64_t writer::append_key_index(std::string &out) const
+    {
+      if (records_.empty() || records_.back().second > max_indexed_offset)
+      {
+        return 0;
+      }
+      // 채움률 3/4 이하가 되는 2의 거듭제곱. 없는 키를 찾을 때도 빈 슬롯을 금방 만남
+      std::uint64_t slots = 8;
+      while (slots * 3 < records_.size() * 4)
+      {
+        slots *= 2;
+      }
+      std::vector<std::uint64_t> table(slots, 0);
+      const std::uint64_t mask = slots - 1;
+      for (const auto &[hash, offset] : records_)
+      {
+        std::uint64_t pos = hash & mask;
+        while (table[pos] != 0)
+        {
+          pos = (pos + 1) & mask;
+        }
+        // 레코드는 header 뒤에 있으므로 offset이 0이 아니어서 빈 슬롯과 구별됨
+        table[pos] = (offset << key_tag_bits) | key_tag(hash);
+      }
+      out.reserve(out.size() + slots * 8);
+      for (const auto slot : table)
+      {
+        append_le(out, slot, 8);
+      }
+      return slots;
+    }
+
+    void encoder::put_u32(std::uint32_t v)
+    {
+      append_le(buf_, v, 4);
+      maybe_flush();
+    }
+
+    void encoder::put_u64(std::uint64_t v)
+    {
+      append_le(buf_, v, 8);
+      maybe_flush();
+    }
+
+    void encoder::put_varint(std::uint64_t v)
+    {
+      while (v >= 0x80)
+      {
+        buf_ += static_cast<char>((v & 0x7f) | 0x80);
+        v >>= 7;
+      }
+      buf_ += static_cast<char>(v);
+      maybe_flush();
+    }
+
+    void encoder::put_double(double v)
+    {
+      std::uint64_t bits;
+      std::memcpy(&bits, &v, sizeof(bits));
+      put_u64(bits);
+    }
+
+    void encoder::put_string(std::string_view s)
+    {
+      put_varint(s.size());
+      if (s.size() >= flush_threshold_)
+      {
+        // 큰 값은 버퍼에 복사하지 않고 바로 씀
+        flush();
+        write_through(s);
+        return;
+      }
+      buf_.append(s.data(), s.size());
+      maybe_flush();
+    }
+
+    void writer::flush()
+    {
+      write_raw(buf_.data(), buf_.size());
+      buf_.clear();
+    }
+
+    void writer::write_raw(const char *data, std::size_t size)
+    {
+      if (size == 0)
+      {
+        return;
+      }
+      crc_ = crc64(crc_, data, size);
+#ifdef __linux__
+      std::size_t done = 0;
+      while (done < size)
+      {
+        const ssize_t n = ::write(fd_, data + done, size - done);
+        if (n < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          io_error("cannot write", path_);
+        }
+        done += static_cast<std::size_t>(n);
+      }
+#else
+      if (size > 0 && std::fwrite(data, 1, size, file_) != size)
+      {
+        io_error("cannot write", path_);
+      }
+#endif
+      flushed_ += size;
+    }
+
+    void writer::commit()
+    {
+      if (chunk_open_)
+      {
+        close_chunk();
+      }
+      else
+      {
+        flush();
+      }
+      const std::uint64_t index_offset = flushed_;
+      std::string index;
+      index.reserve(chunks_.size() * index_entry_size);
+      for (const auto &chunk : chunks_)
+      {
+        append_le(index, chunk.offset, 8);
+        append_le(index, chunk.size, 8);
+        append_le(index, chunk.keys, 8);
+        append_le(index, chunk.shard, 4);
+        append_le(index, chunk.crc, 8);
+      }
+      write_raw(index.data(), index.size());
+
+      // key index는 크므로 (키마다 10 bytes 남짓) 자기 CRC를 따로 두고 footer의 checksum에서는 뺌
+      const std::uint64_t key_index_offset = flushed_;
+      std::string key_index;
+      const std::uint64_t key_index_slots = append_key_index(key_index);
+      const std::uint64_t key_index_crc = crc64(0, key_index.data(), key_index.size());
+      write_raw(key_index.data(), key_index.size());
+      key_index = std::string();
+
+      std::string footer;
+      append_le(footer, index_offset, 8);
+      append_le(footer, chunks_.size(), 4);
+      append_le(footer, shard_count_, 4);
+      append_le(footer, key_index_offset, 8);
+      append_le(footer, key_index_slots, 8);
+      append_le(footer, key_index_crc, 8);
+      footer += static_cast<char>(eof_marker);
+      // 로더가 chunk를 읽기 전에 확인하는 부분 (header, index, footer)의 checksum
+      const std::uint64_t crc =
+          crc64(crc64(crc64(0, header_.data(), header_.size()), index.data(), index.size()), footer.data(), footer.size());
+      append_le(footer, crc, 8);
+      write_raw(footer.data(), footer.size());
+#ifdef __linux__
+      if (::fsync(fd_) != 0)
+      {
+        io_error("cannot fsync", path_);
+      }
+      ::close(fd_);
+      fd_ = -1;
+#else
+      if (std::fflush(file_) != 0)
+      {
+        io_error("cannot write", path_);
+      }
+      std::fclose(file_);
+      file_ = nullptr;
+#endif
+    }
+
+    reader::reader(const std::string &path, bool sequential) : path_(path)
+    {
+#ifdef __linux__
+      const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0)
+      {
+        io_error("cannot open", path);
+      }
+      struct stat st;
+      if (::fstat(fd, &st) != 0)
+      {
+        ::close(fd);
+        io_error("cannot stat", path);
+      }
+      size_ = static_cast<std::size_t>(st.st_size);
+      if (size_ > 0)
+      {
+        void *p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+          ::close(fd);
+          io_error("cannot map", path);
+        }
+        // chunk마다 처음부터 끝까지 한 번씩 읽으므로 미리 읽기를 크게 하도록 알림
+        // (key index로 키를 하나씩 찾을 때는 쓰지 않는 페이지까지 읽지 않도록 기본값 유지)
+        if (sequential)
+        {
+          ::madvise(p, size_, MADV_SEQUENTIAL);
+        }
+        data_ = static_cast<const char *>(p);
+      }
+      ::close(fd);
+#else
+      std::ifstream in(path, std::ios::binary);
+      if (!in)
+      {
+        io_error("cannot open", path);
+      }
+      contents_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+      data_ = contents_.data();
+      size_ = contents_.size();
+#endif
+      const auto *bytes = reinterpret_cast<const unsigned char *>(data_);
+      if (size_ < header_size + 1 + 8 || std::memcmp(data_, magic, sizeof(magic)) != 0)
+      {
+        fail("ERR " + path + " is not a snapshot file");
+      }
+      const auto file_version = static_cast<std::uint32_t>(load_le(bytes + 4, 4));
+      key_count_ = load_le64(bytes + 8);
+      saved_unix_ms_ = static_cast<std::int64_t>(load_le64(bytes + 16));
+
+      if (file_version == legacy_version)
+      {
+        // 레코드... | eof_marker | 전체 CRC: 파일 전체를 확인하고 레코드 전체를 한 chunk로 봄
+        const std::size_t end = size_ - 8;
+        if (bytes[end - 1] != eof_marker || crc64(0, data_, end) != load_le64(bytes + end))
+        {
+          fail("ERR snapshot checksum mismatch in " + path);
+        }
+        chunk_info chunk;
+        chunk.offset = header_size;
+        chunk.size = end - 1 - header_size;
+        chunk.keys = key_count_;
+        chunks_.push_back(chunk);
+        verified_ = true;
+        return;
+      }
+      if (file_version != version && file_version != unindexed_version)
+      {
+        fail("ERR unsupported snapshot version " + std::to_string(file_version) + " in " + path);
+      }
+
+      // footer와 index (와 key index)를 확인한 뒤 chunk 목록을 만듦 (chunk 자체는 chunk()에서 확인)
+      const std::size_t footer_bytes = file_version == version ? footer_size : unindexed_footer_size;
+      if (size_ < header_size + footer_bytes)
+      {
+        fail("ERR snapshot is truncated: " + path);
+      }
+      const auto *footer = bytes + size_ - footer_bytes;
+      const std::uint64_t index_offset = load_le64(footer);
+      const auto chunk_count = static_cast<std::size_t>(load_le(footer + 8, 4));
+      shard_count_ = static_cast<std::uint32_t>(load_le(footer + 12, 4));
+      // version 2는 index 바로 뒤가 footer
+      std::uint64_t index_end = size_ - footer_bytes;
+      std::uint64_t key_index_crc = 0;
+      const auto *rest = footer + 16;
+      if (file_version == version)
+      {
+        index_end = load_le64(footer + 16);
+        key_index_slots_ = load_le64(footer + 24);
+        key_index_crc = load_le64(footer + 32);
+        rest = footer + 40;
+      }
+      if (rest[0] != eof_marker || index_offset < header_size || index_end > size_ - footer_bytes ||
+          index_offset + std::uint64_t(chunk_count) * index_entry_size != index_end ||
+          (size_ - footer_bytes - index_end) / 8 != key_index_slots_ || (size_ - footer_bytes - index_end) % 8 != 0)
+      {
+        fail("ERR snapshot checksum mismatch in " + path);
+      }
+      const std::size_t index_bytes = chunk_count * index_entry_size;
+      std::uint64_t crc = crc64(crc64(0, data_, header_size), data_ + index_offset, index_bytes);
+      crc = crc64(crc, footer, footer_bytes - 8);
+      if (crc != load_le64(bytes + size_ - 8))
+      {
+        fail("ERR snapshot checksum mismatch in " + path);
+      }
+      if (key_index_slots_ != 0)
+      {
+        // 슬롯 수는 2의 거듭제곱이어야 조회의 mask가 맞음
+        key_index_ = bytes + index_end;
+        if ((key_index_slots_ & (key_index_slots_ - 1)) != 0 ||
+            crc64(0, key_index_, static_cast<std::size_t>(key_index_slots_) * 8) != key_index_crc)
+        {
+          fail("ERR snapshot has a malformed key index in " + path);
+        }
+      }
+      chunks_.reserve(chunk_count);
+      std::uint64_t expected_offset = header_size;
+      for (std::size_t i = 0; i < chunk_count; ++i)
+      {
+        const auto *entry = bytes + index_offset + i * index_entry_size;
+        chunk_info chunk;
+        chunk.offset = load_le64(entry);
+        chunk.size = load_le64(entry + 8);
+        chunk.keys = load_le64(entry + 16);
+        chunk.shard = static_cast<std::uint32_t>(load_le(entry + 24, 4));
+        chunk.crc = load_le64(entry + 28);
+        // chunk는 header 뒤부터 index 앞까지 빈틈없이 이어짐
+        if (chunk.offset != expected_offset || chunk.size > index_offset - chunk.offset)
+        {
+          fail("ERR snapshot has a malformed chunk index in " + path);
+        }
+        expected_offset = chunk.offset + chunk.size;
+        chunks_.push_back(chunk);
+      }
+      if (expected_offset != index_offset)
+      {
+        fail("ERR snapshot has a malformed chunk index in " + path);
+      }
+    }
+
+    std::string_view reader::chunk(std::size_t i) const
+    {
+      const auto &info = chunks_.at(i);
+      const std::string_view records(data_ + info.offset, static_cast<std::size_t>(info.size));
+      if (!verified_ && crc64(0, records.data(), records.size()) != info.crc)
+      {
+        throw std::runtime_error("ERR snapshot checksum mismatch in chunk " + std::to_string(i) + " of " + path_);
+      }
+      return records;
+    }
+
+    std::string_view reader::unchecked_chunk(std::size_t i) const
+    {
+      const auto &info = chunks_.at(i);
+      return std::string_view(data_ + info.offset, static_cast<std::size_t>(info.size));
+    }
+
+    void reader::will_need(std::size_t i) const
+    {
+#ifdef __linux__
+      const auto &info = chunks_.at(i);
+      const auto page = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+      const std::uint64_t begin = info.offset / page * page;
+      ::madvise(const_cast<char *>(data_) + begin, static_cast<std::size_t>(info.offset + info.size - begin),
+                MADV_WILLNEED);
+#else
+      (void)i;
+#endif
+    }
+
+    std::size_t reader::chunk_at(std::uint64_t offset) const
+    {
+      // offset보다 뒤에서 시작하는 첫 chunk의 바로 앞 chunk
+      auto it = std::upper_bound(chunks_.begin(), chunks_.end(), offset,
+                                 [](std::uint64_t off, const chunk_info &c) { return off < c.offset; });
+      if (it == chunks_.begin() || offset >= std::prev(it)->offset + std::prev(it)->size)
+      {
+        return chunks_.size();
+      }
+      return static_cast<std::size_t>(std::prev(it) - chunks_.begin());
+    }
+
+    std::uint64_t reader::key_index_slot(std::uint64_t i) const
+    {
+      return load_le64(key_index_ + i * 8);
+    }
+
+    void reader::fail(const std::string &message)
+    {
+      release();
+      throw std::runtime_error(message);
+    }
+
+    reader::~reader()
+    {
+      release();
+    }
+
+    void reader::release()
+    {
+#ifdef __linux__
+      if (data_)
+      {
+        ::munmap(const_cast<char *>(data_), size_);
+        data_ = nullptr;
+      }
+#endif
+    }
+
+    void decoder::need(std::size_t n) const
+    {
+      if (n > end_ - pos_)
+      {
+        throw std::runtime_error("ERR snapshot is truncated");
+      }
+    }
+
+    std::uint32_t decoder::get_u32()
+    {
+      need(4);
+      const auto *p = reinterpret_cast<const unsigned char *>(data_ + pos_);
+      pos_ += 4;
+      return p[0] | (std::uint32_t(p[1]) << 8) | (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+    }
+
+    std::uint64_t decoder::get_u64()
+    {
+      need(8);
+      const auto v = load_le64(reinterpret_cast<const unsigned char *>(data_ + pos_));
+      pos_ += 8;
+      return v;
+    }
+
+    std::uint64_t decoder::get_varint()
+    {
+      std::uint64_t v = 0;
+      for (unsigned shift = 0; shift < 64; shift += 7)
+      {
+        const std::uint8_t b = get_u8();
+        v |= std::uint64_t(b & 0x7f) << shift;
+        if (!(b & 0x80))
+        {
+          return v;
+        }
+      }
+      throw std::runtime_error("ERR snapshot has a malformed length");
+    }
+
+    double decoder::get_double()
+    {
+      const std::uint64_t bits = get_u64();
+      double v;
+      std::memcpy(&v, &bits, sizeof(v));
+      return v;
+    }
+
+    std::string_view decoder::get_string()
+    {
+      const std::uint64_t n = get_varint();
+      need(n);
+      const std::string_view s(data_ + pos_, n);
+      pos_ += n;
+      return s;
+    }
+  } // namespace snapshot
+} // namespace mini_redis
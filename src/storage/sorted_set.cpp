@@ -0,0 +1,615 @@
+#include "storage/sorted_set.hpp"
+#include "storage/value_entry.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <new>
+
+namespace mini_redis
+{
+  namespace
+  {
+    // (s1, m1)이 (s2, m2)보다 앞인지 (점수, 같으면 member의 byte 순서)
+    inline bool ordered_before(double s1, std::string_view m1, double s2, std::string_view m2)
+    {
+      return s1 < s2 || (s1 == s2 && m1 < m2);
+    }
+
+    inline bool in_range(const score_range &range, std::string_view, double score)
+    {
+      return range.above_min(score) && range.below_max(score);
+    }
+
+    inline bool in_range(const lex_range &range, std::string_view member, double)
+    {
+      return range.above_min(member) && range.below_max(member);
+    }
+
+    // skiplist 노드의 level 수: 1에서 시작해 1/4 확률로 하나씩 높아짐 (Redis의 ZSKIPLIST_P)
+    int random_height(int max_level)
+    {
+      static thread_local std::uint64_t state = 0x9e3779b97f4a7c15ull ^ reinterpret_cast<std::uintptr_t>(&state);
+      // xorshift64*
+      state ^= state >> 12;
+      state ^= state << 25;
+      state ^= state >> 27;
+      std::uint64_t bits = state * 0x2545f4914f6cdd1dull;
+      int height = 1;
+      while (height < max_level && (bits & 3) == 0)
+      {
+        ++height;
+        bits >>= 2;
+      }
+      return height;
+    }
+  } // namespace
+
+  std::string format_score(double score)
+  {
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), score);
+    return std::string(buf, result.ptr);
+  }
+
+  sorted_set::node *sorted_set::make_node(int height, std::string_view member, double score)
+  {
+    void *memory = ::operator new(node_size(height));
+    node *x = new (memory) node{std::string(member), score, nullptr, height};
+    for (int i = 0; i < height; ++i)
+    {
+      new (&x->levels()[i]) level{nullptr, 0};
+    }
+    return x;
+  }
+
+  void sorted_set::free_node(node *x)
+  {
+    x->~node();
+    ::operator delete(x);
+  }
+
+  sorted_set::skiplist::skiplist() : header(make_node(max_level, {}, 0)) {}
+
+  sorted_set::skiplist::~skiplist()
+  {
+    node *x = header->levels()[0].forward;
+    while (x)
+    {
+      node *next = x->levels()[0].forward;
+      free_node(x);
+      x = next;
+    }
+    free_node(header);
+  }
+
+  sorted_set::node *sorted_set::skiplist::insert(std::string_view member, double score)
+  {
+    node *update[max_level];
+    std::size_t rank[max_level];
+    node *x = header;
+    for (int i = height - 1; i >= 0; --i)
+    {
+      // rank[i]: update[i]까지 지나온 원소 수
+      rank[i] = i == height - 1 ? 0 : rank[i + 1];
+      while (x->levels()[i].forward &&
+             ordered_before(x->levels()[i].forward->score, x->levels()[i].forward->member, score, member))
+      {
+        rank[i] += x->levels()[i].span;
+        x = x->levels()[i].forward;
+      }
+      update[i] = x;
+    }
+
+    const int new_height = random_height(max_level);
+    if (new_height > height)
+    {
+      for (int i = height; i < new_height; ++i)
+      {
+        rank[i] = 0;
+        update[i] = header;
+        header->levels()[i].span = length;
+      }
+      height = new_height;
+    }
+
+    x = make_node(new_height, member, score);
+    for (int i = 0; i < new_height; ++i)
+    {
+      level &prev = update[i]->levels()[i];
+      x->levels()[i].forward = prev.forward;
+      prev.forward = x;
+      // prev에서 x까지는 (rank[0] - rank[i]) + 1칸, x에서 원래 forward까지는 그 나머지
+      x->levels()[i].span = prev.span - (rank[0] - rank[i]);
+      prev.span = (rank[0] - rank[i]) + 1;
+    }
+    // x보다 높은 level은 x를 건너뛰므로 span이 하나 늘어남
+    for (int i = new_height; i < height; ++i)
+    {
+      ++update[i]->levels()[i].span;
+    }
+
+    x->backward = update[0] == header ? nullptr : update[0];
+    if (x->levels()[0].forward)
+    {
+      x->levels()[0].forward->backward = x;
+    }
+    else
+    {
+      tail = x;
+    }
+    ++length;
+    dict.emplace(std::string_view(x->member), x);
+    node_bytes += node_size(new_height) + string_heap_bytes(x->member);
+    return x;
+  }
+
+  void sorted_set::skiplist::erase(node *target)
+  {
+    node *update[max_level];
+    node *x = header;
+    for (int i = height - 1; i >= 0; --i)
+    {
+      while (x->levels()[i].forward && x->levels()[i].forward != target &&
+             ordered_before(x->levels()[i].forward->score, x->levels()[i].forward->member, target->score,
+                            target->member))
+      {
+        x = x->levels()[i].forward;
+      }
+      update[i] = x;
+    }
+
+    for (int i = 0; i < height; ++i)
+    {
+      level &prev = update[i]->levels()[i];
+      if (prev.forward == target)
+      {
+        prev.span += target->levels()[i].span - 1;
+        prev.forward = target->levels()[i].forward;
+      }
+      else
+      {
+        --prev.span;
+      }
+    }
+    if (target->levels()[0].forward)
+    {
+      target->levels()[0].forward->backward = target->backward;
+    }
+    else
+    {
+      tail = target->backward;
+    }
+    while (height > 1 && !header->levels()[height - 1].forward)
+    {
+      --height;
+    }
+    --length;
+    dict.erase(std::string_view(target->member));
+    node_bytes -= node_size(target->height) + string_heap_bytes(target->member);
+    free_node(target);
+  }
+
+  sorted_set::node *sorted_set::skiplist::update_score(node *x, double score)
+  {
+    // 새 점수로도 이웃 사이의 순서가 그대로이면 (리더보드의 작은 증감 등) 노드를 옮기지 않음
+    const node *prev = x->backward;
+    const node *next = x->levels()[0].forward;
+    if ((!prev || ordered_before(prev->score, prev->member, score, x->member)) &&
+        (!next || ordered_before(score, x->member, next->score, next->member)))
+    {
+      x->score = score;
+      return x;
+    }
+    const std::string member = x->member;
+    erase(x);
+    return insert(member, score);
+  }
+
+  sorted_set::node *sorted_set::skiplist::at_rank(std::size_t rank) const
+  {
+    node *x = header;
+    std::size_t traversed = 0;
+    for (int i = height - 1; i >= 0; --i)
+    {
+      while (x->levels()[i].forward && traversed + x->levels()[i].span <= rank)
+      {
+        traversed += x->levels()[i].span;
+        x = x->levels()[i].forward;
+      }
+      if (traversed == rank)
+      {
+        return x == header ? nullptr : x;
+      }
+    }
+    return nullptr;
+  }
+
+  std::size_t sorted_set::skiplist::rank_of(const node *target) const
+  {
+    const node *x = header;
+    std::size_t rank = 0;
+    for (int i = height - 1; i >= 0; --i)
+    {
+      while (x->levels()[i].forward &&
+             (x->levels()[i].forward == target ||
+              ordered_before(x->levels()[i].forward->score, x->levels()[i].forward->member, target->score,
+                             target->member)))
+      {
+        rank += x->levels()[i].span;
+        x = x->levels()[i].forward;
+      }
+      if (x == target)
+      {
+        return rank;
+      }
+    }
+    return 0;
+  }
+
+  sorted_set::node *sorted_set::skiplist::first_in_range(const score_range &range) const
+  {
+    node *x = header;
+    for (int i = height - 1; i >= 0; --i)
+    {
+      while (x->levels()[i].forward && !range.above_min(x->levels()[i].forward->score))
+      {
+        x = x->levels()[i].forward;
+      }
+    }
+    x = x->levels()[0].forward;
+    return x && range.below_max(x->score) ? x : nullptr;
+  }
+
+  sorted_set::node *sorted_set::skiplist::last_in_range(const score_range &range) const
+  {
+    node *x = header;
+    for (int i = height - 1; i >= 0; --i)
+    {
+      while (x->levels()[i].forward && range.below_max(x->levels()[i].forward->score))
+      {
+        x = x->levels()[i].forward;
+      }
+    }
+    return x != header && range.above_min(x->score) ? x : nullptr;
+  }
+
+  sorted_set::node *sorted_set::skiplist::first_in_range(const lex_range &range) const
+  {
+    node *x = header;
+    for (int i = height - 1; i >= 0; --i)
+    {
+      while (x->levels()[i].forward && !range.above_min(x->levels()[i].forward->member))
+      {
+        x = x->levels()[i].forward;
+      }
+    }
+    x = x->levels()[0].forward;
+    return x && range.below_max(x->member) ? x : nullptr;
+  }
+
+  sorted_set::node *sorted_set::skiplist::last_in_range(const lex_range &range) const
+  {
+    node *x = header;
+    for (int i = height - 1; i >= 0; --i)
+    {
+      while (x->levels()[i].forward && range.below_max(x->levels()[i].forward->member))
+      {
+        x = x->levels()[i].forward;
+      }
+    }
+    return x != header && range.above_min(x->member) ? x : nullptr;
+  }
+
+  sorted_set::sorted_set(const sorted_set &other)
+      : packed_(other.packed_), count_(other.count_), opts_(other.opts_)
+  {
+    if (other.skiplist_)
+    {
+      skiplist_ = std::make_unique<skiplist>();
+      skiplist_->dict.reserve(other.size());
+      other.for_each([&](std::string_view member, double score) { skiplist_->insert(member, score); });
+    }
+  }
+
+  sorted_set &sorted_set::operator=(const sorted_set &other)
+  {
+    if (this != &other)
+    {
+      sorted_set copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  double sorted_set::packed_score(const char *p, std::size_t &size)
+  {
+    const std::string_view bytes = listpack::read(p, size);
+    double score;
+    std::memcpy(&score, bytes.data(), sizeof(score));
+    return score;
+  }
+
+  std::size_t sorted_set::find_packed(std::string_view member, std::size_t &score_at) const
+  {
+    std::size_t pos = 0;
+    while (pos < packed_.size())
+    {
+      std::size_t member_size;
+      const std::string_view candidate = listpack::read(packed_.data() + pos, member_size);
+      if (candidate == member)
+      {
+        score_at = pos + member_size;
+        return pos;
+      }
+      std::size_t score_size;
+      listpack::read(packed_.data() + pos + member_size, score_size);
+      pos += member_size + score_size;
+    }
+    return std::string::npos;
+  }
+
+  void sorted_set::insert_packed(std::string_view member, double score)
+  {
+    // 순서상 새 원소보다 뒤인 첫 원소 앞에 끼워 넣음
+    std::size_t pos = 0;
+    while (pos < packed_.size())
+    {
+      std::size_t member_size, score_size;
+      const std::string_view candidate = listpack::read(packed_.data() + pos, member_size);
+      const double candidate_score = packed_score(packed_.data() + pos + member_size, score_size);
+      if (ordered_before(score, member, candidate_score, candidate))
+      {
+        break;
+      }
+      pos += member_size + score_size;
+    }
+    std::string entry;
+    entry.reserve(listpack::entry_size(member.size()) + listpack::entry_size(sizeof(score)));
+    listpack::append(entry, member);
+    char bytes[sizeof(score)];
+    std::memcpy(bytes, &score, sizeof(score));
+    listpack::append(entry, std::string_view(bytes, sizeof(bytes)));
+    packed_.insert(pos, entry);
+  }
+
+  void sorted_set::convert_to_skiplist()
+  {
+    auto list = std::make_unique<skiplist>();
+    list->dict.reserve(count_ + 1);
+    for_each([&](std::string_view member, double score) { list->insert(member, score); });
+    skiplist_ = std::move(list);
+    std::string().swap(packed_);
+    count_ = 0;
+  }
+
+  bool sorted_set::insert(std::string_view member, double score)
+  {
+    if (skiplist_)
+    {
+      auto it = skiplist_->dict.find(member);
+      if (it == skiplist_->dict.end())
+      {
+        skiplist_->insert(member, score);
+        return true;
+      }
+      if (it->second->score != score)
+      {
+        skiplist_->update_score(it->second, score);
+      }
+      return false;
+    }
+
+    std::size_t score_at;
+    const std::size_t pos = find_packed(member, score_at);
+    if (pos != std::string::npos)
+    {
+      std::size_t score_size;
+      if (packed_score(packed_.data() + score_at, score_size) != score)
+      {
+        // 위치가 바뀔 수 있으므로 지우고 다시 끼워 넣음
+        packed_.erase(pos, score_at + score_size - pos);
+        insert_packed(member, score);
+      }
+      return false;
+    }
+    if (member.size() > opts_.max_listpack_value || count_ + 1 > opts_.max_listpack_entries)
+    {
+      convert_to_skiplist();
+      return insert(member, score);
+    }
+    insert_packed(member, score);
+    ++count_;
+    return true;
+  }
+
+  bool sorted_set::erase(std::string_view member)
+  {
+    if (skiplist_)
+    {
+      auto it = skiplist_->dict.find(member);
+      if (it == skiplist_->dict.end())
+      {
+        return false;
+      }
+      skiplist_->erase(it->second);
+      return true;
+    }
+    std::size_t score_at;
+    const std::size_t pos = find_packed(member, score_at);
+    if (pos == std::string::npos)
+    {
+      return false;
+    }
+    std::size_t score_size;
+    listpack::read(packed_.data() + score_at, score_size);
+    packed_.erase(pos, score_at + score_size - pos);
+    --count_;
+    if (count_ == 0)
+    {
+      packed_.shrink_to_fit();
+    }
+    return true;
+  }
+
+  std::optional<double> sorted_set::score(std::string_view member) const
+  {
+    if (skiplist_)
+    {
+      auto it = skiplist_->dict.find(member);
+      return it == skiplist_->dict.end() ? std::nullopt : std::optional<double>(it->second->score);
+    }
+    std::size_t score_at;
+    if (find_packed(member, score_at) == std::string::npos)
+    {
+      return std::nullopt;
+    }
+    std::size_t size;
+    return packed_score(packed_.data() + score_at, size);
+  }
+
+  std::optional<std::size_t> sorted_set::rank(std::string_view member, bool reverse) const
+  {
+    std::size_t forward_rank;
+    if (skiplist_)
+    {
+      auto it = skiplist_->dict.find(member);
+      if (it == skiplist_->dict.end())
+      {
+        return std::nullopt;
+      }
+      forward_rank = skiplist_->rank_of(it->second) - 1;
+    }
+    else
+    {
+      std::size_t index = 0;
+      std::optional<std::size_t> found;
+      for_each([&](std::string_view candidate, double) {
+        if (!found && candidate == member)
+        {
+          found = index;
+        }
+        ++index;
+      });
+      if (!found)
+      {
+        return std::nullopt;
+      }
+      forward_rank = *found;
+    }
+    return reverse ? size() - 1 - forward_rank : forward_rank;
+  }
+
+  sorted_set::entries sorted_set::range_by_rank(std::size_t start, std::size_t stop, bool reverse) const
+  {
+    entries result;
+    const std::size_t n = size();
+    if (start > stop || start >= n)
+    {
+      return result;
+    }
+    stop = std::min(stop, n - 1);
+    result.reserve(stop - start + 1);
+    if (skiplist_)
+    {
+      // 첫 원소만 O(log n)에 찾고 나머지는 level 0을 따라감
+      const node *x = skiplist_->at_rank(reverse ? n - start : start + 1);
+      for (std::size_t i = start; i <= stop && x; ++i)
+      {
+        result.emplace_back(x->member, x->score);
+        x = reverse ? x->backward : x->levels()[0].forward;
+      }
+      return result;
+    }
+    // listpack은 정방향 위치 [first, last]를 모은 뒤 필요하면 뒤집음
+    const std::size_t first = reverse ? n - 1 - stop : start;
+    const std::size_t last = reverse ? n - 1 - start : stop;
+    std::size_t index = 0;
+    for_each([&](std::string_view member, double score) {
+      if (index >= first && index <= last)
+      {
+        result.emplace_back(member, score);
+      }
+      ++index;
+    });
+    if (reverse)
+    {
+      std::reverse(result.begin(), result.end());
+    }
+    return result;
+  }
+
+  template <typename Range>
+  sorted_set::entries sorted_set::packed_range(const Range &range, bool reverse, std::size_t offset,
+                                               std::size_t count) const
+  {
+    std::vector<std::pair<std::string_view, double>> matched;
+    for_each([&](std::string_view member, double score) {
+      if (in_range(range, member, score))
+      {
+        matched.emplace_back(member, score);
+      }
+    });
+    if (reverse)
+    {
+      std::reverse(matched.begin(), matched.end());
+    }
+    entries result;
+    for (std::size_t i = offset; i < matched.size() && result.size() < count; ++i)
+    {
+      result.emplace_back(matched[i].first, matched[i].second);
+    }
+    return result;
+  }
+
+  template <typename Range>
+  sorted_set::entries sorted_set::skiplist_range(const Range &range, bool reverse, std::size_t offset,
+                                                 std::size_t count) const
+  {
+    entries result;
+    const node *x = reverse ? skiplist_->last_in_range(range) : skiplist_->first_in_range(range);
+    if (x && offset > 0)
+    {
+      // LIMIT offset은 하나씩 건너뛰지 않고 순위로 바로 찾아감
+      const std::size_t rank = skiplist_->rank_of(x);
+      if (reverse)
+      {
+        x = offset < rank ? skiplist_->at_rank(rank - offset) : nullptr;
+      }
+      else
+      {
+        x = rank + offset <= skiplist_->length ? skiplist_->at_rank(rank + offset) : nullptr;
+      }
+    }
+    while (x && result.size() < count && in_range(range, x->member, x->score))
+    {
+      result.emplace_back(x->member, x->score);
+      x = reverse ? x->backward : x->levels()[0].forward;
+    }
+    return result;
+  }
+
+  sorted_set::entries sorted_set::range_by_score(const score_range &range, bool reverse, std::size_t offset,
+                                                 std::size_t count) const
+  {
+    return skiplist_ ? skiplist_range(range, reverse, offset, count) : packed_range(range, reverse, offset, count);
+  }
+
+  sorted_set::entries sorted_set::range_by_lex(const lex_range &range, bool reverse, std::size_t offset,
+                                               std::size_t count) const
+  {
+    return skiplist_ ? skiplist_range(range, reverse, offset, count) : packed_range(range, reverse, offset, count);
+  }
+
+  std::size_t sorted_set::memory_usage() const
+  {
+    std::size_t total = sizeof(sorted_set) + string_heap_bytes(packed_);
+    if (skiplist_)
+    {
+      // dict 노드마다 next 포인터, 캐시된 해시 값, string_view key와 노드 포인터
+      total += sizeof(skiplist) + node_size(max_level) + skiplist_->node_bytes +
+               skiplist_->dict.bucket_count() * sizeof(void *) +
+               skiplist_->dict.size() * (3 * sizeof(void *) + sizeof(std::string_view));
+    }
+    return total;
+  }
+} // namespace mini_redis
@@ -1,249 +1,4118 @@
 #include "storage/store.hpp"
+#include "storage/collection_scan.hpp"
+#include "storage/glob.hpp"
+#include "protocol/serializer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <limits>
 #include <stdexcept>
+#include <thread>
+#ifdef __linux__
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 namespace mini_redis
 {
-  // private helper function
-  bool store::is_key_expired(const value_entry &entry)
+  /*
+   * load_snapshot_lazily로 연 스냅샷. 레코드는 key index 슬롯 하나에 대응하며, 그 슬롯의 bit를 켠
+   * 스레드만 레코드를 넣음. 넣을 레코드의 bit는 그 키의 shard 쓰기 잠금 안에서만 켜므로, 키를 처음 다루는
+   * 명령(fault_in)과 백그라운드 스레드가 같은 레코드를 두 번 넣지 않음. 읽을 수 없는 레코드의 bit는
+   * 잠금 없이 켜고 넣지 않음. 어느 쪽이든 shard 잠금은 한 번에 하나만 잡음.
+   */
+  struct store::lazy_snapshot
   {
-    if (entry.expiry.has_value())
+    static constexpr std::uint64_t npos = static_cast<std::uint64_t>(-1);
+    // 백그라운드 적재가 shard 잠금 한 번에 넣는 최대 레코드 수 (잠금 시간의 상한)
+    static constexpr std::size_t batch_records = 32;
+
+    explicit lazy_snapshot(const std::string &path)
+        : in(path, false), mask(in.key_index_slots() - 1),
+          loaded((in.key_index_slots() + 63) / 64), chunk_state(in.chunks().size())
+    {
+    }
+
+    bool is_loaded(std::uint64_t slot) const
+    {
+      return (loaded[slot / 64].load(std::memory_order_acquire) >> (slot % 64)) & 1;
+    }
+    // 슬롯의 bit를 켬. 이 호출이 켰으면 true (레코드를 맡은 것)
+    bool claim(std::uint64_t slot)
+    {
+      const std::uint64_t bit = std::uint64_t(1) << (slot % 64);
+      if ((loaded[slot / 64].fetch_or(bit, std::memory_order_acq_rel) & bit) != 0)
+      {
+        return false;
+      }
+      remaining.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    // offset의 레코드를 가리키는 슬롯 (키 해시 h로 찾음)
+    std::uint64_t find_slot(flat_table::hash_type h, std::uint64_t offset) const
+    {
+      for (std::uint64_t pos = h & mask, n = 0; n <= mask; pos = (pos + 1) & mask, ++n)
+      {
+        const std::uint64_t slot = in.key_index_slot(pos);
+        if (slot == 0)
+        {
+          break;
+        }
+        if (snapshot::key_slot_offset(slot) == offset)
+        {
+          return pos;
+        }
+      }
+      throw std::runtime_error("ERR snapshot key index does not match its records");
+    }
+
+    // chunk를 처음 읽을 때 checksum을 한 번 확인함. 손상된 chunk는 기록하고 다시 확인하지 않음
+    bool check_chunk(std::size_t c)
     {
-      if (std::chrono::steady_clock::now() > entry.expiry.value())
+      const auto state = chunk_state[c].load(std::memory_order_acquire);
+      if (state != chunk_unchecked)
+      {
+        return state == chunk_ok;
+      }
+      try
       {
+        in.chunk(c);
+        chunk_state[c].store(chunk_ok, std::memory_order_release);
         return true;
       }
+      catch (const std::exception &e)
+      {
+        chunk_state[c].store(chunk_corrupt, std::memory_order_release);
+        fail(e.what());
+        return false;
+      }
+    }
+
+    void fail(const std::string &message)
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      if (error.empty())
+      {
+        error = message;
+      }
+    }
+
+    static constexpr std::uint8_t chunk_unchecked = 0;
+    static constexpr std::uint8_t chunk_ok = 1;
+    static constexpr std::uint8_t chunk_corrupt = 2;
+
+    const snapshot::reader in;
+    const std::uint64_t mask;                          // key index 슬롯 수 - 1
+    std::vector<std::atomic<std::uint64_t>> loaded;    // 슬롯마다 1 bit: 레코드를 누군가 맡았음
+    std::vector<std::atomic<std::uint8_t>> chunk_state;
+    std::int64_t to_steady = 0;                        // 저장된 벽시계 시각을 steady_clock으로
+    std::atomic<std::size_t> next_chunk{0};            // 백그라운드 적재가 다음에 가져갈 chunk
+    std::atomic<std::size_t> done_chunks{0};
+    std::atomic<std::uint64_t> done_bytes{0};
+    std::uint64_t total_bytes = 0;                     // chunk bytes의 합
+    std::atomic<std::uint64_t> remaining{0};           // 아직 아무도 맡지 않은 레코드 수
+    std::atomic<std::uint64_t> faulted{0};
+    std::atomic<bool> stop{false};                     // store 소멸 중
+    snapshot_progress progress;
+
+    std::mutex mutex; // 아래 셋과 progress 호출을 보호
+    std::condition_variable done;
+    bool finished = false;
+    std::string error;
+  };
+
+  store::store(const store_config &config)
+      : shard_count_(std::max<std::size_t>(1, config.shards)),
+        shards_(new shard[shard_count_]),
+        list_options_{config.list_node_bytes, config.list_compress_depth},
+        hash_options_{static_cast<std::uint32_t>(config.hash_max_listpack_entries),
+                      static_cast<std::uint32_t>(config.hash_max_listpack_value)},
+        set_options_{static_cast<std::uint32_t>(config.set_max_intset_entries)},
+        zset_options_{static_cast<std::uint32_t>(config.zset_max_listpack_entries),
+                      static_cast<std::uint32_t>(config.zset_max_listpack_value)},
+        hll_options_{static_cast<std::uint32_t>(config.hll_sparse_max_bytes)},
+        stream_options_{static_cast<std::uint32_t>(std::max<std::size_t>(1, config.stream_node_max_entries)),
+                        static_cast<std::uint32_t>(config.stream_node_max_bytes)},
+        maxmemory_(config.maxmemory),
+        policy_(config.maxmemory_policy),
+        maxmemory_samples_(std::max<std::size_t>(1, config.maxmemory_samples)),
+        dir_(config.dir.empty() ? "." : config.dir),
+        dbfilename_(config.dbfilename)
+  {
+    last_save_time_ = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+    for (std::size_t i = 0; i < shard_count_; ++i)
+    {
+      if (!config.slab_allocator)
+      {
+        shards_[i].data = flat_table(false);
+      }
+      if (config.key_index)
+      {
+        shards_[i].data.enable_key_index();
+      }
     }
-    return false;
   }
 
-  void store::set(const std::string &key, const std::string &value)
+  std::size_t store::shard_index(flat_table::hash_type h) const
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    data_[key] = {RedisString(value), std::nullopt};
+    // flat_table은 해시의 하위 bits로 슬롯을 고르므로, shard 선택에는 상위 32 bits를 사용하여
+    // 같은 shard에 모인 키들의 슬롯 분포가 치우치지 않도록 함
+    return static_cast<std::size_t>((h >> 32) % shard_count_);
   }
 
-  void store::setex(const std::string &key, int ttl_seconds, const std::string &value)
+  store::shard &store::shard_for(flat_table::hash_type h)
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto expiry_time = std::chrono::steady_clock::now() + std::chrono::seconds(ttl_seconds);
-    data_[key] = {RedisString(value), expiry_time};
+    if (loading_.load(std::memory_order_acquire))
+    {
+      fault_in(h);
+    }
+    return shards_[shard_index(h)];
   }
 
-  std::optional<std::string> store::get(const std::string &key)
+  std::vector<std::size_t> store::sorted_shards(const std::vector<flat_table::hash_type> &hashes) const
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = data_.find(key);
-    if (it == data_.end())
+    std::vector<std::size_t> indices;
+    indices.reserve(hashes.size());
+    for (auto h : hashes)
     {
-      return std::nullopt;
+      indices.push_back(shard_index(h));
     }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    return indices;
+  }
 
-    // Check if the key is expired
-    if (is_key_expired(it->second))
+  std::vector<store::write_lock> store::lock_shards(const std::vector<flat_table::hash_type> &hashes)
+  {
+    // lazy 적재 중이면 잠그기 전에 키들을 먼저 읽어 둠 (잠근 뒤의 shard_for는 잠금을 잡지 않게 됨)
+    if (loading_.load(std::memory_order_acquire))
     {
-      data_.erase(it);
-      return std::nullopt;
+      for (const auto h : hashes)
+      {
+        fault_in(h);
+      }
+    }
+    // 항상 오름차순으로 잠가서 교착 상태(deadlock)를 방지
+    const auto indices = sorted_shards(hashes);
+    std::vector<write_lock> locks;
+    locks.reserve(indices.size());
+    for (auto idx : indices)
+    {
+      locks.emplace_back(shards_[idx].mutex);
+      reclaim_expired(shards_[idx]);
     }
+    return locks;
+  }
 
-    // Check if the value is a string
-    if (auto val_ptr = std::get_if<RedisString>(&it->second.value))
+  std::vector<store::read_lock> store::lock_shards_shared(const std::vector<flat_table::hash_type> &hashes)
+  {
+    if (loading_.load(std::memory_order_acquire))
+    {
+      for (const auto h : hashes)
+      {
+        fault_in(h);
+      }
+    }
+    const auto indices = sorted_shards(hashes);
+    std::vector<read_lock> locks;
+    locks.reserve(indices.size());
+    for (auto idx : indices)
     {
-      return *val_ptr;
+      locks.emplace_back(shards_[idx].mutex);
     }
+    return locks;
+  }
+
+  void store::set_expiry(shard &sh, flat_table::hash_type h, value_entry &entry, std::int64_t deadline_ms)
+  {
+    entry.expiry = deadline_ms;
+    // is_key_expired는 now > expiry 기준이므로 인덱스에는 그다음 ms를 만료 시각으로 등록
+    sh.expires.insert(h, deadline_ms + 1);
 
-    // The key exists but is not a string type
-    return std::nullopt;
+    // TTL 갱신이나 삭제로 무효가 된 항목은 만료 시점까지 인덱스에 남으므로,
+    // 키 수에 비해 너무 많이 쌓이면 테이블 기준으로 인덱스를 다시 만듦 (삽입 횟수에 대해 amortized O(1))
+    if (sh.expires.size() > 2 * sh.data.size() + 1024)
+    {
+      sh.expires.clear();
+      sh.data.for_each([&sh](std::string_view key, const value_entry &e) {
+        if (e.has_expiry())
+        {
+          sh.expires.insert(flat_table::hash(key), e.expiry + 1);
+        }
+      });
+    }
   }
 
-  int store::del(const std::string &key)
+  void store::defer_expired(shard &sh, const std::string &key)
   {
-    return del(std::vector<std::string>{key});
+    // 같은 키가 여러 번 기록될 수 있지만, reclaim_expired에서 다시 만료 여부를 확인하므로 문제없음
+    std::lock_guard<std::mutex> lock(sh.expired_mutex);
+    sh.expired_keys.push_back(key);
+    sh.has_expired.store(true, std::memory_order_release);
   }
 
-  // 멀티 키 삭제
-  // 이 함수는 벡터로 전달된 여러 키를 삭제합니다.
-  // 각 키에 대해 data_ 맵에서 해당 키를 찾아 삭제하고, 삭제된 키의 개수를 반환합니다.
-  // 만약 키가 존재하지 않으면 삭제되지 않습니다.
-  // 이 함수는 멀티 스레드 환경에서 안전하게 동작하도록 mutex를 사용하여 동기화합니다.
-  int store::del(const std::vector<std::string> &keys)
+  void store::reclaim_expired(shard &sh)
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    int deleted_count = 0;
-    for (const auto &key : keys)
+    // 대부분의 쓰기는 정리할 키가 없으므로 atomic flag만 확인하고 바로 반환
+    if (!sh.has_expired.load(std::memory_order_acquire))
+    {
+      return;
+    }
+
+    std::vector<std::string> pending;
+    {
+      std::lock_guard<std::mutex> lock(sh.expired_mutex);
+      pending.swap(sh.expired_keys);
+      sh.has_expired.store(false, std::memory_order_relaxed);
+    }
+
+    // 기록된 뒤 SET 등으로 값이 갱신되었을 수 있으므로 다시 확인 후 삭제
+    for (const auto &key : pending)
     {
-      if (data_.erase(key))
+      const auto h = flat_table::hash(key);
+      const value_entry *entry = sh.data.find(key, h);
+      if (entry && is_key_expired(*entry))
       {
-        deleted_count++;
+        sh.data.erase(key, h);
+        expired_keys_.fetch_add(1, std::memory_order_relaxed);
       }
     }
-    return deleted_count;
   }
-  
 
-  // Wild card matching
-  bool glob_match(const std::string &pattern, const std::string &text) {
-    size_t p_idx = 0, t_idx = 0;
-    size_t p_len = pattern.length(), t_len = text.length();
-    size_t star_idx = std::string::npos, t_match_idx = 0;
+  void store::rehash_step(std::chrono::microseconds budget)
+  {
+    // 잠금 한 번에 옮기는 슬롯 수. 작게 유지하여 같은 shard의 명령이 오래 기다리지 않도록 함
+    constexpr std::size_t slots_per_lock = 1024;
+    const auto deadline = std::chrono::steady_clock::now() + budget;
 
-    while (t_idx < t_len) {
+    for (std::size_t i = 0; i < shard_count_; ++i)
+    {
+      auto &sh = shards_[i];
+      bool rehashing = true;
+      while (rehashing && std::chrono::steady_clock::now() < deadline)
+      {
+        write_lock lock(sh.mutex);
+        // 만료/삭제로 대부분 비어 버린 테이블은 작은 배열로 옮겨 메모리를 돌려줌
+        sh.data.shrink_to_fit();
+        rehashing = sh.data.rehash_step(slots_per_lock);
+        sync_memory(sh);
+      }
+    }
+  }
 
-      // ? 또는 문자 일치
-      if (p_idx < p_len && (pattern[p_idx] == '?' || pattern[p_idx] == text[t_idx])) {
-        p_idx++;
-        t_idx++;
+  void store::defrag_step(std::chrono::microseconds budget)
+  {
+    constexpr std::size_t slots_per_lock = 1024;
+    // 이보다 적게 남는 공간은 옮겨도 돌려받을 slab이 거의 없으므로 무시
+    constexpr std::size_t ignore_free_bytes = 8 * slab_arena::slab_size;
+    const auto deadline = std::chrono::steady_clock::now() + budget;
 
-        // * 일치 시, star_idx를 현재 위치로, t_match_idx를 현재 t_idx로 저장
-      } else if (p_idx < p_len && pattern[p_idx] == '*') {
-        star_idx = p_idx;
-        t_match_idx = t_idx;
-        p_idx++;
+    for (std::size_t n = 0; n < shard_count_; ++n)
+    {
+      auto &sh = shards_[defrag_next_shard_];
+      bool fragmented;
+      {
+        read_lock lock(sh.mutex);
+        const slab_arena *arena = sh.data.arena();
+        const auto stats = arena ? arena->get_stats() : slab_arena::stats{};
+        fragmented = sh.defrag_cursor != 0 ||
+                     (stats.free_bytes() > ignore_free_bytes && stats.free_bytes() * 10 > stats.slab_bytes());
+      }
 
-        // * 일치 후(이제 상관없이 끝까지 검색) 다음 일치되는 문자 찾기
-      } else if (star_idx != std::string::npos) {
-        p_idx = star_idx + 1;
-        t_idx = ++t_match_idx;
+      while (fragmented)
+      {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+          return; // 다음 호출이 이 shard부터 이어서 진행
+        }
+        write_lock lock(sh.mutex);
+        if (sh.data.is_rehashing())
+        {
+          break; // 재해시가 끝난 뒤에 다시 시도
+        }
+        sh.defrag_cursor = sh.data.defrag(sh.defrag_cursor, slots_per_lock);
+        if (sh.defrag_cursor == 0)
+        {
+          sh.data.arena()->release_empty_slabs();
+          fragmented = false;
+        }
+        sync_memory(sh);
+      }
+      defrag_next_shard_ = (defrag_next_shard_ + 1) % shard_count_;
+    }
+  }
 
-        // 해당 없음
-      } else {
-        return false;
+  slab_arena::stats store::allocator_stats()
+  {
+    slab_arena::stats total;
+    for (std::size_t i = 0; i < shard_count_; ++i)
+    {
+      read_lock lock(shards_[i].mutex);
+      if (const slab_arena *arena = shards_[i].data.arena())
+      {
+        const auto &stats = arena->get_stats();
+        total.slabs += stats.slabs;
+        total.empty_slabs += stats.empty_slabs;
+        total.live_objects += stats.live_objects;
+        total.live_bytes += stats.live_bytes;
+        total.requested_bytes += stats.requested_bytes;
       }
     }
+    return total;
+  }
+
+  expire_cycle_result store::active_expire_cycle(std::chrono::microseconds budget)
+  {
+    // 잠금 한 번에 처리하는 인덱스 항목 수. 작게 유지하여 같은 shard의 명령이 오래 기다리지 않도록 함
+    constexpr std::size_t entries_per_batch = 256;
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+    expire_cycle_result result;
+    std::vector<expiry_index::entry> batch;
+    batch.reserve(entries_per_batch);
+
+    for (std::size_t n = 0; n < shard_count_ && !result.timed_out; ++n)
+    {
+      auto &sh = shards_[expire_next_shard_];
+      bool more = true;
+      while (more)
+      {
+        std::size_t expired = 0;
+        {
+          write_lock lock(sh.mutex);
+          reclaim_expired(sh);
+          const auto now = steady_clock_ms();
+          sh.expires.advance(now);
+          batch.clear();
+          sh.expires.take_due(entries_per_batch, batch);
+          for (const auto &e : batch)
+          {
+            // 인덱스에 등록된 뒤 값이 바뀌었을 수 있으므로 테이블의 실제 만료 시각으로 다시 확인
+            if (sh.data.erase_expired(e.hash, now))
+            {
+              ++expired;
+            }
+          }
+          more = sh.expires.has_due();
+          sync_memory(sh);
+        }
+        result.sampled += batch.size();
+        result.expired += expired;
 
-    // 연속된 '*' 처리
-    // 패턴의 끝에서 '*'가 연속으로 있는 경우, 이를 무시하고 패턴이 끝났는지 확인
-    while (p_idx < p_len && pattern[p_idx] == '*') {
-      p_idx++;
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+          // 이 shard부터 다음 사이클에서 이어서 진행
+          result.timed_out = more;
+          break;
+        }
+      }
+      if (!result.timed_out)
+      {
+        expire_next_shard_ = (expire_next_shard_ + 1) % shard_count_;
+      }
     }
 
-    return p_idx == p_len;
+    expired_keys_.fetch_add(result.expired, std::memory_order_relaxed);
+    // Redis의 expired_stale_perc와 같이 이번 사이클의 비율을 5%만 반영하는 이동 평균.
+    // TTL 키를 하나도 만나지 못한 사이클은 0%로 반영하여 정리가 끝나면 값이 다시 내려감
+    const double current = result.sampled > 0 ? static_cast<double>(result.expired) / result.sampled : 0.0;
+    const double previous = expired_stale_ratio_.load(std::memory_order_relaxed);
+    expired_stale_ratio_.store(current * 0.05 + previous * 0.95, std::memory_order_relaxed);
+    return result;
   }
 
-  std::vector<std::string> store::keys(const std::string &pattern)
+  std::size_t store::dbsize()
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::vector<std::string> matching_keys;
-    std::vector<std::string> expired_keys;
+    // lazy 적재 중에는 아직 파일에만 있는 키도 셈 (그 사이 읽힌 키가 한 번 더 세어질 수 있는 근삿값)
+    std::size_t total = 0;
+    if (const auto lazy = std::atomic_load(&lazy_))
+    {
+      total += static_cast<std::size_t>(lazy->remaining.load(std::memory_order_relaxed));
+    }
+    for (std::size_t i = 0; i < shard_count_; ++i)
+    {
+      read_lock lock(shards_[i].mutex);
+      total += shards_[i].data.size();
+    }
+    return total;
+  }
+
+  void store::sync_memory(shard &sh)
+  {
+    const std::size_t current = sh.data.memory_usage() + sh.expires.memory_usage();
+    const std::size_t dataset = current - sh.data.reusable_bytes();
+    // 부호 없는 정수의 wrap-around로 감소분도 그대로 더해짐
+    const std::size_t total = used_memory_.fetch_add(current - sh.accounted_memory, std::memory_order_relaxed) +
+                              (current - sh.accounted_memory);
+    dataset_memory_.fetch_add(dataset - sh.accounted_dataset, std::memory_order_relaxed);
+    sh.accounted_memory = current;
+    sh.accounted_dataset = dataset;
+
+    // 테이블을 두 배로 키우면 대략 지금 테이블 크기만큼 메모리가 늘어나므로,
+    // 그러면 한도를 넘게 되는 shard는 축출로 생긴 빈 슬롯을 먼저 재사용
+    if (maxmemory_ != 0)
+    {
+      sh.data.limit_growth(total + sh.data.memory_usage() > maxmemory_);
+    }
+  }
+
+  void store::touch(const value_entry &entry, bool inserted)
+  {
+    switch (policy_)
+    {
+    case eviction_policy::allkeys_lru:
+      entry.access.store(access_policy::lru_clock());
+      break;
+    case eviction_policy::allkeys_lfu:
+      entry.access.store(inserted ? access_policy::lfu_initial() : access_policy::lfu_touch(entry.access.load()));
+      break;
+    default:
+      // noeviction, volatile-ttl은 접근 정보를 사용하지 않으므로 캐시 라인을 더럽히지 않음
+      break;
+    }
+  }
+
+  void store::ensure_memory()
+  {
+    if (maxmemory_ == 0 || dataset_memory() <= maxmemory_ || !maxmemory_enforced_.load(std::memory_order_relaxed))
+    {
+      return;
+    }
 
-    for (auto const& [key, val] : data_)
+    std::lock_guard<std::mutex> guard(eviction_mutex_);
+    // Redis의 기본 maxmemory-eviction-tenacity와 비슷하게, 쓰기 한 번이 축출에 쓰는 시간을 제한.
+    // 다 못 줄인 만큼은 다음 쓰기들이 이어서 줄임
+    constexpr auto eviction_budget = std::chrono::microseconds(500);
+    const auto deadline = std::chrono::steady_clock::now() + eviction_budget;
+    std::size_t evicted = 0;
+    eviction_pool::candidate victim;
+    while (policy_ != eviction_policy::noeviction && dataset_memory() > maxmemory_)
     {
-      if (is_key_expired(val))
+      if (!next_eviction_candidate(victim))
       {
-        expired_keys.push_back(key);
-        continue;
+        break;
       }
-      if (pattern == "*" || glob_match(pattern, key))
+      if (evict(victim))
       {
-        matching_keys.push_back(key);
+        ++evicted;
+      }
+      if (std::chrono::steady_clock::now() >= deadline)
+      {
+        break;
       }
     }
 
-    // Clean up expired keys
-    for(const auto& key : expired_keys) {
-        data_.erase(key);
+    if (evicted == 0 && dataset_memory() > maxmemory_)
+    {
+      throw std::runtime_error("OOM command not allowed when used memory > 'maxmemory'.");
     }
+  }
 
-    return matching_keys;
+  void store::log_evictions_to(std::shared_ptr<append_only_file> aof)
+  {
+    std::lock_guard<std::mutex> guard(eviction_mutex_);
+    eviction_log_ = std::move(aof);
   }
 
-  bool store::exists(const std::string &key)
+  std::size_t store::evict_to_maxmemory()
+  {
+    if (maxmemory_ == 0 || policy_ == eviction_policy::noeviction)
+    {
+      return 0;
+    }
+    std::lock_guard<std::mutex> guard(eviction_mutex_);
+    std::size_t evicted = 0;
+    eviction_pool::candidate victim;
+    while (dataset_memory() > maxmemory_ && next_eviction_candidate(victim))
+    {
+      if (evict(victim))
+      {
+        ++evicted;
+      }
+    }
+    return evicted;
+  }
+
+  bool store::next_eviction_candidate(eviction_pool::candidate &out)
+  {
+    // 한 번에 shard 하나를 샘플링하고 풀에서 가장 좋은 후보를 꺼냄.
+    // 풀이 비어 있으면 다른 shard를 차례로 샘플링하고, 모든 shard에 후보가 없으면 포기
+    for (std::size_t tries = 0; tries < shard_count_; ++tries)
+    {
+      sample_eviction_candidates(eviction_next_shard_);
+      eviction_next_shard_ = (eviction_next_shard_ + 1) % shard_count_;
+      if (eviction_pool_.pop_best(out))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void store::sample_eviction_candidates(std::size_t shard_idx)
+  {
+    auto &sh = shards_[shard_idx];
+    read_lock lock(sh.mutex);
+    const auto now_clock = access_policy::lru_clock();
+    // 빈 슬롯이 많거나(volatile-ttl에서) TTL 키가 드문 경우에도 방문할 슬롯 수는 제한
+    const std::size_t max_visits = maxmemory_samples_ * flat_table::group_width * 2;
+    sh.data.sample(eviction_rng_(), maxmemory_samples_, max_visits, [&](std::string_view key, const value_entry &entry) {
+      std::uint64_t score;
+      if (is_key_expired(entry))
+      {
+        score = std::numeric_limits<std::uint64_t>::max(); // 어차피 만료된 키가 가장 먼저
+      }
+      else if (policy_ == eviction_policy::allkeys_lru)
+      {
+        score = access_policy::lru_idle_seconds(entry.access.load(), now_clock);
+      }
+      else if (policy_ == eviction_policy::allkeys_lfu)
+      {
+        score = 255 - access_policy::lfu_decayed_counter(entry.access.load());
+      }
+      else
+      {
+        if (!entry.has_expiry())
+        {
+          return false; // volatile-ttl은 TTL이 있는 키만 대상
+        }
+        score = std::numeric_limits<std::uint64_t>::max() - 1 - static_cast<std::uint64_t>(entry.expiry);
+      }
+      eviction_pool_.offer(score, shard_idx, key);
+      return true;
+    });
+  }
+
+  bool store::evict(const eviction_pool::candidate &victim)
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = data_.find(key);
-    if (it == data_.end())
+    // AOF에 DEL을 남기는 경우: 키의 order stripe를 잡아 같은 키에 대한 다른 쓰기와 기록 순서를 맞춤.
+    // 다른 스레드가 잡고 있으면 기다리지 않고 (stripe를 번호 순서로 잡지 않게 되므로) 이 후보를 건너뜀
+    append_only_file::order_guard order;
+    if (eviction_log_ && !eviction_log_->try_lock_order(victim.key, order))
     {
       return false;
     }
-    if (is_key_expired(it->second))
+    // 풀에 들어간 뒤 삭제되었거나(volatile-ttl의 경우) TTL이 지워졌을 수 있으므로 다시 확인
+    auto &sh = shards_[victim.shard];
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    const auto h = flat_table::hash(victim.key);
+    const value_entry *entry = sh.data.find(victim.key, h);
+    if (!entry || (policy_ == eviction_policy::volatile_ttl && !entry->has_expiry()))
     {
-      data_.erase(it);
+      sync_memory(sh);
       return false;
     }
+    sh.data.erase(victim.key, h);
+    sync_memory(sh);
+    evicted_keys_.fetch_add(1, std::memory_order_relaxed);
+    if (eviction_log_)
+    {
+      eviction_log_->feed({"DEL", victim.key}, ":1\r\n");
+    }
     return true;
   }
 
-  void store::expire(const std::string &key, int seconds)
+  // private helper function
+  bool store::is_key_expired(const value_entry &entry)
+  {
+    // 만료 시간이 없는 키(대부분)는 시계를 읽지 않음
+    return entry.has_expiry() && steady_clock_ms() > entry.expiry;
+  }
+
+  void store::set(const std::string &key, const std::string &value)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    set_locked(sh, key, h, value);
+    sync_memory(sh);
+  }
+
+  void store::set_locked(shard &sh, const std::string &key, flat_table::hash_type h, const std::string &value)
+  {
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    const auto before = value_memory(entry->value);
+    assign_string(entry->value, value, sh.data.arena());
+    sh.data.value_resized(before, *entry);
+    entry->clear_expiry();
+    touch(*entry, inserted);
+  }
+
+  void store::mget(const std::vector<std::string> &keys,
+                   const std::function<void(std::optional<std::string_view>)> &visit)
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = data_.find(key);
-    if (it != data_.end())
+    std::vector<flat_table::hash_type> hashes;
+    hashes.reserve(keys.size());
+    for (const auto &key : keys)
+    {
+      hashes.push_back(flat_table::hash(key));
+    }
+    // 키마다 잠그는 대신 관련 shard의 읽기 잠금을 한 번씩 잡은 채로 키 순서대로 읽음
+    auto locks = lock_shards_shared(hashes);
+    std::string scratch;
+    for (std::size_t i = 0; i < keys.size(); ++i)
     {
-      if (seconds > 0)
+      auto &sh = shard_for(hashes[i]);
+      const value_entry *entry = sh.data.find(keys[i], hashes[i]);
+      if (!entry)
       {
-        it->second.expiry = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+        visit(std::nullopt);
+        continue;
       }
-      else
+      if (is_key_expired(*entry))
       {
-        it->second.expiry = std::nullopt;
+        defer_expired(sh, keys[i]);
+        visit(std::nullopt);
+        continue;
       }
+      touch(*entry);
+      visit(string_bytes(entry->value, scratch));
     }
   }
 
-  long long store::ttl(const std::string &key)
+  std::vector<std::optional<std::string>> store::mget(const std::vector<std::string> &keys)
+  {
+    std::vector<std::optional<std::string>> values;
+    values.reserve(keys.size());
+    mget(keys, [&](std::optional<std::string_view> value) {
+      values.push_back(value ? std::optional<std::string>(*value) : std::nullopt);
+    });
+    return values;
+  }
+
+  void store::mset(const std::vector<std::pair<std::string, std::string>> &pairs)
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = data_.find(key);
-    if (it == data_.end())
+    ensure_memory();
+    std::vector<flat_table::hash_type> hashes;
+    hashes.reserve(pairs.size());
+    for (const auto &[key, value] : pairs)
     {
-      return -2; // Key does not exist
+      hashes.push_back(flat_table::hash(key));
     }
-
-    if (is_key_expired(it->second))
+    auto locks = lock_shards(hashes);
+    for (std::size_t i = 0; i < pairs.size(); ++i)
     {
-      data_.erase(it);
-      return -2; // Key does not exist (as it just expired)
+      set_locked(shard_for(hashes[i]), pairs[i].first, hashes[i], pairs[i].second);
+    }
+    for (const auto idx : sorted_shards(hashes))
+    {
+      sync_memory(shards_[idx]);
     }
+  }
 
-    if (!it->second.expiry.has_value())
+  bool store::msetnx(const std::vector<std::pair<std::string, std::string>> &pairs)
+  {
+    ensure_memory();
+    std::vector<flat_table::hash_type> hashes;
+    hashes.reserve(pairs.size());
+    for (const auto &[key, value] : pairs)
     {
-      return -1; // Key exists but has no associated expire
+      hashes.push_back(flat_table::hash(key));
+    }
+    // 확인과 설정 사이에 다른 명령이 끼어들지 않도록 모든 잠금을 잡은 채로 둘 다 함
+    auto locks = lock_shards(hashes);
+    bool any_exists = false;
+    for (std::size_t i = 0; i < pairs.size() && !any_exists; ++i)
+    {
+      any_exists = find_for_write(shard_for(hashes[i]), pairs[i].first, hashes[i]) != nullptr;
+    }
+    if (!any_exists)
+    {
+      for (std::size_t i = 0; i < pairs.size(); ++i)
+      {
+        set_locked(shard_for(hashes[i]), pairs[i].first, hashes[i], pairs[i].second);
+      }
     }
+    for (const auto idx : sorted_shards(hashes))
+    {
+      sync_memory(shards_[idx]);
+    }
+    return !any_exists;
+  }
 
-    auto now = std::chrono::steady_clock::now();
-    auto remaining = std::chrono::duration_cast<std::chrono::seconds>(it->second.expiry.value() - now);
-    return remaining.count();
+  void store::setex(const std::string &key, int ttl_seconds, const std::string &value)
+  {
+    psetex(key, static_cast<long long>(ttl_seconds) * 1000, value);
   }
 
-  long long store::incrby(const std::string &key, long long increment) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = data_.find(key);
+  void store::psetex(const std::string &key, long long ttl_ms, const std::string &value)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    const auto before = value_memory(entry->value);
+    assign_string(entry->value, value, sh.data.arena());
+    sh.data.value_resized(before, *entry);
+    set_expiry(sh, h, *entry, steady_clock_ms() + ttl_ms);
+    touch(*entry, inserted);
+    sync_memory(sh);
+  }
 
-    if (it != data_.end() && is_key_expired(it->second)) {
-        data_.erase(it);
-        it = data_.end();
+  std::optional<std::string> store::get(const std::string &key)
+  {
+    // 읽기 전용 경로: 공유 잠금만 잡으므로 같은 shard의 GET끼리는 병렬로 실행됨
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const value_entry *entry = sh.data.find(key, h);
+    if (!entry)
+    {
+      return std::nullopt;
     }
 
-    if (it == data_.end()) {
-        data_[key] = {RedisString(std::to_string(increment)), std::nullopt};
-        return increment;
+    // Check if the key is expired (삭제는 쓰기 쪽에 맡김)
+    if (is_key_expired(*entry))
+    {
+      defer_expired(sh, key);
+      return std::nullopt;
     }
 
-    if (auto val_ptr = std::get_if<RedisString>(&it->second.value)) {
-        try {
-            long long value = std::stoll(*val_ptr);
-            value += increment;
-            *val_ptr = std::to_string(value);
-            return value;
-        } catch (const std::invalid_argument&) {
-            throw std::runtime_error("ERR value is not an integer or out of range");
-        } catch (const std::out_of_range&) {
-            throw std::runtime_error("ERR value is not an integer or out of range");
-        }
-    } else {
-        throw std::runtime_error("ERR wrong type of value");
-    }
-  }
+    touch(*entry);
 
-  long long store::decrby(const std::string &key, long long decrement) {
-    return incrby(key, -decrement);
+    // Return the value if it is a string (정수 인코딩은 여기서만 문자열로 변환).
+    // If the key exists but is not a string type, returns std::nullopt.
+    return string_value(entry->value);
   }
 
-  long long store::incr(const std::string &key) {
-    return incrby(key, 1);
+  int store::del(const std::string &key)
+  {
+    return del(std::vector<std::string>{key});
   }
 
-  long long store::decr(const std::string &key) {
-    return incrby(key, -1);
+  // 멀티 키 삭제
+  // 이 함수는 벡터로 전달된 여러 키를 삭제합니다.
+  // 각 키에 대해 해당 shard의 data 맵에서 해당 키를 찾아 삭제하고, 삭제된 키의 개수를 반환합니다.
+  // 만약 키가 존재하지 않으면 삭제되지 않습니다.
+  // 이 함수는 멀티 스레드 환경에서 안전하게 동작하도록, 키가 속한 shard들의 mutex만 오름차순으로 잠급니다.
+  int store::del(const std::vector<std::string> &keys)
+  {
+    std::vector<flat_table::hash_type> hashes;
+    hashes.reserve(keys.size());
+    for (const auto &key : keys)
+    {
+      hashes.push_back(flat_table::hash(key));
+    }
+
+    auto locks = lock_shards(hashes);
+    int deleted_count = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      if (shard_for(hashes[i]).data.erase(keys[i], hashes[i]))
+      {
+        deleted_count++;
+      }
+    }
+    for (const auto idx : sorted_shards(hashes))
+    {
+      sync_memory(shards_[idx]);
+    }
+    return deleted_count;
+  }
+  
+
+  std::vector<std::string> store::keys(const std::string &pattern)
+  {
+    // 파일에만 있는 키는 볼 수 없고, 적재를 끝내려고 I/O 스레드를 세울 수도 없으므로 Redis처럼 거절함
+    if (loading())
+    {
+      throw std::runtime_error("LOADING Redis is loading the dataset in memory");
+    }
+    std::vector<std::string> matching_keys;
+    const auto glob = glob_cache::global().get(pattern);
+    const std::string &prefix = glob->literal_prefix();
+
+    // shard를 하나씩 잠그며 순회하므로 다른 shard의 명령은 그동안 계속 처리됨
+    for (std::size_t i = 0; i < shard_count_; ++i)
+    {
+      auto &sh = shards_[i];
+      read_lock lock(sh.mutex);
+      if (const radix_tree *index = sh.data.key_index(); index && !prefix.empty())
+      {
+        // 접두사의 하위 트리만 방문하고 값(만료 시각)은 테이블에서 찾음
+        index->for_each_prefix(prefix, [&](std::string_view key) {
+          const value_entry *val = sh.data.find(key, flat_table::hash(key));
+          if (val && is_key_expired(*val))
+          {
+            defer_expired(sh, std::string(key));
+          }
+          else if (val && glob->match(key))
+          {
+            matching_keys.emplace_back(key);
+          }
+          return true;
+        });
+        continue;
+      }
+      sh.data.for_each([&](std::string_view key, const value_entry &val) {
+        // 만료된 키는 결과에서 제외하고 정리는 쓰기 쪽에 맡김
+        if (is_key_expired(val))
+        {
+          defer_expired(sh, std::string(key));
+          return;
+        }
+        if (glob->match(key))
+        {
+          matching_keys.emplace_back(key);
+        }
+      });
+    }
+
+    return matching_keys;
+  }
+
+  scan_result store::scan(std::uint64_t cursor, const std::string &pattern, std::size_t count,
+                           const std::string &type)
+  {
+    if (loading())
+    {
+      throw std::runtime_error("LOADING Redis is loading the dataset in memory");
+    }
+    // cursor = (shard 안의 table cursor) * shard 수 + shard 번호. shard를 차례로 끝까지 순회함
+    std::size_t shard_idx = static_cast<std::size_t>(cursor % shard_count_);
+    std::uint64_t table_cursor = cursor / shard_count_;
+    count = std::max<std::size_t>(1, count);
+    const std::size_t max_groups = count * 10;
+
+    const auto glob = glob_cache::global().get(pattern);
+    scan_result result;
+    std::size_t visited = 0;
+    std::size_t groups = 0;
+    while (shard_idx < shard_count_ && visited < count && groups < max_groups)
+    {
+      auto &sh = shards_[shard_idx];
+      {
+        read_lock lock(sh.mutex);
+        do
+        {
+          table_cursor = sh.data.scan(table_cursor, [&](std::string_view key, const value_entry &val) {
+            ++visited;
+            if (is_key_expired(val))
+            {
+              defer_expired(sh, std::string(key));
+              return;
+            }
+            if (!type.empty() && type != value_type_name(val.value))
+            {
+              return;
+            }
+            if (glob->match(key))
+            {
+              result.items.emplace_back(key);
+            }
+          });
+          ++groups;
+        } while (table_cursor != 0 && visited < count && groups < max_groups);
+      }
+      if (table_cursor == 0)
+      {
+        ++shard_idx;
+      }
+    }
+    result.cursor = shard_idx >= shard_count_ ? 0 : table_cursor * shard_count_ + shard_idx;
+    return result;
+  }
+
+  template <typename T>
+  const T *store::find_collection(shard &sh, const std::string &key, flat_table::hash_type h)
+  {
+    const value_entry *entry = sh.data.find(key, h);
+    if (!entry)
+    {
+      return nullptr;
+    }
+    if (is_key_expired(*entry))
+    {
+      defer_expired(sh, key);
+      return nullptr;
+    }
+    const auto *value = std::get_if<boxed<T>>(&entry->value);
+    if (!value)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    touch(*entry);
+    return &**value;
+  }
+
+  std::optional<std::string_view> store::find_string(shard &sh, const std::string &key, flat_table::hash_type h,
+                                                     std::string &scratch)
+  {
+    const value_entry *entry = sh.data.find(key, h);
+    if (!entry)
+    {
+      return std::nullopt;
+    }
+    if (is_key_expired(*entry))
+    {
+      defer_expired(sh, key);
+      return std::nullopt;
+    }
+    auto bytes = string_bytes(entry->value, scratch);
+    if (!bytes)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    touch(*entry);
+    return bytes;
+  }
+
+  RedisString &store::writable_string(shard &sh, value_entry &entry, bool inserted)
+  {
+    if (inserted)
+    {
+      entry.value = RedisString();
+    }
+    else if (auto n = std::get_if<RedisInt>(&entry.value))
+    {
+      // bit 단위로 고치려면 정수 인코딩을 문자열로 풀어 둠
+      entry.value = RedisString(std::to_string(*n), sh.data.arena());
+    }
+    auto *str = std::get_if<RedisString>(&entry.value);
+    if (!str)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    return *str;
+  }
+
+  scan_result store::sscan(const std::string &key, std::uint64_t cursor, const std::string &pattern,
+                           std::size_t count)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    const auto glob = glob_cache::global().get(pattern);
+    read_lock lock(sh.mutex);
+    scan_result result;
+    const RedisSet *set = find_collection<RedisSet>(sh, key, h);
+    if (set && set->is_intset())
+    {
+      // intset 인코딩은 (Redis와 같이) 한 번에 모두 반환하고 cursor 0으로 끝냄
+      set->for_each([&](std::string_view member) {
+        if (glob->match(member))
+        {
+          result.items.emplace_back(member);
+        }
+      });
+    }
+    else if (set)
+    {
+      result.cursor = scan_buckets(*set->table(), cursor, std::max<std::size_t>(1, count), [&](const std::string &member) {
+        if (glob->match(member))
+        {
+          result.items.push_back(member);
+        }
+      });
+    }
+    return result;
+  }
+
+  scan_result store::hscan(const std::string &key, std::uint64_t cursor, const std::string &pattern,
+                           std::size_t count)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    const auto glob = glob_cache::global().get(pattern);
+    read_lock lock(sh.mutex);
+    scan_result result;
+    const RedisHash *hash = find_collection<RedisHash>(sh, key, h);
+    if (hash && hash->is_listpack())
+    {
+      // listpack 인코딩은 작으므로 (Redis와 같이) 한 번에 모두 반환하고 cursor 0으로 끝냄
+      hash->for_each([&](std::string_view field, std::string_view value) {
+        if (glob->match(field))
+        {
+          result.items.emplace_back(field);
+          result.items.emplace_back(value);
+        }
+      });
+    }
+    else if (hash)
+    {
+      result.cursor = scan_buckets(*hash->table(), cursor, std::max<std::size_t>(1, count), [&](const auto &field) {
+        if (glob->match(field.first))
+        {
+          result.items.push_back(field.first);
+          result.items.push_back(field.second);
+        }
+      });
+    }
+    return result;
+  }
+
+  scan_result store::zscan(const std::string &key, std::uint64_t cursor, const std::string &pattern,
+                           std::size_t count)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    const auto glob = glob_cache::global().get(pattern);
+    read_lock lock(sh.mutex);
+    scan_result result;
+    const RedisSortedSet *zset = find_collection<RedisSortedSet>(sh, key, h);
+    const auto visit = [&](std::string_view member, double score) {
+      if (glob->match(member))
+      {
+        result.items.emplace_back(member);
+        result.items.push_back(format_score(score));
+      }
+    };
+    if (zset && zset->is_listpack())
+    {
+      // listpack 인코딩은 (Redis와 같이) 한 번에 모두 반환하고 cursor 0으로 끝냄
+      zset->for_each(visit);
+    }
+    else if (zset)
+    {
+      // skiplist 인코딩은 member dict를 bucket 순으로 순회 (같은 점수의 member가 여럿이어도 빠짐없이)
+      result.cursor = zset->scan_dict(cursor, std::max<std::size_t>(1, count), visit);
+    }
+    return result;
+  }
+
+  value_entry *store::find_for_write(shard &sh, const std::string &key, flat_table::hash_type h)
+  {
+    value_entry *entry = sh.data.find(key, h);
+    if (entry && is_key_expired(*entry))
+    {
+      sh.data.erase(key, h);
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    return entry;
+  }
+
+  std::size_t store::lpush(const std::string &key, const std::vector<std::string> &values)
+  {
+    return push_list(key, values, true);
+  }
+
+  std::size_t store::rpush(const std::string &key, const std::vector<std::string> &values)
+  {
+    return push_list(key, values, false);
+  }
+
+  std::size_t store::push_list(const std::string &key, const std::vector<std::string> &values, bool front)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    if (!inserted && is_key_expired(*entry))
+    {
+      entry->clear_expiry();
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      inserted = true;
+    }
+    const auto before = value_memory(entry->value);
+    if (inserted)
+    {
+      entry->value = boxed<RedisList>(quicklist(list_options_));
+    }
+    auto *list = std::get_if<boxed<RedisList>>(&entry->value);
+    if (!list)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    for (const auto &value : values)
+    {
+      if (front)
+      {
+        (*list)->push_front(value);
+      }
+      else
+      {
+        (*list)->push_back(value);
+      }
+    }
+    sh.data.value_resized(before, *entry);
+    touch(*entry, inserted);
+    sync_memory(sh);
+    return (*list)->size();
+  }
+
+  std::optional<std::vector<std::string>> store::lpop(const std::string &key, std::size_t count)
+  {
+    return pop_list(key, count, true);
+  }
+
+  std::optional<std::vector<std::string>> store::rpop(const std::string &key, std::size_t count)
+  {
+    return pop_list(key, count, false);
+  }
+
+  std::optional<std::vector<std::string>> store::pop_list(const std::string &key, std::size_t count, bool front)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    value_entry *entry = find_for_write(sh, key, h);
+    if (!entry)
+    {
+      sync_memory(sh);
+      return std::nullopt;
+    }
+    auto *list = std::get_if<boxed<RedisList>>(&entry->value);
+    if (!list)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    const auto before = value_memory(entry->value);
+    std::vector<std::string> popped;
+    popped.reserve(std::min(count, (*list)->size()));
+    while (popped.size() < count && !(*list)->empty())
+    {
+      popped.push_back(*(front ? (*list)->pop_front() : (*list)->pop_back()));
+    }
+    if ((*list)->empty())
+    {
+      // 빈 리스트는 남기지 않음 (Redis와 같이 마지막 원소를 꺼내면 키가 사라짐)
+      sh.data.erase(key, h);
+    }
+    else
+    {
+      sh.data.value_resized(before, *entry);
+      touch(*entry);
+    }
+    sync_memory(sh);
+    return popped;
+  }
+
+  std::vector<std::string> store::lrange(const std::string &key, long long start, long long stop)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisList *list = find_collection<RedisList>(sh, key, h);
+    return list ? list->range(start, stop) : std::vector<std::string>{};
+  }
+
+  std::size_t store::llen(const std::string &key)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisList *list = find_collection<RedisList>(sh, key, h);
+    return list ? list->size() : 0;
+  }
+
+  std::optional<std::string> store::lindex(const std::string &key, long long index)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisList *list = find_collection<RedisList>(sh, key, h);
+    return list ? list->at(index) : std::nullopt;
+  }
+
+  void store::ltrim(const std::string &key, long long start, long long stop)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    value_entry *entry = find_for_write(sh, key, h);
+    if (entry)
+    {
+      auto *list = std::get_if<boxed<RedisList>>(&entry->value);
+      if (!list)
+      {
+        throw std::runtime_error("ERR wrong type of value");
+      }
+      const auto before = value_memory(entry->value);
+      (*list)->trim(start, stop);
+      if ((*list)->empty())
+      {
+        sh.data.erase(key, h);
+      }
+      else
+      {
+        sh.data.value_resized(before, *entry);
+        touch(*entry);
+      }
+    }
+    sync_memory(sh);
+  }
+
+  std::size_t store::hset(const std::string &key, const std::vector<std::pair<std::string, std::string>> &fields)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    if (!inserted && is_key_expired(*entry))
+    {
+      entry->clear_expiry();
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      inserted = true;
+    }
+    const auto before = value_memory(entry->value);
+    if (inserted)
+    {
+      entry->value = boxed<RedisHash>(compact_hash(hash_options_));
+    }
+    auto *hash = std::get_if<boxed<RedisHash>>(&entry->value);
+    if (!hash)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    std::size_t added = 0;
+    for (const auto &[field, value] : fields)
+    {
+      added += (*hash)->set(field, value);
+    }
+    sh.data.value_resized(before, *entry);
+    touch(*entry, inserted);
+    sync_memory(sh);
+    return added;
+  }
+
+  std::optional<std::string> store::hget(const std::string &key, const std::string &field)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisHash *hash = find_collection<RedisHash>(sh, key, h);
+    return hash ? hash->get(field) : std::nullopt;
+  }
+
+  std::vector<std::optional<std::string>> store::hmget(const std::string &key, const std::vector<std::string> &fields)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    std::vector<std::optional<std::string>> values(fields.size());
+    if (const RedisHash *hash = find_collection<RedisHash>(sh, key, h))
+    {
+      for (std::size_t i = 0; i < fields.size(); ++i)
+      {
+        values[i] = hash->get(fields[i]);
+      }
+    }
+    return values;
+  }
+
+  std::vector<std::string> store::hgetall(const std::string &key)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    std::vector<std::string> items;
+    if (const RedisHash *hash = find_collection<RedisHash>(sh, key, h))
+    {
+      items.reserve(hash->size() * 2);
+      hash->for_each([&](std::string_view field, std::string_view value) {
+        items.emplace_back(field);
+        items.emplace_back(value);
+      });
+    }
+    return items;
+  }
+
+  std::size_t store::hdel(const std::string &key, const std::vector<std::string> &fields)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    value_entry *entry = find_for_write(sh, key, h);
+    std::size_t removed = 0;
+    if (entry)
+    {
+      auto *hash = std::get_if<boxed<RedisHash>>(&entry->value);
+      if (!hash)
+      {
+        throw std::runtime_error("ERR wrong type of value");
+      }
+      const auto before = value_memory(entry->value);
+      for (const auto &field : fields)
+      {
+        removed += (*hash)->erase(field);
+      }
+      if ((*hash)->empty())
+      {
+        sh.data.erase(key, h);
+      }
+      else
+      {
+        sh.data.value_resized(before, *entry);
+        touch(*entry);
+      }
+    }
+    sync_memory(sh);
+    return removed;
+  }
+
+  long long store::hincrby(const std::string &key, const std::string &field, long long increment)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    if (!inserted && is_key_expired(*entry))
+    {
+      entry->clear_expiry();
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      inserted = true;
+    }
+    const auto before = value_memory(entry->value);
+    if (inserted)
+    {
+      entry->value = boxed<RedisHash>(compact_hash(hash_options_));
+    }
+    auto *hash = std::get_if<boxed<RedisHash>>(&entry->value);
+    if (!hash)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    RedisInt current = 0;
+    if (auto value = (*hash)->get(field))
+    {
+      auto parsed = parse_int64(*value);
+      if (!parsed)
+      {
+        throw std::runtime_error("ERR hash value is not an integer");
+      }
+      current = *parsed;
+    }
+    if ((increment > 0 && current > std::numeric_limits<RedisInt>::max() - increment) ||
+        (increment < 0 && current < std::numeric_limits<RedisInt>::min() - increment))
+    {
+      throw std::runtime_error("ERR increment or decrement would overflow");
+    }
+    current += increment;
+    (*hash)->set(field, std::to_string(current));
+    sh.data.value_resized(before, *entry);
+    touch(*entry, inserted);
+    sync_memory(sh);
+    return current;
+  }
+
+  std::size_t store::hlen(const std::string &key)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisHash *hash = find_collection<RedisHash>(sh, key, h);
+    return hash ? hash->size() : 0;
+  }
+
+  std::size_t store::sadd(const std::string &key, const std::vector<std::string> &members)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    if (!inserted && is_key_expired(*entry))
+    {
+      entry->clear_expiry();
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      inserted = true;
+    }
+    const auto before = value_memory(entry->value);
+    if (inserted)
+    {
+      entry->value = boxed<RedisSet>(compact_set(set_options_));
+    }
+    auto *set = std::get_if<boxed<RedisSet>>(&entry->value);
+    if (!set)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    std::size_t added = 0;
+    for (const auto &member : members)
+    {
+      added += (*set)->insert(member);
+    }
+    sh.data.value_resized(before, *entry);
+    touch(*entry, inserted);
+    sync_memory(sh);
+    return added;
+  }
+
+  std::size_t store::srem(const std::string &key, const std::vector<std::string> &members)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    value_entry *entry = find_for_write(sh, key, h);
+    std::size_t removed = 0;
+    if (entry)
+    {
+      auto *set = std::get_if<boxed<RedisSet>>(&entry->value);
+      if (!set)
+      {
+        throw std::runtime_error("ERR wrong type of value");
+      }
+      const auto before = value_memory(entry->value);
+      for (const auto &member : members)
+      {
+        removed += (*set)->erase(member);
+      }
+      if ((*set)->empty())
+      {
+        sh.data.erase(key, h);
+      }
+      else
+      {
+        sh.data.value_resized(before, *entry);
+        touch(*entry);
+      }
+    }
+    sync_memory(sh);
+    return removed;
+  }
+
+  bool store::sismember(const std::string &key, const std::string &member)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisSet *set = find_collection<RedisSet>(sh, key, h);
+    return set && set->contains(member);
+  }
+
+  std::vector<std::string> store::smembers(const std::string &key)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    std::vector<std::string> members;
+    if (const RedisSet *set = find_collection<RedisSet>(sh, key, h))
+    {
+      members.reserve(set->size());
+      set->for_each([&](std::string_view member) { members.emplace_back(member); });
+    }
+    return members;
+  }
+
+  std::size_t store::scard(const std::string &key)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisSet *set = find_collection<RedisSet>(sh, key, h);
+    return set ? set->size() : 0;
+  }
+
+  std::vector<std::string> store::sinter(const std::vector<std::string> &keys)
+  {
+    return set_operation(keys, set_algebra::inter);
+  }
+
+  std::vector<std::string> store::sunion(const std::vector<std::string> &keys)
+  {
+    return set_operation(keys, set_algebra::unite);
+  }
+
+  std::vector<std::string> store::sdiff(const std::vector<std::string> &keys)
+  {
+    return set_operation(keys, set_algebra::diff);
+  }
+
+  std::vector<std::string> store::set_operation(const std::vector<std::string> &keys, set_algebra op)
+  {
+    std::vector<flat_table::hash_type> hashes;
+    hashes.reserve(keys.size());
+    for (const auto &key : keys)
+    {
+      hashes.push_back(flat_table::hash(key));
+    }
+    // 모든 키의 shard를 읽기 잠금으로 함께 잡아 한 시점의 집합들로 계산
+    auto locks = lock_shards_shared(hashes);
+    std::vector<const RedisSet *> sets(keys.size());
+    bool all_intsets = true;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      sets[i] = find_collection<RedisSet>(shard_for(hashes[i]), keys[i], hashes[i]);
+      all_intsets = all_intsets && (!sets[i] || sets[i]->is_intset());
+    }
+
+    std::vector<std::string> result;
+    if (sets.empty() || (op != set_algebra::unite && !sets[0]) ||
+        (op == set_algebra::inter && std::find(sets.begin(), sets.end(), nullptr) != sets.end()))
+    {
+      return result; // 없는 키는 빈 집합
+    }
+    sets.erase(std::remove(sets.begin() + (op == set_algebra::diff ? 1 : 0), sets.end(), nullptr), sets.end());
+    if (op == set_algebra::inter)
+    {
+      // 작은 집합부터 교집합을 구하면 중간 결과가 빨리 줄어듦
+      std::sort(sets.begin(), sets.end(), [](const RedisSet *a, const RedisSet *b) { return a->size() < b->size(); });
+    }
+
+    if (all_intsets && !sets.empty())
+    {
+      // 모든 피연산자가 intset이면 정렬된 배열끼리 SIMD 병합
+      intset acc = sets[0]->ints();
+      for (std::size_t i = 1; i < sets.size() && !(op != set_algebra::unite && acc.empty()); ++i)
+      {
+        switch (op)
+        {
+        case set_algebra::inter:
+          acc = intset::intersect(acc, sets[i]->ints());
+          break;
+        case set_algebra::unite:
+          acc = intset::unite(acc, sets[i]->ints());
+          break;
+        case set_algebra::diff:
+          acc = intset::difference(acc, sets[i]->ints());
+          break;
+        }
+      }
+      result.reserve(acc.size());
+      acc.for_each([&](std::int64_t value) { result.push_back(std::to_string(value)); });
+      return result;
+    }
+
+    if (op == set_algebra::unite)
+    {
+      compact_set::table_type seen;
+      for (const RedisSet *set : sets)
+      {
+        set->for_each([&](std::string_view member) {
+          if (seen.emplace(member).second)
+          {
+            result.emplace_back(member);
+          }
+        });
+      }
+      return result;
+    }
+    // 교집합은 가장 작은 집합, 차집합은 첫 집합의 원소를 나머지 집합에서 찾음
+    const bool keep_matched = op == set_algebra::inter;
+    sets[0]->for_each([&](std::string_view member) {
+      bool in_all = true, in_any = false;
+      for (std::size_t i = 1; i < sets.size(); ++i)
+      {
+        const bool found = sets[i]->contains(member);
+        in_all = in_all && found;
+        in_any = in_any || found;
+        if (keep_matched ? !in_all : in_any)
+        {
+          break;
+        }
+      }
+      if (keep_matched ? in_all : !in_any)
+      {
+        result.emplace_back(member);
+      }
+    });
+    return result;
+  }
+
+  std::size_t store::zadd(const std::string &key, const std::vector<std::pair<double, std::string>> &members,
+                          const zadd_flags &flags)
+  {
+    return apply_zadd(key, members, flags, nullptr);
+  }
+
+  std::optional<double> store::zadd_incr(const std::string &key, double increment, const std::string &member,
+                                         const zadd_flags &flags)
+  {
+    std::optional<double> result;
+    apply_zadd(key, {{increment, member}}, flags, &result);
+    return result;
+  }
+
+  double store::zincrby(const std::string &key, double increment, const std::string &member)
+  {
+    return *zadd_incr(key, increment, member);
+  }
+
+  std::size_t store::apply_zadd(const std::string &key, const std::vector<std::pair<double, std::string>> &members,
+                                const zadd_flags &flags, std::optional<double> *incr_result)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    if (!inserted && is_key_expired(*entry))
+    {
+      entry->clear_expiry();
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      inserted = true;
+    }
+    const auto before = value_memory(entry->value);
+    if (inserted)
+    {
+      entry->value = boxed<RedisSortedSet>(sorted_set(zset_options_));
+    }
+    auto *zset = std::get_if<boxed<RedisSortedSet>>(&entry->value);
+    if (!zset)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+
+    std::size_t added = 0, updated = 0;
+    for (const auto &[score, member] : members)
+    {
+      const auto current = (*zset)->score(member);
+      if (!current)
+      {
+        if (flags.xx)
+        {
+          continue;
+        }
+        (*zset)->insert(member, score);
+        ++added;
+        if (incr_result)
+        {
+          *incr_result = score;
+        }
+        continue;
+      }
+      if (flags.nx)
+      {
+        continue;
+      }
+      const double next = incr_result ? *current + score : score;
+      if (std::isnan(next))
+      {
+        // inf + -inf. 이전 원소들은 이미 반영되었으므로 메모리 계산은 맞춰 두고 실패를 알림
+        sh.data.value_resized(before, *entry);
+        sync_memory(sh);
+        throw std::runtime_error("ERR resulting score is not a number (NaN)");
+      }
+      if ((flags.gt && next <= *current) || (flags.lt && next >= *current))
+      {
+        continue;
+      }
+      if (next != *current)
+      {
+        (*zset)->insert(member, next);
+        ++updated;
+      }
+      if (incr_result)
+      {
+        *incr_result = next;
+      }
+    }
+
+    if ((*zset)->empty())
+    {
+      // XX로 아무것도 추가하지 않은 새 키는 만들지 않음
+      sh.data.erase(key, h);
+    }
+    else
+    {
+      sh.data.value_resized(before, *entry);
+      touch(*entry, inserted);
+    }
+    sync_memory(sh);
+    return added + (flags.ch ? updated : 0);
+  }
+
+  std::optional<double> store::zscore(const std::string &key, const std::string &member)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisSortedSet *zset = find_collection<RedisSortedSet>(sh, key, h);
+    return zset ? zset->score(member) : std::nullopt;
+  }
+
+  std::optional<std::size_t> store::zrank(const std::string &key, const std::string &member, bool reverse)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisSortedSet *zset = find_collection<RedisSortedSet>(sh, key, h);
+    return zset ? zset->rank(member, reverse) : std::nullopt;
+  }
+
+  sorted_set::entries store::zrange(const std::string &key, long long start, long long stop, bool reverse)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisSortedSet *zset = find_collection<RedisSortedSet>(sh, key, h);
+    if (!zset)
+    {
+      return {};
+    }
+    // 음수 인덱스는 끝에서부터 (-1이 마지막), 범위를 벗어나면 잘라냄
+    const auto n = static_cast<long long>(zset->size());
+    if (start < 0)
+    {
+      start = std::max(0LL, start + n);
+    }
+    if (stop < 0)
+    {
+      stop += n;
+    }
+    if (start > stop || start >= n)
+    {
+      return {};
+    }
+    return zset->range_by_rank(static_cast<std::size_t>(start), static_cast<std::size_t>(std::min(stop, n - 1)),
+                               reverse);
+  }
+
+  sorted_set::entries store::zrangebyscore(const std::string &key, const score_range &range, bool reverse,
+                                           std::size_t offset, std::size_t count)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisSortedSet *zset = find_collection<RedisSortedSet>(sh, key, h);
+    return zset ? zset->range_by_score(range, reverse, offset, count) : sorted_set::entries{};
+  }
+
+  sorted_set::entries store::zrangebylex(const std::string &key, const lex_range &range, bool reverse,
+                                         std::size_t offset, std::size_t count)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisSortedSet *zset = find_collection<RedisSortedSet>(sh, key, h);
+    return zset ? zset->range_by_lex(range, reverse, offset, count) : sorted_set::entries{};
+  }
+
+  std::size_t store::zrem(const std::string &key, const std::vector<std::string> &members)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    value_entry *entry = find_for_write(sh, key, h);
+    std::size_t removed = 0;
+    if (entry)
+    {
+      auto *zset = std::get_if<boxed<RedisSortedSet>>(&entry->value);
+      if (!zset)
+      {
+        throw std::runtime_error("ERR wrong type of value");
+      }
+      const auto before = value_memory(entry->value);
+      for (const auto &member : members)
+      {
+        removed += (*zset)->erase(member);
+      }
+      if ((*zset)->empty())
+      {
+        sh.data.erase(key, h);
+      }
+      else
+      {
+        sh.data.value_resized(before, *entry);
+        touch(*entry);
+      }
+    }
+    sync_memory(sh);
+    return removed;
+  }
+
+  std::size_t store::zcard(const std::string &key)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisSortedSet *zset = find_collection<RedisSortedSet>(sh, key, h);
+    return zset ? zset->size() : 0;
+  }
+
+  namespace
+  {
+    // BITCOUNT/BITPOS의 [start, end]를 길이 total 안의 위치로 바꿈 (음수는 끝에서부터). 빈 구간이면 false
+    bool clamp_range(long long &start, long long &end, long long total)
+    {
+      if (start < 0)
+      {
+        start += total;
+      }
+      if (end < 0)
+      {
+        end += total;
+      }
+      start = std::max(0LL, start);
+      end = std::min(std::max(0LL, end), total - 1);
+      return total > 0 && start <= end;
+    }
+
+    // p[0, n)의 [first, last] bit 구간에서 bit와 같은 첫 위치. 없으면 -1
+    long long find_bit_between(const unsigned char *p, std::size_t n, std::uint64_t first, std::uint64_t last,
+                               bool bit)
+    {
+      // 구간 양 끝의 byte 일부는 bit 하나씩, 가운데의 온전한 byte들은 kernel로 찾음
+      std::uint64_t pos = first;
+      for (; pos <= last && pos % 8 != 0; ++pos)
+      {
+        if (bitops::get_bit(p, n, pos) == bit)
+        {
+          return static_cast<long long>(pos);
+        }
+      }
+      const std::uint64_t full_end = (last + 1) / 8;
+      if (pos <= last && pos / 8 < full_end)
+      {
+        const auto found = bitops::find_bit(p + pos / 8, full_end - pos / 8, bit);
+        if (found >= 0)
+        {
+          return static_cast<long long>(pos + static_cast<std::uint64_t>(found));
+        }
+        pos = full_end * 8;
+      }
+      for (; pos <= last; ++pos)
+      {
+        if (bitops::get_bit(p, n, pos) == bit)
+        {
+          return static_cast<long long>(pos);
+        }
+      }
+      return -1;
+    }
+
+    // BITFIELD 필드를 읽음 (signed이면 부호 확장)
+    std::int64_t read_field(const unsigned char *p, std::size_t n, const bitfield_op &op)
+    {
+      std::uint64_t raw = bitops::get_field(p, n, op.offset, op.bits);
+      if (op.is_signed && op.bits < 64 && ((raw >> (op.bits - 1)) & 1))
+      {
+        raw |= ~((std::uint64_t(1) << op.bits) - 1);
+      }
+      return static_cast<std::int64_t>(raw);
+    }
+
+    /*
+     * BITFIELD SET/INCRBY: 새 값을 OVERFLOW 방식에 따라 정해 씀.
+     * 반환 값은 SET이면 이전 값, INCRBY이면 새 값. FAIL로 쓰지 않았으면 std::nullopt
+     */
+    std::optional<std::int64_t> write_field(unsigned char *p, std::size_t n, const bitfield_op &op)
+    {
+      const std::int64_t old = read_field(p, n, op);
+      const bool incr = op.type == bitfield_op::kind::incrby;
+      int overflow = 0; // 1이면 최댓값 초과, -1이면 최솟값 미만
+      std::uint64_t wrapped;
+      std::uint64_t saturated_max, saturated_min;
+      if (op.is_signed)
+      {
+        const std::int64_t max = op.bits == 64 ? std::numeric_limits<std::int64_t>::max()
+                                               : (std::int64_t(1) << (op.bits - 1)) - 1;
+        const std::int64_t min = -max - 1;
+        if (incr)
+        {
+          overflow = op.value > 0 && old > max - op.value ? 1 : op.value < 0 && old < min - op.value ? -1 : 0;
+          wrapped = static_cast<std::uint64_t>(old) + static_cast<std::uint64_t>(op.value);
+        }
+        else
+        {
+          overflow = op.value > max ? 1 : op.value < min ? -1 : 0;
+          wrapped = static_cast<std::uint64_t>(op.value);
+        }
+        saturated_max = static_cast<std::uint64_t>(max);
+        saturated_min = static_cast<std::uint64_t>(min);
+      }
+      else
+      {
+        const std::uint64_t max = (std::uint64_t(1) << op.bits) - 1;
+        const auto current = static_cast<std::uint64_t>(old);
+        if (incr && op.value < 0)
+        {
+          // INT64_MIN도 넘치지 않게 크기를 구함
+          const std::uint64_t magnitude = static_cast<std::uint64_t>(-(op.value + 1)) + 1;
+          overflow = magnitude > current ? -1 : 0;
+        }
+        else if (incr)
+        {
+          overflow = static_cast<std::uint64_t>(op.value) > max - current ? 1 : 0;
+        }
+        else
+        {
+          overflow = static_cast<std::uint64_t>(op.value) > max ? 1 : 0;
+        }
+        wrapped = incr ? current + static_cast<std::uint64_t>(op.value) : static_cast<std::uint64_t>(op.value);
+        saturated_max = max;
+        saturated_min = 0;
+      }
+
+      std::uint64_t stored = wrapped;
+      if (overflow != 0 && op.on_overflow == bitfield_op::overflow::fail)
+      {
+        return std::nullopt;
+      }
+      if (overflow != 0 && op.on_overflow == bitfield_op::overflow::sat)
+      {
+        stored = overflow > 0 ? saturated_max : saturated_min;
+      }
+      bitops::set_field(p, op.offset, op.bits, stored);
+      return incr ? read_field(p, n, op) : old;
+    }
+  } // namespace
+
+  bool store::setbit(const std::string &key, std::uint64_t offset, bool value)
+  {
+    if (offset > bitops::max_bit_offset)
+    {
+      throw std::runtime_error("ERR bit offset is not an integer or out of range");
+    }
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    if (!inserted && is_key_expired(*entry))
+    {
+      entry->clear_expiry();
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      inserted = true;
+    }
+    const auto before = value_memory(entry->value);
+    RedisString &str = writable_string(sh, *entry, inserted);
+    const std::size_t needed = static_cast<std::size_t>(offset / 8 + 1);
+    if (str.size() < needed)
+    {
+      str.resize(needed, sh.data.arena());
+    }
+    // 저장된 버퍼의 byte 하나만 바꿈
+    const bool old = bitops::set_bit(reinterpret_cast<unsigned char *>(str.mutable_data()), offset, value);
+    sh.data.value_resized(before, *entry);
+    touch(*entry, inserted);
+    sync_memory(sh);
+    return old;
+  }
+
+  bool store::getbit(const std::string &key, std::uint64_t offset)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    std::string scratch;
+    const auto bytes = find_string(sh, key, h, scratch);
+    return bytes && bitops::get_bit(reinterpret_cast<const unsigned char *>(bytes->data()), bytes->size(), offset);
+  }
+
+  std::uint64_t store::bitcount(const std::string &key, long long start, long long end, bool bit_unit)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    std::string scratch;
+    const auto bytes = find_string(sh, key, h, scratch);
+    if (!bytes)
+    {
+      return 0;
+    }
+    const auto *p = reinterpret_cast<const unsigned char *>(bytes->data());
+    const auto n = static_cast<long long>(bytes->size());
+    if (!clamp_range(start, end, bit_unit ? n * 8 : n))
+    {
+      return 0;
+    }
+    if (!bit_unit)
+    {
+      return bitops::popcount(p + start, static_cast<std::size_t>(end - start + 1));
+    }
+    // 걸친 byte들을 모두 센 뒤, 첫 byte의 start 앞 bit와 마지막 byte의 end 뒤 bit를 뺌
+    const long long first = start / 8, last = end / 8;
+    std::uint64_t count = bitops::popcount(p + first, static_cast<std::size_t>(last - first + 1));
+    const unsigned char head = static_cast<unsigned char>(p[first] >> (8 - start % 8));
+    const unsigned char tail = static_cast<unsigned char>(p[last] & ((1u << (7 - end % 8)) - 1));
+    count -= bitops::popcount(&head, start % 8 ? 1 : 0) + bitops::popcount(&tail, 1);
+    return count;
+  }
+
+  long long store::bitpos(const std::string &key, bool bit, long long start, std::optional<long long> end,
+                          bool bit_unit)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    std::string scratch;
+    const auto bytes = find_string(sh, key, h, scratch);
+    if (!bytes || bytes->empty())
+    {
+      // 빈 문자열은 0으로만 이루어진 것으로 봄
+      return bit ? -1 : 0;
+    }
+    const auto *p = reinterpret_cast<const unsigned char *>(bytes->data());
+    const auto n = static_cast<long long>(bytes->size());
+    long long stop = end.value_or(-1);
+    if (!clamp_range(start, stop, bit_unit ? n * 8 : n))
+    {
+      return -1;
+    }
+    const auto first = static_cast<std::uint64_t>(bit_unit ? start : start * 8);
+    const auto last = static_cast<std::uint64_t>(bit_unit ? stop : stop * 8 + 7);
+    const long long pos = find_bit_between(p, bytes->size(), first, last, bit);
+    if (pos < 0 && !bit && !end)
+    {
+      // 끝을 정하지 않았으면 문자열 뒤가 0으로 이어진다고 보므로 바로 다음 bit
+      return static_cast<long long>(last + 1);
+    }
+    return pos;
+  }
+
+  std::size_t store::bitop(bitops::operation op, const std::string &dest, const std::vector<std::string> &keys)
+  {
+    if (op == bitops::operation::bit_not && keys.size() != 1)
+    {
+      throw std::runtime_error("ERR BITOP NOT must be called with a single source key.");
+    }
+    ensure_memory();
+    std::vector<flat_table::hash_type> hashes;
+    hashes.reserve(keys.size() + 1);
+    hashes.push_back(flat_table::hash(dest));
+    for (const auto &key : keys)
+    {
+      hashes.push_back(flat_table::hash(key));
+    }
+    auto locks = lock_shards(hashes);
+
+    /*
+     * 대상 키를 먼저 만들어 두고 원본들은 find로만 찾음. 이후로는 어느 table도 바뀌지 않으므로
+     * 원본 값(인라인 문자열 포함)을 가리키는 string_view가 끝까지 유효함.
+     */
+    auto &dest_shard = shard_for(hashes[0]);
+    auto [dest_entry, inserted] = dest_shard.data.try_emplace(dest, hashes[0]);
+    if (!inserted && is_key_expired(*dest_entry))
+    {
+      dest_entry->clear_expiry();
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      inserted = true;
+    }
+
+    std::vector<std::string> scratch(keys.size());
+    std::vector<std::string_view> sources(keys.size());
+    std::size_t length = 0, dest_uses = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      const value_entry *entry = keys[i] == dest ? (inserted ? nullptr : dest_entry)
+                                                 : shard_for(hashes[i + 1]).data.find(keys[i], hashes[i + 1]);
+      if (entry && !is_key_expired(*entry))
+      {
+        auto bytes = string_bytes(entry->value, scratch[i]);
+        if (!bytes)
+        {
+          if (inserted)
+          {
+            dest_shard.data.erase(dest, hashes[0]);
+          }
+          throw std::runtime_error("ERR wrong type of value");
+        }
+        sources[i] = *bytes;
+        touch(*entry);
+      }
+      length = std::max(length, sources[i].size());
+      dest_uses += keys[i] == dest ? 1 : 0;
+    }
+
+    if (length == 0)
+    {
+      // 결과가 빈 문자열이면 대상 키를 지움
+      dest_shard.data.erase(dest, hashes[0]);
+      sync_memory(dest_shard);
+      return 0;
+    }
+
+    auto *arena = dest_shard.data.arena();
+    const auto before = value_memory(dest_entry->value);
+    const bool dest_is_string = !inserted && std::holds_alternative<RedisString>(dest_entry->value);
+    // dest가 원본 중 하나(NOT이면 그 유일한 원본)이면 그 버퍼에 바로 나머지를 합침 (교환 법칙)
+    const bool in_place = dest_is_string && dest_uses == 1;
+    if (!in_place && dest_uses > 0)
+    {
+      // 같은 키가 여러 번 나오면 dest를 덮어쓰기 전에 원본 내용을 복사해 둠
+      for (std::size_t i = 0; i < keys.size(); ++i)
+      {
+        if (keys[i] == dest && sources[i].data() != scratch[i].data())
+        {
+          scratch[i].assign(sources[i]);
+          sources[i] = scratch[i];
+        }
+      }
+    }
+    if (!dest_is_string)
+    {
+      dest_entry->value = RedisString();
+    }
+    RedisString &str = std::get<RedisString>(dest_entry->value);
+    str.resize(length, arena);
+    auto *p = reinterpret_cast<unsigned char *>(str.mutable_data());
+
+    std::size_t first = 0;
+    if (in_place)
+    {
+      first = static_cast<std::size_t>(std::find(keys.begin(), keys.end(), dest) - keys.begin());
+      if (op == bitops::operation::bit_not)
+      {
+        bitops::combine(op, p, p, length);
+      }
+    }
+    else
+    {
+      // 첫 원본을 dest 버퍼에 복사해 두고 (NOT이면 뒤집으며 복사) 나머지를 합침
+      const auto &src = sources[0];
+      if (op == bitops::operation::bit_not)
+      {
+        bitops::combine(op, p, reinterpret_cast<const unsigned char *>(src.data()), src.size());
+      }
+      else
+      {
+        std::memcpy(p, src.data(), src.size());
+        std::memset(p + src.size(), 0, length - src.size());
+      }
+    }
+    if (op != bitops::operation::bit_not)
+    {
+      for (std::size_t i = 0; i < keys.size(); ++i)
+      {
+        if (i == first)
+        {
+          continue;
+        }
+        const auto &src = sources[i];
+        bitops::combine(op, p, reinterpret_cast<const unsigned char *>(src.data()), src.size());
+        if (op == bitops::operation::bit_and)
+        {
+          // 짧은 원본의 뒤는 0이므로 AND 결과도 0
+          std::memset(p + src.size(), 0, length - src.size());
+        }
+      }
+    }
+
+    dest_entry->clear_expiry();
+    dest_shard.data.value_resized(before, *dest_entry);
+    touch(*dest_entry, inserted);
+    sync_memory(dest_shard);
+    return length;
+  }
+
+  std::vector<std::optional<std::int64_t>> store::bitfield(const std::string &key, const std::vector<bitfield_op> &ops)
+  {
+    std::vector<std::optional<std::int64_t>> results;
+    results.reserve(ops.size());
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    const bool writes = std::any_of(ops.begin(), ops.end(),
+                                    [](const bitfield_op &op) { return op.type != bitfield_op::kind::get; });
+    if (!writes)
+    {
+      // GET만 있으면 읽기 잠금으로 충분하고 키도 만들지 않음
+      read_lock lock(sh.mutex);
+      std::string scratch;
+      const auto bytes = find_string(sh, key, h, scratch).value_or(std::string_view());
+      for (const auto &op : ops)
+      {
+        results.push_back(read_field(reinterpret_cast<const unsigned char *>(bytes.data()), bytes.size(), op));
+      }
+      return results;
+    }
+
+    ensure_memory();
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    if (!inserted && is_key_expired(*entry))
+    {
+      entry->clear_expiry();
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      inserted = true;
+    }
+    const auto before = value_memory(entry->value);
+    RedisString &str = writable_string(sh, *entry, inserted);
+    // 쓰는 필드가 모두 들어가도록 한 번에 늘림
+    std::size_t needed = str.size();
+    for (const auto &op : ops)
+    {
+      if (op.type != bitfield_op::kind::get)
+      {
+        needed = std::max(needed, static_cast<std::size_t>((op.offset + op.bits - 1) / 8 + 1));
+      }
+    }
+    str.resize(needed, sh.data.arena());
+    auto *p = reinterpret_cast<unsigned char *>(str.mutable_data());
+    for (const auto &op : ops)
+    {
+      results.push_back(op.type == bitfield_op::kind::get ? std::optional<std::int64_t>(read_field(p, needed, op))
+                                                          : write_field(p, needed, op));
+    }
+    sh.data.value_resized(before, *entry);
+    touch(*entry, inserted);
+    sync_memory(sh);
+    return results;
+  }
+
+  bool store::pfadd(const std::string &key, const std::vector<std::string> &elements)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    if (!inserted && is_key_expired(*entry))
+    {
+      entry->clear_expiry();
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      inserted = true;
+    }
+    const auto before = value_memory(entry->value);
+    if (inserted)
+    {
+      entry->value = boxed<RedisHll>(hyperloglog(hll_options_));
+    }
+    auto *hll = std::get_if<boxed<RedisHll>>(&entry->value);
+    if (!hll)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    bool changed = inserted;
+    for (const auto &element : elements)
+    {
+      changed = (*hll)->add(element) || changed;
+    }
+    sh.data.value_resized(before, *entry);
+    touch(*entry, inserted);
+    sync_memory(sh);
+    return changed;
+  }
+
+  std::uint64_t store::pfcount(const std::vector<std::string> &keys)
+  {
+    if (keys.size() == 1)
+    {
+      // 키 하나는 캐시된 추정값을 그대로 씀
+      const auto h = flat_table::hash(keys[0]);
+      auto &sh = shard_for(h);
+      read_lock lock(sh.mutex);
+      const RedisHll *hll = find_collection<RedisHll>(sh, keys[0], h);
+      return hll ? hll->count() : 0;
+    }
+    std::vector<flat_table::hash_type> hashes;
+    hashes.reserve(keys.size());
+    for (const auto &key : keys)
+    {
+      hashes.push_back(flat_table::hash(key));
+    }
+    auto locks = lock_shards_shared(hashes);
+    auto raw = hyperloglog::make_raw();
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      if (const RedisHll *hll = find_collection<RedisHll>(shard_for(hashes[i]), keys[i], hashes[i]))
+      {
+        hll->merge_into(raw);
+      }
+    }
+    return hyperloglog::estimate(raw);
+  }
+
+  void store::pfmerge(const std::string &dest, const std::vector<std::string> &sources)
+  {
+    ensure_memory();
+    std::vector<flat_table::hash_type> hashes;
+    hashes.reserve(sources.size() + 1);
+    hashes.push_back(flat_table::hash(dest));
+    for (const auto &key : sources)
+    {
+      hashes.push_back(flat_table::hash(key));
+    }
+    auto locks = lock_shards(hashes);
+
+    // bitop과 같이 대상 키를 먼저 만들어 두어, 이후 찾은 원본 포인터가 끝까지 유효하도록 함
+    auto &dest_shard = shard_for(hashes[0]);
+    auto [dest_entry, inserted] = dest_shard.data.try_emplace(dest, hashes[0]);
+    if (!inserted && is_key_expired(*dest_entry))
+    {
+      dest_entry->clear_expiry();
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      inserted = true;
+    }
+    const auto fail_wrong_type = [&]() {
+      if (inserted)
+      {
+        dest_shard.data.erase(dest, hashes[0]);
+      }
+      throw std::runtime_error("ERR wrong type of value");
+    };
+    if (!inserted && !std::holds_alternative<boxed<RedisHll>>(dest_entry->value))
+    {
+      fail_wrong_type();
+    }
+
+    // 원본들의 register를 펼친 배열 하나에 byte 단위 max로 모음 (dest 자신은 merge_from이 더함)
+    auto raw = hyperloglog::make_raw();
+    for (std::size_t i = 0; i < sources.size(); ++i)
+    {
+      if (sources[i] == dest)
+      {
+        continue;
+      }
+      const value_entry *entry = shard_for(hashes[i + 1]).data.find(sources[i], hashes[i + 1]);
+      if (!entry || is_key_expired(*entry))
+      {
+        continue;
+      }
+      const auto *hll = std::get_if<boxed<RedisHll>>(&entry->value);
+      if (!hll)
+      {
+        fail_wrong_type();
+      }
+      (*hll)->merge_into(raw);
+      touch(*entry);
+    }
+
+    const auto before = value_memory(dest_entry->value);
+    if (inserted)
+    {
+      dest_entry->value = boxed<RedisHll>(hyperloglog(hll_options_));
+    }
+    std::get<boxed<RedisHll>>(dest_entry->value)->merge_from(raw);
+    dest_shard.data.value_resized(before, *dest_entry);
+    touch(*dest_entry, inserted);
+    sync_memory(dest_shard);
+  }
+
+  namespace
+  {
+    // 벽시계 시각 (밀리초, Unix epoch 기준). XADD의 자동 ID와 스냅샷에 저장하는 시각에 씀
+    std::uint64_t unix_time_ms()
+    {
+      return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                            std::chrono::system_clock::now().time_since_epoch())
+                                            .count());
+    }
+
+    const char *const xgroup_requires_key =
+        "ERR The XGROUP subcommand requires the key to exist. Note that for CREATE you may want to use the "
+        "MKSTREAM option to create an empty stream automatically.";
+  } // namespace
+
+  RedisStream *store::find_stream_for_write(shard &sh, const std::string &key, flat_table::hash_type h)
+  {
+    value_entry *entry = find_for_write(sh, key, h);
+    if (!entry)
+    {
+      return nullptr;
+    }
+    auto *s = std::get_if<boxed<RedisStream>>(&entry->value);
+    if (!s)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    touch(*entry);
+    return &**s;
+  }
+
+  stream::consumer_group &store::find_group_for_write(shard &sh, const std::string &key, flat_table::hash_type h,
+                                                      const std::string &group)
+  {
+    RedisStream *s = find_stream_for_write(sh, key, h);
+    if (!s)
+    {
+      throw std::runtime_error(xgroup_requires_key);
+    }
+    stream::consumer_group *g = s->find_group(group);
+    if (!g)
+    {
+      throw std::runtime_error("NOGROUP No such consumer group '" + group + "' for key name '" + key + "'");
+    }
+    return *g;
+  }
+
+  std::optional<stream_id> store::xadd(const std::string &key, const stream::id_spec &id,
+                                       const std::vector<std::string> &fields, const stream_trim &trim,
+                                       bool nomkstream)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    value_entry *entry = find_for_write(sh, key, h);
+    if (!entry && nomkstream)
+    {
+      sync_memory(sh);
+      return std::nullopt;
+    }
+    if (entry && !std::holds_alternative<boxed<RedisStream>>(entry->value))
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+
+    // ID가 잘못되면 키를 만들지 않도록, 새 스트림은 따로 만들어 ID를 구한 뒤 넣음
+    const bool inserted = entry == nullptr;
+    RedisStream fresh(stream_options_);
+    RedisStream &target = inserted ? fresh : *std::get<boxed<RedisStream>>(entry->value);
+    const stream_id new_id = target.next_id(id, unix_time_ms());
+    if (inserted)
+    {
+      entry = sh.data.try_emplace(key, h).first;
+      entry->value = boxed<RedisStream>(std::move(fresh));
+    }
+    const auto before = value_memory(entry->value);
+    RedisStream &s = *std::get<boxed<RedisStream>>(entry->value);
+    s.append(new_id, fields);
+    s.trim(trim);
+    sh.data.value_resized(before, *entry);
+    touch(*entry, inserted);
+    sync_memory(sh);
+    return new_id;
+  }
+
+  std::size_t store::xlen(const std::string &key)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisStream *s = find_collection<RedisStream>(sh, key, h);
+    return s ? s->size() : 0;
+  }
+
+  std::vector<stream::entry> store::xrange(const std::string &key, stream_id start, stream_id end, std::size_t count,
+                                           bool reverse)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const RedisStream *s = find_collection<RedisStream>(sh, key, h);
+    return s ? s->range(start, end, count, reverse) : std::vector<stream::entry>{};
+  }
+
+  std::size_t store::xtrim(const std::string &key, const stream_trim &trim)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    RedisStream *s = find_stream_for_write(sh, key, h);
+    if (!s)
+    {
+      sync_memory(sh);
+      return 0;
+    }
+    value_entry *entry = sh.data.find(key, h);
+    const auto before = value_memory(entry->value);
+    const std::size_t removed = s->trim(trim);
+    sh.data.value_resized(before, *entry);
+    sync_memory(sh);
+    return removed;
+  }
+
+  stream_read_result store::xread(const std::vector<std::string> &keys,
+                                  const std::vector<std::optional<stream_id>> &after, std::size_t count)
+  {
+    std::vector<flat_table::hash_type> hashes;
+    hashes.reserve(keys.size());
+    for (const auto &key : keys)
+    {
+      hashes.push_back(flat_table::hash(key));
+    }
+    auto locks = lock_shards_shared(hashes);
+    stream_read_result result;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      const RedisStream *s = find_collection<RedisStream>(shard_for(hashes[i]), keys[i], hashes[i]);
+      if (!s)
+      {
+        continue;
+      }
+      stream_id start = after[i] ? *after[i] : s->last_id();
+      if (!start.increment())
+      {
+        continue;
+      }
+      auto entries = s->range(start, stream_id::max(), count ? count : std::numeric_limits<std::size_t>::max());
+      if (!entries.empty())
+      {
+        result.emplace_back(keys[i], std::move(entries));
+      }
+    }
+    return result;
+  }
+
+  void store::xgroup_create(const std::string &key, const std::string &group, std::optional<stream_id> id,
+                            bool mkstream)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    value_entry *entry = find_for_write(sh, key, h);
+    bool inserted = false;
+    if (!entry)
+    {
+      if (!mkstream)
+      {
+        sync_memory(sh);
+        throw std::runtime_error(xgroup_requires_key);
+      }
+      entry = sh.data.try_emplace(key, h).first;
+      entry->value = boxed<RedisStream>(stream(stream_options_));
+      inserted = true;
+    }
+    auto *s = std::get_if<boxed<RedisStream>>(&entry->value);
+    if (!s)
+    {
+      throw std::runtime_error("ERR wrong type of value");
+    }
+    const auto before = value_memory(entry->value);
+    if (!(*s)->create_group(group, id ? *id : (*s)->last_id()))
+    {
+      throw std::runtime_error("BUSYGROUP Consumer Group name already exists");
+    }
+    sh.data.value_resized(before, *entry);
+    touch(*entry, inserted);
+    sync_memory(sh);
+  }
+
+  void store::xgroup_setid(const std::string &key, const std::string &group, std::optional<stream_id> id)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto &g = find_group_for_write(sh, key, h, group);
+    g.last_delivered = id ? *id : std::get<boxed<RedisStream>>(sh.data.find(key, h)->value)->last_id();
+  }
+
+  bool store::xgroup_destroy(const std::string &key, const std::string &group)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    RedisStream *s = find_stream_for_write(sh, key, h);
+    if (!s)
+    {
+      sync_memory(sh);
+      throw std::runtime_error(xgroup_requires_key);
+    }
+    value_entry *entry = sh.data.find(key, h);
+    const auto before = value_memory(entry->value);
+    const bool destroyed = s->destroy_group(group);
+    sh.data.value_resized(before, *entry);
+    sync_memory(sh);
+    return destroyed;
+  }
+
+  bool store::xgroup_createconsumer(const std::string &key, const std::string &group, const std::string &consumer)
+  {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto &g = find_group_for_write(sh, key, h, group);
+    value_entry *entry = sh.data.find(key, h);
+    const auto before = value_memory(entry->value);
+    const bool created =
+        std::get<boxed<RedisStream>>(entry->value)->create_consumer(g, consumer, steady_clock_ms());
+    sh.data.value_resized(before, *entry);
+    sync_memory(sh);
+    return created;
+  }
+
+  std::size_t store::xgroup_delconsumer(const std::string &key, const std::string &group, const std::string &consumer)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto &g = find_group_for_write(sh, key, h, group);
+    value_entry *entry = sh.data.find(key, h);
+    const auto before = value_memory(entry->value);
+    const std::size_t pending = std::get<boxed<RedisStream>>(entry->value)->delete_consumer(g, consumer);
+    sh.data.value_resized(before, *entry);
+    sync_memory(sh);
+    return pending;
+  }
+
+  stream_read_result store::xreadgroup(const std::string &group, const std::string &consumer,
+                                       const std::vector<std::string> &keys,
+                                       const std::vector<std::optional<stream_id>> &after, std::size_t count,
+                                       bool noack)
+  {
+    ensure_memory();
+    std::vector<flat_table::hash_type> hashes;
+    hashes.reserve(keys.size());
+    for (const auto &key : keys)
+    {
+      hashes.push_back(flat_table::hash(key));
+    }
+    auto locks = lock_shards(hashes);
+
+    // 읽기 전에 모든 키와 그룹을 확인하여, 오류이면 어느 그룹의 상태도 바꾸지 않음
+    std::vector<RedisStream *> streams(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      streams[i] = find_stream_for_write(shard_for(hashes[i]), keys[i], hashes[i]);
+      if (!streams[i] || !streams[i]->find_group(group))
+      {
+        for (const auto h : hashes)
+        {
+          sync_memory(shard_for(h));
+        }
+        throw std::runtime_error("NOGROUP No such key '" + keys[i] + "' or consumer group '" + group +
+                                 "' in XREADGROUP with GROUP option");
+      }
+    }
+
+    stream_read_result result;
+    const auto now = steady_clock_ms();
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      auto &sh = shard_for(hashes[i]);
+      value_entry *entry = sh.data.find(keys[i], hashes[i]);
+      const auto before = value_memory(entry->value);
+      auto entries =
+          streams[i]->read_group(*streams[i]->find_group(group), consumer, after[i], count, noack, now);
+      sh.data.value_resized(before, *entry);
+      if (!entries.empty() || after[i])
+      {
+        result.emplace_back(keys[i], std::move(entries));
+      }
+    }
+    for (const auto h : hashes)
+    {
+      sync_memory(shard_for(h));
+    }
+    return result;
+  }
+
+  std::size_t store::xack(const std::string &key, const std::string &group, const std::vector<stream_id> &ids)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    RedisStream *s = find_stream_for_write(sh, key, h);
+    stream::consumer_group *g = s ? s->find_group(group) : nullptr;
+    if (!g)
+    {
+      sync_memory(sh);
+      return 0;
+    }
+    value_entry *entry = sh.data.find(key, h);
+    const auto before = value_memory(entry->value);
+    const std::size_t acked = s->ack(*g, ids);
+    sh.data.value_resized(before, *entry);
+    sync_memory(sh);
+    return acked;
+  }
+
+  namespace
+  {
+    const stream::consumer_group &pending_group(const RedisStream *s, const std::string &key,
+                                                const std::string &group)
+    {
+      if (s)
+      {
+        if (auto it = s->groups().find(group); it != s->groups().end())
+        {
+          return it->second;
+        }
+      }
+      throw std::runtime_error("NOGROUP No such key '" + key + "' or consumer group '" + group + "'");
+    }
+  } // namespace
+
+  xpending_summary store::xpending(const std::string &key, const std::string &group)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const auto &g = pending_group(find_collection<RedisStream>(sh, key, h), key, group);
+    xpending_summary summary;
+    summary.count = g.pending.size();
+    if (summary.count)
+    {
+      summary.min = g.pending.begin()->first;
+      summary.max = g.pending.rbegin()->first;
+    }
+    for (const auto &[name, c] : g.consumers)
+    {
+      if (!c.pending.empty())
+      {
+        summary.consumers.emplace_back(name, c.pending.size());
+      }
+    }
+    return summary;
+  }
+
+  std::vector<xpending_entry> store::xpending(const std::string &key, const std::string &group, stream_id start,
+                                              stream_id end, std::size_t count,
+                                              const std::optional<std::string> &consumer, std::int64_t min_idle_ms)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const auto &g = pending_group(find_collection<RedisStream>(sh, key, h), key, group);
+    std::vector<xpending_entry> result;
+    if (start > end)
+    {
+      return result;
+    }
+    const auto now = steady_clock_ms();
+    const auto add = [&](stream_id id, const stream::pending_entry &p) {
+      const std::int64_t idle = now - p.delivery_ms;
+      if (idle >= min_idle_ms)
+      {
+        result.push_back({id, p.consumer, idle, p.deliveries});
+      }
+    };
+    if (consumer)
+    {
+      // 소비자를 지정하면 그 소비자의 PEL만 훑음
+      auto c = g.consumers.find(*consumer);
+      if (c == g.consumers.end())
+      {
+        return result;
+      }
+      for (auto it = c->second.pending.lower_bound(start);
+           it != c->second.pending.end() && *it <= end && result.size() < count; ++it)
+      {
+        add(*it, g.pending.at(*it));
+      }
+      return result;
+    }
+    for (auto it = g.pending.lower_bound(start); it != g.pending.end() && it->first <= end && result.size() < count;
+         ++it)
+    {
+      add(it->first, it->second);
+    }
+    return result;
+  }
+
+  bool store::exists(const std::string &key)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const value_entry *entry = sh.data.find(key, h);
+    if (!entry)
+    {
+      return false;
+    }
+    if (is_key_expired(*entry))
+    {
+      defer_expired(sh, key);
+      return false;
+    }
+    return true;
+  }
+
+  bool store::expire(const std::string &key, int seconds)
+  {
+    return pexpire(key, static_cast<long long>(seconds) * 1000);
+  }
+
+  bool store::pexpire(const std::string &key, long long ms)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    value_entry *entry = sh.data.find(key, h);
+    if (entry && is_key_expired(*entry))
+    {
+      // 이미 만료된 키에 TTL을 다시 설정하면 키가 되살아나므로 삭제만 함
+      sh.data.erase(key, h);
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      sync_memory(sh);
+      return false;
+    }
+    if (!entry)
+    {
+      return false;
+    }
+    if (ms > 0)
+    {
+      set_expiry(sh, h, *entry, steady_clock_ms() + ms);
+    }
+    else
+    {
+      entry->clear_expiry();
+    }
+    sync_memory(sh);
+    return true;
+  }
+
+  long long store::ttl(const std::string &key)
+  {
+    const long long ms = pttl(key);
+    return ms < 0 ? ms : ms / 1000;
+  }
+
+  long long store::pttl(const std::string &key)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const value_entry *entry = sh.data.find(key, h);
+    if (!entry)
+    {
+      return -2; // Key does not exist
+    }
+
+    if (is_key_expired(*entry))
+    {
+      defer_expired(sh, key);
+      return -2; // Key does not exist (as it just expired)
+    }
+
+    if (!entry->has_expiry())
+    {
+      return -1; // Key exists but has no associated expire
+    }
+
+    return entry->expiry - steady_clock_ms();
+  }
+
+  long long store::incrby(const std::string &key, long long increment) {
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+
+    if (!inserted && is_key_expired(*entry)) {
+        // 만료된 키는 새 키처럼 취급하고 슬롯은 그대로 재사용
+        entry->clear_expiry();
+        expired_keys_.fetch_add(1, std::memory_order_relaxed);
+        inserted = true;
+    }
+
+    if (inserted) {
+        const auto before = value_memory(entry->value);
+        entry->value = RedisInt(increment);
+        sh.data.value_resized(before, *entry);
+        touch(*entry, true);
+        sync_memory(sh);
+        return increment;
+    }
+
+    // 카운터는 정수 인코딩으로 저장되어 있으므로 문자열 변환이나 할당 없이 더함
+    RedisInt current;
+    if (auto int_ptr = std::get_if<RedisInt>(&entry->value)) {
+        current = *int_ptr;
+    } else if (auto str_ptr = std::get_if<RedisString>(&entry->value)) {
+        auto parsed = parse_int64(str_ptr->view());
+        if (!parsed) {
+            throw std::runtime_error("ERR value is not an integer or out of range");
+        }
+        current = *parsed;
+    } else {
+        throw std::runtime_error("ERR wrong type of value");
+    }
+
+    if ((increment > 0 && current > std::numeric_limits<RedisInt>::max() - increment) ||
+        (increment < 0 && current < std::numeric_limits<RedisInt>::min() - increment)) {
+        throw std::runtime_error("ERR increment or decrement would overflow");
+    }
+    current += increment;
+    const auto before = value_memory(entry->value);
+    entry->value = current;
+    sh.data.value_resized(before, *entry);
+    touch(*entry);
+    sync_memory(sh);
+    return current;
+  }
+
+  long long store::decrby(const std::string &key, long long decrement) {
+    if (decrement == std::numeric_limits<long long>::min()) {
+        throw std::runtime_error("ERR decrement would overflow");
+    }
+    return incrby(key, -decrement);
+  }
+
+  long long store::incr(const std::string &key) {
+    return incrby(key, 1);
+  }
+
+  long long store::decr(const std::string &key) {
+    return incrby(key, -1);
+  }
+
+  namespace
+  {
+    // 스냅샷(또는 DUMP payload)에 값 하나를 씀. 시각(소비자, PEL)은 to_unix_ms를 더해 벽시계 기준으로 바꿈
+    struct snapshot_value_writer
+    {
+      snapshot::encoder &out;
+      std::int64_t to_unix_ms;
+
+      void operator()(const RedisString &s) const { out.put_string(s.view()); }
+      void operator()(const RedisInt &n) const { out.put_u64(static_cast<std::uint64_t>(n)); }
+      void operator()(const boxed<RedisList> &list) const
+      {
+        out.put_varint(list->size());
+        list->for_each([this](std::string_view value) { out.put_string(value); });
+      }
+      void operator()(const boxed<RedisHash> &hash) const
+      {
+        out.put_varint(hash->size());
+        hash->for_each([this](std::string_view field, std::string_view value) {
+          out.put_string(field);
+          out.put_string(value);
+        });
+      }
+      void operator()(const boxed<RedisSet> &set) const
+      {
+        out.put_varint(set->size());
+        set->for_each([this](std::string_view member) { out.put_string(member); });
+      }
+      void operator()(const boxed<RedisSortedSet> &zset) const
+      {
+        out.put_varint(zset->size());
+        zset->for_each([this](std::string_view member, double score) {
+          out.put_string(member);
+          out.put_double(score);
+        });
+      }
+      void operator()(const boxed<RedisHll> &hll) const
+      {
+        std::string registers;
+        hll->serialize(registers);
+        out.put_string(registers);
+      }
+      void operator()(const boxed<RedisStream> &s) const
+      {
+        // [항목 수][ID, 필드 수, 필드...]... [마지막 ID] [그룹 수][그룹...]
+        out.put_varint(s->size());
+        s->for_each(stream_id{}, stream_id::max(), false,
+                    [this](stream_id id, const std::vector<std::string_view> &fields) {
+                      put_id(id);
+                      out.put_varint(fields.size());
+                      for (const auto field : fields)
+                      {
+                        out.put_string(field);
+                      }
+                      return true;
+                    });
+        put_id(s->last_id());
+        out.put_varint(s->groups().size());
+        for (const auto &[name, group] : s->groups())
+        {
+          out.put_string(name);
+          put_id(group.last_delivered);
+          out.put_varint(group.consumers.size());
+          for (const auto &[consumer_name, c] : group.consumers)
+          {
+            out.put_string(consumer_name);
+            out.put_u64(static_cast<std::uint64_t>(c.seen_ms + to_unix_ms));
+          }
+          out.put_varint(group.pending.size());
+          for (const auto &[id, p] : group.pending)
+          {
+            put_id(id);
+            out.put_string(p.consumer);
+            out.put_u64(static_cast<std::uint64_t>(p.delivery_ms + to_unix_ms));
+            out.put_varint(p.deliveries);
+          }
+        }
+      }
+
+      void put_id(stream_id id) const
+      {
+        out.put_varint(id.ms);
+        out.put_varint(id.seq);
+      }
+    };
+
+    stream_id get_stream_id(snapshot::decoder &in)
+    {
+      const std::uint64_t ms = in.get_varint();
+      return stream_id{ms, in.get_varint()};
+    }
+
+    // DUMP payload의 끝: version u32 | CRC-64 u64
+    constexpr std::size_t dump_trailer_size = 4 + 8;
+
+    // [type][값][version][앞 bytes 전체의 CRC-64]
+    void encode_dump(snapshot::encoder &out, const RedisValue &value, std::int64_t to_unix_ms)
+    {
+      out.put_u8(static_cast<std::uint8_t>(value.index()));
+      std::visit(snapshot_value_writer{out, to_unix_ms}, value);
+      out.put_u32(snapshot::encoding_version);
+      const std::string &buf = out.buffer();
+      out.put_u64(snapshot::crc64(0, buf.data(), buf.size()));
+    }
+
+    void append_command(std::string &out, std::initializer_list<std::string_view> args)
+    {
+      out += '*';
+      out += std::to_string(args.size());
+      out += "\r\n";
+      for (const auto arg : args)
+      {
+        serializer::append_bulk_string(out, arg);
+      }
+    }
+
+    // 스냅샷 레코드의 값 앞부분
+    struct snapshot_record
+    {
+      snapshot::value_type type;
+      std::int64_t expiry; // steady_clock ms (0이면 만료 없음)
+      std::string_view key;
+    };
+
+    snapshot_record read_record_head(snapshot::decoder &in, std::int64_t to_steady)
+    {
+      const std::uint8_t tag = in.get_u8();
+      snapshot_record record{static_cast<snapshot::value_type>(tag & ~snapshot::expiry_flag), 0, {}};
+      if (tag & snapshot::expiry_flag)
+      {
+        // 0은 만료 없음을 뜻하므로 변환 결과가 0 이하이면 이미 지난 시각으로 봄
+        record.expiry = std::max<std::int64_t>(1, static_cast<std::int64_t>(in.get_u64()) + to_steady);
+      }
+      record.key = in.get_string();
+      return record;
+    }
+
+    // BGREWRITEAOF 자식이 쓰는 임시 파일 (AOF와 같은 디렉터리에 두어야 rename으로 바꿀 수 있음)
+    std::string rewrite_temp_path(const std::string &aof_path, long pid)
+    {
+      const auto dir = std::filesystem::path(aof_path).parent_path();
+      return (dir / ("temp-rewriteaof-" + std::to_string(pid) + ".aof")).string();
+    }
+  } // namespace
+
+  store::~store()
+  {
+    // 백그라운드 적재는 다음 레코드에서 멈춤
+    if (const auto lazy = std::atomic_load(&lazy_))
+    {
+      lazy->stop = true;
+    }
+    if (hydrator_.joinable())
+    {
+      hydrator_.join();
+    }
+#ifdef __linux__
+    // 끝나지 않은 BGSAVE는 기다리지 않고 멈춤 (이전 스냅샷 파일은 그대로 남음)
+    if (bgsave_child_ != 0)
+    {
+      ::kill(bgsave_child_, SIGKILL);
+      ::waitpid(bgsave_child_, nullptr, 0);
+      std::remove((dir_ + "/temp-" + std::to_string(bgsave_child_) + ".rdb").c_str());
+    }
+    // BGREWRITEAOF도 마찬가지 (AOF는 그대로 남음)
+    if (rewrite_child_ != 0)
+    {
+      ::kill(rewrite_child_, SIGKILL);
+      ::waitpid(rewrite_child_, nullptr, 0);
+      std::remove(rewrite_temp_.c_str());
+    }
+#endif
+  }
+
+  std::string store::snapshot_path() const
+  {
+    return dir_ + "/" + dbfilename_;
+  }
+
+  std::vector<store::read_lock> store::lock_all_shards_shared()
+  {
+    std::vector<read_lock> locks;
+    locks.reserve(shard_count_);
+    for (std::size_t i = 0; i < shard_count_; ++i)
+    {
+      locks.emplace_back(shards_[i].mutex);
+    }
+    return locks;
+  }
+
+  void store::write_snapshot(const std::string &path)
+  {
+    snapshot::writer out(path);
+    std::size_t keys = 0;
+    for (std::size_t i = 0; i < shard_count_; ++i)
+    {
+      keys += shards_[i].data.size();
+    }
+    const std::int64_t now = steady_clock_ms();
+    const auto unix_now = static_cast<std::int64_t>(unix_time_ms());
+    out.put_header(keys, unix_now, static_cast<std::uint32_t>(shard_count_));
+
+    const snapshot_value_writer write_value{out, unix_now - now};
+    for (std::size_t i = 0; i < shard_count_; ++i)
+    {
+      shards_[i].data.for_each([&](std::string_view key, const value_entry &entry) {
+        if (entry.has_expiry() && now > entry.expiry)
+        {
+          return;
+        }
+        // chunk는 한 shard의 키만 담으므로, 같은 shard 수로 불러올 때 chunk를 shard별로 나누어 넣을 수 있음
+        out.begin_record(static_cast<std::uint32_t>(i), flat_table::hash(key));
+        // type byte는 RedisValue의 대안 번호와 같음
+        const auto type = static_cast<std::uint8_t>(entry.value.index());
+        if (entry.has_expiry())
+        {
+          out.put_u8(type | snapshot::expiry_flag);
+          out.put_u64(static_cast<std::uint64_t>(entry.expiry + unix_now - now));
+        }
+        else
+        {
+          out.put_u8(type);
+        }
+        out.put_string(key);
+        std::visit(write_value, entry.value);
+      });
+    }
+    out.commit();
+  }
+
+  void store::save()
+  {
+    if (loading())
+    {
+      throw std::runtime_error("LOADING Redis is loading the dataset in memory");
+    }
+    std::lock_guard<std::mutex> guard(persistence_mutex_);
+    if (bgsave_child_ != 0)
+    {
+      throw std::runtime_error("ERR Background save already in progress");
+    }
+    const std::string path = snapshot_path();
+    const std::string temp = path + ".tmp";
+    try
+    {
+      auto locks = lock_all_shards_shared();
+      write_snapshot(temp);
+    }
+    catch (...)
+    {
+      std::remove(temp.c_str());
+      throw;
+    }
+    if (std::rename(temp.c_str(), path.c_str()) != 0)
+    {
+      std::remove(temp.c_str());
+      throw std::runtime_error("ERR cannot rename " + temp + " to " + path + ": " + std::strerror(errno));
+    }
+    last_save_time_ = static_cast<std::int64_t>(unix_time_ms() / 1000);
+  }
+
+  void store::bgsave()
+  {
+    // 자식은 fork한 순간의 메모리만 보므로 파일에만 있는 키를 쓸 수 없음
+    if (loading())
+    {
+      throw std::runtime_error("LOADING Redis is loading the dataset in memory");
+    }
+#ifdef __linux__
+    std::lock_guard<std::mutex> guard(persistence_mutex_);
+    if (bgsave_child_ != 0)
+    {
+      throw std::runtime_error("ERR Background save already in progress");
+    }
+    if (rewrite_child_ != 0)
+    {
+      throw std::runtime_error("ERR An AOF log rewriting in progress: can't BGSAVE right now");
+    }
+    pid_t pid;
+    {
+      // 모든 shard의 읽기 잠금을 잡아 어떤 쓰기도 진행 중이 아닌 순간에 fork함.
+      // 자식은 그 순간의 메모리를 copy-on-write로 보므로 잠금 없이 순회하고,
+      // 부모는 fork가 끝나자마자 잠금을 풀고 계속 명령을 처리함 (바뀌는 페이지만 복사됨)
+      auto locks = lock_all_shards_shared();
+      pid = ::fork();
+      if (pid == 0)
+      {
+        // 자식: 다른 스레드는 없고 잠금 상태도 복사된 것이므로 파일만 쓰고 소멸자 없이 종료
+        int status = 0;
+        try
+        {
+          write_snapshot(dir_ + "/temp-" + std::to_string(::getpid()) + ".rdb");
+        }
+        catch (const std::exception &)
+        {
+          status = 1;
+        }
+        ::_exit(status);
+      }
+    }
+    if (pid < 0)
+    {
+      throw std::runtime_error(std::string("ERR fork failed: ") + std::strerror(errno));
+    }
+    bgsave_child_ = pid;
+#else
+    save();
+#endif
+  }
+
+  void store::poll_background_save()
+  {
+#ifdef __linux__
+    std::lock_guard<std::mutex> guard(persistence_mutex_);
+    int status = 0;
+    if (bgsave_child_ != 0)
+    {
+      const pid_t done = ::waitpid(bgsave_child_, &status, WNOHANG);
+      if (done != 0)
+      {
+        const std::string temp = dir_ + "/temp-" + std::to_string(bgsave_child_) + ".rdb";
+        bgsave_child_ = 0;
+        last_bgsave_ok_ = done > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                          std::rename(temp.c_str(), snapshot_path().c_str()) == 0;
+        if (last_bgsave_ok_)
+        {
+          last_save_time_ = static_cast<std::int64_t>(unix_time_ms() / 1000);
+        }
+        else
+        {
+          std::remove(temp.c_str());
+        }
+      }
+    }
+    if (rewrite_child_ != 0)
+    {
+      const pid_t done = ::waitpid(rewrite_child_, &status, WNOHANG);
+      if (done != 0)
+      {
+        rewrite_child_ = 0;
+        last_aof_rewrite_ok_ = done > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        // 파일 교체는 AOF writer 스레드가 버퍼에 모인 명령을 옮긴 뒤에 함
+        if (last_aof_rewrite_ok_)
+        {
+          rewrite_aof_->finish_rewrite(rewrite_temp_);
+        }
+        else
+        {
+          rewrite_aof_->abort_rewrite();
+          std::remove(rewrite_temp_.c_str());
+        }
+        rewrite_aof_ = nullptr;
+      }
+    }
+#endif
+  }
+
+  persistence_status store::persistence() const
+  {
+    std::lock_guard<std::mutex> guard(persistence_mutex_);
+    persistence_status status;
+    status.bgsave_in_progress = bgsave_child_ != 0;
+    status.last_save_time = last_save_time_;
+    status.last_bgsave_ok = last_bgsave_ok_;
+    status.aof_rewrite_child = rewrite_child_ != 0;
+    status.last_aof_rewrite_ok = last_aof_rewrite_ok_;
+    status.loading_error = lazy_load_error_;
+    status.loading_faulted_keys = lazy_faulted_keys_;
+    if (const auto lazy = std::atomic_load(&lazy_))
+    {
+      status.loading = true;
+      status.loading_total_bytes = lazy->total_bytes;
+      status.loading_loaded_bytes = lazy->done_bytes.load(std::memory_order_relaxed);
+      status.loading_faulted_keys = lazy->faulted.load(std::memory_order_relaxed);
+      std::lock_guard<std::mutex> lazy_guard(lazy->mutex);
+      status.loading_error = lazy->error;
+    }
+    return status;
+  }
+
+  std::optional<std::string> store::dump(const std::string &key)
+  {
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    read_lock lock(sh.mutex);
+    const value_entry *entry = sh.data.find(key, h);
+    if (!entry)
+    {
+      return std::nullopt;
+    }
+    if (is_key_expired(*entry))
+    {
+      defer_expired(sh, key);
+      return std::nullopt;
+    }
+    snapshot::encoder out;
+    encode_dump(out, entry->value, static_cast<std::int64_t>(unix_time_ms()) - steady_clock_ms());
+    return std::move(out.buffer());
+  }
+
+  void store::restore(const std::string &key, long long ttl_ms, bool absolute_ttl, std::string_view payload,
+                      bool replace)
+  {
+    if (ttl_ms < 0)
+    {
+      throw std::runtime_error("ERR Invalid TTL value, must be >= 0");
+    }
+    if (payload.size() < 1 + dump_trailer_size)
+    {
+      throw std::runtime_error("ERR DUMP payload version or checksum are wrong");
+    }
+    snapshot::decoder trailer(payload.data() + payload.size() - dump_trailer_size, dump_trailer_size);
+    const std::uint32_t version = trailer.get_u32();
+    if (version != snapshot::encoding_version || trailer.get_u64() != snapshot::crc64(0, payload.data(), payload.size() - 8))
+    {
+      throw std::runtime_error("ERR DUMP payload version or checksum are wrong");
+    }
+
+    // 잠금 밖에서 먼저 값을 만듦 (잘못된 payload면 키 공간을 건드리지 않음)
+    const std::int64_t now = steady_clock_ms();
+    const std::int64_t to_steady = now - static_cast<std::int64_t>(unix_time_ms());
+    RedisValue value;
+    try
+    {
+      snapshot::decoder in(payload.data(), payload.size() - dump_trailer_size);
+      const std::uint8_t type = in.get_u8();
+      if (type > static_cast<std::uint8_t>(snapshot::value_type::stream))
+      {
+        throw std::runtime_error("unknown type");
+      }
+      read_snapshot_value(in, static_cast<snapshot::value_type>(type), value, nullptr, to_steady);
+      if (in.remaining() != 0)
+      {
+        throw std::runtime_error("trailing bytes");
+      }
+    }
+    catch (const std::runtime_error &)
+    {
+      throw std::runtime_error("ERR Bad data format");
+    }
+    std::int64_t expiry = 0;
+    if (ttl_ms > 0)
+    {
+      expiry = std::max<std::int64_t>(1, absolute_ttl ? ttl_ms + to_steady : now + ttl_ms);
+    }
+
+    ensure_memory();
+    const auto h = flat_table::hash(key);
+    auto &sh = shard_for(h);
+    write_lock lock(sh.mutex);
+    reclaim_expired(sh);
+    value_entry *existing = sh.data.find(key, h);
+    if (existing && is_key_expired(*existing))
+    {
+      sh.data.erase(key, h);
+      expired_keys_.fetch_add(1, std::memory_order_relaxed);
+      existing = nullptr;
+    }
+    if (existing && !replace)
+    {
+      throw std::runtime_error("BUSYKEY Target key name already exists.");
+    }
+    if (expiry != 0 && now > expiry)
+    {
+      // 이미 지난 시각으로 복원하면 키를 만들지 않음 (REPLACE면 기존 키만 지워짐)
+      if (existing)
+      {
+        sh.data.erase(key, h);
+      }
+      sync_memory(sh);
+      return;
+    }
+    auto [entry, inserted] = sh.data.try_emplace(key, h);
+    const auto before = value_memory(entry->value);
+    if (const auto *str = std::get_if<RedisString>(&value))
+    {
+      assign_string(entry->value, str->view(), sh.data.arena());
+    }
+    else
+    {
+      entry->value = std::move(value);
+    }
+    sh.data.value_resized(before, *entry);
+    if (expiry != 0)
+    {
+      set_expiry(sh, h, *entry, expiry);
+    }
+    else
+    {
+      entry->clear_expiry();
+    }
+    touch(*entry, inserted);
+    sync_memory(sh);
+  }
+
+  void store::write_aof_rewrite(const std::string &path)
+  {
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+      throw std::runtime_error("ERR cannot create " + path + ": " + std::strerror(errno));
+    }
+    constexpr std::size_t flush_size = 1 << 20;
+    std::string out;
+    out.reserve(flush_size * 2);
+    bool ok = true;
+    const auto flush = [&] {
+      ok = ok && std::fwrite(out.data(), 1, out.size(), file) == out.size();
+      out.clear();
+    };
+
+    // 키마다 명령 하나: 문자열은 SET, 나머지 타입은 원소마다 명령을 만드는 대신 DUMP payload로 RESTORE.
+    // TTL이 있으면 PEXPIREAT (벽시계 기준)를 덧붙임
+    const std::int64_t now = steady_clock_ms();
+    const auto unix_now = static_cast<std::int64_t>(unix_time_ms());
+    snapshot::encoder payload;
+    for (std::size_t i = 0; i < shard_count_ && ok; ++i)
+    {
+      shards_[i].data.for_each([&](std::string_view key, const value_entry &entry) {
+        if (entry.has_expiry() && now > entry.expiry)
+        {
+          return;
+        }
+        if (const auto text = string_value(entry.value))
+        {
+          append_command(out, {"SET", key, *text});
+        }
+        else
+        {
+          payload.buffer().clear();
+          encode_dump(payload, entry.value, unix_now - now);
+          append_command(out, {"RESTORE", key, "0", payload.buffer()});
+        }
+        if (entry.has_expiry())
+        {
+          append_command(out, {"PEXPIREAT", key, std::to_string(entry.expiry + unix_now - now)});
+        }
+        if (out.size() >= flush_size)
+        {
+          flush();
+        }
+      });
+    }
+    flush();
+    ok = ok && std::fflush(file) == 0;
+#ifdef __linux__
+    ok = ok && ::fsync(::fileno(file)) == 0;
+#endif
+    const int saved = errno;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok)
+    {
+      throw std::runtime_error("ERR cannot write " + path + ": " + std::strerror(saved));
+    }
+  }
+
+  void store::bgrewriteaof(append_only_file &aof)
+  {
+    if (loading())
+    {
+      throw std::runtime_error("LOADING Redis is loading the dataset in memory");
+    }
+    std::lock_guard<std::mutex> guard(persistence_mutex_);
+    if (rewrite_child_ != 0 || aof.rewrite_in_progress())
+    {
+      throw std::runtime_error("ERR Background append only file rewriting already in progress");
+    }
+    if (bgsave_child_ != 0)
+    {
+      throw std::runtime_error("ERR Background save in progress: can't rewrite the append only file right now");
+    }
+#ifdef __linux__
+    pid_t pid;
+    {
+      // 모든 order stripe를 잡았으므로 실행은 되었지만 아직 feed되지 않은 쓰기 명령이 없고, shard 읽기
+      // 잠금으로 반쯤 적용된 쓰기도 없음. 따라서 자식이 보는 키 공간은 정확히 지금까지 feed된 명령의
+      // 결과이고, 그 뒤의 명령은 모두 start_rewrite 이후에 feed되어 rewrite 버퍼에 들어감
+      const auto order = aof.lock_all_order();
+      auto locks = lock_all_shards_shared();
+      pid = ::fork();
+      if (pid == 0)
+      {
+        int status = 0;
+        try
+        {
+          write_aof_rewrite(rewrite_temp_path(aof.path(), ::getpid()));
+        }
+        catch (const std::exception &)
+        {
+          status = 1;
+        }
+        ::_exit(status);
+      }
+      if (pid > 0)
+      {
+        aof.start_rewrite();
+      }
+    }
+    if (pid < 0)
+    {
+      throw std::runtime_error(std::string("ERR fork failed: ") + std::strerror(errno));
+    }
+    rewrite_child_ = pid;
+    rewrite_temp_ = rewrite_temp_path(aof.path(), pid);
+    rewrite_aof_ = &aof;
+#else
+    // fork가 없으면 잠금을 잡은 채 직접 씀 (그동안 쓰기 명령은 기다림)
+    const std::string temp = rewrite_temp_path(aof.path(), 0);
+    try
+    {
+      const auto order = aof.lock_all_order();
+      auto locks = lock_all_shards_shared();
+      aof.start_rewrite();
+      write_aof_rewrite(temp);
+    }
+    catch (...)
+    {
+      aof.abort_rewrite();
+      std::remove(temp.c_str());
+      last_aof_rewrite_ok_ = false;
+      throw;
+    }
+    last_aof_rewrite_ok_ = true;
+    aof.finish_rewrite(temp);
+#endif
+  }
+
+  void store::read_snapshot_value(snapshot::decoder &in, snapshot::value_type type, RedisValue &out,
+                                  slab_arena *arena, std::int64_t to_steady_ms)
+  {
+    switch (type)
+    {
+    case snapshot::value_type::string:
+      out = RedisString(in.get_string(), arena);
+      return;
+    case snapshot::value_type::integer:
+      out = static_cast<RedisInt>(in.get_u64());
+      return;
+    case snapshot::value_type::list:
+    {
+      out = boxed<RedisList>(quicklist(list_options_));
+      auto &list = *std::get<boxed<RedisList>>(out);
+      for (std::uint64_t n = in.get_varint(); n > 0; --n)
+      {
+        list.push_back(in.get_string());
+      }
+      return;
+    }
+    case snapshot::value_type::hash:
+    {
+      out = boxed<RedisHash>(compact_hash(hash_options_));
+      auto &hash = *std::get<boxed<RedisHash>>(out);
+      for (std::uint64_t n = in.get_varint(); n > 0; --n)
+      {
+        const auto field = in.get_string();
+        hash.set(field, in.get_string());
+      }
+      return;
+    }
+    case snapshot::value_type::set:
+    {
+      out = boxed<RedisSet>(compact_set(set_options_));
+      auto &set = *std::get<boxed<RedisSet>>(out);
+      for (std::uint64_t n = in.get_varint(); n > 0; --n)
+      {
+        set.insert(in.get_string());
+      }
+      return;
+    }
+    case snapshot::value_type::zset:
+    {
+      out = boxed<RedisSortedSet>(sorted_set(zset_options_));
+      auto &zset = *std::get<boxed<RedisSortedSet>>(out);
+      for (std::uint64_t n = in.get_varint(); n > 0; --n)
+      {
+        const auto member = in.get_string();
+        zset.insert(member, in.get_double());
+      }
+      return;
+    }
+    case snapshot::value_type::hll:
+    {
+      out = boxed<RedisHll>(hyperloglog(hll_options_));
+      if (!std::get<boxed<RedisHll>>(out)->deserialize(in.get_string()))
+      {
+        throw std::runtime_error("ERR snapshot has a malformed HyperLogLog value");
+      }
+      return;
+    }
+    case snapshot::value_type::stream:
+    {
+      out = boxed<RedisStream>(stream(stream_options_));
+      auto &s = *std::get<boxed<RedisStream>>(out);
+      std::vector<std::string> fields;
+      for (std::uint64_t n = in.get_varint(); n > 0; --n)
+      {
+        const stream_id id = get_stream_id(in);
+        if (!s.empty() && id <= s.last_id())
+        {
+          throw std::runtime_error("ERR snapshot has stream entries out of order");
+        }
+        fields.resize(in.get_varint());
+        for (auto &field : fields)
+        {
+          field = in.get_string();
+        }
+        s.append(id, fields);
+      }
+      s.restore_last_id(get_stream_id(in));
+      for (std::uint64_t groups = in.get_varint(); groups > 0; --groups)
+      {
+        const std::string name(in.get_string());
+        s.create_group(name, get_stream_id(in));
+        auto &group = *s.find_group(name);
+        for (std::uint64_t n = in.get_varint(); n > 0; --n)
+        {
+          const std::string consumer(in.get_string());
+          s.create_consumer(group, consumer, static_cast<std::int64_t>(in.get_u64()) + to_steady_ms);
+        }
+        for (std::uint64_t n = in.get_varint(); n > 0; --n)
+        {
+          const stream_id id = get_stream_id(in);
+          const std::string consumer(in.get_string());
+          const auto delivery_ms = static_cast<std::int64_t>(in.get_u64()) + to_steady_ms;
+          s.restore_pending(group, id, consumer, delivery_ms, in.get_varint());
+        }
+      }
+      return;
+    }
+    }
+    throw std::runtime_error("ERR snapshot has an unknown value type");
+  }
+
+  std::size_t store::load_snapshot_chunk(std::string_view records, shard *owned, std::int64_t now,
+                                         std::int64_t to_steady, std::size_t &expired)
+  {
+    snapshot::decoder in(records.data(), records.size());
+    std::size_t keys = 0;
+    while (in.remaining() > 0)
+    {
+      const auto [type, expiry, key] = read_record_head(in, to_steady);
+      if (expiry != 0 && now > expiry)
+      {
+        RedisValue discarded;
+        read_snapshot_value(in, type, discarded, nullptr, to_steady);
+        ++expired;
+        continue;
+      }
+      const auto h = flat_table::hash(key);
+      auto &sh = shard_for(h);
+      // owned가 있으면 호출자가 그 shard의 잠금을 잡고 있음. 아니면 키마다 잠금
+      write_lock lock;
+      if (owned == nullptr)
+      {
+        lock = write_lock(sh.mutex);
+      }
+      else if (&sh != owned)
+      {
+        throw std::runtime_error("ERR snapshot chunk has a key from another shard");
+      }
+      auto [entry, inserted] = sh.data.try_emplace(key, h);
+      const auto before = value_memory(entry->value);
+      read_snapshot_value(in, type, entry->value, sh.data.arena(), to_steady);
+      sh.data.value_resized(before, *entry);
+      if (expiry != 0)
+      {
+        set_expiry(sh, h, *entry, expiry);
+      }
+      else
+      {
+        entry->clear_expiry();
+      }
+      touch(*entry, inserted);
+      if (owned == nullptr)
+      {
+        sync_memory(sh);
+      }
+      ++keys;
+    }
+    return keys;
+  }
+
+  std::optional<snapshot_load_stats> store::load_snapshot(std::size_t threads, const snapshot_progress &progress)
+  {
+    const std::string path = snapshot_path();
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec))
+    {
+      return std::nullopt;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const snapshot::reader in(path);
+    const auto &chunks = in.chunks();
+    snapshot_load_stats stats;
+    stats.bytes = in.file_size();
+    stats.chunks = chunks.size();
+
+    // 저장한 store와 shard 수가 같으면 chunk의 shard가 곧 이 store의 shard이므로, 스레드마다 shard를 통째로
+    // 맡아 그 잠금 하나만 잡고 넣음 (스레드끼리 잠금을 다투지 않음). 아니면 (version 1 파일 포함) chunk를
+    // 나누어 읽고 키마다 해당 shard를 잠금
+    const bool by_shard =
+        in.shard_count() == shard_count_ &&
+        std::all_of(chunks.begin(), chunks.end(), [this](const auto &c) { return c.shard < shard_count_; });
+
+    // 테이블을 미리 키워 적재 중에는 재해시가 일어나지 않게 함. shard별 키 수를 알면 그만큼,
+    // 모르면 header의 키 수를 나누고 (shard마다 평균에서 조금씩 벗어나므로) 1/16의 여유를 둠
+    std::vector<std::uint64_t> shard_keys(shard_count_, 0);
+    if (by_shard)
+    {
+      for (const auto &c : chunks)
+      {
+        shard_keys[c.shard] += c.keys;
+      }
+    }
+    else
+    {
+      const std::uint64_t per_shard = in.key_count() / shard_count_;
+      std::fill(shard_keys.begin(), shard_keys.end(), per_shard + per_shard / 16);
+    }
+    for (std::size_t i = 0; i < shard_count_; ++i)
+    {
+      write_lock lock(shards_[i].mutex);
+      shards_[i].data.reserve(shards_[i].data.size() + static_cast<std::size_t>(shard_keys[i]) + 64);
+    }
+
+    // 작업 단위: by_shard면 shard 하나의 chunk들, 아니면 chunk 하나. 큰 것부터 나누어 스레드 간 부하를 맞춤
+    struct work
+    {
+      std::size_t shard;
+      std::vector<std::size_t> chunks;
+      std::uint64_t bytes = 0;
+    };
+    std::vector<work> works;
+    if (by_shard)
+    {
+      works.resize(shard_count_);
+      for (std::size_t i = 0; i < shard_count_; ++i)
+      {
+        works[i].shard = i;
+      }
+      for (std::size_t i = 0; i < chunks.size(); ++i)
+      {
+        works[chunks[i].shard].chunks.push_back(i);
+        works[chunks[i].shard].bytes += chunks[i].size;
+      }
+    }
+    else
+    {
+      for (std::size_t i = 0; i < chunks.size(); ++i)
+      {
+        works.push_back(work{0, {i}, chunks[i].size});
+      }
+    }
+    std::sort(works.begin(), works.end(), [](const work &a, const work &b) { return a.bytes > b.bytes; });
+
+    if (threads == 0)
+    {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::max<std::size_t>(1, std::min(threads, works.size()));
+    stats.threads = threads;
+
+    const std::int64_t now = steady_clock_ms();
+    const std::int64_t to_steady = now - static_cast<std::int64_t>(unix_time_ms());
+    std::uint64_t total_bytes = 0;
+    for (const auto &c : chunks)
+    {
+      total_bytes += c.size;
+    }
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::mutex result_mutex; // 아래 셋과 progress 호출을 보호
+    std::exception_ptr error;
+    std::uint64_t done_bytes = 0;
+
+    const auto run = [&] {
+      std::size_t keys = 0;
+      std::size_t expired = 0;
+      try
+      {
+        for (std::size_t w = next++; w < works.size() && !failed.load(); w = next++)
+        {
+          const auto &job = works[w];
+          write_lock owned_lock;
+          shard *owned = nullptr;
+          if (by_shard)
+          {
+            owned = &shards_[job.shard];
+            owned_lock = write_lock(owned->mutex);
+          }
+          for (const std::size_t c : job.chunks)
+          {
+            keys += load_snapshot_chunk(in.chunk(c), owned, now, to_steady, expired);
+            if (progress)
+            {
+              std::lock_guard<std::mutex> guard(result_mutex);
+              done_bytes += chunks[c].size;
+              progress(done_bytes, total_bytes);
+            }
+          }
+          if (owned)
+          {
+            sync_memory(*owned);
+          }
+        }
+      }
+      catch (...)
+      {
+        failed = true;
+        std::lock_guard<std::mutex> guard(result_mutex);
+        if (!error)
+        {
+          error = std::current_exception();
+        }
+      }
+      std::lock_guard<std::mutex> guard(result_mutex);
+      stats.keys += keys;
+      stats.expired += expired;
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (std::size_t t = 1; t < threads; ++t)
+    {
+      workers.emplace_back(run);
+    }
+    run();
+    for (auto &t : workers)
+    {
+      t.join();
+    }
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+  }
+
+  std::optional<snapshot_load_stats> store::load_snapshot_lazily(const snapshot_progress &progress)
+  {
+    const std::string path = snapshot_path();
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec))
+    {
+      return std::nullopt;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    auto lazy = std::make_shared<lazy_snapshot>(path);
+    if (lazy->in.key_index_slots() == 0)
+    {
+      // key index가 없는 이전 형식: 키를 찾을 수 없으므로 전부 읽은 뒤에 시작
+      lazy.reset();
+      return load_snapshot(0, progress);
+    }
+    for (const auto &c : lazy->in.chunks())
+    {
+      lazy->remaining += c.keys;
+      lazy->total_bytes += c.size;
+    }
+    lazy->to_steady = steady_clock_ms() - static_cast<std::int64_t>(unix_time_ms());
+    lazy->progress = progress;
+
+    snapshot_load_stats stats;
+    stats.keys = static_cast<std::size_t>(lazy->remaining.load());
+    stats.bytes = lazy->in.file_size();
+    stats.chunks = lazy->in.chunks().size();
+    stats.threads = 1;
+    stats.deferred = true;
+
+    // 테이블은 미리 키우지 않음 (수십 GB의 슬롯 배열을 잡느라 시작이 늦어지므로). 적재 중의 확장은
+    // 증분 재해시로 나누어 진행됨
+    std::atomic_store(&lazy_, lazy);
+    loading_.store(true, std::memory_order_release);
+    if (stats.chunks == 0)
+    {
+      hydrate_chunks(*lazy);
+    }
+    else
+    {
+      hydrator_ = std::thread([this, lazy] { hydrate_chunks(*lazy); });
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+  }
+
+  void store::fault_in(flat_table::hash_type h)
+  {
+    const auto lazy = std::atomic_load(&lazy_);
+    if (!lazy)
+    {
+      return;
+    }
+    // 같은 tag의 레코드는 모두 읽음 (다른 키의 레코드라도 어차피 넣어야 하는 것이므로 해가 없음).
+    // 이미 읽은 레코드만 있으면 잠금 없이 끝남
+    const auto &in = lazy->in;
+    const std::uint64_t tag = snapshot::key_tag(h);
+    for (std::uint64_t pos = h & lazy->mask, n = 0; n <= lazy->mask; pos = (pos + 1) & lazy->mask, ++n)
+    {
+      const std::uint64_t slot = in.key_index_slot(pos);
+      if (slot == 0)
+      {
+        return;
+      }
+      if (snapshot::key_slot_tag(slot) != tag || lazy->is_loaded(pos))
+      {
+        continue;
+      }
+      const std::uint64_t offset = snapshot::key_slot_offset(slot);
+      const std::size_t c = in.chunk_at(offset);
+      if (c >= in.chunks().size() || !lazy->check_chunk(c))
+      {
+        continue;
+      }
+      try
+      {
+        write_lock lock;
+        hydrate_record(*lazy, c, offset, pos, false, lock);
+        lazy->faulted.fetch_add(1, std::memory_order_relaxed);
+      }
+      catch (const std::exception &e)
+      {
+        // 레코드를 읽을 수 없음: 맡은 것으로 표시하여, 잠금을 잡은 뒤의 shard_for가 다시 읽으려고 같은
+        // shard를 잠그지 않게 함
+        lazy->claim(pos);
+        lazy->fail(e.what());
+      }
+    }
+  }
+
+  std::uint64_t store::hydrate_record(lazy_snapshot &lazy, std::size_t chunk, std::uint64_t offset, std::uint64_t slot,
+                                      bool find_next, write_lock &lock)
+  {
+    const auto &info = lazy.in.chunks()[chunk];
+    const std::string_view records = lazy.in.unchecked_chunk(chunk);
+    const auto start = static_cast<std::size_t>(offset - info.offset);
+    snapshot::decoder in(records.data() + start, records.size() - start);
+    const auto [type, expiry, key] = read_record_head(in, lazy.to_steady);
+    const auto h = flat_table::hash(key);
+    if (slot == lazy_snapshot::npos)
+    {
+      slot = lazy.find_slot(h, offset);
+    }
+    auto &sh = shards_[shard_index(h)];
+    if (lock.mutex() != &sh.mutex)
+    {
+      // 다른 shard의 잠금은 먼저 놓음. 두 잠금을 함께 잡으면 shard를 오름차순으로 잠그는
+      // lock_shards와 교착될 수 있음 (저장할 때와 shard 수가 다르면 한 chunk가 여러 shard에 걸침)
+      if (lock.owns_lock())
+      {
+        lock.unlock();
+      }
+      lock = write_lock(sh.mutex);
+    }
+    // 값을 읽다 실패해도 다시 시도하지 않도록 먼저 표시
+    if (lazy.claim(slot))
+    {
+      // 파일을 연 뒤에 만료된 키는 넣지 않음. 키가 이미 있는 경우는 없어야 하지만 (쓰기는 모두 먼저 이
+      // 레코드를 읽으므로), 있다면 새로 쓰인 값을 남김
+      if (expiry == 0 || steady_clock_ms() <= expiry)
+      {
+        reclaim_expired(sh);
+        auto [entry, inserted] = sh.data.try_emplace(key, h);
+        if (inserted)
+        {
+          const auto before = value_memory(entry->value);
+          read_snapshot_value(in, type, entry->value, sh.data.arena(), lazy.to_steady);
+          sh.data.value_resized(before, *entry);
+          if (expiry != 0)
+          {
+            set_expiry(sh, h, *entry, expiry);
+          }
+          touch(*entry, inserted);
+          sync_memory(sh);
+          return find_next ? offset + in.position() : 0;
+        }
+      }
+    }
+    if (!find_next)
+    {
+      return 0;
+    }
+    RedisValue discarded;
+    read_snapshot_value(in, type, discarded, nullptr, lazy.to_steady);
+    return offset + in.position();
+  }
+
+  void store::hydrate_chunks(lazy_snapshot &lazy)
+  {
+    const auto &chunks = lazy.in.chunks();
+    bool last = chunks.empty();
+    for (std::size_t c = lazy.next_chunk++; c < chunks.size(); c = lazy.next_chunk++)
+    {
+      lazy.in.will_need(c);
+      if (lazy.check_chunk(c))
+      {
+        try
+        {
+          // shard의 잠금은 레코드 몇 개를 넣는 동안만 잡으므로 같은 shard의 명령이 오래 기다리지 않음
+          const std::uint64_t end = chunks[c].offset + chunks[c].size;
+          write_lock lock;
+          std::size_t batch = 0;
+          for (std::uint64_t offset = chunks[c].offset; offset < end;)
+          {
+            if (lazy.stop.load(std::memory_order_relaxed))
+            {
+              return;
+            }
+            offset = hydrate_record(lazy, c, offset, lazy_snapshot::npos, true, lock);
+            if (++batch == lazy_snapshot::batch_records)
+            {
+              lock = write_lock();
+              batch = 0;
+            }
+          }
+        }
+        catch (const std::exception &e)
+        {
+          // 나머지 chunk는 계속 읽음. 이 chunk의 남은 키는 없는 것으로 보임
+          lazy.fail(e.what());
+        }
+      }
+      const auto done_bytes = lazy.done_bytes += chunks[c].size;
+      if (lazy.progress)
+      {
+        std::lock_guard<std::mutex> guard(lazy.mutex);
+        lazy.progress(done_bytes, lazy.total_bytes);
+      }
+      last = ++lazy.done_chunks == chunks.size();
+    }
+    if (!last)
+    {
+      return;
+    }
+    // 모든 chunk를 끝낸 스레드: 키는 이제 모두 테이블에 있으므로 매핑을 놓음
+    // (지금 fault_in 중인 스레드가 가진 복사본이 사라질 때 해제됨)
+    {
+      std::lock_guard<std::mutex> guard(persistence_mutex_);
+      std::lock_guard<std::mutex> lazy_guard(lazy.mutex);
+      lazy_load_error_ = lazy.error;
+      lazy_faulted_keys_ = lazy.faulted.load();
+    }
+    loading_.store(false, std::memory_order_release);
+    std::atomic_store(&lazy_, std::shared_ptr<lazy_snapshot>());
+    std::lock_guard<std::mutex> guard(lazy.mutex);
+    lazy.finished = true;
+    lazy.done.notify_all();
+  }
+
+  void store::finish_loading()
+  {
+    const auto lazy = std::atomic_load(&lazy_);
+    if (!lazy)
+    {
+      return;
+    }
+    hydrate_chunks(*lazy);
+    std::unique_lock<std::mutex> lock(lazy->mutex);
+    lazy->done.wait(lock, [&] { return lazy->finished; });
   }
 
 } // namespace mini_redis
@@ -0,0 +1,662 @@
+#include "storage/stream.hpp"
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+
+namespace mini_redis
+{
+  namespace
+  {
+    /*
+     * 메모리 추정에 쓰는 노드 크기 (64-bit libstdc++ 기준, malloc 단위로 올림).
+     * PEL 항목은 그룹의 std::map 노드와 소비자의 std::set 노드 하나씩, 소비자와 그룹은 map 노드 하나.
+     */
+    constexpr std::size_t pending_node_bytes = 112 + 64;
+    constexpr std::size_t consumer_node_bytes = 128;
+    constexpr std::size_t group_node_bytes = 192;
+
+    void put_varint(std::vector<unsigned char> &out, std::uint64_t v)
+    {
+      while (v >= 0x80)
+      {
+        out.push_back(static_cast<unsigned char>(v | 0x80));
+        v >>= 7;
+      }
+      out.push_back(static_cast<unsigned char>(v));
+    }
+
+    std::uint64_t get_varint(const unsigned char *&p)
+    {
+      std::uint64_t v = 0;
+      for (unsigned shift = 0;; shift += 7)
+      {
+        const unsigned char c = *p++;
+        v |= std::uint64_t(c & 0x7f) << shift;
+        if (!(c & 0x80))
+        {
+          return v;
+        }
+      }
+    }
+
+    void put_string(std::vector<unsigned char> &out, std::string_view s)
+    {
+      put_varint(out, s.size());
+      out.insert(out.end(), s.begin(), s.end());
+    }
+
+    std::string_view get_string(const unsigned char *&p)
+    {
+      const auto len = static_cast<std::size_t>(get_varint(p));
+      std::string_view s(reinterpret_cast<const char *>(p), len);
+      p += len;
+      return s;
+    }
+
+    // radix_tree의 key: big-endian으로 써서 byte 순서가 ID 순서와 같게 함
+    std::string_view index_key(stream_id id, char (&buf)[16])
+    {
+      for (int i = 0; i < 8; ++i)
+      {
+        buf[i] = static_cast<char>(id.ms >> (56 - 8 * i));
+        buf[8 + i] = static_cast<char>(id.seq >> (56 - 8 * i));
+      }
+      return std::string_view(buf, sizeof(buf));
+    }
+  } // namespace
+
+  bool stream_id::increment()
+  {
+    if (seq != std::numeric_limits<std::uint64_t>::max())
+    {
+      ++seq;
+      return true;
+    }
+    if (ms == std::numeric_limits<std::uint64_t>::max())
+    {
+      return false;
+    }
+    ++ms;
+    seq = 0;
+    return true;
+  }
+
+  bool stream_id::decrement()
+  {
+    if (seq != 0)
+    {
+      --seq;
+      return true;
+    }
+    if (ms == 0)
+    {
+      return false;
+    }
+    --ms;
+    seq = std::numeric_limits<std::uint64_t>::max();
+    return true;
+  }
+
+  std::string stream_id::to_string() const
+  {
+    return std::to_string(ms) + "-" + std::to_string(seq);
+  }
+
+  std::optional<stream_id> stream_id::parse(std::string_view s, std::uint64_t missing_seq)
+  {
+    const auto parse_part = [](std::string_view part, std::uint64_t &out) {
+      if (part.empty())
+      {
+        return false;
+      }
+      auto [end, ec] = std::from_chars(part.data(), part.data() + part.size(), out);
+      return ec == std::errc() && end == part.data() + part.size();
+    };
+    stream_id id;
+    const auto dash = s.find('-');
+    if (!parse_part(s.substr(0, dash), id.ms))
+    {
+      return std::nullopt;
+    }
+    if (dash == std::string_view::npos)
+    {
+      id.seq = missing_seq;
+    }
+    else if (!parse_part(s.substr(dash + 1), id.seq))
+    {
+      return std::nullopt;
+    }
+    return id;
+  }
+
+  stream::stream() : stream(options{}) {}
+
+  stream::stream(const options &opts) : opts_(opts), index_(std::make_unique<radix_tree>(true)) {}
+
+  stream::~stream()
+  {
+    release();
+  }
+
+  stream::stream(const stream &other) : stream(other.opts_)
+  {
+    copy_from(other);
+  }
+
+  stream::stream(stream &&other) noexcept
+      : opts_(other.opts_), index_(std::move(other.index_)), head_(std::exchange(other.head_, nullptr)),
+        tail_(std::exchange(other.tail_, nullptr)), size_(std::exchange(other.size_, 0)), last_id_(other.last_id_),
+        block_bytes_(std::exchange(other.block_bytes_, 0)), groups_(std::move(other.groups_)),
+        pending_count_(std::exchange(other.pending_count_, 0)),
+        consumer_count_(std::exchange(other.consumer_count_, 0))
+  {
+  }
+
+  stream &stream::operator=(const stream &other)
+  {
+    if (this != &other)
+    {
+      release();
+      opts_ = other.opts_;
+      index_ = std::make_unique<radix_tree>(true);
+      copy_from(other);
+    }
+    return *this;
+  }
+
+  stream &stream::operator=(stream &&other) noexcept
+  {
+    if (this != &other)
+    {
+      release();
+      opts_ = other.opts_;
+      index_ = std::move(other.index_);
+      head_ = std::exchange(other.head_, nullptr);
+      tail_ = std::exchange(other.tail_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+      last_id_ = other.last_id_;
+      block_bytes_ = std::exchange(other.block_bytes_, 0);
+      groups_ = std::move(other.groups_);
+      pending_count_ = std::exchange(other.pending_count_, 0);
+      consumer_count_ = std::exchange(other.consumer_count_, 0);
+    }
+    return *this;
+  }
+
+  void stream::release()
+  {
+    while (head_)
+    {
+      delete std::exchange(head_, head_->next);
+    }
+    tail_ = nullptr;
+    size_ = 0;
+    block_bytes_ = 0;
+  }
+
+  void stream::copy_from(const stream &other)
+  {
+    std::vector<std::string> owned;
+    other.for_each(stream_id{}, stream_id::max(), false,
+                   [&](stream_id id, const std::vector<std::string_view> &fields) {
+                     owned.assign(fields.begin(), fields.end());
+                     append(id, owned);
+                     return true;
+                   });
+    last_id_ = other.last_id_;
+    groups_ = other.groups_;
+    pending_count_ = other.pending_count_;
+    consumer_count_ = other.consumer_count_;
+  }
+
+  stream_id stream::next_id(const id_spec &spec, std::uint64_t now_ms) const
+  {
+    static const char *const not_greater =
+        "ERR The ID specified in XADD is equal or smaller than the target stream top item";
+    if (spec.auto_ms)
+    {
+      if (now_ms > last_id_.ms)
+      {
+        return {now_ms, 0};
+      }
+      // 시계가 뒤로 가거나 같은 ms 안에서는 마지막 ID 다음 순번
+      stream_id id = last_id_;
+      if (!id.increment())
+      {
+        throw std::runtime_error("ERR The stream has exhausted the last possible ID, unable to add more items");
+      }
+      return id;
+    }
+    if (spec.auto_seq)
+    {
+      if (spec.id.ms < last_id_.ms)
+      {
+        throw std::runtime_error(not_greater);
+      }
+      if (spec.id.ms > last_id_.ms)
+      {
+        return {spec.id.ms, 0};
+      }
+      if (last_id_.seq == std::numeric_limits<std::uint64_t>::max())
+      {
+        throw std::runtime_error(not_greater);
+      }
+      return {spec.id.ms, last_id_.seq + 1};
+    }
+    if (spec.id == stream_id{})
+    {
+      throw std::runtime_error("ERR The ID specified in XADD must be greater than 0-0");
+    }
+    if (spec.id <= last_id_)
+    {
+      throw std::runtime_error(not_greater);
+    }
+    return spec.id;
+  }
+
+  stream::block *stream::new_block(stream_id id, const std::vector<std::string> &fields)
+  {
+    auto *b = new block;
+    b->master = id;
+    b->last = id;
+    // 첫 항목의 필드 이름을 block 머리에 두고, 같은 이름을 쓰는 항목은 값만 저장
+    put_varint(b->data, fields.size() / 2);
+    for (std::size_t i = 0; i < fields.size(); i += 2)
+    {
+      put_string(b->data, fields[i]);
+    }
+    b->head = static_cast<std::uint32_t>(b->data.size());
+    b->prev = tail_;
+    if (tail_)
+    {
+      tail_->next = b;
+    }
+    else
+    {
+      head_ = b;
+    }
+    tail_ = b;
+    char key[16];
+    index_->insert(index_key(id, key), b);
+    block_bytes_ += sizeof(block) + b->data.capacity();
+    return b;
+  }
+
+  void stream::append(stream_id id, const std::vector<std::string> &fields)
+  {
+    if (!tail_ || tail_->added >= opts_.node_max_entries || tail_->data.size() >= opts_.node_max_bytes)
+    {
+      if (tail_)
+      {
+        // 더 쓰지 않을 block은 여유 용량을 돌려줌
+        block_bytes_ -= tail_->data.capacity();
+        tail_->data.shrink_to_fit();
+        block_bytes_ += tail_->data.capacity();
+      }
+      new_block(id, fields);
+    }
+    block &b = *tail_;
+    const std::size_t capacity_before = b.data.capacity();
+
+    std::vector<std::string_view> master_fields;
+    read_master_fields(b, master_fields);
+    bool same_fields = master_fields.size() * 2 == fields.size();
+    for (std::size_t i = 0; same_fields && i < master_fields.size(); ++i)
+    {
+      same_fields = master_fields[i] == fields[2 * i];
+    }
+
+    // ID는 master와의 차이로: ms가 같으면 순번도 차이, 다르면 순번 그대로
+    const std::uint64_t ms_delta = id.ms - b.master.ms;
+    put_varint(b.data, ms_delta);
+    put_varint(b.data, ms_delta == 0 ? id.seq - b.master.seq : id.seq);
+    put_varint(b.data, (fields.size() / 2) << 1 | (same_fields ? 1 : 0));
+    for (std::size_t i = 0; i < fields.size(); i += 2)
+    {
+      if (!same_fields)
+      {
+        put_string(b.data, fields[i]);
+      }
+      put_string(b.data, fields[i + 1]);
+    }
+    block_bytes_ += b.data.capacity() - capacity_before;
+    b.last = id;
+    ++b.added;
+    ++b.live;
+    ++size_;
+    last_id_ = id;
+  }
+
+  const stream::block *stream::locate(stream_id id) const
+  {
+    // master가 id 이상인 첫 block을 찾고, master가 id보다 크면 그 앞 block에 id가 있음
+    char key[16];
+    const block *found = nullptr;
+    index_->for_each_entry(index_key(id, key), {}, [&](std::string_view, void *value) {
+      found = static_cast<const block *>(value);
+      return false;
+    });
+    if (!found)
+    {
+      return tail_;
+    }
+    return found->master == id || !found->prev ? found : found->prev;
+  }
+
+  const unsigned char *stream::read_master_fields(const block &b, std::vector<std::string_view> &names)
+  {
+    const unsigned char *p = b.data.data();
+    names.clear();
+    for (auto n = get_varint(p); n > 0; --n)
+    {
+      names.push_back(get_string(p));
+    }
+    return p;
+  }
+
+  const unsigned char *stream::decode_entry(const block &b, const unsigned char *p,
+                                            const std::vector<std::string_view> &master_fields, stream_id &id,
+                                            std::vector<std::string_view> &fields)
+  {
+    const std::uint64_t ms_delta = get_varint(p);
+    const std::uint64_t seq = get_varint(p);
+    id.ms = b.master.ms + ms_delta;
+    id.seq = ms_delta == 0 ? b.master.seq + seq : seq;
+    const std::uint64_t flags = get_varint(p);
+    const bool same_fields = flags & 1;
+    fields.clear();
+    for (std::uint64_t i = 0; i < flags >> 1; ++i)
+    {
+      fields.push_back(same_fields ? master_fields[i] : get_string(p));
+      fields.push_back(get_string(p));
+    }
+    return p;
+  }
+
+  const unsigned char *stream::skip_entry(const unsigned char *p)
+  {
+    get_varint(p);
+    get_varint(p);
+    const std::uint64_t flags = get_varint(p);
+    for (std::uint64_t i = 0; i < flags >> 1; ++i)
+    {
+      if (!(flags & 1))
+      {
+        get_string(p);
+      }
+      get_string(p);
+    }
+    return p;
+  }
+
+  std::vector<stream::entry> stream::range(stream_id start, stream_id end, std::size_t count, bool reverse) const
+  {
+    std::vector<entry> result;
+    if (count == 0)
+    {
+      return result;
+    }
+    for_each(start, end, reverse, [&](stream_id id, const std::vector<std::string_view> &fields) {
+      result.push_back({id, std::vector<std::string>(fields.begin(), fields.end())});
+      return result.size() < count;
+    });
+    return result;
+  }
+
+  void stream::remove_head_block()
+  {
+    block *b = head_;
+    char key[16];
+    index_->erase(index_key(b->master, key));
+    head_ = b->next;
+    if (head_)
+    {
+      head_->prev = nullptr;
+    }
+    else
+    {
+      tail_ = nullptr;
+    }
+    size_ -= b->live;
+    block_bytes_ -= sizeof(block) + b->data.capacity();
+    delete b;
+  }
+
+  void stream::drop_head_entries(std::size_t n)
+  {
+    const unsigned char *p = head_->data.data() + head_->head;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      p = skip_entry(p);
+    }
+    head_->head = static_cast<std::uint32_t>(p - head_->data.data());
+    head_->live -= static_cast<std::uint32_t>(n);
+    size_ -= n;
+  }
+
+  std::size_t stream::trim(const stream_trim &how)
+  {
+    if (how.by == stream_trim::strategy::none)
+    {
+      return 0;
+    }
+    const std::size_t limit = !how.approximate ? std::numeric_limits<std::size_t>::max()
+                              : how.limit      ? how.limit
+                                               : std::size_t(opts_.node_max_entries) * 100;
+    std::size_t removed = 0;
+    while (head_)
+    {
+      // 지울 앞 항목 수: 첫 block 전체를 넘으면 block째로, 아니면 '='일 때만 block 안에서 지움
+      std::size_t excess = 0;
+      if (how.by == stream_trim::strategy::maxlen)
+      {
+        excess = size_ > how.maxlen ? static_cast<std::size_t>(size_ - how.maxlen) : 0;
+      }
+      else if (head_->last < how.minid)
+      {
+        excess = head_->live;
+      }
+      else
+      {
+        std::vector<std::string_view> master_fields, fields;
+        read_master_fields(*head_, master_fields);
+        stream_id id;
+        for (const unsigned char *p = head_->data.data() + head_->head;; ++excess)
+        {
+          p = decode_entry(*head_, p, master_fields, id, fields);
+          if (id >= how.minid)
+          {
+            break;
+          }
+        }
+      }
+      if (excess == 0)
+      {
+        break;
+      }
+      if (head_->live <= excess)
+      {
+        if (removed + head_->live > limit)
+        {
+          break;
+        }
+        removed += head_->live;
+        remove_head_block();
+        continue;
+      }
+      if (!how.approximate)
+      {
+        drop_head_entries(excess);
+        removed += excess;
+      }
+      break;
+    }
+    return removed;
+  }
+
+  stream::consumer_group *stream::find_group(std::string_view name)
+  {
+    auto it = groups_.find(name);
+    return it == groups_.end() ? nullptr : &it->second;
+  }
+
+  bool stream::create_group(const std::string &name, stream_id last_delivered)
+  {
+    auto [it, inserted] = groups_.try_emplace(name);
+    if (inserted)
+    {
+      it->second.last_delivered = last_delivered;
+    }
+    return inserted;
+  }
+
+  bool stream::destroy_group(std::string_view name)
+  {
+    auto it = groups_.find(name);
+    if (it == groups_.end())
+    {
+      return false;
+    }
+    pending_count_ -= it->second.pending.size();
+    consumer_count_ -= it->second.consumers.size();
+    groups_.erase(it);
+    return true;
+  }
+
+  bool stream::create_consumer(consumer_group &group, const std::string &name, std::int64_t now_ms)
+  {
+    auto [it, inserted] = group.consumers.try_emplace(name);
+    if (inserted)
+    {
+      it->second.seen_ms = now_ms;
+      ++consumer_count_;
+    }
+    return inserted;
+  }
+
+  std::size_t stream::delete_consumer(consumer_group &group, std::string_view name)
+  {
+    auto it = group.consumers.find(name);
+    if (it == group.consumers.end())
+    {
+      return 0;
+    }
+    const std::size_t pending = it->second.pending.size();
+    for (const auto &id : it->second.pending)
+    {
+      group.pending.erase(id);
+    }
+    pending_count_ -= pending;
+    --consumer_count_;
+    group.consumers.erase(it);
+    return pending;
+  }
+
+  std::vector<stream::entry> stream::read_group(consumer_group &group, const std::string &consumer_name,
+                                                std::optional<stream_id> after, std::size_t count, bool noack,
+                                                std::int64_t now_ms)
+  {
+    create_consumer(group, consumer_name, now_ms);
+    consumer &self = group.consumers.find(consumer_name)->second;
+    self.seen_ms = now_ms;
+    const std::size_t limit = count ? count : std::numeric_limits<std::size_t>::max();
+
+    std::vector<entry> result;
+    if (after)
+    {
+      // 이력: 이 소비자가 받고 아직 ACK하지 않은 항목 중 after 다음부터 (지워진 항목은 fields가 빔)
+      for (auto it = self.pending.upper_bound(*after); it != self.pending.end() && result.size() < limit; ++it)
+      {
+        entry e{*it, {}};
+        for_each(*it, *it, false, [&](stream_id, const std::vector<std::string_view> &fields) {
+          e.fields.assign(fields.begin(), fields.end());
+          return false;
+        });
+        result.push_back(std::move(e));
+      }
+      return result;
+    }
+
+    stream_id start = group.last_delivered;
+    if (!start.increment())
+    {
+      return result;
+    }
+    result = range(start, stream_id::max(), limit);
+    for (const auto &e : result)
+    {
+      group.last_delivered = e.id;
+      if (noack)
+      {
+        continue;
+      }
+      auto [it, inserted] = group.pending.try_emplace(e.id);
+      if (inserted)
+      {
+        ++pending_count_;
+      }
+      else if (auto owner = group.consumers.find(it->second.consumer); owner != group.consumers.end())
+      {
+        // SETID로 되돌린 뒤 다시 전달하는 경우: 이전 소비자의 PEL에서 옮겨 옴
+        owner->second.pending.erase(e.id);
+      }
+      it->second = pending_entry{consumer_name, now_ms, inserted ? 1 : it->second.deliveries + 1};
+      self.pending.insert(e.id);
+    }
+    return result;
+  }
+
+  std::size_t stream::ack(consumer_group &group, const std::vector<stream_id> &ids)
+  {
+    std::size_t acked = 0;
+    for (const auto &id : ids)
+    {
+      auto it = group.pending.find(id);
+      if (it == group.pending.end())
+      {
+        continue;
+      }
+      if (auto owner = group.consumers.find(it->second.consumer); owner != group.consumers.end())
+      {
+        owner->second.pending.erase(id);
+      }
+      group.pending.erase(it);
+      --pending_count_;
+      ++acked;
+    }
+    return acked;
+  }
+
+  void stream::restore_last_id(stream_id id)
+  {
+    if (id > last_id_)
+    {
+      last_id_ = id;
+    }
+  }
+
+  void stream::restore_pending(consumer_group &group, stream_id id, const std::string &consumer_name,
+                               std::int64_t delivery_ms, std::uint64_t deliveries)
+  {
+    create_consumer(group, consumer_name, delivery_ms);
+    auto [it, inserted] = group.pending.try_emplace(id);
+    if (!inserted)
+    {
+      // 같은 ID가 두 번 나오면 이전 소비자의 목록에서 빼고 덮어씀
+      if (auto owner = group.consumers.find(it->second.consumer); owner != group.consumers.end())
+      {
+        owner->second.pending.erase(id);
+      }
+      --pending_count_;
+    }
+    it->second = pending_entry{consumer_name, delivery_ms, deliveries};
+    group.consumers.find(consumer_name)->second.pending.insert(id);
+    ++pending_count_;
+  }
+
+  std::size_t stream::memory_usage() const
+  {
+    return sizeof(stream) + block_bytes_ + index_->memory_usage() + groups_.size() * group_node_bytes +
+           consumer_count_ * consumer_node_bytes + pending_count_ * pending_node_bytes;
+  }
+} // namespace mini_redis
@@ -0,0 +1,435 @@
+#include "gtest/gtest.h"
+#include "command/dispatcher.hpp"
+#include "storage/aof.hpp"
+#include "storage/store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Append-only file tests: successful write commands are logged (relative TTLs and
+* automatic stream IDs in a form that replays to the same state), replay restores the
+* keyspace, appendfsync always hands out a sequence to wait for, and an incomplete
+* command at the end of the file is cut off. BGREWRITEAOF compacts the file while
+* writes continue, keeps every write made during the rewrite, and swaps the file in
+* with a short pause. Writes are ordered per key: concurrent writers to the same keys
+* replay to the same state, and a write never waits for one on another order stripe.
+* Keys evicted for maxmemory are logged as DEL, so replay does not bring them back.
+*/
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    std::string read_file(const fs::path &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    std::shared_ptr<mini_redis::store> replay_into_new_store(const fs::path &path, std::size_t *commands = nullptr)
+    {
+        auto s = std::make_shared<mini_redis::store>();
+        mini_redis::CommandDispatcher replayer(s, std::make_shared<mini_redis::pubsub_manager>());
+        const auto stats = mini_redis::append_only_file::replay(
+            path.string(), [&](const mini_redis::command_t &cmd) { replayer.execute_command(cmd); });
+        if (commands)
+        {
+            *commands = stats.commands;
+        }
+        return s;
+    }
+
+    void wait_until_durable(mini_redis::append_only_file &aof, std::uint64_t seq)
+    {
+        std::promise<void> done;
+        aof.when_durable(seq, [&] { done.set_value(); });
+        ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    }
+
+    // server cron처럼 rewrite 자식을 거두고 writer가 파일을 바꿀 때까지 기다림
+    void wait_for_rewrite(mini_redis::store &s, mini_redis::append_only_file &aof)
+    {
+        for (int i = 0; i < 2000 && aof.rewrite_in_progress(); ++i)
+        {
+            s.poll_background_save();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        ASSERT_FALSE(aof.rewrite_in_progress());
+    }
+} // namespace
+
+class AofTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() /
+               ("mini_redis_aof_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        fs::create_directories(dir_);
+        path_ = dir_ / "appendonly.aof";
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(dir_, ec);
+    }
+
+    fs::path dir_;
+    fs::path path_;
+};
+
+TEST_F(AofTest, LogsWritesAndReplaysThem) {
+    auto s = std::make_shared<mini_redis::store>();
+    std::string stream_id;
+    {
+        auto aof = std::make_shared<mini_redis::append_only_file>(path_.string(), mini_redis::fsync_policy::everysec);
+        mini_redis::CommandDispatcher dispatcher(s, std::make_shared<mini_redis::pubsub_manager>(), aof);
+        dispatcher.execute_command({"SET", "name", "mini-redis"});
+        dispatcher.execute_command({"INCRBY", "counter", "5"});
+        dispatcher.execute_command({"incr", "counter"});
+        dispatcher.execute_command({"RPUSH", "list", "a", "b", "c"});
+        dispatcher.execute_command({"LPOP", "list"});
+        dispatcher.execute_command({"HSET", "hash", "f1", "v1", "f2", "v2"});
+        dispatcher.execute_command({"SADD", "set", "x", "y"});
+        dispatcher.execute_command({"ZADD", "zset", "1.5", "m1", "2", "m2"});
+        dispatcher.execute_command({"PFADD", "hll", "a", "b", "c"});
+        const std::string added = dispatcher.execute_command({"XADD", "events", "MAXLEN", "~", "100", "*", "type", "click"});
+        stream_id = added.substr(added.find("\r\n") + 2, added.size() - added.find("\r\n") - 4);
+        dispatcher.execute_command({"SETEX", "session", "100", "token"});
+        dispatcher.execute_command({"SET", "temp", "1"});
+        dispatcher.execute_command({"EXPIRE", "temp", "0"});
+        dispatcher.execute_command({"SET", "gone", "1"});
+        dispatcher.execute_command({"DEL", "gone"});
+        // 읽기 명령과 실패한 쓰기는 기록되지 않음
+        dispatcher.execute_command({"GET", "name"});
+        EXPECT_EQ(dispatcher.execute_command({"INCR", "list"})[0], '-');
+        EXPECT_EQ(dispatcher.take_unsynced_write(), 0u);
+    }
+
+    const std::string log = read_file(path_);
+    EXPECT_EQ(log.find("GET"), std::string::npos);
+    EXPECT_EQ(log.find("SETEX"), std::string::npos);
+    EXPECT_NE(log.find("PEXPIREAT"), std::string::npos);
+    EXPECT_NE(log.find(stream_id), std::string::npos);
+
+    std::size_t commands = 0;
+    auto replayed = replay_into_new_store(path_, &commands);
+    // SETEX는 SET + PEXPIREAT 두 명령으로 기록됨
+    EXPECT_EQ(commands, 16u);
+    EXPECT_EQ(replayed->get("name"), "mini-redis");
+    EXPECT_EQ(replayed->get("counter"), "6");
+    EXPECT_EQ(replayed->lrange("list", 0, -1), (std::vector<std::string>{"b", "c"}));
+    EXPECT_EQ(replayed->hget("hash", "f2"), "v2");
+    EXPECT_EQ(replayed->scard("set"), 2u);
+    EXPECT_EQ(replayed->zscore("zset", "m1"), 1.5);
+    EXPECT_EQ(replayed->pfcount({"hll"}), 3u);
+    EXPECT_EQ(replayed->xlen("events"), 1u);
+    EXPECT_EQ(replayed->get("session"), "token");
+    EXPECT_GT(replayed->ttl("session"), 90);
+    EXPECT_LE(replayed->ttl("session"), 100);
+    EXPECT_FALSE(replayed->get("temp").has_value());
+    EXPECT_FALSE(replayed->get("gone").has_value());
+    EXPECT_EQ(replayed->dbsize(), s->dbsize());
+
+    // 기존 파일에 이어 씀
+    {
+        auto aof = std::make_shared<mini_redis::append_only_file>(path_.string(), mini_redis::fsync_policy::no);
+        EXPECT_EQ(aof->size(), log.size());
+        mini_redis::CommandDispatcher dispatcher(s, std::make_shared<mini_redis::pubsub_manager>(), aof);
+        dispatcher.execute_command({"XADD", "events", "*", "type", "view"});
+    }
+    EXPECT_EQ(replay_into_new_store(path_)->xlen("events"), 2u);
+}
+
+TEST_F(AofTest, AlwaysPolicyRepliesAfterTheWriteIsSynced) {
+    auto s = std::make_shared<mini_redis::store>();
+    auto aof = std::make_shared<mini_redis::append_only_file>(path_.string(), mini_redis::fsync_policy::always);
+    mini_redis::CommandDispatcher dispatcher(s, std::make_shared<mini_redis::pubsub_manager>(), aof);
+
+    EXPECT_EQ(dispatcher.execute_command({"SET", "k", "v"}), "+OK\r\n");
+    const auto seq = dispatcher.take_unsynced_write();
+    ASSERT_NE(seq, 0u);
+    EXPECT_EQ(dispatcher.take_unsynced_write(), 0u);
+
+    std::promise<void> synced;
+    aof->when_durable(seq, [&] { synced.set_value(); });
+    ASSERT_EQ(synced.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_NE(read_file(path_).find("$1\r\nk\r\n$1\r\nv\r\n"), std::string::npos);
+
+    // 이미 기록된 sequence는 바로 호출됨
+    bool called = false;
+    aof->when_durable(seq, [&] { called = true; });
+    EXPECT_TRUE(called);
+
+    dispatcher.execute_command({"GET", "k"});
+    EXPECT_EQ(dispatcher.take_unsynced_write(), 0u);
+    EXPECT_NE(dispatcher.execute_command({"INFO", "persistence"}).find("aof_fsync:always"), std::string::npos);
+}
+
+TEST_F(AofTest, ReplayCutsOffAnIncompleteCommand) {
+    const std::string complete = "*3\r\n$3\r\nSET\r\n$1\r\na\r\n$1\r\n1\r\n*3\r\n$3\r\nSET\r\n$1\r\nb\r\n$1\r\n2\r\n";
+    {
+        std::ofstream out(path_, std::ios::binary);
+        out << complete << "*3\r\n$3\r\nSET\r\n$1\r\nc\r\n$";
+    }
+    std::size_t commands = 0;
+    auto s = replay_into_new_store(path_, &commands);
+    EXPECT_EQ(commands, 2u);
+    EXPECT_EQ(s->get("b"), "2");
+    EXPECT_FALSE(s->get("c").has_value());
+    EXPECT_EQ(read_file(path_), complete);
+}
+
+TEST_F(AofTest, ExpireAtCommands) {
+    auto s = std::make_shared<mini_redis::store>();
+    mini_redis::CommandDispatcher dispatcher(s, std::make_shared<mini_redis::pubsub_manager>());
+    const long long now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch()).count();
+    dispatcher.execute_command({"SET", "a", "1"});
+    dispatcher.execute_command({"SET", "b", "1"});
+    EXPECT_EQ(dispatcher.execute_command({"PEXPIREAT", "a", std::to_string(now_ms + 60000)}), ":1\r\n");
+    EXPECT_GT(s->pttl("a"), 50000);
+    EXPECT_EQ(dispatcher.execute_command({"EXPIREAT", "b", std::to_string(now_ms / 1000 - 10)}), ":1\r\n");
+    EXPECT_FALSE(s->get("b").has_value());
+    EXPECT_EQ(dispatcher.execute_command({"PEXPIREAT", "missing", std::to_string(now_ms + 60000)}), ":0\r\n");
+    EXPECT_EQ(dispatcher.execute_command({"EXPIREAT", "a", "soon"}), "-ERR value is not an integer or out of range\r\n");
+}
+
+TEST_F(AofTest, RewriteCompactsTheFileWhileWritesContinue) {
+    mini_redis::store_config config;
+    config.dir = dir_.string();
+    auto s = std::make_shared<mini_redis::store>(config);
+    auto pubsub = std::make_shared<mini_redis::pubsub_manager>();
+    auto aof = std::make_shared<mini_redis::append_only_file>(path_.string(), mini_redis::fsync_policy::always);
+    mini_redis::CommandDispatcher dispatcher(s, pubsub, aof);
+    for (int i = 0; i < 5000; ++i)
+    {
+        dispatcher.execute_command({"INCR", "counter"});
+        dispatcher.execute_command({"HSET", "hash", "f" + std::to_string(i % 20), std::to_string(i)});
+    }
+    dispatcher.execute_command({"RPUSH", "list", "a", "b", "c"});
+    dispatcher.execute_command({"SETEX", "session", "100", "token"});
+    dispatcher.execute_command({"ZADD", "zset", "1.5", "m1", "2", "m2"});
+    dispatcher.execute_command({"SADD", "set", "x", "y"});
+    dispatcher.execute_command({"PFADD", "hll", "a", "b", "c"});
+    dispatcher.execute_command({"XADD", "events", "*", "type", "click"});
+    dispatcher.execute_command({"XGROUP", "CREATE", "events", "g", "0"});
+    wait_until_durable(*aof, dispatcher.take_unsynced_write());
+    const auto before = fs::file_size(path_);
+
+    // rewrite 중에도 쓰기가 계속됨
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> last_seq{0};
+    std::atomic<int> during{0};
+    std::thread writer([&] {
+        mini_redis::CommandDispatcher d(s, pubsub, aof);
+        while (!stop.load())
+        {
+            d.execute_command({"INCR", "during"});
+            d.execute_command({"RPUSH", "tail", std::to_string(during.fetch_add(1))});
+            last_seq = d.take_unsynced_write();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    while (during.load() < 10)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    s->bgrewriteaof(*aof);
+    EXPECT_TRUE(aof->rewrite_in_progress());
+    EXPECT_THROW(s->bgrewriteaof(*aof), std::runtime_error);
+    EXPECT_THROW(s->bgsave(), std::runtime_error);
+    wait_for_rewrite(*s, *aof);
+    const auto at_swap = during.load();
+    while (during.load() < at_swap + 10)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stop = true;
+    writer.join();
+    wait_until_durable(*aof, last_seq.load());
+
+    EXPECT_TRUE(s->persistence().last_aof_rewrite_ok);
+    EXPECT_TRUE(aof->last_rewrite_ok());
+    // 쓰기 명령이 막히는 것은 남은 버퍼를 쓰고 rename하는 동안뿐
+    EXPECT_LT(aof->last_rewrite_pause(), std::chrono::milliseconds(50));
+    EXPECT_LT(aof->base_size(), before / 10);
+    const std::string info = dispatcher.execute_command({"INFO", "persistence"});
+    EXPECT_NE(info.find("aof_rewrite_in_progress:0"), std::string::npos);
+    EXPECT_NE(info.find("aof_last_bgrewrite_status:ok"), std::string::npos);
+
+    std::size_t commands = 0;
+    auto replayed = replay_into_new_store(path_, &commands);
+    EXPECT_LT(commands, 200u);
+    EXPECT_EQ(replayed->get("counter"), "5000");
+    EXPECT_EQ(replayed->get("during"), std::to_string(during.load()));
+    EXPECT_EQ(replayed->lrange("tail", 0, -1), s->lrange("tail", 0, -1));
+    EXPECT_EQ(replayed->hgetall("hash"), s->hgetall("hash"));
+    EXPECT_EQ(replayed->lrange("list", 0, -1), (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_GT(replayed->ttl("session"), 90);
+    EXPECT_EQ(replayed->zscore("zset", "m1"), 1.5);
+    EXPECT_EQ(replayed->scard("set"), 2u);
+    EXPECT_EQ(replayed->pfcount({"hll"}), 3u);
+    EXPECT_EQ(replayed->xlen("events"), 1u);
+    EXPECT_EQ(replayed->dbsize(), s->dbsize());
+
+    // 교체 뒤에는 새 파일에 이어 씀
+    dispatcher.execute_command({"SET", "after", "1"});
+    wait_until_durable(*aof, dispatcher.take_unsynced_write());
+    EXPECT_EQ(replay_into_new_store(path_)->get("after"), "1");
+    std::size_t files = 0;
+    for (const auto &entry : fs::directory_iterator(dir_))
+    {
+        ++files;
+        EXPECT_EQ(entry.path().filename(), "appendonly.aof");
+    }
+    EXPECT_EQ(files, 1u);
+}
+
+TEST_F(AofTest, RewriteIsDueOnceTheFileHasGrown) {
+    mini_redis::store_config config;
+    config.dir = dir_.string();
+    auto s = std::make_shared<mini_redis::store>(config);
+    auto aof = std::make_shared<mini_redis::append_only_file>(path_.string(), mini_redis::fsync_policy::always);
+    mini_redis::CommandDispatcher dispatcher(s, std::make_shared<mini_redis::pubsub_manager>(), aof);
+    EXPECT_FALSE(aof->rewrite_due(100, 1024));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        dispatcher.execute_command({"SET", "key", std::to_string(i)});
+    }
+    wait_until_durable(*aof, dispatcher.take_unsynced_write());
+    EXPECT_TRUE(aof->rewrite_due(100, 1024));
+    EXPECT_FALSE(aof->rewrite_due(100, 1 << 20));
+    EXPECT_FALSE(aof->rewrite_due(0, 1024));
+
+    EXPECT_EQ(dispatcher.execute_command({"BGREWRITEAOF"}), "+Background append only file rewriting started\r\n");
+    wait_for_rewrite(*s, *aof);
+    EXPECT_EQ(aof->base_size(), aof->size());
+    EXPECT_FALSE(aof->rewrite_due(100, 0));
+
+    // 기준 크기의 두 배가 되면 다시 due
+    const auto base = aof->base_size();
+    for (int i = 0; aof->size() < base * 2; ++i)
+    {
+        dispatcher.execute_command({"SET", "key", std::to_string(i)});
+        wait_until_durable(*aof, dispatcher.take_unsynced_write());
+    }
+    EXPECT_TRUE(aof->rewrite_due(100, 0));
+    EXPECT_FALSE(aof->rewrite_due(200, 0));
+
+    mini_redis::CommandDispatcher without_aof(s, std::make_shared<mini_redis::pubsub_manager>());
+    EXPECT_EQ(without_aof.execute_command({"BGREWRITEAOF"}),
+              "-ERR Append only file is disabled (persistence.appendonly)\r\n");
+}
+
+TEST_F(AofTest, ConcurrentWritesToTheSameKeysReplayInApplyOrder) {
+    auto s = std::make_shared<mini_redis::store>();
+    auto pubsub = std::make_shared<mini_redis::pubsub_manager>();
+    {
+        auto aof = std::make_shared<mini_redis::append_only_file>(path_.string(), mini_redis::fsync_policy::no);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t)
+        {
+            writers.emplace_back([&, t] {
+                mini_redis::CommandDispatcher d(s, pubsub, aof);
+                for (int i = 0; i < 2000; ++i)
+                {
+                    // 같은 키들을 여러 스레드가 고치므로 기록 순서가 실행 순서와 다르면 리스트 순서가 달라짐
+                    const std::string id = std::to_string(i % 8);
+                    d.execute_command({"RPUSH", "list:" + id, std::to_string(t) + ":" + std::to_string(i)});
+                    d.execute_command({"SET", "last:" + id, std::to_string(t)});
+                    d.execute_command({"MSET", "a:" + id, std::to_string(i), "b:" + id, std::to_string(t)});
+                }
+            });
+        }
+        for (auto &w : writers)
+        {
+            w.join();
+        }
+    }
+    auto replayed = replay_into_new_store(path_);
+    EXPECT_EQ(replayed->dbsize(), s->dbsize());
+    for (int k = 0; k < 8; ++k)
+    {
+        const std::string id = std::to_string(k);
+        EXPECT_EQ(replayed->lrange("list:" + id, 0, -1), s->lrange("list:" + id, 0, -1));
+        EXPECT_EQ(replayed->get("last:" + id), s->get("last:" + id));
+        EXPECT_EQ(replayed->get("a:" + id), s->get("a:" + id));
+        EXPECT_EQ(replayed->get("b:" + id), s->get("b:" + id));
+    }
+}
+
+TEST_F(AofTest, WritesOnOtherOrderStripesDoNotWait) {
+    auto s = std::make_shared<mini_redis::store>();
+    auto pubsub = std::make_shared<mini_redis::pubsub_manager>();
+    auto aof = std::make_shared<mini_redis::append_only_file>(path_.string(), mini_redis::fsync_policy::no);
+    std::string other = "other";
+    while (mini_redis::append_only_file::order_stripe(other) == mini_redis::append_only_file::order_stripe("busy"))
+    {
+        other += "+";
+    }
+
+    // 느린 쓰기가 "busy"의 stripe를 잡고 있는 동안
+    auto busy = aof->lock_order({"SET", "busy", "1"});
+    auto other_write = std::async(std::launch::async, [&] {
+        mini_redis::CommandDispatcher d(s, pubsub, aof);
+        return d.execute_command({"SET", other, "1"});
+    });
+    EXPECT_EQ(other_write.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    auto same_key = std::async(std::launch::async, [&] {
+        mini_redis::CommandDispatcher d(s, pubsub, aof);
+        return d.execute_command({"MSET", other, "2", "busy", "2"});
+    });
+    EXPECT_EQ(same_key.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+    busy = mini_redis::append_only_file::order_guard();
+    EXPECT_EQ(same_key.get(), "+OK\r\n");
+    EXPECT_EQ(s->get("busy"), "2");
+}
+
+TEST_F(AofTest, EvictionsAreLoggedAsDel) {
+    mini_redis::store_config config;
+    config.maxmemory = 256 * 1024;
+    config.maxmemory_policy = mini_redis::eviction_policy::allkeys_lru;
+    auto s = std::make_shared<mini_redis::store>(config);
+    {
+        auto aof = std::make_shared<mini_redis::append_only_file>(path_.string(), mini_redis::fsync_policy::no);
+        s->log_evictions_to(aof);
+        mini_redis::CommandDispatcher dispatcher(s, std::make_shared<mini_redis::pubsub_manager>(), aof);
+        const std::string value(200, 'v');
+        for (int i = 0; i < 5000; ++i)
+        {
+            dispatcher.execute_command({"SET", "key:" + std::to_string(i), value});
+            // 축출된 키를 다시 만들면 처음부터 세므로, DEL이 빠지면 다시 실행한 값이 달라짐
+            dispatcher.execute_command({"INCR", "counter:" + std::to_string(i % 50)});
+        }
+        s->log_evictions_to(nullptr);
+    }
+    ASSERT_GT(s->evicted_keys(), 0u);
+
+    // 기록된 DEL 덕분에 한도를 적용하지 않고 다시 실행해도 같은 키 공간이 됨
+    auto replayed = std::make_shared<mini_redis::store>(config);
+    replayed->set_maxmemory_enforced(false);
+    mini_redis::CommandDispatcher replayer(replayed, std::make_shared<mini_redis::pubsub_manager>());
+    mini_redis::append_only_file::replay(path_.string(),
+                                         [&](const mini_redis::command_t &cmd) { replayer.execute_command(cmd); });
+    replayed->set_maxmemory_enforced(true);
+    EXPECT_EQ(replayed->evicted_keys(), 0u);
+    auto live_keys = s->keys("*");
+    auto replayed_keys = replayed->keys("*");
+    std::sort(live_keys.begin(), live_keys.end());
+    std::sort(replayed_keys.begin(), replayed_keys.end());
+    EXPECT_EQ(replayed_keys, live_keys);
+    for (int i = 0; i < 50; ++i)
+    {
+        const std::string key = "counter:" + std::to_string(i);
+        EXPECT_EQ(replayed->get(key), s->get(key)) << key;
+    }
+    EXPECT_EQ(replayed->evict_to_maxmemory(), 0u);
+}
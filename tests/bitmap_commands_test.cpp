@@ -0,0 +1,244 @@
+#include "gtest/gtest.h"
+#include "storage/store.hpp"
+#include "storage/bitops.hpp"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+* Bitmap commands tests: SETBIT/GETBIT/BITCOUNT/BITPOS/BITOP/BITFIELD on the store (including BITOP
+* with the destination among its sources), and every bitops kernel the CPU supports compared against
+* a bit-by-bit reference on unaligned buffers of many sizes.
+*/
+
+namespace bitops = mini_redis::bitops;
+using mini_redis::bitfield_op;
+
+namespace {
+    std::uint64_t naive_popcount(const std::string &s) {
+        std::uint64_t n = 0;
+        for (unsigned char c : s) {
+            for (int b = 0; b < 8; ++b) {
+                n += (c >> b) & 1;
+            }
+        }
+        return n;
+    }
+
+    std::string random_bytes(std::mt19937_64 &rng, std::size_t n, int density) {
+        // density: 바이트마다 0x00 / 0xFF / 무작위 중 하나가 나오는 비율을 바꿔 find_bit의 건너뛰기를 검사
+        std::string s(n, '\0');
+        for (auto &c : s) {
+            const auto r = rng() % 4;
+            c = static_cast<char>(r < 2 ? (density ? 0xFF : 0x00) : rng());
+        }
+        return s;
+    }
+
+    bitfield_op field(bitfield_op::kind type, bool is_signed, unsigned bits, std::uint64_t offset,
+                      std::int64_t value = 0, bitfield_op::overflow on_overflow = bitfield_op::overflow::wrap) {
+        bitfield_op op;
+        op.type = type;
+        op.is_signed = is_signed;
+        op.bits = bits;
+        op.offset = offset;
+        op.value = value;
+        op.on_overflow = on_overflow;
+        return op;
+    }
+
+    // 지원하는 모든 kernel로 fn을 실행하고 원래 kernel로 되돌림
+    template <typename Fn>
+    void for_each_kernel(Fn &&fn) {
+        const auto original = bitops::active_kernel();
+        for (auto k : {bitops::kernel::scalar, bitops::kernel::popcnt, bitops::kernel::avx2}) {
+            if (static_cast<int>(k) <= static_cast<int>(bitops::best_kernel())) {
+                bitops::use_kernel(k);
+                fn(k);
+            }
+        }
+        bitops::use_kernel(original);
+    }
+}
+
+class BitmapCommandsTest : public ::testing::Test {
+protected:
+    mini_redis::store store_instance;
+};
+
+TEST_F(BitmapCommandsTest, SetbitAndGetbit) {
+    EXPECT_FALSE(store_instance.setbit("b", 7, true));
+    EXPECT_EQ(store_instance.get("b"), std::string("\x01", 1));
+    EXPECT_TRUE(store_instance.setbit("b", 7, false));
+    EXPECT_FALSE(store_instance.setbit("b", 1, true));
+    EXPECT_EQ(store_instance.get("b"), std::string("@"));
+    EXPECT_TRUE(store_instance.getbit("b", 1));
+    EXPECT_FALSE(store_instance.getbit("b", 0));
+    // 문자열 밖과 없는 키는 0
+    EXPECT_FALSE(store_instance.getbit("b", 100000));
+    EXPECT_FALSE(store_instance.getbit("missing", 3));
+
+    // 먼 offset은 0으로 채우며 늘림 (1MB 넘게 늘리는 중간 단계도 내용 유지)
+    store_instance.setbit("big", 8 * 3000000 - 1, true);
+    store_instance.setbit("big", 5, true);
+    EXPECT_EQ(store_instance.get("big")->size(), 3000000u);
+    EXPECT_EQ(store_instance.bitcount("big"), 2u);
+
+    // 정수 인코딩 값도 문자열 bytes로 다룸 ("1" = 0x31)
+    store_instance.set("n", "1");
+    EXPECT_TRUE(store_instance.getbit("n", 2));
+    EXPECT_FALSE(store_instance.setbit("n", 6, true));
+    EXPECT_EQ(store_instance.get("n"), std::string("3"));
+
+    store_instance.lpush("list", {"a"});
+    EXPECT_THROW(store_instance.setbit("list", 0, true), std::runtime_error);
+    EXPECT_THROW(store_instance.getbit("list", 0), std::runtime_error);
+    EXPECT_THROW(store_instance.setbit("b", bitops::max_bit_offset + 1, true), std::runtime_error);
+}
+
+TEST_F(BitmapCommandsTest, BitcountAndBitposRanges) {
+    store_instance.set("s", "foobar");
+    EXPECT_EQ(store_instance.bitcount("s"), 26u);
+    EXPECT_EQ(store_instance.bitcount("s", 0, 0), 4u);
+    EXPECT_EQ(store_instance.bitcount("s", 1, 1), 6u);
+    EXPECT_EQ(store_instance.bitcount("s", 1, 1, true), 1u);
+    EXPECT_EQ(store_instance.bitcount("s", 5, 30, true), 17u);
+    EXPECT_EQ(store_instance.bitcount("s", -2, -1), 7u);
+    EXPECT_EQ(store_instance.bitcount("s", 3, 1), 0u);
+    EXPECT_EQ(store_instance.bitcount("missing"), 0u);
+
+    store_instance.set("p", std::string("\xff\xf0\x00", 3));
+    EXPECT_EQ(store_instance.bitpos("p", false), 12);
+    EXPECT_EQ(store_instance.bitpos("p", true, 2), -1);
+    EXPECT_EQ(store_instance.bitpos("p", true, 1), 8);
+    EXPECT_EQ(store_instance.bitpos("p", true, 7, 15, true), 7);
+    EXPECT_EQ(store_instance.bitpos("p", false, 2, 12, true), 12);
+    EXPECT_EQ(store_instance.bitpos("p", true, -1), -1);
+
+    // 0을 찾는데 끝을 정하지 않으면 문자열 바로 뒤, 끝을 정했으면 -1
+    store_instance.set("ones", std::string(20, '\xff'));
+    EXPECT_EQ(store_instance.bitpos("ones", false), 160);
+    EXPECT_EQ(store_instance.bitpos("ones", false, 0, -1), -1);
+    EXPECT_EQ(store_instance.bitpos("missing", false), 0);
+    EXPECT_EQ(store_instance.bitpos("missing", true), -1);
+}
+
+TEST_F(BitmapCommandsTest, BitopWritesIntoDestination) {
+    store_instance.set("a", "abcdefghijklmnopqrstuvwxyz0123456789");
+    store_instance.set("b", "ZYX");
+    const std::string a = *store_instance.get("a"), b = *store_instance.get("b");
+
+    EXPECT_EQ(store_instance.bitop(bitops::operation::bit_and, "and", {"a", "b"}), a.size());
+    std::string expected(a.size(), '\0');
+    for (std::size_t i = 0; i < b.size(); ++i) {
+        expected[i] = static_cast<char>(a[i] & b[i]);
+    }
+    EXPECT_EQ(store_instance.get("and"), expected);
+
+    store_instance.bitop(bitops::operation::bit_xor, "xor", {"b", "a", "missing"});
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        expected[i] = static_cast<char>(a[i] ^ (i < b.size() ? b[i] : 0));
+    }
+    EXPECT_EQ(store_instance.get("xor"), expected);
+
+    // dest가 원본이면 그 버퍼에서 바로 계산
+    store_instance.bitop(bitops::operation::bit_or, "b", {"a", "b"});
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        expected[i] = static_cast<char>(a[i] | (i < b.size() ? b[i] : 0));
+    }
+    EXPECT_EQ(store_instance.get("b"), expected);
+    store_instance.bitop(bitops::operation::bit_not, "b", {"b"});
+    for (auto &c : expected) {
+        c = static_cast<char>(~c);
+    }
+    EXPECT_EQ(store_instance.get("b"), expected);
+
+    // 같은 dest가 여러 번 나오면 원래 값으로 계산 (x ^ x = 0)
+    store_instance.bitop(bitops::operation::bit_xor, "b", {"b", "a", "b"});
+    EXPECT_EQ(store_instance.get("b"), a);
+
+    // 결과가 비면 dest를 지우고, 덮어쓰면 TTL도 사라짐
+    store_instance.set("gone", "x");
+    EXPECT_EQ(store_instance.bitop(bitops::operation::bit_or, "gone", {"missing"}), 0u);
+    EXPECT_FALSE(store_instance.exists("gone"));
+    store_instance.setex("ttl", 100, "x");
+    store_instance.bitop(bitops::operation::bit_not, "ttl", {"a"});
+    EXPECT_EQ(store_instance.ttl("ttl"), -1);
+
+    store_instance.lpush("list", {"a"});
+    EXPECT_THROW(store_instance.bitop(bitops::operation::bit_and, "fresh", {"a", "list"}), std::runtime_error);
+    EXPECT_FALSE(store_instance.exists("fresh"));
+    EXPECT_THROW(store_instance.bitop(bitops::operation::bit_not, "d", {"a", "b"}), std::runtime_error);
+}
+
+TEST_F(BitmapCommandsTest, BitfieldOverflowModes) {
+    using kind = bitfield_op::kind;
+    using overflow = bitfield_op::overflow;
+
+    // GET만 있으면 키를 만들지 않음
+    auto r = store_instance.bitfield("f", {field(kind::get, false, 8, 0)});
+    EXPECT_EQ(r, (std::vector<std::optional<std::int64_t>>{0}));
+    EXPECT_FALSE(store_instance.exists("f"));
+
+    r = store_instance.bitfield("f", {field(kind::set, false, 8, 0, 200), field(kind::get, true, 8, 0),
+                                      field(kind::incrby, false, 8, 0, 100),
+                                      field(kind::incrby, false, 8, 0, 100, overflow::sat),
+                                      field(kind::incrby, false, 8, 0, 1, overflow::fail),
+                                      field(kind::incrby, false, 8, 0, -300, overflow::sat)});
+    EXPECT_EQ(r, (std::vector<std::optional<std::int64_t>>{0, -56, 44, 144, 145, 0}));
+
+    r = store_instance.bitfield("f", {field(kind::set, true, 5, 100, 15), field(kind::incrby, true, 5, 100, 1),
+                                      field(kind::incrby, true, 5, 100, -10, overflow::fail),
+                                      field(kind::set, true, 5, 100, -17, overflow::sat),
+                                      field(kind::set, true, 64, 200, std::numeric_limits<std::int64_t>::min()),
+                                      field(kind::incrby, true, 64, 200, -1, overflow::sat)});
+    EXPECT_EQ(r, (std::vector<std::optional<std::int64_t>>{0, -16, std::nullopt, -16,
+                                                            0, std::numeric_limits<std::int64_t>::min()}));
+    // 필드 전체가 들어가도록 한 번에 늘림 (200 + 64 bits = 33 bytes)
+    EXPECT_EQ(store_instance.get("f")->size(), 33u);
+
+    // 같은 bit를 BITFIELD와 GETBIT가 같은 순서로 봄
+    store_instance.bitfield("g", {field(kind::set, false, 4, 4, 0b1010)});
+    EXPECT_TRUE(store_instance.getbit("g", 4));
+    EXPECT_FALSE(store_instance.getbit("g", 5));
+    EXPECT_TRUE(store_instance.getbit("g", 6));
+}
+
+TEST(BitopsTest, KernelsMatchReference) {
+    std::mt19937_64 rng(11);
+    for_each_kernel([&](bitops::kernel k) {
+        for (std::size_t n : {0, 1, 7, 31, 32, 33, 63, 64, 65, 511, 512, 513, 1000, 2048, 4133}) {
+            for (std::size_t shift : {0, 1, 5}) {
+                const std::string a = random_bytes(rng, n + shift, n % 2), b = random_bytes(rng, n + shift, 1);
+                const auto *pa = reinterpret_cast<const unsigned char *>(a.data()) + shift;
+                const auto *pb = reinterpret_cast<const unsigned char *>(b.data()) + shift;
+                ASSERT_EQ(bitops::popcount(pa, n), naive_popcount(a.substr(shift))) << bitops::kernel_name(k) << " " << n;
+
+                for (auto op : {bitops::operation::bit_and, bitops::operation::bit_or, bitops::operation::bit_xor,
+                                bitops::operation::bit_not}) {
+                    std::string dst(a.substr(shift));
+                    bitops::combine(op, reinterpret_cast<unsigned char *>(&dst[0]), pb, n);
+                    for (std::size_t i = 0; i < n; ++i) {
+                        const unsigned char x = pa[i], y = pb[i];
+                        const unsigned char want = op == bitops::operation::bit_and ? x & y
+                                                   : op == bitops::operation::bit_or ? x | y
+                                                   : op == bitops::operation::bit_xor ? x ^ y
+                                                                                      : static_cast<unsigned char>(~y);
+                        ASSERT_EQ(static_cast<unsigned char>(dst[i]), want) << bitops::kernel_name(k) << " " << n;
+                    }
+                }
+
+                for (bool bit : {false, true}) {
+                    std::int64_t want = -1;
+                    for (std::size_t i = 0; i < n * 8 && want < 0; ++i) {
+                        if (bitops::get_bit(pa, n, i) == bit) {
+                            want = static_cast<std::int64_t>(i);
+                        }
+                    }
+                    ASSERT_EQ(bitops::find_bit(pa, n, bit), want) << n;
+                }
+            }
+        }
+    });
+}
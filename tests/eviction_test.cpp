@@ -0,0 +1,159 @@
+#include "gtest/gtest.h"
+#include "storage/store.hpp"
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+/*
+* maxmemory and eviction tests for the mini-redis store.
+* These tests cover the eviction policies (noeviction, allkeys-lru,
+* allkeys-lfu, volatile-ttl) and the eviction candidate pool.
+*/
+
+namespace
+{
+    mini_redis::store_config limited(mini_redis::eviction_policy policy, std::size_t maxmemory = 256 * 1024)
+    {
+        mini_redis::store_config config;
+        config.shards = 4;
+        config.maxmemory = maxmemory;
+        config.maxmemory_policy = policy;
+        return config;
+    }
+
+    // 값이 std::string의 인라인 크기를 넘도록 하여 키마다 힙 메모리를 사용
+    const std::string value(100, 'v');
+} // namespace
+
+TEST(EvictionTest, ParsePolicyNames) {
+    EXPECT_EQ(mini_redis::parse_eviction_policy("allkeys-lru"), mini_redis::eviction_policy::allkeys_lru);
+    EXPECT_EQ(mini_redis::parse_eviction_policy("ALLKEYS_LFU"), mini_redis::eviction_policy::allkeys_lfu);
+    EXPECT_EQ(mini_redis::parse_eviction_policy("volatile-ttl"), mini_redis::eviction_policy::volatile_ttl);
+    EXPECT_EQ(mini_redis::parse_eviction_policy("noeviction"), mini_redis::eviction_policy::noeviction);
+    EXPECT_FALSE(mini_redis::parse_eviction_policy("volatile-random").has_value());
+    EXPECT_STREQ(mini_redis::eviction_policy_name(mini_redis::eviction_policy::allkeys_lru), "allkeys-lru");
+}
+
+TEST(EvictionTest, PoolKeepsBestCandidates) {
+    mini_redis::eviction_pool pool;
+    for (std::uint64_t score = 0; score < 40; ++score) {
+        pool.offer(score, 0, "key" + std::to_string(score));
+    }
+    pool.offer(39, 0, "key39"); // 중복은 무시
+
+    mini_redis::eviction_pool::candidate c;
+    for (std::uint64_t expected = 39; expected >= 40 - mini_redis::eviction_pool::capacity; --expected) {
+        ASSERT_TRUE(pool.pop_best(c));
+        EXPECT_EQ(c.score, expected);
+        EXPECT_EQ(c.key, "key" + std::to_string(expected));
+    }
+    EXPECT_TRUE(pool.empty());
+    EXPECT_FALSE(pool.pop_best(c));
+}
+
+TEST(EvictionTest, NoEvictionRejectsWrites) {
+    mini_redis::store s(limited(mini_redis::eviction_policy::noeviction));
+    std::size_t written = 0;
+    EXPECT_THROW({
+        for (;; ++written) {
+            s.set("key:" + std::to_string(written), value);
+        }
+    }, std::runtime_error);
+    EXPECT_GT(written, 0u);
+
+    // 기존 키는 그대로 남아 있고, 읽기와 삭제는 계속 가능
+    EXPECT_EQ(s.dbsize(), written);
+    EXPECT_EQ(s.get("key:0"), value);
+    EXPECT_EQ(s.evicted_keys(), 0u);
+    for (std::size_t i = 0; i < written / 2; ++i) {
+        s.del("key:" + std::to_string(i));
+    }
+    EXPECT_NO_THROW(s.set("after-delete", value));
+}
+
+TEST(EvictionTest, AllKeysLruKeepsRecentlyUsedKeys) {
+    mini_redis::store s(limited(mini_redis::eviction_policy::allkeys_lru));
+    int loaded = 0;
+    while (s.dataset_memory() < s.maxmemory() - 4096) {
+        s.set("old:" + std::to_string(loaded++), value);
+    }
+    // LRU clock은 초 단위이므로 접근 시각이 구분되도록 기다린 뒤 앞쪽 100개만 읽음
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(s.get("old:" + std::to_string(i)).has_value());
+    }
+    for (int i = 0; i < loaded / 2; ++i) {
+        s.set("new:" + std::to_string(i), value);
+    }
+
+    EXPECT_GT(s.evicted_keys(), 0u);
+    // 한도 확인은 쓰기 전에 하므로 마지막 쓰기 하나만큼은 넘을 수 있음
+    EXPECT_LE(s.dataset_memory(), s.maxmemory() + 1024);
+    int recent_alive = 0;
+    for (int i = 0; i < 100; ++i) {
+        recent_alive += s.get("old:" + std::to_string(i)).has_value();
+    }
+    EXPECT_GE(recent_alive, 95);
+}
+
+TEST(EvictionTest, AllKeysLfuKeepsFrequentlyUsedKeys) {
+    mini_redis::store s(limited(mini_redis::eviction_policy::allkeys_lfu));
+    for (int i = 0; i < 100; ++i) {
+        s.set("hot:" + std::to_string(i), value);
+        for (int j = 0; j < 50; ++j) {
+            s.get("hot:" + std::to_string(i));
+        }
+    }
+    for (int i = 0; i < 5000; ++i) {
+        s.set("cold:" + std::to_string(i), value);
+    }
+
+    EXPECT_GT(s.evicted_keys(), 0u);
+    int hot_alive = 0;
+    for (int i = 0; i < 100; ++i) {
+        hot_alive += s.get("hot:" + std::to_string(i)).has_value();
+    }
+    EXPECT_GE(hot_alive, 95);
+}
+
+TEST(EvictionTest, VolatileTtlEvictsOnlyKeysWithTtl) {
+    mini_redis::store s(limited(mini_redis::eviction_policy::volatile_ttl));
+    for (int i = 0; i < 200; ++i) {
+        s.set("persistent:" + std::to_string(i), value);
+    }
+    // 뒤에 쓴 키일수록 TTL이 길어서, 먼저 쓴 키부터 축출되어야 함
+    for (int i = 0; i < 3000; ++i) {
+        s.psetex("volatile:" + std::to_string(i), 1000000 + i, value);
+    }
+
+    EXPECT_GT(s.evicted_keys(), 0u);
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_TRUE(s.get("persistent:" + std::to_string(i)).has_value());
+    }
+    EXPECT_FALSE(s.get("volatile:0").has_value());
+    EXPECT_TRUE(s.get("volatile:2999").has_value());
+
+    // TTL이 있는 키가 모두 없어지면 더는 축출할 수 없으므로 쓰기를 거부
+    for (int i = 0; i < 3000; ++i) {
+        s.del("volatile:" + std::to_string(i));
+    }
+    EXPECT_THROW({
+        for (int i = 0;; ++i) {
+            s.set("more:" + std::to_string(i), value);
+        }
+    }, std::runtime_error);
+}
+
+TEST(EvictionTest, DatasetStaysWithinLimitWithInlineValues) {
+    // 키와 값이 모두 슬롯에 인라인으로 저장되어 삭제해도 해제되는 힙 메모리가 없는 경우.
+    // 축출된 슬롯은 재사용되므로 한도를 지키면서도 대량 축출이 일어나지 않아야 함
+    mini_redis::store s(limited(mini_redis::eviction_policy::allkeys_lru, 1024 * 1024));
+    for (int i = 0; i < 100000; ++i) {
+        s.set("k" + std::to_string(i), "v");
+    }
+    EXPECT_LE(s.dataset_memory(), s.maxmemory() + 1024);
+    EXPECT_LE(s.memory_usage(), s.maxmemory() * 2);
+    EXPECT_EQ(s.dbsize(), 100000u - s.evicted_keys());
+    EXPECT_GT(s.dbsize(), 5000u);
+}
@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+#include "storage/expiry_index.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+/*
+* expiry_index (계층형 타이밍 휠) 단위 테스트.
+* 시각을 직접 넘겨서 ms 단위 정확도, 상위 단에서의 cascade, 휠 범위를 넘는 만료 시각을 검증합니다.
+*/
+
+using mini_redis::expiry_index;
+
+namespace {
+    std::vector<expiry_index::entry> drain(expiry_index &index) {
+        std::vector<expiry_index::entry> out;
+        while (index.take_due(7, out) > 0) {}
+        return out;
+    }
+}
+
+TEST(ExpiryIndexTest, FiresAtExactMillisecond) {
+    expiry_index index(1000);
+    index.insert(1, 1005);
+    index.insert(2, 1070);   // 0단 범위(64ms) 밖 -> 1단
+    index.insert(3, 1000);   // 이미 지난 시각은 바로 due
+
+    index.advance(1000);
+    auto due = drain(index);
+    ASSERT_EQ(due.size(), 1u);
+    EXPECT_EQ(due[0].hash, 3u);
+
+    index.advance(1004);
+    EXPECT_FALSE(index.has_due());
+    index.advance(1005);
+    due = drain(index);
+    ASSERT_EQ(due.size(), 1u);
+    EXPECT_EQ(due[0].hash, 1u);
+
+    index.advance(1069);
+    EXPECT_FALSE(index.has_due());
+    index.advance(1070);
+    due = drain(index);
+    ASSERT_EQ(due.size(), 1u);
+    EXPECT_EQ(due[0].hash, 2u);
+    EXPECT_EQ(index.size(), 0u);
+}
+
+TEST(ExpiryIndexTest, MatchesSortedDeadlinesAcrossLevels) {
+    const std::int64_t start = 123456;
+    expiry_index index(start);
+    std::mt19937_64 rng(42);
+    std::vector<std::int64_t> deadlines;
+    for (std::uint64_t i = 0; i < 20000; ++i) {
+        // 1ms ~ 약 3일: 0단부터 4단까지 고르게 사용
+        const std::int64_t ttl = std::int64_t(1) << (rng() % 28);
+        const std::int64_t deadline = start + 1 + static_cast<std::int64_t>(rng() % ttl);
+        deadlines.push_back(deadline);
+        index.insert(static_cast<std::uint64_t>(deadline), deadline);
+    }
+    std::sort(deadlines.begin(), deadlines.end());
+
+    // 불규칙한 간격으로 시간을 진행하며, 매번 정확히 만료 시각이 지난 항목만 나와야 함
+    std::size_t next = 0;
+    std::int64_t now = start;
+    while (next < deadlines.size()) {
+        now += 1 + static_cast<std::int64_t>(rng() % 5000000);
+        index.advance(now);
+        auto due = drain(index);
+        std::vector<std::int64_t> fired;
+        for (const auto &e : due) {
+            EXPECT_EQ(static_cast<std::int64_t>(e.hash), e.deadline);
+            fired.push_back(e.deadline);
+        }
+        std::sort(fired.begin(), fired.end());
+        const auto end = std::upper_bound(deadlines.begin(), deadlines.end(), now) - deadlines.begin();
+        ASSERT_EQ(fired.size(), static_cast<std::size_t>(end) - next) << "now=" << now;
+        EXPECT_TRUE(std::equal(fired.begin(), fired.end(), deadlines.begin() + next));
+        next = static_cast<std::size_t>(end);
+    }
+    EXPECT_EQ(index.size(), 0u);
+}
+
+TEST(ExpiryIndexTest, DeadlineBeyondWheelRange) {
+    expiry_index index(0);
+    const std::int64_t range = std::int64_t(1) << (expiry_index::wheel_bits * expiry_index::levels);
+    index.insert(9, 3 * range + 17);
+
+    index.advance(3 * range + 16);
+    EXPECT_FALSE(index.has_due());
+    index.advance(3 * range + 17);
+    auto due = drain(index);
+    ASSERT_EQ(due.size(), 1u);
+    EXPECT_EQ(due[0].hash, 9u);
+}
+
+TEST(ExpiryIndexTest, SparseDeadlinesAcrossLargeClockJumps) {
+    // 0단이 빈 동안에는 상위 단의 다음 사용 중인 칸으로 건너뛰므로, 수년을 진행해도 빠르게 끝나야 하고
+    // 그사이 넣은 항목도 정확한 시각에 나와야 함
+    const std::int64_t range = std::int64_t(1) << (expiry_index::wheel_bits * expiry_index::levels);
+    const std::int64_t start = 987654321;
+    expiry_index index(start);
+    std::mt19937_64 rng(7);
+    std::vector<std::int64_t> deadlines;
+    auto add = [&](std::int64_t now) {
+        const std::int64_t deadline = now + 1 + static_cast<std::int64_t>(rng() % (std::int64_t(1) << (rng() % 38)));
+        deadlines.push_back(deadline);
+        index.insert(static_cast<std::uint64_t>(deadline), deadline);
+    };
+    for (int i = 0; i < 300; ++i) {
+        add(start);
+    }
+
+    std::int64_t now = start;
+    std::size_t fired_total = 0;
+    for (int step = 0; step < 2000 && now < start + 3 * range; ++step) {
+        now += 1 + static_cast<std::int64_t>(rng() % (range / 512));
+        index.advance(now);
+        for (const auto &e : drain(index)) {
+            ASSERT_EQ(static_cast<std::int64_t>(e.hash), e.deadline);
+            ASSERT_LE(e.deadline, now);
+            ++fired_total;
+        }
+        if (step % 4 == 0) {
+            add(now);
+        }
+    }
+    // 아직 나오지 않은 항목은 모두 미래의 것이어야 함
+    const auto remaining = std::count_if(deadlines.begin(), deadlines.end(), [&](std::int64_t d) { return d > now; });
+    EXPECT_EQ(fired_total + static_cast<std::size_t>(remaining), deadlines.size());
+    EXPECT_EQ(index.size(), static_cast<std::size_t>(remaining));
+}
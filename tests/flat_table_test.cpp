@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+#include "storage/flat_table.hpp"
+#include <string>
+#include <unordered_map>
+#include <random>
+
+/*
+* flat_table (store의 키 공간 해시 테이블) 단위 테스트.
+* 삽입/조회/삭제, 재해시, tombstone 재사용, 인라인/힙 키 처리를 검증합니다.
+*/
+
+using mini_redis::compact_key;
+using mini_redis::flat_table;
+
+namespace {
+    mini_redis::value_entry *insert(flat_table &table, const std::string &key, const std::string &value) {
+        auto *entry = table.try_emplace(key, flat_table::hash(key)).first;
+        entry->value = value;
+        return entry;
+    }
+
+    const mini_redis::RedisString *lookup(const flat_table &table, const std::string &key) {
+        const auto *entry = table.find(key, flat_table::hash(key));
+        return entry ? std::get_if<mini_redis::RedisString>(&entry->value) : nullptr;
+    }
+}
+
+TEST(FlatTableTest, CompactKeyInlineAndHeap) {
+    compact_key short_key("user:1");
+    EXPECT_TRUE(short_key.is_inline());
+    EXPECT_EQ(short_key.view(), "user:1");
+
+    std::string exact(compact_key::inline_capacity, 'a');
+    compact_key exact_key(exact);
+    EXPECT_TRUE(exact_key.is_inline());
+    EXPECT_EQ(exact_key.view(), exact);
+
+    std::string long_str(100, 'b');
+    compact_key long_key(long_str);
+    EXPECT_FALSE(long_key.is_inline());
+    EXPECT_EQ(long_key.heap_bytes(), 100u);
+
+    compact_key moved(std::move(long_key));
+    EXPECT_EQ(moved.view(), long_str);
+    compact_key copied(moved);
+    EXPECT_EQ(copied.view(), long_str);
+}
+
+TEST(FlatTableTest, InsertFindErase) {
+    flat_table table;
+    EXPECT_EQ(lookup(table, "missing"), nullptr);
+
+    auto *entry = insert(table, "key1", "value1");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(table.size(), 1u);
+    ASSERT_NE(lookup(table, "key1"), nullptr);
+    EXPECT_EQ(*lookup(table, "key1"), "value1");
+
+    // 같은 키를 다시 넣으면 기존 엔트리를 반환
+    auto result = table.try_emplace("key1", flat_table::hash("key1"));
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(table.size(), 1u);
+
+    EXPECT_TRUE(table.erase("key1", flat_table::hash("key1")));
+    EXPECT_FALSE(table.erase("key1", flat_table::hash("key1")));
+    EXPECT_EQ(lookup(table, "key1"), nullptr);
+    EXPECT_TRUE(table.empty());
+}
+
+TEST(FlatTableTest, GrowsAndMatchesReferenceMap) {
+    // 무작위 삽입/삭제를 std::unordered_map과 비교하여 재해시와 tombstone 처리를 검증
+    flat_table table;
+    std::unordered_map<std::string, std::string> reference;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pick(0, 20000);
+
+    for (int i = 0; i < 200000; ++i) {
+        int n = pick(rng);
+        // 일부 키는 인라인 한도(23 bytes)를 넘도록 길게 생성
+        std::string key = (n % 3 == 0) ? "a-rather-long-key-prefix:" + std::to_string(n) : "k:" + std::to_string(n);
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(table.erase(key, flat_table::hash(key)), reference.erase(key) == 1);
+        } else {
+            insert(table, key, std::to_string(i));
+            reference[key] = std::to_string(i);
+        }
+    }
+
+    EXPECT_EQ(table.size(), reference.size());
+    for (const auto &[key, value] : reference) {
+        const auto *found = lookup(table, key);
+        ASSERT_NE(found, nullptr) << key;
+        EXPECT_EQ(*found, value);
+    }
+
+    std::size_t visited = 0;
+    table.for_each([&](std::string_view key, const mini_redis::value_entry &) {
+        EXPECT_EQ(reference.count(std::string(key)), 1u);
+        ++visited;
+    });
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST(FlatTableTest, ReserveAndEraseIf) {
+    flat_table table;
+    table.reserve(1000);
+    const auto capacity = table.capacity();
+    for (int i = 0; i < 1000; ++i) {
+        insert(table, "key:" + std::to_string(i), "v");
+    }
+    EXPECT_EQ(table.capacity(), capacity); // reserve 이후에는 재해시가 없어야 함
+
+    auto erased = table.erase_if([](std::string_view key, mini_redis::value_entry &) {
+        return key.back() == '0';
+    });
+    EXPECT_EQ(erased, 100u);
+    EXPECT_EQ(table.size(), 900u);
+    EXPECT_EQ(lookup(table, "key:10"), nullptr);
+    EXPECT_NE(lookup(table, "key:11"), nullptr);
+}
+
+TEST(FlatTableTest, IncrementalRehashKeepsLookupsCorrect) {
+    flat_table table;
+    int inserted = 0;
+    // 재해시가 시작될 때까지 삽입
+    while (!table.is_rehashing()) {
+        insert(table, "key:" + std::to_string(inserted), std::to_string(inserted));
+        ++inserted;
+    }
+
+    // 이전 배열과 새 배열에 키가 나뉘어 있는 동안에도 모든 키가 조회되어야 함
+    for (int i = 0; i < inserted; ++i) {
+        const auto *found = lookup(table, "key:" + std::to_string(i));
+        ASSERT_NE(found, nullptr) << i;
+        EXPECT_EQ(*found, std::to_string(i));
+    }
+
+    // 재해시 도중의 삭제와 덮어쓰기
+    EXPECT_TRUE(table.erase("key:0", flat_table::hash("key:0")));
+    insert(table, "key:1", "updated");
+    EXPECT_EQ(table.size(), static_cast<std::size_t>(inserted - 1));
+    EXPECT_EQ(*lookup(table, "key:1"), "updated");
+
+    // 쓰기 한 번에 옮기는 양은 제한되어 있으므로 나머지는 rehash_step으로 마무리
+    while (table.rehash_step(flat_table::rehash_step_slots)) {}
+    EXPECT_FALSE(table.is_rehashing());
+    EXPECT_EQ(lookup(table, "key:0"), nullptr);
+    for (int i = 1; i < inserted; ++i) {
+        EXPECT_NE(lookup(table, "key:" + std::to_string(i)), nullptr) << i;
+    }
+}
+
+TEST(FlatTableTest, EraseIfRangeAndShrink) {
+    flat_table table;
+    for (int i = 0; i < 10000; ++i) {
+        insert(table, "key:" + std::to_string(i), "v");
+    }
+    const auto grown = table.capacity();
+
+    // 작은 구간씩 나누어 순회해도 전체를 한 번씩 방문해야 함
+    std::size_t cursor = 0;
+    std::size_t visited = 0;
+    do {
+        cursor = table.erase_if_range(cursor, 100, [&](std::string_view key, mini_redis::value_entry &) {
+            ++visited;
+            return key != "key:7";
+        });
+    } while (cursor != 0);
+    EXPECT_EQ(visited, 10000u);
+    EXPECT_EQ(table.size(), 1u);
+
+    // 거의 비어 버린 테이블은 작은 배열로 옮겨짐
+    EXPECT_TRUE(table.shrink_to_fit());
+    while (table.rehash_step(flat_table::rehash_step_slots)) {}
+    EXPECT_LT(table.capacity(), grown);
+    EXPECT_NE(lookup(table, "key:7"), nullptr);
+    EXPECT_FALSE(table.shrink_to_fit());
+
+    EXPECT_TRUE(table.erase("key:7", flat_table::hash("key:7")));
+    insert(table, "other", "v");
+    table.erase("other", flat_table::hash("other"));
+    EXPECT_EQ(table.capacity(), flat_table::group_width);
+}
@@ -3,6 +3,7 @@
 #include <thread>
 #include <chrono>
 #include <algorithm>
+#include <vector>
 
 class GenericCommandsTest : public ::testing::Test {
 protected:
@@ -85,3 +86,105 @@ TEST_F(GenericCommandsTest, KeysWithExpiration) {
     EXPECT_EQ(keys.size(), 1);
     EXPECT_EQ(keys[0], "key1");
 }
+
+TEST_F(GenericCommandsTest, DeleteAcrossShards) {
+    mini_redis::store_config cfg;
+    cfg.shards = 4;
+    mini_redis::store sharded(cfg);
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < 100; ++i) {
+        keys.push_back("key:" + std::to_string(i));
+        sharded.set(keys.back(), "value");
+    }
+    keys.push_back("key:0"); // 중복 키는 한 번만 삭제되어야 함
+    EXPECT_EQ(sharded.del(keys), 100);
+    EXPECT_TRUE(sharded.keys("*").empty());
+}
+
+TEST_F(GenericCommandsTest, ConcurrentMultiKeyDelete) {
+    // 여러 shard에 걸친 DEL이 서로 반대 순서로 동시에 실행되어도 교착 상태에 빠지지 않아야 함
+    std::vector<std::string> forward, backward;
+    for (int i = 0; i < 64; ++i) {
+        forward.push_back("k" + std::to_string(i));
+    }
+    backward.assign(forward.rbegin(), forward.rend());
+
+    auto worker = [this](const std::vector<std::string>& keys) {
+        for (int round = 0; round < 500; ++round) {
+            for (const auto& key : keys) {
+                store_instance.incr(key);
+            }
+            store_instance.del(keys);
+        }
+    };
+    std::thread t1(worker, forward);
+    std::thread t2(worker, backward);
+    t1.join();
+    t2.join();
+
+    EXPECT_TRUE(store_instance.keys("*").empty());
+}
+
+TEST_F(GenericCommandsTest, ActiveExpireReclaimsUnreadKeys) {
+    // 다시 읽히지 않는 만료 키도 능동 만료 사이클이 삭제하고 메모리를 돌려줘야 함
+    const auto baseline = store_instance.memory_usage();
+    store_instance.set("persistent", "value");
+    for (int i = 0; i < 5000; ++i) {
+        store_instance.setex("temp:" + std::to_string(i), 1, "value");
+    }
+    const auto peak = store_instance.memory_usage();
+    EXPECT_GT(peak, baseline);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+    std::size_t expired = 0;
+    for (int cycle = 0; cycle < 100 && expired < 5000; ++cycle) {
+        expired += store_instance.active_expire_cycle(std::chrono::milliseconds(25)).expired;
+    }
+    EXPECT_EQ(expired, 5000u);
+    EXPECT_EQ(store_instance.expired_keys(), 5000u);
+    EXPECT_GT(store_instance.expired_stale_ratio(), 0.0);
+    EXPECT_EQ(store_instance.get("persistent"), "value");
+
+    // 재해시(축소)가 끝나면 키 하나만 남은 shard의 최소 크기로 돌아감
+    for (int i = 0; i < 100; ++i) {
+        store_instance.rehash_step(std::chrono::milliseconds(10));
+    }
+    EXPECT_LT(store_instance.memory_usage(), peak / 100);
+}
+
+TEST_F(GenericCommandsTest, MillisecondExpiry) {
+    store_instance.psetex("short", 50, "value");
+    store_instance.set("long", "value");
+    EXPECT_TRUE(store_instance.pexpire("long", 10000));
+    EXPECT_FALSE(store_instance.pexpire("missing", 10000));
+
+    const auto pttl = store_instance.pttl("short");
+    EXPECT_GT(pttl, 0);
+    EXPECT_LE(pttl, 50);
+    EXPECT_GE(store_instance.ttl("long"), 9);
+    EXPECT_LE(store_instance.ttl("long"), 10);
+    EXPECT_EQ(store_instance.pttl("missing"), -2);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(store_instance.active_expire_cycle(std::chrono::milliseconds(10)).expired, 1u);
+    EXPECT_EQ(store_instance.pttl("short"), -2);
+    EXPECT_TRUE(store_instance.exists("long"));
+}
+
+TEST_F(GenericCommandsTest, ActiveExpireSkipsRefreshedKeys) {
+    // 인덱스에 남은 이전 만료 시각은 무시되고, 갱신된 TTL이나 SET으로 지운 TTL이 우선해야 함
+    store_instance.psetex("refreshed", 30, "value");
+    store_instance.pexpire("refreshed", 10000);
+    store_instance.psetex("persisted", 30, "value");
+    store_instance.set("persisted", "value");
+    store_instance.psetex("expiring", 30, "value");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto result = store_instance.active_expire_cycle(std::chrono::milliseconds(10));
+    EXPECT_EQ(result.expired, 1u);
+    EXPECT_TRUE(store_instance.exists("refreshed"));
+    EXPECT_TRUE(store_instance.exists("persisted"));
+    EXPECT_FALSE(store_instance.exists("expiring"));
+}
@@ -0,0 +1,196 @@
+#include "gtest/gtest.h"
+#include "storage/glob.hpp"
+#include <random>
+#include <string>
+
+/*
+* glob_pattern (컴파일된 glob 패턴), find_literal, glob_cache 단위 테스트.
+* Redis 문법(*, ?, [...], \ escape)을 확인하고, 무작위 패턴의 결과를 Redis의 stringmatchlen을
+* 그대로 옮긴 재귀 구현과 비교합니다.
+*/
+
+using mini_redis::glob_pattern;
+
+namespace {
+    // Redis util.c stringmatchlen (nocase 제외)를 옮긴 기준 구현
+    bool reference_match(const char *pattern, int patternLen, const char *string, int stringLen) {
+        while (patternLen && stringLen) {
+            switch (pattern[0]) {
+            case '*':
+                while (patternLen && pattern[1] == '*') {
+                    pattern++;
+                    patternLen--;
+                }
+                if (patternLen == 1) return true;
+                while (stringLen) {
+                    if (reference_match(pattern + 1, patternLen - 1, string, stringLen)) return true;
+                    string++;
+                    stringLen--;
+                }
+                return false;
+            case '?':
+                string++;
+                stringLen--;
+                break;
+            case '[': {
+                pattern++;
+                patternLen--;
+                bool negate = pattern[0] == '^';
+                if (negate) {
+                    pattern++;
+                    patternLen--;
+                }
+                bool match = false;
+                while (true) {
+                    if (pattern[0] == '\\' && patternLen >= 2) {
+                        pattern++;
+                        patternLen--;
+                        if (pattern[0] == string[0]) match = true;
+                    } else if (pattern[0] == ']') {
+                        break;
+                    } else if (patternLen == 0) {
+                        pattern--;
+                        patternLen++;
+                        break;
+                    } else if (patternLen >= 3 && pattern[1] == '-') {
+                        int start = static_cast<unsigned char>(pattern[0]);
+                        int end = static_cast<unsigned char>(pattern[2]);
+                        int c = static_cast<unsigned char>(string[0]);
+                        if (start > end) std::swap(start, end);
+                        pattern += 2;
+                        patternLen -= 2;
+                        if (c >= start && c <= end) match = true;
+                    } else if (pattern[0] == string[0]) {
+                        match = true;
+                    }
+                    pattern++;
+                    patternLen--;
+                }
+                if (negate) match = !match;
+                if (!match) return false;
+                string++;
+                stringLen--;
+                break;
+            }
+            case '\\':
+                if (patternLen >= 2) {
+                    pattern++;
+                    patternLen--;
+                }
+                [[fallthrough]];
+            default:
+                if (pattern[0] != string[0]) return false;
+                string++;
+                stringLen--;
+                break;
+            }
+            pattern++;
+            patternLen--;
+            if (stringLen == 0) {
+                while (*pattern == '*') {
+                    pattern++;
+                    patternLen--;
+                }
+                break;
+            }
+        }
+        return patternLen == 0 && stringLen == 0;
+    }
+
+    bool reference_match(const std::string &pattern, const std::string &text) {
+        // stringmatchlen은 빈 문자열을 "*"와도 일치시키지 않음 (Redis의 KEYS *는 따로 처리).
+        // 여기서는 '*'만으로 된 패턴이 빈 문자열과 일치하는 것으로 봄
+        if (text.empty()) {
+            return pattern.find_first_not_of('*') == std::string::npos;
+        }
+        return reference_match(pattern.c_str(), static_cast<int>(pattern.size()), text.c_str(),
+                               static_cast<int>(text.size()));
+    }
+
+    bool match(const std::string &pattern, const std::string &text) {
+        return glob_pattern(pattern).match(text);
+    }
+}
+
+TEST(GlobTest, RedisSyntax) {
+    EXPECT_TRUE(match("*", ""));
+    EXPECT_TRUE(match("*", "anything"));
+    EXPECT_TRUE(match("", ""));
+    EXPECT_FALSE(match("", "a"));
+    EXPECT_TRUE(match("h?llo", "hello"));
+    EXPECT_FALSE(match("h?llo", "hllo"));
+    EXPECT_TRUE(match("h*llo", "hllo"));
+    EXPECT_TRUE(match("h*llo", "heeeello"));
+    EXPECT_TRUE(match("h[ae]llo", "hallo"));
+    EXPECT_FALSE(match("h[ae]llo", "hillo"));
+    EXPECT_TRUE(match("h[^e]llo", "hallo"));
+    EXPECT_FALSE(match("h[^e]llo", "hello"));
+    EXPECT_TRUE(match("h[a-b]llo", "hbllo"));
+    EXPECT_TRUE(match("h[b-a]llo", "hallo"));
+    EXPECT_FALSE(match("h[a-b]llo", "hcllo"));
+    // escape: 패턴 문자를 문자 그대로
+    EXPECT_TRUE(match("a\\*b", "a*b"));
+    EXPECT_FALSE(match("a\\*b", "axb"));
+    EXPECT_TRUE(match("[\\]]", "]"));
+    EXPECT_TRUE(match("abc\\", "abc\\"));
+    // 닫히지 않은 [는 패턴 끝까지 문자 집합
+    EXPECT_TRUE(match("x[abc", "xb"));
+    EXPECT_TRUE(match("*a*b*", "xxaxxb"));
+    EXPECT_FALSE(match("*a*b*", "xxbxxa"));
+    EXPECT_TRUE(match("*ab*abc", "abababc"));
+    EXPECT_TRUE(match("user:*:profile", "user:42:profile"));
+    EXPECT_FALSE(match("user:*:profile", "user:42:profile:x"));
+    EXPECT_FALSE(match("a*a", "a"));
+
+    glob_pattern prefixed("session:4?:*");
+    EXPECT_EQ(prefixed.literal_prefix(), "session:4");
+    EXPECT_EQ(glob_pattern("\\*x").literal_prefix(), "*x");
+    EXPECT_EQ(glob_pattern("*x").literal_prefix(), "");
+    EXPECT_TRUE(glob_pattern("***").matches_all());
+    EXPECT_FALSE(glob_pattern("*?").matches_all());
+}
+
+TEST(GlobTest, MatchesReferenceOnRandomPatterns) {
+    std::mt19937 rng(12);
+    const char pattern_chars[] = "ab*?[]^-\\";
+    const char text_chars[] = "ab-]";
+    for (int i = 0; i < 200000; ++i) {
+        std::string pattern, text;
+        for (int n = rng() % 8; n > 0; --n) {
+            pattern += pattern_chars[rng() % (sizeof(pattern_chars) - 1)];
+        }
+        for (int n = rng() % 10; n > 0; --n) {
+            text += text_chars[rng() % (sizeof(text_chars) - 1)];
+        }
+        ASSERT_EQ(match(pattern, text), reference_match(pattern, text)) << "pattern=" << pattern << " text=" << text;
+    }
+}
+
+TEST(GlobTest, FindLiteral) {
+    std::string haystack(200, 'x');
+    haystack.replace(150, 4, "abcd");
+    EXPECT_EQ(mini_redis::find_literal(haystack, "abcd"), 150u);
+    EXPECT_EQ(mini_redis::find_literal(haystack, "a"), 150u);
+    EXPECT_EQ(mini_redis::find_literal(haystack, "abce"), std::string_view::npos);
+    EXPECT_EQ(mini_redis::find_literal(haystack, ""), 0u);
+    // 블록 경계와 끝부분 (SIMD 구간이 끝난 뒤의 나머지)
+    for (std::size_t pos = 0; pos + 3 <= 70; ++pos) {
+        std::string h(70, 'a');
+        h.replace(pos, 3, "aab");
+        h[pos + 2] = 'b';
+        EXPECT_EQ(mini_redis::find_literal(h, "ab"), pos + 1) << pos;
+        EXPECT_EQ(mini_redis::find_literal(h, "aab"), pos) << pos;
+    }
+}
+
+TEST(GlobTest, CacheReusesAndEvicts) {
+    mini_redis::glob_cache cache(2);
+    auto a = cache.get("user:*");
+    EXPECT_EQ(cache.get("user:*"), a);
+    cache.get("item:*");
+    cache.get("user:*"); // user:*가 가장 최근
+    cache.get("other:*"); // item:*를 밀어냄
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.get("user:*"), a);
+    EXPECT_TRUE(a->match("user:1"));
+}
@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+#include "storage/store.hpp"
+#include "storage/compact_hash.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+* Hash commands tests: HSET/HGET/HMGET/HGETALL/HDEL/HINCRBY/HLEN on the store,
+* and compact_hash (listpack -> table conversion) compared against std::unordered_map.
+*/
+
+using mini_redis::compact_hash;
+
+class HashCommandsTest : public ::testing::Test {
+protected:
+    mini_redis::store store_instance;
+};
+
+TEST_F(HashCommandsTest, SetGetAndDelete) {
+    EXPECT_EQ(store_instance.hset("user:1", {{"name", "kim"}, {"age", "30"}}), 2u);
+    EXPECT_EQ(store_instance.hset("user:1", {{"age", "31"}, {"city", "seoul"}}), 1u);
+    EXPECT_EQ(store_instance.hget("user:1", "age"), "31");
+    EXPECT_EQ(store_instance.hget("user:1", "missing"), std::nullopt);
+    EXPECT_EQ(store_instance.hget("nokey", "age"), std::nullopt);
+    EXPECT_EQ(store_instance.hlen("user:1"), 3u);
+
+    auto values = store_instance.hmget("user:1", {"name", "nope", "city"});
+    ASSERT_EQ(values.size(), 3u);
+    EXPECT_EQ(values[0], "kim");
+    EXPECT_EQ(values[1], std::nullopt);
+    EXPECT_EQ(values[2], "seoul");
+
+    auto all = store_instance.hgetall("user:1");
+    EXPECT_EQ(all, (std::vector<std::string>{"name", "kim", "age", "31", "city", "seoul"}));
+
+    EXPECT_EQ(store_instance.hdel("user:1", {"name", "nope"}), 1u);
+    EXPECT_EQ(store_instance.hdel("user:1", {"age", "city"}), 2u);
+    // 마지막 필드를 지우면 키가 사라짐
+    EXPECT_FALSE(store_instance.exists("user:1"));
+    EXPECT_EQ(store_instance.hlen("user:1"), 0u);
+}
+
+TEST_F(HashCommandsTest, IncrbyAndErrors) {
+    EXPECT_EQ(store_instance.hincrby("counters", "visits", 5), 5);
+    EXPECT_EQ(store_instance.hincrby("counters", "visits", -7), -2);
+    store_instance.hset("counters", {{"name", "x"}, {"max", "9223372036854775807"}});
+    EXPECT_THROW(store_instance.hincrby("counters", "name", 1), std::runtime_error);
+    EXPECT_THROW(store_instance.hincrby("counters", "max", 1), std::runtime_error);
+    EXPECT_EQ(store_instance.hget("counters", "max"), "9223372036854775807");
+
+    store_instance.set("str", "value");
+    EXPECT_THROW(store_instance.hset("str", {{"a", "b"}}), std::runtime_error);
+    EXPECT_THROW(store_instance.hget("str", "a"), std::runtime_error);
+    EXPECT_THROW(store_instance.hdel("str", {"a"}), std::runtime_error);
+    EXPECT_EQ(store_instance.get("str"), "value");
+}
+
+TEST_F(HashCommandsTest, HscanBothEncodings) {
+    store_instance.hset("small", {{"a", "1"}, {"b", "2"}});
+    auto small = store_instance.hscan("small", 0);
+    EXPECT_EQ(small.cursor, 0u);
+    EXPECT_EQ(small.items, (std::vector<std::string>{"a", "1", "b", "2"}));
+
+    for (int i = 0; i < 1000; ++i) {
+        store_instance.hset("big", {{"f" + std::to_string(i), std::to_string(i)}});
+    }
+    std::vector<std::string> fields;
+    std::uint64_t cursor = 0;
+    do {
+        auto result = store_instance.hscan("big", cursor, "*", 50);
+        for (std::size_t i = 0; i < result.items.size(); i += 2) {
+            fields.push_back(result.items[i]);
+        }
+        cursor = result.cursor;
+    } while (cursor != 0);
+    std::sort(fields.begin(), fields.end());
+    fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+    EXPECT_EQ(fields.size(), 1000u);
+}
+
+TEST(CompactHashTest, ConvertsPastThresholds) {
+    compact_hash by_count(compact_hash::options{4, 16});
+    for (int i = 0; i < 4; ++i) {
+        by_count.set("f" + std::to_string(i), "v");
+    }
+    EXPECT_TRUE(by_count.is_listpack());
+    by_count.set("f4", "v");
+    EXPECT_FALSE(by_count.is_listpack());
+    EXPECT_EQ(by_count.size(), 5u);
+    EXPECT_EQ(by_count.get("f0"), "v");
+
+    compact_hash by_value(compact_hash::options{4, 16});
+    by_value.set("short", "v");
+    by_value.set("long", std::string(17, 'x'));
+    EXPECT_FALSE(by_value.is_listpack());
+    EXPECT_EQ(by_value.get("short"), "v");
+    EXPECT_EQ(by_value.get("long"), std::string(17, 'x'));
+
+    // 작은 hash는 필드마다 노드를 두는 표보다 훨씬 작음
+    compact_hash small;
+    compact_hash big(compact_hash::options{0, 64});
+    for (int i = 0; i < 10; ++i) {
+        small.set("field" + std::to_string(i), "value" + std::to_string(i));
+        big.set("field" + std::to_string(i), "value" + std::to_string(i));
+    }
+    EXPECT_TRUE(small.is_listpack());
+    EXPECT_LT(small.memory_usage() * 2, big.memory_usage());
+}
+
+TEST(CompactHashTest, MatchesUnorderedMapUnderRandomOperations) {
+    for (std::uint32_t max_entries : {8u, 128u}) {
+        compact_hash hash(compact_hash::options{max_entries, 20});
+        std::unordered_map<std::string, std::string> expected;
+        std::mt19937 rng(max_entries);
+        for (int i = 0; i < 20000; ++i) {
+            const std::string field = "f" + std::to_string(rng() % 40);
+            const unsigned op = rng() % 10;
+            if (op < 5) {
+                // 가끔 값 길이 한도를 넘는 값
+                const std::string value(rng() % 100 == 0 ? 30 : rng() % 10, static_cast<char>('a' + rng() % 26));
+                ASSERT_EQ(hash.set(field, value), expected.count(field) == 0);
+                expected[field] = value;
+            } else if (op < 8) {
+                ASSERT_EQ(hash.erase(field), expected.erase(field) == 1);
+            } else {
+                auto it = expected.find(field);
+                ASSERT_EQ(hash.get(field), it == expected.end() ? std::nullopt : std::optional<std::string>(it->second));
+            }
+            ASSERT_EQ(hash.size(), expected.size());
+        }
+        std::unordered_map<std::string, std::string> seen;
+        hash.for_each([&](std::string_view f, std::string_view v) { seen.emplace(f, v); });
+        EXPECT_EQ(seen, expected);
+        compact_hash copy = hash;
+        EXPECT_EQ(copy.size(), hash.size());
+        EXPECT_EQ(copy.memory_usage(), hash.memory_usage());
+    }
+}
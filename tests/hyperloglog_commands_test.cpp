@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+#include "storage/store.hpp"
+#include "storage/hyperloglog.hpp"
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+* HyperLogLog commands tests: PFADD/PFCOUNT/PFMERGE on the store, the sparse -> dense conversion
+* (same registers, same estimate), and the estimate's relative error at checkpoints up to 100M
+* distinct inputs.
+*/
+
+using mini_redis::hyperloglog;
+
+namespace {
+    std::vector<std::string> elements(const std::string &prefix, std::size_t from, std::size_t to) {
+        std::vector<std::string> out;
+        for (std::size_t i = from; i < to; ++i) {
+            out.push_back(prefix + std::to_string(i));
+        }
+        return out;
+    }
+
+    double relative_error(std::uint64_t estimate, std::uint64_t exact) {
+        return std::fabs(static_cast<double>(estimate) - static_cast<double>(exact)) / static_cast<double>(exact);
+    }
+}
+
+class HyperLogLogCommandsTest : public ::testing::Test {
+protected:
+    mini_redis::store store_instance;
+};
+
+TEST_F(HyperLogLogCommandsTest, PfaddAndPfcount) {
+    // 원소 없이 불러도 키를 만들고, 그다음에는 바뀐 것이 없으므로 false
+    EXPECT_TRUE(store_instance.pfadd("empty", {}));
+    EXPECT_FALSE(store_instance.pfadd("empty", {}));
+    EXPECT_EQ(store_instance.pfcount({"empty"}), 0u);
+    EXPECT_EQ(store_instance.scan(0, "*", 100, "string").items, std::vector<std::string>{"empty"});
+
+    EXPECT_TRUE(store_instance.pfadd("h", {"a", "b", "c", "d", "e"}));
+    EXPECT_FALSE(store_instance.pfadd("h", {"a", "c"}));
+    EXPECT_EQ(store_instance.pfcount({"h"}), 5u);
+    // 캐시된 추정값은 register가 바뀌면 다시 계산
+    EXPECT_TRUE(store_instance.pfadd("h", {"f", "g"}));
+    EXPECT_EQ(store_instance.pfcount({"h"}), 7u);
+    EXPECT_EQ(store_instance.pfcount({"missing"}), 0u);
+
+    store_instance.set("str", "x");
+    EXPECT_THROW(store_instance.pfadd("str", {"a"}), std::runtime_error);
+    EXPECT_THROW(store_instance.pfcount({"str"}), std::runtime_error);
+    EXPECT_THROW(store_instance.pfcount({"h", "str"}), std::runtime_error);
+    EXPECT_THROW(store_instance.sadd("h", {"a"}), std::runtime_error);
+}
+
+TEST_F(HyperLogLogCommandsTest, PfmergeAndMultiKeyPfcount) {
+    store_instance.pfadd("a", elements("x", 0, 20000));
+    store_instance.pfadd("b", elements("x", 10000, 30000));
+    store_instance.pfadd("small", {"x1", "only-here"});
+
+    const auto together = store_instance.pfcount({"a", "b", "small", "missing"});
+    EXPECT_LT(relative_error(together, 30001), 0.02);
+
+    store_instance.pfmerge("u", {"a", "b", "small", "missing"});
+    EXPECT_EQ(store_instance.pfcount({"u"}), together);
+    // dest 자신도 합집합에 들어감
+    store_instance.pfmerge("small", {"a"});
+    EXPECT_LT(relative_error(store_instance.pfcount({"small"}), 20001), 0.02);
+    store_instance.pfmerge("a", {"a", "b"});
+    EXPECT_EQ(store_instance.pfcount({"a"}), store_instance.pfcount({"a", "b"}));
+
+    // 원본이 없어도 빈 HyperLogLog를 만들고, dest의 TTL은 유지
+    store_instance.pfmerge("new", {});
+    EXPECT_TRUE(store_instance.exists("new"));
+    EXPECT_EQ(store_instance.pfcount({"new"}), 0u);
+    store_instance.expire("new", 100);
+    store_instance.pfmerge("new", {"b"});
+    EXPECT_GT(store_instance.ttl("new"), 0);
+
+    store_instance.set("str", "x");
+    EXPECT_THROW(store_instance.pfmerge("fresh", {"a", "str"}), std::runtime_error);
+    EXPECT_FALSE(store_instance.exists("fresh"));
+    EXPECT_THROW(store_instance.pfmerge("str", {"a"}), std::runtime_error);
+    EXPECT_EQ(store_instance.get("str"), "x");
+}
+
+TEST(HyperLogLogTest, SparseToDenseKeepsRegisters) {
+    hyperloglog sparse(hyperloglog::options{1 << 20}), dense(hyperloglog::options{0});
+    std::size_t converted_at = 0;
+    hyperloglog hll(hyperloglog::options{3000});
+    for (std::size_t i = 0; i < 5000; ++i) {
+        const std::string element = "e" + std::to_string(i);
+        sparse.add(element);
+        dense.add(element);
+        hll.add(element);
+        if (!converted_at && !hll.is_sparse()) {
+            converted_at = i;
+        }
+        if (i % 250 == 0) {
+            ASSERT_EQ(sparse.count(), dense.count()) << i;
+        }
+    }
+    EXPECT_TRUE(sparse.is_sparse());
+    EXPECT_FALSE(dense.is_sparse());
+    // 원소 4 bytes씩 3000 bytes를 넘는 순간 (751번째 register)에 변환
+    EXPECT_GT(converted_at, 700u);
+    EXPECT_LT(converted_at, 800u);
+    EXPECT_EQ(hll.count(), sparse.count());
+    EXPECT_GT(dense.memory_usage(), hyperloglog::dense_bytes);
+    EXPECT_LT(hyperloglog(hyperloglog::options{3000}).memory_usage(), 100u);
+
+    // 펼친 배열로 합쳐도 같은 register
+    auto raw_sparse = hyperloglog::make_raw(), raw_dense = hyperloglog::make_raw();
+    sparse.merge_into(raw_sparse);
+    dense.merge_into(raw_dense);
+    EXPECT_EQ(raw_sparse, raw_dense);
+    EXPECT_EQ(hyperloglog::estimate(raw_sparse), dense.count());
+
+    hyperloglog copy(sparse);
+    copy.merge_from(raw_dense);
+    EXPECT_FALSE(copy.is_sparse());
+    EXPECT_EQ(copy.count(), sparse.count());
+    copy = dense;
+    EXPECT_EQ(copy.count(), dense.count());
+}
+
+TEST(HyperLogLogTest, AccuracyUpTo100MDistinct) {
+    // 표준 오차 0.81%이므로 2%(약 2.5 sigma)를 허용. 해시가 결정적이라 결과는 매번 같음
+    hyperloglog hll;
+    std::uint64_t next_checkpoint = 10;
+    for (std::uint64_t i = 1; i <= 100000000; ++i) {
+        char element[8];
+        std::memcpy(element, &i, sizeof(i));
+        hll.add(std::string_view(element, sizeof(element)));
+        if (i == next_checkpoint) {
+            const double error = relative_error(hll.count(), i);
+            EXPECT_LT(error, 0.02) << i;
+            next_checkpoint *= 10;
+        }
+    }
+    EXPECT_FALSE(hll.is_sparse());
+}
@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+#include "storage/store.hpp"
+#include "storage/quicklist.hpp"
+#include "storage/lzf.hpp"
+#include <chrono>
+#include <deque>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* List commands tests: LPUSH/RPUSH/LPOP/RPOP/LRANGE/LLEN/LINDEX/LTRIM on the store,
+* and the quicklist (packed nodes, optional LZF compression) compared against std::deque.
+*/
+
+using mini_redis::quicklist;
+
+class ListCommandsTest : public ::testing::Test {
+protected:
+    mini_redis::store store_instance;
+};
+
+TEST_F(ListCommandsTest, PushPopAndRange) {
+    EXPECT_EQ(store_instance.rpush("list", {"b", "c"}), 2u);
+    EXPECT_EQ(store_instance.lpush("list", {"a", "z"}), 4u); // z가 먼저 들어간 a 앞에 옴
+    EXPECT_EQ(store_instance.lrange("list", 0, -1), (std::vector<std::string>{"z", "a", "b", "c"}));
+    EXPECT_EQ(store_instance.lrange("list", -2, 100), (std::vector<std::string>{"b", "c"}));
+    EXPECT_TRUE(store_instance.lrange("list", 3, 1).empty());
+    EXPECT_EQ(store_instance.llen("list"), 4u);
+    EXPECT_EQ(store_instance.lindex("list", -1), "c");
+    EXPECT_EQ(store_instance.lindex("list", 4), std::nullopt);
+
+    EXPECT_EQ(store_instance.lpop("list"), (std::vector<std::string>{"z"}));
+    EXPECT_EQ(store_instance.rpop("list", 2), (std::vector<std::string>{"c", "b"}));
+    // 마지막 원소를 꺼내면 키가 사라짐
+    EXPECT_EQ(store_instance.rpop("list", 5), (std::vector<std::string>{"a"}));
+    EXPECT_FALSE(store_instance.exists("list"));
+    EXPECT_EQ(store_instance.lpop("list"), std::nullopt);
+    EXPECT_EQ(store_instance.llen("list"), 0u);
+}
+
+TEST_F(ListCommandsTest, TrimAndWrongType) {
+    store_instance.rpush("list", {"0", "1", "2", "3", "4"});
+    store_instance.ltrim("list", 1, -2);
+    EXPECT_EQ(store_instance.lrange("list", 0, -1), (std::vector<std::string>{"1", "2", "3"}));
+    store_instance.ltrim("list", 5, 10);
+    EXPECT_FALSE(store_instance.exists("list"));
+
+    store_instance.set("str", "value");
+    EXPECT_THROW(store_instance.lpush("str", {"x"}), std::runtime_error);
+    EXPECT_THROW(store_instance.lrange("str", 0, -1), std::runtime_error);
+    EXPECT_THROW(store_instance.lpop("str"), std::runtime_error);
+    EXPECT_EQ(store_instance.get("str"), "value");
+    EXPECT_FALSE(store_instance.get("list").has_value());
+
+    // 만료된 리스트에 push하면 새 리스트로 시작
+    store_instance.rpush("old", {"a"});
+    store_instance.pexpire("old", 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(store_instance.rpush("old", {"b"}), 1u);
+    EXPECT_EQ(store_instance.lrange("old", 0, -1), (std::vector<std::string>{"b"}));
+}
+
+TEST(QuicklistTest, MatchesDequeUnderRandomOperations) {
+    // 작은 노드와 압축을 켜서 노드 분할/병합, 압축 경계 이동을 자주 일으킴
+    for (std::size_t depth : {0u, 1u, 2u}) {
+        quicklist list(quicklist::options{128, depth});
+        std::deque<std::string> expected;
+        std::mt19937 rng(static_cast<unsigned>(depth) + 7);
+        for (int i = 0; i < 20000; ++i) {
+            const unsigned op = rng() % 100;
+            // 반복이 많은 값 (압축 가능) 과 가끔 노드보다 긴 값
+            std::string value = "item:" + std::to_string(rng() % 50) + std::string(rng() % 20, 'x');
+            if (rng() % 200 == 0) {
+                value.assign(300, static_cast<char>('a' + rng() % 26));
+            }
+            if (op < 30) {
+                list.push_back(value);
+                expected.push_back(value);
+            } else if (op < 55) {
+                list.push_front(value);
+                expected.push_front(value);
+            } else if (op < 70) {
+                auto popped = list.pop_front();
+                ASSERT_EQ(popped.has_value(), !expected.empty());
+                if (popped) {
+                    ASSERT_EQ(*popped, expected.front());
+                    expected.pop_front();
+                }
+            } else if (op < 85) {
+                auto popped = list.pop_back();
+                ASSERT_EQ(popped.has_value(), !expected.empty());
+                if (popped) {
+                    ASSERT_EQ(*popped, expected.back());
+                    expected.pop_back();
+                }
+            } else if (op < 97) {
+                const long long n = static_cast<long long>(expected.size());
+                const long long index = n ? static_cast<long long>(rng() % (2 * n)) - n : 0;
+                auto value_at = list.at(index);
+                if (n == 0) {
+                    ASSERT_FALSE(value_at.has_value());
+                } else {
+                    ASSERT_EQ(*value_at, expected[index < 0 ? index + n : index]);
+                }
+            } else if (expected.size() > 10) {
+                const long long n = static_cast<long long>(expected.size());
+                const long long start = rng() % 5;
+                const long long stop = n - 1 - static_cast<long long>(rng() % 5);
+                list.trim(start, stop);
+                expected.erase(expected.begin() + stop + 1, expected.end());
+                expected.erase(expected.begin(), expected.begin() + start);
+            }
+            ASSERT_EQ(list.size(), expected.size());
+            if (i % 1000 == 0) {
+                auto all = list.range(0, -1);
+                ASSERT_TRUE(std::equal(all.begin(), all.end(), expected.begin(), expected.end()));
+            }
+        }
+        if (depth == 0) {
+            EXPECT_EQ(list.compressed_nodes(), 0u);
+        }
+        // 복사본은 같은 내용
+        quicklist copy = list;
+        EXPECT_EQ(copy.range(0, -1), list.range(0, -1));
+    }
+}
+
+TEST(QuicklistTest, CompressesInteriorNodes) {
+    quicklist list(quicklist::options{512, 1});
+    for (int i = 0; i < 5000; ++i) {
+        list.push_back("{\"user\":" + std::to_string(i) + ",\"status\":\"active\",\"plan\":\"free\"}");
+    }
+    // 양 끝 노드 하나씩을 제외하고 모두 압축
+    EXPECT_EQ(list.compressed_nodes(), list.node_count() - 2);
+    quicklist plain(quicklist::options{512, 0});
+    for (int i = 0; i < 5000; ++i) {
+        plain.push_back("{\"user\":" + std::to_string(i) + ",\"status\":\"active\",\"plan\":\"free\"}");
+    }
+    EXPECT_LT(list.memory_usage(), plain.memory_usage() * 3 / 4);
+    EXPECT_EQ(list.range(2500, 2502), plain.range(2500, 2502));
+    EXPECT_EQ(list.at(-4000), plain.at(-4000));
+    // 압축된 노드를 가로지르는 trim
+    list.trim(100, -100);
+    plain.trim(100, -100);
+    EXPECT_EQ(list.range(0, -1), plain.range(0, -1));
+    EXPECT_EQ(list.compressed_nodes(), list.node_count() - 2);
+}
+
+TEST(QuicklistTest, LzfRoundTrip) {
+    std::mt19937 rng(3);
+    for (int i = 0; i < 300; ++i) {
+        std::string input;
+        const std::size_t len = rng() % 20000;
+        while (input.size() < len) {
+            // 무작위 byte와 앞부분 반복을 섞음
+            if (rng() % 3 == 0 && !input.empty()) {
+                const std::size_t from = rng() % input.size();
+                input += input.substr(from, rng() % 300);
+            } else {
+                input += static_cast<char>(rng() % (i % 2 ? 256 : 4));
+            }
+        }
+        std::string compressed(input.size() + input.size() / 16 + 64, '\0');
+        const std::size_t size = mini_redis::lzf_compress(input.data(), input.size(), compressed.data(), compressed.size());
+        if (input.empty()) {
+            EXPECT_EQ(size, 0u);
+            continue;
+        }
+        ASSERT_GT(size, 0u);
+        std::string output(input.size(), '\0');
+        ASSERT_EQ(mini_redis::lzf_decompress(compressed.data(), size, output.data(), output.size()), input.size());
+        ASSERT_EQ(output, input);
+    }
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <thread>
 #include <chrono>
+#include <map>
+#include <optional>
 #include <boost/asio.hpp>
 #include "network/server.hpp"
 #include "protocol/serializer.hpp"
@@ -46,11 +48,71 @@ protected:
         boost::asio::write(socket, boost::asio::buffer(data));
     }
 
-    // Helper to read data from socket
+    // Helper to read exactly one RESP reply from socket. The server may merge several replies into
+    // one segment, so the bytes after the reply stay in the socket's buffer for the next call.
+    // Fails the test instead of hanging if the reply does not arrive within read_timeout.
     std::string read_from_socket(tcp::socket& socket) {
-        boost::asio::streambuf buf;
-        boost::asio::read_until(socket, buf, "\r\n");
-        return std::string(boost::asio::buffers_begin(buf.data()), boost::asio::buffers_end(buf.data()));
+        auto& buf = read_buffers_[&socket];
+        auto& io_context = static_cast<boost::asio::io_context&>(socket.get_executor().context());
+        const auto deadline = std::chrono::steady_clock::now() + read_timeout;
+        for (;;) {
+            const std::string data(boost::asio::buffers_begin(buf.data()), boost::asio::buffers_end(buf.data()));
+            if (const auto end = reply_end(data, 0)) {
+                buf.consume(*end);
+                return data.substr(0, *end);
+            }
+            boost::system::error_code error = boost::asio::error::would_block;
+            std::size_t received = 0;
+            socket.async_read_some(buf.prepare(4096), [&](const boost::system::error_code& ec, std::size_t n) {
+                error = ec;
+                received = n;
+            });
+            io_context.restart();
+            io_context.run_until(deadline);
+            if (error == boost::asio::error::would_block) {
+                // Let the cancelled read finish before its handler's captures go out of scope
+                socket.cancel();
+                io_context.restart();
+                io_context.run();
+                ADD_FAILURE() << "timed out waiting for a reply, received so far: " << data;
+                return data;
+            }
+            if (error) {
+                ADD_FAILURE() << "read failed: " << error.message();
+                return data;
+            }
+            buf.commit(received);
+        }
+    }
+
+private:
+    static constexpr std::chrono::seconds read_timeout{5};
+    std::map<const tcp::socket*, boost::asio::streambuf> read_buffers_;
+
+    // End offset of the RESP value starting at pos, or std::nullopt if data does not hold all of it yet
+    static std::optional<std::size_t> reply_end(const std::string& data, std::size_t pos) {
+        const auto line_end = data.find("\r\n", pos);
+        if (pos >= data.size() || line_end == std::string::npos) {
+            return std::nullopt;
+        }
+        const char type = data[pos];
+        if (type == '+' || type == '-' || type == ':') {
+            return line_end + 2;
+        }
+        const long long length = std::stoll(data.substr(pos + 1, line_end - pos - 1));
+        if (length < 0) {
+            return line_end + 2;
+        }
+        if (type == '$') {
+            const std::size_t end = line_end + 2 + static_cast<std::size_t>(length) + 2;
+            return end <= data.size() ? std::optional<std::size_t>(end) : std::nullopt;
+        }
+        // '*': an array of length values
+        std::optional<std::size_t> end = line_end + 2;
+        for (long long i = 0; i < length && end; ++i) {
+            end = reply_end(data, *end);
+        }
+        return end;
     }
 };
 
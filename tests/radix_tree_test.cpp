@@ -0,0 +1,154 @@
+#include "gtest/gtest.h"
+#include "storage/radix_tree.hpp"
+#include "storage/store.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* radix_tree (선택적 키 인덱스) 단위 테스트.
+* 무작위 삽입/삭제 결과를 std::set과 비교하고, 사전 순 범위/접두사 순회, 키에 붙인 값과
+* store의 인덱스를 사용한 KEYS 결과를 검증합니다.
+*/
+
+using mini_redis::radix_tree;
+
+namespace {
+    std::vector<std::string> collect_range(const radix_tree &tree, std::string_view first, std::string_view last) {
+        std::vector<std::string> out;
+        tree.for_each_range(first, last, [&](std::string_view key) {
+            out.emplace_back(key);
+            return true;
+        });
+        return out;
+    }
+
+    std::vector<std::string> collect_prefix(const radix_tree &tree, std::string_view prefix) {
+        std::vector<std::string> out;
+        tree.for_each_prefix(prefix, [&](std::string_view key) {
+            out.emplace_back(key);
+            return true;
+        });
+        return out;
+    }
+}
+
+TEST(RadixTreeTest, InsertEraseMatchesReference) {
+    radix_tree tree;
+    std::set<std::string> reference;
+    std::mt19937 rng(7);
+    const char alphabet[] = "ab:\xff";
+    for (int i = 0; i < 20000; ++i) {
+        // 짧은 키를 작은 문자 집합에서 만들어 분할과 병합이 자주 일어나게 함
+        std::string key;
+        for (int n = rng() % 6; n > 0; --n) {
+            key += alphabet[rng() % 4];
+        }
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(tree.erase(key), reference.erase(key) == 1) << key;
+        } else {
+            EXPECT_EQ(tree.insert(key), reference.insert(key).second) << key;
+        }
+        ASSERT_EQ(tree.size(), reference.size());
+    }
+    for (const auto &key : reference) {
+        EXPECT_TRUE(tree.contains(key));
+    }
+    EXPECT_FALSE(tree.contains("zzz"));
+    EXPECT_EQ(collect_range(tree, "", ""), std::vector<std::string>(reference.begin(), reference.end()));
+
+    for (const auto &key : reference) {
+        tree.erase(key);
+    }
+    EXPECT_TRUE(tree.empty());
+    const std::size_t empty_memory = radix_tree().memory_usage();
+    EXPECT_EQ(tree.memory_usage(), empty_memory);
+}
+
+TEST(RadixTreeTest, RangeAndPrefix) {
+    radix_tree tree;
+    for (const char *key : {"session:1:a", "session:1:b", "session:10:a", "session:2:a", "session", "sess", "user:1"}) {
+        tree.insert(key);
+    }
+    // byte 순서: '0'(0x30) < ':'(0x3A)
+    EXPECT_EQ(collect_prefix(tree, "session:1"),
+              (std::vector<std::string>{"session:10:a", "session:1:a", "session:1:b"}));
+    EXPECT_EQ(collect_prefix(tree, "session:1:"), (std::vector<std::string>{"session:1:a", "session:1:b"}));
+    EXPECT_EQ(collect_prefix(tree, "sess"),
+              (std::vector<std::string>{"sess", "session", "session:10:a", "session:1:a", "session:1:b", "session:2:a"}));
+    EXPECT_TRUE(collect_prefix(tree, "nothing").empty());
+
+    // [first, last) 범위, last가 비어 있으면 끝까지
+    EXPECT_EQ(collect_range(tree, "session:1:", "session:2:a"),
+              (std::vector<std::string>{"session:1:a", "session:1:b"}));
+    EXPECT_EQ(collect_range(tree, "session:1:b", "session:2:a~"),
+              (std::vector<std::string>{"session:1:b", "session:2:a"}));
+    EXPECT_EQ(collect_range(tree, "session:2", ""), (std::vector<std::string>{"session:2:a", "user:1"}));
+
+    // fn이 false를 반환하면 멈춤
+    std::size_t visited = 0;
+    tree.for_each_range("", "", [&](std::string_view) { return ++visited < 3; });
+    EXPECT_EQ(visited, 3u);
+}
+
+TEST(RadixTreeTest, ValuesSurviveSplitsAndMerges) {
+    // 값을 함께 저장하는 트리: 노드가 나뉘거나 합쳐져도 키마다 값이 그대로 따라감
+    radix_tree tree(true);
+    std::vector<int> values(6);
+    const std::vector<std::string> keys{"abc", "abd", "ab", "abcdef", "b", "abcd"};
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_TRUE(tree.insert(keys[i], &values[i]));
+    }
+    EXPECT_FALSE(tree.insert("abc", &values[5]));
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(tree.find(keys[i]), &values[i]) << keys[i];
+    }
+    EXPECT_EQ(tree.find("a"), nullptr);
+
+    EXPECT_TRUE(tree.erase("abc"));
+    EXPECT_TRUE(tree.erase("abcd"));
+    EXPECT_EQ(tree.find("abcdef"), &values[3]);
+    EXPECT_EQ(tree.find("ab"), &values[2]);
+
+    // first 이상인 첫 키 (stream이 ID로 block을 찾는 방식)
+    void *found = nullptr;
+    tree.for_each_entry("abce", "", [&](std::string_view key, void *value) {
+        EXPECT_EQ(key, "abd");
+        found = value;
+        return false;
+    });
+    EXPECT_EQ(found, &values[1]);
+}
+
+TEST(RadixTreeTest, StoreKeysUsesIndex) {
+    mini_redis::store_config config;
+    config.key_index = true;
+    mini_redis::store indexed(config);
+    mini_redis::store plain;
+    for (int i = 0; i < 5000; ++i) {
+        const std::string key = "session:" + std::to_string(i % 50) + ":" + std::to_string(i);
+        indexed.set(key, "v");
+        plain.set(key, "v");
+    }
+    for (int i = 0; i < 5000; i += 3) {
+        const std::string key = "session:" + std::to_string(i % 50) + ":" + std::to_string(i);
+        indexed.del(key);
+        plain.del(key);
+    }
+    indexed.psetex("session:7:expiring", 1, "v");
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    for (const char *pattern : {"session:7:*", "session:1?:*", "session:*:42", "*"}) {
+        auto a = indexed.keys(pattern);
+        auto b = plain.keys(pattern);
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        EXPECT_EQ(a, b) << pattern;
+    }
+    EXPECT_EQ(indexed.keys("session:7:*").size(), 67u);
+    // 인덱스 메모리도 키 공간 메모리에 포함
+    EXPECT_GT(indexed.memory_usage(), plain.memory_usage());
+}
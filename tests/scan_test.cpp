@@ -0,0 +1,188 @@
+#include "gtest/gtest.h"
+#include "storage/collection_scan.hpp"
+#include "storage/flat_table.hpp"
+#include "storage/store.hpp"
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+/*
+* SCAN (cursor 기반 점진적 순회) 단위 테스트.
+* flat_table의 reverse-binary cursor가 순회 도중 테이블이 커지거나 줄어도 키를 빠뜨리지 않는지,
+* store::scan의 MATCH/COUNT/TYPE 처리와 shard 간 cursor, 컬렉션 순회 함수를 검증합니다.
+*/
+
+using mini_redis::flat_table;
+
+namespace {
+    void insert(flat_table &table, const std::string &key) {
+        table.try_emplace(key, flat_table::hash(key)).first->value = mini_redis::RedisString(key);
+    }
+
+    // cursor 하나만큼 순회하고 본 키를 seen에 추가
+    std::uint64_t scan_step(const flat_table &table, std::uint64_t cursor, std::multiset<std::string> &seen) {
+        return table.scan(cursor, [&](std::string_view key, const mini_redis::value_entry &) {
+            seen.insert(std::string(key));
+        });
+    }
+}
+
+TEST(ScanTest, FlatTableVisitsEveryKeyOnce) {
+    flat_table table;
+    for (int i = 0; i < 5000; ++i) {
+        insert(table, "key:" + std::to_string(i));
+    }
+    while (table.rehash_step(1024)) {}
+
+    std::multiset<std::string> seen;
+    std::uint64_t cursor = 0;
+    do {
+        cursor = scan_step(table, cursor, seen);
+    } while (cursor != 0);
+    // 크기가 바뀌지 않으면 모든 키를 정확히 한 번씩 반환
+    EXPECT_EQ(seen.size(), 5000u);
+    for (int i = 0; i < 5000; ++i) {
+        EXPECT_EQ(seen.count("key:" + std::to_string(i)), 1u);
+    }
+}
+
+TEST(ScanTest, FlatTableStableAcrossGrowth) {
+    flat_table table;
+    for (int i = 0; i < 1000; ++i) {
+        insert(table, "old:" + std::to_string(i));
+    }
+    std::multiset<std::string> seen;
+    std::uint64_t cursor = 0;
+    int added = 0;
+    do {
+        cursor = scan_step(table, cursor, seen);
+        // 순회 중에 키를 추가하여 여러 번의 확장과 증분 재해시를 거치게 함
+        // (순회 속도보다 빠르게 계속 커지면 순회가 끝나지 않으므로 일정 수까지만)
+        for (int i = 0; i < 50 && added < 30000; ++i) {
+            insert(table, "new:" + std::to_string(added++));
+        }
+    } while (cursor != 0);
+    EXPECT_GT(table.capacity(), 1024u * 16);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_GE(seen.count("old:" + std::to_string(i)), 1u) << i;
+    }
+}
+
+TEST(ScanTest, FlatTableStableAcrossShrink) {
+    flat_table table;
+    for (int i = 0; i < 50000; ++i) {
+        insert(table, "key:" + std::to_string(i));
+    }
+    while (table.rehash_step(1024)) {}
+
+    std::multiset<std::string> seen;
+    std::uint64_t cursor = 0;
+    for (int step = 0; step < 100; ++step) {
+        cursor = scan_step(table, cursor, seen);
+    }
+    // 100개마다 하나만 남기고 지운 뒤 작은 배열로 옮기는 도중과 끝난 뒤에도 계속 순회
+    for (int i = 0; i < 50000; ++i) {
+        if (i % 100 != 0) {
+            const std::string key = "key:" + std::to_string(i);
+            table.erase(key, flat_table::hash(key));
+        }
+    }
+    ASSERT_TRUE(table.shrink_to_fit());
+    int steps = 0;
+    while (cursor != 0) {
+        cursor = scan_step(table, cursor, seen);
+        if (++steps % 4 == 0) {
+            table.rehash_step(64);
+        }
+    }
+    for (int i = 0; i < 50000; i += 100) {
+        EXPECT_GE(seen.count("key:" + std::to_string(i)), 1u) << i;
+    }
+}
+
+TEST(ScanTest, StoreScanMatchCountType) {
+    mini_redis::store_config config;
+    config.shards = 4;
+    mini_redis::store s(config);
+    for (int i = 0; i < 1000; ++i) {
+        s.set("user:" + std::to_string(i), "v");
+        s.set("item:" + std::to_string(i), std::to_string(i));
+    }
+    s.psetex("user:expiring", 1, "gone");
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    std::set<std::string> users;
+    std::uint64_t cursor = 0;
+    int calls = 0;
+    do {
+        auto result = s.scan(cursor, "user:*", 50);
+        for (const auto &key : result.items) {
+            EXPECT_EQ(key.rfind("user:", 0), 0u);
+            users.insert(key);
+        }
+        cursor = result.cursor;
+        ++calls;
+    } while (cursor != 0);
+    EXPECT_EQ(users.size(), 1000u);
+    EXPECT_EQ(users.count("user:expiring"), 0u);
+    // COUNT만큼씩 나누어 순회했는지 (2001개 키 / 50)
+    EXPECT_GE(calls, 2001 / 50 / 2);
+
+    // 정수로 저장된 값도 string 타입
+    std::size_t strings = 0;
+    cursor = 0;
+    do {
+        auto result = s.scan(cursor, "*", 1000, "string");
+        strings += result.items.size();
+        cursor = result.cursor;
+    } while (cursor != 0);
+    EXPECT_EQ(strings, 2000u);
+
+    auto none = s.scan(0, "*", 100000, "hash");
+    EXPECT_EQ(none.cursor, 0u);
+    EXPECT_TRUE(none.items.empty());
+
+    // 없는 키의 컬렉션 순회는 빈 결과
+    auto missing = s.sscan("nokey", 0);
+    EXPECT_EQ(missing.cursor, 0u);
+    EXPECT_TRUE(missing.items.empty());
+    EXPECT_THROW(s.hscan("user:1", 0), std::runtime_error);
+}
+
+TEST(ScanTest, CollectionScanHelpers) {
+    std::unordered_set<std::string> set;
+    for (int i = 0; i < 300; ++i) {
+        set.insert("m" + std::to_string(i));
+    }
+    std::multiset<std::string> seen;
+    std::uint64_t cursor = 0;
+    do {
+        cursor = mini_redis::scan_buckets(set, cursor, 10, [&](const std::string &m) { seen.insert(m); });
+    } while (cursor != 0);
+    EXPECT_EQ(seen.size(), 300u);
+    EXPECT_EQ(std::set<std::string>(seen.begin(), seen.end()).size(), 300u);
+
+    // 점수 순서 cursor는 순회 중 삽입/삭제가 있어도 남아 있던 원소를 정확히 한 번씩 반환
+    std::map<double, std::string> zset;
+    for (int i = 0; i < 100; ++i) {
+        zset[i - 50.5] = "z" + std::to_string(i);
+    }
+    zset[-std::numeric_limits<double>::infinity()] = "min";
+    std::multiset<std::string> members;
+    cursor = 0;
+    int round = 0;
+    do {
+        cursor = mini_redis::scan_ordered(zset, cursor, 7, [&](const auto &e) { members.insert(e.second); });
+        zset[1000.0 + round] = "late" + std::to_string(round);
+        zset.erase(zset.begin());
+        zset[-1000.0 - round] = "early" + std::to_string(round);
+        ++round;
+    } while (cursor != 0);
+    EXPECT_EQ(members.count("min"), 1u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(members.count("z" + std::to_string(i)), 1u) << i;
+    }
+}
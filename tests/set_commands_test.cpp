@@ -0,0 +1,205 @@
+#include "gtest/gtest.h"
+#include "storage/store.hpp"
+#include "storage/compact_set.hpp"
+#include "storage/intset.hpp"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+/*
+* Set commands tests: SADD/SREM/SISMEMBER/SMEMBERS/SCARD/SINTER/SUNION/SDIFF on the store,
+* compact_set (intset -> table conversion), and the intset SIMD kernels compared against
+* std::set_intersection/set_union/set_difference.
+*/
+
+using mini_redis::compact_set;
+using mini_redis::intset;
+
+namespace {
+    std::vector<std::string> sorted(std::vector<std::string> v) {
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    std::vector<std::int64_t> values(const intset &s) {
+        std::vector<std::int64_t> out;
+        s.for_each([&](std::int64_t v) { out.push_back(v); });
+        return out;
+    }
+
+    intset make_intset(const std::vector<std::int64_t> &v) {
+        intset s;
+        for (auto x : v) {
+            s.insert(x);
+        }
+        return s;
+    }
+}
+
+class SetCommandsTest : public ::testing::Test {
+protected:
+    mini_redis::store store_instance;
+};
+
+TEST_F(SetCommandsTest, AddRemoveAndQuery) {
+    EXPECT_EQ(store_instance.sadd("s", {"3", "1", "2", "3"}), 3u);
+    EXPECT_EQ(store_instance.sadd("s", {"2", "4"}), 1u);
+    EXPECT_EQ(store_instance.scard("s"), 4u);
+    EXPECT_TRUE(store_instance.sismember("s", "4"));
+    EXPECT_FALSE(store_instance.sismember("s", "5"));
+    EXPECT_FALSE(store_instance.sismember("s", "04"));
+    // intset 인코딩은 오름차순으로 반환
+    EXPECT_EQ(store_instance.smembers("s"), (std::vector<std::string>{"1", "2", "3", "4"}));
+
+    // 정수가 아닌 원소가 들어오면 해시 집합으로 바뀌어도 내용은 그대로
+    EXPECT_EQ(store_instance.sadd("s", {"apple", "007"}), 2u);
+    EXPECT_EQ(sorted(store_instance.smembers("s")), (std::vector<std::string>{"007", "1", "2", "3", "4", "apple"}));
+    EXPECT_TRUE(store_instance.sismember("s", "007"));
+
+    EXPECT_EQ(store_instance.srem("s", {"1", "nope", "apple"}), 2u);
+    EXPECT_EQ(store_instance.srem("s", {"2", "3", "4", "007"}), 4u);
+    // 마지막 원소를 지우면 키가 사라짐
+    EXPECT_FALSE(store_instance.exists("s"));
+    EXPECT_EQ(store_instance.scard("s"), 0u);
+
+    store_instance.set("str", "value");
+    EXPECT_THROW(store_instance.sadd("str", {"a"}), std::runtime_error);
+    EXPECT_THROW(store_instance.sismember("str", "a"), std::runtime_error);
+    EXPECT_THROW(store_instance.sinter({"str"}), std::runtime_error);
+}
+
+TEST_F(SetCommandsTest, AlgebraOnBothEncodings) {
+    store_instance.sadd("a", {"1", "2", "3", "4", "5"});
+    store_instance.sadd("b", {"4", "5", "6", "-9223372036854775808"});
+    store_instance.sadd("c", {"5", "x", "1"});
+
+    EXPECT_EQ(store_instance.sinter({"a", "b"}), (std::vector<std::string>{"4", "5"}));
+    EXPECT_EQ(store_instance.sunion({"a", "b"}),
+              (std::vector<std::string>{"-9223372036854775808", "1", "2", "3", "4", "5", "6"}));
+    EXPECT_EQ(store_instance.sdiff({"a", "b"}), (std::vector<std::string>{"1", "2", "3"}));
+
+    // 해시 집합이 섞이면 일반 경로
+    EXPECT_EQ(sorted(store_instance.sinter({"a", "c"})), (std::vector<std::string>{"1", "5"}));
+    EXPECT_EQ(sorted(store_instance.sinter({"a", "b", "c"})), (std::vector<std::string>{"5"}));
+    EXPECT_EQ(sorted(store_instance.sdiff({"c", "a"})), (std::vector<std::string>{"x"}));
+    EXPECT_EQ(sorted(store_instance.sunion({"c", "b"})),
+              (std::vector<std::string>{"-9223372036854775808", "1", "4", "5", "6", "x"}));
+
+    // 없는 키는 빈 집합
+    EXPECT_TRUE(store_instance.sinter({"a", "missing"}).empty());
+    EXPECT_TRUE(store_instance.sdiff({"missing", "a"}).empty());
+    EXPECT_EQ(store_instance.sdiff({"a", "missing"}).size(), 5u);
+    EXPECT_EQ(store_instance.sunion({"missing", "a"}).size(), 5u);
+}
+
+TEST_F(SetCommandsTest, SscanBothEncodings) {
+    store_instance.sadd("small", {"2", "1"});
+    auto small = store_instance.sscan("small", 0);
+    EXPECT_EQ(small.cursor, 0u);
+    EXPECT_EQ(small.items, (std::vector<std::string>{"1", "2"}));
+
+    for (int i = 0; i < 1000; ++i) {
+        store_instance.sadd("big", {"m" + std::to_string(i)});
+    }
+    std::vector<std::string> members;
+    std::uint64_t cursor = 0;
+    do {
+        auto result = store_instance.sscan("big", cursor, "*", 50);
+        members.insert(members.end(), result.items.begin(), result.items.end());
+        cursor = result.cursor;
+    } while (cursor != 0);
+    std::sort(members.begin(), members.end());
+    members.erase(std::unique(members.begin(), members.end()), members.end());
+    EXPECT_EQ(members.size(), 1000u);
+}
+
+TEST(CompactSetTest, ConvertsPastThresholds) {
+    compact_set by_count(compact_set::options{4});
+    for (int i = 0; i < 4; ++i) {
+        by_count.insert(std::to_string(i));
+    }
+    EXPECT_TRUE(by_count.is_intset());
+    // 이미 있는 원소는 한도와 무관
+    EXPECT_FALSE(by_count.insert("3"));
+    EXPECT_TRUE(by_count.is_intset());
+    by_count.insert("4");
+    EXPECT_FALSE(by_count.is_intset());
+    EXPECT_EQ(by_count.size(), 5u);
+    EXPECT_TRUE(by_count.contains("0"));
+
+    compact_set by_member;
+    by_member.insert("10");
+    by_member.insert("+10");
+    EXPECT_FALSE(by_member.is_intset());
+    EXPECT_TRUE(by_member.contains("10"));
+    EXPECT_TRUE(by_member.contains("+10"));
+
+    // intset은 원소마다 노드를 두는 표보다 훨씬 작음
+    compact_set small;
+    compact_set big(compact_set::options{0});
+    for (int i = 0; i < 100; ++i) {
+        small.insert(std::to_string(i * 1000));
+        big.insert(std::to_string(i * 1000));
+    }
+    EXPECT_TRUE(small.is_intset());
+    EXPECT_LT(small.memory_usage() * 4, big.memory_usage());
+}
+
+TEST(IntsetTest, WidensAndKeepsOrder) {
+    intset s;
+    for (std::int64_t v : {5, -3, 100, 5}) {
+        s.insert(v);
+    }
+    EXPECT_EQ(s.width(), 4u);
+    s.insert(std::int64_t(1) << 40);
+    EXPECT_EQ(s.width(), 8u);
+    EXPECT_EQ(values(s), (std::vector<std::int64_t>{-3, 5, 100, std::int64_t(1) << 40}));
+    EXPECT_TRUE(s.contains(100));
+    EXPECT_FALSE(s.contains(101));
+    EXPECT_TRUE(s.erase(std::int64_t(1) << 40));
+    EXPECT_FALSE(s.erase(std::int64_t(1) << 40));
+    EXPECT_EQ(s.size(), 3u);
+
+    intset narrow;
+    EXPECT_FALSE(narrow.contains(std::int64_t(1) << 33));
+    EXPECT_FALSE(narrow.erase(std::int64_t(1) << 33));
+}
+
+TEST(IntsetTest, KernelsMatchStdAlgorithms) {
+    std::mt19937_64 rng(42);
+    // 크기, 값 범위, 폭을 바꿔가며 블록 경계와 꼬리 처리를 검사
+    for (int round = 0; round < 400; ++round) {
+        const std::size_t na = rng() % 200, nb = rng() % 200;
+        const std::int64_t range = 1 + static_cast<std::int64_t>(rng() % 400);
+        const bool wide_a = round % 4 == 1 || round % 4 == 3;
+        const bool wide_b = round % 4 == 2 || round % 4 == 3;
+        std::set<std::int64_t> sa, sb;
+        for (std::size_t i = 0; i < na; ++i) {
+            sa.insert(static_cast<std::int64_t>(rng() % range) - range / 2);
+        }
+        for (std::size_t i = 0; i < nb; ++i) {
+            sb.insert(static_cast<std::int64_t>(rng() % range) - range / 2);
+        }
+        if (wide_a) {
+            sa.insert(std::int64_t(1) << 40);
+        }
+        if (wide_b) {
+            sb.insert(-(std::int64_t(1) << 40));
+        }
+        const std::vector<std::int64_t> va(sa.begin(), sa.end()), vb(sb.begin(), sb.end());
+        const intset a = make_intset(va), b = make_intset(vb);
+
+        std::vector<std::int64_t> expected;
+        std::set_intersection(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(expected));
+        ASSERT_EQ(values(intset::intersect(a, b)), expected) << "round " << round;
+        expected.clear();
+        std::set_union(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(expected));
+        ASSERT_EQ(values(intset::unite(a, b)), expected) << "round " << round;
+        expected.clear();
+        std::set_difference(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(expected));
+        ASSERT_EQ(values(intset::difference(a, b)), expected) << "round " << round;
+    }
+}
@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include "storage/flat_table.hpp"
+#include "storage/slab_arena.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+* slab_arena (키와 문자열 값을 위한 크기 등급별 slab allocator) 단위 테스트.
+* 크기 등급, 빈 slab 해제, compact_string의 arena 할당, flat_table의 defrag를 검증합니다.
+*/
+
+using mini_redis::compact_string;
+using mini_redis::flat_table;
+using mini_redis::slab_arena;
+
+TEST(SlabArenaTest, SizeClasses) {
+    EXPECT_EQ(slab_arena::class_size_for(1), 16u);
+    EXPECT_EQ(slab_arena::class_size_for(16), 16u);
+    EXPECT_EQ(slab_arena::class_size_for(17), 32u);
+    EXPECT_EQ(slab_arena::class_size_for(128), 128u);
+    EXPECT_EQ(slab_arena::class_size_for(129), 144u);
+    EXPECT_EQ(slab_arena::class_size_for(600), 640u);
+    EXPECT_EQ(slab_arena::class_size_for(1000), 1024u);
+    EXPECT_EQ(slab_arena::class_size_for(slab_arena::max_object_size), slab_arena::max_object_size);
+}
+
+TEST(SlabArenaTest, FreesEmptySlabs) {
+    slab_arena arena;
+    std::vector<void *> objects;
+    for (int i = 0; i < 10000; ++i) {
+        objects.push_back(arena.allocate(40));
+        EXPECT_EQ(slab_arena::owner(objects.back()), &arena);
+    }
+    const auto &stats = arena.get_stats();
+    EXPECT_EQ(stats.live_objects, 10000u);
+    EXPECT_EQ(stats.live_bytes, 10000u * 48);
+    EXPECT_EQ(stats.requested_bytes, 10000u * 40);
+    const std::size_t slabs = stats.slabs;
+    EXPECT_GE(slabs, 10000u * 48 / slab_arena::slab_size);
+
+    for (void *p : objects) {
+        slab_arena::deallocate(p, 40);
+    }
+    EXPECT_EQ(stats.live_objects, 0u);
+    // 마지막으로 할당하던 slab과 재사용을 위해 남긴 빈 slab만 남음
+    EXPECT_LE(stats.slabs, slab_arena::max_empty_slabs + 1);
+    arena.release_empty_slabs();
+    EXPECT_EQ(stats.empty_slabs, 0u);
+    EXPECT_LE(stats.slabs, 1u);
+}
+
+TEST(SlabArenaTest, CompactStringInArena) {
+    slab_arena arena;
+    const std::string long_value(100, 'x');
+    compact_string in_arena(long_value, &arena);
+    EXPECT_TRUE(in_arena.in_arena());
+    EXPECT_EQ(in_arena.arena(), &arena);
+    EXPECT_EQ(in_arena.view(), long_value);
+    EXPECT_EQ(in_arena.heap_bytes(), 112u);
+
+    // 복사본은 원본과 같은 arena에 할당
+    compact_string copy(in_arena);
+    EXPECT_EQ(copy.arena(), &arena);
+    EXPECT_EQ(copy, in_arena);
+    EXPECT_EQ(arena.get_stats().live_objects, 2u);
+
+    // 인라인 문자열과 max_object_size보다 긴 문자열은 slab을 쓰지 않음
+    compact_string small("short", &arena);
+    EXPECT_TRUE(small.is_inline());
+    compact_string huge(std::string(slab_arena::max_object_size + 1, 'y'), &arena);
+    EXPECT_FALSE(huge.in_arena());
+    EXPECT_EQ(arena.get_stats().live_objects, 2u);
+}
+
+TEST(SlabArenaTest, CompactStringResize) {
+    slab_arena arena;
+    compact_string s("abc", &arena);
+    // 인라인 -> slab -> 전역 allocator로 옮겨 가도 앞부분은 그대로이고 늘어난 곳은 0
+    s.resize(20, &arena);
+    EXPECT_TRUE(s.is_inline());
+    s.resize(100, &arena);
+    EXPECT_TRUE(s.in_arena());
+    EXPECT_EQ(s.view().substr(0, 3), "abc");
+    EXPECT_EQ(s.view().substr(3), std::string(97, '\0'));
+    s.mutable_data()[99] = 'z';
+    s.resize(5000, &arena);
+    EXPECT_FALSE(s.in_arena());
+    EXPECT_EQ(s.view()[99], 'z');
+    EXPECT_EQ(s.view().substr(100), std::string(4900, '\0'));
+    EXPECT_EQ(arena.get_stats().live_objects, 0u);
+
+    // 커질 때는 여유 용량을 잡아 두고, 그 안에서는 다시 할당하지 않음
+    EXPECT_GT(s.heap_bytes(), 5000u);
+    const char *before = s.data();
+    s.resize(s.heap_bytes(), &arena);
+    EXPECT_EQ(s.data(), before);
+
+    // 복사본은 딱 맞는 크기로 할당
+    compact_string copy(s);
+    EXPECT_EQ(copy, s);
+    EXPECT_EQ(copy.heap_bytes(), copy.size());
+
+    s.resize(2);
+    EXPECT_TRUE(s.is_inline());
+    EXPECT_EQ(s.view(), "ab");
+}
+
+TEST(SlabArenaTest, DefragFreesSparseSlabs) {
+    flat_table table;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 50000; ++i) {
+        keys.push_back("session:0123456789abcdef:" + std::to_string(i));
+        auto *entry = table.try_emplace(keys.back(), flat_table::hash(keys.back())).first;
+        entry->value = mini_redis::RedisString(std::string(60, 'v'), table.arena());
+        table.value_resized(0, *entry);
+    }
+    // 무작위로 90%를 지우면 대부분의 slab이 조금씩만 찬 채로 남음
+    std::mt19937 rng(3);
+    std::vector<std::string> kept;
+    for (const auto &key : keys) {
+        if (rng() % 10 == 0) {
+            kept.push_back(key);
+        } else {
+            table.erase(key, flat_table::hash(key));
+        }
+    }
+    while (table.rehash_step(1024)) {}
+    const auto before = table.arena()->get_stats();
+    EXPECT_GT(before.free_bytes(), before.live_bytes);
+    const std::size_t memory_before = table.memory_usage();
+
+    std::size_t cursor = 0;
+    do {
+        cursor = table.defrag(cursor, 1000);
+    } while (cursor != 0);
+    table.arena()->release_empty_slabs();
+
+    const auto after = table.arena()->get_stats();
+    EXPECT_EQ(after.live_objects, before.live_objects);
+    EXPECT_LT(after.slabs, before.slabs / 2);
+    EXPECT_LT(table.memory_usage(), memory_before);
+    for (const auto &key : kept) {
+        const auto *entry = table.find(key, flat_table::hash(key));
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(std::get<mini_redis::RedisString>(entry->value), std::string(60, 'v'));
+    }
+}
@@ -0,0 +1,543 @@
+#include "gtest/gtest.h"
+#include "command/dispatcher.hpp"
+#include "storage/store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Snapshot (SAVE/BGSAVE) tests: every value type and encoding survives a save and load
+* with its TTL, BGSAVE writes the state at the moment it forked, and a damaged or
+* truncated file is rejected. Large files are split into chunks that load in parallel,
+* and version 1 files still load. A lazy load serves reads and writes of keys that are
+* still only in the file. DUMP/RESTORE use the same value encoding.
+*/
+
+using mini_redis::stream;
+using mini_redis::stream_id;
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    mini_redis::store_config in_dir(const fs::path &dir)
+    {
+        mini_redis::store_config config;
+        config.shards = 4;
+        config.dir = dir.string();
+        // 작은 한도로 컬렉션들이 두 인코딩을 모두 거치게 함
+        config.list_node_bytes = 64;
+        config.list_compress_depth = 1;
+        config.hash_max_listpack_entries = 4;
+        config.set_max_intset_entries = 4;
+        config.zset_max_listpack_entries = 4;
+        config.stream_node_max_entries = 3;
+        return config;
+    }
+
+    std::vector<std::string> sorted(std::vector<std::string> v)
+    {
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    stream::id_spec explicit_id(std::uint64_t ms, std::uint64_t seq)
+    {
+        return stream::id_spec{stream_id{ms, seq}, false, false};
+    }
+
+    // BGSAVE 자식이 끝날 때까지 server cron처럼 거둠
+    void wait_for_background_save(mini_redis::store &s)
+    {
+        for (int i = 0; i < 1000 && s.persistence().bgsave_in_progress; ++i)
+        {
+            s.poll_background_save();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+} // namespace
+
+class SnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() /
+               ("mini_redis_snapshot_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(dir_, ec);
+    }
+
+    fs::path dir_;
+};
+
+TEST_F(SnapshotTest, SaveAndLoadEveryType) {
+    std::vector<std::string> many;
+    for (int i = 0; i < 5000; ++i) {
+        many.push_back("e" + std::to_string(i));
+    }
+    std::uint64_t dense_count = 0;
+    {
+        mini_redis::store s(in_dir(dir_));
+        s.set("str", "hello");
+        s.set("long", std::string(5000, 'x'));
+        s.set("num", "-42");
+        s.setbit("bits", 100, true);
+        s.setex("ttl", 100, "soon");
+        s.psetex("gone", 1, "already expired");
+        std::vector<std::string> items;
+        for (int i = 0; i < 50; ++i) {
+            items.push_back("item" + std::to_string(i));
+        }
+        s.rpush("list", items);
+        s.hset("small_hash", {{"a", "1"}, {"b", "2"}});
+        s.hset("big_hash", {{"f1", "v1"}, {"f2", "v2"}, {"f3", "v3"}, {"f4", "v4"}, {"f5", std::string(100, 'y')}});
+        s.sadd("ints", {"3", "1", "2"});
+        s.sadd("members", {"x", "y", "z"});
+        s.zadd("small_z", {{1.5, "a"}, {-2, "b"}});
+        s.zadd("big_z", {{1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}, {5, "e"}, {0.25, "f"}});
+        s.pfadd("hll_sparse", {"a", "b", "c"});
+        s.pfadd("hll_dense", many);
+        dense_count = s.pfcount({"hll_dense"});
+        for (std::uint64_t i = 1; i <= 7; ++i) {
+            s.xadd("events", explicit_id(1000, i), {"n", std::to_string(i)});
+        }
+        s.xgroup_create("events", "workers", stream_id{}, false);
+        s.xreadgroup("workers", "alice", {"events"}, {std::nullopt}, 2, false);
+        s.xreadgroup("workers", "bob", {"events"}, {std::nullopt}, 1, false);
+        // 항목이 모두 지워진 스트림도 마지막 ID를 기억함
+        s.xadd("trimmed", explicit_id(5, 1), {"k", "v"});
+        mini_redis::stream_trim trim;
+        trim.by = mini_redis::stream_trim::strategy::maxlen;
+        trim.maxlen = 0;
+        s.xtrim("trimmed", trim);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        s.save();
+    }
+    ASSERT_TRUE(fs::exists(dir_ / "dump.rdb"));
+    EXPECT_FALSE(fs::exists(dir_ / "dump.rdb.tmp"));
+
+    mini_redis::store loaded(in_dir(dir_));
+    const auto stats = loaded.load_snapshot();
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->keys, 16u);
+    EXPECT_EQ(loaded.dbsize(), 16u);
+    EXPECT_GT(stats->bytes, 5000u);
+
+    EXPECT_EQ(loaded.get("str"), "hello");
+    EXPECT_EQ(loaded.get("long"), std::string(5000, 'x'));
+    EXPECT_EQ(loaded.incr("num"), -41);
+    EXPECT_TRUE(loaded.getbit("bits", 100));
+    EXPECT_EQ(loaded.bitcount("bits"), 1u);
+    EXPECT_EQ(loaded.get("ttl"), "soon");
+    EXPECT_GT(loaded.pttl("ttl"), 90000);
+    EXPECT_LE(loaded.pttl("ttl"), 100000);
+    EXPECT_EQ(loaded.get("gone"), std::nullopt);
+    EXPECT_EQ(loaded.pttl("str"), -1);
+
+    const auto list = loaded.lrange("list", 0, -1);
+    ASSERT_EQ(list.size(), 50u);
+    EXPECT_EQ(list.front(), "item0");
+    EXPECT_EQ(list.back(), "item49");
+    EXPECT_EQ(sorted(loaded.hgetall("small_hash")), sorted({"a", "1", "b", "2"}));
+    EXPECT_EQ(loaded.hlen("big_hash"), 5u);
+    EXPECT_EQ(loaded.hget("big_hash", "f5"), std::string(100, 'y'));
+    EXPECT_EQ(sorted(loaded.smembers("ints")), sorted({"1", "2", "3"}));
+    EXPECT_EQ(sorted(loaded.smembers("members")), sorted({"x", "y", "z"}));
+    EXPECT_EQ(loaded.zrange("small_z", 0, -1), (mini_redis::sorted_set::entries{{"b", -2}, {"a", 1.5}}));
+    EXPECT_EQ(loaded.zrank("big_z", "f"), 0u);
+    EXPECT_EQ(loaded.zscore("big_z", "e"), 5.0);
+    EXPECT_EQ(loaded.pfcount({"hll_sparse"}), 3u);
+    EXPECT_EQ(loaded.pfcount({"hll_dense"}), dense_count);
+    EXPECT_FALSE(loaded.pfadd("hll_dense", {"e1"}));
+
+    EXPECT_EQ(loaded.xlen("events"), 7u);
+    const auto entries = loaded.xrange("events", stream_id{}, stream_id::max(), 100);
+    ASSERT_EQ(entries.size(), 7u);
+    EXPECT_EQ(entries[6].id, (stream_id{1000, 7}));
+    EXPECT_EQ(entries[6].fields, (std::vector<std::string>{"n", "7"}));
+    const auto pending = loaded.xpending("events", "workers");
+    EXPECT_EQ(pending.count, 3u);
+    EXPECT_EQ(pending.consumers,
+              (std::vector<std::pair<std::string, std::size_t>>{{"alice", 2}, {"bob", 1}}));
+    // 그룹의 마지막 전달 ID도 복원되어 다음 읽기는 4번째 항목부터
+    const auto next = loaded.xreadgroup("workers", "alice", {"events"}, {std::nullopt}, 1, false);
+    ASSERT_EQ(next.size(), 1u);
+    EXPECT_EQ(next[0].second[0].id, (stream_id{1000, 4}));
+    EXPECT_EQ(loaded.xlen("trimmed"), 0u);
+    EXPECT_THROW(loaded.xadd("trimmed", explicit_id(5, 1), {"k", "v"}), std::runtime_error);
+}
+
+TEST_F(SnapshotTest, BackgroundSaveKeepsTheForkedState) {
+    mini_redis::store s(in_dir(dir_));
+    for (int i = 0; i < 1000; ++i) {
+        s.set("key:" + std::to_string(i), "before");
+    }
+    s.bgsave();
+    EXPECT_THROW(s.bgsave(), std::runtime_error);
+    EXPECT_THROW(s.save(), std::runtime_error);
+    // fork 뒤의 쓰기는 부모에만 보이고 스냅샷에는 들어가지 않음
+    for (int i = 0; i < 1000; ++i) {
+        s.set("key:" + std::to_string(i), "after");
+    }
+    s.set("late", "x");
+    wait_for_background_save(s);
+    const auto status = s.persistence();
+    EXPECT_FALSE(status.bgsave_in_progress);
+    EXPECT_TRUE(status.last_bgsave_ok);
+
+    mini_redis::store loaded(in_dir(dir_));
+    ASSERT_TRUE(loaded.load_snapshot().has_value());
+    EXPECT_EQ(loaded.dbsize(), 1000u);
+    EXPECT_EQ(loaded.get("key:7"), "before");
+    EXPECT_EQ(loaded.get("late"), std::nullopt);
+    EXPECT_EQ(s.get("key:7"), "after");
+}
+
+TEST_F(SnapshotTest, RejectsDamagedFiles) {
+    mini_redis::store missing(in_dir(dir_));
+    EXPECT_FALSE(missing.load_snapshot().has_value());
+
+    {
+        mini_redis::store s(in_dir(dir_));
+        for (int i = 0; i < 100; ++i) {
+            s.set("key:" + std::to_string(i), "value" + std::to_string(i));
+        }
+        s.save();
+    }
+    const auto path = dir_ / "dump.rdb";
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto write_file = [&](const std::string &contents) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << contents;
+    };
+
+    std::string flipped = bytes;
+    flipped[bytes.size() / 2] ^= 0x20;
+    write_file(flipped);
+    mini_redis::store corrupt(in_dir(dir_));
+    EXPECT_THROW(corrupt.load_snapshot(), std::runtime_error);
+
+    write_file(bytes.substr(0, bytes.size() - 20));
+    mini_redis::store truncated(in_dir(dir_));
+    EXPECT_THROW(truncated.load_snapshot(), std::runtime_error);
+
+    write_file("not a snapshot");
+    mini_redis::store garbage(in_dir(dir_));
+    EXPECT_THROW(garbage.load_snapshot(), std::runtime_error);
+
+    write_file(bytes);
+    mini_redis::store intact(in_dir(dir_));
+    ASSERT_TRUE(intact.load_snapshot().has_value());
+    EXPECT_EQ(intact.get("key:42"), "value42");
+}
+
+TEST_F(SnapshotTest, ParallelLoadSplitsTheFileIntoChunks) {
+    const std::string big(2000, 'v');
+    {
+        mini_redis::store s(in_dir(dir_));
+        // 1MB chunk를 여러 개 만들 만큼의 값
+        for (int i = 0; i < 20000; ++i) {
+            s.set("key:" + std::to_string(i), i % 2 ? std::to_string(i) : big + std::to_string(i));
+        }
+        for (int i = 0; i < 100; ++i) {
+            s.hset("hash:" + std::to_string(i), {{"f", std::to_string(i)}});
+        }
+        s.setex("ttl", 100, "soon");
+        s.save();
+    }
+    std::size_t chunks = 0;
+    {
+        const mini_redis::snapshot::reader in((dir_ / "dump.rdb").string());
+        chunks = in.chunks().size();
+        EXPECT_EQ(in.shard_count(), 4u);
+        std::uint64_t keys = 0;
+        for (const auto &chunk : in.chunks()) {
+            EXPECT_LT(chunk.shard, 4u);
+            keys += chunk.keys;
+        }
+        EXPECT_EQ(keys, 20101u);
+    }
+    EXPECT_GT(chunks, 4u);
+
+    auto check = [&](mini_redis::store &loaded) {
+        EXPECT_EQ(loaded.dbsize(), 20101u);
+        EXPECT_EQ(loaded.get("key:7"), "7");
+        EXPECT_EQ(loaded.get("key:19998"), big + "19998");
+        EXPECT_EQ(loaded.hget("hash:42", "f"), "42");
+        EXPECT_GT(loaded.ttl("ttl"), 90);
+    };
+
+    // 같은 shard 수: 스레드마다 shard를 맡음
+    {
+        mini_redis::store loaded(in_dir(dir_));
+        std::uint64_t last = 0;
+        std::uint64_t total = 0;
+        bool monotonic = true;
+        const auto stats = loaded.load_snapshot(4, [&](std::uint64_t done, std::uint64_t all) {
+            monotonic = monotonic && done > last;
+            last = done;
+            total = all;
+        });
+        ASSERT_TRUE(stats.has_value());
+        EXPECT_EQ(stats->keys, 20101u);
+        EXPECT_EQ(stats->chunks, chunks);
+        EXPECT_EQ(stats->threads, 4u);
+        EXPECT_TRUE(monotonic);
+        EXPECT_EQ(last, total);
+        check(loaded);
+    }
+    // 다른 shard 수: chunk를 나누어 읽고 키마다 잠금
+    {
+        auto config = in_dir(dir_);
+        config.shards = 3;
+        mini_redis::store loaded(config);
+        ASSERT_TRUE(loaded.load_snapshot(3).has_value());
+        check(loaded);
+    }
+    {
+        mini_redis::store loaded(in_dir(dir_));
+        ASSERT_EQ(loaded.load_snapshot(1)->threads, 1u);
+        check(loaded);
+    }
+}
+
+TEST_F(SnapshotTest, LoadsVersionOneFiles) {
+    // chunk와 index가 없던 형식: header | 레코드... | eof_marker | 전체 CRC
+    mini_redis::snapshot::encoder out;
+    out.buffer().append(mini_redis::snapshot::magic, sizeof(mini_redis::snapshot::magic));
+    out.put_u32(mini_redis::snapshot::legacy_version);
+    out.put_u64(2);
+    out.put_u64(0);
+    for (const auto &[key, value] : {std::pair<std::string, std::string>{"a", "1"}, {"b", "two"}}) {
+        out.put_u8(static_cast<std::uint8_t>(mini_redis::snapshot::value_type::string));
+        out.put_string(key);
+        out.put_string(value);
+    }
+    out.put_u8(mini_redis::snapshot::eof_marker);
+    const std::string &bytes = out.buffer();
+    out.put_u64(mini_redis::snapshot::crc64(0, bytes.data(), bytes.size()));
+    {
+        std::ofstream file(dir_ / "dump.rdb", std::ios::binary);
+        file << out.buffer();
+    }
+    mini_redis::store loaded(in_dir(dir_));
+    const auto stats = loaded.load_snapshot();
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->keys, 2u);
+    EXPECT_EQ(stats->chunks, 1u);
+    EXPECT_EQ(loaded.get("b"), "two");
+
+    // key index가 없으므로 lazy 적재도 전부 읽은 뒤에 돌아옴
+    mini_redis::store lazy(in_dir(dir_));
+    const auto lazy_stats = lazy.load_snapshot_lazily();
+    ASSERT_TRUE(lazy_stats.has_value());
+    EXPECT_FALSE(lazy_stats->deferred);
+    EXPECT_FALSE(lazy.loading());
+    EXPECT_EQ(lazy.get("a"), "1");
+}
+
+TEST_F(SnapshotTest, LazyLoadServesKeysBeforeTheyAreLoaded) {
+    const std::string value(200, 'v');
+    {
+        mini_redis::store s(in_dir(dir_));
+        for (int i = 0; i < 20000; ++i) {
+            s.set("key:" + std::to_string(i), value + std::to_string(i));
+        }
+        for (int i = 0; i < 100; ++i) {
+            s.set("counter:" + std::to_string(i), std::to_string(i));
+            s.hset("hash:" + std::to_string(i), {{"f", "1"}, {"g", "2"}});
+        }
+        s.setex("ttl", 100, "soon");
+        s.save();
+    }
+
+    // 백그라운드 적재를 첫 chunk 뒤에 세워 두어, 나머지 키가 파일에만 있는 동안 명령을 실행함
+    std::mutex m;
+    std::condition_variable cv;
+    bool paused = false;
+    bool resume = false;
+    mini_redis::store s(in_dir(dir_));
+    const auto stats = s.load_snapshot_lazily([&](std::uint64_t, std::uint64_t) {
+        std::unique_lock<std::mutex> lock(m);
+        paused = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return resume; });
+    });
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_TRUE(stats->deferred);
+    EXPECT_EQ(stats->keys, 20201u);
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return paused; });
+    }
+    EXPECT_TRUE(s.loading());
+    EXPECT_EQ(s.dbsize(), 20201u);
+    // 키 공간 전체를 보는 명령은 적재를 기다리지 않고 LOADING으로 거절됨
+    EXPECT_THROW(s.bgsave(), std::runtime_error);
+    EXPECT_THROW(s.save(), std::runtime_error);
+    EXPECT_THROW(s.keys("*"), std::runtime_error);
+    EXPECT_THROW(s.scan(0), std::runtime_error);
+
+    EXPECT_EQ(s.get("key:19999"), value + "19999");
+    EXPECT_EQ(s.mget({"key:10", "missing", "key:11"}),
+              (std::vector<std::optional<std::string>>{value + "10", std::nullopt, value + "11"}));
+    EXPECT_GT(s.ttl("ttl"), 90);
+    // 쓰기는 저장된 값 위에 적용됨
+    EXPECT_EQ(s.incr("counter:5"), 6);
+    EXPECT_EQ(s.del(std::vector<std::string>{"key:7", "missing"}), 1);
+    EXPECT_FALSE(s.get("key:7").has_value());
+    EXPECT_EQ(s.hset("hash:3", {{"f", "9"}}), 0);
+    EXPECT_EQ(s.hget("hash:3", "g"), "2");
+    s.set("key:8", "new");
+
+    {
+        std::lock_guard<std::mutex> lock(m);
+        resume = true;
+    }
+    cv.notify_all();
+    s.finish_loading();
+    EXPECT_FALSE(s.loading());
+    EXPECT_EQ(s.keys("key:*").size(), 19999u);
+    EXPECT_EQ(s.dbsize(), 20200u);
+
+    // 백그라운드 적재가 앞의 쓰기를 덮어쓰거나 지운 키를 되살리지 않음
+    EXPECT_FALSE(s.get("key:7").has_value());
+    EXPECT_EQ(s.get("key:8"), "new");
+    EXPECT_EQ(s.incr("counter:5"), 7);
+    EXPECT_EQ(s.hget("hash:3", "f"), "9");
+    EXPECT_EQ(s.get("key:12345"), value + "12345");
+    const auto status = s.persistence();
+    EXPECT_FALSE(status.loading);
+    EXPECT_GT(status.loading_faulted_keys, 0u);
+    EXPECT_TRUE(status.loading_error.empty());
+    EXPECT_NO_THROW(s.bgsave());
+    wait_for_background_save(s);
+}
+
+TEST_F(SnapshotTest, LazyLoadWithAnotherShardCountUnderMultiKeyTraffic) {
+    // 저장할 때와 shard 수가 다르면 한 chunk의 레코드가 여러 shard로 흩어짐. 백그라운드 적재가 shard를
+    // 옮겨 갈 때 잠금을 하나씩만 잡아야 여러 shard를 오름차순으로 잠그는 MGET/DEL과 교착되지 않음
+    constexpr int keys = 200000;
+    {
+        auto config = in_dir(dir_);
+        config.shards = 16;
+        mini_redis::store s(config);
+        for (int i = 0; i < keys; ++i) {
+            s.set("key:" + std::to_string(i), std::to_string(i));
+        }
+        s.save();
+    }
+    auto config = in_dir(dir_);
+    config.shards = 5;
+    mini_redis::store s(config);
+    ASSERT_TRUE(s.load_snapshot_lazily()->deferred);
+
+    std::atomic<int> finished{0};
+    std::atomic<int> deleted{0};
+    std::vector<std::thread> clients;
+    for (int t = 0; t < 4; ++t) {
+        clients.emplace_back([&, t] {
+            std::mt19937_64 rng(t + 1);
+            // 적재가 끝난 뒤에도 조금 더 보냄
+            for (int after = 0; after < 50;) {
+                std::vector<std::string> batch;
+                for (int k = 0; k < 8; ++k) {
+                    batch.push_back("key:" + std::to_string(rng() % keys));
+                }
+                s.mget(batch);
+                if (rng() % 4 == 0) {
+                    deleted += s.del(std::vector<std::string>(batch.begin(), batch.begin() + 2));
+                }
+                after += s.loading() ? 0 : 1;
+            }
+            ++finished;
+        });
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(120);
+    while (finished.load() < 4 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (finished.load() < 4) {
+        // 교착된 스레드는 join할 수 없으므로 여기서 끝냄
+        ADD_FAILURE() << "lazy load and multi-key commands made no progress";
+        std::abort();
+    }
+    for (auto &c : clients) {
+        c.join();
+    }
+    EXPECT_FALSE(s.loading());
+    EXPECT_TRUE(s.persistence().loading_error.empty());
+    EXPECT_EQ(s.dbsize(), static_cast<std::size_t>(keys - deleted.load()));
+}
+
+TEST_F(SnapshotTest, SaveCommands) {
+    auto s = std::make_shared<mini_redis::store>(in_dir(dir_));
+    mini_redis::CommandDispatcher dispatcher(s, std::make_shared<mini_redis::pubsub_manager>());
+    dispatcher.execute_command({"SET", "k", "v"});
+    const auto before = s->persistence().last_save_time;
+    EXPECT_EQ(dispatcher.execute_command({"SAVE"}), "+OK\r\n");
+    EXPECT_GE(s->persistence().last_save_time, before);
+    EXPECT_EQ(dispatcher.execute_command({"LASTSAVE"}), ":" + std::to_string(s->persistence().last_save_time) + "\r\n");
+    EXPECT_EQ(dispatcher.execute_command({"BGSAVE"}), "+Background saving started\r\n");
+    EXPECT_EQ(dispatcher.execute_command({"BGSAVE"}), "-ERR Background save already in progress\r\n");
+    EXPECT_NE(dispatcher.execute_command({"INFO", "persistence"}).find("rdb_bgsave_in_progress:1"), std::string::npos);
+    wait_for_background_save(*s);
+    EXPECT_NE(dispatcher.execute_command({"INFO", "persistence"}).find("rdb_last_bgsave_status:ok"), std::string::npos);
+    EXPECT_EQ(dispatcher.execute_command({"SAVE", "extra"}), "-ERR wrong number of arguments for 'save' command\r\n");
+}
+
+TEST_F(SnapshotTest, DumpAndRestore) {
+    auto s = std::make_shared<mini_redis::store>(in_dir(dir_));
+    mini_redis::CommandDispatcher dispatcher(s, std::make_shared<mini_redis::pubsub_manager>());
+    dispatcher.execute_command({"RPUSH", "list", "a", "b", "c", "d", "e", "f"});
+    dispatcher.execute_command({"ZADD", "zset", "1", "m1", "2.5", "m2"});
+    dispatcher.execute_command({"SET", "n", "42"});
+
+    const auto list = s->dump("list");
+    ASSERT_TRUE(list.has_value());
+    EXPECT_FALSE(s->dump("missing").has_value());
+    EXPECT_EQ(dispatcher.execute_command({"DUMP", "missing"}), "$-1\r\n");
+
+    EXPECT_EQ(dispatcher.execute_command({"RESTORE", "copy", "0", *list}), "+OK\r\n");
+    EXPECT_EQ(s->lrange("copy", 0, -1), (std::vector<std::string>{"a", "b", "c", "d", "e", "f"}));
+    EXPECT_EQ(s->ttl("copy"), -1);
+    EXPECT_EQ(dispatcher.execute_command({"RESTORE", "copy", "0", *list}),
+              "-BUSYKEY Target key name already exists.\r\n");
+    EXPECT_EQ(dispatcher.execute_command({"RESTORE", "copy", "5000", *s->dump("zset"), "REPLACE"}), "+OK\r\n");
+    EXPECT_EQ(s->zscore("copy", "m2"), 2.5);
+    EXPECT_GT(s->pttl("copy"), 4000);
+    EXPECT_EQ(dispatcher.execute_command({"RESTORE", "int", "0", *s->dump("n")}), "+OK\r\n");
+    EXPECT_EQ(s->get("int"), "42");
+
+    // 이미 지난 절대 시각이면 키를 만들지 않음
+    EXPECT_EQ(dispatcher.execute_command({"RESTORE", "old", "1000", *list, "ABSTTL"}), "+OK\r\n");
+    EXPECT_FALSE(s->get("old").has_value());
+    EXPECT_EQ(s->dbsize(), 5u);
+
+    std::string damaged = *list;
+    damaged[2] ^= 0x20;
+    EXPECT_EQ(dispatcher.execute_command({"RESTORE", "bad", "0", damaged}),
+              "-ERR DUMP payload version or checksum are wrong\r\n");
+    EXPECT_EQ(dispatcher.execute_command({"RESTORE", "bad", "0", "x"}),
+              "-ERR DUMP payload version or checksum are wrong\r\n");
+    EXPECT_EQ(dispatcher.execute_command({"RESTORE", "bad", "-1", *list}), "-ERR Invalid TTL value, must be >= 0\r\n");
+    EXPECT_EQ(dispatcher.execute_command({"RESTORE", "bad", "0", *list, "NOW"}), "-ERR syntax error\r\n");
+    EXPECT_EQ(s->dbsize(), 5u);
+}
@@ -0,0 +1,295 @@
+#include "gtest/gtest.h"
+#include "storage/store.hpp"
+#include "storage/sorted_set.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+* Sorted set commands tests: ZADD flags, ZINCRBY, ZSCORE/ZRANK/ZRANGE/ZRANGEBYSCORE/ZRANGEBYLEX/ZREM/ZCARD
+* on the store, ZSCAN on both encodings, and sorted_set (listpack and skiplist encodings) compared
+* against an std::set of (score, member) pairs under random inserts, updates and deletes.
+*/
+
+using mini_redis::lex_range;
+using mini_redis::score_range;
+using mini_redis::sorted_set;
+using mini_redis::zadd_flags;
+
+namespace {
+    using reference = std::set<std::pair<double, std::string>>;
+
+    std::vector<std::string> members_of(const sorted_set::entries &entries) {
+        std::vector<std::string> out;
+        for (const auto &entry : entries) {
+            out.push_back(entry.first);
+        }
+        return out;
+    }
+
+    sorted_set::entries to_entries(reference::const_iterator first, reference::const_iterator last) {
+        sorted_set::entries out;
+        for (; first != last; ++first) {
+            out.emplace_back(first->second, first->first);
+        }
+        return out;
+    }
+
+    // 정렬 순서, 순위, 점수 범위 조회를 reference와 비교
+    void expect_matches(const sorted_set &zset, const reference &ref, std::mt19937_64 &rng) {
+        ASSERT_EQ(zset.size(), ref.size());
+        sorted_set::entries all;
+        zset.for_each([&](std::string_view member, double score) { all.emplace_back(std::string(member), score); });
+        ASSERT_EQ(all, to_entries(ref.begin(), ref.end()));
+        if (ref.empty()) {
+            return;
+        }
+        for (int probe = 0; probe < 20; ++probe) {
+            const std::size_t i = rng() % ref.size();
+            const auto &[score, member] = *std::next(ref.begin(), static_cast<long>(i));
+            ASSERT_EQ(zset.rank(member), i);
+            ASSERT_EQ(zset.rank(member, true), ref.size() - 1 - i);
+            ASSERT_EQ(zset.score(member), score);
+
+            const std::size_t j = std::min(ref.size() - 1, i + rng() % 10);
+            ASSERT_EQ(zset.range_by_rank(i, j), to_entries(std::next(ref.begin(), static_cast<long>(i)),
+                                                           std::next(ref.begin(), static_cast<long>(j + 1))));
+
+            score_range range;
+            range.min = score;
+            range.max = score + static_cast<double>(rng() % 50);
+            range.min_exclusive = rng() % 2;
+            range.max_exclusive = rng() % 2;
+            sorted_set::entries expected;
+            for (const auto &[s, m] : ref) {
+                if (range.above_min(s) && range.below_max(s)) {
+                    expected.emplace_back(m, s);
+                }
+            }
+            ASSERT_EQ(zset.range_by_score(range), expected);
+            const std::size_t offset = rng() % 4, count = rng() % 4;
+            sorted_set::entries limited(expected.begin() + static_cast<long>(std::min(offset, expected.size())),
+                                        expected.begin() + static_cast<long>(std::min(offset + count, expected.size())));
+            ASSERT_EQ(zset.range_by_score(range, false, offset, count), limited);
+            std::reverse(expected.begin(), expected.end());
+            ASSERT_EQ(zset.range_by_score(range, true), expected);
+        }
+    }
+
+    void random_operations(const sorted_set::options &opts, std::size_t keyspace, bool expect_listpack) {
+        std::mt19937_64 rng(7);
+        sorted_set zset(opts);
+        reference ref;
+        std::unordered_map<std::string, double> scores;
+        for (int round = 0; round < 3000; ++round) {
+            const std::string member = "m" + std::to_string(rng() % keyspace);
+            // 같은 점수가 자주 나오도록 좁은 범위를 씀
+            const double score = static_cast<double>(rng() % 64) - 20;
+            const auto found = scores.find(member);
+            if (rng() % 4 == 0) {
+                ASSERT_EQ(zset.erase(member), found != scores.end());
+                if (found != scores.end()) {
+                    ref.erase({found->second, member});
+                    scores.erase(found);
+                }
+            } else {
+                ASSERT_EQ(zset.insert(member, score), found == scores.end());
+                if (found != scores.end()) {
+                    ref.erase({found->second, member});
+                }
+                ref.insert({score, member});
+                scores[member] = score;
+            }
+            if (round % 100 == 0) {
+                expect_matches(zset, ref, rng);
+            }
+        }
+        expect_matches(zset, ref, rng);
+        EXPECT_EQ(zset.is_listpack(), expect_listpack);
+    }
+}
+
+class SortedSetCommandsTest : public ::testing::Test {
+protected:
+    mini_redis::store store_instance;
+};
+
+TEST_F(SortedSetCommandsTest, AddScoreRankAndRemove) {
+    EXPECT_EQ(store_instance.zadd("z", {{3, "c"}, {1, "a"}, {2, "b"}, {2, "b2"}}), 4u);
+    EXPECT_EQ(store_instance.zcard("z"), 4u);
+    EXPECT_EQ(store_instance.zscore("z", "b"), 2.0);
+    EXPECT_FALSE(store_instance.zscore("z", "x").has_value());
+    EXPECT_EQ(store_instance.zrank("z", "a"), 0u);
+    EXPECT_EQ(store_instance.zrank("z", "b2"), 2u);
+    EXPECT_EQ(store_instance.zrank("z", "a", true), 3u);
+    EXPECT_FALSE(store_instance.zrank("z", "x").has_value());
+
+    // 같은 점수는 member 순서, 음수 인덱스는 끝에서부터
+    EXPECT_EQ(members_of(store_instance.zrange("z", 0, -1)), (std::vector<std::string>{"a", "b", "b2", "c"}));
+    EXPECT_EQ(members_of(store_instance.zrange("z", -2, 100)), (std::vector<std::string>{"b2", "c"}));
+    EXPECT_EQ(members_of(store_instance.zrange("z", 0, 1, true)), (std::vector<std::string>{"c", "b2"}));
+    EXPECT_TRUE(store_instance.zrange("z", 3, 1).empty());
+    EXPECT_TRUE(store_instance.zrange("z", 10, 20).empty());
+
+    EXPECT_EQ(store_instance.zincrby("z", 10, "a"), 11.0);
+    EXPECT_EQ(store_instance.zrank("z", "a"), 3u);
+    EXPECT_EQ(store_instance.zincrby("z", 1.5, "new"), 1.5);
+
+    EXPECT_EQ(store_instance.zrem("z", {"a", "nope", "b"}), 2u);
+    EXPECT_EQ(store_instance.zrem("z", {"b2", "c", "new"}), 3u);
+    // 마지막 원소를 지우면 키가 사라짐
+    EXPECT_FALSE(store_instance.exists("z"));
+
+    store_instance.set("str", "value");
+    EXPECT_THROW(store_instance.zadd("str", {{1, "a"}}), std::runtime_error);
+    EXPECT_THROW(store_instance.zrank("str", "a"), std::runtime_error);
+    EXPECT_THROW(store_instance.zrange("str", 0, -1), std::runtime_error);
+}
+
+TEST_F(SortedSetCommandsTest, AddFlags) {
+    store_instance.zadd("z", {{1, "a"}, {5, "b"}});
+
+    zadd_flags nx;
+    nx.nx = true;
+    EXPECT_EQ(store_instance.zadd("z", {{9, "a"}, {2, "c"}}, nx), 1u);
+    EXPECT_EQ(store_instance.zscore("z", "a"), 1.0);
+
+    zadd_flags xx;
+    xx.xx = true;
+    xx.ch = true;
+    EXPECT_EQ(store_instance.zadd("z", {{7, "a"}, {3, "d"}}, xx), 1u);
+    EXPECT_EQ(store_instance.zscore("z", "a"), 7.0);
+    EXPECT_FALSE(store_instance.zscore("z", "d").has_value());
+    // XX만으로는 빈 키를 만들지 않음
+    EXPECT_EQ(store_instance.zadd("missing", {{1, "a"}}, xx), 0u);
+    EXPECT_FALSE(store_instance.exists("missing"));
+
+    zadd_flags gt;
+    gt.gt = true;
+    gt.ch = true;
+    EXPECT_EQ(store_instance.zadd("z", {{4, "b"}, {6, "c"}, {1, "e"}}, gt), 2u);
+    EXPECT_EQ(store_instance.zscore("z", "b"), 5.0);
+    EXPECT_EQ(store_instance.zscore("z", "c"), 6.0);
+
+    zadd_flags lt;
+    lt.lt = true;
+    EXPECT_EQ(store_instance.zadd_incr("z", -1, "b", lt), 4.0);
+    EXPECT_FALSE(store_instance.zadd_incr("z", 1, "b", lt).has_value());
+    EXPECT_FALSE(store_instance.zadd_incr("z", 1, "b", nx).has_value());
+    EXPECT_EQ(store_instance.zscore("z", "b"), 4.0);
+
+    // 값이 같으면 CH에서도 바뀐 것으로 세지 않음
+    zadd_flags ch;
+    ch.ch = true;
+    EXPECT_EQ(store_instance.zadd("z", {{4, "b"}}, ch), 0u);
+
+    const double inf = std::numeric_limits<double>::infinity();
+    store_instance.zadd("inf", {{inf, "a"}});
+    EXPECT_THROW(store_instance.zincrby("inf", -inf, "a"), std::runtime_error);
+    EXPECT_EQ(store_instance.zscore("inf", "a"), inf);
+}
+
+TEST_F(SortedSetCommandsTest, ScoreAndLexRanges) {
+    store_instance.zadd("z", {{1, "a"}, {2, "b"}, {2, "c"}, {3, "d"}, {4, "e"}});
+
+    score_range range;
+    range.min = 2;
+    range.max = 3;
+    EXPECT_EQ(members_of(store_instance.zrangebyscore("z", range)), (std::vector<std::string>{"b", "c", "d"}));
+    range.min_exclusive = true;
+    EXPECT_EQ(members_of(store_instance.zrangebyscore("z", range)), (std::vector<std::string>{"d"}));
+    score_range all;
+    EXPECT_EQ(members_of(store_instance.zrangebyscore("z", all, true, 1, 2)), (std::vector<std::string>{"d", "c"}));
+    EXPECT_EQ(members_of(store_instance.zrangebyscore("z", all, false, 4, 10)), (std::vector<std::string>{"e"}));
+    EXPECT_TRUE(store_instance.zrangebyscore("z", all, false, 5, 10).empty());
+
+    store_instance.zadd("lex", {{0, "a"}, {0, "b"}, {0, "c"}, {0, "d"}});
+    lex_range lex;
+    lex.min = "b";
+    lex.min_unbounded = false;
+    EXPECT_EQ(members_of(store_instance.zrangebylex("lex", lex)), (std::vector<std::string>{"b", "c", "d"}));
+    lex.max = "d";
+    lex.max_unbounded = false;
+    lex.max_exclusive = true;
+    EXPECT_EQ(members_of(store_instance.zrangebylex("lex", lex, true)), (std::vector<std::string>{"c", "b"}));
+    EXPECT_EQ(members_of(store_instance.zrangebylex("lex", lex_range{}, false, 1, 2)),
+              (std::vector<std::string>{"b", "c"}));
+}
+
+TEST_F(SortedSetCommandsTest, ZscanBothEncodings) {
+    store_instance.zadd("small", {{2, "b"}, {1.5, "a"}});
+    auto small = store_instance.zscan("small", 0);
+    EXPECT_EQ(small.cursor, 0u);
+    EXPECT_EQ(small.items, (std::vector<std::string>{"a", "1.5", "b", "2"}));
+
+    // 같은 점수가 많아도 모든 member를 방문
+    for (int i = 0; i < 1000; ++i) {
+        store_instance.zadd("big", {{static_cast<double>(i % 3), "m" + std::to_string(i)}});
+    }
+    std::vector<std::string> members;
+    std::uint64_t cursor = 0;
+    do {
+        auto result = store_instance.zscan("big", cursor, "*", 50);
+        for (std::size_t i = 0; i < result.items.size(); i += 2) {
+            members.push_back(result.items[i]);
+        }
+        cursor = result.cursor;
+    } while (cursor != 0);
+    std::sort(members.begin(), members.end());
+    members.erase(std::unique(members.begin(), members.end()), members.end());
+    EXPECT_EQ(members.size(), 1000u);
+}
+
+TEST(SortedSetTest, ConvertsPastThresholds) {
+    sorted_set by_count(sorted_set::options{4, 64});
+    for (int i = 0; i < 4; ++i) {
+        by_count.insert("m" + std::to_string(i), i);
+    }
+    EXPECT_TRUE(by_count.is_listpack());
+    // 이미 있는 원소의 점수 변경은 한도와 무관
+    EXPECT_FALSE(by_count.insert("m3", -1));
+    EXPECT_TRUE(by_count.is_listpack());
+    EXPECT_EQ(by_count.rank("m3"), 0u);
+    by_count.insert("m4", 4);
+    EXPECT_FALSE(by_count.is_listpack());
+    EXPECT_EQ(by_count.size(), 5u);
+    EXPECT_EQ(by_count.rank("m3"), 0u);
+    EXPECT_EQ(by_count.score("m4"), 4.0);
+
+    sorted_set by_member(sorted_set::options{128, 8});
+    by_member.insert("short", 1);
+    EXPECT_TRUE(by_member.is_listpack());
+    by_member.insert("a-member-longer-than-8", 2);
+    EXPECT_FALSE(by_member.is_listpack());
+    EXPECT_EQ(by_member.rank("a-member-longer-than-8"), 1u);
+
+    // 복사본은 원본과 독립
+    sorted_set copy = by_count;
+    copy.erase("m0");
+    EXPECT_EQ(copy.size(), 4u);
+    EXPECT_EQ(by_count.size(), 5u);
+    EXPECT_EQ(copy.rank("m4"), 3u);
+}
+
+TEST(SortedSetTest, ListpackMatchesReference) {
+    random_operations(sorted_set::options{1000, 64}, 200, true);
+}
+
+TEST(SortedSetTest, SkiplistMatchesReference) {
+    random_operations(sorted_set::options{0, 64}, 500, false);
+}
+
+TEST(SortedSetTest, FormatScore) {
+    EXPECT_EQ(mini_redis::format_score(1), "1");
+    EXPECT_EQ(mini_redis::format_score(-2.5), "-2.5");
+    EXPECT_EQ(mini_redis::format_score(0.1), "0.1");
+    EXPECT_EQ(mini_redis::format_score(std::numeric_limits<double>::infinity()), "inf");
+    EXPECT_EQ(mini_redis::format_score(-std::numeric_limits<double>::infinity()), "-inf");
+}
@@ -0,0 +1,261 @@
+#include "gtest/gtest.h"
+#include "storage/store.hpp"
+#include "storage/stream.hpp"
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+* Stream commands tests: XADD ID rules, XRANGE/XREVRANGE across packed blocks (compared with a
+* reference vector), XTRIM exact and approximate trimming, XREAD, and consumer groups
+* (XGROUP/XREADGROUP/XACK/XPENDING).
+*/
+
+using mini_redis::stream;
+using mini_redis::stream_id;
+using mini_redis::stream_trim;
+
+namespace {
+    constexpr std::size_t no_limit = std::numeric_limits<std::size_t>::max();
+
+    stream::id_spec explicit_id(std::uint64_t ms, std::uint64_t seq) {
+        return stream::id_spec{stream_id{ms, seq}, false, false};
+    }
+
+    std::vector<std::string> ids_of(const std::vector<stream::entry> &entries) {
+        std::vector<std::string> out;
+        for (const auto &e : entries) {
+            out.push_back(e.id.to_string());
+        }
+        return out;
+    }
+
+    stream_trim maxlen(std::uint64_t n, bool approximate = false) {
+        stream_trim trim;
+        trim.by = stream_trim::strategy::maxlen;
+        trim.maxlen = n;
+        trim.approximate = approximate;
+        return trim;
+    }
+}
+
+class StreamCommandsTest : public ::testing::Test {
+protected:
+    // 작은 block으로 여러 block에 걸친 경우를 시험
+    static mini_redis::store_config small_blocks() {
+        mini_redis::store_config config;
+        config.stream_node_max_entries = 4;
+        config.stream_node_max_bytes = 256;
+        return config;
+    }
+
+    mini_redis::store store_instance{small_blocks()};
+};
+
+TEST_F(StreamCommandsTest, XaddIdRules) {
+    EXPECT_EQ(store_instance.xadd("s", explicit_id(5, 1), {"f", "v"}), (stream_id{5, 1}));
+    EXPECT_THROW(store_instance.xadd("s", explicit_id(5, 1), {"f", "v"}), std::runtime_error);
+    EXPECT_THROW(store_instance.xadd("s", explicit_id(4, 9), {"f", "v"}), std::runtime_error);
+    // "<ms>-*": 같은 ms이면 다음 순번, 더 크면 0부터
+    EXPECT_EQ(store_instance.xadd("s", stream::id_spec{stream_id{5, 0}, false, true}, {"f", "v"}), (stream_id{5, 2}));
+    EXPECT_EQ(store_instance.xadd("s", stream::id_spec{stream_id{7, 0}, false, true}, {"f", "v"}), (stream_id{7, 0}));
+    EXPECT_THROW(store_instance.xadd("s", stream::id_spec{stream_id{6, 0}, false, true}, {"f", "v"}),
+                 std::runtime_error);
+    // "*": 벽시계 시각
+    const auto auto_id = store_instance.xadd("s", stream::id_spec{}, {"f", "v"});
+    EXPECT_GT(auto_id->ms, 1600000000000u);
+    EXPECT_EQ(store_instance.xlen("s"), 4u);
+
+    // 0-0은 안 되고, 잘못된 ID로는 키를 만들지 않음
+    EXPECT_THROW(store_instance.xadd("new", explicit_id(0, 0), {"f", "v"}), std::runtime_error);
+    EXPECT_FALSE(store_instance.exists("new"));
+    EXPECT_EQ(store_instance.xadd("new", stream::id_spec{stream_id{0, 0}, false, true}, {"f", "v"}), (stream_id{0, 1}));
+    EXPECT_EQ(store_instance.xadd("none", stream::id_spec{}, {"f", "v"}, {}, true), std::nullopt);
+    EXPECT_FALSE(store_instance.exists("none"));
+
+    store_instance.set("str", "x");
+    EXPECT_THROW(store_instance.xadd("str", stream::id_spec{}, {"f", "v"}), std::runtime_error);
+    EXPECT_THROW(store_instance.xlen("str"), std::runtime_error);
+    EXPECT_EQ(store_instance.scan(0, "*", 100, "stream").items.size(), 2u);
+
+    EXPECT_EQ(stream_id::parse("12-3"), (stream_id{12, 3}));
+    EXPECT_EQ(stream_id::parse("12", 7), (stream_id{12, 7}));
+    EXPECT_FALSE(stream_id::parse("12-"));
+    EXPECT_FALSE(stream_id::parse("-3"));
+    EXPECT_FALSE(stream_id::parse("1x"));
+}
+
+TEST_F(StreamCommandsTest, RangeAcrossBlocksMatchesReference) {
+    // 필드 이름이 같은 항목과 다른 항목을 섞어 block 경계를 여러 번 넘김
+    std::mt19937 rng(7);
+    std::vector<stream::entry> reference;
+    stream_id id{1000, 0};
+    for (int i = 0; i < 300; ++i) {
+        id = rng() % 3 ? stream_id{id.ms, id.seq + 1} : stream_id{id.ms + rng() % 1000, 0};
+        std::vector<std::string> fields{"temp", std::to_string(rng() % 100)};
+        if (rng() % 4 == 0) {
+            fields = {"other", std::string(rng() % 40, 'x'), "k", std::to_string(i)};
+        }
+        store_instance.xadd("s", explicit_id(id.ms, id.seq), fields);
+        reference.push_back({id, fields});
+    }
+    const auto all = store_instance.xrange("s", stream_id{}, stream_id::max(), no_limit);
+    ASSERT_EQ(all.size(), reference.size());
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        EXPECT_EQ(all[i].id, reference[i].id);
+        EXPECT_EQ(all[i].fields, reference[i].fields);
+    }
+
+    for (int round = 0; round < 200; ++round) {
+        std::size_t a = rng() % reference.size(), b = rng() % reference.size();
+        if (a > b) {
+            std::swap(a, b);
+        }
+        const std::size_t count = rng() % 20 + 1;
+        std::vector<std::string> expected, expected_rev;
+        for (std::size_t i = a; i <= b && expected.size() < count; ++i) {
+            expected.push_back(reference[i].id.to_string());
+        }
+        for (std::size_t i = b + 1; i-- > a && expected_rev.size() < count;) {
+            expected_rev.push_back(reference[i].id.to_string());
+        }
+        EXPECT_EQ(ids_of(store_instance.xrange("s", reference[a].id, reference[b].id, count)), expected);
+        EXPECT_EQ(ids_of(store_instance.xrange("s", reference[a].id, reference[b].id, count, true)), expected_rev);
+    }
+    EXPECT_TRUE(store_instance.xrange("s", stream_id{5, 0}, stream_id{1, 0}, no_limit).empty());
+    EXPECT_TRUE(store_instance.xrange("s", stream_id{}, stream_id::max(), 0).empty());
+    EXPECT_TRUE(store_instance.xrange("missing", stream_id{}, stream_id::max(), no_limit).empty());
+}
+
+TEST_F(StreamCommandsTest, Xtrim) {
+    for (std::uint64_t i = 1; i <= 10; ++i) {
+        store_instance.xadd("s", explicit_id(i, 0), {"n", std::to_string(i)});
+    }
+    // block은 4개씩: [1-4][5-8][9-10]. '~'는 통째로 지울 수 있는 block만 지움
+    EXPECT_EQ(store_instance.xtrim("s", maxlen(7, true)), 0u);
+    EXPECT_EQ(store_instance.xtrim("s", maxlen(6, true)), 4u);
+    EXPECT_EQ(store_instance.xtrim("s", maxlen(5)), 1u);
+    EXPECT_EQ(ids_of(store_instance.xrange("s", stream_id{}, stream_id::max(), 2)),
+              (std::vector<std::string>{"6-0", "7-0"}));
+
+    stream_trim minid;
+    minid.by = stream_trim::strategy::minid;
+    minid.minid = stream_id{9, 0};
+    EXPECT_EQ(store_instance.xtrim("s", minid), 3u);
+    EXPECT_EQ(ids_of(store_instance.xrange("s", stream_id{}, stream_id::max(), no_limit)),
+              (std::vector<std::string>{"9-0", "10-0"}));
+
+    // 모두 지워도 키와 마지막 ID는 남음
+    EXPECT_EQ(store_instance.xtrim("s", maxlen(0)), 2u);
+    EXPECT_TRUE(store_instance.exists("s"));
+    EXPECT_EQ(store_instance.xlen("s"), 0u);
+    EXPECT_THROW(store_instance.xadd("s", explicit_id(10, 0), {"n", "x"}), std::runtime_error);
+
+    // XADD의 MAXLEN은 추가 뒤에 적용
+    for (std::uint64_t i = 11; i <= 20; ++i) {
+        store_instance.xadd("s", explicit_id(i, 0), {"n", std::to_string(i)}, maxlen(3));
+    }
+    EXPECT_EQ(ids_of(store_instance.xrange("s", stream_id{}, stream_id::max(), no_limit)),
+              (std::vector<std::string>{"18-0", "19-0", "20-0"}));
+    EXPECT_EQ(store_instance.xtrim("missing", maxlen(0)), 0u);
+}
+
+TEST_F(StreamCommandsTest, XreadAndConsumerGroups) {
+    for (std::uint64_t i = 1; i <= 5; ++i) {
+        store_instance.xadd("s", explicit_id(i, 0), {"n", std::to_string(i)});
+    }
+    auto read = store_instance.xread({"s", "missing"}, {stream_id{2, 0}, stream_id{}}, 2);
+    ASSERT_EQ(read.size(), 1u);
+    EXPECT_EQ(ids_of(read[0].second), (std::vector<std::string>{"3-0", "4-0"}));
+    EXPECT_TRUE(store_instance.xread({"s"}, {std::nullopt}, 0).empty());
+
+    EXPECT_THROW(store_instance.xgroup_create("missing", "g", stream_id{}, false), std::runtime_error);
+    store_instance.xgroup_create("s", "g", stream_id{}, false);
+    EXPECT_THROW(store_instance.xgroup_create("s", "g", stream_id{}, false), std::runtime_error);
+    EXPECT_THROW(store_instance.xreadgroup("nogroup", "c", {"s"}, {std::nullopt}, 0, false), std::runtime_error);
+
+    // ">": 그룹에 아직 전달하지 않은 항목을 소비자끼리 나눠 받음
+    read = store_instance.xreadgroup("g", "alice", {"s"}, {std::nullopt}, 2, false);
+    EXPECT_EQ(ids_of(read[0].second), (std::vector<std::string>{"1-0", "2-0"}));
+    read = store_instance.xreadgroup("g", "bob", {"s"}, {std::nullopt}, 0, false);
+    EXPECT_EQ(ids_of(read[0].second), (std::vector<std::string>{"3-0", "4-0", "5-0"}));
+    EXPECT_TRUE(store_instance.xreadgroup("g", "bob", {"s"}, {std::nullopt}, 0, false).empty());
+
+    auto summary = store_instance.xpending("s", "g");
+    EXPECT_EQ(summary.count, 5u);
+    EXPECT_EQ(summary.min, (stream_id{1, 0}));
+    EXPECT_EQ(summary.max, (stream_id{5, 0}));
+    EXPECT_EQ(summary.consumers, (std::vector<std::pair<std::string, std::size_t>>{{"alice", 2}, {"bob", 3}}));
+
+    EXPECT_EQ(store_instance.xack("s", "g", {stream_id{1, 0}, stream_id{3, 0}, stream_id{9, 0}}), 2u);
+    EXPECT_EQ(store_instance.xack("s", "g", {stream_id{1, 0}}), 0u);
+    const auto pending = store_instance.xpending("s", "g", stream_id{}, stream_id::max(), 10, std::string("bob"));
+    ASSERT_EQ(pending.size(), 2u);
+    EXPECT_EQ(pending[0].id, (stream_id{4, 0}));
+    EXPECT_EQ(pending[0].consumer, "bob");
+    EXPECT_EQ(pending[0].deliveries, 1u);
+    EXPECT_TRUE(store_instance.xpending("s", "g", stream_id{}, stream_id::max(), 10, std::nullopt, 60000).empty());
+
+    // 이력 읽기: 자신의 pending 항목만, 지워진 항목은 fields가 빔
+    store_instance.xtrim("s", maxlen(1));
+    read = store_instance.xreadgroup("g", "bob", {"s"}, {stream_id{}}, 0, false);
+    ASSERT_EQ(read.size(), 1u);
+    ASSERT_EQ(ids_of(read[0].second), (std::vector<std::string>{"4-0", "5-0"}));
+    EXPECT_TRUE(read[0].second[0].fields.empty());
+    EXPECT_EQ(read[0].second[1].fields, (std::vector<std::string>{"n", "5"}));
+
+    // NOACK은 PEL에 넣지 않음. SETID로 되돌리면 다시 전달하며 전달 횟수가 늘어남
+    store_instance.xadd("s", explicit_id(6, 0), {"n", "6"});
+    read = store_instance.xreadgroup("g", "carol", {"s"}, {std::nullopt}, 0, true);
+    EXPECT_EQ(ids_of(read[0].second), (std::vector<std::string>{"6-0"}));
+    EXPECT_EQ(store_instance.xpending("s", "g").count, 3u);
+    store_instance.xgroup_setid("s", "g", stream_id{4, 0});
+    read = store_instance.xreadgroup("g", "carol", {"s"}, {std::nullopt}, 1, false);
+    EXPECT_EQ(ids_of(read[0].second), (std::vector<std::string>{"5-0"}));
+    const auto moved = store_instance.xpending("s", "g", stream_id{5, 0}, stream_id{5, 0}, 10, std::nullopt);
+    ASSERT_EQ(moved.size(), 1u);
+    EXPECT_EQ(moved[0].consumer, "carol");
+    EXPECT_EQ(moved[0].deliveries, 2u);
+
+    EXPECT_TRUE(store_instance.xgroup_createconsumer("s", "g", "dave"));
+    EXPECT_FALSE(store_instance.xgroup_createconsumer("s", "g", "dave"));
+    EXPECT_EQ(store_instance.xgroup_delconsumer("s", "g", "bob"), 1u);
+    EXPECT_EQ(store_instance.xpending("s", "g").count, 2u);
+    EXPECT_THROW(store_instance.xgroup_setid("s", "nogroup", std::nullopt), std::runtime_error);
+    EXPECT_TRUE(store_instance.xgroup_destroy("s", "g"));
+    EXPECT_FALSE(store_instance.xgroup_destroy("s", "g"));
+    EXPECT_THROW(store_instance.xpending("s", "g"), std::runtime_error);
+
+    // MKSTREAM은 빈 스트림을 만들고, "$"는 지금의 마지막 ID부터
+    store_instance.xgroup_create("fresh", "g", std::nullopt, true);
+    EXPECT_EQ(store_instance.xlen("fresh"), 0u);
+    store_instance.xadd("fresh", explicit_id(1, 0), {"a", "b"});
+    read = store_instance.xreadgroup("g", "c", {"fresh"}, {std::nullopt}, 0, false);
+    EXPECT_EQ(ids_of(read[0].second), (std::vector<std::string>{"1-0"}));
+}
+
+TEST(StreamTest, CopyAndMemoryUsage) {
+    stream s(stream::options{100, 4096});
+    const std::size_t empty = s.memory_usage();
+    for (std::uint64_t i = 1; i <= 1000; ++i) {
+        s.append(stream_id{1700000000000 + i / 10, i % 10}, {"sensor", "42", "temp", std::to_string(i % 97)});
+    }
+    // 같은 필드 이름은 block 머리에 한 번만 쓰므로 항목당 십여 bytes
+    EXPECT_LT(s.memory_usage() - empty, 1000u * 16);
+    s.create_group("g", stream_id{});
+    s.read_group(*s.find_group("g"), "c", std::nullopt, 10, false, 0);
+
+    stream copy(s);
+    EXPECT_EQ(copy.size(), s.size());
+    EXPECT_EQ(copy.last_id(), s.last_id());
+    EXPECT_EQ(copy.range(stream_id{}, stream_id::max(), 1000)[999].fields,
+              s.range(stream_id{}, stream_id::max(), 1000)[999].fields);
+    EXPECT_EQ(copy.find_group("g")->pending.size(), 10u);
+
+    stream moved(std::move(copy));
+    EXPECT_EQ(moved.size(), 1000u);
+    EXPECT_EQ(copy.size(), 0u);
+    moved = s;
+    EXPECT_EQ(moved.memory_usage(), s.memory_usage());
+}
@@ -1,7 +1,9 @@
 #include "gtest/gtest.h"
 #include "storage/store.hpp"
+#include "protocol/serializer.hpp"
 #include <thread>
 #include <chrono>
+#include <limits>
 
 class StringCommandsTest : public ::testing::Test {
 protected:
@@ -114,3 +116,74 @@ TEST_F(StringCommandsTest, DecrBy) {
     store_instance.set("not_a_number", "world");
     EXPECT_THROW(store_instance.decrby("not_a_number", 5), std::runtime_error);
 }
+
+TEST_F(StringCommandsTest, IntegerEncodedValues) {
+    // 정수로 저장된 값도 GET에는 원래 문자열 그대로 보여야 함
+    store_instance.set("n", "-42");
+    EXPECT_EQ(store_instance.get("n"), "-42");
+    EXPECT_EQ(store_instance.incrby("n", 50), 8);
+    EXPECT_EQ(store_instance.get("n"), "8");
+
+    // 표준 표기가 아닌 숫자 문자열은 문자열로 남고, 카운터로 쓸 수 없음 (Redis와 동일)
+    store_instance.set("padded", "007");
+    EXPECT_EQ(store_instance.get("padded"), "007");
+    EXPECT_THROW(store_instance.incr("padded"), std::runtime_error);
+    store_instance.set("spaced", " 1");
+    EXPECT_THROW(store_instance.incr("spaced"), std::runtime_error);
+
+    // 64-bit 전 범위와 overflow 검사
+    store_instance.set("big", "9223372036854775806");
+    EXPECT_EQ(store_instance.incr("big"), 9223372036854775807LL);
+    EXPECT_THROW(store_instance.incr("big"), std::runtime_error);
+    EXPECT_EQ(store_instance.get("big"), "9223372036854775807");
+    store_instance.set("small", "-9223372036854775808");
+    EXPECT_THROW(store_instance.decr("small"), std::runtime_error);
+    EXPECT_THROW(store_instance.decrby("other", std::numeric_limits<long long>::min()), std::runtime_error);
+
+    // 카운터에 설정된 TTL은 증가 후에도 유지됨
+    store_instance.setex("limited", 100, "1");
+    EXPECT_EQ(store_instance.incr("limited"), 2);
+    EXPECT_GT(store_instance.ttl("limited"), 0);
+}
+
+TEST_F(StringCommandsTest, SerializeInteger64) {
+    // 64-bit 카운터 값이 응답에서 잘리지 않아야 함
+    EXPECT_EQ(mini_redis::serializer::serialize_integer(9223372036854775807LL), ":9223372036854775807\r\n");
+    EXPECT_EQ(mini_redis::serializer::serialize_integer(std::numeric_limits<std::int64_t>::min()), ":-9223372036854775808\r\n");
+    EXPECT_EQ(mini_redis::serializer::serialize_integer(0), ":0\r\n");
+}
+
+TEST_F(StringCommandsTest, MgetMsetMsetnx) {
+    // 여러 shard에 걸친 키를 한 번에 설정하고, 같은 키가 두 번 나오면 뒤의 값
+    std::vector<std::pair<std::string, std::string>> pairs;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 100; ++i) {
+        pairs.emplace_back("k" + std::to_string(i), "v" + std::to_string(i));
+        keys.push_back("k" + std::to_string(i));
+    }
+    pairs.emplace_back("k0", "12");
+    store_instance.setex("k1", 100, "old");
+    store_instance.mset(pairs);
+    EXPECT_EQ(store_instance.ttl("k1"), -1);
+
+    store_instance.rpush("list", {"a"});
+    store_instance.psetex("gone", 1, "x");
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    keys.insert(keys.end(), {"missing", "list", "gone", "k5"});
+    const auto values = store_instance.mget(keys);
+    ASSERT_EQ(values.size(), 104u);
+    EXPECT_EQ(values[0], "12");
+    EXPECT_EQ(values[99], "v99");
+    EXPECT_EQ(values[100], std::nullopt);
+    EXPECT_EQ(values[101], std::nullopt); // 문자열이 아닌 값은 nil
+    EXPECT_EQ(values[102], std::nullopt);
+    EXPECT_EQ(values[103], "v5");
+
+    // MSETNX는 키가 하나라도 있으면 아무것도 설정하지 않음
+    EXPECT_FALSE(store_instance.msetnx({{"new1", "a"}, {"k7", "b"}}));
+    EXPECT_FALSE(store_instance.exists("new1"));
+    EXPECT_EQ(store_instance.get("k7"), "v7");
+    EXPECT_TRUE(store_instance.msetnx({{"new1", "a"}, {"new2", "b"}, {"gone", "c"}}));
+    EXPECT_EQ(store_instance.mget({"new1", "new2", "gone"}),
+              (std::vector<std::optional<std::string>>{"a", "b", "c"}));
+}